@@ -27,6 +27,8 @@ namespace ouzel::assets
         struct Options final
         {
             bool mipmaps = true;
+            bool stream = false; // sounds are decoded from the file while they play (only Vorbis)
+            bool distanceField = false; // fonts are drawn from signed distance fields, so that one atlas serves all the sizes
         };
 
         Asset(Type initType,
@@ -0,0 +1,55 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETS_ASSETID_HPP
+#define OUZEL_ASSETS_ASSETID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include "../hash/Fnv1.hpp"
+
+namespace ouzel::assets
+{
+    // Hash of an asset name, constexpr AssetId values of literals are computed at compile time
+    class AssetId final
+    {
+    public:
+        constexpr AssetId() noexcept = default;
+
+        constexpr explicit AssetId(std::string_view name) noexcept:
+            value{hash::fnv1a::hash<std::uint64_t>(name)}
+        {
+        }
+
+        [[nodiscard]] constexpr auto getValue() const noexcept { return value; }
+
+        [[nodiscard]] constexpr bool operator==(const AssetId& other) const noexcept
+        {
+            return value == other.value;
+        }
+
+        [[nodiscard]] constexpr bool operator!=(const AssetId& other) const noexcept
+        {
+            return value != other.value;
+        }
+
+    private:
+        std::uint64_t value = 0;
+    };
+}
+
+namespace std
+{
+    template <>
+    struct hash<ouzel::assets::AssetId> final
+    {
+        std::size_t operator()(const ouzel::assets::AssetId& id) const noexcept
+        {
+            // the value is already a hash
+            return static_cast<std::size_t>(id.getValue());
+        }
+    };
+}
+
+#endif // OUZEL_ASSETS_ASSETID_HPP
@@ -4,20 +4,25 @@
 #define OUZEL_ASSETS_BMFLOADER_HPP
 
 #include "Bundle.hpp"
+#include "Cache.hpp"
+#include "../core/Engine.hpp"
 #include "../gui/BMFont.hpp"
 
 namespace ouzel::assets
 {
-    inline bool loadBmf(Cache&,
+    inline bool loadBmf(Cache& cache,
                         Bundle& bundle,
                         const std::string& name,
                         const std::vector<std::byte>& data,
-                        const Asset::Options&)
+                        const Asset::Options& options)
     {
         try
         {
+            // only the drivers that have the distance field shader can draw the distance fields
+            const auto distanceField = options.distanceField && cache.getShader(shaderDistanceField);
+
             // TODO: move the loader here
-            auto font = std::make_unique<gui::BMFont>(data);
+            auto font = std::make_unique<gui::BMFont>(data, distanceField);
             bundle.setFont(name, std::move(font));
         }
         catch (const std::exception&)
@@ -1,13 +1,73 @@
 // Ouzel by Elviss Strazdins
 
+#include <algorithm>
 #include <cctype>
 #include "AssetError.hpp"
 #include "Bundle.hpp"
 #include "Cache.hpp"
+#include "ImageLoader.hpp"
+#include "KtxLoader.hpp"
+#include "../audio/VorbisClip.hpp"
+#include "../core/Engine.hpp"
 #include "../formats/Json.hpp"
+#include "../utils/Log.hpp"
 
 namespace ouzel::assets
 {
+    namespace
+    {
+        std::vector<Asset> parseAssets(const std::vector<std::byte>& manifest)
+        {
+            const json::Document document{manifest};
+            const auto data = document.getRoot();
+
+            std::vector<Asset> result;
+
+            for (const auto& asset : data["assets"])
+            {
+                const auto& file = asset["filename"].as<std::string>();
+                const auto& name = asset.hasMember("name") ? asset["name"].as<std::string>() : file;
+
+                Asset::Options options;
+                options.mipmaps = asset.hasMember("mipmaps") ? asset["mipmaps"].as<bool>() : true;
+                options.stream = asset.hasMember("stream") ? asset["stream"].as<bool>() : false;
+                options.distanceField = asset.hasMember("distanceField") ? asset["distanceField"].as<bool>() : false;
+                result.emplace_back(static_cast<Asset::Type>(asset["type"].as<std::uint32_t>()), name, file, options);
+            }
+
+            return result;
+        }
+
+        // assets are created only after all the assets of the previous stages, so that
+        // materials, sprites, particle systems and fonts find their textures and cues their sounds
+        // in the bundle, and meshes find their materials
+        std::uint32_t getStage(Asset::Type assetType) noexcept
+        {
+            switch (assetType)
+            {
+                case Asset::Type::image:
+                case Asset::Type::sound:
+                    return 0;
+                case Asset::Type::bank:
+                case Asset::Type::font:
+                case Asset::Type::material:
+                case Asset::Type::particleSystem:
+                case Asset::Type::sprite:
+                case Asset::Type::cue:
+                    return 1;
+                case Asset::Type::staticMesh:
+                case Asset::Type::skinnedMesh:
+                default:
+                    return 2;
+            }
+        }
+
+        bool isStreamed(const Asset& asset) noexcept
+        {
+            return asset.type == Asset::Type::sound && asset.options.stream;
+        }
+    }
+
     Bundle::Bundle(Cache& initCache, storage::FileSystem& initFileSystem):
         cache{initCache}, fileSystem{initFileSystem}
     {
@@ -23,8 +83,95 @@ namespace ouzel::assets
                            const std::string& filename,
                            const Asset::Options& options)
     {
-        const auto data = fileSystem.readFile(filename);
+        if (assetType == Asset::Type::sound && options.stream)
+        {
+            setSound(name, std::make_unique<audio::VorbisClip>(engine->getAudio(), fileSystem.openFile(filename)));
+            return;
+        }
+
+        loadAssetData(assetType, name, filename, fileSystem.readFile(filename), options);
+    }
+
+    void Bundle::loadAssets(const std::string& filename)
+    {
+        loadAssets(parseAssets(fileSystem.readFile(filename)));
+    }
+
+    void Bundle::loadAssets(const std::vector<Asset>& assets)
+    {
+        for (const auto& asset : assets)
+            loadAsset(asset.type, asset.name, asset.filename, asset.options);
+    }
+
+    LoadHandle Bundle::loadAssetsAsync(const std::string& filename,
+                                       const LoadHandle::ProgressCallback& progressCallback)
+    {
+        return loadAssetsAsync(parseAssets(fileSystem.readFile(filename)), progressCallback);
+    }
 
+    LoadHandle Bundle::loadAssetsAsync(const std::vector<Asset>& assets,
+                                       const LoadHandle::ProgressCallback& progressCallback)
+    {
+        const auto state = std::make_shared<LoadHandle::State>();
+        state->bundle = this;
+        state->progressCallback = progressCallback;
+
+        state->entries.reserve(assets.size());
+        for (const auto& asset : assets)
+            state->entries.emplace_back(asset, getStage(asset.type));
+
+        std::stable_sort(state->entries.begin(), state->entries.end(),
+                         [](const auto& a, const auto& b) noexcept { return a.stage < b.stage; });
+
+        // images are decoded on the workers only if no custom image loader overrides the default one,
+        // KTX files are not decoded, because their levels are uploaded as they are
+        const auto& loaders = cache.getLoaders();
+        const auto imageLoader = std::find_if(loaders.rbegin(), loaders.rend(), [](const auto& loader) noexcept {
+            return loader.first == Asset::Type::image && loader.second != loadKtx;
+        });
+        const bool decodeImages = imageLoader != loaders.rend() && imageLoader->second == loadImage;
+
+        auto& workerPool = engine->getWorkerPool();
+
+        // the entries must not be reallocated after this point, because the workers write into them
+        for (std::size_t i = 0; i < state->entries.size(); ++i)
+        {
+            // streamed sounds are only opened on the update thread
+            if (isStreamed(state->entries[i].asset)) continue;
+
+            core::TaskGroup taskGroup;
+            taskGroup.add([state, i, &fs = fileSystem, decodeImages]() {
+                if (state->cancelled.load(std::memory_order_acquire)) return;
+
+                auto& entry = state->entries[i];
+
+                try
+                {
+                    entry.data = fs.readFile(entry.asset.filename);
+
+                    if (decodeImages && entry.asset.type == Asset::Type::image && !isKtx(entry.data))
+                    {
+                        entry.image = decodeImage(entry.data);
+                        entry.data.clear();
+                    }
+                }
+                catch (...)
+                {
+                    entry.exception = std::current_exception();
+                }
+            });
+
+            state->entries[i].future = workerPool.run(std::move(taskGroup));
+        }
+
+        cache.addLoad(state);
+
+        return LoadHandle{state};
+    }
+
+    void Bundle::loadAssetData(Asset::Type assetType, const std::string& name, const std::string& filename,
+                               const std::vector<std::byte>& data, const Asset::Options& options)
+    {
         const auto& loaders = cache.getLoaders();
 
         for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
@@ -35,25 +182,90 @@ namespace ouzel::assets
         throw Error{"Failed to load asset " + filename};
     }
 
-    void Bundle::loadAssets(const std::string& filename)
+    bool Bundle::finishLoad(LoadHandle::State& state, std::chrono::steady_clock::time_point deadline)
     {
-        const auto data = json::parse(fileSystem.readFile(filename));
+        auto& entries = state.entries;
 
-        for (const auto& asset : data["assets"])
+        while (state.stageBegin < entries.size())
         {
-            const auto& file = asset["filename"].as<std::string>();
-            const auto& name = asset.hasMember("name") ? asset["name"].as<std::string>() : file;
-
-            Asset::Options options;
-            options.mipmaps = asset.hasMember("mipmaps") ? asset["mipmaps"].as<bool>() : true;
-            loadAsset(static_cast<Asset::Type>(asset["type"].as<std::uint32_t>()), name, file, options);
+            const auto stage = entries[state.stageBegin].stage;
+            bool stageFinished = true;
+            bool progressed = false;
+
+            for (auto i = state.stageBegin; i < entries.size() && entries[i].stage == stage; ++i)
+            {
+                auto& entry = entries[i];
+                if (entry.finished) continue;
+
+                if (!entry.future.isReady())
+                {
+                    stageFinished = false;
+                    continue;
+                }
+
+                if (finishEntry(entry))
+                    state.loadedCount.fetch_add(1, std::memory_order_release);
+                else
+                    state.failedCount.fetch_add(1, std::memory_order_release);
+                entry.finished = true;
+                progressed = true;
+
+                if (state.progressCallback)
+                    state.progressCallback(state.loadedCount.load(std::memory_order_relaxed) +
+                                           state.failedCount.load(std::memory_order_relaxed),
+                                           entries.size());
+
+                // the callback is allowed to cancel the load or to destroy the bundle
+                if (!state.bundle) return true;
+
+                if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    stageFinished = false;
+                    break;
+                }
+            }
+
+            if (!stageFinished)
+            {
+                if (!progressed || std::chrono::steady_clock::now() >= deadline) return false;
+                continue;
+            }
+
+            while (state.stageBegin < entries.size() && entries[state.stageBegin].stage == stage)
+                ++state.stageBegin;
         }
+
+        return true;
     }
 
-    void Bundle::loadAssets(const std::vector<Asset>& assets)
+    bool Bundle::finishEntry(LoadHandle::Entry& entry)
     {
-        for (const auto& asset : assets)
-            loadAsset(asset.type, asset.name, asset.filename, asset.options);
+        const auto& asset = entry.asset;
+
+        try
+        {
+            if (entry.exception)
+                std::rethrow_exception(entry.exception);
+
+            if (entry.image)
+                loadTexture(*this, asset.name, *entry.image, asset.options);
+            else if (isStreamed(asset))
+                loadAsset(asset.type, asset.name, asset.filename, asset.options);
+            else
+                loadAssetData(asset.type, asset.name, asset.filename, entry.data, asset.options);
+
+            entry.data = std::vector<std::byte>{};
+            entry.image.reset();
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            log(Log::Level::error) << "Failed to load asset " << asset.filename << ": " << e.what();
+
+            entry.data = std::vector<std::byte>{};
+            entry.image.reset();
+            return false;
+        }
     }
 
     std::shared_ptr<graphics::Texture> Bundle::getTexture(std::string_view name) const
@@ -71,11 +283,18 @@ namespace ouzel::assets
             textures.try_emplace(std::string(name), texture);
         else
             i->second = texture;
+
+        cache.updateTexture(name);
     }
 
     void Bundle::releaseTextures()
     {
+        // the assets are destroyed only after the cache index stops pointing to them
+        const auto released = std::move(textures);
         textures.clear();
+
+        for (const auto& asset : released)
+            cache.updateTexture(asset.first);
     }
 
     const graphics::Shader* Bundle::getShader(std::string_view name) const
@@ -93,11 +312,18 @@ namespace ouzel::assets
             shaders.try_emplace(std::string(name), std::move(shader));
         else
             i->second = std::move(shader);
+
+        cache.updateShader(name);
     }
 
     void Bundle::releaseShaders()
     {
+        // the assets are destroyed only after the cache index stops pointing to them
+        const auto released = std::move(shaders);
         shaders.clear();
+
+        for (const auto& asset : released)
+            cache.updateShader(asset.first);
     }
 
     const graphics::BlendState* Bundle::getBlendState(std::string_view name) const
@@ -115,11 +341,18 @@ namespace ouzel::assets
             blendStates.try_emplace(std::string(name), std::move(blendState));
         else
             i->second = std::move(blendState);
+
+        cache.updateBlendState(name);
     }
 
     void Bundle::releaseBlendStates()
     {
+        // the assets are destroyed only after the cache index stops pointing to them
+        const auto released = std::move(blendStates);
         blendStates.clear();
+
+        for (const auto& asset : released)
+            cache.updateBlendState(asset.first);
     }
 
     const graphics::DepthStencilState* Bundle::getDepthStencilState(std::string_view name) const
@@ -137,11 +370,18 @@ namespace ouzel::assets
             depthStencilStates.try_emplace(std::string(name), std::move(depthStencilState));
         else
             i->second = std::move(depthStencilState);
+
+        cache.updateDepthStencilState(name);
     }
 
     void Bundle::releaseDepthStencilStates()
     {
+        // the assets are destroyed only after the cache index stops pointing to them
+        const auto released = std::move(depthStencilStates);
         depthStencilStates.clear();
+
+        for (const auto& asset : released)
+            cache.updateDepthStencilState(asset.first);
     }
 
     const scene::SpriteData* Bundle::getSpriteData(std::string_view name) const
@@ -159,11 +399,18 @@ namespace ouzel::assets
             spriteData.try_emplace(std::string(name), newSpriteData);
         else
             i->second = newSpriteData;
+
+        cache.updateSpriteData(name);
     }
 
     void Bundle::releaseSpriteData()
     {
+        // the assets are destroyed only after the cache index stops pointing to them
+        const auto released = std::move(spriteData);
         spriteData.clear();
+
+        for (const auto& asset : released)
+            cache.updateSpriteData(asset.first);
     }
 
     const scene::ParticleSystemData* Bundle::getParticleSystemData(std::string_view name) const
@@ -181,11 +428,18 @@ namespace ouzel::assets
             particleSystemData.try_emplace(std::string(name), newParticleSystemData);
         else
             i->second = newParticleSystemData;
+
+        cache.updateParticleSystemData(name);
     }
 
     void Bundle::releaseParticleSystemData()
     {
+        // the assets are destroyed only after the cache index stops pointing to them
+        const auto released = std::move(particleSystemData);
         particleSystemData.clear();
+
+        for (const auto& asset : released)
+            cache.updateParticleSystemData(asset.first);
     }
 
     const gui::Font* Bundle::getFont(std::string_view name) const
@@ -203,11 +457,18 @@ namespace ouzel::assets
             fonts.try_emplace(std::string(name), std::move(font));
         else
             i->second = std::move(font);
+
+        cache.updateFont(name);
     }
 
     void Bundle::releaseFonts()
     {
+        // the assets are destroyed only after the cache index stops pointing to them
+        const auto released = std::move(fonts);
         fonts.clear();
+
+        for (const auto& asset : released)
+            cache.updateFont(asset.first);
     }
 
     const audio::Cue* Bundle::getCue(std::string_view name) const
@@ -225,11 +486,18 @@ namespace ouzel::assets
             cues.try_emplace(std::string(name), std::move(cue));
         else
             i->second = std::move(cue);
+
+        cache.updateCue(name);
     }
 
     void Bundle::releaseCues()
     {
+        // the assets are destroyed only after the cache index stops pointing to them
+        const auto released = std::move(cues);
         cues.clear();
+
+        for (const auto& asset : released)
+            cache.updateCue(asset.first);
     }
 
     const audio::Sound* Bundle::getSound(std::string_view name) const
@@ -247,11 +515,18 @@ namespace ouzel::assets
             sounds.try_emplace(std::string(name), std::move(sound));
         else
             i->second = std::move(sound);
+
+        cache.updateSound(name);
     }
 
     void Bundle::releaseSounds()
     {
+        // the assets are destroyed only after the cache index stops pointing to them
+        const auto released = std::move(sounds);
         sounds.clear();
+
+        for (const auto& asset : released)
+            cache.updateSound(asset.first);
     }
 
     const graphics::Material* Bundle::getMaterial(std::string_view name) const
@@ -269,11 +544,18 @@ namespace ouzel::assets
             materials.try_emplace(std::string(name), std::move(material));
         else
             i->second = std::move(material);
+
+        cache.updateMaterial(name);
     }
 
     void Bundle::releaseMaterials()
     {
+        // the assets are destroyed only after the cache index stops pointing to them
+        const auto released = std::move(materials);
         materials.clear();
+
+        for (const auto& asset : released)
+            cache.updateMaterial(asset.first);
     }
 
     const scene::SkinnedMeshData* Bundle::getSkinnedMeshData(std::string_view name) const
@@ -291,11 +573,18 @@ namespace ouzel::assets
             skinnedMeshData.try_emplace(std::string(name), std::move(newSkinnedMeshData));
         else
             i->second = std::move(newSkinnedMeshData);
+
+        cache.updateSkinnedMeshData(name);
     }
 
     void Bundle::releaseSkinnedMeshData()
     {
+        // the assets are destroyed only after the cache index stops pointing to them
+        const auto released = std::move(skinnedMeshData);
         skinnedMeshData.clear();
+
+        for (const auto& asset : released)
+            cache.updateSkinnedMeshData(asset.first);
     }
 
     const scene::StaticMeshData* Bundle::getStaticMeshData(std::string_view name) const
@@ -313,10 +602,17 @@ namespace ouzel::assets
             staticMeshData.try_emplace(std::string(name), std::move(newStaticMeshData));
         else
             i->second = std::move(newStaticMeshData);
+
+        cache.updateStaticMeshData(name);
     }
 
     void Bundle::releaseStaticMeshData()
     {
+        // the assets are destroyed only after the cache index stops pointing to them
+        const auto released = std::move(staticMeshData);
         staticMeshData.clear();
+
+        for (const auto& asset : released)
+            cache.updateStaticMeshData(asset.first);
     }
 }
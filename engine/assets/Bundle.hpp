@@ -3,12 +3,14 @@
 #ifndef OUZEL_ASSETS_BUNDLE_HPP
 #define OUZEL_ASSETS_BUNDLE_HPP
 
+#include <chrono>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
 #include <string_view>
 #include "Asset.hpp"
+#include "LoadHandle.hpp"
 #include "../audio/Cue.hpp"
 #include "../audio/Sound.hpp"
 #include "../graphics/BlendState.hpp"
@@ -30,6 +32,7 @@ namespace ouzel::assets
     class Bundle final
     {
         friend Cache;
+        friend LoadHandle;
     public:
         Bundle(Cache& initCache, storage::FileSystem& initFileSystem);
         ~Bundle();
@@ -45,6 +48,13 @@ namespace ouzel::assets
         void loadAssets(const std::string& filename);
         void loadAssets(const std::vector<Asset>& assets);
 
+        // Reads and decodes the assets on the worker pool and creates them over the following updates,
+        // only the manifest is read on the calling thread
+        LoadHandle loadAssetsAsync(const std::string& filename,
+                                   const LoadHandle::ProgressCallback& progressCallback = nullptr);
+        LoadHandle loadAssetsAsync(const std::vector<Asset>& assets,
+                                   const LoadHandle::ProgressCallback& progressCallback = nullptr);
+
         std::shared_ptr<graphics::Texture> getTexture(std::string_view name) const;
         void setTexture(std::string_view name, const std::shared_ptr<graphics::Texture>& texture);
         void releaseTextures();
@@ -94,6 +104,13 @@ namespace ouzel::assets
         void releaseStaticMeshData();
 
     private:
+        void loadAssetData(Asset::Type assetType, const std::string& name, const std::string& filename,
+                           const std::vector<std::byte>& data, const Asset::Options& options);
+
+        // returns true when all the assets of the load are finished
+        bool finishLoad(LoadHandle::State& state, std::chrono::steady_clock::time_point deadline);
+        bool finishEntry(LoadHandle::Entry& entry);
+
         Cache& cache;
         storage::FileSystem& fileSystem;
 
@@ -4,9 +4,11 @@
 #include "Cache.hpp"
 #include "BmfLoader.hpp"
 #include "ColladaLoader.hpp"
+#include "CookedLoader.hpp"
 #include "CueLoader.hpp"
 #include "GltfLoader.hpp"
 #include "ImageLoader.hpp"
+#include "KtxLoader.hpp"
 #include "MtlLoader.hpp"
 #include "ObjLoader.hpp"
 #include "ParticleSystemLoader.hpp"
@@ -21,6 +23,12 @@
 
 namespace ouzel::assets
 {
+    namespace
+    {
+        // time of an update that can be spent on creating the loaded assets
+        constexpr std::chrono::milliseconds loadTimeSlice{4};
+    }
+
     Cache::Cache()
     {
         addLoader(Asset::Type::font, loadBmf);
@@ -28,6 +36,7 @@ namespace ouzel::assets
         addLoader(Asset::Type::cue, loadCue);
         addLoader(Asset::Type::skinnedMesh, loadGltf);
         addLoader(Asset::Type::image, loadImage);
+        addLoader(Asset::Type::image, loadKtx); // tried before loadImage, passes other files to it
         addLoader(Asset::Type::material, loadMtl);
         addLoader(Asset::Type::staticMesh, loadObj);
         addLoader(Asset::Type::particleSystem, loadParticleSystem);
@@ -36,6 +45,13 @@ namespace ouzel::assets
         addLoader(Asset::Type::font, loadTtf);
         addLoader(Asset::Type::sound, loadVorbis);
         addLoader(Asset::Type::sound, loadWave);
+
+        // tried before the text format loaders, pass the files that were not cooked to them
+        addLoader(Asset::Type::sprite, loadCookedSpriteData);
+        addLoader(Asset::Type::particleSystem, loadCookedParticleSystem);
+        addLoader(Asset::Type::font, loadCookedFont);
+        addLoader(Asset::Type::staticMesh, loadCookedStaticMesh);
+        addLoader(Asset::Type::material, loadCookedMaterial);
     }
 
     void Cache::addBundle(const Bundle* bundle)
@@ -48,6 +64,43 @@ namespace ouzel::assets
     {
         if (const auto i = std::find(bundles.begin(), bundles.end(), bundle); i != bundles.end())
             bundles.erase(i);
+
+        // the assets of the bundle are replaced by the ones from other bundles in the index
+        for (const auto& texture : bundle->textures)
+            updateTexture(texture.first);
+        for (const auto& shader : bundle->shaders)
+            updateShader(shader.first);
+        for (const auto& blendState : bundle->blendStates)
+            updateBlendState(blendState.first);
+        for (const auto& depthStencilState : bundle->depthStencilStates)
+            updateDepthStencilState(depthStencilState.first);
+        for (const auto& spriteData : bundle->spriteData)
+            updateSpriteData(spriteData.first);
+        for (const auto& particleSystemData : bundle->particleSystemData)
+            updateParticleSystemData(particleSystemData.first);
+        for (const auto& font : bundle->fonts)
+            updateFont(font.first);
+        for (const auto& cue : bundle->cues)
+            updateCue(cue.first);
+        for (const auto& sound : bundle->sounds)
+            updateSound(sound.first);
+        for (const auto& material : bundle->materials)
+            updateMaterial(material.first);
+        for (const auto& skinnedMeshData : bundle->skinnedMeshData)
+            updateSkinnedMeshData(skinnedMeshData.first);
+        for (const auto& staticMeshData : bundle->staticMeshData)
+            updateStaticMeshData(staticMeshData.first);
+
+        // the workers of the loads hold a reference to the state, so they don't have to be waited for
+        for (auto i = loads.begin(); i != loads.end();)
+            if ((*i)->bundle == bundle)
+            {
+                (*i)->bundle = nullptr;
+                (*i)->cancelled.store(true, std::memory_order_release);
+                i = loads.erase(i);
+            }
+            else
+                ++i;
     }
 
     void Cache::addLoader(const Asset::Type assetType, const Loader loader)
@@ -64,111 +117,270 @@ namespace ouzel::assets
                 ++i;
     }
 
+    void Cache::addLoad(const std::shared_ptr<LoadHandle::State>& state)
+    {
+        loads.push_back(state);
+    }
+
+    void Cache::update()
+    {
+        const auto deadline = std::chrono::steady_clock::now() + loadTimeSlice;
+
+        // indices are used, because the progress callbacks can start new loads
+        for (std::size_t i = 0; i < loads.size();)
+        {
+            const auto state = loads[i];
+
+            if (!state->bundle || state->bundle->finishLoad(*state, deadline))
+            {
+                // the callback could have removed the load already
+                if (i < loads.size() && loads[i] == state)
+                    loads.erase(loads.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+            else if (std::chrono::steady_clock::now() >= deadline)
+                break;
+            else
+                ++i;
+        }
+    }
+
     std::shared_ptr<graphics::Texture> Cache::getTexture(std::string_view name) const
     {
-        for (const auto bundle : bundles)
-            if (const auto texture = bundle->getTexture(name))
-                return texture;
+        return findInIndex(textureIndex, name);
+    }
+
+    std::shared_ptr<graphics::Texture> Cache::getTexture(AssetId id) const
+    {
+        return findInIndex(textureIndex, id);
+    }
+
+    Handle<std::shared_ptr<graphics::Texture>> Cache::getTextureHandle(AssetId id)
+    {
+        return Handle<std::shared_ptr<graphics::Texture>>{&textureIndex.try_emplace(id).first->second};
+    }
 
-        return nullptr;
+    void Cache::updateTexture(std::string_view name)
+    {
+        updateIndex(textureIndex, name, &Bundle::getTexture);
     }
 
     const graphics::Shader* Cache::getShader(std::string_view name) const
     {
-        for (const auto bundle : bundles)
-            if (const auto shader = bundle->getShader(name))
-                return shader;
+        return findInIndex(shaderIndex, name);
+    }
 
-        return nullptr;
+    const graphics::Shader* Cache::getShader(AssetId id) const
+    {
+        return findInIndex(shaderIndex, id);
+    }
+
+    Handle<const graphics::Shader*> Cache::getShaderHandle(AssetId id)
+    {
+        return Handle<const graphics::Shader*>{&shaderIndex.try_emplace(id).first->second};
+    }
+
+    void Cache::updateShader(std::string_view name)
+    {
+        updateIndex(shaderIndex, name, &Bundle::getShader);
     }
 
     const graphics::BlendState* Cache::getBlendState(std::string_view name) const
     {
-        for (const auto bundle : bundles)
-            if (const auto blendState = bundle->getBlendState(name))
-                return blendState;
+        return findInIndex(blendStateIndex, name);
+    }
+
+    const graphics::BlendState* Cache::getBlendState(AssetId id) const
+    {
+        return findInIndex(blendStateIndex, id);
+    }
 
-        return nullptr;
+    Handle<const graphics::BlendState*> Cache::getBlendStateHandle(AssetId id)
+    {
+        return Handle<const graphics::BlendState*>{&blendStateIndex.try_emplace(id).first->second};
+    }
+
+    void Cache::updateBlendState(std::string_view name)
+    {
+        updateIndex(blendStateIndex, name, &Bundle::getBlendState);
     }
 
     const graphics::DepthStencilState* Cache::getDepthStencilState(std::string_view name) const
     {
-        for (const auto bundle : bundles)
-            if (const auto depthStencilState = bundle->getDepthStencilState(name))
-                return depthStencilState;
+        return findInIndex(depthStencilStateIndex, name);
+    }
+
+    const graphics::DepthStencilState* Cache::getDepthStencilState(AssetId id) const
+    {
+        return findInIndex(depthStencilStateIndex, id);
+    }
 
-        return nullptr;
+    Handle<const graphics::DepthStencilState*> Cache::getDepthStencilStateHandle(AssetId id)
+    {
+        return Handle<const graphics::DepthStencilState*>{&depthStencilStateIndex.try_emplace(id).first->second};
+    }
+
+    void Cache::updateDepthStencilState(std::string_view name)
+    {
+        updateIndex(depthStencilStateIndex, name, &Bundle::getDepthStencilState);
     }
 
     const scene::SpriteData* Cache::getSpriteData(std::string_view name) const
     {
-        for (const auto bundle : bundles)
-            if (const auto spriteData = bundle->getSpriteData(name))
-                return spriteData;
+        return findInIndex(spriteDataIndex, name);
+    }
+
+    const scene::SpriteData* Cache::getSpriteData(AssetId id) const
+    {
+        return findInIndex(spriteDataIndex, id);
+    }
+
+    Handle<const scene::SpriteData*> Cache::getSpriteDataHandle(AssetId id)
+    {
+        return Handle<const scene::SpriteData*>{&spriteDataIndex.try_emplace(id).first->second};
+    }
 
-        return nullptr;
+    void Cache::updateSpriteData(std::string_view name)
+    {
+        updateIndex(spriteDataIndex, name, &Bundle::getSpriteData);
     }
 
     const scene::ParticleSystemData* Cache::getParticleSystemData(std::string_view name) const
     {
-        for (const auto bundle : bundles)
-            if (const auto particleSystemData = bundle->getParticleSystemData(name))
-                return particleSystemData;
+        return findInIndex(particleSystemDataIndex, name);
+    }
+
+    const scene::ParticleSystemData* Cache::getParticleSystemData(AssetId id) const
+    {
+        return findInIndex(particleSystemDataIndex, id);
+    }
 
-        return nullptr;
+    Handle<const scene::ParticleSystemData*> Cache::getParticleSystemDataHandle(AssetId id)
+    {
+        return Handle<const scene::ParticleSystemData*>{&particleSystemDataIndex.try_emplace(id).first->second};
+    }
+
+    void Cache::updateParticleSystemData(std::string_view name)
+    {
+        updateIndex(particleSystemDataIndex, name, &Bundle::getParticleSystemData);
     }
 
     const gui::Font* Cache::getFont(std::string_view name) const
     {
-        for (const auto bundle : bundles)
-            if (const auto font = bundle->getFont(name))
-                return font;
+        return findInIndex(fontIndex, name);
+    }
 
-        return nullptr;
+    const gui::Font* Cache::getFont(AssetId id) const
+    {
+        return findInIndex(fontIndex, id);
+    }
+
+    Handle<const gui::Font*> Cache::getFontHandle(AssetId id)
+    {
+        return Handle<const gui::Font*>{&fontIndex.try_emplace(id).first->second};
+    }
+
+    void Cache::updateFont(std::string_view name)
+    {
+        updateIndex(fontIndex, name, &Bundle::getFont);
     }
 
     const audio::Cue* Cache::getCue(std::string_view name) const
     {
-        for (const auto bundle : bundles)
-            if (const auto cue = bundle->getCue(name))
-                return cue;
+        return findInIndex(cueIndex, name);
+    }
+
+    const audio::Cue* Cache::getCue(AssetId id) const
+    {
+        return findInIndex(cueIndex, id);
+    }
+
+    Handle<const audio::Cue*> Cache::getCueHandle(AssetId id)
+    {
+        return Handle<const audio::Cue*>{&cueIndex.try_emplace(id).first->second};
+    }
 
-        return nullptr;
+    void Cache::updateCue(std::string_view name)
+    {
+        updateIndex(cueIndex, name, &Bundle::getCue);
     }
 
     const audio::Sound* Cache::getSound(std::string_view name) const
     {
-        for (const auto bundle : bundles)
-            if (const auto sound = bundle->getSound(name))
-                return sound;
+        return findInIndex(soundIndex, name);
+    }
 
-        return nullptr;
+    const audio::Sound* Cache::getSound(AssetId id) const
+    {
+        return findInIndex(soundIndex, id);
+    }
+
+    Handle<const audio::Sound*> Cache::getSoundHandle(AssetId id)
+    {
+        return Handle<const audio::Sound*>{&soundIndex.try_emplace(id).first->second};
+    }
+
+    void Cache::updateSound(std::string_view name)
+    {
+        updateIndex(soundIndex, name, &Bundle::getSound);
     }
 
     const graphics::Material* Cache::getMaterial(std::string_view name) const
     {
-        for (const auto bundle : bundles)
-            if (const auto material = bundle->getMaterial(name))
-                return material;
+        return findInIndex(materialIndex, name);
+    }
+
+    const graphics::Material* Cache::getMaterial(AssetId id) const
+    {
+        return findInIndex(materialIndex, id);
+    }
 
-        return nullptr;
+    Handle<const graphics::Material*> Cache::getMaterialHandle(AssetId id)
+    {
+        return Handle<const graphics::Material*>{&materialIndex.try_emplace(id).first->second};
+    }
+
+    void Cache::updateMaterial(std::string_view name)
+    {
+        updateIndex(materialIndex, name, &Bundle::getMaterial);
     }
 
     const scene::SkinnedMeshData* Cache::getSkinnedMeshData(std::string_view name) const
     {
-        for (const auto bundle : bundles)
-            if (const auto meshData = bundle->getSkinnedMeshData(name))
-                return meshData;
+        return findInIndex(skinnedMeshDataIndex, name);
+    }
+
+    const scene::SkinnedMeshData* Cache::getSkinnedMeshData(AssetId id) const
+    {
+        return findInIndex(skinnedMeshDataIndex, id);
+    }
 
-        return nullptr;
+    Handle<const scene::SkinnedMeshData*> Cache::getSkinnedMeshDataHandle(AssetId id)
+    {
+        return Handle<const scene::SkinnedMeshData*>{&skinnedMeshDataIndex.try_emplace(id).first->second};
+    }
+
+    void Cache::updateSkinnedMeshData(std::string_view name)
+    {
+        updateIndex(skinnedMeshDataIndex, name, &Bundle::getSkinnedMeshData);
     }
 
     const scene::StaticMeshData* Cache::getStaticMeshData(std::string_view name) const
     {
-        for (const auto bundle : bundles)
-            if (const auto meshData = bundle->getStaticMeshData(name))
-                return meshData;
+        return findInIndex(staticMeshDataIndex, name);
+    }
+
+    const scene::StaticMeshData* Cache::getStaticMeshData(AssetId id) const
+    {
+        return findInIndex(staticMeshDataIndex, id);
+    }
 
-        return nullptr;
+    Handle<const scene::StaticMeshData*> Cache::getStaticMeshDataHandle(AssetId id)
+    {
+        return Handle<const scene::StaticMeshData*>{&staticMeshDataIndex.try_emplace(id).first->second};
+    }
+
+    void Cache::updateStaticMeshData(std::string_view name)
+    {
+        updateIndex(staticMeshDataIndex, name, &Bundle::getStaticMeshData);
     }
 }
@@ -3,12 +3,19 @@
 #ifndef OUZEL_ASSETS_CACHE_HPP
 #define OUZEL_ASSETS_CACHE_HPP
 
+#include <chrono>
 #include <memory>
+#include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include "Asset.hpp"
+#include "AssetError.hpp"
+#include "AssetId.hpp"
 #include "Bundle.hpp"
+#include "Handle.hpp"
+#include "LoadHandle.hpp"
 
 namespace ouzel::assets
 {
@@ -36,17 +43,55 @@ namespace ouzel::assets
         auto& getLoaders() const noexcept { return loaders; }
 
         std::shared_ptr<graphics::Texture> getTexture(std::string_view name) const;
+        std::shared_ptr<graphics::Texture> getTexture(AssetId id) const;
+        Handle<std::shared_ptr<graphics::Texture>> getTextureHandle(AssetId id);
+
         const graphics::Shader* getShader(std::string_view name) const;
+        const graphics::Shader* getShader(AssetId id) const;
+        Handle<const graphics::Shader*> getShaderHandle(AssetId id);
+
         const graphics::BlendState* getBlendState(std::string_view name) const;
+        const graphics::BlendState* getBlendState(AssetId id) const;
+        Handle<const graphics::BlendState*> getBlendStateHandle(AssetId id);
+
         const graphics::DepthStencilState* getDepthStencilState(std::string_view name) const;
+        const graphics::DepthStencilState* getDepthStencilState(AssetId id) const;
+        Handle<const graphics::DepthStencilState*> getDepthStencilStateHandle(AssetId id);
+
         const scene::SpriteData* getSpriteData(std::string_view name) const;
+        const scene::SpriteData* getSpriteData(AssetId id) const;
+        Handle<const scene::SpriteData*> getSpriteDataHandle(AssetId id);
+
         const scene::ParticleSystemData* getParticleSystemData(std::string_view name) const;
+        const scene::ParticleSystemData* getParticleSystemData(AssetId id) const;
+        Handle<const scene::ParticleSystemData*> getParticleSystemDataHandle(AssetId id);
+
         const gui::Font* getFont(std::string_view name) const;
+        const gui::Font* getFont(AssetId id) const;
+        Handle<const gui::Font*> getFontHandle(AssetId id);
+
         const audio::Cue* getCue(std::string_view name) const;
+        const audio::Cue* getCue(AssetId id) const;
+        Handle<const audio::Cue*> getCueHandle(AssetId id);
+
         const audio::Sound* getSound(std::string_view name) const;
+        const audio::Sound* getSound(AssetId id) const;
+        Handle<const audio::Sound*> getSoundHandle(AssetId id);
+
         const graphics::Material* getMaterial(std::string_view name) const;
+        const graphics::Material* getMaterial(AssetId id) const;
+        Handle<const graphics::Material*> getMaterialHandle(AssetId id);
+
         const scene::SkinnedMeshData* getSkinnedMeshData(std::string_view name) const;
+        const scene::SkinnedMeshData* getSkinnedMeshData(AssetId id) const;
+        Handle<const scene::SkinnedMeshData*> getSkinnedMeshDataHandle(AssetId id);
+
         const scene::StaticMeshData* getStaticMeshData(std::string_view name) const;
+        const scene::StaticMeshData* getStaticMeshData(AssetId id) const;
+        Handle<const scene::StaticMeshData*> getStaticMeshDataHandle(AssetId id);
+
+        // creates the assets of the asynchronous loads whose data is ready, called by the engine on every update
+        void update();
 
     private:
         void addBundle(const Bundle* bundle);
@@ -55,8 +100,81 @@ namespace ouzel::assets
         void addLoader(const Asset::Type assetType, const Loader loader);
         void removeLoader(const Loader loader);
 
+        void addLoad(const std::shared_ptr<LoadHandle::State>& state);
+
+        // update the index entry of the name to the asset of the first bundle that has it
+        void updateTexture(std::string_view name);
+        void updateShader(std::string_view name);
+        void updateBlendState(std::string_view name);
+        void updateDepthStencilState(std::string_view name);
+        void updateSpriteData(std::string_view name);
+        void updateParticleSystemData(std::string_view name);
+        void updateFont(std::string_view name);
+        void updateCue(std::string_view name);
+        void updateSound(std::string_view name);
+        void updateMaterial(std::string_view name);
+        void updateSkinnedMeshData(std::string_view name);
+        void updateStaticMeshData(std::string_view name);
+
+        template <class T, class Getter>
+        void updateIndex(std::unordered_map<AssetId, T>& index, std::string_view name, Getter getter)
+        {
+            T result{};
+            for (const auto bundle : bundles)
+                if (const auto asset = (bundle->*getter)(name))
+                {
+                    result = asset;
+                    break;
+                }
+
+            // the ids are hashes of the names, so two names with the same hash would share an entry
+            const AssetId id{name};
+            if (const auto [i, inserted] = names.try_emplace(id, name); !inserted && i->second != name)
+                throw Error{"Asset " + std::string{name} + " has the same id as " + i->second};
+
+            // the entries are never removed, because handles point to them
+            if (const auto i = index.find(id); i != index.end())
+                i->second = result;
+            else if (result)
+                index.emplace(id, result);
+        }
+
+        template <class T>
+        static T findInIndex(const std::unordered_map<AssetId, T>& index, AssetId id)
+        {
+            const auto i = index.find(id);
+            return (i != index.end()) ? i->second : T{};
+        }
+
+        template <class T>
+        T findInIndex(const std::unordered_map<AssetId, T>& index, std::string_view name) const
+        {
+            // a name that was never added can have the same hash as one that was
+            const AssetId id{name};
+            if (const auto i = names.find(id); i == names.end() || i->second != name)
+                return T{};
+
+            return findInIndex(index, id);
+        }
+
         std::vector<const Bundle*> bundles;
         std::vector<std::pair<Asset::Type, Loader>> loaders;
+        std::vector<std::shared_ptr<LoadHandle::State>> loads;
+
+        std::unordered_map<AssetId, std::string> names; // names of the ids in the indices
+
+        std::unordered_map<AssetId, std::shared_ptr<graphics::Texture>> textureIndex;
+        std::unordered_map<AssetId, const graphics::Shader*> shaderIndex;
+        std::unordered_map<AssetId, const graphics::BlendState*> blendStateIndex;
+        std::unordered_map<AssetId, const graphics::DepthStencilState*> depthStencilStateIndex;
+        std::unordered_map<AssetId, const scene::SpriteData*> spriteDataIndex;
+        std::unordered_map<AssetId, const scene::ParticleSystemData*> particleSystemDataIndex;
+        std::unordered_map<AssetId, const gui::Font*> fontIndex;
+        std::unordered_map<AssetId, const audio::Cue*> cueIndex;
+        std::unordered_map<AssetId, const audio::Sound*> soundIndex;
+        std::unordered_map<AssetId, const graphics::Material*> materialIndex;
+        std::unordered_map<AssetId, const scene::SkinnedMeshData*> skinnedMeshDataIndex;
+        std::unordered_map<AssetId, const scene::StaticMeshData*> staticMeshDataIndex;
     };
 }
 
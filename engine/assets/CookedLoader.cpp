@@ -0,0 +1,457 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+#include "CookedLoader.hpp"
+#include "AssetError.hpp"
+#include "Cache.hpp"
+#include "../core/Engine.hpp"
+#include "../formats/Cooked.hpp"
+#include "../graphics/Material.hpp"
+#include "../gui/BMFont.hpp"
+#include "../scene/ParticleSystem.hpp"
+#include "../scene/SpriteRenderer.hpp"
+#include "../scene/StaticMeshRenderer.hpp"
+
+namespace ouzel::assets
+{
+    namespace
+    {
+        std::shared_ptr<graphics::Texture> getTexture(Bundle& bundle,
+                                                      std::string_view filename,
+                                                      const Asset::Options& options)
+        {
+            if (filename.empty()) return nullptr;
+
+            auto texture = bundle.getTexture(filename);
+            if (!texture)
+            {
+                const std::string textureFilename{filename};
+                bundle.loadAsset(Asset::Type::image, textureFilename, textureFilename, options);
+                texture = bundle.getTexture(filename);
+            }
+
+            return texture;
+        }
+
+        math::Vector<float, 2> readVector(const cooked::Reader& reader, std::size_t offset)
+        {
+            return math::Vector<float, 2>{
+                reader.read<float>(offset),
+                reader.read<float>(offset + 4)
+            };
+        }
+
+        math::Color readColor(const cooked::Reader& reader, std::size_t offset)
+        {
+            return math::Color{
+                reader.read<std::uint8_t>(offset),
+                reader.read<std::uint8_t>(offset + 1),
+                reader.read<std::uint8_t>(offset + 2),
+                reader.read<std::uint8_t>(offset + 3)
+            };
+        }
+
+        // vertices of the sprite frames that are not rectangles, the coordinates are in pixels of the source image
+        std::vector<graphics::Vertex> readSpriteVertices(const cooked::Reader& reader,
+                                                         std::size_t offset,
+                                                         const math::Size<float, 2>& textureSize,
+                                                         const math::Vector<float, 2>& finalOffset)
+        {
+            const auto range = reader.readRange(offset, cooked::sprite::vertexSize);
+
+            std::vector<graphics::Vertex> vertices;
+            vertices.reserve(range.count);
+
+            for (std::size_t i = 0; i < range.count; ++i)
+            {
+                const auto vertexOffset = range.offset + i * cooked::sprite::vertexSize;
+                const auto position = readVector(reader, vertexOffset);
+                const auto texCoord = readVector(reader, vertexOffset + 8);
+
+                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + finalOffset.v[0], -position.v[1] - finalOffset.v[1], 0.0F},
+                                      math::whiteColor,
+                                      math::Vector<float, 2>{texCoord.v[0] / textureSize.v[0], texCoord.v[1] / textureSize.v[1]},
+                                      math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+            }
+
+            return vertices;
+        }
+    }
+
+    bool isCooked(const std::vector<std::byte>& data) noexcept
+    {
+        return cooked::Reader::isCooked(data.data(), data.size());
+    }
+
+    bool loadCookedSpriteData(Cache&,
+                              Bundle& bundle,
+                              const std::string& name,
+                              const std::vector<std::byte>& data,
+                              const Asset::Options& options)
+    {
+        if (!isCooked(data)) return false;
+
+        const cooked::Reader reader{data.data(), data.size()};
+        reader.expect(cooked::Kind::spriteData, cooked::sprite::rootSize);
+
+        constexpr auto root = cooked::headerSize;
+
+        scene::SpriteData spriteData;
+        spriteData.texture = getTexture(bundle, reader.readString(root), options);
+
+        if (!spriteData.texture)
+            throw Error{"Sprite texture not found"};
+
+        const math::Size<float, 2> textureSize{
+            static_cast<float>(spriteData.texture->getSize().v[0]),
+            static_cast<float>(spriteData.texture->getSize().v[1])
+        };
+
+        const auto animations = reader.readRange(root + cooked::rangeSize, cooked::sprite::animationSize);
+
+        for (std::size_t i = 0; i < animations.count; ++i)
+        {
+            const auto animationOffset = animations.offset + i * cooked::sprite::animationSize;
+
+            scene::SpriteData::Animation animation;
+            animation.name = std::string{reader.readString(animationOffset)};
+
+            const auto frames = reader.readRange(animationOffset + cooked::rangeSize, cooked::sprite::frameSize);
+            animation.frames.reserve(frames.count);
+
+            for (std::size_t f = 0; f < frames.count; ++f)
+            {
+                const auto frameOffset = frames.offset + f * cooked::sprite::frameSize;
+
+                const std::string frameName{reader.readString(frameOffset)};
+                const math::Rect<float> rectangle{
+                    reader.read<float>(frameOffset + 8),
+                    reader.read<float>(frameOffset + 12),
+                    reader.read<float>(frameOffset + 16),
+                    reader.read<float>(frameOffset + 20)
+                };
+                const auto sourceSizeVector = readVector(reader, frameOffset + 24);
+                const math::Size<float, 2> sourceSize{sourceSizeVector.v[0], sourceSizeVector.v[1]};
+                const auto sourceOffset = readVector(reader, frameOffset + 32);
+                const auto pivot = readVector(reader, frameOffset + 40);
+                const auto rotated = reader.read<bool>(frameOffset + 48);
+
+                // frames with indices are polygons
+                if (const auto indices = reader.readArray<std::uint16_t>(frameOffset + 64); !indices.empty())
+                {
+                    const math::Vector<float, 2> finalOffset{
+                        -sourceSize.v[0] * pivot.v[0] + sourceOffset.v[0],
+                        -sourceSize.v[1] * pivot.v[1] + (sourceSize.v[1] - rectangle.size.v[1] - sourceOffset.v[1])
+                    };
+
+                    const auto vertices = readSpriteVertices(reader, frameOffset + 56, textureSize, finalOffset);
+
+                    if (std::any_of(indices.begin(), indices.end(), [&vertices](std::uint16_t index) noexcept {
+                        return index >= vertices.size();
+                    }))
+                        throw Error{"Invalid sprite frame index"};
+
+                    animation.frames.emplace_back(frameName, indices, vertices, rectangle, sourceSize, sourceOffset, pivot);
+                }
+                else
+                    animation.frames.emplace_back(frameName, textureSize, rectangle, rotated, sourceSize, sourceOffset, pivot);
+            }
+
+            auto animationName = animation.name;
+            spriteData.animations[std::move(animationName)] = std::move(animation);
+        }
+
+        bundle.setSpriteData(name, spriteData);
+
+        return true;
+    }
+
+    bool loadCookedParticleSystem(Cache&,
+                                  Bundle& bundle,
+                                  const std::string& name,
+                                  const std::vector<std::byte>& data,
+                                  const Asset::Options& options)
+    {
+        if (!isCooked(data)) return false;
+
+        const cooked::Reader reader{data.data(), data.size()};
+        reader.expect(cooked::Kind::particleSystem, cooked::particleSystem::rootSize);
+
+        using Field = cooked::particleSystem::Field;
+        constexpr auto root = cooked::headerSize;
+
+        scene::ParticleSystemData particleSystemData;
+        particleSystemData.name = std::string{reader.readString(root)};
+
+        const auto mask = reader.read<std::uint64_t>(root + cooked::particleSystem::maskOffset);
+
+        // only the fields set in the source file are read, the others keep their default values
+        for (std::size_t i = 0; i < cooked::particleSystem::fieldCount; ++i)
+        {
+            if (!(mask & (std::uint64_t{1} << i))) continue;
+
+            const auto valueOffset = root + cooked::particleSystem::valuesOffset + i * 4;
+            const auto integer = [&reader, valueOffset]() { return reader.read<std::uint32_t>(valueOffset); };
+            const auto number = [&reader, valueOffset]() { return reader.read<float>(valueOffset); };
+
+            switch (static_cast<Field>(i))
+            {
+                case Field::blendFuncSource: particleSystemData.blendFuncSource = integer(); break;
+                case Field::blendFuncDestination: particleSystemData.blendFuncDestination = integer(); break;
+                case Field::emitterType:
+                    switch (integer())
+                    {
+                        case 0: particleSystemData.emitterType = scene::ParticleSystemData::EmitterType::gravity; break;
+                        case 1: particleSystemData.emitterType = scene::ParticleSystemData::EmitterType::radius; break;
+                        default: throw Error{"Unsupported emitter type"};
+                    }
+                    break;
+                case Field::maxParticles: particleSystemData.maxParticles = integer(); break;
+                case Field::duration: particleSystemData.duration = number(); break;
+                case Field::particleLifespan: particleSystemData.particleLifespan = number(); break;
+                case Field::particleLifespanVariance: particleSystemData.particleLifespanVariance = number(); break;
+                case Field::speed: particleSystemData.speed = number(); break;
+                case Field::speedVariance: particleSystemData.speedVariance = number(); break;
+                case Field::absolutePosition: particleSystemData.absolutePosition = (integer() != 0); break;
+                case Field::yCoordFlipped: particleSystemData.yCoordFlipped = (integer() == 1); break;
+                case Field::sourcePositionX: particleSystemData.sourcePosition.v[0] = number(); break;
+                case Field::sourcePositionY: particleSystemData.sourcePosition.v[1] = number(); break;
+                case Field::sourcePositionVarianceX: particleSystemData.sourcePositionVariance.v[0] = number(); break;
+                case Field::sourcePositionVarianceY: particleSystemData.sourcePositionVariance.v[1] = number(); break;
+                case Field::startParticleSize: particleSystemData.startParticleSize = number(); break;
+                case Field::startParticleSizeVariance: particleSystemData.startParticleSizeVariance = number(); break;
+                case Field::finishParticleSize: particleSystemData.finishParticleSize = number(); break;
+                case Field::finishParticleSizeVariance: particleSystemData.finishParticleSizeVariance = number(); break;
+                case Field::angle: particleSystemData.angle = number(); break;
+                case Field::angleVariance: particleSystemData.angleVariance = number(); break;
+                case Field::startRotation: particleSystemData.startRotation = number(); break;
+                case Field::startRotationVariance: particleSystemData.startRotationVariance = number(); break;
+                case Field::finishRotation: particleSystemData.finishRotation = number(); break;
+                case Field::finishRotationVariance: particleSystemData.finishRotationVariance = number(); break;
+                case Field::rotatePerSecond: particleSystemData.rotatePerSecond = number(); break;
+                case Field::rotatePerSecondVariance: particleSystemData.rotatePerSecondVariance = number(); break;
+                case Field::minRadius: particleSystemData.minRadius = number(); break;
+                case Field::minRadiusVariance: particleSystemData.minRadiusVariance = number(); break;
+                case Field::maxRadius: particleSystemData.maxRadius = number(); break;
+                case Field::maxRadiusVariance: particleSystemData.maxRadiusVariance = number(); break;
+                case Field::radialAcceleration: particleSystemData.radialAcceleration = number(); break;
+                case Field::radialAccelVariance: particleSystemData.radialAccelVariance = number(); break;
+                case Field::tangentialAcceleration: particleSystemData.tangentialAcceleration = number(); break;
+                case Field::tangentialAccelVariance: particleSystemData.tangentialAccelVariance = number(); break;
+                case Field::rotationIsDir: particleSystemData.rotationIsDir = (integer() != 0); break;
+                case Field::gravityX: particleSystemData.gravity.v[0] = number(); break;
+                case Field::gravityY: particleSystemData.gravity.v[1] = number(); break;
+                case Field::startColorRed: particleSystemData.startColorRed = number(); break;
+                case Field::startColorGreen: particleSystemData.startColorGreen = number(); break;
+                case Field::startColorBlue: particleSystemData.startColorBlue = number(); break;
+                case Field::startColorAlpha: particleSystemData.startColorAlpha = number(); break;
+                case Field::startColorRedVariance: particleSystemData.startColorRedVariance = number(); break;
+                case Field::startColorGreenVariance: particleSystemData.startColorGreenVariance = number(); break;
+                case Field::startColorBlueVariance: particleSystemData.startColorBlueVariance = number(); break;
+                case Field::startColorAlphaVariance: particleSystemData.startColorAlphaVariance = number(); break;
+                case Field::finishColorRed: particleSystemData.finishColorRed = number(); break;
+                case Field::finishColorGreen: particleSystemData.finishColorGreen = number(); break;
+                case Field::finishColorBlue: particleSystemData.finishColorBlue = number(); break;
+                case Field::finishColorAlpha: particleSystemData.finishColorAlpha = number(); break;
+                case Field::finishColorRedVariance: particleSystemData.finishColorRedVariance = number(); break;
+                case Field::finishColorGreenVariance: particleSystemData.finishColorGreenVariance = number(); break;
+                case Field::finishColorBlueVariance: particleSystemData.finishColorBlueVariance = number(); break;
+                case Field::finishColorAlphaVariance: particleSystemData.finishColorAlphaVariance = number(); break;
+                default: throw Error{"Invalid particle system field"};
+            }
+        }
+
+        particleSystemData.texture = getTexture(bundle, reader.readString(root + cooked::rangeSize), options);
+
+        particleSystemData.emissionRate = static_cast<float>(particleSystemData.maxParticles) / particleSystemData.particleLifespan;
+
+        bundle.setParticleSystemData(name, particleSystemData);
+
+        return true;
+    }
+
+    bool loadCookedFont(Cache&,
+                        Bundle& bundle,
+                        const std::string& name,
+                        const std::vector<std::byte>& data,
+                        const Asset::Options&)
+    {
+        if (!isCooked(data)) return false;
+
+        const cooked::Reader reader{data.data(), data.size()};
+        reader.expect(cooked::Kind::font, cooked::font::rootSize);
+
+        constexpr auto root = cooked::headerSize;
+
+        const auto characters = reader.readRange(root + 24, cooked::font::characterSize);
+
+        std::unordered_map<char32_t, gui::BMFont::CharDescriptor> chars;
+        chars.reserve(characters.count);
+
+        for (std::size_t i = 0; i < characters.count; ++i)
+        {
+            const auto offset = characters.offset + i * cooked::font::characterSize;
+
+            gui::BMFont::CharDescriptor c;
+            c.x = reader.read<std::int16_t>(offset + 4);
+            c.y = reader.read<std::int16_t>(offset + 6);
+            c.width = reader.read<std::int16_t>(offset + 8);
+            c.height = reader.read<std::int16_t>(offset + 10);
+            c.xOffset = reader.read<std::int16_t>(offset + 12);
+            c.yOffset = reader.read<std::int16_t>(offset + 14);
+            c.xAdvance = reader.read<std::int16_t>(offset + 16);
+            c.page = reader.read<std::int16_t>(offset + 18);
+            chars.insert_or_assign(reader.read<std::uint32_t>(offset), c);
+        }
+
+        const auto kerningPairs = reader.readRange(root + 32, cooked::font::kerningPairSize);
+
+        std::map<std::pair<char32_t, char32_t>, std::int16_t> kern;
+
+        for (std::size_t i = 0; i < kerningPairs.count; ++i)
+        {
+            const auto offset = kerningPairs.offset + i * cooked::font::kerningPairSize;
+
+            const std::pair<char32_t, char32_t> pair{
+                reader.read<std::uint32_t>(offset),
+                reader.read<std::uint32_t>(offset + 4)
+            };
+            kern[pair] = reader.read<std::int16_t>(offset + 8);
+        }
+
+        // like in the text format, the page texture has to be loaded before the font
+        auto font = std::make_unique<gui::BMFont>(reader.read<std::uint16_t>(root),
+                                                  reader.read<std::uint16_t>(root + 2),
+                                                  reader.read<std::uint16_t>(root + 4),
+                                                  reader.read<std::uint16_t>(root + 6),
+                                                  reader.read<std::uint16_t>(root + 8),
+                                                  reader.read<std::uint16_t>(root + 10),
+                                                  std::move(chars),
+                                                  std::move(kern),
+                                                  engine->getCache().getTexture(reader.readString(root + 16)));
+        bundle.setFont(name, std::move(font));
+
+        return true;
+    }
+
+    bool loadCookedStaticMesh(Cache&,
+                              Bundle& bundle,
+                              const std::string& name,
+                              const std::vector<std::byte>& data,
+                              const Asset::Options& options)
+    {
+        if (!isCooked(data)) return false;
+
+        const cooked::Reader reader{data.data(), data.size()};
+        reader.expect(cooked::Kind::staticMesh, cooked::staticMesh::rootSize);
+
+        constexpr auto root = cooked::headerSize;
+
+        if (const auto materialLibrary = reader.readString(root); !materialLibrary.empty())
+        {
+            const std::string filename{materialLibrary};
+            bundle.loadAsset(Asset::Type::material, filename, filename, options);
+        }
+
+        const auto meshes = reader.readRange(root + cooked::rangeSize, cooked::staticMesh::meshSize);
+
+        // the vertices are stored in the memory layout of graphics::Vertex
+        const bool copyVertices = cooked::isLittleEndianHost() &&
+            sizeof(graphics::Vertex) == cooked::staticMesh::vertexSize &&
+            offsetof(graphics::Vertex, color) == 12 &&
+            offsetof(graphics::Vertex, texCoords) == 16 &&
+            offsetof(graphics::Vertex, normal) == 32;
+
+        for (std::size_t i = 0; i < meshes.count; ++i)
+        {
+            const auto meshOffset = meshes.offset + i * cooked::staticMesh::meshSize;
+
+            const auto meshName = reader.readString(meshOffset);
+            const auto materialName = reader.readString(meshOffset + 8);
+            const auto material = materialName.empty() ? nullptr : bundle.getMaterial(materialName);
+
+            math::Box<float, 3> boundingBox;
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+                boundingBox.min.v[c] = reader.read<float>(meshOffset + 16 + c * 4);
+                boundingBox.max.v[c] = reader.read<float>(meshOffset + 28 + c * 4);
+            }
+
+            const auto vertexRange = reader.readRange(meshOffset + 40, cooked::staticMesh::vertexSize);
+            std::vector<graphics::Vertex> vertices(vertexRange.count);
+
+            if (copyVertices)
+                std::memcpy(vertices.data(), data.data() + vertexRange.offset, vertexRange.count * cooked::staticMesh::vertexSize);
+            else
+                for (std::size_t v = 0; v < vertexRange.count; ++v)
+                {
+                    const auto vertexOffset = vertexRange.offset + v * cooked::staticMesh::vertexSize;
+                    auto& vertex = vertices[v];
+
+                    for (std::size_t c = 0; c < 3; ++c)
+                        vertex.position.v[c] = reader.read<float>(vertexOffset + c * 4);
+                    vertex.color = readColor(reader, vertexOffset + 12);
+                    vertex.texCoords[0] = readVector(reader, vertexOffset + 16);
+                    vertex.texCoords[1] = readVector(reader, vertexOffset + 24);
+                    for (std::size_t c = 0; c < 3; ++c)
+                        vertex.normal.v[c] = reader.read<float>(vertexOffset + 32 + c * 4);
+                }
+
+            const auto indices = reader.readArray<std::uint32_t>(meshOffset + 48);
+
+            if (std::any_of(indices.begin(), indices.end(), [&vertices](std::uint32_t index) noexcept {
+                return index >= vertices.size();
+            }))
+                throw Error{"Invalid mesh index"};
+
+            // the geometry before the first object definition belongs to an object with the name of the asset
+            bundle.setStaticMeshData(meshName.empty() ? name : meshName,
+                                     scene::StaticMeshData{boundingBox, indices, vertices, material});
+        }
+
+        return true;
+    }
+
+    bool loadCookedMaterial(Cache& cache,
+                            Bundle& bundle,
+                            const std::string& name,
+                            const std::vector<std::byte>& data,
+                            const Asset::Options& options)
+    {
+        if (!isCooked(data)) return false;
+
+        const cooked::Reader reader{data.data(), data.size()};
+        reader.expect(cooked::Kind::material, cooked::material::rootSize);
+
+        constexpr auto root = cooked::headerSize;
+
+        const auto materials = reader.readRange(root, cooked::material::materialSize);
+
+        for (std::size_t i = 0; i < materials.count; ++i)
+        {
+            const auto offset = materials.offset + i * cooked::material::materialSize;
+
+            auto diffuseTexture = getTexture(bundle, reader.readString(offset + 8), options);
+
+            auto material = std::make_unique<graphics::Material>();
+            material->blendState = cache.getBlendState(blendAlpha);
+            material->shader = diffuseTexture ? cache.getShader(shaderTexture) : cache.getShader(shaderColor);
+            material->textures[0] = std::move(diffuseTexture);
+            material->textures[1] = getTexture(bundle, reader.readString(offset + 16), options);
+            material->ambientColor = readColor(reader, offset + 24);
+            material->diffuseColor = readColor(reader, offset + 28);
+            material->opacity = reader.read<float>(offset + 32);
+            material->cullMode = graphics::CullMode::back;
+
+            // the attributes before the first material definition belong to a material with the name of the asset
+            const auto materialName = reader.readString(offset);
+            bundle.setMaterial(materialName.empty() ? name : materialName, std::move(material));
+        }
+
+        return true;
+    }
+}
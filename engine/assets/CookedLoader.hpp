@@ -0,0 +1,45 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETS_COOKEDLOADER_HPP
+#define OUZEL_ASSETS_COOKEDLOADER_HPP
+
+#include "Bundle.hpp"
+
+namespace ouzel::assets
+{
+    // checks only the file identifier
+    bool isCooked(const std::vector<std::byte>& data) noexcept;
+
+    // loaders of the assets cooked by the ouzel tool, they pass all other files to the text format loaders
+    bool loadCookedSpriteData(Cache& cache,
+                              Bundle& bundle,
+                              const std::string& name,
+                              const std::vector<std::byte>& data,
+                              const Asset::Options& options);
+
+    bool loadCookedParticleSystem(Cache& cache,
+                                  Bundle& bundle,
+                                  const std::string& name,
+                                  const std::vector<std::byte>& data,
+                                  const Asset::Options& options);
+
+    bool loadCookedFont(Cache& cache,
+                        Bundle& bundle,
+                        const std::string& name,
+                        const std::vector<std::byte>& data,
+                        const Asset::Options& options);
+
+    bool loadCookedStaticMesh(Cache& cache,
+                              Bundle& bundle,
+                              const std::string& name,
+                              const std::vector<std::byte>& data,
+                              const Asset::Options& options);
+
+    bool loadCookedMaterial(Cache& cache,
+                            Bundle& bundle,
+                            const std::string& name,
+                            const std::vector<std::byte>& data,
+                            const Asset::Options& options);
+}
+
+#endif // OUZEL_ASSETS_COOKEDLOADER_HPP
@@ -0,0 +1,39 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETS_HANDLE_HPP
+#define OUZEL_ASSETS_HANDLE_HPP
+
+namespace ouzel::assets
+{
+    class Cache;
+
+    // Stable reference to an asset in the cache, it points to the asset that is currently loaded
+    // under its name, so it stays valid when the asset is released or loaded again by any bundle
+    template <class T>
+    class Handle final
+    {
+        friend Cache;
+    public:
+        Handle() noexcept = default;
+
+        [[nodiscard]] T get() const
+        {
+            return slot ? *slot : T{};
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return slot && *slot;
+        }
+
+    private:
+        explicit Handle(const T* initSlot) noexcept:
+            slot{initSlot}
+        {
+        }
+
+        const T* slot = nullptr;
+    };
+}
+
+#endif // OUZEL_ASSETS_HANDLE_HPP
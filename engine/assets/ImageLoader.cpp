@@ -43,11 +43,7 @@
 
 namespace ouzel::assets
 {
-    bool loadImage(Cache&,
-                   Bundle& bundle,
-                   const std::string& name,
-                   const std::vector<std::byte>& data,
-                   const Asset::Options& options)
+    graphics::Image decodeImage(const std::vector<std::byte>& data)
     {
         int width;
         int height;
@@ -135,7 +131,7 @@ namespace ouzel::assets
                 throw Error{"Unsupported pixel format"};
         }
 
-        const graphics::Image image{
+        return graphics::Image{
             pixelFormat,
             math::Size<std::uint32_t, 2>{
                 static_cast<std::uint32_t>(width),
@@ -143,7 +139,13 @@ namespace ouzel::assets
             },
             imageData
         };
+    }
 
+    void loadTexture(Bundle& bundle,
+                     const std::string& name,
+                     const graphics::Image& image,
+                     const Asset::Options& options)
+    {
         auto texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
                                                            image.getData(),
                                                            image.getSize(),
@@ -152,7 +154,15 @@ namespace ouzel::assets
                                                            image.getPixelFormat());
 
         bundle.setTexture(name, texture);
+    }
 
+    bool loadImage(Cache&,
+                   Bundle& bundle,
+                   const std::string& name,
+                   const std::vector<std::byte>& data,
+                   const Asset::Options& options)
+    {
+        loadTexture(bundle, name, decodeImage(data), options);
         return true;
     }
 }
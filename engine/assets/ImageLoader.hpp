@@ -4,9 +4,19 @@
 #define OUZEL_ASSETS_IMAGELOADER_HPP
 
 #include "Bundle.hpp"
+#include "../graphics/Image.hpp"
 
 namespace ouzel::assets
 {
+    // decodes the image without touching the graphics device, so it can be called from worker threads
+    graphics::Image decodeImage(const std::vector<std::byte>& data);
+
+    // must be called on the update thread
+    void loadTexture(Bundle& bundle,
+                     const std::string& name,
+                     const graphics::Image& image,
+                     const Asset::Options& options);
+
     bool loadImage(Cache& cache,
                    Bundle& bundle,
                    const std::string& name,
@@ -0,0 +1,181 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include "KtxLoader.hpp"
+#include "AssetError.hpp"
+#include "../core/Engine.hpp"
+#include "../graphics/Texture.hpp"
+#include "../utils/Utils.hpp"
+
+namespace ouzel::assets
+{
+    namespace
+    {
+        constexpr std::array<std::uint8_t, 12> identifier = {
+            0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+        };
+        constexpr std::uint32_t endianness = 0x04030201U;
+        constexpr std::size_t headerSize = 64;
+
+        // OpenGL enums used by the KTX header
+        constexpr std::uint32_t glUnsignedByte = 0x1401;
+        constexpr std::uint32_t glRgba = 0x1908;
+        constexpr std::uint32_t glRgba8 = 0x8058;
+        constexpr std::uint32_t glSrgb8Alpha8 = 0x8C43;
+        constexpr std::uint32_t glCompressedRgbaS3tcDxt1 = 0x83F1;
+        constexpr std::uint32_t glCompressedRgbaS3tcDxt5 = 0x83F3;
+        constexpr std::uint32_t glCompressedSrgbAlphaS3tcDxt1 = 0x8C4D;
+        constexpr std::uint32_t glCompressedSrgbAlphaS3tcDxt5 = 0x8C4F;
+        constexpr std::uint32_t glCompressedRedRgtc1 = 0x8DBB;
+        constexpr std::uint32_t glCompressedRgRgtc2 = 0x8DBD;
+        constexpr std::uint32_t glCompressedRgbaBptcUnorm = 0x8E8C;
+        constexpr std::uint32_t glCompressedSrgbAlphaBptcUnorm = 0x8E8D;
+        constexpr std::uint32_t glCompressedRgb8Etc2 = 0x9274;
+        constexpr std::uint32_t glCompressedSrgb8Etc2 = 0x9275;
+        constexpr std::uint32_t glCompressedRgba8Etc2Eac = 0x9278;
+        constexpr std::uint32_t glCompressedSrgb8Alpha8Etc2Eac = 0x9279;
+        constexpr std::uint32_t glCompressedRgbaAstc4x4 = 0x93B0;
+        constexpr std::uint32_t glCompressedSrgb8Alpha8Astc4x4 = 0x93D0;
+
+        graphics::PixelFormat getPixelFormat(std::uint32_t glType,
+                                             std::uint32_t glFormat,
+                                             std::uint32_t glInternalFormat)
+        {
+            // uncompressed data must be stored in a format that can be uploaded without a conversion
+            if (glType != 0)
+            {
+                if (glType != glUnsignedByte || glFormat != glRgba)
+                    throw Error{"Unsupported KTX pixel type"};
+
+                switch (glInternalFormat)
+                {
+                    case glRgba8: return graphics::PixelFormat::rgba8UnsignedNorm;
+                    case glSrgb8Alpha8: return graphics::PixelFormat::rgba8UnsignedNormSRGB;
+                    default: throw Error{"Unsupported KTX pixel format"};
+                }
+            }
+
+            switch (glInternalFormat)
+            {
+                case glCompressedRgbaS3tcDxt1: return graphics::PixelFormat::bc1RgbaUnsignedNorm;
+                case glCompressedSrgbAlphaS3tcDxt1: return graphics::PixelFormat::bc1RgbaUnsignedNormSRGB;
+                case glCompressedRgbaS3tcDxt5: return graphics::PixelFormat::bc3RgbaUnsignedNorm;
+                case glCompressedSrgbAlphaS3tcDxt5: return graphics::PixelFormat::bc3RgbaUnsignedNormSRGB;
+                case glCompressedRedRgtc1: return graphics::PixelFormat::bc4RUnsignedNorm;
+                case glCompressedRgRgtc2: return graphics::PixelFormat::bc5RgUnsignedNorm;
+                case glCompressedRgbaBptcUnorm: return graphics::PixelFormat::bc7RgbaUnsignedNorm;
+                case glCompressedSrgbAlphaBptcUnorm: return graphics::PixelFormat::bc7RgbaUnsignedNormSRGB;
+                case glCompressedRgb8Etc2: return graphics::PixelFormat::etc2RgbUnsignedNorm;
+                case glCompressedSrgb8Etc2: return graphics::PixelFormat::etc2RgbUnsignedNormSRGB;
+                case glCompressedRgba8Etc2Eac: return graphics::PixelFormat::etc2RgbaUnsignedNorm;
+                case glCompressedSrgb8Alpha8Etc2Eac: return graphics::PixelFormat::etc2RgbaUnsignedNormSRGB;
+                case glCompressedRgbaAstc4x4: return graphics::PixelFormat::astc4x4RgbaUnsignedNorm;
+                case glCompressedSrgb8Alpha8Astc4x4: return graphics::PixelFormat::astc4x4RgbaUnsignedNormSRGB;
+                default: throw Error{"Unsupported KTX pixel format"};
+            }
+        }
+    }
+
+    bool isKtx(const std::vector<std::byte>& data) noexcept
+    {
+        return data.size() >= identifier.size() &&
+            std::equal(identifier.begin(), identifier.end(), data.begin(), [](std::uint8_t a, std::byte b) noexcept {
+                return a == static_cast<std::uint8_t>(b);
+            });
+    }
+
+    bool loadKtx(Cache&,
+                 Bundle& bundle,
+                 const std::string& name,
+                 const std::vector<std::byte>& data,
+                 const Asset::Options& options)
+    {
+        // let the other image loaders handle the file
+        if (!isKtx(data)) return false;
+
+        if (data.size() < headerSize)
+            throw Error{"Invalid KTX file"};
+
+        auto offset = identifier.size();
+
+        if (decodeLittleEndian<std::uint32_t>(data.data() + offset) != endianness)
+            throw Error{"Big endian KTX files are not supported"};
+        offset += sizeof(std::uint32_t);
+
+        const auto glType = decodeLittleEndian<std::uint32_t>(data.data() + offset);
+        offset += sizeof(std::uint32_t) * 2; // glTypeSize is implied by the type
+        const auto glFormat = decodeLittleEndian<std::uint32_t>(data.data() + offset);
+        offset += sizeof(std::uint32_t);
+        const auto glInternalFormat = decodeLittleEndian<std::uint32_t>(data.data() + offset);
+        offset += sizeof(std::uint32_t) * 2; // glBaseInternalFormat is implied by the internal format
+        const auto width = decodeLittleEndian<std::uint32_t>(data.data() + offset);
+        offset += sizeof(std::uint32_t);
+        const auto height = decodeLittleEndian<std::uint32_t>(data.data() + offset);
+        offset += sizeof(std::uint32_t);
+        const auto depth = decodeLittleEndian<std::uint32_t>(data.data() + offset);
+        offset += sizeof(std::uint32_t);
+        const auto arrayElementCount = decodeLittleEndian<std::uint32_t>(data.data() + offset);
+        offset += sizeof(std::uint32_t);
+        const auto faceCount = decodeLittleEndian<std::uint32_t>(data.data() + offset);
+        offset += sizeof(std::uint32_t);
+        const auto levelCount = decodeLittleEndian<std::uint32_t>(data.data() + offset);
+        offset += sizeof(std::uint32_t);
+        const std::size_t keyValueDataSize = decodeLittleEndian<std::uint32_t>(data.data() + offset);
+        offset += sizeof(std::uint32_t);
+
+        if (width == 0 || height == 0 || depth > 1 || arrayElementCount > 0 || faceCount != 1)
+            throw Error{"Only 2D KTX textures are supported"};
+
+        if (levelCount == 0)
+            throw Error{"KTX file does not contain any mip levels"};
+
+        const auto pixelFormat = getPixelFormat(glType, glFormat, glInternalFormat);
+
+        if (data.size() - offset < keyValueDataSize)
+            throw Error{"Invalid KTX file"};
+        offset += keyValueDataSize;
+
+        // the levels that are not needed are not copied
+        const auto usedLevelCount = options.mipmaps ? levelCount : 1U;
+
+        std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levels;
+        levels.reserve(usedLevelCount);
+
+        math::Size<std::uint32_t, 2> levelSize{width, height};
+
+        for (std::uint32_t level = 0; level < usedLevelCount; ++level)
+        {
+            if (data.size() - offset < sizeof(std::uint32_t))
+                throw Error{"Invalid KTX file"};
+
+            const std::size_t imageSize = decodeLittleEndian<std::uint32_t>(data.data() + offset);
+            offset += sizeof(std::uint32_t);
+
+            if (imageSize != graphics::getLevelSize(pixelFormat, levelSize.v[0], levelSize.v[1]) ||
+                data.size() - offset < imageSize)
+                throw Error{"Invalid KTX level size"};
+
+            const auto levelData = reinterpret_cast<const std::uint8_t*>(data.data() + offset);
+            levels.emplace_back(levelSize, std::vector<std::uint8_t>(levelData, levelData + imageSize));
+
+            // the levels are aligned to 4 bytes
+            offset += (imageSize + 3U) & ~std::size_t{3U};
+            if (offset > data.size())
+                throw Error{"Invalid KTX file"};
+
+            levelSize.v[0] = std::max(levelSize.v[0] >> 1, 1U);
+            levelSize.v[1] = std::max(levelSize.v[1] >> 1, 1U);
+        }
+
+        auto texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
+                                                           levels,
+                                                           math::Size<std::uint32_t, 2>{width, height},
+                                                           graphics::Flags::none,
+                                                           pixelFormat);
+        bundle.setTexture(name, texture);
+
+        return true;
+    }
+}
@@ -0,0 +1,21 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETS_KTXLOADER_HPP
+#define OUZEL_ASSETS_KTXLOADER_HPP
+
+#include "Bundle.hpp"
+
+namespace ouzel::assets
+{
+    // checks only the file identifier, so it is cheap enough to call from worker threads
+    bool isKtx(const std::vector<std::byte>& data) noexcept;
+
+    // loads KTX 1.1 textures with all their mip levels, compressed levels are passed to the GPU as they are
+    bool loadKtx(Cache& cache,
+                 Bundle& bundle,
+                 const std::string& name,
+                 const std::vector<std::byte>& data,
+                 const Asset::Options& options);
+}
+
+#endif // OUZEL_ASSETS_KTXLOADER_HPP
@@ -0,0 +1,32 @@
+// Ouzel by Elviss Strazdins
+
+#include <thread>
+#include "LoadHandle.hpp"
+#include "Bundle.hpp"
+#include "../core/Engine.hpp"
+
+namespace ouzel::assets
+{
+    void LoadHandle::wait()
+    {
+        if (!state) return;
+
+        auto& workerPool = engine->getWorkerPool();
+
+        while (state->bundle &&
+               !state->bundle->finishLoad(*state, std::chrono::steady_clock::time_point::max()))
+        {
+            // help the workers with reading and decoding instead of blocking
+            if (!workerPool.runPendingTask())
+                std::this_thread::yield();
+        }
+    }
+
+    void LoadHandle::cancel() noexcept
+    {
+        if (!state) return;
+
+        state->bundle = nullptr;
+        state->cancelled.store(true, std::memory_order_release);
+    }
+}
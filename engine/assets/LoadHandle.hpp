@@ -0,0 +1,114 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETS_LOADHANDLE_HPP
+#define OUZEL_ASSETS_LOADHANDLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "Asset.hpp"
+#include "../core/WorkerPool.hpp"
+#include "../graphics/Image.hpp"
+
+namespace ouzel::assets
+{
+    class Bundle;
+    class Cache;
+
+    // Tracks the progress of an asynchronous load of assets into a bundle
+    class LoadHandle final
+    {
+        friend Bundle;
+        friend Cache;
+    public:
+        // called on the update thread after every asset that was loaded or failed to load
+        using ProgressCallback = std::function<void(std::size_t finishedCount, std::size_t totalCount)>;
+
+        LoadHandle() noexcept = default;
+
+        [[nodiscard]] bool isDone() const noexcept
+        {
+            return !state ||
+                state->cancelled.load(std::memory_order_acquire) ||
+                getFinishedCount() == state->entries.size();
+        }
+
+        [[nodiscard]] std::size_t getLoadedCount() const noexcept
+        {
+            return state ? state->loadedCount.load(std::memory_order_acquire) : 0;
+        }
+
+        [[nodiscard]] std::size_t getFailedCount() const noexcept
+        {
+            return state ? state->failedCount.load(std::memory_order_acquire) : 0;
+        }
+
+        [[nodiscard]] std::size_t getFinishedCount() const noexcept
+        {
+            return getLoadedCount() + getFailedCount();
+        }
+
+        [[nodiscard]] std::size_t getTotalCount() const noexcept
+        {
+            return state ? state->entries.size() : 0;
+        }
+
+        [[nodiscard]] float getProgress() const noexcept
+        {
+            const auto totalCount = getTotalCount();
+            return totalCount ? static_cast<float>(getFinishedCount()) / static_cast<float>(totalCount) : 1.0F;
+        }
+
+        // Must be called on the update thread, finishes the load without spreading it over multiple frames
+        void wait();
+
+        // Must be called on the update thread, the assets that were already loaded stay in the bundle
+        void cancel() noexcept;
+
+    private:
+        struct Entry final
+        {
+            Entry(const Asset& initAsset, std::uint32_t initStage):
+                asset{initAsset}, stage{initStage}
+            {
+            }
+
+            Asset asset;
+            std::uint32_t stage;
+
+            // written by the worker, read on the update thread after the future is ready
+            std::vector<std::byte> data;
+            std::optional<graphics::Image> image;
+            std::exception_ptr exception;
+
+            core::Future future;
+            bool finished = false;
+        };
+
+        struct State final
+        {
+            Bundle* bundle = nullptr; // null after the load was cancelled or the bundle was destroyed
+            std::vector<Entry> entries; // sorted by stage, assets of a stage depend only on the previous stages
+            std::size_t stageBegin = 0;
+            ProgressCallback progressCallback;
+
+            std::atomic<std::size_t> loadedCount{0};
+            std::atomic<std::size_t> failedCount{0};
+            std::atomic<bool> cancelled{false};
+        };
+
+        explicit LoadHandle(const std::shared_ptr<State>& initState) noexcept:
+            state{initState}
+        {
+        }
+
+        std::shared_ptr<State> state;
+    };
+}
+
+#endif // OUZEL_ASSETS_LOADHANDLE_HPP
@@ -18,7 +18,8 @@ namespace ouzel::assets
     {
         scene::ParticleSystemData particleSystemData;
 
-        const auto d = json::parse(data);
+        const json::Document document{data};
+        const auto d = document.getRoot();
 
         if (!d.hasMember("textureFileName") ||
             !d.hasMember("configName"))
@@ -17,7 +17,8 @@ namespace ouzel::assets
                                 const std::vector<std::byte>& data,
                                 const Asset::Options& options)
     {
-        const auto d = json::parse(data);
+        const json::Document document{data};
+        const auto d = document.getRoot();
 
         if (!d.hasMember("filename") ||
             !d.hasMember("spritesX") ||
@@ -4,12 +4,14 @@
 #define OUZEL_ASSETS_TTFLOADER_HPP
 
 #include "Bundle.hpp"
+#include "Cache.hpp"
+#include "../core/Engine.hpp"
 #include "../gui/TTFont.hpp"
 #include "stb_truetype.h"
 
 namespace ouzel::assets
 {
-    inline bool loadTtf(Cache&,
+    inline bool loadTtf(Cache& cache,
                         Bundle& bundle,
                         const std::string& name,
                         const std::vector<std::byte>& data,
@@ -17,8 +19,11 @@ namespace ouzel::assets
     {
         try
         {
+            // only the drivers that have the distance field shader can draw the distance fields
+            const auto distanceField = options.distanceField && cache.getShader(shaderDistanceField);
+
             // TODO: move the loader here
-            auto font = std::make_unique<gui::TTFont>(data, options.mipmaps);
+            auto font = std::make_unique<gui::TTFont>(data, distanceField);
             bundle.setFont(name, std::move(font));
         }
         catch (const std::exception&)
@@ -5,6 +5,7 @@
 #include "WaveLoader.hpp"
 #include "AssetError.hpp"
 #include "../audio/PcmClip.hpp"
+#include "../audio/mixer/Kernels.hpp"
 #include "../core/Engine.hpp"
 
 namespace
@@ -246,16 +247,9 @@ namespace ouzel::assets
             {
                 if (bitsPerSample == 32)
                 {
-                    for (std::uint32_t channel = 0; channel < channels; ++channel)
-                    {
-                        const auto outputChannel = &samples[channel * frames];
-
-                        for (std::uint32_t frame = 0; frame < frames; ++frame)
-                        {
-                            const auto sourceData = &soundData[(frame * channels + channel) * 4];
-                            std::memcpy(&outputChannel[frame], sourceData, sizeof(float));
-                        }
-                    }
+                    std::vector<float> interleavedSamples(sampleCount);
+                    std::memcpy(interleavedSamples.data(), soundData.data(), sampleCount * sizeof(float));
+                    audio::mixer::deinterleave(interleavedSamples.data(), channels, frames, samples.data());
                 }
                 else
                     throw Error{"Failed to load sound file, unsupported bit depth"};
@@ -144,7 +144,7 @@ namespace ouzel::audio
                                            std::placeholders::_3,
                                            std::placeholders::_4),
                                  settings)},
-        mixer{device->getBufferSize(), device->getChannels()},
+        mixer{device->getBufferSize(), device->getChannels(), device->getSampleRate()},
         masterMix{*this},
         rootNode{*this} // mixer.getRootObjectId()
     {
@@ -181,39 +181,77 @@ namespace ouzel::audio
             }
         }
 
-        mixer.submitCommandBuffer(std::move(commandBuffer));
-        commandBuffer = mixer::CommandBuffer();
+        mixer.releaseCommandBuffers();
+
+        // if the mixer has not caught up, the commands are sent with the next update
+        if (!commandBuffer.isEmpty() &&
+            mixer.submitCommandBuffer(std::move(commandBuffer)))
+            commandBuffer = mixer::CommandBuffer();
+    }
+
+    mixer::Mixer::ObjectId Audio::getObjectId()
+    {
+        const auto objectId = mixer.getObjectId();
+
+        if (objectId > objectCapacity)
+        {
+            objectCapacity = std::max(objectId, objectCapacity * 2);
+            addCommand(std::make_unique<mixer::ReserveObjectsCommand>(objectCapacity));
+        }
+
+        return objectId;
     }
 
     void Audio::deleteObject(mixer::Mixer::ObjectId objectId)
     {
         addCommand(std::make_unique<mixer::DeleteObjectCommand>(objectId));
+        dataObjects.erase(objectId);
+
+        // the commands are executed in order, so the id can be reused by the next command
+        mixer.deleteObjectId(objectId);
+    }
+
+    mixer::Mixer::ObjectId Audio::initObject(std::unique_ptr<mixer::Source> source)
+    {
+        const auto objectId = getObjectId();
+        addCommand(std::make_unique<mixer::InitObjectCommand>(objectId, std::make_unique<mixer::Object>(std::move(source))));
+        return objectId;
     }
 
     mixer::Mixer::ObjectId Audio::initBus()
     {
-        const auto busId = mixer.getObjectId();
-        addCommand(std::make_unique<mixer::InitBusCommand>(busId));
+        const auto busId = getObjectId();
+        addCommand(std::make_unique<mixer::InitBusCommand>(busId, std::make_unique<mixer::Bus>(mixer.getBufferSize(), mixer.getChannels())));
         return busId;
     }
 
     mixer::Mixer::ObjectId Audio::initStream(mixer::Mixer::ObjectId sourceId)
     {
-        const auto streamId = mixer.getObjectId();
-        addCommand(std::make_unique<mixer::InitStreamCommand>(streamId, sourceId));
+        const auto i = dataObjects.find(sourceId);
+        if (i == dataObjects.end())
+            throw Error{"Invalid data"};
+
+        auto stream = i->second->createStream();
+        stream->reserve(mixer.getBufferSize(), mixer.getChannels(), mixer.getSampleRate());
+
+        const auto streamId = getObjectId();
+        addCommand(std::make_unique<mixer::InitStreamCommand>(streamId, std::move(stream)));
         return streamId;
     }
 
     mixer::Mixer::ObjectId Audio::initData(std::unique_ptr<mixer::Data> data)
     {
-        const auto dataId = mixer.getObjectId();
+        const auto dataId = getObjectId();
+        dataObjects[dataId] = data.get();
         addCommand(std::make_unique<mixer::InitDataCommand>(dataId, std::move(data)));
         return dataId;
     }
 
     mixer::Mixer::ObjectId Audio::initProcessor(std::unique_ptr<mixer::Processor> processor)
     {
-        const auto processorId = mixer.getObjectId();
+        processor->reserve(mixer.getBufferSize(), mixer.getChannels(), mixer.getSampleRate());
+
+        const auto processorId = getObjectId();
         addCommand(std::make_unique<mixer::InitProcessorCommand>(processorId, std::move(processor)));
         return processorId;
     }
@@ -224,8 +262,9 @@ namespace ouzel::audio
         addCommand(std::make_unique<mixer::UpdateProcessorCommand>(processorId, updateFunction));
     }
 
-    void Audio::getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples)
+    void Audio::getSamples(std::uint32_t frames, std::uint32_t channels, [[maybe_unused]] std::uint32_t sampleRate, std::vector<float>& samples)
     {
-        mixer.getSamples(frames, channels, sampleRate, samples);
+        samples.resize(frames * channels);
+        mixer.getSamples(frames, samples);
     }
 }
@@ -7,11 +7,13 @@
 #include <functional>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 #include "AudioDevice.hpp"
 #include "Driver.hpp"
 #include "Mix.hpp"
 #include "Node.hpp"
+#include "Prefetcher.hpp"
 #include "Settings.hpp"
 #include "mixer/Commands.hpp"
 #include "mixer/Processor.hpp"
@@ -34,6 +36,7 @@ namespace ouzel::audio
         auto getDevice() const noexcept { return device.get(); }
         mixer::Mixer& getMixer() { return mixer; }
         Mix& getMasterMix() { return masterMix; }
+        Prefetcher& getPrefetcher() { return prefetcher; }
 
         void start();
         void update();
@@ -44,6 +47,7 @@ namespace ouzel::audio
         }
 
         void deleteObject(mixer::Mixer::ObjectId objectId);
+        mixer::Mixer::ObjectId initObject(std::unique_ptr<mixer::Source> source);
         mixer::Mixer::ObjectId initBus();
         mixer::Mixer::ObjectId initStream(mixer::Mixer::ObjectId sourceId);
         mixer::Mixer::ObjectId initData(std::unique_ptr<mixer::Data> data);
@@ -59,9 +63,15 @@ namespace ouzel::audio
                         std::uint32_t sampleRate,
                         std::vector<float>& samples);
 
+        // the mixer objects are created on this thread and the object storage of the mixer is grown from here
+        mixer::Mixer::ObjectId getObjectId();
+
         std::unique_ptr<AudioDevice> device;
+        Prefetcher prefetcher; // destroyed after the mixer, which owns the streams
         mixer::Mixer mixer;
         mixer::CommandBuffer commandBuffer;
+        std::size_t objectCapacity = mixer::Mixer::initialObjectCapacity;
+        std::unordered_map<mixer::Mixer::ObjectId, mixer::Data*> dataObjects;
         Mix masterMix;
         Node rootNode;
     };
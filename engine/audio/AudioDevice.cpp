@@ -2,6 +2,7 @@
 
 #include "AudioDevice.hpp"
 #include "AudioError.hpp"
+#include "mixer/Kernels.hpp"
 
 namespace ouzel::audio
 {
@@ -17,6 +18,9 @@ namespace ouzel::audio
         channels{(settings.channels != 0) ? settings.channels : 2}, // TODO: leave it zero and let subclasses decide the number of channels
         dataGetter{initDataGetter}
     {
+        // the callbacks usually ask for the buffer size, so the buffers don't have to grow on the audio thread
+        buffer.reserve(bufferSize * channels);
+        interleavedBuffer.reserve(bufferSize * channels);
     }
 
     void AudioDevice::getData(std::uint32_t frames, std::vector<std::uint8_t>& result)
@@ -27,30 +31,17 @@ namespace ouzel::audio
         {
             case SampleFormat::signedInt16:
             {
-                result.resize(frames * channels * sizeof(std::int16_t));
-                auto resultPtr = reinterpret_cast<std::int16_t*>(result.data());
-
-                for (std::uint32_t channel = 0; channel < channels; ++channel)
-                {
-                    const auto bufferChannel = &buffer[channel * frames];
+                interleavedBuffer.resize(frames * channels);
+                mixer::interleave(buffer.data(), channels, frames, interleavedBuffer.data());
 
-                    for (std::uint32_t frame = 0; frame < frames; ++frame)
-                        resultPtr[frame * channels + channel] = static_cast<std::int16_t>(bufferChannel[frame] * 32767.0F);
-                }
+                result.resize(frames * channels * sizeof(std::int16_t));
+                mixer::convertToInt16(interleavedBuffer.data(), reinterpret_cast<std::int16_t*>(result.data()), interleavedBuffer.size());
                 break;
             }
             case SampleFormat::float32:
             {
                 result.resize(frames * channels * sizeof(float));
-                auto resultPtr = reinterpret_cast<float*>(result.data());
-
-                for (std::uint32_t channel = 0; channel < channels; ++channel)
-                {
-                    const auto bufferChannel = &buffer[channel * frames];
-
-                    for (std::uint32_t frame = 0; frame < frames; ++frame)
-                        resultPtr[frame * channels + channel] = bufferChannel[frame];
-                }
+                mixer::interleave(buffer.data(), channels, frames, reinterpret_cast<float*>(result.data()));
                 break;
             }
             default:
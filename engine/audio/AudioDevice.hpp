@@ -56,6 +56,7 @@ namespace ouzel::audio
     private:
         std::function<void(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples)> dataGetter;
         std::vector<float> buffer;
+        std::vector<float> interleavedBuffer;
     };
 }
 
@@ -17,7 +17,7 @@ namespace ouzel::audio
     class Parallel final: public Container
     {
     public:
-        void getSamples(std::uint32_t, std::uint32_t, std::uint32_t, std::vector<float>&) override
+        void getSamples(std::uint32_t, std::uint32_t, std::uint32_t, Span<float>) override
         {
         }
     };
@@ -25,7 +25,7 @@ namespace ouzel::audio
     class Random final: public Container
     {
     public:
-        void getSamples(std::uint32_t, std::uint32_t, std::uint32_t, std::vector<float>&) override
+        void getSamples(std::uint32_t, std::uint32_t, std::uint32_t, Span<float>) override
         {
         }
     };
@@ -33,7 +33,7 @@ namespace ouzel::audio
     class Sequence final: public Container
     {
     public:
-        void getSamples(std::uint32_t, std::uint32_t, std::uint32_t, std::vector<float>&) override
+        void getSamples(std::uint32_t, std::uint32_t, std::uint32_t, Span<float>) override
         {
         }
     };
@@ -4,6 +4,7 @@
 #include <cmath>
 #include "Effects.hpp"
 #include "Audio.hpp"
+#include "mixer/Kernels.hpp"
 #include "../scene/Actor.hpp"
 #include "../math/Scalar.hpp"
 #include "smbPitchShift.hpp"
@@ -18,41 +19,51 @@ namespace ouzel::audio
         {
         }
 
-        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                     std::vector<float>& samples) override
+        static auto getBufferSize(std::uint32_t maxFrames, std::uint32_t channels, std::uint32_t delayFrames)
         {
-            const auto delayFrames = static_cast<std::uint32_t>(delay * sampleRate);
-            const auto bufferFrames = frames + delayFrames;
+            return (maxFrames + delayFrames) * channels;
+        }
+
+        void reserve(std::uint32_t maxFrames, std::uint32_t channels, std::uint32_t sampleRate) override
+        {
+            delayFrames = static_cast<std::uint32_t>(delay * sampleRate);
+            buffer.resize(getBufferSize(maxFrames, channels, delayFrames));
+        }
 
-            buffer.resize(bufferFrames * channels);
+        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t,
+                     Span<float> samples) override
+        {
+            // every channel has room for the largest block and the delay
+            const auto channelFrames = static_cast<std::uint32_t>(buffer.size() / channels);
+            if (channelFrames < frames + delayFrames) return;
+
+            const auto bufferFrames = frames + delayFrames;
 
             for (std::uint32_t channel = 0; channel < channels; ++channel)
             {
-                const auto bufferChannel = &buffer[channel * bufferFrames];
+                const auto bufferChannel = &buffer[channel * channelFrames];
                 const auto outputChannel = &samples[channel * frames];
 
-                for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    bufferChannel[frame + delayFrames] += outputChannel[frame];
-
-                for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    outputChannel[frame] = bufferChannel[frame];
+                mixer::mix(outputChannel, bufferChannel + delayFrames, frames);
+                std::copy(bufferChannel, bufferChannel + frames, outputChannel);
 
                 // erase frames from beginning
-                for (std::uint32_t frame = 0; frame < bufferFrames - frames; ++frame)
-                    bufferChannel[frame] = bufferChannel[frame + frames];
-
-                for (std::uint32_t frame = bufferFrames - frames; frame < bufferFrames; ++frame)
-                    bufferChannel[frame] = 0.0F;
+                std::copy(bufferChannel + frames, bufferChannel + bufferFrames, bufferChannel);
+                std::fill(bufferChannel + delayFrames, bufferChannel + bufferFrames, 0.0F);
             }
         }
 
-        void setDelay(const float newDelay) noexcept
+        // the buffer for the new delay is allocated by the caller, and the old buffer is returned in it
+        void setDelay(const float newDelay, std::uint32_t newDelayFrames, std::vector<float>& newBuffer) noexcept
         {
             delay = newDelay;
+            delayFrames = newDelayFrames;
+            buffer.swap(newBuffer);
         }
 
     private:
         float delay = 0.0F;
+        std::uint32_t delayFrames = 0;
         std::vector<float> buffer;
     };
 
@@ -69,9 +80,15 @@ namespace ouzel::audio
     {
         delay = newDelay;
 
-        audio.updateProcessor(processorId, [newDelay](mixer::Object* node) {
+        const auto newDelayFrames = static_cast<std::uint32_t>(newDelay * audio.getMixer().getSampleRate());
+        std::vector<float> newBuffer(DelayProcessor::getBufferSize(audio.getMixer().getBufferSize(),
+                                                                   audio.getMixer().getChannels(),
+                                                                   newDelayFrames));
+
+        // the old buffer is freed with the command, outside of the mixer thread
+        audio.updateProcessor(processorId, [newDelay, newDelayFrames, newBuffer = std::move(newBuffer)](mixer::Object* node) mutable {
             const auto delayProcessor = static_cast<DelayProcessor*>(node);
-            delayProcessor->setDelay(newDelay);
+            delayProcessor->setDelay(newDelay, newDelayFrames, newBuffer);
         });
     }
 
@@ -91,10 +108,9 @@ namespace ouzel::audio
         }
 
         void process(std::uint32_t, std::uint32_t, std::uint32_t,
-                     std::vector<float>& samples) override
+                     Span<float> samples) override
         {
-            for (auto& sample : samples)
-                sample *= gainFactor;
+            mixer::scale(samples.data(), gainFactor, samples.data(), samples.size());
         }
 
         void setGain(const float newGain) noexcept
@@ -141,7 +157,7 @@ namespace ouzel::audio
         }
 
         void process(std::uint32_t, std::uint32_t, std::uint32_t,
-                     std::vector<float>&) override
+                     Span<float>) override
         {
         }
 
@@ -239,12 +255,15 @@ namespace ouzel::audio
         {
         }
 
-        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                     std::vector<float>& samples) override
+        void reserve(std::uint32_t, std::uint32_t channels, std::uint32_t) override
         {
             pitchShift.resize(channels);
+        }
 
-            for (std::uint32_t channel = 0; channel < channels; ++channel)
+        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
+                     Span<float> samples) override
+        {
+            for (std::uint32_t channel = 0; channel < std::min(channels, static_cast<std::uint32_t>(pitchShift.size())); ++channel)
                 pitchShift[channel].process(scale, frames, sampleRate,
                                             &samples[channel * frames],
                                             &samples[channel * frames]);
@@ -294,7 +313,7 @@ namespace ouzel::audio
         }
 
         void process(std::uint32_t, std::uint32_t, std::uint32_t,
-                     std::vector<float>&) override
+                     Span<float>) override
         {
             // TODO: implement
         }
@@ -341,39 +360,46 @@ namespace ouzel::audio
         {
         }
 
-        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                     std::vector<float>& samples) override
+        void reserve(std::uint32_t maxFrames, std::uint32_t channels, std::uint32_t sampleRate) override
         {
-            const auto delayFrames = static_cast<std::uint32_t>(delay * sampleRate);
-            const auto bufferFrames = frames + delayFrames;
+            delayFrames = static_cast<std::uint32_t>(delay * sampleRate);
+            buffer.resize((maxFrames + delayFrames) * channels);
+        }
+
+        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t,
+                     Span<float> samples) override
+        {
+            // every channel has room for the largest block and the delay
+            const auto channelFrames = static_cast<std::uint32_t>(buffer.size() / channels);
+            if (channelFrames < frames + delayFrames) return;
 
-            buffers.resize(channels);
+            const auto bufferFrames = frames + delayFrames;
 
             for (std::uint32_t channel = 0; channel < channels; ++channel)
             {
-                auto& buffer = buffers[channel];
-                buffer.resize(bufferFrames);
-
+                const auto bufferChannel = &buffer[channel * channelFrames];
                 const auto outputChannel = &samples[channel * frames];
 
                 for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    buffer[frame] += outputChannel[frame];
+                    bufferChannel[frame] += outputChannel[frame];
 
                 for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    buffer[frame + delayFrames] += buffer[frame] * decay;
+                    bufferChannel[frame + delayFrames] += bufferChannel[frame] * decay;
 
                 for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    outputChannel[frame] = buffer[frame];
+                    outputChannel[frame] = bufferChannel[frame];
 
                 // erase frames from beginning
-                buffer.erase(buffer.begin(), buffer.begin() + frames);
+                std::copy(bufferChannel + frames, bufferChannel + bufferFrames, bufferChannel);
+                std::fill(bufferChannel + delayFrames, bufferChannel + bufferFrames, 0.0F);
             }
         }
 
     private:
         float delay = 0.1F;
         float decay = 0.5F;
-        std::vector<std::vector<float>> buffers;
+        std::uint32_t delayFrames = 0;
+        std::vector<float> buffer;
     };
 
     Reverb::Reverb(Audio& initAudio, float initDelay, float initDecay):
@@ -392,7 +418,7 @@ namespace ouzel::audio
         void process([[maybe_unused]] std::uint32_t frames,
                      [[maybe_unused]] std::uint32_t channels,
                      [[maybe_unused]] std::uint32_t sampleRate,
-                     [[maybe_unused]] std::vector<float>& samples) override
+                     [[maybe_unused]] Span<float> samples) override
         {
         }
     };
@@ -400,7 +426,7 @@ namespace ouzel::audio
     LowPass::LowPass(Audio& initAudio):
         Effect{
             initAudio,
-            initAudio.initProcessor(std::unique_ptr<LowPassProcessor>())
+            initAudio.initProcessor(std::make_unique<LowPassProcessor>())
         }
     {
     }
@@ -411,7 +437,7 @@ namespace ouzel::audio
         void process([[maybe_unused]] std::uint32_t frames,
                      [[maybe_unused]] std::uint32_t channels,
                      [[maybe_unused]] std::uint32_t sampleRate,
-                     [[maybe_unused]] std::vector<float>& samples) override
+                     [[maybe_unused]] Span<float> samples) override
         {
         }
     };
@@ -419,7 +445,7 @@ namespace ouzel::audio
     HighPass::HighPass(Audio& initAudio):
         Effect{
             initAudio,
-            initAudio.initProcessor(std::unique_ptr<HighPassProcessor>())
+            initAudio.initProcessor(std::make_unique<HighPassProcessor>())
         }
     {
     }
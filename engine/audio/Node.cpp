@@ -2,6 +2,7 @@
 
 #include "Node.hpp"
 #include "Audio.hpp"
+#include "AudioError.hpp"
 
 namespace ouzel::audio
 {
@@ -9,6 +10,10 @@ namespace ouzel::audio
     {
         if (child.parent != this)
         {
+            // the mixer does not grow the children of its objects, so the limit is enforced here
+            if (children.size() >= mixer::Object::maxChildren)
+                throw Error{"Too many children"};
+
             if (child.parent)
                 child.parent->removeChild(child);
 
@@ -20,7 +20,7 @@ namespace ouzel::audio
             position = 0;
         }
 
-        void generateSamples(std::uint32_t frames, std::vector<float>& samples) override;
+        void generateSamples(std::uint32_t frames, Span<float> samples) override;
 
     private:
         std::uint32_t position = 0;
@@ -92,12 +92,10 @@ namespace ouzel::audio
         }
     }
 
-    void OscillatorStream::generateSamples(std::uint32_t frames, std::vector<float>& samples)
+    void OscillatorStream::generateSamples(std::uint32_t frames, Span<float> samples)
     {
         auto& oscillatorData = static_cast<OscillatorData&>(data);
 
-        samples.resize(frames);
-
         const auto sampleRate = data.getSampleRate();
         const auto length = static_cast<OscillatorData&>(data).getLength();
 
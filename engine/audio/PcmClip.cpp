@@ -20,7 +20,7 @@ namespace ouzel::audio
             position = 0;
         }
 
-        void generateSamples(std::uint32_t frames, std::vector<float>& samples) override;
+        void generateSamples(std::uint32_t frames, Span<float> samples) override;
 
     private:
         std::uint32_t position = 0;
@@ -52,11 +52,8 @@ namespace ouzel::audio
     {
     }
 
-    void PcmStream::generateSamples(std::uint32_t frames, std::vector<float>& samples)
+    void PcmStream::generateSamples(std::uint32_t frames, Span<float> samples)
     {
-        const std::uint32_t neededSize = frames * data.getChannels();
-        samples.resize(neededSize);
-
         const auto& pcmData = static_cast<PcmData&>(data);
         const auto& dataSamples = pcmData.getData();
 
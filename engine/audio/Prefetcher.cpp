@@ -0,0 +1,85 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <chrono>
+#include "Prefetcher.hpp"
+#include "../utils/Log.hpp"
+
+namespace ouzel::audio
+{
+    namespace
+    {
+        // the buffers of the sources hold much more than this, so polling is enough to keep them filled
+        constexpr std::chrono::milliseconds prefetchInterval{10};
+    }
+
+    Prefetcher::Prefetcher():
+        prefetchThread{&Prefetcher::prefetchMain, this}
+    {
+    }
+
+    Prefetcher::~Prefetcher()
+    {
+        std::unique_lock lock{sourceMutex};
+        running = false;
+        lock.unlock();
+        sourceCondition.notify_all();
+
+        if (prefetchThread.isJoinable()) prefetchThread.join();
+    }
+
+    void Prefetcher::addSource(Source& source)
+    {
+        std::unique_lock lock{sourceMutex};
+        source.alive = true;
+        sources.push_back(&source);
+        lock.unlock();
+        sourceCondition.notify_all();
+    }
+
+    void Prefetcher::removeSource(Source& source)
+    {
+        std::unique_lock lock{sourceMutex};
+
+        source.alive = false;
+        if (const auto i = std::find(sources.begin(), sources.end(), &source); i != sources.end())
+            sources.erase(i);
+
+        removeCondition.wait(lock, [&source]() noexcept { return !source.prefetching; });
+    }
+
+    void Prefetcher::prefetchMain()
+    {
+        std::unique_lock lock{sourceMutex};
+
+        while (running)
+        {
+            // the sources are decoded without the lock, so that adding and removing sources doesn't wait for
+            // the decoding of all of them, the removal of a source waits only while that source is being decoded
+            // if the list changes in the meantime, a source may be skipped until the next pass
+            for (std::size_t i = 0; i < sources.size(); ++i)
+            {
+                const auto source = sources[i];
+                source->prefetching = true;
+                lock.unlock();
+
+                try
+                {
+                    source->prefetch();
+                }
+                catch (const std::exception& e)
+                {
+                    log(Log::Level::error) << e.what();
+                }
+
+                lock.lock();
+                source->prefetching = false;
+
+                if (!source->alive)
+                    removeCondition.notify_all();
+            }
+
+            sourceCondition.wait_for(lock, prefetchInterval);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_AUDIO_PREFETCHER_HPP
+#define OUZEL_AUDIO_PREFETCHER_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "../thread/Thread.hpp"
+
+namespace ouzel::audio
+{
+    // Worker thread that keeps the buffers of the streamed sounds filled, so that they are not decoded on the mixer thread
+    class Prefetcher final
+    {
+    public:
+        class Source
+        {
+            friend Prefetcher;
+        public:
+            virtual ~Source() = default;
+
+            // called on the prefetch thread, fills the buffer of the source until it is full
+            virtual void prefetch() = 0;
+
+        private:
+            // guarded by the source mutex of the prefetcher
+            bool alive = false;
+            bool prefetching = false;
+        };
+
+        Prefetcher();
+        ~Prefetcher();
+
+        Prefetcher(const Prefetcher&) = delete;
+        Prefetcher& operator=(const Prefetcher&) = delete;
+
+        Prefetcher(Prefetcher&&) = delete;
+        Prefetcher& operator=(Prefetcher&&) = delete;
+
+        // the source is not prefetched anymore after removeSource returns,
+        // if the prefetch thread is decoding the source, removeSource waits for it to finish
+        void addSource(Source& source);
+        void removeSource(Source& source);
+
+    private:
+        void prefetchMain();
+
+        std::mutex sourceMutex;
+        std::condition_variable sourceCondition;
+        std::condition_variable removeCondition;
+        std::vector<Source*> sources;
+        bool running = true;
+        thread::Thread prefetchThread;
+    };
+}
+
+#endif // OUZEL_AUDIO_PREFETCHER_HPP
@@ -19,7 +19,7 @@ namespace ouzel::audio
             position = 0;
         }
 
-        void generateSamples(std::uint32_t frames, std::vector<float>& samples) override;
+        void generateSamples(std::uint32_t frames, Span<float> samples) override;
 
     private:
         std::uint32_t position = 0;
@@ -50,11 +50,10 @@ namespace ouzel::audio
     {
     }
 
-    void SilenceStream::generateSamples(std::uint32_t frames, std::vector<float>& samples)
+    void SilenceStream::generateSamples(std::uint32_t frames, Span<float> samples)
     {
         auto& silenceData = static_cast<SilenceData&>(data);
 
-        samples.resize(frames);
         std::fill(samples.begin(), samples.end(), 0.0F); // TODO: fill only the needed samples
 
         const auto length = static_cast<SilenceData&>(silenceData).getLength();
@@ -5,6 +5,7 @@
 
 #include <vector>
 #include "Effect.hpp"
+#include "../utils/Span.hpp"
 
 namespace ouzel::audio
 {
@@ -15,7 +16,7 @@ namespace ouzel::audio
 
         virtual void play() {}
         virtual void stop([[maybe_unused]] bool shouldReset) {}
-        virtual void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples) = 0;
+        virtual void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, Span<float> samples) = 0;
 
         auto& getEffects() const noexcept { return effects; }
 
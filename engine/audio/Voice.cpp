@@ -28,7 +28,7 @@ namespace ouzel::audio
                 source->stop(shouldReset);
         }
 
-        void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples) override
+        void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, Span<float> samples) override
         {
             if (source)
                 source->getSamples(frames, channels, sampleRate, samples);
@@ -121,8 +121,7 @@ namespace ouzel::audio
 
         auto source = std::make_unique<VoiceSource>();
 
-        audio.addCommand(std::make_unique<mixer::InitObjectCommand>(audio.getMixer().getObjectId(),
-                                                                    std::move(source)));
+        audio.initObject(std::move(source));
     }
 
     Voice::Voice(Audio& initAudio, const Sound* initSound):
@@ -145,9 +144,9 @@ namespace ouzel::audio
 
         playing = true;
 
-        auto startEvent = std::make_unique<SoundEvent>();
-        startEvent->type = Event::Type::soundStart;
-        startEvent->voice = this;
+        SoundEvent startEvent;
+        startEvent.type = Event::Type::soundStart;
+        startEvent.voice = this;
         engine->getEventDispatcher().postEvent(std::move(startEvent));
 
         // TODO: send PlayCommand
@@ -174,9 +173,9 @@ namespace ouzel::audio
     // executed on audio thread
     /*void Voice::onReset()
     {
-        auto event = std::make_unique<SoundEvent>();
-        event->type = Event::Type::soundReset;
-        event->voice = this;
+        SoundEvent event;
+        event.type = Event::Type::soundReset;
+        event.voice = this;
         engine->getEventDispatcher().postEvent(std::move(event));
     }
 
@@ -185,9 +184,9 @@ namespace ouzel::audio
     {
         playing = false;
 
-        auto event = std::make_unique<SoundEvent>();
-        event->type = Event::Type::soundFinish;
-        event->voice = this;
+        SoundEvent event;
+        event.type = Event::Type::soundFinish;
+        event.voice = this;
         engine->getEventDispatcher().postEvent(std::move(event));
     }*/
 
@@ -1,10 +1,14 @@
 // Ouzel by Elviss Strazdins
 
+#include <algorithm>
+#include <atomic>
 #include "VorbisClip.hpp"
 #include "Audio.hpp"
 #include "AudioError.hpp"
+#include "Prefetcher.hpp"
 #include "mixer/Data.hpp"
 #include "mixer/Stream.hpp"
+#include "../utils/Log.hpp"
 #include "../utils/Utils.hpp"
 
 #ifdef _MSC_VER
@@ -61,7 +65,7 @@ namespace ouzel::audio
             stb_vorbis_seek_start(vorbisStream);
         }
 
-        void generateSamples(std::uint32_t frames, std::vector<float>& samples) override;
+        void generateSamples(std::uint32_t frames, Span<float> samples) override;
 
     private:
         stb_vorbis* vorbisStream = nullptr;
@@ -107,10 +111,9 @@ namespace ouzel::audio
                                               nullptr, nullptr);
     }
 
-    void VorbisStream::generateSamples(std::uint32_t frames, std::vector<float>& samples)
+    void VorbisStream::generateSamples(std::uint32_t frames, Span<float> samples)
     {
         std::uint32_t neededSize = frames * data.getChannels();
-        samples.resize(neededSize);
 
         int resultFrames = 0;
 
@@ -119,7 +122,7 @@ namespace ouzel::audio
             if (vorbisStream->eof)
                 reset();
 
-            std::vector<float*> channelData(data.getChannels());
+            float* channelData[6];
 
             switch (data.getChannels())
             {
@@ -150,7 +153,7 @@ namespace ouzel::audio
 
             resultFrames = stb_vorbis_get_samples_float(vorbisStream,
                                                         static_cast<int>(data.getChannels()),
-                                                        channelData.data(),
+                                                        channelData,
                                                         static_cast<int>(frames));
         }
 
@@ -165,6 +168,320 @@ namespace ouzel::audio
                 samples[channel * frames + frame] = 0.0F;
     }
 
+    namespace
+    {
+        constexpr std::size_t inputChunkSize = 16384U;
+        constexpr std::uint32_t prefetchDivider = 2U; // the streams buffer half a second of audio
+
+        // Vorbis orders the 5.1 channels L, C, R, SL, SR, LFE
+        constexpr std::uint32_t channelMap6[] = {0, 2, 1, 4, 5, 3};
+        constexpr std::uint32_t identityChannelMap[] = {0, 1, 2, 3, 4, 5};
+
+        const std::uint32_t* getChannelMap(std::uint32_t channels)
+        {
+            switch (channels)
+            {
+                case 1: case 2: case 4: return identityChannelMap;
+                case 6: return channelMap6;
+                default: throw Error{"Unsupported channel count"};
+            }
+        }
+
+        // Compressed data that is read from a file in chunks and passed to the push data API of stb_vorbis
+        class VorbisReader final
+        {
+        public:
+            explicit VorbisReader(storage::FileReader&& initReader):
+                reader{std::move(initReader)},
+                input(inputChunkSize)
+            {
+            }
+
+            ~VorbisReader()
+            {
+                if (decoder) stb_vorbis_close(decoder);
+            }
+
+            VorbisReader(const VorbisReader&) = delete;
+            VorbisReader& operator=(const VorbisReader&) = delete;
+
+            VorbisReader(VorbisReader&&) = delete;
+            VorbisReader& operator=(VorbisReader&&) = delete;
+
+            // returns the decoder after the headers of the stream have been read
+            stb_vorbis* open()
+            {
+                while (!decoder)
+                {
+                    int used = 0;
+                    int error = 0;
+                    decoder = stb_vorbis_open_pushdata(reinterpret_cast<const unsigned char*>(input.data()),
+                                                       static_cast<int>(inputEnd),
+                                                       &used, &error, nullptr);
+
+                    if (decoder)
+                        inputStart = static_cast<std::size_t>(used);
+                    else if (error != VORBIS_need_more_data)
+                        throw Error{"Failed to load Vorbis stream"};
+                    else if (!readInput()) // the headers have to be in one contiguous block
+                        throw Error{"Failed to load Vorbis stream"};
+                }
+
+                return decoder;
+            }
+
+            // returns the number of frames, zero at the end of the stream
+            // the output is valid until the next call
+            std::uint32_t decodeFrame(float**& output)
+            {
+                open();
+
+                for (;;)
+                {
+                    int channels = 0;
+                    int frames = 0;
+                    const auto used = stb_vorbis_decode_frame_pushdata(decoder,
+                                                                       reinterpret_cast<const unsigned char*>(input.data() + inputStart),
+                                                                       static_cast<int>(inputEnd - inputStart),
+                                                                       &channels, &output, &frames);
+
+                    if (used == 0)
+                    {
+                        if (!readInput()) return 0;
+                    }
+                    else
+                    {
+                        inputStart += static_cast<std::size_t>(used);
+                        if (frames > 0) return static_cast<std::uint32_t>(frames);
+                    }
+                }
+            }
+
+            void rewind()
+            {
+                if (decoder) stb_vorbis_close(decoder);
+                decoder = nullptr;
+                reader.seek(0);
+                inputStart = inputEnd = 0;
+            }
+
+        private:
+            bool readInput()
+            {
+                // move the unused data to the beginning of the buffer
+                std::copy(input.begin() + static_cast<std::ptrdiff_t>(inputStart),
+                          input.begin() + static_cast<std::ptrdiff_t>(inputEnd),
+                          input.begin());
+                inputEnd -= inputStart;
+                inputStart = 0;
+
+                // a page didn't fit in the buffer
+                if (inputEnd == input.size())
+                    input.resize(input.size() * 2);
+
+                const auto bytesRead = reader.read(input.data() + inputEnd, input.size() - inputEnd);
+                inputEnd += bytesRead;
+                return bytesRead > 0;
+            }
+
+            storage::FileReader reader;
+            std::vector<std::byte> input;
+            std::size_t inputStart = 0;
+            std::size_t inputEnd = 0;
+            stb_vorbis* decoder = nullptr;
+        };
+    }
+
+    class VorbisFileData;
+
+    // Stream that is decoded ahead on the prefetch thread into a ring buffer of interleaved frames
+    // Only the mixer thread reads from the ring and only the prefetch thread writes to it
+    class VorbisFileStream final: public mixer::Stream, public Prefetcher::Source
+    {
+    public:
+        explicit VorbisFileStream(VorbisFileData& vorbisData);
+        ~VorbisFileStream() override;
+
+        void reset() override
+        {
+            // the prefetch thread rewinds the file and the mixer skips the frames that were decoded before it
+            resetRequested.store(true, std::memory_order_release);
+            resetPending = true;
+        }
+
+        void generateSamples(std::uint32_t frames, Span<float> samples) override;
+
+        void prefetch() override;
+
+    private:
+        Prefetcher& prefetcher;
+        VorbisReader reader;
+        const std::uint32_t* channelMap;
+        std::uint32_t channels;
+
+        // accessed only by the prefetch thread
+        float** pendingOutput = nullptr;
+        std::uint32_t pendingFrames = 0;
+        std::uint32_t pendingOffset = 0;
+        bool failed = false;
+
+        std::vector<float> ring;
+        std::size_t ringFrames;
+        std::atomic<std::size_t> readPosition{0};
+        std::atomic<std::size_t> writePosition{0};
+        std::atomic<std::size_t> restartPosition{0};
+        std::atomic<bool> resetRequested{false};
+        std::atomic<bool> finished{false};
+
+        bool resetPending = false; // accessed only by the mixer thread
+    };
+
+    class VorbisFileData final: public mixer::Data
+    {
+    public:
+        VorbisFileData(Prefetcher& initPrefetcher, storage::FileReader&& initReader):
+            prefetcher{initPrefetcher},
+            reader{std::move(initReader)}
+        {
+            VorbisReader headerReader{reader.reopen()};
+            const auto info = stb_vorbis_get_info(headerReader.open());
+
+            channels = static_cast<std::uint32_t>(info.channels);
+            sampleRate = info.sample_rate;
+
+            getChannelMap(channels); // throws if the channel count is not supported
+        }
+
+        auto& getPrefetcher() const noexcept { return prefetcher; }
+        auto openReader() const { return reader.reopen(); }
+
+        std::unique_ptr<mixer::Stream> createStream() override
+        {
+            return std::make_unique<VorbisFileStream>(*this);
+        }
+
+    private:
+        Prefetcher& prefetcher;
+        storage::FileReader reader;
+    };
+
+    VorbisFileStream::VorbisFileStream(VorbisFileData& vorbisData):
+        Stream{vorbisData},
+        prefetcher{vorbisData.getPrefetcher()},
+        reader{vorbisData.openReader()},
+        channelMap{getChannelMap(vorbisData.getChannels())},
+        channels{vorbisData.getChannels()},
+        ring(vorbisData.getSampleRate() / prefetchDivider * vorbisData.getChannels()),
+        ringFrames{vorbisData.getSampleRate() / prefetchDivider}
+    {
+        prefetcher.addSource(*this);
+    }
+
+    VorbisFileStream::~VorbisFileStream()
+    {
+        prefetcher.removeSource(*this);
+    }
+
+    void VorbisFileStream::generateSamples(std::uint32_t frames, Span<float> samples)
+    {
+        std::uint32_t resultFrames = 0;
+
+        if (resetPending && !resetRequested.load(std::memory_order_acquire))
+        {
+            readPosition.store(restartPosition.load(std::memory_order_relaxed), std::memory_order_release);
+            resetPending = false;
+        }
+
+        // silence is played until the prefetch thread has rewound the stream
+        if (!resetPending)
+        {
+            const auto read = readPosition.load(std::memory_order_relaxed);
+            const auto available = writePosition.load(std::memory_order_acquire) - read;
+            resultFrames = static_cast<std::uint32_t>(std::min(available, static_cast<std::size_t>(frames)));
+
+            for (std::uint32_t frame = 0; frame < resultFrames; ++frame)
+            {
+                const auto ringFrame = &ring[((read + frame) % ringFrames) * channels];
+
+                for (std::uint32_t channel = 0; channel < channels; ++channel)
+                    samples[channel * frames + frame] = ringFrame[channel];
+            }
+
+            readPosition.store(read + resultFrames, std::memory_order_release);
+
+            // the stream stops at the end of the file and is rewound for the next play
+            if (resultFrames == available && finished.load(std::memory_order_acquire) &&
+                writePosition.load(std::memory_order_acquire) == read + resultFrames)
+            {
+                playing = false;
+                reset();
+            }
+        }
+
+        for (std::uint32_t channel = 0; channel < channels; ++channel)
+            for (auto frame = resultFrames; frame < frames; ++frame)
+                samples[channel * frames + frame] = 0.0F;
+    }
+
+    void VorbisFileStream::prefetch()
+    {
+        if (resetRequested.load(std::memory_order_acquire))
+        {
+            reader.rewind();
+            pendingFrames = 0;
+            pendingOffset = 0;
+            failed = false;
+            finished.store(false, std::memory_order_relaxed);
+            restartPosition.store(writePosition.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            resetRequested.store(false, std::memory_order_release);
+        }
+
+        if (failed || finished.load(std::memory_order_relaxed)) return;
+
+        for (;;)
+        {
+            if (pendingOffset == pendingFrames)
+            {
+                try
+                {
+                    pendingFrames = reader.decodeFrame(pendingOutput);
+                }
+                catch (const std::exception&)
+                {
+                    failed = true;
+                    pendingFrames = 0;
+                    finished.store(true, std::memory_order_release);
+                    throw;
+                }
+
+                pendingOffset = 0;
+
+                if (pendingFrames == 0)
+                {
+                    finished.store(true, std::memory_order_release);
+                    return;
+                }
+            }
+
+            const auto write = writePosition.load(std::memory_order_relaxed);
+            const auto freeFrames = ringFrames - (write - readPosition.load(std::memory_order_acquire));
+            if (freeFrames == 0) return;
+
+            const auto count = std::min(freeFrames, static_cast<std::size_t>(pendingFrames - pendingOffset));
+
+            for (std::size_t frame = 0; frame < count; ++frame)
+            {
+                const auto ringFrame = &ring[((write + frame) % ringFrames) * channels];
+
+                for (std::uint32_t channel = 0; channel < channels; ++channel)
+                    ringFrame[channelMap[channel]] = pendingOutput[channel][pendingOffset + frame];
+            }
+
+            pendingOffset += static_cast<std::uint32_t>(count);
+            writePosition.store(write + count, std::memory_order_release);
+        }
+    }
+
     VorbisClip::VorbisClip(Audio& initAudio, const std::vector<std::byte>& initData):
         Sound{
             initAudio,
@@ -173,4 +490,13 @@ namespace ouzel::audio
         }
     {
     }
+
+    VorbisClip::VorbisClip(Audio& initAudio, storage::FileReader&& reader):
+        Sound{
+            initAudio,
+            initAudio.initData(std::unique_ptr<mixer::Data>(data = new VorbisFileData(initAudio.getPrefetcher(), std::move(reader)))),
+            Sound::Format::vorbis
+        }
+    {
+    }
 }
@@ -6,18 +6,25 @@
 #include <cstdint>
 #include <vector>
 #include "Sound.hpp"
+#include "../storage/FileReader.hpp"
 
 namespace ouzel::audio
 {
-    class VorbisData;
+    namespace mixer
+    {
+        class Data;
+    }
 
     class VorbisClip final: public Sound
     {
     public:
         VorbisClip(Audio& initAudio, const std::vector<std::byte>& initData);
 
+        // the file is decoded while the sound plays, so only a small part of it is kept in memory
+        VorbisClip(Audio& initAudio, storage::FileReader&& reader);
+
     private:
-        VorbisData* data;
+        mixer::Data* data;
     };
 }
 
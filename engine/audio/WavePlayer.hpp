@@ -17,7 +17,7 @@ namespace ouzel::audio
         {
         }
 
-        void getSamples(std::uint32_t, std::uint32_t, std::uint32_t, std::vector<float>&) override
+        void getSamples(std::uint32_t, std::uint32_t, std::uint32_t, Span<float>) override
         {
         }
 
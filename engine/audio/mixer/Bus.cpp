@@ -3,15 +3,31 @@
 #include <algorithm>
 #include "Bus.hpp"
 #include "Data.hpp"
+#include "Kernels.hpp"
 #include "Processor.hpp"
 #include "Stream.hpp"
-#include "../../math/Scalar.hpp"
 
 namespace ouzel::audio::mixer
 {
+    Bus::Bus(std::uint32_t maxFrames, std::uint32_t channels):
+        buffer(maxFrames * channels)
+    {
+        inputBuses.reserve(maxInputs);
+        inputStreams.reserve(maxInputs);
+        processors.reserve(maxProcessors);
+    }
+
     Bus::~Bus()
     {
+        Bus::detach();
+    }
+
+    void Bus::detach()
+    {
+        Object::detach();
+
         if (output) output->removeInput(this);
+        output = nullptr;
 
         for (auto inputBus : inputBuses)
             inputBus->output = nullptr;
@@ -21,223 +37,140 @@ namespace ouzel::audio::mixer
 
         for (auto processor : processors)
             processor->bus = nullptr;
+
+        inputBuses.clear();
+        inputStreams.clear();
+        processors.clear();
     }
 
     void Bus::setOutput(Bus* newOutput)
     {
         if (output) output->removeInput(this);
         output = newOutput;
-        if (output) output->addInput(this);
-    }
-
-    static void resample(std::uint32_t channels, std::uint32_t sourceFrames, const std::vector<float>& sourceSamples,
-                         std::uint32_t frames, std::vector<float>& samples)
-    {
-        if (sourceFrames != frames)
-        {
-            const auto sourceIncrement = static_cast<float>(sourceFrames - 1) / static_cast<float>(frames - 1);
-            auto sourcePosition = 0.0F;
-
-            samples.resize(frames * channels);
-
-            for (std::uint32_t frame = 0; frame < frames - 1; ++frame)
-            {
-                const auto sourceCurrentFrame = static_cast<std::uint32_t>(sourcePosition);
-                const auto fraction = sourcePosition - sourceCurrentFrame;
-
-                const std::uint32_t sourceNextFrame = sourceCurrentFrame + 1;
-
-                for (std::uint32_t channel = 0; channel < channels; ++channel)
-                {
-                    const auto sourceChannel = &sourceSamples[channel * sourceFrames];
-                    const auto outputChannel = &samples[channel * frames];
-
-                    outputChannel[frame] = math::lerp(sourceChannel[sourceCurrentFrame],
-                                                      sourceChannel[sourceNextFrame],
-                                                      fraction);
-                }
-
-                sourcePosition += sourceIncrement;
-            }
-
-            // fill the last frame of the destination with the last frame of the source
-            for (std::uint32_t channel = 0; channel < channels; ++channel)
-            {
-                const auto sourceChannel = &sourceSamples[channel * sourceFrames];
-                const auto outputChannel = &samples[channel * frames];
-                outputChannel[frames - 1] = sourceChannel[sourceFrames - 1];
-            }
-        }
-        else
-            samples = sourceSamples;
+        if (output && !output->addInput(this)) output = nullptr;
     }
 
-    static void convert(std::uint32_t frames, std::uint32_t sourceChannels, const std::vector<float>& sourceSamples,
-                        std::uint32_t channels, std::vector<float>& samples)
+    // rows are the channels of the destination and columns are the channels of the source
+    static const float* getChannelMatrix(std::uint32_t sourceChannels, std::uint32_t channels) noexcept
     {
-        samples.resize(frames * channels);
+        static constexpr float upmix1To2[] = {
+            1.0F, // L = M
+            1.0F // R = M
+        };
+        static constexpr float upmix1To4[] = {
+            1.0F, // L = M
+            1.0F, // R = M
+            0.0F, // SL = 0
+            0.0F // SR = 0
+        };
+        static constexpr float upmix1To6[] = {
+            0.0F, // L = 0
+            0.0F, // R = 0
+            1.0F, // C = M
+            0.0F, // LFE = 0
+            0.0F, // SL = 0
+            0.0F // SR = 0
+        };
+        static constexpr float downmix2To1[] = {
+            0.5F, 0.5F // M = (L + R) * 0.5
+        };
+        static constexpr float upmix2To4[] = {
+            1.0F, 0.0F, // L = L
+            0.0F, 1.0F, // R = R
+            0.0F, 0.0F, // SL = 0
+            0.0F, 0.0F // SR = 0
+        };
+        static constexpr float upmix2To6[] = {
+            1.0F, 0.0F, // L = L
+            0.0F, 1.0F, // R = R
+            0.0F, 0.0F, // C = 0
+            0.0F, 0.0F, // LFE = 0
+            0.0F, 0.0F, // SL = 0
+            0.0F, 0.0F // SR = 0
+        };
+        static constexpr float downmix4To1[] = {
+            0.25F, 0.25F, 0.25F, 0.25F // M = (L + R + SL + SR) * 0.25
+        };
+        static constexpr float downmix4To2[] = {
+            0.5F, 0.0F, 0.5F, 0.0F, // L = (L + SL) * 0.5
+            0.0F, 0.5F, 0.0F, 0.5F // R = (R + SR) * 0.5
+        };
+        static constexpr float upmix4To6[] = {
+            1.0F, 0.0F, 0.0F, 0.0F, // L = L
+            0.0F, 1.0F, 0.0F, 0.0F, // R = R
+            0.0F, 0.0F, 0.0F, 0.0F, // C = 0
+            0.0F, 0.0F, 0.0F, 0.0F, // LFE = 0
+            0.0F, 0.0F, 1.0F, 0.0F, // SL = SL
+            0.0F, 0.0F, 0.0F, 1.0F // SR = SR
+        };
+        static constexpr float downmix6To1[] = {
+            0.7071F, 0.7071F, 1.0F, 0.0F, 0.5F, 0.5F // M = (L + R) * 0.7071 + C + (SL + SR) * 0.5
+        };
+        static constexpr float downmix6To2[] = {
+            1.0F, 0.0F, 0.7071F, 0.0F, 0.7071F, 0.0F, // L = L + (C + SL) * 0.7071
+            0.0F, 1.0F, 0.7071F, 0.0F, 0.0F, 0.7071F // R = R + (C + SR) * 0.7071
+        };
+        static constexpr float downmix6To4[] = {
+            1.0F, 0.0F, 0.7071F, 0.0F, 0.0F, 0.0F, // L = L + C * 0.7071
+            0.0F, 1.0F, 0.7071F, 0.0F, 0.0F, 0.0F, // R = R + C * 0.7071
+            0.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F, // SL = SL
+            0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 1.0F // SR = SR
+        };
 
-        if (sourceChannels != channels)
+        switch (sourceChannels)
         {
-            switch (sourceChannels)
-            {
-                case 1:
+            case 1:
+                switch (channels)
                 {
-                    switch (channels)
-                    {
-                        case 2: // upmix 1 to 2
-                            for (std::uint32_t frame = 0; frame < frames; ++frame)
-                            {
-                                samples[0 * frames + frame] = sourceSamples[frame]; // L = M
-                                samples[1 * frames + frame] = sourceSamples[frame]; // R = M
-                            }
-                            break;
-                        case 4: // upmix 1 to 4
-                            for (std::uint32_t frame = 0; frame < frames; ++frame)
-                            {
-                                samples[0 * frames + frame] = sourceSamples[frame]; // L = M
-                                samples[1 * frames + frame] = sourceSamples[frame]; // R = M
-                                samples[2 * frames + frame] = 0.0F; // SL = 0
-                                samples[3 * frames + frame] = 0.0F; // SR = 0
-                            }
-                            break;
-                        case 6: // upmix 1 to 6
-                            for (std::uint32_t frame = 0; frame < frames; ++frame)
-                            {
-                                samples[0 * frames + frame] = 0.0F; // L = 0
-                                samples[1 * frames + frame] = 0.0F; // R = 0
-                                samples[2 * frames + frame] = sourceSamples[frame]; // C = M
-                                samples[3 * frames + frame] = 0.0F; // LFE = 0
-                                samples[4 * frames + frame] = 0.0F; // SL = 0
-                                samples[5 * frames + frame] = 0.0F; // SR = 0
-                            }
-                            break;
-                    }
-                    break;
+                    case 2: return upmix1To2;
+                    case 4: return upmix1To4;
+                    case 6: return upmix1To6;
+                    default: return nullptr;
                 }
-                case 2:
+            case 2:
+                switch (channels)
                 {
-                    switch (channels)
-                    {
-                        case 1: // downmix 2 to 1
-                            for (std::uint32_t frame = 0; frame < frames; ++frame)
-                                samples[frame] = (sourceSamples[0 * frames + frame] +
-                                                  sourceSamples[1 * frames + frame]) * 0.5F; // M = (L + R) * 0.5
-                            break;
-                        case 4: // upmix 2 to 4
-                            for (std::uint32_t frame = 0; frame < frames; ++frame)
-                            {
-                                samples[0 * frames + frame] = sourceSamples[0 * frames + frame]; // L = L
-                                samples[1 * frames + frame] = sourceSamples[1 * frames + frame]; // R = R
-                                samples[2 * frames + frame] = 0.0F; // SL = 0
-                                samples[3 * frames + frame] = 0.0F; // SR = 0
-                            }
-                            break;
-                        case 6: // upmix 2 to 6
-                            for (std::uint32_t frame = 0; frame < frames; ++frame)
-                            {
-                                samples[0 * frames + frame] = sourceSamples[0 * frames + frame]; // L = L
-                                samples[1 * frames + frame] = sourceSamples[1 * frames + frame]; // R = R
-                                samples[2 * frames + frame] = 0.0F; // C = 0
-                                samples[3 * frames + frame] = 0.0F; // LFE = 0
-                                samples[4 * frames + frame] = 0.0F; // SL = 0
-                                samples[5 * frames + frame] = 0.0F; // SR = 0
-                            }
-                            break;
-                    }
-                    break;
+                    case 1: return downmix2To1;
+                    case 4: return upmix2To4;
+                    case 6: return upmix2To6;
+                    default: return nullptr;
                 }
-                case 4:
+            case 4:
+                switch (channels)
                 {
-                    switch (channels)
-                    {
-                        case 1: // downmix 4 to 1
-                            for (std::uint32_t frame = 0; frame < frames; ++frame)
-                                samples[frame] = (sourceSamples[0 * frames + frame] +
-                                                  sourceSamples[1 * frames + frame] +
-                                                  sourceSamples[2 * frames + frame] +
-                                                  sourceSamples[3 * frames + frame]) * 0.25F; // M = (L + R + SL + SR) * 0.25
-                            break;
-                        case 2: // downmix 4 to 2
-                            for (std::uint32_t frame = 0; frame < frames; ++frame)
-                            {
-                                samples[0 * frames + frame] = (sourceSamples[0 * frames + frame] +
-                                                               sourceSamples[2 * frames + frame]) * 0.5F; // L = (L + SL) * 0.5
-                                samples[1 * frames + frame] = (sourceSamples[1 * frames + frame] +
-                                                               sourceSamples[3 * frames + frame]) * 0.5F; // R = (R + RL) * 0.5
-                            }
-                            break;
-                        case 6: // upmix 4 to 6
-                            for (std::uint32_t frame = 0; frame < frames; ++frame)
-                            {
-                                samples[0 * frames + frame] = sourceSamples[0 * frames + frame]; // L = L
-                                samples[1 * frames + frame] = sourceSamples[1 * frames + frame]; // R = R
-                                samples[2 * frames + frame] = 0.0F; // C = 0
-                                samples[3 * frames + frame] = 0.0F; // LFE = 0
-                                samples[4 * frames + frame] = sourceSamples[2 * frames + frame]; // SL = SL
-                                samples[5 * frames + frame] = sourceSamples[3 * frames + frame]; // SR = SR
-                            }
-                            break;
-                    }
-                    break;
+                    case 1: return downmix4To1;
+                    case 2: return downmix4To2;
+                    case 6: return upmix4To6;
+                    default: return nullptr;
                 }
-                case 6:
+            case 6:
+                switch (channels)
                 {
-                    switch (channels)
-                    {
-                        case 1: // downmix 6 to 1
-                            for (std::uint32_t frame = 0; frame < frames; ++frame)
-                                samples[frame] = ((sourceSamples[0 * frames + frame] +
-                                                   sourceSamples[1 * frames + frame]) * 0.7071F +
-                                                  sourceSamples[2 * frames + frame] +
-                                                  (sourceSamples[4 * frames + frame] +
-                                                   sourceSamples[5 * frames + frame]) * 0.5F); // M = (L + R) * 0.7071 + C + (SL + SR) * 0.5
-                            break;
-                        case 2: // downmix 6 to 2
-                            for (std::uint32_t frame = 0; frame < frames; ++frame)
-                            {
-                                samples[frame * channels + 0] = (sourceSamples[0 * frames + frame] +
-                                                                 (sourceSamples[2 * frames + frame] +
-                                                                  sourceSamples[4 * frames + frame]) * 0.7071F); // L = L + (C + SL) * 0.7071
-                                samples[frame * channels + 1] = (sourceSamples[1 * frames + frame] +
-                                                                 (sourceSamples[2 * frames + frame] +
-                                                                  sourceSamples[5 * frames + frame]) * 0.7071F); // R = R + (C + SR) * 0.7071
-                            }
-                            break;
-                        case 4: // downmix 6 to 4
-                            for (std::uint32_t frame = 0; frame < frames; ++frame)
-                            {
-                                samples[frame * channels + 0] = (sourceSamples[0 * frames + frame] +
-                                                                 sourceSamples[2 * frames + frame] * 0.7071F); // L = L + C * 0.7071
-                                samples[frame * channels + 1] = (sourceSamples[1 * frames + frame] +
-                                                                 sourceSamples[2 * frames + frame] * 0.7071F); // R = R + C * 0.7071
-                                samples[frame * channels + 2] = sourceSamples[4 * frames + frame]; // SL = SL
-                                samples[frame * channels + 3] = sourceSamples[5 * frames + frame]; // SR = SR
-                            }
-                            break;
-                    }
-                    break;
+                    case 1: return downmix6To1;
+                    case 2: return downmix6To2;
+                    case 4: return downmix6To4;
+                    default: return nullptr;
                 }
-            }
+            default:
+                return nullptr;
         }
-        else
-            samples = sourceSamples;
     }
 
     void Bus::generateSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
                               const math::Vector<float, 3>& listenerPosition, const math::Quaternion<float>& listenerRotation,
-                              std::vector<float>& samples)
+                              Span<float> samples)
     {
-        samples.resize(frames * channels);
         std::fill(samples.begin(), samples.end(), 0.0F);
 
+        // the buffers were sized for the largest block of the mixer, so only their views are taken here
+        const Span<float> inputSamples{buffer.data(), samples.size()};
+
         for (auto bus : inputBuses)
         {
             bus->generateSamples(frames, channels, sampleRate,
-                                 listenerPosition, listenerRotation, buffer);
+                                 listenerPosition, listenerRotation, inputSamples);
 
-            for (std::size_t s = 0; s < samples.size(); ++s)
-                samples[s] += buffer[s];
+            mix(inputSamples.data(), samples.data(), samples.size());
         }
 
         for (auto stream : inputStreams)
@@ -246,23 +179,31 @@ namespace ouzel::audio::mixer
             {
                 const std::uint32_t sourceSampleRate = stream->getData().getSampleRate();
                 const std::uint32_t sourceChannels = stream->getData().getChannels();
+                const Span<float> streamSamples{stream->mixBuffer.data(), frames * sourceChannels};
 
                 if (sourceSampleRate != sampleRate)
                 {
                     std::uint32_t sourceFrames = (frames * sourceSampleRate + sampleRate - 1) / sampleRate; // round up
-                    stream->generateSamples(sourceFrames, resampleBuffer);
-                    resample(sourceChannels, sourceFrames, resampleBuffer, frames, mixBuffer);
+                    stream->generateSamples(sourceFrames, Span<float>{stream->resampleBuffer.data(), sourceFrames * sourceChannels});
+
+                    for (std::uint32_t channel = 0; channel < sourceChannels; ++channel)
+                        resample(&stream->resampleBuffer[channel * sourceFrames], sourceFrames,
+                                 &streamSamples[channel * frames], frames);
                 }
                 else
-                    stream->generateSamples(frames, mixBuffer);
+                    stream->generateSamples(frames, streamSamples);
 
                 if (sourceChannels != channels)
-                    convert(frames, sourceChannels, mixBuffer, channels, buffer);
-                else
-                    buffer = mixBuffer;
+                {
+                    if (const auto matrix = getChannelMatrix(sourceChannels, channels))
+                        convertChannels(streamSamples.data(), sourceChannels, inputSamples.data(), channels, frames, matrix);
+                    else
+                        std::fill(inputSamples.begin(), inputSamples.end(), 0.0F);
 
-                for (std::size_t s = 0; s < samples.size(); ++s)
-                    samples[s] += buffer[s];
+                    mix(inputSamples.data(), samples.data(), samples.size());
+                }
+                else
+                    mix(streamSamples.data(), samples.data(), samples.size());
             }
         }
 
@@ -271,14 +212,18 @@ namespace ouzel::audio::mixer
                 processor->process(frames, channels, sampleRate, samples);
     }
 
-    void Bus::addProcessor(Processor* processor)
+    bool Bus::addProcessor(Processor* processor)
     {
         if (std::find(processors.begin(), processors.end(), processor) == processors.end())
         {
+            if (processors.size() >= maxProcessors) return false;
+
             if (processor->bus) processor->bus->removeProcessor(processor);
             processor->bus = this;
             processors.push_back(processor);
         }
+
+        return true;
     }
 
     void Bus::removeProcessor(Processor* processor)
@@ -290,10 +235,15 @@ namespace ouzel::audio::mixer
         }
     }
 
-    void Bus::addInput(Bus* bus)
+    bool Bus::addInput(Bus* bus)
     {
         if (std::find(inputBuses.begin(), inputBuses.end(), bus) == inputBuses.end())
+        {
+            if (inputBuses.size() >= maxInputs) return false;
             inputBuses.push_back(bus);
+        }
+
+        return true;
     }
 
     void Bus::removeInput(Bus* bus)
@@ -302,9 +252,15 @@ namespace ouzel::audio::mixer
             inputBuses.erase(i);
     }
 
-    void Bus::addInput(Stream* stream)
+    bool Bus::addInput(Stream* stream)
     {
-        if (std::find(inputStreams.begin(), inputStreams.end(), stream) == inputStreams.end()) inputStreams.push_back(stream);
+        if (std::find(inputStreams.begin(), inputStreams.end(), stream) == inputStreams.end())
+        {
+            if (inputStreams.size() >= maxInputs) return false;
+            inputStreams.push_back(stream);
+        }
+
+        return true;
     }
 
     void Bus::removeInput(Stream* stream)
@@ -16,7 +16,8 @@ namespace ouzel::audio::mixer
         friend Processor;
         friend Stream;
     public:
-        Bus() noexcept {}
+        // the buffers are allocated here, so that the bus can be created outside of the mixer thread
+        Bus(std::uint32_t maxFrames, std::uint32_t channels);
         ~Bus() override;
         Bus(const Bus&) = delete;
         Bus& operator=(const Bus&) = delete;
@@ -24,19 +25,26 @@ namespace ouzel::audio::mixer
         Bus(Bus&&) = delete;
         Bus& operator=(Bus&&) = delete;
 
+        void detach() override;
+
         void setOutput(Bus* newOutput);
 
         void generateSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
                              const math::Vector<float, 3>& listenerPosition, const math::Quaternion<float>& listenerRotation,
-                             std::vector<float>& samples);
+                             Span<float> samples);
 
-        void addProcessor(Processor* processor);
+        // returns false if the bus already has maxProcessors processors
+        bool addProcessor(Processor* processor);
         void removeProcessor(Processor* processor);
 
     private:
-        void addInput(Bus* bus);
+        static constexpr std::size_t maxInputs = 64;
+        static constexpr std::size_t maxProcessors = 16;
+
+        // the inputs are never grown past the reserved capacity on the mixer thread
+        bool addInput(Bus* bus);
         void removeInput(Bus* bus);
-        void addInput(Stream* stream);
+        bool addInput(Stream* stream);
         void removeInput(Stream* stream);
 
         Bus* output = nullptr;
@@ -44,8 +52,6 @@ namespace ouzel::audio::mixer
         std::vector<Stream*> inputStreams;
         std::vector<Processor*> processors;
 
-        std::vector<float> resampleBuffer;
-        std::vector<float> mixBuffer;
         std::vector<float> buffer;
     };
 }
@@ -6,6 +6,8 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "Processor.hpp"
 #include "Source.hpp"
@@ -38,7 +40,8 @@ namespace ouzel::audio::mixer
             setStreamOutput,
             initData,
             initProcessor,
-            updateProcessor
+            updateProcessor,
+            reserveObjects
         };
 
         explicit constexpr Command(Type initType) noexcept: type{initType} {}
@@ -50,31 +53,27 @@ namespace ouzel::audio::mixer
     class InitObjectCommand final: public Command
     {
     public:
-        explicit constexpr InitObjectCommand(ObjectId initObjectId) noexcept:
-            Command{Command::Type::initObject},
-            objectId{initObjectId}
-        {}
-
         InitObjectCommand(ObjectId initObjectId,
-                          std::unique_ptr<Source> initSource) noexcept:
+                          std::unique_ptr<Object> initObject) noexcept:
             Command{Command::Type::initObject},
             objectId{initObjectId},
-            source{std::move(initSource)}
+            object{std::move(initObject)}
         {}
 
         const ObjectId objectId;
-        std::unique_ptr<Source> source;
+        std::unique_ptr<Object> object;
     };
 
     class DeleteObjectCommand final: public Command
     {
     public:
-        explicit constexpr DeleteObjectCommand(ObjectId initObjectId) noexcept:
+        explicit DeleteObjectCommand(ObjectId initObjectId) noexcept:
             Command{Command::Type::deleteObject},
             objectId{initObjectId}
         {}
 
         const ObjectId objectId;
+        std::unique_ptr<Object> object; // the mixer moves the deleted object here, so that it is destroyed with the command
     };
 
     class AddChildCommand final: public Command
@@ -133,12 +132,15 @@ namespace ouzel::audio::mixer
     class InitBusCommand final: public Command
     {
     public:
-        explicit constexpr InitBusCommand(ObjectId initBusId) noexcept:
+        InitBusCommand(ObjectId initBusId,
+                       std::unique_ptr<Bus> initBus) noexcept:
             Command{Command::Type::initBus},
-            busId{initBusId}
+            busId{initBusId},
+            bus{std::move(initBus)}
         {}
 
         const ObjectId busId;
+        std::unique_ptr<Bus> bus;
     };
 
     class SetBusOutputCommand final: public Command
@@ -197,15 +199,15 @@ namespace ouzel::audio::mixer
     class InitStreamCommand final: public Command
     {
     public:
-        constexpr InitStreamCommand(ObjectId initStreamId,
-                                    ObjectId initDataId) noexcept:
+        InitStreamCommand(ObjectId initStreamId,
+                          std::unique_ptr<Stream> initStream) noexcept:
             Command{Command::Type::initStream},
             streamId{initStreamId},
-            dataId{initDataId}
+            stream{std::move(initStream)}
         {}
 
         const ObjectId streamId;
-        const ObjectId dataId;
+        std::unique_ptr<Stream> stream;
     };
 
     class PlayStreamCommand final: public Command
@@ -289,6 +291,18 @@ namespace ouzel::audio::mixer
         const std::function<void(Processor*)> updateFunction;
     };
 
+    // grows the object storage of the mixer, the storage is allocated with the command
+    class ReserveObjectsCommand final: public Command
+    {
+    public:
+        explicit ReserveObjectsCommand(std::size_t initCapacity):
+            Command{Command::Type::reserveObjects},
+            objects(initCapacity)
+        {}
+
+        std::vector<std::unique_ptr<Object>> objects;
+    };
+
     class CommandBuffer final
     {
     public:
@@ -304,24 +318,18 @@ namespace ouzel::audio::mixer
 
         void pushCommand(std::unique_ptr<Command> command)
         {
-            commands.push(std::move(command));
-        }
-
-        std::unique_ptr<Command> popCommand()
-        {
-            auto result = std::move(commands.front());
-            commands.pop();
-            return result;
+            commands.push_back(std::move(command));
         }
 
-        auto& getCommands() const
+        // the commands are kept in the buffer after they are executed, so that they are destroyed with it
+        auto& getCommands() const noexcept
         {
             return commands;
         }
 
     private:
         std::string name;
-        std::queue<std::unique_ptr<Command>> commands;
+        std::vector<std::unique_ptr<Command>> commands;
     };
 }
 
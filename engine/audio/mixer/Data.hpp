@@ -13,8 +13,8 @@ namespace ouzel::audio::mixer
     class Data: public Object
     {
     public:
-        Data() noexcept = default;
-        Data(std::uint32_t initChannels, std::uint32_t initSampleRate) noexcept:
+        Data() = default;
+        Data(std::uint32_t initChannels, std::uint32_t initSampleRate):
             channels{initChannels}, sampleRate{initSampleRate}
         {
         }
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <vector>
 #include "Source.hpp"
+#include "../../utils/Span.hpp"
 
 namespace ouzel::audio::mixer
 {
@@ -23,7 +24,7 @@ namespace ouzel::audio::mixer
         virtual void play() = 0;
         virtual void stop(bool shouldReset) = 0;
 
-        virtual void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples) = 0;
+        virtual void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, Span<float> samples) = 0;
     };
 }
 
@@ -0,0 +1,274 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include "Kernels.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#endif
+
+namespace ouzel::audio::mixer
+{
+    void mix(const float* source, float* destination, std::size_t count) noexcept
+    {
+        std::size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i),
+                                                      _mm_loadu_ps(source + i)));
+#elif defined(__ARM_NEON__)
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(destination + i, vaddq_f32(vld1q_f32(destination + i),
+                                                 vld1q_f32(source + i)));
+#endif
+
+        for (; i < count; ++i)
+            destination[i] += source[i];
+    }
+
+    void mix(const float* source, float gain, float* destination, std::size_t count) noexcept
+    {
+        std::size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+        const auto gainVector = _mm_set1_ps(gain);
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i),
+                                                      _mm_mul_ps(_mm_loadu_ps(source + i), gainVector)));
+#elif defined(__ARM_NEON__)
+        const auto gainVector = vdupq_n_f32(gain);
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(destination + i, vmlaq_f32(vld1q_f32(destination + i),
+                                                 vld1q_f32(source + i), gainVector));
+#endif
+
+        for (; i < count; ++i)
+            destination[i] += source[i] * gain;
+    }
+
+    void scale(const float* source, float gain, float* destination, std::size_t count) noexcept
+    {
+        std::size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+        const auto gainVector = _mm_set1_ps(gain);
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(destination + i, _mm_mul_ps(_mm_loadu_ps(source + i), gainVector));
+#elif defined(__ARM_NEON__)
+        const auto gainVector = vdupq_n_f32(gain);
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(destination + i, vmulq_f32(vld1q_f32(source + i), gainVector));
+#endif
+
+        for (; i < count; ++i)
+            destination[i] = source[i] * gain;
+    }
+
+    void convertToInt16(const float* source, std::int16_t* destination, std::size_t count) noexcept
+    {
+        std::size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+        const auto minVector = _mm_set1_ps(-1.0F);
+        const auto maxVector = _mm_set1_ps(1.0F);
+        const auto scaleVector = _mm_set1_ps(32767.0F);
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const auto first = _mm_mul_ps(_mm_max_ps(_mm_min_ps(_mm_loadu_ps(source + i), maxVector), minVector), scaleVector);
+            const auto second = _mm_mul_ps(_mm_max_ps(_mm_min_ps(_mm_loadu_ps(source + i + 4), maxVector), minVector), scaleVector);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i),
+                             _mm_packs_epi32(_mm_cvttps_epi32(first), _mm_cvttps_epi32(second)));
+        }
+#elif defined(__ARM_NEON__)
+        const auto minVector = vdupq_n_f32(-1.0F);
+        const auto maxVector = vdupq_n_f32(1.0F);
+        const auto scaleVector = vdupq_n_f32(32767.0F);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const auto values = vmulq_f32(vmaxq_f32(vminq_f32(vld1q_f32(source + i), maxVector), minVector), scaleVector);
+            vst1_s16(destination + i, vqmovn_s32(vcvtq_s32_f32(values)));
+        }
+#endif
+
+        for (; i < count; ++i)
+            destination[i] = static_cast<std::int16_t>(std::clamp(source[i], -1.0F, 1.0F) * 32767.0F);
+    }
+
+    void interleave(const float* source, std::uint32_t channels, std::uint32_t frames, float* destination) noexcept
+    {
+        if (channels == 1)
+        {
+            std::copy(source, source + frames, destination);
+            return;
+        }
+
+        std::uint32_t frame = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+        if (channels == 2)
+            for (; frame + 4 <= frames; frame += 4)
+            {
+                const auto left = _mm_loadu_ps(source + frame);
+                const auto right = _mm_loadu_ps(source + frames + frame);
+                _mm_storeu_ps(destination + frame * 2, _mm_unpacklo_ps(left, right));
+                _mm_storeu_ps(destination + frame * 2 + 4, _mm_unpackhi_ps(left, right));
+            }
+#elif defined(__ARM_NEON__)
+        if (channels == 2)
+            for (; frame + 4 <= frames; frame += 4)
+            {
+                float32x4x2_t values;
+                values.val[0] = vld1q_f32(source + frame);
+                values.val[1] = vld1q_f32(source + frames + frame);
+                vst2q_f32(destination + frame * 2, values);
+            }
+#endif
+
+        for (; frame < frames; ++frame)
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+                destination[frame * channels + channel] = source[channel * frames + frame];
+    }
+
+    void deinterleave(const float* source, std::uint32_t channels, std::uint32_t frames, float* destination) noexcept
+    {
+        if (channels == 1)
+        {
+            std::copy(source, source + frames, destination);
+            return;
+        }
+
+        std::uint32_t frame = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+        if (channels == 2)
+            for (; frame + 4 <= frames; frame += 4)
+            {
+                const auto first = _mm_loadu_ps(source + frame * 2);
+                const auto second = _mm_loadu_ps(source + frame * 2 + 4);
+                _mm_storeu_ps(destination + frame, _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+                _mm_storeu_ps(destination + frames + frame, _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+#elif defined(__ARM_NEON__)
+        if (channels == 2)
+            for (; frame + 4 <= frames; frame += 4)
+            {
+                const auto values = vld2q_f32(source + frame * 2);
+                vst1q_f32(destination + frame, values.val[0]);
+                vst1q_f32(destination + frames + frame, values.val[1]);
+            }
+#endif
+
+        for (; frame < frames; ++frame)
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+                destination[channel * frames + frame] = source[frame * channels + channel];
+    }
+
+    void resample(const float* source, std::uint32_t sourceFrames, float* destination, std::uint32_t frames) noexcept
+    {
+        if (frames == 0) return;
+
+        if (sourceFrames < 2)
+        {
+            std::fill(destination, destination + frames, sourceFrames ? source[0] : 0.0F);
+            return;
+        }
+
+        const auto increment = (frames > 1) ? static_cast<float>(sourceFrames - 1) / static_cast<float>(frames - 1) : 0.0F;
+        const auto lastIndex = static_cast<std::int32_t>(sourceFrames - 2);
+
+        std::uint32_t frame = 0;
+
+        // positions are calculated from the frame index, so that the rounding errors don't accumulate
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+        const auto incrementVector = _mm_set1_ps(increment);
+        const auto frameOffsets = _mm_set_ps(3.0F, 2.0F, 1.0F, 0.0F);
+
+        for (; frame + 4 < frames; frame += 4)
+        {
+            const auto positions = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(frame)), frameOffsets), incrementVector);
+            const auto indexVector = _mm_cvttps_epi32(positions);
+            const auto fractions = _mm_sub_ps(positions, _mm_cvtepi32_ps(indexVector));
+
+            alignas(16) std::int32_t indices[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(indices), indexVector);
+            for (auto& index : indices) index = std::min(index, lastIndex);
+
+            const auto current = _mm_set_ps(source[indices[3]], source[indices[2]], source[indices[1]], source[indices[0]]);
+            const auto next = _mm_set_ps(source[indices[3] + 1], source[indices[2] + 1], source[indices[1] + 1], source[indices[0] + 1]);
+
+            _mm_storeu_ps(destination + frame, _mm_add_ps(current, _mm_mul_ps(_mm_sub_ps(next, current), fractions)));
+        }
+#elif defined(__ARM_NEON__)
+        const auto incrementVector = vdupq_n_f32(increment);
+        const float frameOffsetValues[] = {0.0F, 1.0F, 2.0F, 3.0F};
+        const auto frameOffsets = vld1q_f32(frameOffsetValues);
+
+        for (; frame + 4 < frames; frame += 4)
+        {
+            const auto positions = vmulq_f32(vaddq_f32(vdupq_n_f32(static_cast<float>(frame)), frameOffsets), incrementVector);
+            const auto indexVector = vcvtq_s32_f32(positions);
+            const auto fractions = vsubq_f32(positions, vcvtq_f32_s32(indexVector));
+
+            std::int32_t indices[4];
+            vst1q_s32(indices, indexVector);
+            for (auto& index : indices) index = std::min(index, lastIndex);
+
+            const float currentValues[] = {source[indices[0]], source[indices[1]], source[indices[2]], source[indices[3]]};
+            const float nextValues[] = {source[indices[0] + 1], source[indices[1] + 1], source[indices[2] + 1], source[indices[3] + 1]};
+            const auto current = vld1q_f32(currentValues);
+            const auto next = vld1q_f32(nextValues);
+
+            vst1q_f32(destination + frame, vmlaq_f32(current, vsubq_f32(next, current), fractions));
+        }
+#endif
+
+        for (; frame + 1 < frames; ++frame)
+        {
+            const auto position = static_cast<float>(frame) * increment;
+            const auto index = std::min(static_cast<std::int32_t>(position), lastIndex);
+            const auto fraction = position - static_cast<float>(index);
+
+            destination[frame] = source[index] + (source[index + 1] - source[index]) * fraction;
+        }
+
+        // the last frame of the destination is the last frame of the source
+        destination[frames - 1] = source[sourceFrames - 1];
+    }
+
+    void convertChannels(const float* source, std::uint32_t sourceChannels,
+                         float* destination, std::uint32_t channels,
+                         std::uint32_t frames, const float* matrix) noexcept
+    {
+        for (std::uint32_t channel = 0; channel < channels; ++channel)
+        {
+            const auto outputChannel = destination + channel * frames;
+            bool written = false;
+
+            for (std::uint32_t sourceChannel = 0; sourceChannel < sourceChannels; ++sourceChannel)
+            {
+                const auto gain = matrix[channel * sourceChannels + sourceChannel];
+                if (gain == 0.0F) continue;
+
+                const auto inputChannel = source + sourceChannel * frames;
+
+                if (written)
+                    mix(inputChannel, gain, outputChannel, frames);
+                else if (gain == 1.0F)
+                    std::copy(inputChannel, inputChannel + frames, outputChannel);
+                else
+                    scale(inputChannel, gain, outputChannel, frames);
+
+                written = true;
+            }
+
+            if (!written)
+                std::fill(outputChannel, outputChannel + frames, 0.0F);
+        }
+    }
+}
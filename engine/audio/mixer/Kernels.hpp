@@ -0,0 +1,40 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_AUDIO_MIXER_KERNELS_HPP
+#define OUZEL_AUDIO_MIXER_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Sample processing loops of the mixer, vectorized with SSE2 or NEON where available
+// Multi-channel buffers are planar (all frames of the first channel, then the second channel etc.) unless noted otherwise
+namespace ouzel::audio::mixer
+{
+    // destination += source
+    void mix(const float* source, float* destination, std::size_t count) noexcept;
+
+    // destination += source * gain
+    void mix(const float* source, float gain, float* destination, std::size_t count) noexcept;
+
+    // destination = source * gain, source and destination can be the same buffer
+    void scale(const float* source, float gain, float* destination, std::size_t count) noexcept;
+
+    // converts samples in the range [-1, 1] to 16-bit integers, values outside the range are clamped
+    void convertToInt16(const float* source, std::int16_t* destination, std::size_t count) noexcept;
+
+    // planar source to interleaved destination
+    void interleave(const float* source, std::uint32_t channels, std::uint32_t frames, float* destination) noexcept;
+
+    // interleaved source to planar destination
+    void deinterleave(const float* source, std::uint32_t channels, std::uint32_t frames, float* destination) noexcept;
+
+    // linearly resamples a single channel, the first and the last frames of the source and the destination are aligned
+    void resample(const float* source, std::uint32_t sourceFrames, float* destination, std::uint32_t frames) noexcept;
+
+    // destination channel c = sum of source channel s * matrix[c * sourceChannels + s]
+    void convertChannels(const float* source, std::uint32_t sourceChannels,
+                         float* destination, std::uint32_t channels,
+                         std::uint32_t frames, const float* matrix) noexcept;
+}
+
+#endif // OUZEL_AUDIO_MIXER_KERNELS_HPP
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <vector>
 #include "Source.hpp"
+#include "../../utils/Span.hpp"
 
 namespace ouzel::audio::mixer
 {
@@ -20,7 +21,7 @@ namespace ouzel::audio::mixer
         Mix(Mix&&) = delete;
         Mix& operator=(Mix&&) = delete;
 
-        virtual void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples) = 0;
+        virtual void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, Span<float> samples) = 0;
 
     private:
         Object* parent = nullptr;
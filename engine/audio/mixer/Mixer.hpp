@@ -3,36 +3,38 @@
 #ifndef OUZEL_AUDIO_MIXER_MIXER_HPP
 #define OUZEL_AUDIO_MIXER_MIXER_HPP
 
-#include <condition_variable>
 #include <cstdint>
 #include <functional>
-#include <mutex>
 #include <queue>
-#include <set>
-#include <thread>
 #include <vector>
 #include "Commands.hpp"
+#include "Kernels.hpp"
 #include "Object.hpp"
 #include "Processor.hpp"
-#include "../../thread/Thread.hpp"
+#include "../../thread/SpscQueue.hpp"
+#include "../../utils/Span.hpp"
 
 namespace ouzel::audio::mixer
 {
     class RootObject final: public Object
     {
     public:
-        void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples) override
+        RootObject(std::uint32_t maxFrames, std::uint32_t channels):
+            buffer(maxFrames * channels)
+        {
+        }
+
+        void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, Span<float> samples) override
         {
-            samples.resize(frames * channels);
             std::fill(samples.begin(), samples.end(), 0.0F);
 
+            const Span<float> childSamples{buffer.data(), samples.size()};
+
             for (auto child : children)
             {
-                child->getSamples(frames, channels, sampleRate, buffer);
+                child->getSamples(frames, channels, sampleRate, childSamples);
 
-                for (std::uint32_t channel = 0; channel < channels; ++channel)
-                    for (std::uint32_t frame = 0; frame < frames; ++frame)
-                        samples[channel * frames + frame] += buffer[channel * frames + frame];
+                mix(childSamples.data(), samples.data(), samples.size());
             }
         }
 
@@ -61,10 +63,10 @@ namespace ouzel::audio::mixer
             std::size_t objectId;
         };
 
+        // the mixer allocates all its buffers for blocks of at most initBufferSize frames
         Mixer(std::uint32_t initBufferSize,
-              std::uint32_t initChannels);
-
-        ~Mixer();
+              std::uint32_t initChannels,
+              std::uint32_t initSampleRate);
 
         Mixer(const Mixer&) = delete;
         Mixer& operator=(const Mixer&) = delete;
@@ -72,16 +74,24 @@ namespace ouzel::audio::mixer
         Mixer(Mixer&&) = delete;
         Mixer& operator=(Mixer&&) = delete;
 
+        auto getBufferSize() const noexcept { return bufferSize; }
+        auto getChannels() const noexcept { return channels; }
+        auto getSampleRate() const noexcept { return sampleRate; }
+
+        // called on the audio thread, doesn't allocate memory or take locks
         void process();
-        void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples);
+        void getSamples(std::uint32_t frames, Span<float> samples);
+
+        static constexpr std::size_t initialObjectCapacity = 256;
 
         using ObjectId = std::size_t;
+        // called on the game thread only, freed ids are reused before new ones are handed out
         ObjectId getObjectId()
         {
-            if (const auto i = deletedObjectIds.begin(); i != deletedObjectIds.end())
+            if (!deletedObjectIds.empty())
             {
-                const auto objectId = *i;
-                deletedObjectIds.erase(i);
+                const auto objectId = deletedObjectIds.back();
+                deletedObjectIds.pop_back();
                 return objectId;
             }
             else
@@ -90,15 +100,18 @@ namespace ouzel::audio::mixer
 
         void deleteObjectId(ObjectId objectId)
         {
-            deletedObjectIds.insert(objectId);
+            deletedObjectIds.push_back(objectId);
         }
 
-        void submitCommandBuffer(CommandBuffer&& commandBuffer)
+        // returns false if the queue is full, in that case the command buffer is left intact
+        bool submitCommandBuffer(CommandBuffer&& commandBuffer)
         {
-            std::scoped_lock lock{commandQueueMutex};
-            commandQueue.push(std::move(commandBuffer));
+            return commandQueue.tryPush(std::move(commandBuffer));
         }
 
+        // destroys the command buffers that the mixer has executed, so that they are not freed on the audio thread
+        void releaseCommandBuffers();
+
         auto getRootObjectId() const noexcept
         {
             return rootObjectId;
@@ -110,15 +123,18 @@ namespace ouzel::audio::mixer
         void sendEvent(const Event& event);
 
     private:
-        void mixerMain();
+        static constexpr std::size_t commandQueueCapacity = 64;
+        static constexpr std::size_t eventQueueCapacity = 256;
+
+        void execute(Command& command);
 
         std::uint32_t bufferSize;
         std::uint32_t channels;
-        std::queue<Event> eventQueue;
-        std::mutex eventQueueMutex;
+        std::uint32_t sampleRate;
+        thread::SpscQueue<Event> eventQueue{eventQueueCapacity};
 
         ObjectId lastObjectId = 0;
-        std::set<ObjectId> deletedObjectIds;
+        std::vector<ObjectId> deletedObjectIds;
 
         std::vector<std::unique_ptr<Object>> objects;
         std::size_t rootObjectId = 0;
@@ -126,35 +142,11 @@ namespace ouzel::audio::mixer
 
         Bus* masterBus = nullptr;
 
-        class Buffer final
-        {
-        public:
-            Buffer(std::size_t size, std::uint32_t initChannels):
-                maxFrames{size},
-                channels{initChannels},
-                buffer(size * channels)
-            {
-            }
-
-            bool canRead() const noexcept { return frames > 0; }
-            bool canWrite() const noexcept { return frames < maxFrames; }
-
-        private:
-            std::size_t frames = 0;
-            std::size_t maxFrames;
-            std::uint32_t channels;
-            std::size_t readPosition = 0;
-            std::size_t writePosition = 0;
-            std::vector<float> buffer;
-        };
-
-        thread::Thread mixerThread;
-        std::mutex bufferMutex;
-        std::condition_variable bufferCondition;
-        Buffer buffer;
+        std::vector<float> blockBuffer;
 
-        std::queue<CommandBuffer> commandQueue;
-        std::mutex commandQueueMutex;
+        thread::SpscQueue<CommandBuffer> commandQueue{commandQueueCapacity};
+        thread::SpscQueue<CommandBuffer> executedCommandBuffers{commandQueueCapacity + 1};
+        CommandBuffer executedCommandBuffer; // the last executed buffer, if it didn't fit in the queue
     };
 }
 
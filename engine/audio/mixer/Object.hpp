@@ -3,10 +3,13 @@
 #ifndef OUZEL_AUDIO_MIXER_OBJECT_HPP
 #define OUZEL_AUDIO_MIXER_OBJECT_HPP
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
 #include "Source.hpp"
+#include "../../utils/Span.hpp"
 #include "../../math/Quaternion.hpp"
 #include "../../math/Vector.hpp"
 
@@ -15,16 +18,27 @@ namespace ouzel::audio::mixer
     class Object
     {
     public:
-        Object() noexcept = default;
-        explicit Object(std::unique_ptr<Source> initSource) noexcept:
+        // children are added on the mixer thread, so the storage for them is reserved up front
+        static constexpr std::size_t maxChildren = 64;
+
+        Object()
+        {
+            children.reserve(maxChildren);
+        }
+
+        explicit Object(std::unique_ptr<Source> initSource):
             source{std::move(initSource)}
         {
+            children.reserve(maxChildren);
         }
 
         virtual ~Object()
         {
             if (parent)
                 parent->removeChild(*this);
+
+            for (auto child : children)
+                child->parent = nullptr;
         }
 
         Object(const Object&) = delete;
@@ -33,10 +47,13 @@ namespace ouzel::audio::mixer
         Object(Object&&) = delete;
         Object& operator=(Object&&) = delete;
 
-        void addChild(Object& child)
+        // returns false without changing the graph if the object already has maxChildren children
+        bool addChild(Object& child)
         {
             if (child.parent != this)
             {
+                if (children.size() >= maxChildren) return false;
+
                 if (child.parent)
                     child.parent->removeChild(child);
 
@@ -46,6 +63,8 @@ namespace ouzel::audio::mixer
                     children.push_back(&child);
                 }
             }
+
+            return true;
         }
 
         void removeChild(Object& child)
@@ -53,11 +72,23 @@ namespace ouzel::audio::mixer
             if (child.parent == this)
                 if (const auto i = std::find(children.begin(), children.end(), &child); i != children.end())
                 {
-                    child.parent = this;
+                    child.parent = nullptr;
                     children.erase(i);
                 }
         }
 
+        // removes the object from the graph, so that it can be destroyed outside of the mixer thread
+        virtual void detach()
+        {
+            if (parent)
+                parent->removeChild(*this);
+
+            for (auto child : children)
+                child->parent = nullptr;
+
+            children.clear();
+        }
+
         void play()
         {
             if (source)
@@ -71,7 +102,7 @@ namespace ouzel::audio::mixer
         }
 
         // TODO: make non-virtual
-        virtual void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples)
+        virtual void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, Span<float> samples)
         {
             for (auto child : children)
                 child->getSamples(frames, channels, sampleRate, samples);
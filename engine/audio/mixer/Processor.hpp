@@ -12,12 +12,24 @@ namespace ouzel::audio::mixer
     {
         friend Bus;
     public:
-        Processor() noexcept = default;
+        Processor() = default;
         ~Processor() override
         {
             if (bus) bus->removeProcessor(this);
         }
 
+        void detach() override
+        {
+            Object::detach();
+
+            if (bus) bus->removeProcessor(this);
+        }
+
+        // allocates the buffers of the processor, called before the processor is passed to the mixer
+        virtual void reserve([[maybe_unused]] std::uint32_t maxFrames,
+                             [[maybe_unused]] std::uint32_t channels,
+                             [[maybe_unused]] std::uint32_t sampleRate) {}
+
         Processor(const Processor&) = delete;
         Processor& operator=(const Processor&) = delete;
 
@@ -25,7 +37,7 @@ namespace ouzel::audio::mixer
         Processor& operator=(Processor&&) = delete;
 
         virtual void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
-                             std::vector<float>& samples) = 0;
+                             Span<float> samples) = 0;
 
         auto isEnabled() const noexcept { return enabled; }
         void setEnabled(bool newEnabled) { enabled = newEnabled; }
@@ -0,0 +1,153 @@
+// Ouzel by Elviss Strazdins
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#  include <malloc.h>
+#endif
+#include "RealTime.hpp"
+#include "../../utils/Log.hpp"
+
+namespace ouzel::audio::mixer
+{
+    namespace
+    {
+        void logViolation(RealTimeViolation violation, std::size_t size)
+        {
+            switch (violation)
+            {
+                case RealTimeViolation::allocation:
+                    log(Log::Level::warning) << "Allocated " << size << " bytes on the audio thread";
+                    break;
+                case RealTimeViolation::deallocation:
+                    log(Log::Level::warning) << "Freed memory on the audio thread";
+                    break;
+            }
+        }
+
+        std::atomic<RealTimeViolationHandler> violationHandler{logViolation};
+        thread_local std::uint32_t realTimeDepth = 0;
+
+#ifdef OUZEL_CHECK_REALTIME_ALLOCATIONS
+        void reportViolation(RealTimeViolation violation, std::size_t size)
+        {
+            if (realTimeDepth == 0) return;
+
+            // the handler is allowed to allocate
+            const auto depth = realTimeDepth;
+            realTimeDepth = 0;
+            violationHandler.load(std::memory_order_relaxed)(violation, size);
+            realTimeDepth = depth;
+        }
+#endif
+    }
+
+    void setRealTimeViolationHandler(RealTimeViolationHandler handler) noexcept
+    {
+        violationHandler.store(handler ? handler : logViolation, std::memory_order_relaxed);
+    }
+
+    bool isRealTime() noexcept
+    {
+        return realTimeDepth > 0;
+    }
+
+    RealTimeScope::RealTimeScope() noexcept
+    {
+        ++realTimeDepth;
+    }
+
+    RealTimeScope::~RealTimeScope()
+    {
+        --realTimeDepth;
+    }
+}
+
+#ifdef OUZEL_CHECK_REALTIME_ALLOCATIONS
+namespace
+{
+    void* allocate(std::size_t size) noexcept
+    {
+        ouzel::audio::mixer::reportViolation(ouzel::audio::mixer::RealTimeViolation::allocation, size);
+        return std::malloc(size ? size : 1);
+    }
+
+    void* allocate(std::size_t size, std::align_val_t alignment) noexcept
+    {
+        ouzel::audio::mixer::reportViolation(ouzel::audio::mixer::RealTimeViolation::allocation, size);
+
+        const auto align = static_cast<std::size_t>(alignment);
+        // aligned_alloc requires the size to be a multiple of the alignment
+        const auto alignedSize = ((size ? size : 1) + align - 1) / align * align;
+#ifdef _WIN32
+        return _aligned_malloc(alignedSize, align);
+#else
+        return std::aligned_alloc(align, alignedSize);
+#endif
+    }
+
+    void deallocate(void* pointer) noexcept
+    {
+        if (pointer)
+            ouzel::audio::mixer::reportViolation(ouzel::audio::mixer::RealTimeViolation::deallocation, 0);
+
+        std::free(pointer);
+    }
+
+    void deallocate(void* pointer, std::align_val_t) noexcept
+    {
+        if (pointer)
+            ouzel::audio::mixer::reportViolation(ouzel::audio::mixer::RealTimeViolation::deallocation, 0);
+
+#ifdef _WIN32
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    if (const auto result = allocate(size)) return result;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size)
+{
+    if (const auto result = allocate(size)) return result;
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (const auto result = allocate(size, alignment)) return result;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (const auto result = allocate(size, alignment)) return result;
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate(size, alignment); }
+
+void operator delete(void* pointer) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, std::align_val_t alignment) noexcept { deallocate(pointer, alignment); }
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept { deallocate(pointer, alignment); }
+void operator delete(void* pointer, std::size_t, std::align_val_t alignment) noexcept { deallocate(pointer, alignment); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t alignment) noexcept { deallocate(pointer, alignment); }
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(pointer, alignment); }
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(pointer, alignment); }
+#endif
@@ -0,0 +1,40 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_AUDIO_MIXER_REALTIME_HPP
+#define OUZEL_AUDIO_MIXER_REALTIME_HPP
+
+#include <cstddef>
+
+namespace ouzel::audio::mixer
+{
+    enum class RealTimeViolation
+    {
+        allocation,
+        deallocation
+    };
+
+    using RealTimeViolationHandler = void(*)(RealTimeViolation violation, std::size_t size);
+
+    // the handler is called when memory is allocated or freed inside of a real-time scope
+    // violations are detected only if the engine is built with OUZEL_CHECK_REALTIME_ALLOCATIONS defined,
+    // which replaces the global operator new and delete, the default handler logs a warning
+    void setRealTimeViolationHandler(RealTimeViolationHandler handler) noexcept;
+
+    bool isRealTime() noexcept;
+
+    // marks the code that runs on the audio thread and must not block
+    class RealTimeScope final
+    {
+    public:
+        RealTimeScope() noexcept;
+        ~RealTimeScope();
+
+        RealTimeScope(const RealTimeScope&) = delete;
+        RealTimeScope& operator=(const RealTimeScope&) = delete;
+
+        RealTimeScope(RealTimeScope&&) = delete;
+        RealTimeScope& operator=(RealTimeScope&&) = delete;
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_REALTIME_HPP
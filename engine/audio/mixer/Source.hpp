@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <vector>
+#include "../../utils/Span.hpp"
 
 namespace ouzel::audio::mixer
 {
@@ -17,7 +18,7 @@ namespace ouzel::audio::mixer
         virtual void play() = 0;
         virtual void stop(bool shouldReset) = 0;
 
-        virtual void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples) = 0;
+        virtual void getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, Span<float> samples) = 0;
     };
 }
 
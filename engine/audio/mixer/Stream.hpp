@@ -3,6 +3,8 @@
 #ifndef OUZEL_AUDIO_MIXER_STREAM_HPP
 #define OUZEL_AUDIO_MIXER_STREAM_HPP
 
+#include <cstdint>
+#include <vector>
 #include "Object.hpp"
 #include "Bus.hpp"
 #include "Data.hpp"
@@ -16,7 +18,7 @@ namespace ouzel::audio::mixer
     {
         friend Bus;
     public:
-        explicit Stream(Data& initData) noexcept:
+        explicit Stream(Data& initData):
             data{initData}
         {
         }
@@ -26,6 +28,24 @@ namespace ouzel::audio::mixer
             if (output) output->removeInput(this);
         }
 
+        void detach() override
+        {
+            Object::detach();
+
+            if (output) output->removeInput(this);
+            output = nullptr;
+        }
+
+        // allocates the buffers that the bus mixes the stream through, called before the stream is passed to the mixer
+        void reserve(std::uint32_t maxFrames, [[maybe_unused]] std::uint32_t channels, std::uint32_t sampleRate)
+        {
+            const auto sourceChannels = data.getChannels();
+            const auto maxSourceFrames = (maxFrames * data.getSampleRate() + sampleRate - 1) / sampleRate;
+
+            resampleBuffer.resize(maxSourceFrames * sourceChannels);
+            mixBuffer.resize(maxFrames * sourceChannels);
+        }
+
         Stream(const Stream&) = delete;
         Stream& operator=(const Object&) = delete;
 
@@ -38,7 +58,7 @@ namespace ouzel::audio::mixer
         {
             if (output) output->removeInput(this);
             output = newOutput;
-            if (output) output->addInput(this);
+            if (output && !output->addInput(this)) output = nullptr;
         }
 
         auto isPlaying() const noexcept { return playing; }
@@ -52,12 +72,16 @@ namespace ouzel::audio::mixer
 
         virtual void reset() = 0;
 
-        virtual void generateSamples(std::uint32_t frames, std::vector<float>& samples) = 0;
+        virtual void generateSamples(std::uint32_t frames, Span<float> samples) = 0;
 
     protected:
         Data& data;
         Bus* output = nullptr;
         bool playing = false;
+
+    private:
+        std::vector<float> resampleBuffer;
+        std::vector<float> mixBuffer;
     };
 }
 
@@ -8,6 +8,7 @@
 #include "Setup.h"
 #include "Engine.hpp"
 #include "../scene/Scene.hpp"
+#include "../utils/Profiler.hpp"
 #include "../utils/Utils.hpp"
 
 #if OUZEL_COMPILE_OPENGL
@@ -17,23 +18,33 @@
 #    include "opengl/ColorVSGLES2.h"
 #    include "opengl/TexturePSGLES2.h"
 #    include "opengl/TextureVSGLES2.h"
+#    include "opengl/TextPSGLES2.h"
+#    include "opengl/DistanceFieldPSGLES2.h"
 #    include "opengl/ColorPSGLES3.h"
 #    include "opengl/ColorVSGLES3.h"
 #    include "opengl/TexturePSGLES3.h"
 #    include "opengl/TextureVSGLES3.h"
+#    include "opengl/TextPSGLES3.h"
+#    include "opengl/DistanceFieldPSGLES3.h"
 #  else
 #    include "opengl/ColorPSGL2.h"
 #    include "opengl/ColorVSGL2.h"
 #    include "opengl/TexturePSGL2.h"
 #    include "opengl/TextureVSGL2.h"
+#    include "opengl/TextPSGL2.h"
+#    include "opengl/DistanceFieldPSGL2.h"
 #    include "opengl/ColorPSGL3.h"
 #    include "opengl/ColorVSGL3.h"
 #    include "opengl/TexturePSGL3.h"
 #    include "opengl/TextureVSGL3.h"
+#    include "opengl/TextPSGL3.h"
+#    include "opengl/DistanceFieldPSGL3.h"
 #    include "opengl/ColorPSGL4.h"
 #    include "opengl/ColorVSGL4.h"
 #    include "opengl/TexturePSGL4.h"
 #    include "opengl/TextureVSGL4.h"
+#    include "opengl/TextPSGL4.h"
+#    include "opengl/DistanceFieldPSGL4.h"
 #  endif
 #endif
 
@@ -117,6 +128,9 @@ namespace ouzel::core
             const auto& maxAnisotropyValue = userEngineSection.getValue("maxAnisotropy", defaultEngineSection.getValue("maxAnisotropy"));
             if (!maxAnisotropyValue.empty()) settings.graphicsSettings.maxAnisotropy = static_cast<std::uint32_t>(std::stoul(maxAnisotropyValue));
 
+            const auto& framesInFlightValue = userEngineSection.getValue("framesInFlight", defaultEngineSection.getValue("framesInFlight"));
+            if (!framesInFlightValue.empty()) settings.graphicsSettings.framesInFlight = static_cast<std::uint32_t>(std::stoul(framesInFlightValue));
+
             const auto& resizableValue = userEngineSection.getValue("resizable", defaultEngineSection.getValue("resizable"));
             if (!resizableValue.empty()) settings.resizable = (resizableValue == "true" || resizableValue == "1" || resizableValue == "yes");
 
@@ -149,6 +163,11 @@ namespace ouzel::core
 
             settings.audioSettings.audioDevice = userEngineSection.getValue("audioDevice", defaultEngineSection.getValue("audioDevice"));
 
+            const auto& asyncLogValue = userEngineSection.getValue("asyncLog", defaultEngineSection.getValue("asyncLog"));
+            if (!asyncLogValue.empty()) settings.asyncLog = (asyncLogValue == "true" || asyncLogValue == "1" || asyncLogValue == "yes");
+
+            settings.binaryLog = userEngineSection.getValue("binaryLog", defaultEngineSection.getValue("binaryLog"));
+
             return settings;
         }
 
@@ -179,6 +198,9 @@ namespace ouzel::core
     {
         engine = this;
 
+        if (settings.asyncLog)
+            log.startAsync(Logger::defaultBufferSize, settings.binaryLog.empty() ? storage::Path{} : fileSystem.getStorageDirectory() / settings.binaryLog);
+
         // default assets
         switch (settings.graphicsDriver)
         {
@@ -288,6 +310,224 @@ namespace ouzel::core
 
                 assetBundle.setShader(shaderTexture, std::move(textureShader));
 
+                // the glyphs of the TrueType fonts are stored in single channel textures
+                std::unique_ptr<graphics::Shader> textShader;
+
+                switch (graphics.getDevice()->getAPIMajorVersion())
+                {
+#  if OUZEL_OPENGLES
+                    case 2:
+                        textShader = std::make_unique<graphics::Shader>(graphics,
+                                                                        std::vector<std::uint8_t>(std::begin(TextPSGLES2_glsl),
+                                                                                                  std::end(TextPSGLES2_glsl)),
+                                                                        std::vector<std::uint8_t>(std::begin(TextureVSGLES2_glsl),
+                                                                                                  std::end(TextureVSGLES2_glsl)),
+                                                                        std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                            {graphics::Vertex::Attribute::Usage::position},
+                                                                            {graphics::Vertex::Attribute::Usage::color},
+                                                                            {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U}
+                                                                        },
+                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                            {"color", graphics::DataType::float32Vector4}
+                                                                        },
+                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                            {"modelViewProj", graphics::DataType::float32Matrix4}
+                                                                        });
+                        break;
+                    case 3:
+                        textShader = std::make_unique<graphics::Shader>(graphics,
+                                                                        std::vector<std::uint8_t>(std::begin(TextPSGLES3_glsl),
+                                                                                                  std::end(TextPSGLES3_glsl)),
+                                                                        std::vector<std::uint8_t>(std::begin(TextureVSGLES3_glsl),
+                                                                                                  std::end(TextureVSGLES3_glsl)),
+                                                                        std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                            {graphics::Vertex::Attribute::Usage::position},
+                                                                            {graphics::Vertex::Attribute::Usage::color},
+                                                                            {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U}
+                                                                        },
+                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                            {"color", graphics::DataType::float32Vector4}
+                                                                        },
+                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                            {"modelViewProj", graphics::DataType::float32Matrix4}
+                                                                        });
+                        break;
+#  else
+                    case 2:
+                        textShader = std::make_unique<graphics::Shader>(graphics,
+                                                                        std::vector<std::uint8_t>(std::begin(TextPSGL2_glsl),
+                                                                                                  std::end(TextPSGL2_glsl)),
+                                                                        std::vector<std::uint8_t>(std::begin(TextureVSGL2_glsl),
+                                                                                                  std::end(TextureVSGL2_glsl)),
+                                                                        std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                            {graphics::Vertex::Attribute::Usage::position},
+                                                                            {graphics::Vertex::Attribute::Usage::color},
+                                                                            {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U}
+                                                                        },
+                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                            {"color", graphics::DataType::float32Vector4}
+                                                                        },
+                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                            {"modelViewProj", graphics::DataType::float32Matrix4}
+                                                                        });
+                        break;
+                    case 3:
+                        textShader = std::make_unique<graphics::Shader>(graphics,
+                                                                        std::vector<std::uint8_t>(std::begin(TextPSGL3_glsl),
+                                                                                                  std::end(TextPSGL3_glsl)),
+                                                                        std::vector<std::uint8_t>(std::begin(TextureVSGL3_glsl),
+                                                                                                  std::end(TextureVSGL3_glsl)),
+                                                                        std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                            {graphics::Vertex::Attribute::Usage::position},
+                                                                            {graphics::Vertex::Attribute::Usage::color},
+                                                                            {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U}
+                                                                        },
+                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                            {"color", graphics::DataType::float32Vector4}
+                                                                        },
+                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                            {"modelViewProj", graphics::DataType::float32Matrix4}
+                                                                        });
+                        break;
+                    case 4:
+                        textShader = std::make_unique<graphics::Shader>(graphics,
+                                                                        std::vector<std::uint8_t>(std::begin(TextPSGL4_glsl),
+                                                                                                  std::end(TextPSGL4_glsl)),
+                                                                        std::vector<std::uint8_t>(std::begin(TextureVSGL4_glsl),
+                                                                                                  std::end(TextureVSGL4_glsl)),
+                                                                        std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                            {graphics::Vertex::Attribute::Usage::position},
+                                                                            {graphics::Vertex::Attribute::Usage::color},
+                                                                            {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U}
+                                                                        },
+                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                            {"color", graphics::DataType::float32Vector4}
+                                                                        },
+                                                                        std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                            {"modelViewProj", graphics::DataType::float32Matrix4}
+                                                                        });
+                        break;
+#  endif
+                    default:
+                        throw std::runtime_error{"Unsupported OpenGL version"};
+                }
+
+                assetBundle.setShader(shaderText, std::move(textShader));
+
+                // the fonts loaded as distance fields are drawn with antialiased edges and optional outlines
+                std::unique_ptr<graphics::Shader> distanceFieldShader;
+
+                switch (graphics.getDevice()->getAPIMajorVersion())
+                {
+#  if OUZEL_OPENGLES
+                    case 2:
+                        distanceFieldShader = std::make_unique<graphics::Shader>(graphics,
+                                                                                 std::vector<std::uint8_t>(std::begin(DistanceFieldPSGLES2_glsl),
+                                                                                                           std::end(DistanceFieldPSGLES2_glsl)),
+                                                                                 std::vector<std::uint8_t>(std::begin(TextureVSGLES2_glsl),
+                                                                                                           std::end(TextureVSGLES2_glsl)),
+                                                                                 std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                                     {graphics::Vertex::Attribute::Usage::position},
+                                                                                     {graphics::Vertex::Attribute::Usage::color},
+                                                                                     {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U}
+                                                                                 },
+                                                                                 std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                     {"color", graphics::DataType::float32Vector4},
+                                                                                     {"outlineColor", graphics::DataType::float32Vector4},
+                                                                                     {"outlineWidth", graphics::DataType::float32}
+                                                                                 },
+                                                                                 std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                     {"modelViewProj", graphics::DataType::float32Matrix4}
+                                                                                 });
+                        break;
+                    case 3:
+                        distanceFieldShader = std::make_unique<graphics::Shader>(graphics,
+                                                                                 std::vector<std::uint8_t>(std::begin(DistanceFieldPSGLES3_glsl),
+                                                                                                           std::end(DistanceFieldPSGLES3_glsl)),
+                                                                                 std::vector<std::uint8_t>(std::begin(TextureVSGLES3_glsl),
+                                                                                                           std::end(TextureVSGLES3_glsl)),
+                                                                                 std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                                     {graphics::Vertex::Attribute::Usage::position},
+                                                                                     {graphics::Vertex::Attribute::Usage::color},
+                                                                                     {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U}
+                                                                                 },
+                                                                                 std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                     {"color", graphics::DataType::float32Vector4},
+                                                                                     {"outlineColor", graphics::DataType::float32Vector4},
+                                                                                     {"outlineWidth", graphics::DataType::float32}
+                                                                                 },
+                                                                                 std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                     {"modelViewProj", graphics::DataType::float32Matrix4}
+                                                                                 });
+                        break;
+#  else
+                    case 2:
+                        distanceFieldShader = std::make_unique<graphics::Shader>(graphics,
+                                                                                 std::vector<std::uint8_t>(std::begin(DistanceFieldPSGL2_glsl),
+                                                                                                           std::end(DistanceFieldPSGL2_glsl)),
+                                                                                 std::vector<std::uint8_t>(std::begin(TextureVSGL2_glsl),
+                                                                                                           std::end(TextureVSGL2_glsl)),
+                                                                                 std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                                     {graphics::Vertex::Attribute::Usage::position},
+                                                                                     {graphics::Vertex::Attribute::Usage::color},
+                                                                                     {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U}
+                                                                                 },
+                                                                                 std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                     {"color", graphics::DataType::float32Vector4},
+                                                                                     {"outlineColor", graphics::DataType::float32Vector4},
+                                                                                     {"outlineWidth", graphics::DataType::float32}
+                                                                                 },
+                                                                                 std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                     {"modelViewProj", graphics::DataType::float32Matrix4}
+                                                                                 });
+                        break;
+                    case 3:
+                        distanceFieldShader = std::make_unique<graphics::Shader>(graphics,
+                                                                                 std::vector<std::uint8_t>(std::begin(DistanceFieldPSGL3_glsl),
+                                                                                                           std::end(DistanceFieldPSGL3_glsl)),
+                                                                                 std::vector<std::uint8_t>(std::begin(TextureVSGL3_glsl),
+                                                                                                           std::end(TextureVSGL3_glsl)),
+                                                                                 std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                                     {graphics::Vertex::Attribute::Usage::position},
+                                                                                     {graphics::Vertex::Attribute::Usage::color},
+                                                                                     {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U}
+                                                                                 },
+                                                                                 std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                     {"color", graphics::DataType::float32Vector4},
+                                                                                     {"outlineColor", graphics::DataType::float32Vector4},
+                                                                                     {"outlineWidth", graphics::DataType::float32}
+                                                                                 },
+                                                                                 std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                     {"modelViewProj", graphics::DataType::float32Matrix4}
+                                                                                 });
+                        break;
+                    case 4:
+                        distanceFieldShader = std::make_unique<graphics::Shader>(graphics,
+                                                                                 std::vector<std::uint8_t>(std::begin(DistanceFieldPSGL4_glsl),
+                                                                                                           std::end(DistanceFieldPSGL4_glsl)),
+                                                                                 std::vector<std::uint8_t>(std::begin(TextureVSGL4_glsl),
+                                                                                                           std::end(TextureVSGL4_glsl)),
+                                                                                 std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                                     {graphics::Vertex::Attribute::Usage::position},
+                                                                                     {graphics::Vertex::Attribute::Usage::color},
+                                                                                     {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U}
+                                                                                 },
+                                                                                 std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                     {"color", graphics::DataType::float32Vector4},
+                                                                                     {"outlineColor", graphics::DataType::float32Vector4},
+                                                                                     {"outlineWidth", graphics::DataType::float32}
+                                                                                 },
+                                                                                 std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                     {"modelViewProj", graphics::DataType::float32Matrix4}
+                                                                                 });
+                        break;
+#  endif
+                    default:
+                        throw std::runtime_error{"Unsupported OpenGL version"};
+                }
+
+                assetBundle.setShader(shaderDistanceField, std::move(distanceFieldShader));
+
                 std::unique_ptr<graphics::Shader> colorShader;
 
                 switch (graphics.getDevice()->getAPIMajorVersion())
@@ -581,8 +821,8 @@ namespace ouzel::core
     {
         if (active)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::engineStop;
+            SystemEvent event;
+            event.type = Event::Type::engineStop;
             eventDispatcher.postEvent(std::move(event));
         }
 
@@ -592,14 +832,17 @@ namespace ouzel::core
 #ifndef __EMSCRIPTEN__
         if (updateThread.isJoinable()) updateThread.join();
 #endif
+
+        // write the buffered messages before the application exits
+        if (settings.asyncLog) log.stopAsync();
     }
 
     void Engine::start()
     {
         if (!active)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::engineStart;
+            SystemEvent event;
+            event.type = Event::Type::engineStart;
             eventDispatcher.postEvent(std::move(event));
 
             active = true;
@@ -619,8 +862,8 @@ namespace ouzel::core
     {
         if (active && !paused)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::enginePause;
+            SystemEvent event;
+            event.type = Event::Type::enginePause;
             eventDispatcher.postEvent(std::move(event));
 
             paused = true;
@@ -631,8 +874,8 @@ namespace ouzel::core
     {
         if (active && paused)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::engineResume;
+            SystemEvent event;
+            event.type = Event::Type::engineResume;
             eventDispatcher.postEvent(std::move(event));
 
             paused = false;
@@ -645,8 +888,8 @@ namespace ouzel::core
 
         if (active)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::engineStop;
+            SystemEvent event;
+            event.type = Event::Type::engineStop;
             eventDispatcher.postEvent(std::move(event));
 
             active = false;
@@ -655,6 +898,8 @@ namespace ouzel::core
 
     void Engine::update()
     {
+        OUZEL_PROFILE_SCOPE("Engine::update");
+
         eventDispatcher.dispatchEvents();
 
         const auto currentTime = std::chrono::steady_clock::now();
@@ -668,18 +913,22 @@ namespace ouzel::core
             previousUpdateTime = currentTime;
             const auto delta = static_cast<float>(std::chrono::duration_cast<std::chrono::microseconds>(diff).count()) / 1000000.0F;
 
-            auto updateEvent = std::make_unique<UpdateEvent>();
-            updateEvent->type = Event::Type::update;
-            updateEvent->delta = delta;
-            eventDispatcher.dispatchEvent(std::move(updateEvent));
+            UpdateEvent updateEvent;
+            updateEvent.type = Event::Type::update;
+            updateEvent.delta = delta;
+            eventDispatcher.dispatchEvent(updateEvent);
+
+            updateScheduler.update(delta);
         }
 
         inputManager.update();
         handleEvents(window.getEvents(false));
         audio.update();
+        cache.update();
 
         if (refillRenderQueue)
         {
+            OUZEL_PROFILE_SCOPE("SceneManager::draw");
             sceneManager.draw();
             refillRenderQueue = false;
         }
@@ -694,6 +943,8 @@ namespace ouzel::core
 
     void Engine::engineMain()
     {
+        OUZEL_PROFILE_THREAD("Game");
+
         try
         {
             std::unique_ptr<Application> application = ouzel::main(args);
@@ -748,7 +999,7 @@ namespace ouzel::core
                     break;
             }
 
-            eventDispatcher.dispatchEvent(std::move(windowEvent));
+            eventDispatcher.dispatchEvent(*windowEvent);
         }
     }
 }
@@ -11,6 +11,7 @@
 #include <vector>
 #include "Application.hpp"
 #include "Timer.hpp"
+#include "UpdateScheduler.hpp"
 #include "Window.hpp"
 #include "WorkerPool.hpp"
 #include "../graphics/Graphics.hpp"
@@ -42,6 +43,8 @@ namespace ouzel::core
         bool highDpi = true; // should high DPI resolution be used
         audio::Driver audioDriver;
         audio::Settings audioSettings;
+        bool asyncLog = false; // should the log messages be written by a background thread
+        std::string binaryLog; // the file in the storage directory that the asynchronous log also writes the messages to
     };
 
     class Engine
@@ -86,6 +89,12 @@ namespace ouzel::core
         [[nodiscard]] auto& getNetwork() noexcept { return network; }
         [[nodiscard]] auto& getNetwork() const noexcept { return network; }
 
+        [[nodiscard]] auto& getWorkerPool() noexcept { return workerPool; }
+        [[nodiscard]] auto& getWorkerPool() const noexcept { return workerPool; }
+
+        [[nodiscard]] auto& getUpdateScheduler() noexcept { return updateScheduler; }
+        [[nodiscard]] auto& getUpdateScheduler() const noexcept { return updateScheduler; }
+
         void start();
         void pause();
         void resume();
@@ -138,6 +147,7 @@ namespace ouzel::core
         scene::SceneManager sceneManager;
         network::Network network;
         WorkerPool workerPool;
+        UpdateScheduler updateScheduler{workerPool};
 
     private:
         void handleEvents(std::queue<std::unique_ptr<Event>> windowEvents);
@@ -160,6 +170,8 @@ namespace ouzel::core
 namespace ouzel
 {
     const std::string shaderTexture = "shaderTexture";
+    const std::string shaderText = "shaderText";
+    const std::string shaderDistanceField = "shaderDistanceField";
     const std::string shaderColor = "shaderColor";
 
     const std::string blendNoBlend = "blendNoBlend";
@@ -0,0 +1,194 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <cmath>
+#include "UpdateScheduler.hpp"
+#include "../utils/Profiler.hpp"
+
+namespace ouzel::core
+{
+    Updater::~Updater()
+    {
+        if (scheduler) scheduler->removeUpdater(*this);
+    }
+
+    void Updater::remove()
+    {
+        if (scheduler) scheduler->removeUpdater(*this);
+    }
+
+    void Updater::setThreadSafe(bool newThreadSafe)
+    {
+        if (threadSafe == newThreadSafe) return;
+
+        if (const auto currentScheduler = scheduler)
+        {
+            // move the updater to the other list of its phase
+            currentScheduler->removeUpdater(*this);
+            threadSafe = newThreadSafe;
+            currentScheduler->addUpdater(*this);
+        }
+        else
+            threadSafe = newThreadSafe;
+    }
+
+    UpdateScheduler::~UpdateScheduler()
+    {
+        for (const auto updater : addedUpdaters)
+            updater->scheduler = nullptr;
+
+        for (auto& phase : phases)
+        {
+            for (const auto updater : phase.serialUpdaters)
+                if (updater)
+                {
+                    updater->scheduler = nullptr;
+                    updater->position = Updater::npos;
+                }
+
+            for (const auto updater : phase.parallelUpdaters)
+                if (updater)
+                {
+                    updater->scheduler = nullptr;
+                    updater->position = Updater::npos;
+                }
+        }
+    }
+
+    void UpdateScheduler::addUpdater(Updater& updater)
+    {
+        if (updater.scheduler == this) return;
+
+        if (updater.scheduler)
+            updater.scheduler->removeUpdater(updater);
+
+        updater.scheduler = this;
+        addedUpdaters.push_back(&updater);
+    }
+
+    void UpdateScheduler::removeUpdater(Updater& updater)
+    {
+        if (updater.scheduler != this) return;
+
+        updater.scheduler = nullptr;
+
+        if (updater.position != Updater::npos)
+        {
+            auto& phase = phases[static_cast<std::size_t>(updater.phase)];
+            auto& updaters = updater.threadSafe ? phase.parallelUpdaters : phase.serialUpdaters;
+            updaters[updater.position] = nullptr;
+            phase.dirty = true;
+            updater.position = Updater::npos;
+        }
+        else if (const auto i = std::find(addedUpdaters.begin(),
+                                          addedUpdaters.end(),
+                                          &updater); i != addedUpdaters.end())
+            addedUpdaters.erase(i);
+    }
+
+    void UpdateScheduler::updateUpdaters()
+    {
+        for (auto& phase : phases)
+            if (phase.dirty)
+            {
+                phase.serialUpdaters.erase(std::remove(phase.serialUpdaters.begin(),
+                                                       phase.serialUpdaters.end(),
+                                                       nullptr),
+                                           phase.serialUpdaters.end());
+
+                for (std::size_t i = 0; i < phase.serialUpdaters.size(); ++i)
+                    phase.serialUpdaters[i]->position = i;
+
+                phase.parallelUpdaters.erase(std::remove(phase.parallelUpdaters.begin(),
+                                                         phase.parallelUpdaters.end(),
+                                                         nullptr),
+                                             phase.parallelUpdaters.end());
+
+                for (std::size_t i = 0; i < phase.parallelUpdaters.size(); ++i)
+                    phase.parallelUpdaters[i]->position = i;
+
+                phase.dirty = false;
+            }
+
+        for (const auto updater : addedUpdaters)
+        {
+            auto& phase = phases[static_cast<std::size_t>(updater->phase)];
+            auto& updaters = updater->threadSafe ? phase.parallelUpdaters : phase.serialUpdaters;
+            updater->position = updaters.size();
+            updaters.push_back(updater);
+        }
+
+        addedUpdaters.clear();
+    }
+
+    void UpdateScheduler::update(float delta)
+    {
+        OUZEL_PROFILE_SCOPE("UpdateScheduler::update");
+
+        runPhase(UpdatePhase::input, delta);
+
+        if (fixedTimeStep > 0.0F)
+        {
+            accumulator += delta;
+
+            std::uint32_t steps = 0;
+            for (; accumulator >= fixedTimeStep && steps < maxFixedSteps; ++steps)
+            {
+                runPhase(UpdatePhase::fixed, fixedTimeStep);
+                accumulator -= fixedTimeStep;
+            }
+
+            // drop the time that could not be simulated instead of falling further behind every frame
+            if (steps == maxFixedSteps && accumulator >= fixedTimeStep)
+                accumulator = std::fmod(accumulator, fixedTimeStep);
+        }
+        else
+            runPhase(UpdatePhase::fixed, delta);
+
+        runPhase(UpdatePhase::animation, delta);
+        runPhase(UpdatePhase::late, delta);
+        runPhase(UpdatePhase::preRender, delta);
+    }
+
+    void UpdateScheduler::runPhase(UpdatePhase phaseType, float delta)
+    {
+        updateUpdaters();
+
+        auto& phase = phases[static_cast<std::size_t>(phaseType)];
+
+        // updaters can be removed while updating, so the lists are accessed by index
+        for (std::size_t i = 0; i < phase.serialUpdaters.size(); ++i)
+            if (const auto updater = phase.serialUpdaters[i]; updater && updater->function)
+                updater->function(delta);
+
+        if (!phase.parallelUpdaters.empty())
+        {
+            runningParallel = true;
+
+            workerPool.parallelFor(0, phase.parallelUpdaters.size(), 1,
+                                   [&updaters = phase.parallelUpdaters, delta](std::size_t first, std::size_t last) {
+                                       for (auto i = first; i < last; ++i)
+                                           if (const auto updater = updaters[i]; updater && updater->function)
+                                               updater->function(delta);
+                                   });
+
+            runningParallel = false;
+
+            for (const auto& function : deferredFunctions)
+                function();
+
+            deferredFunctions.clear();
+        }
+    }
+
+    void UpdateScheduler::runSerially(const std::function<void()>& function)
+    {
+        if (runningParallel)
+        {
+            std::scoped_lock lock{deferredMutex};
+            deferredFunctions.push_back(function);
+        }
+        else
+            function();
+    }
+}
@@ -0,0 +1,134 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_CORE_UPDATESCHEDULER_HPP
+#define OUZEL_CORE_UPDATESCHEDULER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <vector>
+#include "WorkerPool.hpp"
+
+namespace ouzel::core
+{
+    class UpdateScheduler;
+
+    // phases of a frame in the order they are run
+    enum class UpdatePhase
+    {
+        input,
+        fixed, // runs with the fixed time step if it is set, zero or more times per frame
+        animation,
+        late,
+        preRender
+    };
+
+    class Updater final
+    {
+        friend UpdateScheduler;
+    public:
+        explicit Updater(UpdatePhase initPhase = UpdatePhase::animation,
+                         bool initThreadSafe = false) noexcept:
+            phase{initPhase}, threadSafe{initThreadSafe}
+        {
+        }
+
+        ~Updater();
+
+        Updater(const Updater&) = delete;
+        Updater& operator=(const Updater&) = delete;
+        Updater(Updater&&) = delete;
+        Updater& operator=(Updater&&) = delete;
+
+        void remove();
+
+        [[nodiscard]] auto getPhase() const noexcept { return phase; }
+
+        // thread-safe updaters of a phase run in parallel on the worker pool, so they must not touch
+        // the state of other updaters and must defer everything else to UpdateScheduler::runSerially
+        [[nodiscard]] auto isThreadSafe() const noexcept { return threadSafe; }
+        void setThreadSafe(bool newThreadSafe);
+
+        std::function<void(float delta)> function;
+
+    private:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        UpdatePhase phase;
+        bool threadSafe;
+        UpdateScheduler* scheduler = nullptr;
+        std::size_t position = npos;
+    };
+
+    class UpdateScheduler final
+    {
+    public:
+        static constexpr std::size_t phaseCount = 5;
+
+        explicit UpdateScheduler(WorkerPool& initWorkerPool) noexcept:
+            workerPool{initWorkerPool}
+        {
+        }
+
+        ~UpdateScheduler();
+
+        UpdateScheduler(const UpdateScheduler&) = delete;
+        UpdateScheduler& operator=(const UpdateScheduler&) = delete;
+        UpdateScheduler(UpdateScheduler&&) = delete;
+        UpdateScheduler& operator=(UpdateScheduler&&) = delete;
+
+        // updaters added during an update start running in the next phase
+        void addUpdater(Updater& updater);
+        void removeUpdater(Updater& updater);
+
+        // runs all the phases, the serial updaters of a phase run in the order they were added
+        // and the thread-safe ones after them in parallel
+        void update(float delta);
+
+        // zero runs the fixed phase once per frame with the frame delta
+        [[nodiscard]] auto getFixedTimeStep() const noexcept { return fixedTimeStep; }
+        void setFixedTimeStep(float newFixedTimeStep, std::uint32_t newMaxFixedSteps = 5) noexcept
+        {
+            fixedTimeStep = newFixedTimeStep;
+            maxFixedSteps = newMaxFixedSteps;
+            accumulator = 0.0F;
+        }
+
+        // the part of the fixed time step that has not been simulated yet, for interpolating the rendered state
+        [[nodiscard]] float getFixedStepAlpha() const noexcept
+        {
+            return (fixedTimeStep > 0.0F) ? accumulator / fixedTimeStep : 0.0F;
+        }
+
+        // runs the function immediately on the update thread or after the running parallel updaters finish
+        void runSerially(const std::function<void()>& function);
+
+    private:
+        struct Phase final
+        {
+            std::vector<Updater*> serialUpdaters;
+            std::vector<Updater*> parallelUpdaters; // removed updaters are set to null in both lists
+            bool dirty = false;
+        };
+
+        void updateUpdaters();
+        void runPhase(UpdatePhase phase, float delta);
+
+        WorkerPool& workerPool;
+        std::array<Phase, phaseCount> phases;
+        std::vector<Updater*> addedUpdaters;
+
+        float fixedTimeStep = 0.0F;
+        std::uint32_t maxFixedSteps = 5;
+        float accumulator = 0.0F;
+
+        bool runningParallel = false;
+        std::mutex deferredMutex;
+        std::vector<std::function<void()>> deferredFunctions;
+    };
+}
+
+#endif // OUZEL_CORE_UPDATESCHEDULER_HPP
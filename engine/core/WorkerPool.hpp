@@ -3,160 +3,578 @@
 #ifndef OUZEL_CORE_WORKERPOOL_HPP
 #define OUZEL_CORE_WORKERPOOL_HPP
 
+#include <atomic>
 #include <condition_variable>
-#include <functional>
+#include <cstddef>
+#include <exception>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include "../thread/Thread.hpp"
 #include "../utils/Log.hpp"
+#include "../utils/Profiler.hpp"
 
 namespace ouzel::core
 {
+    class WorkerPool;
+
+    // Type-erased callable that stores small function objects inline instead of allocating them
+    class Task final
+    {
+    public:
+        static constexpr std::size_t bufferSize = 6 * sizeof(void*);
+
+        Task() noexcept = default;
+
+        template <class F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+        Task(F&& function)
+        {
+            using Callable = std::decay_t<F>;
+
+            if constexpr (sizeof(Callable) <= bufferSize &&
+                          alignof(Callable) <= alignof(std::max_align_t) &&
+                          std::is_nothrow_move_constructible_v<Callable>)
+            {
+                new(&storage) Callable(std::forward<F>(function));
+                operations = &InlineOperations<Callable>::operations;
+            }
+            else
+            {
+                new(&storage) Callable*(new Callable(std::forward<F>(function)));
+                operations = &HeapOperations<Callable>::operations;
+            }
+        }
+
+        ~Task()
+        {
+            if (operations) operations->destroy(&storage);
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        Task(Task&& other) noexcept:
+            operations{other.operations}
+        {
+            if (operations) operations->move(&storage, &other.storage);
+            other.operations = nullptr;
+        }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            if (operations) operations->destroy(&storage);
+            operations = other.operations;
+            if (operations) operations->move(&storage, &other.storage);
+            other.operations = nullptr;
+
+            return *this;
+        }
+
+        explicit operator bool() const noexcept { return operations != nullptr; }
+
+        void operator()()
+        {
+            operations->invoke(&storage);
+        }
+
+    private:
+        struct Operations final
+        {
+            void (*invoke)(void* storage);
+            void (*move)(void* destination, void* source) noexcept; // also destroys the source
+            void (*destroy)(void* storage) noexcept;
+        };
+
+        template <class Callable>
+        struct InlineOperations final
+        {
+            static void invoke(void* storage)
+            {
+                (*std::launder(static_cast<Callable*>(storage)))();
+            }
+
+            static void move(void* destination, void* source) noexcept
+            {
+                const auto callable = std::launder(static_cast<Callable*>(source));
+                new(destination) Callable(std::move(*callable));
+                callable->~Callable();
+            }
+
+            static void destroy(void* storage) noexcept
+            {
+                std::launder(static_cast<Callable*>(storage))->~Callable();
+            }
+
+            static constexpr Operations operations{&invoke, &move, &destroy};
+        };
+
+        template <class Callable>
+        struct HeapOperations final
+        {
+            static void invoke(void* storage)
+            {
+                (**std::launder(static_cast<Callable**>(storage)))();
+            }
+
+            static void move(void* destination, void* source) noexcept
+            {
+                new(destination) Callable*(*std::launder(static_cast<Callable**>(source)));
+            }
+
+            static void destroy(void* storage) noexcept
+            {
+                delete *std::launder(static_cast<Callable**>(storage));
+            }
+
+            static constexpr Operations operations{&invoke, &move, &destroy};
+        };
+
+        const Operations* operations = nullptr;
+        alignas(std::max_align_t) std::byte storage[bufferSize];
+    };
+
     class TaskGroup final
     {
-        friend class WorkerPool;
+        friend WorkerPool;
     public:
         TaskGroup() = default;
 
-        void add(std::function<void()> task)
+        template <class F>
+        void add(F&& task)
         {
-            taskQueue.push(std::move(task));
+            tasks.emplace_back(std::forward<F>(task));
         }
 
-        std::size_t getTaskCount() const noexcept { return taskQueue.size(); }
+        void reserve(std::size_t count)
+        {
+            tasks.reserve(count);
+        }
+
+        std::size_t getTaskCount() const noexcept { return tasks.size(); }
 
     private:
-        std::queue<std::function<void()>> taskQueue;
+        std::vector<Task> tasks;
     };
 
+    // Completion handle of a task group. The pending task count is a lock-free counter, the mutex
+    // is only used when the waiting thread runs out of tasks to help with and has to sleep.
     class Future final
     {
-        friend class Promise;
+        friend WorkerPool;
     public:
-        void wait()
+        Future() noexcept = default;
+
+        ~Future()
+        {
+            if (state) release(state);
+        }
+
+        Future(const Future& other) noexcept:
+            state{other.state}
         {
-            std::unique_lock lock{sharedState->mutex};
-            sharedState->condition.wait(lock, [this]() noexcept { return sharedState->count == 0; });
+            if (state) state->referenceCount.fetch_add(1, std::memory_order_relaxed);
         }
 
+        Future& operator=(const Future& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            if (other.state) other.state->referenceCount.fetch_add(1, std::memory_order_relaxed);
+            if (state) release(state);
+            state = other.state;
+
+            return *this;
+        }
+
+        Future(Future&& other) noexcept:
+            state{other.state}
+        {
+            other.state = nullptr;
+        }
+
+        Future& operator=(Future&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            if (state) release(state);
+            state = other.state;
+            other.state = nullptr;
+
+            return *this;
+        }
+
+        [[nodiscard]] bool isReady() const noexcept
+        {
+            return !state || state->count.load(std::memory_order_acquire) == 0;
+        }
+
+        // Executes pending tasks of the pool on the calling thread until all the tasks of the group are done,
+        // rethrows the first exception thrown by a task of the group
+        void wait();
+
     private:
         struct State final
         {
-        public:
-            State(std::size_t c): count{c}
+            State(WorkerPool& initPool, std::size_t initCount, std::size_t initReferenceCount) noexcept:
+                pool{initPool}, count{initCount}, referenceCount{initReferenceCount}
             {
             }
 
-            std::size_t count = 0;
+            WorkerPool& pool;
+            std::atomic<std::size_t> count;
+            std::atomic<std::size_t> referenceCount;
+            std::atomic<bool> waiting{false};
             std::mutex mutex;
             std::condition_variable condition;
+            std::exception_ptr exception; // guarded by the mutex until the count reaches zero
         };
 
-        Future(std::shared_ptr<State> state) noexcept:
-            sharedState{state}
+        explicit Future(State* initState) noexcept:
+            state{initState}
         {
         }
 
-        std::shared_ptr<State> sharedState;
+        static void release(State* state) noexcept
+        {
+            if (state->referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete state;
+        }
+
+        State* state = nullptr;
     };
 
-    class Promise final
+    // Work-stealing scheduler, every worker owns a task queue, executes tasks from its back
+    // and steals from the front of the other queues when its own queue is empty
+    class WorkerPool final
     {
+        friend Future;
     public:
-        Promise(const TaskGroup& taskGroup) noexcept:
-            sharedState{std::make_shared<Future::State>(taskGroup.getTaskCount())}
+        WorkerPool():
+            queues(getWorkerCount())
         {
+            workers.reserve(queues.size());
+            for (std::size_t i = 0; i < queues.size(); ++i)
+                workers.emplace_back(&WorkerPool::work, this, i);
         }
 
-        Future getFuture() const
+        ~WorkerPool()
         {
-            return Future{sharedState};
+            std::unique_lock lock{sleepMutex};
+            running = false;
+            lock.unlock();
+            sleepCondition.notify_all();
+
+            for (auto& worker : workers)
+                worker.join();
         }
 
-        void decrement()
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+        WorkerPool(WorkerPool&&) = delete;
+        WorkerPool& operator=(WorkerPool&&) = delete;
+
+        std::size_t getThreadCount() const noexcept { return workers.size(); }
+
+        Future run(TaskGroup&& taskGroup)
         {
-            std::unique_lock lock{sharedState->mutex};
+            const auto taskCount = taskGroup.tasks.size();
+            if (taskCount == 0) return Future{};
+
+            // one reference is held by the returned future and one by the tasks until the last one finishes
+            const auto state = new Future::State{*this, taskCount, 2};
+
+            // the pending task count is increased under the lock of the queue after the jobs are pushed,
+            // so that it never gets decremented for a job before it was counted
+            if (currentWorker.pool == this)
+            {
+                // tasks spawned by a worker go to its own queue to be executed while the data is hot
+                auto& queue = queues[currentWorker.index];
+                std::scoped_lock lock{queue.mutex};
+                for (auto& task : taskGroup.tasks)
+                    queue.pushBack(Job{std::move(task), state});
+                pendingTaskCount.fetch_add(taskCount, std::memory_order_seq_cst);
+            }
+            else
+            {
+                // spread the tasks from other threads evenly across the queues
+                const auto queueCount = queues.size();
+                const auto tasksPerQueue = (taskCount + queueCount - 1) / queueCount;
+                auto queueIndex = nextQueue.fetch_add(1, std::memory_order_relaxed);
+
+                for (std::size_t first = 0; first < taskCount; first += tasksPerQueue, ++queueIndex)
+                {
+                    auto& queue = queues[queueIndex % queueCount];
+                    const auto last = (first + tasksPerQueue < taskCount) ? first + tasksPerQueue : taskCount;
+
+                    std::scoped_lock lock{queue.mutex};
+                    for (auto i = first; i < last; ++i)
+                        queue.pushBack(Job{std::move(taskGroup.tasks[i]), state});
+                    pendingTaskCount.fetch_add(last - first, std::memory_order_seq_cst);
+                }
+            }
+
+            taskGroup.tasks.clear();
 
-            if (sharedState->count == 0 || --sharedState->count == 0)
+            if (sleepingWorkerCount.load(std::memory_order_seq_cst) > 0)
             {
+                std::unique_lock lock{sleepMutex};
                 lock.unlock();
-                sharedState->condition.notify_all();
+                if (taskCount == 1)
+                    sleepCondition.notify_one();
+                else
+                    sleepCondition.notify_all();
             }
+
+            return Future{state};
         }
 
-    private:
-        std::shared_ptr<Future::State> sharedState;
-    };
+        // Calls function(first, last) for consecutive subranges of [begin, end) of at most grain
+        // elements in parallel and returns when all of them have finished, the first exception
+        // thrown by the function is rethrown after all the subranges are done
+        template <class F>
+        void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, const F& function)
+        {
+            if (grain == 0) grain = 1;
 
-    class WorkerPool final
-    {
-    public:
-        WorkerPool()
+            if (end - begin <= grain)
+            {
+                if (begin != end) function(begin, end);
+                return;
+            }
+
+            TaskGroup taskGroup;
+            taskGroup.reserve((end - begin) / grain);
+
+            std::size_t first = begin;
+            for (; end - first > grain; first += grain)
+                taskGroup.add([&function, first, last = first + grain]() { function(first, last); });
+
+            auto future = run(std::move(taskGroup));
+
+            // the tasks reference the function, so they have to finish even if the last subrange throws
+            try
+            {
+                function(first, end); // the calling thread processes the last subrange
+            }
+            catch (...)
+            {
+                try
+                {
+                    future.wait();
+                }
+                catch (...)
+                {
+                }
+                throw;
+            }
+
+            future.wait();
+        }
+
+        // Executes one pending task on the calling thread, returns false if there were no tasks
+        bool runPendingTask()
         {
-            const std::size_t cpuCount = std::thread::hardware_concurrency();
-            const std::size_t count = (cpuCount > 1) ? cpuCount - 1 : 1;
+            const auto start = (currentWorker.pool == this) ? currentWorker.index : nextQueue.load(std::memory_order_relaxed);
+
+            Job job;
+            if (!popTask(start % queues.size(), job)) return false;
 
-            for (std::size_t i = 0; i < count; ++i)
-                workers.emplace_back(&WorkerPool::work, this);
+            execute(job);
+            return true;
         }
 
-        ~WorkerPool()
+    private:
+        struct Job final
         {
-            running = false;
-            taskQueueCondition.notify_all();
+            Task task;
+            Future::State* state = nullptr;
+        };
+
+        // growable ring buffer of jobs
+        class Queue final
+        {
+        public:
+            void pushBack(Job&& job)
+            {
+                if (size == jobs.size())
+                {
+                    std::vector<Job> newJobs(jobs.empty() ? 64 : jobs.size() * 2);
+                    for (std::size_t i = 0; i < size; ++i)
+                        newJobs[i] = std::move(jobs[(head + i) & (jobs.size() - 1)]);
+                    jobs = std::move(newJobs);
+                    head = 0;
+                }
+
+                jobs[(head + size) & (jobs.size() - 1)] = std::move(job);
+                ++size;
+            }
+
+            bool popBack(Job& job) noexcept
+            {
+                if (size == 0) return false;
+                --size;
+                job = std::move(jobs[(head + size) & (jobs.size() - 1)]);
+                return true;
+            }
+
+            bool popFront(Job& job) noexcept
+            {
+                if (size == 0) return false;
+                job = std::move(jobs[head]);
+                head = (head + 1) & (jobs.size() - 1);
+                --size;
+                return true;
+            }
+
+            std::mutex mutex;
+
+        private:
+            std::vector<Job> jobs; // size is always a power of two
+            std::size_t head = 0;
+            std::size_t size = 0;
+        };
+
+        struct CurrentWorker final
+        {
+            WorkerPool* pool = nullptr;
+            std::size_t index = 0;
+        };
+
+        static std::size_t getWorkerCount() noexcept
+        {
+            const std::size_t cpuCount = std::thread::hardware_concurrency();
+            return (cpuCount > 1) ? cpuCount - 1 : 1;
         }
 
-        Future run(TaskGroup&& taskGroup)
+        bool popTask(std::size_t ownQueue, Job& job)
         {
-            Promise promise{taskGroup};
-            Future future = promise.getFuture();
+            if (pendingTaskCount.load(std::memory_order_relaxed) == 0) return false;
 
-            std::unique_lock lock{taskQueueMutex};
+            // take the most recently added task of the own queue first
+            {
+                auto& queue = queues[ownQueue];
+                std::scoped_lock lock{queue.mutex};
+                if (queue.popBack(job))
+                {
+                    pendingTaskCount.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
 
-            while (!taskGroup.taskQueue.empty())
+            // steal the oldest task from other queues
+            for (std::size_t i = 1; i < queues.size(); ++i)
             {
-                taskQueue.push(std::pair(std::move(promise),
-                                         std::move(taskGroup.taskQueue.front())));
-                taskGroup.taskQueue.pop();
+                auto& queue = queues[(ownQueue + i) % queues.size()];
+                std::scoped_lock lock{queue.mutex};
+                if (queue.popFront(job))
+                {
+                    pendingTaskCount.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
             }
 
-            lock.unlock();
+            return false;
+        }
 
-            taskQueueCondition.notify_all();
+        static void execute(Job& job) noexcept
+        {
+            const auto state = job.state;
+
+            try
+            {
+                job.task();
+            }
+            catch (...)
+            {
+                // only the first exception of the group is kept
+                std::scoped_lock lock{state->mutex};
+                if (!state->exception) state->exception = std::current_exception();
+            }
 
-            return future;
+            job.task = Task{};
+
+            if (state->count.fetch_sub(1, std::memory_order_seq_cst) == 1)
+            {
+                if (state->waiting.load(std::memory_order_seq_cst))
+                {
+                    std::unique_lock lock{state->mutex};
+                    lock.unlock();
+                    state->condition.notify_all();
+                }
+
+                Future::release(state);
+            }
         }
 
-    private:
-        void work()
+        void work(std::size_t index)
         {
             log(Log::Level::info) << "Worker started";
+            OUZEL_PROFILE_THREAD("Worker");
+
+            currentWorker = CurrentWorker{this, index};
 
+            Job job;
             for (;;)
             {
-                std::unique_lock lock{taskQueueMutex};
-                taskQueueCondition.wait(lock, [this]() noexcept { return !running || !taskQueue.empty(); });
+                if (popTask(index, job))
+                {
+                    execute(job);
+                    continue;
+                }
+
+                std::unique_lock lock{sleepMutex};
+                sleepingWorkerCount.fetch_add(1, std::memory_order_seq_cst);
+                sleepCondition.wait(lock, [this]() noexcept {
+                    return !running || pendingTaskCount.load(std::memory_order_seq_cst) > 0;
+                });
+                sleepingWorkerCount.fetch_sub(1, std::memory_order_seq_cst);
                 if (!running) break;
-                auto task = std::move(taskQueue.front());
-                taskQueue.pop();
-                lock.unlock();
-
-                task.second();
-
-                task.first.decrement();
             }
 
             log(Log::Level::info) << "Worker finished";
         }
 
+        static thread_local CurrentWorker currentWorker;
+
+        std::vector<Queue> queues;
         std::vector<thread::Thread> workers;
+        std::atomic<std::size_t> nextQueue{0};
+        std::atomic<std::size_t> pendingTaskCount{0};
+        std::atomic<std::size_t> sleepingWorkerCount{0};
         bool running = true;
-        std::queue<std::pair<Promise, std::function<void()>>> taskQueue;
-        std::mutex taskQueueMutex;
-        std::condition_variable taskQueueCondition;
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
     };
+
+    inline thread_local WorkerPool::CurrentWorker WorkerPool::currentWorker;
+
+    inline void Future::wait()
+    {
+        if (!state) return;
+
+        while (state->count.load(std::memory_order_acquire) != 0)
+        {
+            // help with the work instead of blocking
+            if (state->pool.runPendingTask()) continue;
+
+            // the remaining tasks are running on other threads
+            std::unique_lock lock{state->mutex};
+            state->waiting.store(true, std::memory_order_seq_cst);
+            state->condition.wait(lock, [this]() noexcept {
+                return state->count.load(std::memory_order_seq_cst) == 0;
+            });
+        }
+
+        // all the tasks are done, no other thread can write the exception anymore
+        if (state->exception)
+            std::rethrow_exception(state->exception);
+    }
 }
 
 #endif // OUZEL_CORE_WORKERPOOL_HPP
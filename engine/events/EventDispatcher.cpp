@@ -3,209 +3,247 @@
 #include <algorithm>
 #include "EventDispatcher.hpp"
 #include "EventHandler.hpp"
-#include "../utils/Utils.hpp"
+#include "../utils/Profiler.hpp"
 
 namespace ouzel
 {
     EventDispatcher::~EventDispatcher()
     {
-        for (auto eventHandler : eventHandlerAddSet)
+        for (const auto eventHandler : addedEventHandlers)
             eventHandler->eventDispatcher = nullptr;
 
-        for (auto eventHandler : eventHandlers)
-            if (std::find(eventHandlerDeleteSet.begin(),
-                          eventHandlerDeleteSet.end(),
-                          eventHandler) == eventHandlerDeleteSet.end())
-                eventHandler->eventDispatcher = nullptr;
+        for (auto& categoryHandlers : eventHandlers)
+            for (const auto eventHandler : categoryHandlers)
+                if (eventHandler)
+                {
+                    eventHandler->eventDispatcher = nullptr;
+                    eventHandler->positions.fill(EventHandler::npos);
+                }
     }
 
-    void EventDispatcher::dispatchEvents()
+    bool EventDispatcher::hasHandler(const EventHandler& eventHandler, Category category) noexcept
     {
-        for (const auto eventHandler : eventHandlerDeleteSet)
-            if (const auto i = std::find(eventHandlers.begin(),
-                                         eventHandlers.end(),
-                                         eventHandler); i != eventHandlers.end())
-                eventHandlers.erase(i);
-
-        eventHandlerDeleteSet.clear();
-
-        for (const auto eventHandler : eventHandlerAddSet)
-            if (std::find(eventHandlers.begin(),
-                          eventHandlers.end(),
-                          eventHandler) == eventHandlers.end())
+        switch (category)
+        {
+            case Category::keyboard: return static_cast<bool>(eventHandler.keyboardHandler);
+            case Category::mouse: return static_cast<bool>(eventHandler.mouseHandler);
+            case Category::touch: return static_cast<bool>(eventHandler.touchHandler);
+            case Category::gamepad: return static_cast<bool>(eventHandler.gamepadHandler);
+            case Category::window: return static_cast<bool>(eventHandler.windowHandler);
+            case Category::system: return static_cast<bool>(eventHandler.systemHandler);
+            case Category::ui: return static_cast<bool>(eventHandler.uiHandler);
+            case Category::animation: return static_cast<bool>(eventHandler.animationHandler);
+            case Category::sound: return static_cast<bool>(eventHandler.soundHandler);
+            case Category::update: return static_cast<bool>(eventHandler.updateHandler);
+            case Category::user: return static_cast<bool>(eventHandler.userHandler);
+            default: return false;
+        }
+    }
+
+    void EventDispatcher::updateEventHandlers()
+    {
+        std::array<bool, categoryCount> changed = dirty;
+
+        for (std::size_t category = 0; category < categoryCount; ++category)
+            if (dirty[category])
             {
-                const auto upperBound = std::upper_bound(eventHandlers.begin(), eventHandlers.end(), eventHandler,
-                                                         [](const auto a, const auto b) noexcept {
-                                                                return a->priority > b->priority;
-                                                            });
+                auto& categoryHandlers = eventHandlers[category];
+                categoryHandlers.erase(std::remove(categoryHandlers.begin(),
+                                                   categoryHandlers.end(),
+                                                   nullptr),
+                                       categoryHandlers.end());
+                dirty[category] = false;
+            }
 
-                eventHandlers.insert(upperBound, eventHandler);
+        if (!addedEventHandlers.empty())
+        {
+            const auto comparePriorities = [](const auto a, const auto b) noexcept {
+                return a->priority > b->priority;
+            };
+
+            for (std::size_t category = 0; category < categoryCount; ++category)
+            {
+                auto& categoryHandlers = eventHandlers[category];
+                const auto oldSize = categoryHandlers.size();
+
+                // handlers that got a new function after they were added are already listed under their other categories
+                for (const auto eventHandler : addedEventHandlers)
+                    if (eventHandler->positions[category] == EventHandler::npos &&
+                        hasHandler(*eventHandler, static_cast<Category>(category)))
+                        categoryHandlers.push_back(eventHandler);
+
+                if (categoryHandlers.size() != oldSize)
+                {
+                    // new handlers go after the existing ones with the same priority
+                    const auto middle = categoryHandlers.begin() + static_cast<std::ptrdiff_t>(oldSize);
+                    std::stable_sort(middle, categoryHandlers.end(), comparePriorities);
+                    std::inplace_merge(categoryHandlers.begin(), middle, categoryHandlers.end(), comparePriorities);
+                    changed[category] = true;
+                }
+            }
+
+            addedEventHandlers.clear();
+        }
+
+        for (std::size_t category = 0; category < categoryCount; ++category)
+            if (changed[category])
+            {
+                const auto& categoryHandlers = eventHandlers[category];
+                for (std::size_t i = 0; i < categoryHandlers.size(); ++i)
+                    categoryHandlers[i]->positions[category] = i;
             }
+    }
 
-        eventHandlerAddSet.clear();
+    void EventDispatcher::dispatchEvents()
+    {
+        OUZEL_PROFILE_SCOPE("EventDispatcher::dispatchEvents");
 
-        std::pair<std::promise<bool>, std::unique_ptr<Event>> event;
+        updateEventHandlers();
 
         for (;;)
         {
             std::unique_lock lock{eventQueueMutex};
             if (eventQueue.empty()) break;
-
-            event = std::move(eventQueue.front());
-            eventQueue.pop();
+            std::swap(eventQueue, dispatchedEvents);
             lock.unlock();
 
-            event.first.set_value(dispatchEvent(std::move(event.second)));
+            for (const auto& event : dispatchedEvents)
+                std::visit([this](const auto& e) { dispatchEvent(e); }, event);
+
+            dispatchedEvents.clear();
         }
     }
 
-    bool EventDispatcher::dispatchEvent(std::unique_ptr<Event> event)
+    template <class T, class Handler>
+    bool EventDispatcher::dispatch(Category category, const T& event, Handler EventHandler::* handler) const
     {
-        if (!event) return false;
+        const auto& categoryHandlers = eventHandlers[static_cast<std::size_t>(category)];
 
-        for (const auto eventHandler : eventHandlers)
-            if (std::find(eventHandlerDeleteSet.begin(),
-                          eventHandlerDeleteSet.end(),
-                          eventHandler) == eventHandlerDeleteSet.end())
-                switch (event->type)
-                {
-                    case Event::Type::keyboardConnect:
-                    case Event::Type::keyboardDisconnect:
-                    case Event::Type::keyboardKeyPress:
-                    case Event::Type::keyboardKeyRelease:
-                        if (eventHandler->keyboardHandler &&
-                            eventHandler->keyboardHandler(*static_cast<KeyboardEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::mouseConnect:
-                    case Event::Type::mouseDisconnect:
-                    case Event::Type::mousePress:
-                    case Event::Type::mouseRelease:
-                    case Event::Type::mouseScroll:
-                    case Event::Type::mouseMove:
-                    case Event::Type::mouseCursorLockChange:
-                        if (eventHandler->mouseHandler &&
-                            eventHandler->mouseHandler(*static_cast<MouseEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::touchpadConnect:
-                    case Event::Type::touchpadDisconnect:
-                    case Event::Type::touchBegin:
-                    case Event::Type::touchMove:
-                    case Event::Type::touchEnd:
-                    case Event::Type::touchCancel:
-                        if (eventHandler->touchHandler &&
-                            eventHandler->touchHandler(*static_cast<TouchEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::gamepadConnect:
-                    case Event::Type::gamepadDisconnect:
-                    case Event::Type::gamepadButtonChange:
-                        if (eventHandler->gamepadHandler &&
-                            eventHandler->gamepadHandler(*static_cast<GamepadEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::windowSizeChange:
-                    case Event::Type::fullscreenChange:
-                    case Event::Type::screenChange:
-                    case Event::Type::resolutionChange:
-                        if (eventHandler->windowHandler &&
-                            eventHandler->windowHandler(*static_cast<WindowEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::engineStart:
-                    case Event::Type::engineStop:
-                    case Event::Type::engineResume:
-                    case Event::Type::enginePause:
-                    case Event::Type::orientationChange:
-                    case Event::Type::lowMemory:
-                    case Event::Type::openFile:
-                        if (eventHandler->systemHandler &&
-                            eventHandler->systemHandler(*static_cast<SystemEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::actorEnter:
-                    case Event::Type::actorLeave:
-                    case Event::Type::actorPress:
-                    case Event::Type::actorRelease:
-                    case Event::Type::actorClick:
-                    case Event::Type::actorDrag:
-                    case Event::Type::widgetChange:
-                        if (eventHandler->uiHandler &&
-                            eventHandler->uiHandler(*static_cast<UIEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::animationStart:
-                    case Event::Type::animationReset:
-                    case Event::Type::animationFinish:
-                        if (eventHandler->animationHandler &&
-                            eventHandler->animationHandler(*static_cast<AnimationEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::soundStart:
-                    case Event::Type::soundReset:
-                    case Event::Type::soundFinish:
-                        if (eventHandler->soundHandler &&
-                            eventHandler->soundHandler(*static_cast<SoundEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::update:
-                        if (eventHandler->updateHandler &&
-                            eventHandler->updateHandler(*static_cast<UpdateEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::user:
-                        if (eventHandler->userHandler &&
-                            eventHandler->userHandler(*static_cast<UserEvent*>(event.get())))
-                            return true;
-                        break;
-                    default:
-                        return false; // custom event should not be sent
-                }
+        // handlers can be removed while dispatching, so the list is accessed by index
+        for (std::size_t i = 0; i < categoryHandlers.size(); ++i)
+            if (const auto eventHandler = categoryHandlers[i])
+                if (const auto& function = eventHandler->*handler; function && function(event))
+                    return true;
 
         return false;
     }
 
+    bool EventDispatcher::dispatchEvent(const Event& event)
+    {
+        switch (event.type)
+        {
+            case Event::Type::keyboardConnect:
+            case Event::Type::keyboardDisconnect:
+            case Event::Type::keyboardKeyPress:
+            case Event::Type::keyboardKeyRelease:
+                return dispatch(Category::keyboard, static_cast<const KeyboardEvent&>(event), &EventHandler::keyboardHandler);
+            case Event::Type::mouseConnect:
+            case Event::Type::mouseDisconnect:
+            case Event::Type::mousePress:
+            case Event::Type::mouseRelease:
+            case Event::Type::mouseScroll:
+            case Event::Type::mouseMove:
+            case Event::Type::mouseCursorLockChange:
+                return dispatch(Category::mouse, static_cast<const MouseEvent&>(event), &EventHandler::mouseHandler);
+            case Event::Type::touchpadConnect:
+            case Event::Type::touchpadDisconnect:
+            case Event::Type::touchBegin:
+            case Event::Type::touchMove:
+            case Event::Type::touchEnd:
+            case Event::Type::touchCancel:
+                return dispatch(Category::touch, static_cast<const TouchEvent&>(event), &EventHandler::touchHandler);
+            case Event::Type::gamepadConnect:
+            case Event::Type::gamepadDisconnect:
+            case Event::Type::gamepadButtonChange:
+                return dispatch(Category::gamepad, static_cast<const GamepadEvent&>(event), &EventHandler::gamepadHandler);
+            case Event::Type::windowSizeChange:
+            case Event::Type::fullscreenChange:
+            case Event::Type::screenChange:
+            case Event::Type::resolutionChange:
+                return dispatch(Category::window, static_cast<const WindowEvent&>(event), &EventHandler::windowHandler);
+            case Event::Type::engineStart:
+            case Event::Type::engineStop:
+            case Event::Type::engineResume:
+            case Event::Type::enginePause:
+            case Event::Type::orientationChange:
+            case Event::Type::lowMemory:
+            case Event::Type::openFile:
+                return dispatch(Category::system, static_cast<const SystemEvent&>(event), &EventHandler::systemHandler);
+            case Event::Type::actorEnter:
+            case Event::Type::actorLeave:
+            case Event::Type::actorPress:
+            case Event::Type::actorRelease:
+            case Event::Type::actorClick:
+            case Event::Type::actorDrag:
+            case Event::Type::widgetChange:
+                return dispatch(Category::ui, static_cast<const UIEvent&>(event), &EventHandler::uiHandler);
+            case Event::Type::animationStart:
+            case Event::Type::animationReset:
+            case Event::Type::animationFinish:
+                return dispatch(Category::animation, static_cast<const AnimationEvent&>(event), &EventHandler::animationHandler);
+            case Event::Type::soundStart:
+            case Event::Type::soundReset:
+            case Event::Type::soundFinish:
+                return dispatch(Category::sound, static_cast<const SoundEvent&>(event), &EventHandler::soundHandler);
+            case Event::Type::update:
+                return dispatch(Category::update, static_cast<const UpdateEvent&>(event), &EventHandler::updateHandler);
+            case Event::Type::user:
+                return dispatch(Category::user, static_cast<const UserEvent&>(event), &EventHandler::userHandler);
+            default:
+                return false; // custom event should not be sent
+        }
+    }
+
     void EventDispatcher::addEventHandler(EventHandler& eventHandler)
     {
+        if (eventHandler.eventDispatcher == this) return;
+
         if (eventHandler.eventDispatcher)
             eventHandler.eventDispatcher->removeEventHandler(eventHandler);
 
         eventHandler.eventDispatcher = this;
-
-        eventHandlerAddSet.insert(&eventHandler);
-
-        const auto setIterator = eventHandlerDeleteSet.find(&eventHandler);
-
-        if (setIterator != eventHandlerDeleteSet.end())
-            eventHandlerDeleteSet.erase(setIterator);
+        addedEventHandlers.push_back(&eventHandler);
     }
 
-    void EventDispatcher::removeEventHandler(EventHandler& eventHandler)
+    void EventDispatcher::updateEventHandler(EventHandler& eventHandler, Category category)
     {
-        if (eventHandler.eventDispatcher == this)
-            eventHandler.eventDispatcher = nullptr;
-
-        eventHandlerDeleteSet.insert(&eventHandler);
+        const auto index = static_cast<std::size_t>(category);
+        auto& position = eventHandler.positions[index];
 
-        const auto setIterator = eventHandlerAddSet.find(&eventHandler);
-
-        if (setIterator != eventHandlerAddSet.end())
-            eventHandlerAddSet.erase(setIterator);
+        if (hasHandler(eventHandler, category))
+        {
+            // the handler is listed under the new category with the next update
+            if (position == EventHandler::npos &&
+                std::find(addedEventHandlers.begin(),
+                          addedEventHandlers.end(),
+                          &eventHandler) == addedEventHandlers.end())
+                addedEventHandlers.push_back(&eventHandler);
+        }
+        else if (position != EventHandler::npos)
+        {
+            eventHandlers[index][position] = nullptr;
+            dirty[index] = true;
+            position = EventHandler::npos;
+        }
     }
 
-    std::future<bool> EventDispatcher::postEvent(std::unique_ptr<Event> event)
+    void EventDispatcher::removeEventHandler(EventHandler& eventHandler)
     {
-        std::promise<bool> promise;
-        auto future = promise.get_future();
+        if (eventHandler.eventDispatcher != this) return;
 
-#ifdef __EMSCRIPTEN__
-        promise.set_value(dispatchEvent(std::move(event)));
-#else
-        std::scoped_lock lock{eventQueueMutex};
-        eventQueue.push(std::pair<std::promise<bool>, std::unique_ptr<Event>>{std::move(promise), std::move(event)});
-#endif
+        eventHandler.eventDispatcher = nullptr;
+
+        for (std::size_t category = 0; category < categoryCount; ++category)
+            if (auto& position = eventHandler.positions[category]; position != EventHandler::npos)
+            {
+                eventHandlers[category][position] = nullptr;
+                dirty[category] = true;
+                position = EventHandler::npos;
+            }
 
-        return future;
+        if (const auto i = std::find(addedEventHandlers.begin(),
+                                     addedEventHandlers.end(),
+                                     &eventHandler); i != addedEventHandlers.end())
+            addedEventHandlers.erase(i);
     }
 }
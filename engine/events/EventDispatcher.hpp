@@ -3,11 +3,11 @@
 #ifndef OUZEL_EVENTS_EVENTDISPATCHER_HPP
 #define OUZEL_EVENTS_EVENTDISPATCHER_HPP
 
-#include <cstdint>
-#include <future>
-#include <memory>
-#include <queue>
-#include <set>
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+#include <variant>
 #include <vector>
 #include "Event.hpp"
 
@@ -18,6 +18,24 @@ namespace ouzel
     class EventDispatcher final
     {
     public:
+        // one handler list for every handler function of the EventHandler
+        static constexpr std::size_t categoryCount = 11;
+
+        enum class Category
+        {
+            keyboard,
+            mouse,
+            touch,
+            gamepad,
+            window,
+            system,
+            ui,
+            animation,
+            sound,
+            update,
+            user
+        };
+
         EventDispatcher() = default;
         ~EventDispatcher();
 
@@ -29,22 +47,60 @@ namespace ouzel
         void addEventHandler(EventHandler& eventHandler);
         void removeEventHandler(EventHandler& eventHandler);
 
-        // dispatches the event immediately
-        bool dispatchEvent(std::unique_ptr<Event> event);
+        // dispatches the event immediately, returns true if a handler consumed it
+        bool dispatchEvent(const Event& event);
 
         // posts the event for dispatching on the game thread
-        std::future<bool> postEvent(std::unique_ptr<Event> event);
+        template <class T>
+        void postEvent(T&& event)
+        {
+            static_assert(std::is_base_of_v<Event, std::decay_t<T>>, "Not an event");
+
+#ifdef __EMSCRIPTEN__
+            dispatchEvent(event);
+#else
+            std::scoped_lock lock{eventQueueMutex};
+            eventQueue.emplace_back(std::forward<T>(event));
+#endif
+        }
 
         // dispatches all queued events on the game thread
         void dispatchEvents();
 
     private:
-        std::vector<EventHandler*> eventHandlers;
-        std::set<EventHandler*> eventHandlerAddSet;
-        std::set<EventHandler*> eventHandlerDeleteSet;
+        friend EventHandler;
+
+        static bool hasHandler(const EventHandler& eventHandler, Category category) noexcept;
+
+        template <class T, class Handler>
+        bool dispatch(Category category, const T& event, Handler EventHandler::* handler) const;
+
+        void updateEventHandlers();
+
+        // called when a handler function of an added handler is assigned
+        void updateEventHandler(EventHandler& eventHandler, Category category);
+
+        // handlers of every category sorted by descending priority, removed handlers are set to null
+        std::array<std::vector<EventHandler*>, categoryCount> eventHandlers;
+        std::array<bool, categoryCount> dirty{};
+        std::vector<EventHandler*> addedEventHandlers;
+
+        using QueuedEvent = std::variant<KeyboardEvent,
+            MouseEvent,
+            TouchEvent,
+            GamepadEvent,
+            WindowEvent,
+            SystemEvent,
+            UIEvent,
+            AnimationEvent,
+            SoundEvent,
+            UpdateEvent,
+            UserEvent>;
 
+        // the queues are swapped on dispatch, so the events are constructed in the already allocated storage
         std::mutex eventQueueMutex;
-        std::queue<std::pair<std::promise<bool>, std::unique_ptr<Event>>> eventQueue;
+        std::vector<QueuedEvent> eventQueue;
+        std::vector<QueuedEvent> dispatchedEvents;
     };
 }
 
@@ -3,8 +3,11 @@
 #ifndef OUZEL_EVENTS_EVENTHANDLER_HPP
 #define OUZEL_EVENTS_EVENTHANDLER_HPP
 
+#include <array>
 #include <functional>
 #include <cstdint>
+#include <limits>
+#include <utility>
 #include "Event.hpp"
 #include "EventDispatcher.hpp"
 
@@ -37,21 +40,69 @@ namespace ouzel
             }
         }
 
-        std::function<bool(const KeyboardEvent&)> keyboardHandler;
-        std::function<bool(const MouseEvent&)> mouseHandler;
-        std::function<bool(const TouchEvent&)> touchHandler;
-        std::function<bool(const GamepadEvent&)> gamepadHandler;
-        std::function<bool(const WindowEvent&)> windowHandler;
-        std::function<bool(const SystemEvent&)> systemHandler;
-        std::function<bool(const UIEvent&)> uiHandler;
-        std::function<bool(const AnimationEvent&)> animationHandler;
-        std::function<bool(const SoundEvent&)> soundHandler;
-        std::function<bool(const UpdateEvent&)> updateHandler;
-        std::function<bool(const UserEvent&)> userHandler;
+        // Handler function that tells the dispatcher when it is assigned
+        template <class T>
+        class Function final
+        {
+        public:
+            Function(EventHandler& initOwner, EventDispatcher::Category initCategory) noexcept:
+                owner{initOwner}, category{initCategory}
+            {
+            }
+
+            Function(const Function&) = delete;
+            Function& operator=(const Function&) = delete;
+            Function(Function&&) = delete;
+            Function& operator=(Function&&) = delete;
+
+            template <class F>
+            Function& operator=(F&& newFunction)
+            {
+                function = std::forward<F>(newFunction);
+                if (owner.eventDispatcher)
+                    owner.eventDispatcher->updateEventHandler(owner, category);
+                return *this;
+            }
+
+            explicit operator bool() const noexcept { return static_cast<bool>(function); }
+
+            bool operator()(const T& event) const { return function(event); }
+
+        private:
+            EventHandler& owner;
+            EventDispatcher::Category category;
+            std::function<bool(const T&)> function;
+        };
+
+        // the dispatcher lists the handler only under the categories that it has a function for,
+        // the functions can be assigned and cleared at any time, also after the handler was added to a dispatcher,
+        // the changes take effect with the next dispatchEvents call of the dispatcher
+        Function<KeyboardEvent> keyboardHandler{*this, EventDispatcher::Category::keyboard};
+        Function<MouseEvent> mouseHandler{*this, EventDispatcher::Category::mouse};
+        Function<TouchEvent> touchHandler{*this, EventDispatcher::Category::touch};
+        Function<GamepadEvent> gamepadHandler{*this, EventDispatcher::Category::gamepad};
+        Function<WindowEvent> windowHandler{*this, EventDispatcher::Category::window};
+        Function<SystemEvent> systemHandler{*this, EventDispatcher::Category::system};
+        Function<UIEvent> uiHandler{*this, EventDispatcher::Category::ui};
+        Function<AnimationEvent> animationHandler{*this, EventDispatcher::Category::animation};
+        Function<SoundEvent> soundHandler{*this, EventDispatcher::Category::sound};
+        Function<UpdateEvent> updateHandler{*this, EventDispatcher::Category::update};
+        Function<UserEvent> userHandler{*this, EventDispatcher::Category::user};
 
     private:
         Priority priority;
         EventDispatcher* eventDispatcher = nullptr;
+
+        // indices of the handler in the handler lists of the dispatcher
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+        std::array<std::size_t, EventDispatcher::categoryCount> positions = makePositions();
+
+        static constexpr std::array<std::size_t, EventDispatcher::categoryCount> makePositions() noexcept
+        {
+            std::array<std::size_t, EventDispatcher::categoryCount> result{};
+            for (auto& position : result) position = npos;
+            return result;
+        }
     };
 }
 
@@ -0,0 +1,440 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_FORMATS_COOKED_HPP
+#define OUZEL_FORMATS_COOKED_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "../utils/Utils.hpp"
+
+// Assets cooked by the ouzel tool. The values are little-endian and every record starts at an
+// offset aligned to its largest member, so the data can be used where it is without parsing.
+// Arrays and strings are stored as ranges: a 32-bit offset from the start of the file and a 32-bit element count.
+namespace ouzel::cooked
+{
+    class DecodeError final: public std::logic_error
+    {
+    public:
+        using logic_error::logic_error;
+    };
+
+    constexpr std::array<std::uint8_t, 4> identifier{'O', 'Z', 'C', 'K'};
+    constexpr std::uint16_t version = 1;
+
+    // identifier, version, kind, file size and 4 reserved bytes, the root record of the kind follows the header
+    constexpr std::size_t headerSize = 16;
+    constexpr std::size_t rangeSize = 8;
+
+    enum class Kind: std::uint16_t
+    {
+        spriteData = 1,
+        particleSystem = 2,
+        font = 3,
+        staticMesh = 4,
+        material = 5
+    };
+
+    // root: texture filename (string), animations (range)
+    // animation: name (string), frames (range)
+    // frame: name (string), rectangle (4 floats), source size (2 floats), source offset (2 floats),
+    // pivot (2 floats), rotated (uint32), reserved (uint32), vertices (range), indices (range of uint16)
+    // vertex: position and texture coordinates in pixels of the source image (4 floats)
+    namespace sprite
+    {
+        constexpr std::size_t rootSize = 16;
+        constexpr std::size_t animationSize = 16;
+        constexpr std::size_t frameSize = 72;
+        constexpr std::size_t vertexSize = 16;
+    }
+
+    // root: name (string), texture filename (string), mask of the set fields (uint64),
+    // a 32-bit value for every field, integers and booleans are stored as uint32
+    namespace particleSystem
+    {
+        enum class Field: std::uint8_t
+        {
+            blendFuncSource,
+            blendFuncDestination,
+            emitterType,
+            maxParticles,
+            duration,
+            particleLifespan,
+            particleLifespanVariance,
+            speed,
+            speedVariance,
+            absolutePosition,
+            yCoordFlipped,
+            sourcePositionX,
+            sourcePositionY,
+            sourcePositionVarianceX,
+            sourcePositionVarianceY,
+            startParticleSize,
+            startParticleSizeVariance,
+            finishParticleSize,
+            finishParticleSizeVariance,
+            angle,
+            angleVariance,
+            startRotation,
+            startRotationVariance,
+            finishRotation,
+            finishRotationVariance,
+            rotatePerSecond,
+            rotatePerSecondVariance,
+            minRadius,
+            minRadiusVariance,
+            maxRadius,
+            maxRadiusVariance,
+            radialAcceleration,
+            radialAccelVariance,
+            tangentialAcceleration,
+            tangentialAccelVariance,
+            rotationIsDir,
+            gravityX,
+            gravityY,
+            startColorRed,
+            startColorGreen,
+            startColorBlue,
+            startColorAlpha,
+            startColorRedVariance,
+            startColorGreenVariance,
+            startColorBlueVariance,
+            startColorAlphaVariance,
+            finishColorRed,
+            finishColorGreen,
+            finishColorBlue,
+            finishColorAlpha,
+            finishColorRedVariance,
+            finishColorGreenVariance,
+            finishColorBlueVariance,
+            finishColorAlphaVariance,
+            count
+        };
+
+        constexpr std::size_t fieldCount = static_cast<std::size_t>(Field::count);
+
+        // keys of the fields in the particle designer JSON files
+        constexpr std::array<std::string_view, fieldCount> keys{
+            "blendFuncSource",
+            "blendFuncDestination",
+            "emitterType",
+            "maxParticles",
+            "duration",
+            "particleLifespan",
+            "particleLifespanVariance",
+            "speed",
+            "speedVariance",
+            "absolutePosition",
+            "yCoordFlipped",
+            "sourcePositionx",
+            "sourcePositiony",
+            "sourcePositionVariancex",
+            "sourcePositionVariancey",
+            "startParticleSize",
+            "startParticleSizeVariance",
+            "finishParticleSize",
+            "finishParticleSizeVariance",
+            "angle",
+            "angleVariance",
+            "rotationStart",
+            "rotationStartVariance",
+            "rotationEnd",
+            "rotationEndVariance",
+            "rotatePerSecond",
+            "rotatePerSecondVariance",
+            "minRadius",
+            "minRadiusVariance",
+            "maxRadius",
+            "maxRadiusVariance",
+            "radialAcceleration",
+            "radialAccelVariance",
+            "tangentialAcceleration",
+            "tangentialAccelVariance",
+            "rotationIsDir",
+            "gravityx",
+            "gravityy",
+            "startColorRed",
+            "startColorGreen",
+            "startColorBlue",
+            "startColorAlpha",
+            "startColorVarianceRed",
+            "startColorVarianceGreen",
+            "startColorVarianceBlue",
+            "startColorVarianceAlpha",
+            "finishColorRed",
+            "finishColorGreen",
+            "finishColorBlue",
+            "finishColorAlpha",
+            "finishColorVarianceRed",
+            "finishColorVarianceGreen",
+            "finishColorVarianceBlue",
+            "finishColorVarianceAlpha"
+        };
+
+        static_assert(fieldCount <= 64, "The fields must fit in the mask");
+
+        [[nodiscard]] constexpr bool isInteger(Field field) noexcept
+        {
+            return field == Field::blendFuncSource ||
+                field == Field::blendFuncDestination ||
+                field == Field::emitterType ||
+                field == Field::maxParticles ||
+                field == Field::yCoordFlipped;
+        }
+
+        [[nodiscard]] constexpr bool isBoolean(Field field) noexcept
+        {
+            return field == Field::absolutePosition ||
+                field == Field::rotationIsDir;
+        }
+
+        constexpr std::size_t maskOffset = 16;
+        constexpr std::size_t valuesOffset = 24;
+        constexpr std::size_t rootSize = valuesOffset + fieldCount * 4;
+    }
+
+    // root: line height, base, width, height, pages, outline (uint16 each), reserved (uint32),
+    // texture filename (string), characters (range), kerning pairs (range)
+    // character: id (uint32), x, y, width, height, x offset, y offset, x advance, page (int16 each)
+    // kerning pair: first (uint32), second (uint32), amount (int16), reserved (uint16)
+    namespace font
+    {
+        constexpr std::size_t rootSize = 40;
+        constexpr std::size_t characterSize = 20;
+        constexpr std::size_t kerningPairSize = 12;
+    }
+
+    // root: material library filename (string), meshes (range)
+    // mesh: name (string), material name (string), bounding box minimum and maximum (6 floats),
+    // vertices (range), indices (range of uint32)
+    // vertex: position (3 floats), color (4 bytes), two texture coordinates (4 floats), normal (3 floats),
+    // which is the memory layout of graphics::Vertex
+    namespace staticMesh
+    {
+        constexpr std::size_t rootSize = 16;
+        constexpr std::size_t meshSize = 56;
+        constexpr std::size_t vertexSize = 44;
+    }
+
+    // root: materials (range)
+    // material: name (string), diffuse texture filename (string), ambient texture filename (string),
+    // ambient color (4 bytes), diffuse color (4 bytes), opacity (float), reserved (uint32)
+    namespace material
+    {
+        constexpr std::size_t rootSize = 8;
+        constexpr std::size_t materialSize = 40;
+    }
+
+    [[nodiscard]] inline bool isLittleEndianHost() noexcept
+    {
+        constexpr std::uint16_t probe = 1;
+        std::uint8_t firstByte;
+        std::memcpy(&firstByte, &probe, sizeof(firstByte));
+        return firstByte == 1;
+    }
+
+    struct Range final
+    {
+        std::size_t offset = 0;
+        std::size_t count = 0;
+    };
+
+    class Reader final
+    {
+    public:
+        Reader(const std::byte* initData, std::size_t initSize):
+            data{initData}, size{initSize}
+        {
+            if (!isCooked(data, size) || size < headerSize)
+                throw DecodeError{"Not a cooked asset"};
+
+            if (read<std::uint16_t>(4) != version)
+                throw DecodeError{"Unsupported cooked asset version"};
+
+            if (read<std::uint32_t>(8) != size)
+                throw DecodeError{"Invalid cooked asset size"};
+
+            kind = static_cast<Kind>(read<std::uint16_t>(6));
+        }
+
+        [[nodiscard]] static bool isCooked(const std::byte* data, std::size_t size) noexcept
+        {
+            if (size < identifier.size()) return false;
+
+            for (std::size_t i = 0; i < identifier.size(); ++i)
+                if (static_cast<std::uint8_t>(data[i]) != identifier[i])
+                    return false;
+
+            return true;
+        }
+
+        [[nodiscard]] auto getData() const noexcept { return data; }
+        [[nodiscard]] auto getSize() const noexcept { return size; }
+        [[nodiscard]] auto getKind() const noexcept { return kind; }
+
+        // checks that the root record of the kind fits in the file
+        void expect(Kind expectedKind, std::size_t rootSize) const
+        {
+            if (kind != expectedKind)
+                throw DecodeError{"Unexpected cooked asset kind"};
+
+            check(headerSize, rootSize);
+        }
+
+        template <typename T>
+        [[nodiscard]] T read(std::size_t offset) const
+        {
+            static_assert(std::is_arithmetic_v<T>, "Only numbers can be read");
+
+            if constexpr (std::is_same_v<T, bool>)
+                return read<std::uint32_t>(offset) != 0;
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                check(offset, sizeof(T));
+
+                using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+                const auto bits = decodeLittleEndian<Bits>(data + offset);
+                T result;
+                std::memcpy(&result, &bits, sizeof(result));
+                return result;
+            }
+            else
+            {
+                check(offset, sizeof(T));
+                return static_cast<T>(decodeLittleEndian<std::make_unsigned_t<T>>(data + offset));
+            }
+        }
+
+        // reads the range stored at the offset and checks that its elements are inside the file
+        [[nodiscard]] Range readRange(std::size_t offset, std::size_t elementSize) const
+        {
+            const Range result{read<std::uint32_t>(offset), read<std::uint32_t>(offset + 4)};
+
+            if (result.count > (std::numeric_limits<std::size_t>::max() - result.offset) / elementSize)
+                throw DecodeError{"Invalid cooked asset range"};
+
+            check(result.offset, result.count * elementSize);
+            return result;
+        }
+
+        [[nodiscard]] std::string_view readString(std::size_t offset) const
+        {
+            const auto range = readRange(offset, 1);
+            return std::string_view{reinterpret_cast<const char*>(data + range.offset), range.count};
+        }
+
+        // copies the elements as they are on little-endian hosts and decodes them one by one otherwise
+        template <typename T>
+        [[nodiscard]] std::vector<T> readArray(std::size_t offset) const
+        {
+            static_assert(std::is_unsigned_v<T>, "Only unsigned integer arrays can be read");
+
+            const auto range = readRange(offset, sizeof(T));
+            std::vector<T> result(range.count);
+
+            if (isLittleEndianHost())
+                std::memcpy(result.data(), data + range.offset, range.count * sizeof(T));
+            else
+                for (std::size_t i = 0; i < range.count; ++i)
+                    result[i] = decodeLittleEndian<T>(data + range.offset + i * sizeof(T));
+
+            return result;
+        }
+
+    private:
+        void check(std::size_t offset, std::size_t length) const
+        {
+            if (offset > size || size - offset < length)
+                throw DecodeError{"Cooked asset data out of range"};
+        }
+
+        const std::byte* data = nullptr;
+        std::size_t size = 0;
+        Kind kind{};
+    };
+
+    class Writer final
+    {
+    public:
+        explicit Writer(Kind kind):
+            data(headerSize)
+        {
+            std::copy(identifier.begin(), identifier.end(), data.begin());
+            write(4, version);
+            write(6, static_cast<std::uint16_t>(kind));
+        }
+
+        // appends a zeroed block starting at an offset aligned to the alignment and returns the offset
+        std::size_t allocate(std::size_t length, std::size_t alignment = 4)
+        {
+            const auto offset = (data.size() + alignment - 1) / alignment * alignment;
+            if (offset + length > std::numeric_limits<std::uint32_t>::max())
+                throw std::length_error{"Cooked asset is too big"};
+
+            data.resize(offset + length);
+            return offset;
+        }
+
+        template <typename T>
+        void write(std::size_t offset, T value)
+        {
+            static_assert(std::is_arithmetic_v<T>, "Only numbers can be written");
+
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+                Bits bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                encodeLittleEndian(data.data() + offset, bits);
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+                encodeLittleEndian(data.data() + offset, static_cast<std::uint32_t>(value ? 1 : 0));
+            else
+                encodeLittleEndian(data.data() + offset, static_cast<std::make_unsigned_t<T>>(value));
+        }
+
+        void writeRange(std::size_t offset, const Range& range)
+        {
+            write(offset, static_cast<std::uint32_t>(range.offset));
+            write(offset + 4, static_cast<std::uint32_t>(range.count));
+        }
+
+        // appends the characters and stores their range at the offset
+        void writeString(std::size_t offset, std::string_view str)
+        {
+            const auto stringOffset = allocate(str.size(), 1);
+            std::copy(str.begin(), str.end(), data.begin() + static_cast<std::ptrdiff_t>(stringOffset));
+            writeRange(offset, Range{stringOffset, str.size()});
+        }
+
+        template <typename T>
+        void writeArray(std::size_t offset, const std::vector<T>& values)
+        {
+            static_assert(std::is_unsigned_v<T>, "Only unsigned integer arrays can be written");
+
+            const auto arrayOffset = allocate(values.size() * sizeof(T), sizeof(T));
+            for (std::size_t i = 0; i < values.size(); ++i)
+                encodeLittleEndian(data.data() + arrayOffset + i * sizeof(T), values[i]);
+            writeRange(offset, Range{arrayOffset, values.size()});
+        }
+
+        // stores the final size in the header and returns the data
+        std::vector<std::uint8_t> finish()
+        {
+            write(8, static_cast<std::uint32_t>(data.size()));
+            return std::move(data);
+        }
+
+    private:
+        std::vector<std::uint8_t> data;
+    };
+}
+
+#endif // OUZEL_FORMATS_COOKED_HPP
@@ -7,9 +7,13 @@
 #include <array>
 #include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -66,26 +70,6 @@ namespace ouzel::json
                 if (!isWhiteSpace(static_cast<char>(*i))) return i;
             return end;
         }
-
-        template <class Iterator>
-        [[nodiscard]]
-        std::pair<bool, Iterator> isSame(const Iterator begin, const Iterator end,
-                                         const char* expectedBegin,
-                                         const char* expectedEnd)
-        {
-            auto iterator = begin;
-
-            while (iterator != end && expectedBegin != expectedEnd)
-            {
-                if (static_cast<char>(*iterator) != *expectedBegin)
-                    return std::pair(false, iterator);
-
-                ++iterator;
-                ++expectedBegin;
-            }
-
-            return std::pair{true, iterator};
-        }
     }
 
     class Value final
@@ -398,231 +382,264 @@ namespace ouzel::json
     using Object = std::map<std::string, Value, std::less<>>;
     using String = std::string;
 
-    template <class Iterator>
-    Value parse(Iterator begin, Iterator end)
+    inline namespace detail
     {
-        class Parser final
+        template <class Data, class = void>
+        struct IsContiguous: std::false_type {};
+
+        template <class Data>
+        struct IsContiguous<Data, std::void_t<decltype(std::data(std::declval<const Data&>()))>>:
+            std::bool_constant<sizeof(*std::data(std::declval<const Data&>())) == 1> {};
+
+        // Iterative reader, the nesting depth is limited only by the memory
+        template <class Iterator, class Handler>
+        class Reader final
         {
         public:
-            [[nodiscard]]
-            static Value parse(const Iterator begin, const Iterator end)
+            Reader(const Iterator initBegin, const Iterator initEnd, Handler& initHandler):
+                iterator{hasByteOrderMark(initBegin, initEnd) ? std::next(initBegin, 3) : initBegin},
+                end{initEnd},
+                handler{initHandler}
             {
-                const auto startIterator = hasByteOrderMark(begin, end) ? begin + 3 : begin;
-                const auto [result, valueIterator] = parseValue(startIterator, end);
-                if (const auto endIterator = skipWhiteSpaces(valueIterator, end); endIterator != end)
-                    throw ParseError{"Unexpected data"};
-
-                return result;
             }
 
-        private:
-            [[nodiscard]]
-            static std::pair<Value, Iterator> parseValue(const Iterator begin, const Iterator end)
+            void read()
             {
-                Iterator iterator = skipWhiteSpaces(begin, end);
-
-                if (iterator == end)
-                    throw ParseError{"Unexpected end of data"};
+                std::vector<bool> containers; // true for objects, false for arrays
 
-                if (static_cast<char>(*iterator) == '{')
+                for (;;)
                 {
-                    ++iterator;
+                    iterator = skipWhiteSpaces(iterator, end);
 
-                    Value result = Object{};
+                    if (iterator == end)
+                        throw ParseError{"Unexpected end of data"};
 
-                    bool firstValue = true;
+                    const auto c = static_cast<char>(*iterator);
 
-                    while ((iterator = skipWhiteSpaces(iterator, end)) != end &&
-                           static_cast<char>(*iterator) != '}')
+                    if (c == '{' || c == '[')
                     {
-                        if (firstValue)
-                            firstValue = false;
-                        else
-                        {
-                            if (static_cast<char>(*iterator++) != ',')
-                                throw ParseError{"Invalid object"};
-
-                            iterator = skipWhiteSpaces(iterator, end);
-                        }
-
-                        const auto [key, stringIterator] = parseString(iterator, end);
-                        iterator = skipWhiteSpaces(stringIterator, end);
+                        ++iterator;
 
-                        if (static_cast<char>(*iterator++) != ':')
-                            throw ParseError{"Invalid object"};
+                        const bool object = (c == '{');
+                        if (object) handler.beginObject(); else handler.beginArray();
 
                         iterator = skipWhiteSpaces(iterator, end);
 
-                        auto [value, valueIterator] = parseValue(iterator, end);
-                        iterator = valueIterator;
-                        result[key] = std::move(value);
+                        if (iterator == end || static_cast<char>(*iterator) != (object ? '}' : ']'))
+                        {
+                            containers.push_back(object);
+                            if (object) readKey();
+                            continue;
+                        }
+
+                        ++iterator;
+                        if (object) handler.endObject(); else handler.endArray();
                     }
+                    else
+                        readScalar(c);
 
-                    if (iterator == end || static_cast<char>(*iterator) != '}')
-                        throw ParseError{"Invalid object"};
+                    // close the finished containers up to the next value
+                    for (;;)
+                    {
+                        iterator = skipWhiteSpaces(iterator, end);
 
-                    ++iterator;
+                        if (containers.empty())
+                        {
+                            if (iterator != end)
+                                throw ParseError{"Unexpected data"};
+                            return;
+                        }
 
-                    return std::pair{result, iterator};
-                }
-                else if (static_cast<char>(*iterator) == '[')
-                {
-                    ++iterator;
+                        const bool object = containers.back();
 
-                    Value result = Array{};
+                        if (iterator == end)
+                            throw ParseError{object ? "Invalid object" : "Invalid array"};
 
-                    bool firstValue = true;
+                        const auto separator = static_cast<char>(*iterator++);
 
-                    while ((iterator = skipWhiteSpaces(iterator, end)) != end &&
-                           static_cast<char>(*iterator) != ']')
-                    {
-                        if (firstValue)
-                            firstValue = false;
-                        else
+                        if (separator == ',')
                         {
-                            if (static_cast<char>(*iterator++) != ',')
-                                throw ParseError{"Invalid object"};
-
-                            iterator = skipWhiteSpaces(iterator, end);
+                            if (object) readKey();
+                            break;
                         }
-
-                        const auto [value, valueIterator] = parseValue(iterator, end);
-                        iterator = valueIterator;
-                        result.pushBack(value);
+                        else if (separator == (object ? '}' : ']'))
+                        {
+                            containers.pop_back();
+                            if (object) handler.endObject(); else handler.endArray();
+                        }
+                        else
+                            throw ParseError{object ? "Invalid object" : "Invalid array"};
                     }
-
-                    if (iterator == end || static_cast<char>(*iterator) != ']')
-                        throw ParseError{"Invalid array"};
-
-                    ++iterator;
-
-                    return std::pair{result, iterator};
                 }
-                else if (static_cast<char>(*iterator) == '-' ||
-                         (static_cast<char>(*iterator) >= '0' &&
-                          static_cast<char>(*iterator) <= '9'))
-                {
-                    std::string value;
+            }
 
-                    if (static_cast<char>(*iterator) == '-')
-                    {
-                        value.push_back('-');
+        private:
+            // strings of mutable char buffers are decoded in place
+            static constexpr bool inSitu = std::is_same_v<Iterator, char*>;
+            // strings without escape sequences of contiguous data are passed as views into the data
+            static constexpr bool contiguous = std::is_pointer_v<Iterator> &&
+                sizeof(std::remove_pointer_t<Iterator>) == 1;
 
-                        if (++iterator == end ||
-                            static_cast<char>(*iterator) < '0' ||
-                            static_cast<char>(*iterator) > '9')
-                            throw ParseError{"Invalid number"};
-                    }
+            void readKey()
+            {
+                iterator = skipWhiteSpaces(iterator, end);
+                handler.key(readString());
+                iterator = skipWhiteSpaces(iterator, end);
 
-                    while (iterator != end &&
-                           (static_cast<char>(*iterator) >= '0' &&
-                            static_cast<char>(*iterator) <= '9'))
-                    {
-                        value.push_back(static_cast<char>(*iterator));
-                        ++iterator;
-                    }
+                if (iterator == end || static_cast<char>(*iterator++) != ':')
+                    throw ParseError{"Invalid object"};
+            }
 
-                    bool floatingPoint = false;
+            void readScalar(const char c)
+            {
+                if (c == '"')
+                    handler.string(readString());
+                else if (c == '-' || (c >= '0' && c <= '9'))
+                    readNumber();
+                else if (readLiteral("true"))
+                    handler.boolean(true);
+                else if (readLiteral("false"))
+                    handler.boolean(false);
+                else if (readLiteral("null"))
+                    handler.null();
+                else
+                    throw ParseError{"Unexpected identifier"};
+            }
 
-                    if (iterator != end &&
-                        static_cast<char>(*iterator) == '.')
-                    {
-                        floatingPoint = true;
+            [[nodiscard]] bool readLiteral(const std::string_view literal)
+            {
+                auto i = iterator;
+                for (const auto c : literal)
+                    if (i == end || static_cast<char>(*i++) != c)
+                        return false;
 
-                        value.push_back(static_cast<char>(*iterator));
-                        ++iterator;
+                iterator = i;
+                return true;
+            }
 
-                        while (iterator != end &&
-                               (static_cast<char>(*iterator) >= '0' &&
-                                static_cast<char>(*iterator) <= '9'))
-                        {
-                            value.push_back(static_cast<char>(*iterator));
-                            ++iterator;
-                        }
-                    }
+            [[nodiscard]] static constexpr bool isDigit(const char c) noexcept
+            {
+                return c >= '0' && c <= '9';
+            }
 
-                    // parse exponent
-                    if (iterator != end &&
-                        (static_cast<char>(*iterator) == 'e' ||
-                         static_cast<char>(*iterator) == 'E'))
-                    {
-                        floatingPoint = true;
+            void readNumber()
+            {
+                const auto start = iterator;
 
-                        value.push_back(static_cast<char>(*iterator));
+                const bool negative = (static_cast<char>(*iterator) == '-');
+                if (negative && (++iterator == end || !isDigit(static_cast<char>(*iterator))))
+                    throw ParseError{"Invalid number"};
 
-                        if (++iterator == end)
-                            throw ParseError{"Invalid exponent"};
+                // integers are accumulated while they are scanned
+                const std::uint64_t limit = negative ?
+                    static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) + 1U :
+                    static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+                std::uint64_t integer = 0;
+                bool overflow = false;
+
+                for (; iterator != end && isDigit(static_cast<char>(*iterator)); ++iterator)
+                {
+                    const auto digit = static_cast<std::uint64_t>(static_cast<char>(*iterator) - '0');
+                    if (integer > (limit - digit) / 10U)
+                        overflow = true;
+                    else
+                        integer = integer * 10U + digit;
+                }
 
-                        if (static_cast<char>(*iterator) == '+' ||
-                            static_cast<char>(*iterator) == '-')
-                            value.push_back(static_cast<char>(*iterator++));
+                bool floatingPoint = false;
 
-                        if (iterator == end ||
-                            static_cast<char>(*iterator) < '0' ||
-                            static_cast<char>(*iterator) > '9')
-                            throw ParseError{"Invalid exponent"};
+                if (iterator != end && static_cast<char>(*iterator) == '.')
+                {
+                    floatingPoint = true;
 
-                        while (iterator != end &&
-                               static_cast<char>(*iterator) >= '0' &&
-                               static_cast<char>(*iterator) <= '9')
-                        {
-                            value.push_back(static_cast<char>(*iterator));
-                            ++iterator;
-                        }
-                    }
+                    if (++iterator == end || !isDigit(static_cast<char>(*iterator)))
+                        throw ParseError{"Invalid number"};
 
-                    return floatingPoint ?
-                        std::pair{Value{std::stod(value)}, iterator} :
-                        std::pair{Value{static_cast<std::int64_t>(std::stoll(value))}, iterator};
+                    while (iterator != end && isDigit(static_cast<char>(*iterator)))
+                        ++iterator;
                 }
-                else if (static_cast<char>(*iterator) == '"')
+
+                // parse exponent
+                if (iterator != end &&
+                    (static_cast<char>(*iterator) == 'e' ||
+                     static_cast<char>(*iterator) == 'E'))
                 {
-                    const auto [stringValue, stringIterator] = parseString(iterator, end);
-                    iterator = stringIterator;
-                    return std::pair{Value{stringValue}, iterator};
+                    floatingPoint = true;
+
+                    if (++iterator == end)
+                        throw ParseError{"Invalid exponent"};
+
+                    if (static_cast<char>(*iterator) == '+' ||
+                        static_cast<char>(*iterator) == '-')
+                        ++iterator;
+
+                    if (iterator == end || !isDigit(static_cast<char>(*iterator)))
+                        throw ParseError{"Invalid exponent"};
+
+                    while (iterator != end && isDigit(static_cast<char>(*iterator)))
+                        ++iterator;
                 }
-                else
+
+                if (floatingPoint)
                 {
-                    constexpr char trueString[] = {'t', 'r', 'u', 'e'};
-                    constexpr char falseString[] = {'f', 'a', 'l', 's', 'e'};
-                    constexpr char nullString[] = {'n', 'u', 'l', 'l'};
-
-                    const auto [isTrue, trueIterator] = isSame(iterator, end,
-                                                               std::begin(trueString),
-                                                               std::end(trueString));
-                    iterator = trueIterator;
-                    if (isTrue)
-                        return std::pair{Value{true}, iterator};
-
-                    const auto [isFalse, falseIterator] = isSame(iterator, end,
-                                                                 std::begin(falseString),
-                                                                 std::end(falseString));
-                    iterator = falseIterator;
-                    if (isFalse)
-                        return std::pair{Value{false}, iterator};
-
-                    const auto [isNull, nullIterator] = isSame(iterator, end,
-                                                               std::begin(nullString),
-                                                               std::end(nullString));
-                    iterator = nullIterator;
-                    if (isNull)
-                        return std::pair{Value{nullptr}, iterator};
+                    // strtod needs a null-terminated string
+                    buffer.clear();
+                    for (auto i = start; i != iterator; ++i)
+                        buffer.push_back(static_cast<char>(*i));
 
-                    throw ParseError{"Unexpected identifier"};
+                    handler.number(std::strtod(buffer.c_str(), nullptr));
                 }
+                else if (overflow)
+                    throw RangeError{"Integer out of range"};
+                else
+                    handler.integer(negative ?
+                                    static_cast<std::int64_t>(0U - integer) :
+                                    static_cast<std::int64_t>(integer));
             }
 
-            [[nodiscard]]
-            static std::pair<std::string, Iterator> parseString(const Iterator begin, const Iterator end)
+            [[nodiscard]] std::string_view readString()
             {
-                std::string result;
-                Iterator iterator = begin;
-
                 if (iterator == end || static_cast<char>(*iterator) != '"')
                     throw ParseError{"Invalid string"};
 
                 ++iterator;
 
+                const auto start = iterator;
+
+                if constexpr (contiguous)
+                {
+                    for (; iterator != end; ++iterator)
+                    {
+                        const auto c = static_cast<char>(*iterator);
+                        if (c == '"' || c == '\\') break;
+                        else if (static_cast<std::uint8_t>(c) <= 0x1F) // control char
+                            throw ParseError{"Unterminated string literal"};
+                    }
+
+                    if (iterator == end)
+                        throw ParseError{"Invalid string"};
+
+                    if (static_cast<char>(*iterator) == '"')
+                        return std::string_view{reinterpret_cast<const char*>(start),
+                                                static_cast<std::size_t>(iterator++ - start)};
+                }
+
+                // the part without escape sequences is already in place for in-situ strings
+                [[maybe_unused]] auto output = iterator;
+                if constexpr (!inSitu)
+                {
+                    buffer.clear();
+                    for (auto i = start; i != iterator; ++i)
+                        buffer.push_back(static_cast<char>(*i));
+                }
+
+                const auto put = [&](const char c) {
+                    if constexpr (inSitu)
+                        *output++ = c;
+                    else
+                        buffer.push_back(c);
+                };
+
                 while (iterator != end && static_cast<char>(*iterator) != '"')
                 {
                     if (static_cast<char>(*iterator) == '\\')
@@ -632,56 +649,53 @@ namespace ouzel::json
 
                         switch (static_cast<char>(*iterator))
                         {
-                            case '"': result.push_back('"'); break;
-                            case '\\': result.push_back('\\'); break;
-                            case '/': result.push_back('/'); break;
-                            case 'b': result.push_back('\b'); break;
-                            case 'f': result.push_back('\f'); break;
-                            case 'n': result.push_back('\n'); break;
-                            case 'r': result.push_back('\r'); break;
-                            case 't': result.push_back('\t'); break;
+                            case '"': put('"'); break;
+                            case '\\': put('\\'); break;
+                            case '/': put('/'); break;
+                            case 'b': put('\b'); break;
+                            case 'f': put('\f'); break;
+                            case 'n': put('\n'); break;
+                            case 'r': put('\r'); break;
+                            case 't': put('\t'); break;
                             case 'u':
                             {
-                                char32_t c = 0;
+                                char32_t c = readCodeUnit();
 
-                                for (std::uint32_t i = 0; i < 4; ++i)
+                                // a surrogate pair is decoded to a single code point
+                                if (c >= 0xD800 && c <= 0xDBFF)
                                 {
-                                    if (++iterator == end)
-                                        throw ParseError{"Unexpected end of data"};
-
-                                    std::uint8_t code = 0;
-
-                                    if (static_cast<char>(*iterator) >= '0' && static_cast<char>(*iterator) <= '9')
-                                        code = static_cast<std::uint8_t>(*iterator) - '0';
-                                    else if (static_cast<char>(*iterator) >= 'a' && static_cast<char>(*iterator) <='f')
-                                        code = static_cast<std::uint8_t>(*iterator) - 'a' + 10;
-                                    else if (static_cast<char>(*iterator) >= 'A' && static_cast<char>(*iterator) <='F')
-                                        code = static_cast<std::uint8_t>(*iterator) - 'A' + 10;
-                                    else
-                                        throw ParseError{"Invalid character code"};
-
-                                    c = (c << 4) | code;
+                                    auto next = iterator;
+                                    if (++next != end && static_cast<char>(*next) == '\\' &&
+                                        ++next != end && static_cast<char>(*next) == 'u')
+                                    {
+                                        iterator = next;
+                                        const auto low = readCodeUnit();
+                                        if (low < 0xDC00 || low > 0xDFFF)
+                                            throw ParseError{"Invalid surrogate pair"};
+
+                                        c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                                    }
                                 }
 
                                 if (c <= 0x7F)
-                                    result.push_back(static_cast<char>(c));
+                                    put(static_cast<char>(c));
                                 else if (c <= 0x7FF)
                                 {
-                                    result.push_back(static_cast<char>(0xC0 | ((c >> 6) & 0x1F)));
-                                    result.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+                                    put(static_cast<char>(0xC0 | ((c >> 6) & 0x1F)));
+                                    put(static_cast<char>(0x80 | (c & 0x3F)));
                                 }
                                 else if (c <= 0xFFFF)
                                 {
-                                    result.push_back(static_cast<char>(0xE0 | ((c >> 12) & 0x0F)));
-                                    result.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
-                                    result.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+                                    put(static_cast<char>(0xE0 | ((c >> 12) & 0x0F)));
+                                    put(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+                                    put(static_cast<char>(0x80 | (c & 0x3F)));
                                 }
                                 else
                                 {
-                                    result.push_back(static_cast<char>(0xF0 | ((c >> 18) & 0x07)));
-                                    result.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
-                                    result.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
-                                    result.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+                                    put(static_cast<char>(0xF0 | ((c >> 18) & 0x07)));
+                                    put(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+                                    put(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+                                    put(static_cast<char>(0x80 | (c & 0x3F)));
                                 }
 
                                 break;
@@ -693,7 +707,7 @@ namespace ouzel::json
                     else if (static_cast<std::uint8_t>(*iterator) <= 0x1F) // control char
                         throw ParseError{"Unterminated string literal"};
                     else
-                        result.push_back(static_cast<char>(*iterator));
+                        put(static_cast<char>(*iterator));
 
                     ++iterator;
                 }
@@ -703,11 +717,123 @@ namespace ouzel::json
 
                 ++iterator;
 
-                return std::pair{result, iterator};
+                if constexpr (inSitu)
+                    return std::string_view{start, static_cast<std::size_t>(output - start)};
+                else
+                    return std::string_view{buffer};
+            }
+
+            // reads the four hexadecimal digits of a \u escape sequence, leaves the iterator on the last one
+            [[nodiscard]] char32_t readCodeUnit()
+            {
+                char32_t c = 0;
+
+                for (std::uint32_t i = 0; i < 4; ++i)
+                {
+                    if (++iterator == end)
+                        throw ParseError{"Unexpected end of data"};
+
+                    std::uint8_t code = 0;
+
+                    if (static_cast<char>(*iterator) >= '0' && static_cast<char>(*iterator) <= '9')
+                        code = static_cast<std::uint8_t>(*iterator) - '0';
+                    else if (static_cast<char>(*iterator) >= 'a' && static_cast<char>(*iterator) <='f')
+                        code = static_cast<std::uint8_t>(*iterator) - 'a' + 10;
+                    else if (static_cast<char>(*iterator) >= 'A' && static_cast<char>(*iterator) <='F')
+                        code = static_cast<std::uint8_t>(*iterator) - 'A' + 10;
+                    else
+                        throw ParseError{"Invalid character code"};
+
+                    c = (c << 4) | code;
+                }
+
+                return c;
+            }
+
+            Iterator iterator;
+            Iterator end;
+            Handler& handler;
+            std::string buffer; // decoded strings and numbers, reused to avoid allocations
+        };
+    }
+
+    // Streaming reader, calls the following functions of the handler for every token:
+    // null(), boolean(bool), integer(std::int64_t), number(double), string(std::string_view),
+    // key(std::string_view), beginObject(), endObject(), beginArray() and endArray()
+    // The string views are valid only until the function returns
+    template <class Iterator, class Handler>
+    void read(const Iterator begin, const Iterator end, Handler& handler)
+    {
+        Reader<Iterator, Handler>{begin, end, handler}.read();
+    }
+
+    template <class Handler>
+    void read(const char* data, Handler& handler)
+    {
+        read(data, data + std::strlen(data), handler);
+    }
+
+    template <class Data, class Handler>
+    void read(const Data& data, Handler& handler)
+    {
+        if constexpr (IsContiguous<Data>::value)
+            read(std::data(data), std::data(data) + std::size(data), handler);
+        else
+        {
+            using std::begin, std::end; // add std::begin and std::end to lookup
+            read(begin(data), end(data), handler);
+        }
+    }
+
+    template <class Iterator>
+    Value parse(Iterator begin, Iterator end)
+    {
+        class Builder final
+        {
+        public:
+            void null() { add(Value{nullptr}); }
+            void boolean(const bool value) { add(Value{value}); }
+            void integer(const std::int64_t value) { add(Value{value}); }
+            void number(const double value) { add(Value{value}); }
+            void string(const std::string_view value)
+            {
+                Value stringValue;
+                stringValue = String{value};
+                add(std::move(stringValue));
             }
+            void key(const std::string_view value) { currentKey = value; }
+            void beginObject() { containers.push_back(&add(Value{Object{}})); }
+            void endObject() { containers.pop_back(); }
+            void beginArray() { containers.push_back(&add(Value{Array{}})); }
+            void endArray() { containers.pop_back(); }
+
+            Value result;
+
+        private:
+            Value& add(Value&& value)
+            {
+                if (containers.empty())
+                    return result = std::move(value);
+
+                // the containers are filled one at a time, so the pointers to the parents stay valid
+                auto& parent = *containers.back();
+                if (parent.is<Object>())
+                    return parent.as<Object>().insert_or_assign(currentKey, std::move(value)).first->second;
+                else
+                {
+                    auto& array = parent.as<Array>();
+                    array.push_back(std::move(value));
+                    return array.back();
+                }
+            }
+
+            std::vector<Value*> containers;
+            std::string currentKey;
         };
 
-        return Parser::parse(begin, end);
+        Builder builder;
+        read(begin, end, builder);
+        return std::move(builder.result);
     }
 
     [[nodiscard]] inline Value parse(const char* data)
@@ -718,10 +844,337 @@ namespace ouzel::json
     template <class Data>
     [[nodiscard]] Value parse(const Data& data)
     {
-        using std::begin, std::end; // add std::begin and std::end to lookup
-        return parse(begin(data), end(data));
+        if constexpr (IsContiguous<Data>::value)
+            return parse(std::data(data), std::data(data) + std::size(data));
+        else
+        {
+            using std::begin, std::end; // add std::begin and std::end to lookup
+            return parse(begin(data), end(data));
+        }
     }
 
+    // Document parsed in place in its own copy of the data, the values are stored in a single array in the
+    // document order and the strings point into the copy, so the data must not be kept alive by the caller
+    class Document final
+    {
+    public:
+        enum class Type: std::uint8_t
+        {
+            null,
+            boolean,
+            integer,
+            number,
+            string,
+            object,
+            array
+        };
+
+    private:
+        struct Entry final
+        {
+            std::string_view key; // the key of an object member
+            union
+            {
+                std::int64_t integer = 0;
+                bool boolean;
+                double number;
+                const char* string;
+            };
+            std::uint32_t next = 0; // the index of the entry after the subtree
+            std::uint32_t size = 0; // the number of children or the length of the string
+            Type type = Type::null;
+        };
+
+    public:
+        class Node final
+        {
+        public:
+            class Iterator final
+            {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = Node;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const Node*;
+                using reference = Node;
+
+                Iterator() noexcept = default;
+                Iterator(const Document* initDocument, const std::uint32_t initIndex) noexcept:
+                    document{initDocument}, index{initIndex} {}
+
+                [[nodiscard]] Node operator*() const noexcept { return Node{document, index}; }
+
+                Iterator& operator++() noexcept
+                {
+                    index = document->entries[index].next;
+                    return *this;
+                }
+
+                Iterator operator++(int) noexcept
+                {
+                    const auto result = *this;
+                    ++(*this);
+                    return result;
+                }
+
+                [[nodiscard]] bool operator==(const Iterator& other) const noexcept { return index == other.index; }
+                [[nodiscard]] bool operator!=(const Iterator& other) const noexcept { return index != other.index; }
+
+            private:
+                const Document* document = nullptr;
+                std::uint32_t index = 0;
+            };
+
+            Node(const Document* initDocument, const std::uint32_t initIndex) noexcept:
+                document{initDocument}, index{initIndex} {}
+
+            [[nodiscard]] auto getType() const noexcept { return getEntry().type; }
+
+            // the key of the member when the node was reached by iterating an object
+            [[nodiscard]] auto getKey() const noexcept { return getEntry().key; }
+
+            template <typename T, typename std::enable_if_t<
+                std::is_same_v<T, std::nullptr_t> ||
+                std::is_same_v<T, bool> ||
+                std::is_same_v<T, Array> ||
+                std::is_same_v<T, Object> ||
+                std::is_same_v<T, String> ||
+                std::is_same_v<T, std::string_view>
+            >* = nullptr>
+            [[nodiscard]] bool is() const noexcept
+            {
+                const auto type = getEntry().type;
+                if constexpr (std::is_same_v<T, std::nullptr_t>) return type == Type::null;
+                else if constexpr (std::is_same_v<T, bool>) return type == Type::boolean;
+                else if constexpr (std::is_same_v<T, Array>) return type == Type::array;
+                else if constexpr (std::is_same_v<T, Object>) return type == Type::object;
+                else return type == Type::string;
+            }
+
+            template <typename T, typename std::enable_if_t<
+                std::is_arithmetic_v<T> &&
+                !std::is_same_v<T, bool>
+            >* = nullptr>
+            [[nodiscard]] bool is() const noexcept
+            {
+                return getEntry().type == Type::integer || getEntry().type == Type::number;
+            }
+
+            template <typename T, typename std::enable_if_t<std::is_arithmetic_v<T>>* = nullptr>
+            [[nodiscard]] T as() const
+            {
+                const auto& entry = getEntry();
+                switch (entry.type)
+                {
+                    case Type::number: return static_cast<T>(entry.number);
+                    case Type::integer: return static_cast<T>(entry.integer);
+                    case Type::boolean: return static_cast<T>(entry.boolean);
+                    default: throw TypeError{"Wrong type"};
+                }
+            }
+
+            template <typename T, typename std::enable_if_t<
+                std::is_same_v<T, std::string_view> ||
+                std::is_same_v<T, String>
+            >* = nullptr>
+            [[nodiscard]] T as() const
+            {
+                const auto& entry = getEntry();
+                if (entry.type != Type::string)
+                    throw TypeError{"Wrong type"};
+
+                return T{entry.string, entry.size};
+            }
+
+            // iterates the elements of an array or the members of an object
+            [[nodiscard]] Iterator begin() const
+            {
+                (void)getContainer(); // throws for the other types
+                return Iterator{document, index + 1U};
+            }
+
+            [[nodiscard]] Iterator end() const
+            {
+                return Iterator{document, getContainer().next};
+            }
+
+            // objects are searched linearly, which is faster than a map for the small objects of the asset files
+            [[nodiscard]] bool hasMember(std::string_view member) const
+            {
+                return findMember(member) != getEntry().next;
+            }
+
+            [[nodiscard]] Node operator[](std::string_view member) const
+            {
+                if (const auto memberIndex = findMember(member); memberIndex != getEntry().next)
+                    return Node{document, memberIndex};
+                else
+                    throw RangeError{"Member does not exist"};
+            }
+
+            // the elements are reached by skipping the previous ones, use iterators to visit all of them
+            [[nodiscard]] Node operator[](std::size_t elementIndex) const
+            {
+                const auto& entry = getEntry();
+                if (entry.type != Type::array)
+                    throw TypeError{"Wrong type"};
+
+                if (elementIndex >= entry.size)
+                    throw RangeError{"Index out of range"};
+
+                auto i = begin();
+                while (elementIndex-- > 0) ++i;
+                return *i;
+            }
+
+            [[nodiscard]] bool isEmpty() const
+            {
+                return getContainer().size == 0;
+            }
+
+            [[nodiscard]] std::size_t getSize() const
+            {
+                return getContainer().size;
+            }
+
+        private:
+            [[nodiscard]] const Entry& getEntry() const noexcept
+            {
+                return document->entries[index];
+            }
+
+            [[nodiscard]] const Entry& getContainer() const
+            {
+                const auto& entry = getEntry();
+                if (entry.type != Type::array && entry.type != Type::object)
+                    throw TypeError{"Wrong type"};
+                return entry;
+            }
+
+            [[nodiscard]] std::uint32_t findMember(std::string_view member) const
+            {
+                const auto& entry = getEntry();
+                if (entry.type != Type::object)
+                    throw TypeError{"Wrong type"};
+
+                // the last member with the same key is used, like in Value
+                std::uint32_t result = entry.next;
+                for (auto i = index + 1U; i != entry.next; i = document->entries[i].next)
+                    if (document->entries[i].key == member)
+                        result = i;
+
+                return result;
+            }
+
+            const Document* document;
+            std::uint32_t index;
+        };
+
+        Document() = default;
+
+        explicit Document(const char* data):
+            Document{data, data + std::strlen(data)}
+        {
+        }
+
+        template <class Data>
+        explicit Document(const Data& data)
+        {
+            using std::begin, std::end; // add std::begin and std::end to lookup
+            parse(begin(data), end(data));
+        }
+
+        template <class Iterator>
+        Document(const Iterator begin, const Iterator end)
+        {
+            parse(begin, end);
+        }
+
+        [[nodiscard]] Node getRoot() const
+        {
+            if (entries.empty())
+                throw RangeError{"Document is empty"};
+            return Node{this, 0};
+        }
+
+    private:
+        template <class Iterator>
+        void parse(const Iterator begin, const Iterator end)
+        {
+            const auto size = static_cast<std::size_t>(std::distance(begin, end));
+            if (size > std::numeric_limits<std::uint32_t>::max())
+                throw RangeError{"Document is too big"};
+
+            buffer.reset(new char[size]);
+            std::transform(begin, end, buffer.get(), [](const auto c) noexcept { return static_cast<char>(c); });
+
+            class Builder final
+            {
+            public:
+                explicit Builder(std::vector<Entry>& initEntries) noexcept: entries{initEntries} {}
+
+                void null() { add(Type::null); }
+                void boolean(const bool value) { add(Type::boolean).boolean = value; }
+                void integer(const std::int64_t value) { add(Type::integer).integer = value; }
+                void number(const double value) { add(Type::number).number = value; }
+
+                void string(const std::string_view value)
+                {
+                    // the strings are decoded in place, so they are never longer than the document
+                    auto& entry = add(Type::string);
+                    entry.string = value.data();
+                    entry.size = static_cast<std::uint32_t>(value.size());
+                }
+
+                void key(const std::string_view value) noexcept { currentKey = value; }
+                void beginObject() { open(Type::object); }
+                void endObject() { close(); }
+                void beginArray() { open(Type::array); }
+                void endArray() { close(); }
+
+            private:
+                Entry& add(const Type type)
+                {
+                    if (!containers.empty())
+                        ++entries[containers.back()].size;
+
+                    auto& entry = entries.emplace_back();
+                    entry.type = type;
+                    entry.key = currentKey;
+                    entry.next = static_cast<std::uint32_t>(entries.size());
+                    currentKey = {};
+                    return entry;
+                }
+
+                void open(const Type type)
+                {
+                    add(type);
+                    containers.push_back(static_cast<std::uint32_t>(entries.size() - 1));
+                }
+
+                void close()
+                {
+                    entries[containers.back()].next = static_cast<std::uint32_t>(entries.size());
+                    containers.pop_back();
+                }
+
+                std::vector<Entry>& entries;
+                std::vector<std::uint32_t> containers;
+                std::string_view currentKey;
+            };
+
+            // a rough estimate for the indented asset files, avoids most of the reallocations
+            entries.clear();
+            entries.reserve(size / 16);
+
+            Builder builder{entries};
+            read(buffer.get(), buffer.get() + size, builder);
+        }
+
+        std::unique_ptr<char[]> buffer;
+        std::vector<Entry> entries;
+    };
+
     [[nodiscard]]
     inline std::string encode(const Value& value,
                               const bool whiteSpaces = false,
@@ -0,0 +1,427 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <array>
+#include "BlockDecoder.hpp"
+#include "GraphicsError.hpp"
+
+namespace ouzel::graphics
+{
+    namespace
+    {
+        using Pixel = std::array<std::uint8_t, 4>;
+        using Block = std::array<Pixel, 16>; // pixels of a 4x4 block in rows
+
+        constexpr std::uint8_t clampColor(std::int32_t value) noexcept
+        {
+            return static_cast<std::uint8_t>(std::clamp(value, 0, 255));
+        }
+
+        Pixel fromRgb565(std::uint32_t color) noexcept
+        {
+            const auto red = (color >> 11) & 0x1FU;
+            const auto green = (color >> 5) & 0x3FU;
+            const auto blue = color & 0x1FU;
+
+            return Pixel{
+                static_cast<std::uint8_t>((red << 3) | (red >> 2)),
+                static_cast<std::uint8_t>((green << 2) | (green >> 4)),
+                static_cast<std::uint8_t>((blue << 3) | (blue >> 2)),
+                255
+            };
+        }
+
+        // BC1 color block, the color blocks of BC3 are always in the four color mode
+        void decodeColorBlock(const std::uint8_t* input, bool fourColors, Block& block) noexcept
+        {
+            const auto color0 = static_cast<std::uint32_t>(input[0]) | (static_cast<std::uint32_t>(input[1]) << 8);
+            const auto color1 = static_cast<std::uint32_t>(input[2]) | (static_cast<std::uint32_t>(input[3]) << 8);
+
+            std::array<Pixel, 4> palette{fromRgb565(color0), fromRgb565(color1)};
+
+            for (std::size_t channel = 0; channel < 3; ++channel)
+                if (fourColors || color0 > color1)
+                {
+                    palette[2][channel] = static_cast<std::uint8_t>((2U * palette[0][channel] + palette[1][channel] + 1U) / 3U);
+                    palette[3][channel] = static_cast<std::uint8_t>((palette[0][channel] + 2U * palette[1][channel] + 1U) / 3U);
+                }
+                else
+                {
+                    palette[2][channel] = static_cast<std::uint8_t>((palette[0][channel] + palette[1][channel] + 1U) / 2U);
+                    palette[3][channel] = 0;
+                }
+
+            palette[2][3] = 255;
+            palette[3][3] = (fourColors || color0 > color1) ? 255 : 0;
+
+            const auto indices = static_cast<std::uint32_t>(input[4]) |
+                (static_cast<std::uint32_t>(input[5]) << 8) |
+                (static_cast<std::uint32_t>(input[6]) << 16) |
+                (static_cast<std::uint32_t>(input[7]) << 24);
+
+            for (std::size_t i = 0; i < block.size(); ++i)
+                block[i] = palette[(indices >> (i * 2)) & 0x03U];
+        }
+
+        // BC3 alpha block and BC4 and BC5 channel blocks
+        void decodeChannelBlock(const std::uint8_t* input, Block& block, std::size_t channel) noexcept
+        {
+            const std::uint32_t value0 = input[0];
+            const std::uint32_t value1 = input[1];
+
+            std::array<std::uint8_t, 8> palette{static_cast<std::uint8_t>(value0), static_cast<std::uint8_t>(value1)};
+
+            if (value0 > value1)
+                for (std::uint32_t i = 2; i < 8; ++i)
+                    palette[i] = static_cast<std::uint8_t>(((8 - i) * value0 + (i - 1) * value1) / 7);
+            else
+            {
+                for (std::uint32_t i = 2; i < 6; ++i)
+                    palette[i] = static_cast<std::uint8_t>(((6 - i) * value0 + (i - 1) * value1) / 5);
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+
+            std::uint64_t indices = 0;
+            for (std::size_t i = 0; i < 6; ++i)
+                indices |= static_cast<std::uint64_t>(input[2 + i]) << (i * 8);
+
+            for (std::size_t i = 0; i < block.size(); ++i)
+                block[i][channel] = palette[(indices >> (i * 3)) & 0x07U];
+        }
+
+        constexpr std::int32_t etcModifiers[8][4] = {
+            {2, 8, -2, -8},
+            {5, 17, -5, -17},
+            {9, 29, -9, -29},
+            {13, 42, -13, -42},
+            {18, 60, -18, -60},
+            {24, 80, -24, -80},
+            {33, 106, -33, -106},
+            {47, 183, -47, -183}
+        };
+
+        constexpr std::int32_t etcDistances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+        constexpr std::int32_t eacModifiers[16][8] = {
+            {-3, -6, -9, -15, 2, 5, 8, 14},
+            {-3, -7, -10, -13, 2, 6, 9, 12},
+            {-2, -5, -8, -13, 1, 4, 7, 12},
+            {-2, -4, -6, -13, 1, 3, 5, 12},
+            {-3, -6, -8, -12, 2, 5, 7, 11},
+            {-3, -7, -9, -11, 2, 6, 8, 10},
+            {-4, -7, -8, -11, 3, 6, 7, 10},
+            {-3, -5, -8, -11, 2, 4, 7, 10},
+            {-2, -6, -8, -10, 1, 5, 7, 9},
+            {-2, -5, -8, -10, 1, 4, 7, 9},
+            {-2, -4, -8, -10, 1, 3, 7, 9},
+            {-2, -5, -7, -10, 1, 4, 6, 9},
+            {-3, -4, -7, -10, 2, 3, 6, 9},
+            {-1, -2, -3, -10, 0, 1, 2, 9},
+            {-4, -6, -8, -9, 3, 5, 7, 8},
+            {-3, -5, -7, -9, 2, 4, 6, 8}
+        };
+
+        constexpr std::int32_t extend4(std::uint64_t value) noexcept
+        {
+            return static_cast<std::int32_t>((value << 4) | value);
+        }
+
+        constexpr std::int32_t extend5(std::uint64_t value) noexcept
+        {
+            return static_cast<std::int32_t>((value << 3) | (value >> 2));
+        }
+
+        constexpr std::int32_t extend6(std::uint64_t value) noexcept
+        {
+            return static_cast<std::int32_t>((value << 2) | (value >> 4));
+        }
+
+        constexpr std::int32_t extend7(std::uint64_t value) noexcept
+        {
+            return static_cast<std::int32_t>((value << 1) | (value >> 6));
+        }
+
+        constexpr std::int32_t signExtend3(std::uint64_t value) noexcept
+        {
+            return static_cast<std::int32_t>(value) - ((value & 0x04U) ? 8 : 0);
+        }
+
+        // ETC pixels are stored in columns, the most significant bits of the indices are in the upper half
+        constexpr std::uint32_t getEtcIndex(std::uint64_t bits, std::uint32_t x, std::uint32_t y) noexcept
+        {
+            const auto pixel = x * 4 + y;
+            return static_cast<std::uint32_t>(((bits >> (pixel + 16)) & 0x01U) << 1 | ((bits >> pixel) & 0x01U));
+        }
+
+        // ETC2 RGB block, which includes the individual and differential modes of ETC1 and the T, H and planar modes
+        void decodeEtc2ColorBlock(const std::uint8_t* input, Block& block) noexcept
+        {
+            std::uint64_t bits = 0;
+            for (std::size_t i = 0; i < 8; ++i)
+                bits = (bits << 8) | input[i];
+
+            const auto get = [bits](std::uint32_t high, std::uint32_t count) noexcept {
+                return (bits >> (high - count + 1)) & ((std::uint64_t{1} << count) - 1);
+            };
+
+            const auto setPixel = [&block](std::uint32_t x, std::uint32_t y, std::int32_t red, std::int32_t green, std::int32_t blue) noexcept {
+                block[y * 4 + x] = Pixel{clampColor(red), clampColor(green), clampColor(blue), 255};
+            };
+
+            std::array<std::array<std::int32_t, 3>, 2> baseColors;
+
+            if (get(33, 1) == 0) // individual mode
+            {
+                baseColors[0] = {extend4(get(63, 4)), extend4(get(55, 4)), extend4(get(47, 4))};
+                baseColors[1] = {extend4(get(59, 4)), extend4(get(51, 4)), extend4(get(43, 4))};
+            }
+            else
+            {
+                const auto red = static_cast<std::int32_t>(get(63, 5));
+                const auto green = static_cast<std::int32_t>(get(55, 5));
+                const auto blue = static_cast<std::int32_t>(get(47, 5));
+                const auto red2 = red + signExtend3(get(58, 3));
+                const auto green2 = green + signExtend3(get(50, 3));
+                const auto blue2 = blue + signExtend3(get(42, 3));
+
+                if (red2 < 0 || red2 > 31) // T mode
+                {
+                    const std::array<std::int32_t, 3> color0{
+                        extend4((get(60, 2) << 2) | get(57, 2)), extend4(get(55, 4)), extend4(get(51, 4))
+                    };
+                    const std::array<std::int32_t, 3> color1{
+                        extend4(get(47, 4)), extend4(get(43, 4)), extend4(get(39, 4))
+                    };
+                    const auto distance = etcDistances[(get(35, 2) << 1) | get(32, 1)];
+
+                    for (std::uint32_t x = 0; x < 4; ++x)
+                        for (std::uint32_t y = 0; y < 4; ++y)
+                            switch (getEtcIndex(bits, x, y))
+                            {
+                                case 0: setPixel(x, y, color0[0], color0[1], color0[2]); break;
+                                case 1: setPixel(x, y, color1[0] + distance, color1[1] + distance, color1[2] + distance); break;
+                                case 2: setPixel(x, y, color1[0], color1[1], color1[2]); break;
+                                default: setPixel(x, y, color1[0] - distance, color1[1] - distance, color1[2] - distance); break;
+                            }
+                    return;
+                }
+
+                if (green2 < 0 || green2 > 31) // H mode
+                {
+                    const auto red0 = get(62, 4);
+                    const auto green0 = (get(58, 3) << 1) | get(52, 1);
+                    const auto blue0 = (get(51, 1) << 3) | get(49, 3);
+                    const auto red1 = get(46, 4);
+                    const auto green1 = get(42, 4);
+                    const auto blue1 = get(38, 4);
+
+                    // the lowest bit of the distance index is given by the order of the colors
+                    const auto order = ((red0 << 8) | (green0 << 4) | blue0) >= ((red1 << 8) | (green1 << 4) | blue1) ? 1U : 0U;
+                    const auto distance = etcDistances[(get(34, 1) << 2) | (get(32, 1) << 1) | order];
+
+                    const std::array<std::int32_t, 3> color0{extend4(red0), extend4(green0), extend4(blue0)};
+                    const std::array<std::int32_t, 3> color1{extend4(red1), extend4(green1), extend4(blue1)};
+
+                    for (std::uint32_t x = 0; x < 4; ++x)
+                        for (std::uint32_t y = 0; y < 4; ++y)
+                        {
+                            const auto index = getEtcIndex(bits, x, y);
+                            const auto& color = (index < 2) ? color0 : color1;
+                            const auto offset = (index % 2 == 0) ? distance : -distance;
+                            setPixel(x, y, color[0] + offset, color[1] + offset, color[2] + offset);
+                        }
+                    return;
+                }
+
+                if (blue2 < 0 || blue2 > 31) // planar mode
+                {
+                    const std::array<std::int32_t, 3> origin{
+                        extend6(get(62, 6)),
+                        extend7((get(56, 1) << 6) | get(54, 6)),
+                        extend6((get(48, 1) << 5) | (get(44, 2) << 3) | get(41, 3))
+                    };
+                    const std::array<std::int32_t, 3> horizontal{
+                        extend6((get(38, 5) << 1) | get(32, 1)),
+                        extend7(get(31, 7)),
+                        extend6(get(24, 6))
+                    };
+                    const std::array<std::int32_t, 3> vertical{
+                        extend6(get(18, 6)),
+                        extend7(get(12, 7)),
+                        extend6(get(5, 6))
+                    };
+
+                    const auto interpolate = [&origin, &horizontal, &vertical](std::size_t channel, std::int32_t x, std::int32_t y) noexcept {
+                        return (x * (horizontal[channel] - origin[channel]) +
+                                y * (vertical[channel] - origin[channel]) +
+                                4 * origin[channel] + 2) / 4;
+                    };
+
+                    for (std::uint32_t x = 0; x < 4; ++x)
+                        for (std::uint32_t y = 0; y < 4; ++y)
+                        {
+                            const auto pixelX = static_cast<std::int32_t>(x);
+                            const auto pixelY = static_cast<std::int32_t>(y);
+                            setPixel(x, y,
+                                     interpolate(0, pixelX, pixelY),
+                                     interpolate(1, pixelX, pixelY),
+                                     interpolate(2, pixelX, pixelY));
+                        }
+                    return;
+                }
+
+                // differential mode
+                baseColors[0] = {extend5(static_cast<std::uint64_t>(red)), extend5(static_cast<std::uint64_t>(green)), extend5(static_cast<std::uint64_t>(blue))};
+                baseColors[1] = {extend5(static_cast<std::uint64_t>(red2)), extend5(static_cast<std::uint64_t>(green2)), extend5(static_cast<std::uint64_t>(blue2))};
+            }
+
+            const std::array<std::uint64_t, 2> tables{get(39, 3), get(36, 3)};
+            const auto flip = get(32, 1) != 0;
+
+            for (std::uint32_t x = 0; x < 4; ++x)
+                for (std::uint32_t y = 0; y < 4; ++y)
+                {
+                    // the sub-blocks are side by side, or on top of each other if flipped
+                    const auto subblock = flip ? (y >= 2 ? 1U : 0U) : (x >= 2 ? 1U : 0U);
+                    const auto& color = baseColors[subblock];
+                    const auto modifier = etcModifiers[tables[subblock]][getEtcIndex(bits, x, y)];
+                    setPixel(x, y, color[0] + modifier, color[1] + modifier, color[2] + modifier);
+                }
+        }
+
+        void decodeEacAlphaBlock(const std::uint8_t* input, Block& block) noexcept
+        {
+            const auto base = static_cast<std::int32_t>(input[0]);
+            const auto multiplier = static_cast<std::int32_t>(input[1] >> 4);
+            const auto& modifiers = eacModifiers[input[1] & 0x0FU];
+
+            std::uint64_t indices = 0;
+            for (std::size_t i = 2; i < 8; ++i)
+                indices = (indices << 8) | input[i];
+
+            // the pixels are stored in columns starting from the most significant bits
+            for (std::uint32_t x = 0; x < 4; ++x)
+                for (std::uint32_t y = 0; y < 4; ++y)
+                {
+                    const auto pixel = x * 4 + y;
+                    const auto index = (indices >> (45 - pixel * 3)) & 0x07U;
+                    block[y * 4 + x][3] = clampColor(base + modifiers[index] * multiplier);
+                }
+        }
+    }
+
+    bool isDecodable(PixelFormat pixelFormat) noexcept
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::bc1RgbaUnsignedNorm:
+            case PixelFormat::bc1RgbaUnsignedNormSRGB:
+            case PixelFormat::bc3RgbaUnsignedNorm:
+            case PixelFormat::bc3RgbaUnsignedNormSRGB:
+            case PixelFormat::bc4RUnsignedNorm:
+            case PixelFormat::bc5RgUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNormSRGB:
+            case PixelFormat::etc2RgbaUnsignedNorm:
+            case PixelFormat::etc2RgbaUnsignedNormSRGB:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    PixelFormat getDecodedPixelFormat(PixelFormat pixelFormat)
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::bc1RgbaUnsignedNorm:
+            case PixelFormat::bc3RgbaUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNorm:
+            case PixelFormat::etc2RgbaUnsignedNorm:
+                return PixelFormat::rgba8UnsignedNorm;
+            case PixelFormat::bc1RgbaUnsignedNormSRGB:
+            case PixelFormat::bc3RgbaUnsignedNormSRGB:
+            case PixelFormat::etc2RgbUnsignedNormSRGB:
+            case PixelFormat::etc2RgbaUnsignedNormSRGB:
+                return PixelFormat::rgba8UnsignedNormSRGB;
+            case PixelFormat::bc4RUnsignedNorm:
+                return PixelFormat::r8UnsignedNorm;
+            case PixelFormat::bc5RgUnsignedNorm:
+                return PixelFormat::rg8UnsignedNorm;
+            default:
+                throw Error{"Pixel format can't be decoded"};
+        }
+    }
+
+    std::vector<std::uint8_t> decodeLevel(PixelFormat pixelFormat,
+                                          std::uint32_t width,
+                                          std::uint32_t height,
+                                          const std::vector<std::uint8_t>& data)
+    {
+        const auto decodedPixelFormat = getDecodedPixelFormat(pixelFormat);
+
+        if (data.size() != getLevelSize(pixelFormat, width, height))
+            throw Error{"Invalid compressed texture data size"};
+
+        const auto channelCount = getPixelSize(decodedPixelFormat);
+        const auto blockSize = getBlockSize(pixelFormat);
+        const auto blockCountX = (width + compressedBlockWidth - 1) / compressedBlockWidth;
+        const auto blockCountY = (height + compressedBlockHeight - 1) / compressedBlockHeight;
+
+        std::vector<std::uint8_t> result(static_cast<std::size_t>(width) * height * channelCount);
+
+        auto input = data.data();
+
+        for (std::uint32_t blockY = 0; blockY < blockCountY; ++blockY)
+            for (std::uint32_t blockX = 0; blockX < blockCountX; ++blockX, input += blockSize)
+            {
+                Block block{};
+
+                switch (pixelFormat)
+                {
+                    case PixelFormat::bc1RgbaUnsignedNorm:
+                    case PixelFormat::bc1RgbaUnsignedNormSRGB:
+                        decodeColorBlock(input, false, block);
+                        break;
+                    case PixelFormat::bc3RgbaUnsignedNorm:
+                    case PixelFormat::bc3RgbaUnsignedNormSRGB:
+                        decodeColorBlock(input + 8, true, block);
+                        decodeChannelBlock(input, block, 3);
+                        break;
+                    case PixelFormat::bc4RUnsignedNorm:
+                        decodeChannelBlock(input, block, 0);
+                        break;
+                    case PixelFormat::bc5RgUnsignedNorm:
+                        decodeChannelBlock(input, block, 0);
+                        decodeChannelBlock(input + 8, block, 1);
+                        break;
+                    case PixelFormat::etc2RgbUnsignedNorm:
+                    case PixelFormat::etc2RgbUnsignedNormSRGB:
+                        decodeEtc2ColorBlock(input, block);
+                        break;
+                    case PixelFormat::etc2RgbaUnsignedNorm:
+                    case PixelFormat::etc2RgbaUnsignedNormSRGB:
+                        decodeEtc2ColorBlock(input + 8, block);
+                        decodeEacAlphaBlock(input, block);
+                        break;
+                    default:
+                        throw Error{"Pixel format can't be decoded"};
+                }
+
+                // the pixels of the blocks on the right and bottom edges can be outside of the level
+                const auto blockWidth = std::min(width - blockX * 4, 4U);
+                const auto blockHeight = std::min(height - blockY * 4, 4U);
+
+                for (std::uint32_t y = 0; y < blockHeight; ++y)
+                    for (std::uint32_t x = 0; x < blockWidth; ++x)
+                    {
+                        const auto output = result.data() +
+                            ((static_cast<std::size_t>(blockY) * 4 + y) * width + blockX * 4 + x) * channelCount;
+                        std::copy(block[y * 4 + x].begin(), block[y * 4 + x].begin() + channelCount, output);
+                    }
+            }
+
+        return result;
+    }
+}
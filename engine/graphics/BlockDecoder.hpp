@@ -0,0 +1,25 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_BLOCKDECODER_HPP
+#define OUZEL_GRAPHICS_BLOCKDECODER_HPP
+
+#include <cstdint>
+#include <vector>
+#include "PixelFormat.hpp"
+
+namespace ouzel::graphics
+{
+    // Decodes block compressed levels on the CPU for devices that can't sample the format
+    // BC1, BC3, BC4, BC5 and ETC2 (RGB and RGBA with EAC alpha) can be decoded, BC7 and ASTC can't
+    bool isDecodable(PixelFormat pixelFormat) noexcept;
+
+    // BC4 and BC5 are decoded to one and two channel formats, the others to RGBA
+    PixelFormat getDecodedPixelFormat(PixelFormat pixelFormat);
+
+    std::vector<std::uint8_t> decodeLevel(PixelFormat pixelFormat,
+                                          std::uint32_t width,
+                                          std::uint32_t height,
+                                          const std::vector<std::uint8_t>& data);
+}
+
+#endif // OUZEL_GRAPHICS_BLOCKDECODER_HPP
@@ -7,6 +7,7 @@
 #include "RenderDevice.hpp"
 #include "BufferType.hpp"
 #include "Flags.hpp"
+#include "../utils/Span.hpp"
 
 namespace ouzel::graphics
 {
@@ -36,6 +37,10 @@ namespace ouzel::graphics
         void setData(const void* newData, std::uint32_t newSize);
         void setData(const std::vector<std::uint8_t>& newData);
 
+        // returns the memory for the new contents of the buffer, so that they can be written without an extra copy
+        // the memory must be filled before the frame is presented
+        Span<std::uint8_t> reserveData(std::uint32_t newSize);
+
         auto& getResource() const noexcept { return resource; }
 
         auto getType() const noexcept { return type; }
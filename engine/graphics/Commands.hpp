@@ -3,9 +3,15 @@
 #ifndef OUZEL_GRAPHICS_COMMANDS_HPP
 #define OUZEL_GRAPHICS_COMMANDS_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
 #include <set>
 #include <string>
-#include <queue>
+#include <type_traits>
+#include <vector>
 #include "BlendFactor.hpp"
 #include "BlendOperation.hpp"
 #include "BufferType.hpp"
@@ -24,13 +30,20 @@
 #include "Vertex.hpp"
 #include "../math/Color.hpp"
 #include "../math/Rect.hpp"
+#include "../utils/Span.hpp"
 
 namespace ouzel::graphics
 {
     using ResourceId = std::size_t;
 
+    class CommandBuffer;
+
+    // Commands are constructed in place inside of a CommandBuffer and are never deleted through
+    // a base class pointer, so they don't have a virtual destructor. Commands with variable-length
+    // data (hasPayload set to true) store it directly after the command object.
     class Command
     {
+        friend CommandBuffer;
     public:
         enum class Type
         {
@@ -68,14 +81,17 @@ namespace ouzel::graphics
             setLightParameters
         };
 
+        static constexpr bool hasPayload = false;
+
         explicit constexpr Command(Type initType) noexcept:
             type{initType}
         {
         }
 
-        virtual ~Command() = default;
-
         const Type type;
+
+    private:
+        std::uint32_t recordSize = 0; // size of the command including its payload and padding
     };
 
     class ResizeCommand final: public Command
@@ -372,16 +388,48 @@ namespace ouzel::graphics
     class SetBufferDataCommand final: public Command
     {
     public:
+        static constexpr bool hasPayload = true;
+
+        static std::size_t getPayloadSize(ResourceId, Span<const std::uint8_t> data) noexcept
+        {
+            return data.size();
+        }
+
+        static std::size_t getPayloadSize(ResourceId, std::size_t size) noexcept
+        {
+            return size;
+        }
+
         SetBufferDataCommand(ResourceId initBuffer,
-                             const std::vector<std::uint8_t>& initData) noexcept(false):
+                             Span<const std::uint8_t> initData) noexcept:
             Command{Type::setBufferData},
             buffer{initBuffer},
-            data{initData}
+            dataSize{initData.size()}
+        {
+            std::copy(initData.begin(), initData.end(), reinterpret_cast<std::uint8_t*>(this + 1));
+        }
+
+        // leaves the data uninitialized for the caller to write it in place
+        SetBufferDataCommand(ResourceId initBuffer,
+                             std::size_t initSize) noexcept:
+            Command{Type::setBufferData},
+            buffer{initBuffer},
+            dataSize{initSize}
+        {
+        }
+
+        auto getData() const noexcept
+        {
+            return Span<const std::uint8_t>{reinterpret_cast<const std::uint8_t*>(this + 1), dataSize};
+        }
+
+        auto getData() noexcept
         {
+            return Span<std::uint8_t>{reinterpret_cast<std::uint8_t*>(this + 1), dataSize};
         }
 
         const ResourceId buffer;
-        const std::vector<std::uint8_t> data;
+        const std::size_t dataSize;
     };
 
     class InitShaderCommand final: public Command
@@ -420,16 +468,74 @@ namespace ouzel::graphics
     class SetShaderConstantsCommand final: public Command
     {
     public:
-        SetShaderConstantsCommand(std::vector<std::vector<float>> initFragmentShaderConstants,
-                                  std::vector<std::vector<float>> initVertexShaderConstants) noexcept(false):
+        static constexpr bool hasPayload = true;
+
+        static std::size_t getPayloadSize(const std::vector<std::vector<float>>& fragmentShaderConstants,
+                                          const std::vector<std::vector<float>>& vertexShaderConstants) noexcept
+        {
+            std::size_t result = (fragmentShaderConstants.size() + vertexShaderConstants.size()) * sizeof(Range);
+
+            for (const auto& constant : fragmentShaderConstants)
+                result += constant.size() * sizeof(float);
+
+            for (const auto& constant : vertexShaderConstants)
+                result += constant.size() * sizeof(float);
+
+            return result;
+        }
+
+        SetShaderConstantsCommand(const std::vector<std::vector<float>>& initFragmentShaderConstants,
+                                  const std::vector<std::vector<float>>& initVertexShaderConstants) noexcept:
             Command{Type::setShaderConstants},
-            fragmentShaderConstants{initFragmentShaderConstants},
-            vertexShaderConstants{initVertexShaderConstants}
+            fragmentShaderConstantCount{static_cast<std::uint32_t>(initFragmentShaderConstants.size())},
+            vertexShaderConstantCount{static_cast<std::uint32_t>(initVertexShaderConstants.size())}
+        {
+            // the payload is a table of ranges followed by the values of all constants
+            auto range = reinterpret_cast<Range*>(this + 1);
+            const auto values = reinterpret_cast<float*>(range + fragmentShaderConstantCount + vertexShaderConstantCount);
+            std::uint32_t offset = 0;
+
+            for (const auto& constant : initFragmentShaderConstants)
+            {
+                *range++ = Range{offset, static_cast<std::uint32_t>(constant.size())};
+                std::copy(constant.begin(), constant.end(), values + offset);
+                offset += static_cast<std::uint32_t>(constant.size());
+            }
+
+            for (const auto& constant : initVertexShaderConstants)
+            {
+                *range++ = Range{offset, static_cast<std::uint32_t>(constant.size())};
+                std::copy(constant.begin(), constant.end(), values + offset);
+                offset += static_cast<std::uint32_t>(constant.size());
+            }
+        }
+
+        Span<const float> getFragmentShaderConstant(std::size_t index) const noexcept
         {
+            return getConstant(index);
         }
 
-        const std::vector<std::vector<float>> fragmentShaderConstants;
-        const std::vector<std::vector<float>> vertexShaderConstants;
+        Span<const float> getVertexShaderConstant(std::size_t index) const noexcept
+        {
+            return getConstant(fragmentShaderConstantCount + index);
+        }
+
+        const std::uint32_t fragmentShaderConstantCount;
+        const std::uint32_t vertexShaderConstantCount;
+
+    private:
+        struct Range final
+        {
+            std::uint32_t offset;
+            std::uint32_t size;
+        };
+
+        Span<const float> getConstant(std::size_t index) const noexcept
+        {
+            const auto ranges = reinterpret_cast<const Range*>(this + 1);
+            const auto values = reinterpret_cast<const float*>(ranges + fragmentShaderConstantCount + vertexShaderConstantCount);
+            return Span<const float>{values + ranges[index].offset, ranges[index].size};
+        }
     };
 
     class InitTextureCommand final: public Command
@@ -487,9 +593,22 @@ namespace ouzel::graphics
         {
         }
 
+        // updates only the rectangle of the first level at the offset, the level holds its size and data
+        SetTextureDataCommand(ResourceId initTexture,
+                              const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& initLevels,
+                              const math::Vector<std::uint32_t, 2>& initOffset) noexcept(false):
+            Command{Type::setTextureData},
+            texture{initTexture},
+            levels{initLevels},
+            face{CubeFace::positiveX},
+            offset{initOffset}
+        {
+        }
+
         const ResourceId texture;
         const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levels;
         const CubeFace face;
+        const math::Vector<std::uint32_t, 2> offset{};
     };
 
     class SetTextureParametersCommand final: public Command
@@ -525,15 +644,31 @@ namespace ouzel::graphics
     class SetTexturesCommand final: public Command
     {
     public:
-        explicit SetTexturesCommand(const std::vector<ResourceId>& initTextures) noexcept(false):
+        static constexpr bool hasPayload = true;
+
+        static std::size_t getPayloadSize(Span<const ResourceId> textures) noexcept
+        {
+            return textures.sizeBytes();
+        }
+
+        explicit SetTexturesCommand(Span<const ResourceId> initTextures) noexcept:
             Command{Type::setTextures},
-            textures{initTextures}
+            textureCount{initTextures.size()}
         {
+            std::copy(initTextures.begin(), initTextures.end(), reinterpret_cast<ResourceId*>(this + 1));
         }
 
-        const std::vector<ResourceId> textures;
+        auto getTextures() const noexcept
+        {
+            return Span<const ResourceId>{reinterpret_cast<const ResourceId*>(this + 1), textureCount};
+        }
+
+        const std::size_t textureCount;
     };
 
+    static_assert(sizeof(SetShaderConstantsCommand) % alignof(float) == 0);
+    static_assert(sizeof(SetTexturesCommand) % alignof(ResourceId) == 0);
+
     class InitRenderPassCommand final: public Command
     {
     public:
@@ -564,39 +699,219 @@ namespace ouzel::graphics
         const std::set<ResourceId> renderTargets;
     };
 
+    // Destroys the members of commands that own heap memory (resource initialization commands)
+    inline void destroyCommand(Command& command) noexcept
+    {
+        switch (command.type)
+        {
+            case Command::Type::initRenderTarget:
+                static_cast<InitRenderTargetCommand&>(command).~InitRenderTargetCommand();
+                break;
+            case Command::Type::initBuffer:
+                static_cast<InitBufferCommand&>(command).~InitBufferCommand();
+                break;
+            case Command::Type::initShader:
+                static_cast<InitShaderCommand&>(command).~InitShaderCommand();
+                break;
+            case Command::Type::initTexture:
+                static_cast<InitTextureCommand&>(command).~InitTextureCommand();
+                break;
+            case Command::Type::setTextureData:
+                static_cast<SetTextureDataCommand&>(command).~SetTextureDataCommand();
+                break;
+            case Command::Type::initRenderPass:
+                static_cast<InitRenderPassCommand&>(command).~InitRenderPassCommand();
+                break;
+            case Command::Type::setRenderPassParameters:
+                static_cast<SetRenderPassParametersCommand&>(command).~SetRenderPassParametersCommand();
+                break;
+            default: // all the other commands are trivially destructible
+                break;
+        }
+    }
+
+    // Linear arena of commands. Memory blocks are kept when the buffer is cleared, so a buffer
+    // that is recycled every frame doesn't allocate once it has grown to the size of a frame.
     class CommandBuffer final
     {
     public:
+        static constexpr std::size_t alignment = alignof(std::max_align_t);
+        static constexpr std::size_t blockSize = 64U * 1024U;
+
         CommandBuffer() = default;
         explicit CommandBuffer(const std::string& initName) noexcept(false):
             name{initName}
         {
         }
 
+        ~CommandBuffer()
+        {
+            clear();
+        }
+
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+        CommandBuffer(CommandBuffer&& other) noexcept:
+            name{std::move(other.name)},
+            blocks{std::move(other.blocks)},
+            writeBlock{other.writeBlock},
+            readBlock{other.readBlock},
+            readOffset{other.readOffset},
+            commandCount{other.commandCount},
+            readCount{other.readCount}
+        {
+            other.blocks.clear();
+            other.writeBlock = other.readBlock = other.readOffset = 0;
+            other.commandCount = other.readCount = 0;
+        }
+
+        CommandBuffer& operator=(CommandBuffer&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            clear();
+
+            name = std::move(other.name);
+            blocks = std::move(other.blocks);
+            writeBlock = other.writeBlock;
+            readBlock = other.readBlock;
+            readOffset = other.readOffset;
+            commandCount = other.commandCount;
+            readCount = other.readCount;
+
+            other.blocks.clear();
+            other.writeBlock = other.readBlock = other.readOffset = 0;
+            other.commandCount = other.readCount = 0;
+
+            return *this;
+        }
+
         auto& getName() const noexcept { return name; }
 
-        auto isEmpty() const noexcept { return commands.empty(); }
+        auto isEmpty() const noexcept { return readCount == commandCount; }
+        auto getCommandCount() const noexcept { return commandCount; }
+        auto getBlockCount() const noexcept { return blocks.size(); }
 
-        void pushCommand(std::unique_ptr<Command> command)
+        // returns the new command, it stays valid until the buffer is cleared
+        template <class T, class ...Args>
+        T& pushCommand(Args&&... args)
         {
-            commands.push(std::move(command));
+            static_assert(std::is_base_of_v<Command, T>);
+            static_assert(alignof(T) <= alignment);
+
+            std::size_t size = sizeof(T);
+            if constexpr (T::hasPayload) size += T::getPayloadSize(args...);
+            size = (size + alignment - 1) & ~(alignment - 1);
+
+            auto& block = reserve(size);
+            const auto command = new(block.data.get() + block.size) T(std::forward<Args>(args)...);
+            command->recordSize = static_cast<std::uint32_t>(size);
+            block.size += size;
+            ++commandCount;
+            return *command;
         }
 
-        std::unique_ptr<Command> popCommand()
+        // Returns the next command, the command stays valid until the buffer is cleared
+        const Command* popCommand() noexcept
         {
-            auto result = std::move(commands.front());
-            commands.pop();
-            return result;
+            while (readOffset == blocks[readBlock].size)
+            {
+                ++readBlock;
+                readOffset = 0;
+            }
+
+            const auto command = reinterpret_cast<const Command*>(blocks[readBlock].data.get() + readOffset);
+            readOffset += command->recordSize;
+            ++readCount;
+            return command;
         }
 
-        auto& getCommands() const
+        // Destroys all commands but keeps the memory for reuse
+        void clear() noexcept
         {
-            return commands;
+            for (auto& block : blocks)
+            {
+                for (std::size_t offset = 0; offset < block.size;)
+                {
+                    const auto command = reinterpret_cast<Command*>(block.data.get() + offset);
+                    offset += command->recordSize;
+                    destroyCommand(*command);
+                }
+
+                block.size = 0;
+            }
+
+            // release the blocks that were allocated for oversized commands
+            blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [](const Block& block) noexcept {
+                return block.capacity > blockSize;
+            }), blocks.end());
+
+            writeBlock = readBlock = readOffset = 0;
+            commandCount = readCount = 0;
+        }
+
+        // Moves the commands of the other buffer after the commands of this one,
+        // neither of the buffers must have been read from
+        void append(CommandBuffer&& other)
+        {
+            if (&other == this) return;
+
+            const auto firstBlock = blocks.size();
+            blocks.reserve(blocks.size() + other.blocks.size());
+            for (auto& block : other.blocks)
+                blocks.push_back(std::move(block));
+
+            writeBlock = firstBlock + other.writeBlock;
+            commandCount += other.commandCount;
+
+            other.blocks.clear();
+            other.writeBlock = other.readBlock = other.readOffset = 0;
+            other.commandCount = other.readCount = 0;
         }
 
     private:
+        struct Block final
+        {
+            std::unique_ptr<std::byte[]> data;
+            std::size_t capacity = 0;
+            std::size_t size = 0;
+        };
+
+        Block& reserve(std::size_t size)
+        {
+            if (size > blockSize)
+            {
+                // Oversized commands don't fit into any of the regular blocks, so they get a block of their own.
+                // It is inserted before the next unused block, which would otherwise be skipped and stay empty.
+                const auto position = (writeBlock < blocks.size() && blocks[writeBlock].size > 0) ?
+                    writeBlock + 1 : writeBlock;
+
+                Block block;
+                block.capacity = size;
+                block.data = std::unique_ptr<std::byte[]>(new std::byte[block.capacity]);
+                writeBlock = position;
+                return *blocks.insert(blocks.begin() + static_cast<std::ptrdiff_t>(position), std::move(block));
+            }
+
+            for (; writeBlock < blocks.size(); ++writeBlock)
+                if (blocks[writeBlock].capacity - blocks[writeBlock].size >= size)
+                    return blocks[writeBlock];
+
+            Block block;
+            block.capacity = blockSize;
+            block.data = std::unique_ptr<std::byte[]>(new std::byte[block.capacity]);
+            blocks.push_back(std::move(block));
+            return blocks.back();
+        }
+
         std::string name;
-        std::queue<std::unique_ptr<Command>> commands;
+        std::vector<Block> blocks;
+        std::size_t writeBlock = 0;
+        std::size_t readBlock = 0;
+        std::size_t readOffset = 0;
+        std::size_t commandCount = 0;
+        std::size_t readCount = 0;
     };
 }
 
@@ -163,7 +163,7 @@ namespace ouzel::graphics
     {
         size = newSize;
 
-        addCommand(std::make_unique<ResizeCommand>(newSize));
+        addCommand<ResizeCommand>(newSize);
     }
 
     void Graphics::saveScreenshot(const std::string& filename)
@@ -173,7 +173,7 @@ namespace ouzel::graphics
 
     void Graphics::setRenderTarget(std::size_t renderTarget)
     {
-        addCommand(std::make_unique<SetRenderTargetCommand>(renderTarget));
+        addCommand<SetRenderTargetCommand>(renderTarget);
     }
 
     void Graphics::clearRenderTarget(bool clearColorBuffer,
@@ -183,29 +183,29 @@ namespace ouzel::graphics
                                      float clearDepth,
                                      std::uint32_t clearStencil)
     {
-        addCommand(std::make_unique<ClearRenderTargetCommand>(clearColorBuffer,
-                                                              clearDepthBuffer,
-                                                              clearStencilBuffer,
-                                                              clearColor,
-                                                              clearDepth,
-                                                              clearStencil));
+        addCommand<ClearRenderTargetCommand>(clearColorBuffer,
+                                             clearDepthBuffer,
+                                             clearStencilBuffer,
+                                             clearColor,
+                                             clearDepth,
+                                             clearStencil);
     }
 
     void Graphics::setScissorTest(bool enabled, const math::Rect<float>& rectangle)
     {
-        addCommand(std::make_unique<SetScissorTestCommand>(enabled, rectangle));
+        addCommand<SetScissorTestCommand>(enabled, rectangle);
     }
 
     void Graphics::setViewport(const math::Rect<float>& viewport)
     {
-        addCommand(std::make_unique<SetViewportCommand>(viewport));
+        addCommand<SetViewportCommand>(viewport);
     }
 
     void Graphics::setDepthStencilState(std::size_t depthStencilState,
                                         std::uint32_t stencilReferenceValue)
     {
-        addCommand(std::make_unique<SetDepthStencilStateCommand>(depthStencilState,
-                                                                 stencilReferenceValue));
+        addCommand<SetDepthStencilStateCommand>(depthStencilState,
+                                                stencilReferenceValue);
     }
 
     void Graphics::setPipelineState(std::size_t blendState,
@@ -213,10 +213,10 @@ namespace ouzel::graphics
                                     CullMode cullMode,
                                     FillMode fillMode)
     {
-        addCommand(std::make_unique<SetPipelineStateCommand>(blendState,
-                                                             shader,
-                                                             cullMode,
-                                                             fillMode));
+        addCommand<SetPipelineStateCommand>(blendState,
+                                            shader,
+                                            cullMode,
+                                            fillMode);
     }
 
     void Graphics::draw(std::size_t indexBuffer,
@@ -229,31 +229,36 @@ namespace ouzel::graphics
         if (!indexBuffer || !vertexBuffer)
             throw Error{"Invalid mesh buffer passed to render queue"};
 
-        addCommand(std::make_unique<DrawCommand>(indexBuffer,
-                                                 indexCount,
-                                                 indexSize,
-                                                 vertexBuffer,
-                                                 drawMode,
-                                                 startIndex));
+        addCommand<DrawCommand>(indexBuffer,
+                                indexCount,
+                                indexSize,
+                                vertexBuffer,
+                                drawMode,
+                                startIndex);
     }
 
     void Graphics::setShaderConstants(const std::vector<std::vector<float>>& fragmentShaderConstants,
                                       const std::vector<std::vector<float>>& vertexShaderConstants)
     {
-        addCommand(std::make_unique<SetShaderConstantsCommand>(fragmentShaderConstants,
-                                                               vertexShaderConstants));
+        addCommand<SetShaderConstantsCommand>(fragmentShaderConstants,
+                                              vertexShaderConstants);
     }
 
     void Graphics::setTextures(const std::vector<std::size_t>& textures)
     {
-        addCommand(std::make_unique<SetTexturesCommand>(textures));
+        addCommand<SetTexturesCommand>(textures);
     }
 
     void Graphics::present()
     {
-        addCommand(std::make_unique<PresentCommand>());
+        spriteBatcher.flush();
+        device->batchCount = spriteBatcher.getBatchCount();
+        device->batchedSpriteCount = spriteBatcher.getSpriteCount();
+        spriteBatcher.reset();
+
+        addCommand<PresentCommand>();
         device->submitCommandBuffer(std::move(commandBuffer));
-        commandBuffer = CommandBuffer();
+        commandBuffer = device->getFreeCommandBuffer();
     }
 
     bool Graphics::getRefillQueue(bool waitForNextFrame) const
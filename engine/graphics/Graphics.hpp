@@ -12,6 +12,7 @@
 #include "Driver.hpp"
 #include "RenderDevice.hpp"
 #include "Settings.hpp"
+#include "SpriteBatcher.hpp"
 #include "../math/Rect.hpp"
 #include "../math/Matrix.hpp"
 #include "../math/Size.hpp"
@@ -38,6 +39,8 @@ namespace ouzel::graphics
 
         auto getDevice() const noexcept { return device.get(); }
 
+        auto& getSpriteBatcher() noexcept { return spriteBatcher; }
+
         auto& getSize() const noexcept { return size; }
 
         auto getTextureFilter() const noexcept { return textureFilter; }
@@ -70,9 +73,13 @@ namespace ouzel::graphics
                                 const std::vector<std::vector<float>>& vertexShaderConstants);
         void setTextures(const std::vector<std::size_t>& textures);
 
-        void addCommand(std::unique_ptr<Command> command)
+        template <class T, class ...Args>
+        T& addCommand(Args&&... args)
         {
-            commandBuffer.pushCommand(std::move(command));
+            // batched sprites have to be drawn before any other command
+            if (spriteBatcher.hasPendingSprites()) spriteBatcher.flush();
+
+            return commandBuffer.pushCommand<T>(std::forward<Args>(args)...);
         }
         void present();
 
@@ -105,6 +112,7 @@ namespace ouzel::graphics
         CommandBuffer commandBuffer;
 
         std::unique_ptr<RenderDevice> device;
+        SpriteBatcher spriteBatcher{*this};
     };
 }
 
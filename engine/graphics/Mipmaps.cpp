@@ -0,0 +1,607 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include "Mipmaps.hpp"
+#include "GraphicsError.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+#  include <xmmintrin.h>
+#elif defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#endif
+
+namespace ouzel::graphics
+{
+    namespace
+    {
+        constexpr float gamma = 2.2F;
+        constexpr float gammaLookup[256] = {
+            0.0F, 5.077051355e-06F, 2.33280025e-05F, 5.692175546e-05F, 0.0001071873558F, 0.0001751239615F, 0.0002615437261F, 0.0003671362065F,
+            0.0004925037501F, 0.0006381827989F, 0.0008046584553F, 0.0009923742618F, 0.001201739418F, 0.001433134428F, 0.001686915057F, 0.001963415882F,
+            0.002262953203F, 0.00258582551F, 0.002932318253F, 0.003302702913F, 0.003697239328F, 0.004116177093F, 0.00455975486F, 0.00502820313F,
+            0.00552174449F, 0.006040593144F, 0.006584956776F, 0.007155036554F, 0.007751026656F, 0.008373117074F, 0.009021490812F, 0.009696328081F,
+            0.01039780304F, 0.01112608239F, 0.01188133471F, 0.01266372018F, 0.01347339712F, 0.01431051921F, 0.01517523825F, 0.01606770046F,
+            0.01698805206F, 0.01793643273F, 0.0189129822F, 0.01991783828F, 0.02095113136F, 0.02201299369F, 0.02310355566F, 0.02422294207F,
+            0.02537127584F, 0.02654868178F, 0.02775527909F, 0.02899118513F, 0.03025651723F, 0.03155139089F, 0.03287591413F, 0.03423020616F,
+            0.03561436757F, 0.03702851385F, 0.03847274557F, 0.03994716704F, 0.04145189002F, 0.04298700765F, 0.04455262423F, 0.04614884034F,
+            0.04777575657F, 0.04943346232F, 0.05112205446F, 0.05284162983F, 0.05459228158F, 0.05637409911F, 0.05818717927F, 0.06003161147F,
+            0.06190747768F, 0.06381487101F, 0.06575388461F, 0.06772459298F, 0.06972708553F, 0.07176145166F, 0.07382776588F, 0.07592612505F,
+            0.07805658877F, 0.08021926135F, 0.08241420984F, 0.08464150876F, 0.08690125495F, 0.08919350803F, 0.0915183574F, 0.09387587011F,
+            0.09626612067F, 0.09868919849F, 0.1011451632F, 0.1036340967F, 0.1061560661F, 0.1087111533F, 0.1112994179F, 0.1139209345F,
+            0.1165757775F, 0.1192640141F, 0.1219857112F, 0.1247409433F, 0.1275297701F, 0.1303522736F, 0.1332085133F, 0.1360985488F,
+            0.1390224546F, 0.1419802904F, 0.1449721307F, 0.1479980201F, 0.151058048F, 0.1541522592F, 0.1572807282F, 0.1604435146F,
+            0.163640663F, 0.166872263F, 0.170138374F, 0.1734390259F, 0.176774323F, 0.1801442802F, 0.1835489869F, 0.1869885027F,
+            0.1904628724F, 0.1939721555F, 0.1975164264F, 0.2010957301F, 0.204710111F, 0.2083596438F, 0.2120443881F, 0.2157643884F,
+            0.2195197344F, 0.2233104259F, 0.2271365523F, 0.2309981436F, 0.234895274F, 0.2388280034F, 0.2427963763F, 0.2468004376F,
+            0.2508402467F, 0.2549158633F, 0.2590273619F, 0.2631747425F, 0.2673580945F, 0.2715774477F, 0.2758328617F, 0.2801243961F,
+            0.2844520807F, 0.288816005F, 0.2932161689F, 0.2976526618F, 0.3021255136F, 0.3066347837F, 0.311180532F, 0.3157627583F,
+            0.3203815818F, 0.3250369728F, 0.3297290504F, 0.3344578147F, 0.3392233551F, 0.3440256715F, 0.3488648534F, 0.3537409306F,
+            0.3586539328F, 0.3636039197F, 0.368590951F, 0.3736150563F, 0.3786762655F, 0.383774668F, 0.3889102638F, 0.3940831423F,
+            0.3992933333F, 0.4045408368F, 0.409825772F, 0.4151481092F, 0.4205079377F, 0.4259053171F, 0.4313402176F, 0.4368127584F,
+            0.4423229694F, 0.4478708506F, 0.4534564912F, 0.4590799212F, 0.4647411406F, 0.4704402685F, 0.4761772752F, 0.48195225F,
+            0.4877652228F, 0.4936162233F, 0.4995052814F, 0.5054324865F, 0.5113978386F, 0.5174013972F, 0.5234431624F, 0.5295232534F,
+            0.5356416106F, 0.5417983532F, 0.5479935408F, 0.5542271137F, 0.5604991913F, 0.5668097734F, 0.5731588602F, 0.5795466304F,
+            0.5859730244F, 0.5924380422F, 0.598941803F, 0.6054843068F, 0.6120656133F, 0.6186857224F, 0.6253447533F, 0.6320426464F,
+            0.6387794614F, 0.6455552578F, 0.6523700953F, 0.6592240334F, 0.6661169529F, 0.6730490923F, 0.6800203323F, 0.6870308518F,
+            0.6940805316F, 0.7011694908F, 0.7082977891F, 0.7154654264F, 0.7226724625F, 0.7299188972F, 0.7372047901F, 0.744530201F,
+            0.7518950701F, 0.7592995763F, 0.7667436004F, 0.7742273211F, 0.781750679F, 0.7893137336F, 0.7969165444F, 0.8045591116F,
+            0.8122414947F, 0.8199636936F, 0.8277258277F, 0.8355277777F, 0.8433697224F, 0.8512516618F, 0.8591735959F, 0.8671355247F,
+            0.8751375675F, 0.8831797242F, 0.8912620544F, 0.8993844986F, 0.9075471759F, 0.9157501459F, 0.9239933491F, 0.932276845F,
+            0.9406006932F, 0.9489649534F, 0.957369566F, 0.9658146501F, 0.9743002057F, 0.9828262329F, 0.9913928509F, 1.0F
+        };
+
+        // encoded values are rounded, so a value is encoded to the number of midpoints between the encoded values below it
+        const std::array<float, 255> gammaThresholds = []() {
+            std::array<float, 255> result{};
+            for (std::size_t i = 0; i < result.size(); ++i)
+                result[i] = std::pow((static_cast<float>(i) + 0.5F) / 255.0F, gamma);
+            return result;
+        }();
+
+        // the first threshold is above 2^-20, the values are bucketed by their exponent and seven highest mantissa bits,
+        // which makes the buckets narrower than the distances between the thresholds
+        constexpr std::uint32_t gammaBucketShift = 16;
+        constexpr std::uint32_t gammaFirstBucket = (127U - 20U) << 7;
+        constexpr std::uint32_t gammaBucketCount = 20U << 7;
+
+        // the number of the thresholds below the start of every bucket
+        const std::array<std::uint8_t, gammaBucketCount> gammaBuckets = []() {
+            std::array<std::uint8_t, gammaBucketCount> result{};
+            for (std::uint32_t i = 0; i < result.size(); ++i)
+            {
+                const std::uint32_t bits = (gammaFirstBucket + i) << gammaBucketShift;
+                float start;
+                std::memcpy(&start, &bits, sizeof(start));
+                result[i] = static_cast<std::uint8_t>(std::upper_bound(gammaThresholds.begin(), gammaThresholds.end(), start) -
+                                                      gammaThresholds.begin());
+            }
+            return result;
+        }();
+
+        // levels are split into bands of rows for the worker pool once they are big enough to amortize the scheduling
+        constexpr std::size_t parallelPixelCount = 64U * 1024U;
+
+        template <class F>
+        void forEachRowBand(core::WorkerPool& workerPool, const math::Size<std::uint32_t, 2>& size, const F& function)
+        {
+            const auto grain = std::max(parallelPixelCount / std::max(size.v[0], 1U), std::size_t{1});
+            workerPool.parallelFor(0, size.v[1], grain, function);
+        }
+
+#if defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+        // sums the adjacent values of a and b
+        inline __m128 sumPairs(const __m128 a, const __m128 b) noexcept
+        {
+            return _mm_add_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)),
+                              _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+
+        // sums the adjacent two-channel pixels of a and b
+        inline __m128 sumPixelPairs(const __m128 a, const __m128 b) noexcept
+        {
+            return _mm_add_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 1, 0)),
+                              _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 2, 3, 2)));
+        }
+#elif defined(__ARM_NEON__)
+        inline float32x4_t sumPairs(const float32x4_t a, const float32x4_t b) noexcept
+        {
+            const auto values = vuzpq_f32(a, b);
+            return vaddq_f32(values.val[0], values.val[1]);
+        }
+
+        inline float32x4_t sumPixelPairs(const float32x4_t a, const float32x4_t b) noexcept
+        {
+            return vaddq_f32(vcombine_f32(vget_low_f32(a), vget_low_f32(b)),
+                             vcombine_f32(vget_high_f32(a), vget_high_f32(b)));
+        }
+
+        inline float32x4_t select(const float32x4_t values, const uint32x4_t mask) noexcept
+        {
+            return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(values), mask));
+        }
+
+        inline float32x4_t divide(const float32x4_t a, const float32x4_t b) noexcept
+        {
+#  ifdef __aarch64__
+            return vdivq_f32(a, b);
+#  else
+            // two Newton-Raphson steps refine the estimate to full precision
+            auto reciprocal = vrecpeq_f32(b);
+            reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+            reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+            return vmulq_f32(a, reciprocal);
+#  endif
+        }
+#endif
+
+        // averages the 2x2 blocks of a row of single-channel pixels, pitch is the distance between the source rows
+        void downsampleRowR8(const float* src, const std::size_t pitch,
+                             float* dst, const std::uint32_t dstWidth) noexcept
+        {
+            std::uint32_t x = 0;
+
+#if defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+            const auto quarter = _mm_set1_ps(0.25F);
+            for (; x + 4 <= dstWidth; x += 4, src += 8, dst += 4)
+            {
+                const auto first = _mm_add_ps(_mm_loadu_ps(src), _mm_loadu_ps(src + pitch));
+                const auto second = _mm_add_ps(_mm_loadu_ps(src + 4), _mm_loadu_ps(src + pitch + 4));
+                _mm_storeu_ps(dst, _mm_mul_ps(sumPairs(first, second), quarter));
+            }
+#elif defined(__ARM_NEON__)
+            const auto quarter = vdupq_n_f32(0.25F);
+            for (; x + 4 <= dstWidth; x += 4, src += 8, dst += 4)
+            {
+                const auto first = vaddq_f32(vld1q_f32(src), vld1q_f32(src + pitch));
+                const auto second = vaddq_f32(vld1q_f32(src + 4), vld1q_f32(src + pitch + 4));
+                vst1q_f32(dst, vmulq_f32(sumPairs(first, second), quarter));
+            }
+#endif
+
+            for (; x < dstWidth; ++x, src += 2, dst += 1)
+                dst[0] = (src[0] + src[1] + src[pitch + 0] + src[pitch + 1]) / 4.0F;
+        }
+
+        // averages the 2x2 blocks of a row of two-channel pixels, pitch is the distance between the source rows
+        void downsampleRowRg8(const float* src, const std::size_t pitch,
+                              float* dst, const std::uint32_t dstWidth) noexcept
+        {
+            std::uint32_t x = 0;
+
+#if defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+            const auto quarter = _mm_set1_ps(0.25F);
+            for (; x + 2 <= dstWidth; x += 2, src += 8, dst += 4)
+            {
+                const auto first = _mm_add_ps(_mm_loadu_ps(src), _mm_loadu_ps(src + pitch));
+                const auto second = _mm_add_ps(_mm_loadu_ps(src + 4), _mm_loadu_ps(src + pitch + 4));
+                _mm_storeu_ps(dst, _mm_mul_ps(sumPixelPairs(first, second), quarter));
+            }
+#elif defined(__ARM_NEON__)
+            const auto quarter = vdupq_n_f32(0.25F);
+            for (; x + 2 <= dstWidth; x += 2, src += 8, dst += 4)
+            {
+                const auto first = vaddq_f32(vld1q_f32(src), vld1q_f32(src + pitch));
+                const auto second = vaddq_f32(vld1q_f32(src + 4), vld1q_f32(src + pitch + 4));
+                vst1q_f32(dst, vmulq_f32(sumPixelPairs(first, second), quarter));
+            }
+#endif
+
+            for (; x < dstWidth; ++x, src += 4, dst += 2)
+            {
+                dst[0] = (src[0] + src[2] + src[pitch + 0] + src[pitch + 2]) / 4.0F;
+                dst[1] = (src[1] + src[3] + src[pitch + 1] + src[pitch + 3]) / 4.0F;
+            }
+        }
+
+        // averages a 2x2 block of RGBA pixels, the color of the transparent pixels is ignored
+        void averageRgba8(const float* pixel, const std::size_t pitch, float* dst) noexcept
+        {
+#if defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+            const auto zero = _mm_setzero_ps();
+            const auto one = _mm_set1_ps(1.0F);
+
+            const auto p0 = _mm_loadu_ps(pixel);
+            const auto p1 = _mm_loadu_ps(pixel + 4);
+            const auto p2 = _mm_loadu_ps(pixel + pitch);
+            const auto p3 = _mm_loadu_ps(pixel + pitch + 4);
+
+            const auto m0 = _mm_cmpgt_ps(_mm_shuffle_ps(p0, p0, _MM_SHUFFLE(3, 3, 3, 3)), zero);
+            const auto m1 = _mm_cmpgt_ps(_mm_shuffle_ps(p1, p1, _MM_SHUFFLE(3, 3, 3, 3)), zero);
+            const auto m2 = _mm_cmpgt_ps(_mm_shuffle_ps(p2, p2, _MM_SHUFFLE(3, 3, 3, 3)), zero);
+            const auto m3 = _mm_cmpgt_ps(_mm_shuffle_ps(p3, p3, _MM_SHUFFLE(3, 3, 3, 3)), zero);
+
+            const auto color = _mm_add_ps(_mm_add_ps(_mm_and_ps(p0, m0), _mm_and_ps(p1, m1)),
+                                          _mm_add_ps(_mm_and_ps(p2, m2), _mm_and_ps(p3, m3)));
+            const auto pixels = _mm_add_ps(_mm_add_ps(_mm_and_ps(one, m0), _mm_and_ps(one, m1)),
+                                           _mm_add_ps(_mm_and_ps(one, m2), _mm_and_ps(one, m3)));
+            const auto alpha = _mm_mul_ps(_mm_add_ps(_mm_add_ps(p0, p1), _mm_add_ps(p2, p3)), _mm_set1_ps(0.25F));
+
+            // the color sum is zero if none of the pixels is visible
+            const auto average = _mm_div_ps(color, _mm_max_ps(pixels, one));
+
+            // (r, g, b) of the average and the alpha of the sum
+            const auto blueAlpha = _mm_shuffle_ps(average, alpha, _MM_SHUFFLE(3, 3, 2, 2));
+            _mm_storeu_ps(dst, _mm_shuffle_ps(average, blueAlpha, _MM_SHUFFLE(2, 0, 1, 0)));
+#elif defined(__ARM_NEON__)
+            const auto zero = vdupq_n_f32(0.0F);
+            const auto one = vdupq_n_f32(1.0F);
+
+            const auto p0 = vld1q_f32(pixel);
+            const auto p1 = vld1q_f32(pixel + 4);
+            const auto p2 = vld1q_f32(pixel + pitch);
+            const auto p3 = vld1q_f32(pixel + pitch + 4);
+
+            const auto m0 = vcgtq_f32(vdupq_n_f32(vgetq_lane_f32(p0, 3)), zero);
+            const auto m1 = vcgtq_f32(vdupq_n_f32(vgetq_lane_f32(p1, 3)), zero);
+            const auto m2 = vcgtq_f32(vdupq_n_f32(vgetq_lane_f32(p2, 3)), zero);
+            const auto m3 = vcgtq_f32(vdupq_n_f32(vgetq_lane_f32(p3, 3)), zero);
+
+            const auto color = vaddq_f32(vaddq_f32(select(p0, m0), select(p1, m1)),
+                                         vaddq_f32(select(p2, m2), select(p3, m3)));
+            const auto pixels = vaddq_f32(vaddq_f32(select(one, m0), select(one, m1)),
+                                          vaddq_f32(select(one, m2), select(one, m3)));
+            const auto alpha = vgetq_lane_f32(vaddq_f32(vaddq_f32(p0, p1), vaddq_f32(p2, p3)), 3) / 4.0F;
+
+            // the color sum is zero if none of the pixels is visible
+            const auto average = divide(color, vmaxq_f32(pixels, one));
+            vst1q_f32(dst, vsetq_lane_f32(alpha, average, 3));
+#else
+            float pixels = 0.0F;
+            float r = 0.0F;
+            float g = 0.0F;
+            float b = 0.0F;
+            float a = 0.0F;
+
+            for (const auto* p : {pixel, pixel + 4, pixel + pitch, pixel + pitch + 4})
+            {
+                if (p[3] > 0.0F)
+                {
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                    pixels += 1.0F;
+                }
+                a += p[3];
+            }
+
+            if (pixels > 0.0F)
+            {
+                dst[0] = r / pixels;
+                dst[1] = g / pixels;
+                dst[2] = b / pixels;
+                dst[3] = a / 4.0F;
+            }
+            else
+            {
+                dst[0] = 0;
+                dst[1] = 0;
+                dst[2] = 0;
+                dst[3] = 0;
+            }
+#endif
+        }
+
+        // averages two RGBA pixels of a one pixel wide or high image
+        void averageRgba8(const float* first, const float* second, float* dst) noexcept
+        {
+            float pixels = 0.0F;
+            float r = 0.0F;
+            float g = 0.0F;
+            float b = 0.0F;
+
+            for (const auto* p : {first, second})
+                if (p[3] > 0.0F)
+                {
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                    pixels += 1.0F;
+                }
+
+            if (pixels > 0.0F)
+            {
+                dst[0] = r / pixels;
+                dst[1] = g / pixels;
+                dst[2] = b / pixels;
+                dst[3] = (first[3] + second[3]) / 2.0F;
+            }
+            else
+            {
+                dst[0] = 0;
+                dst[1] = 0;
+                dst[2] = 0;
+                dst[3] = 0;
+            }
+        }
+
+        // the downsample functions fill the rows [firstRow, lastRow) of the resized image
+        void downsample2x2R8(const math::Size<std::uint32_t, 2>& size,
+                             const float* original,
+                             float* resized,
+                             const std::size_t firstRow,
+                             const std::size_t lastRow) noexcept
+        {
+            const std::uint32_t dstWidth = size.v[0] >> 1;
+            const std::uint32_t dstHeight = size.v[1] >> 1;
+            const std::size_t pitch = size.v[0] * 1;
+
+            if (dstWidth > 0 && dstHeight > 0)
+            {
+                for (auto y = firstRow; y < lastRow; ++y)
+                    downsampleRowR8(original + y * 2 * pitch, pitch, resized + y * dstWidth * 1, dstWidth);
+            }
+            else if (dstHeight > 0)
+            {
+                for (auto y = firstRow; y < lastRow; ++y)
+                {
+                    const auto* pixel = original + y * 2 * pitch;
+                    resized[y] = (pixel[0] + pixel[pitch + 0]) / 2.0F;
+                }
+            }
+            else if (dstWidth > 0)
+            {
+                for (std::uint32_t x = 0; x < dstWidth; ++x)
+                    resized[x] = (original[x * 2 + 0] + original[x * 2 + 1]) / 2.0F;
+            }
+        }
+
+        void downsample2x2Rg8(const math::Size<std::uint32_t, 2>& size,
+                              const float* original,
+                              float* resized,
+                              const std::size_t firstRow,
+                              const std::size_t lastRow) noexcept
+        {
+            const std::uint32_t dstWidth = size.v[0] >> 1;
+            const std::uint32_t dstHeight = size.v[1] >> 1;
+            const std::size_t pitch = size.v[0] * 2;
+
+            if (dstWidth > 0 && dstHeight > 0)
+            {
+                for (auto y = firstRow; y < lastRow; ++y)
+                    downsampleRowRg8(original + y * 2 * pitch, pitch, resized + y * dstWidth * 2, dstWidth);
+            }
+            else if (dstHeight > 0)
+            {
+                for (auto y = firstRow; y < lastRow; ++y)
+                {
+                    const auto* pixel = original + y * 2 * pitch;
+                    resized[y * 2 + 0] = (pixel[0] + pixel[pitch + 0]) / 2.0F;
+                    resized[y * 2 + 1] = (pixel[1] + pixel[pitch + 1]) / 2.0F;
+                }
+            }
+            else if (dstWidth > 0)
+            {
+                for (std::uint32_t x = 0; x < dstWidth; ++x)
+                {
+                    const auto* pixel = original + x * 4;
+                    resized[x * 2 + 0] = (pixel[0] + pixel[2]) / 2.0F;
+                    resized[x * 2 + 1] = (pixel[1] + pixel[3]) / 2.0F;
+                }
+            }
+        }
+
+        void downsample2x2Rgba8(const math::Size<std::uint32_t, 2>& size,
+                                const float* original,
+                                float* resized,
+                                const std::size_t firstRow,
+                                const std::size_t lastRow) noexcept
+        {
+            const std::uint32_t dstWidth = size.v[0] >> 1;
+            const std::uint32_t dstHeight = size.v[1] >> 1;
+            const std::size_t pitch = size.v[0] * 4;
+
+            if (dstWidth > 0 && dstHeight > 0)
+            {
+                for (auto y = firstRow; y < lastRow; ++y)
+                {
+                    const auto* pixel = original + y * 2 * pitch;
+                    auto* dst = resized + y * dstWidth * 4;
+                    for (std::uint32_t x = 0; x < dstWidth; ++x, pixel += 8, dst += 4)
+                        averageRgba8(pixel, pitch, dst);
+                }
+            }
+            else if (dstHeight > 0)
+            {
+                for (auto y = firstRow; y < lastRow; ++y)
+                {
+                    const auto* pixel = original + y * 2 * pitch;
+                    averageRgba8(pixel, pixel + pitch, resized + y * 4);
+                }
+            }
+            else if (dstWidth > 0)
+            {
+                for (std::uint32_t x = 0; x < dstWidth; ++x)
+                {
+                    const auto* pixel = original + x * 8;
+                    averageRgba8(pixel, pixel + 4, resized + x * 4);
+                }
+            }
+        }
+
+        [[nodiscard]] float gammaDecode(std::uint8_t value) noexcept
+        {
+            return gammaLookup[value]; // std::pow(value / 255.0F, gamma);
+        }
+
+        [[nodiscard]] std::uint8_t gammaEncode(float value) noexcept
+        {
+            // std::round(std::pow(value, 1.0F / gamma) * 255.0F)
+            if (!(value >= gammaThresholds.front())) return 0; // also handles NaN
+            if (value >= 1.0F) return 255;
+
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+
+            // a bucket contains at most one threshold
+            const std::uint32_t result = gammaBuckets[(bits >> gammaBucketShift) - gammaFirstBucket];
+            return static_cast<std::uint8_t>(result < gammaThresholds.size() && value >= gammaThresholds[result] ? result + 1 : result);
+        }
+
+        void decode(const std::size_t pixelCount,
+                    const std::uint8_t* src,
+                    const PixelFormat pixelFormat,
+                    float* dst)
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::rgba8UnsignedNorm:
+                case PixelFormat::rgba8UnsignedNormSRGB:
+                    for (std::size_t i = 0; i < pixelCount; ++i, src += 4, dst += 4)
+                    {
+                        dst[0] = gammaDecode(src[0]); // red
+                        dst[1] = gammaDecode(src[1]); // green
+                        dst[2] = gammaDecode(src[2]); // blue
+                        dst[3] = src[3] / 255.0F; // alpha
+                    }
+                    break;
+                case PixelFormat::rg8UnsignedNorm:
+                    for (std::size_t i = 0; i < pixelCount; ++i, src += 2, dst += 2)
+                    {
+                        dst[0] = gammaDecode(src[0]); // red
+                        dst[1] = gammaDecode(src[1]); // green
+                    }
+                    break;
+                case PixelFormat::r8UnsignedNorm:
+                    for (std::size_t i = 0; i < pixelCount; ++i, src += 1, dst += 1)
+                        dst[0] = gammaDecode(src[0]); // red
+                    break;
+                case PixelFormat::a8UnsignedNorm:
+                    for (std::size_t i = 0; i < pixelCount; ++i, src += 1, dst += 1)
+                        dst[0] = src[0] / 255.0F; // alpha
+                    break;
+                default:
+                    throw Error{"Invalid pixel format"};
+            }
+        }
+
+        void encode(const std::size_t pixelCount,
+                    const float* src,
+                    const PixelFormat pixelFormat,
+                    std::uint8_t* dst)
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::rgba8UnsignedNorm:
+                case PixelFormat::rgba8UnsignedNormSRGB:
+                    for (std::size_t i = 0; i < pixelCount; ++i, src += 4, dst += 4)
+                    {
+                        dst[0] = gammaEncode(src[0]); // red
+                        dst[1] = gammaEncode(src[1]); // green
+                        dst[2] = gammaEncode(src[2]); // blue
+                        dst[3] = static_cast<std::uint8_t>(src[3] * 255.0F + 0.5F); // alpha
+                    }
+                    break;
+                case PixelFormat::rg8UnsignedNorm:
+                    for (std::size_t i = 0; i < pixelCount; ++i, src += 2, dst += 2)
+                    {
+                        dst[0] = gammaEncode(src[0]); // red
+                        dst[1] = gammaEncode(src[1]); // green
+                    }
+                    break;
+                case PixelFormat::r8UnsignedNorm:
+                    for (std::size_t i = 0; i < pixelCount; ++i, src += 1, dst += 1)
+                        dst[0] = gammaEncode(src[0]); // red
+                    break;
+                case PixelFormat::a8UnsignedNorm:
+                    for (std::size_t i = 0; i < pixelCount; ++i, src += 1, dst += 1)
+                        dst[0] = static_cast<std::uint8_t>(src[0] * 255.0F + 0.5F); // alpha
+                    break;
+                default:
+                    throw Error{"Invalid pixel format"};
+            }
+        }
+    }
+
+    std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> generateMipmaps(const math::Size<std::uint32_t, 2>& size,
+                                                                                                    const std::vector<std::uint8_t>& data,
+                                                                                                    const std::uint32_t mipmaps,
+                                                                                                    const PixelFormat pixelFormat,
+                                                                                                    core::WorkerPool& workerPool)
+    {
+        std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levels;
+
+        levels.emplace_back(size, data);
+
+        if ((size.v[0] <= 1 && size.v[1] <= 1) || mipmaps == 1)
+            return levels;
+
+        using Downsample = void(*)(const math::Size<std::uint32_t, 2>&, const float*, float*, std::size_t, std::size_t);
+
+        Downsample downsample;
+        switch (pixelFormat)
+        {
+            case PixelFormat::rgba8UnsignedNorm:
+            case PixelFormat::rgba8UnsignedNormSRGB:
+                downsample = downsample2x2Rgba8;
+                break;
+
+            case PixelFormat::rg8UnsignedNorm:
+                downsample = downsample2x2Rg8;
+                break;
+
+            case PixelFormat::r8UnsignedNorm:
+            case PixelFormat::a8UnsignedNorm:
+                downsample = downsample2x2R8;
+                break;
+
+            default:
+                throw Error{"Invalid pixel format"};
+        }
+
+        const std::uint32_t channelCount = getChannelCount(pixelFormat);
+        const std::uint32_t pixelSize = getPixelSize(pixelFormat);
+
+        auto newSize = size;
+        auto previousSize = size;
+        std::vector<float> previousData;
+        std::vector<float> newData;
+
+        while ((newSize.v[0] > 1 || newSize.v[1] > 1) &&
+            (mipmaps == 0 || levels.size() < mipmaps))
+        {
+            newSize.v[0] >>= 1;
+            newSize.v[1] >>= 1;
+
+            if (newSize.v[0] < 1) newSize.v[0] = 1;
+            if (newSize.v[1] < 1) newSize.v[1] = 1;
+
+            const std::size_t dstPitch = std::size_t{newSize.v[0]} * channelCount;
+            newData.resize(dstPitch * newSize.v[1]);
+            std::vector<std::uint8_t> encodedData(std::size_t{newSize.v[0]} * newSize.v[1] * pixelSize);
+
+            // every band is encoded right after it is downsampled, while it is still in the cache
+            forEachRowBand(workerPool, newSize, [&](std::size_t firstRow, std::size_t lastRow) {
+                if (levels.size() == 1)
+                {
+                    // the original level is decoded two rows at a time, so it is never stored as floats as a whole
+                    const std::size_t srcPitch = std::size_t{size.v[0]} * pixelSize;
+                    std::vector<float> rows(std::size_t{size.v[0]} * 2 * channelCount);
+
+                    for (auto y = firstRow; y < lastRow; ++y)
+                    {
+                        const auto rowCount = std::min(std::size_t{size.v[1]} - y * 2, std::size_t{2});
+                        decode(size.v[0] * rowCount, data.data() + y * 2 * srcPitch, pixelFormat, rows.data());
+                        downsample(size, rows.data(), newData.data() + y * dstPitch, 0, 1);
+                    }
+                }
+                else
+                    downsample(previousSize, previousData.data(), newData.data(), firstRow, lastRow);
+
+                encode(newSize.v[0] * (lastRow - firstRow),
+                       newData.data() + firstRow * dstPitch,
+                       pixelFormat,
+                       encodedData.data() + firstRow * newSize.v[0] * pixelSize);
+            });
+
+            levels.emplace_back(newSize, std::move(encodedData));
+
+            std::swap(previousData, newData);
+            previousSize = newSize;
+        }
+
+        return levels;
+    }
+}
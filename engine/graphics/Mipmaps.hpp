@@ -0,0 +1,25 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_MIPMAPS_HPP
+#define OUZEL_GRAPHICS_MIPMAPS_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "PixelFormat.hpp"
+#include "../core/WorkerPool.hpp"
+#include "../math/Size.hpp"
+
+namespace ouzel::graphics
+{
+    // Returns the given level followed by the levels generated from it, down to 1x1 or until there are
+    // mipmaps levels (all of them if mipmaps is zero), the levels are filtered in linear space and the
+    // bands of rows of the large levels are processed on the worker pool
+    std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> generateMipmaps(const math::Size<std::uint32_t, 2>& size,
+                                                                                                    const std::vector<std::uint8_t>& data,
+                                                                                                    std::uint32_t mipmaps,
+                                                                                                    PixelFormat pixelFormat,
+                                                                                                    core::WorkerPool& workerPool);
+}
+
+#endif // OUZEL_GRAPHICS_MIPMAPS_HPP
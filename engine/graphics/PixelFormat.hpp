@@ -3,6 +3,9 @@
 #ifndef OUZEL_GRAPHICS_PIXELFORMAT_HPP
 #define OUZEL_GRAPHICS_PIXELFORMAT_HPP
 
+#include <cstddef>
+#include <cstdint>
+
 namespace ouzel::graphics
 {
     enum class PixelFormat
@@ -38,9 +41,76 @@ namespace ouzel::graphics
         rgba32SignedInt,
         rgba32Float,
         depth,
-        depthStencil
+        depthStencil,
+        bc1RgbaUnsignedNorm,
+        bc1RgbaUnsignedNormSRGB,
+        bc3RgbaUnsignedNorm,
+        bc3RgbaUnsignedNormSRGB,
+        bc4RUnsignedNorm,
+        bc5RgUnsignedNorm,
+        bc7RgbaUnsignedNorm,
+        bc7RgbaUnsignedNormSRGB,
+        etc2RgbUnsignedNorm,
+        etc2RgbUnsignedNormSRGB,
+        etc2RgbaUnsignedNorm,
+        etc2RgbaUnsignedNormSRGB,
+        astc4x4RgbaUnsignedNorm,
+        astc4x4RgbaUnsignedNormSRGB
     };
 
+    // Block compressed formats store blocks of 4x4 pixels, so they have no per pixel size
+    constexpr bool isCompressed(PixelFormat pixelFormat) noexcept
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::bc1RgbaUnsignedNorm:
+            case PixelFormat::bc1RgbaUnsignedNormSRGB:
+            case PixelFormat::bc3RgbaUnsignedNorm:
+            case PixelFormat::bc3RgbaUnsignedNormSRGB:
+            case PixelFormat::bc4RUnsignedNorm:
+            case PixelFormat::bc5RgUnsignedNorm:
+            case PixelFormat::bc7RgbaUnsignedNorm:
+            case PixelFormat::bc7RgbaUnsignedNormSRGB:
+            case PixelFormat::etc2RgbUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNormSRGB:
+            case PixelFormat::etc2RgbaUnsignedNorm:
+            case PixelFormat::etc2RgbaUnsignedNormSRGB:
+            case PixelFormat::astc4x4RgbaUnsignedNorm:
+            case PixelFormat::astc4x4RgbaUnsignedNormSRGB:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    constexpr std::uint32_t compressedBlockWidth = 4;
+    constexpr std::uint32_t compressedBlockHeight = 4;
+
+    inline std::uint32_t getBlockSize(PixelFormat pixelFormat) noexcept
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::bc1RgbaUnsignedNorm:
+            case PixelFormat::bc1RgbaUnsignedNormSRGB:
+            case PixelFormat::bc4RUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNormSRGB:
+                return 8;
+            case PixelFormat::bc3RgbaUnsignedNorm:
+            case PixelFormat::bc3RgbaUnsignedNormSRGB:
+            case PixelFormat::bc5RgUnsignedNorm:
+            case PixelFormat::bc7RgbaUnsignedNorm:
+            case PixelFormat::bc7RgbaUnsignedNormSRGB:
+            case PixelFormat::etc2RgbaUnsignedNorm:
+            case PixelFormat::etc2RgbaUnsignedNormSRGB:
+            case PixelFormat::astc4x4RgbaUnsignedNorm:
+            case PixelFormat::astc4x4RgbaUnsignedNormSRGB:
+                return 16;
+            default:
+                return 0;
+        }
+    }
+
     inline std::uint32_t getPixelSize(PixelFormat pixelFormat) noexcept
     {
         switch (pixelFormat)
@@ -179,6 +249,22 @@ namespace ouzel::graphics
                 return 0;
         }
     }
+
+    // Size in bytes of a row of pixels, or of a row of blocks for compressed formats
+    inline std::size_t getRowSize(PixelFormat pixelFormat, std::uint32_t width) noexcept
+    {
+        if (isCompressed(pixelFormat))
+            return static_cast<std::size_t>((width + compressedBlockWidth - 1) / compressedBlockWidth) * getBlockSize(pixelFormat);
+        else
+            return static_cast<std::size_t>(width) * getPixelSize(pixelFormat);
+    }
+
+    inline std::size_t getLevelSize(PixelFormat pixelFormat, std::uint32_t width, std::uint32_t height) noexcept
+    {
+        const auto rowCount = isCompressed(pixelFormat) ?
+            (height + compressedBlockHeight - 1) / compressedBlockHeight : height;
+        return getRowSize(pixelFormat, width) * rowCount;
+    }
 }
 
 #endif // OUZEL_GRAPHICS_PIXELFORMAT_HPP
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include "RenderDevice.hpp"
 #include "GraphicsError.hpp"
+#include "../utils/Profiler.hpp"
 #include "stb_image_write.h"
 
 namespace ouzel::graphics
@@ -24,12 +25,20 @@ namespace ouzel::graphics
         clampToBorderSupported{false},
         multisamplingSupported{false},
         uintIndicesSupported{false},
-        previousFrameTime{std::chrono::steady_clock::now()}
+        bcTexturesSupported{false},
+        bc7TexturesSupported{false},
+        etc2TexturesSupported{false},
+        astcTexturesSupported{false},
+        previousFrameTime{std::chrono::steady_clock::now()},
+        commandQueue{std::max(settings.framesInFlight, 1U)},
+        freeCommandBuffers{std::max(settings.framesInFlight, 1U) + 1U}
     {
     }
 
     void RenderDevice::process()
     {
+        OUZEL_PROFILE_THREAD("Render");
+
         const auto currentTime = std::chrono::steady_clock::now();
         const auto diff = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - previousFrameTime);
         previousFrameTime = currentTime;
@@ -47,28 +56,27 @@ namespace ouzel::graphics
             accumulatedFps = currentAccumulatedFps;
             accumulatedTime = 0.0F;
             currentAccumulatedFps = 0.0F;
+
+            maxQueueLatency.store(currentMaxQueueLatency, std::memory_order_relaxed);
+            currentMaxQueueLatency = 0;
         }
 
-        std::unique_lock lock{eventQueueMutex};
-        Event event;
-        event.type = Event::Type::frame;
-        eventQueue.push(event);
-        lock.unlock();
-        eventQueueCondition.notify_all();
+        frameEventCount.fetch_add(1, std::memory_order_release);
+        frameEventSemaphore.release();
     }
 
     bool RenderDevice::hasEvents() const
     {
-        std::scoped_lock lock{eventQueueMutex};
-        return !eventQueue.empty();
+        return frameEventCount.load(std::memory_order_acquire) != 0;
     }
 
     RenderDevice::Event RenderDevice::getNextEvent()
     {
-        std::unique_lock lock{eventQueueMutex};
-        eventQueueCondition.wait(lock, [this]() noexcept { return !eventQueue.empty(); });
-        Event result = std::move(eventQueue.front());
-        eventQueue.pop();
+        frameEventSemaphore.acquire();
+        frameEventCount.fetch_sub(1, std::memory_order_acquire);
+
+        Event result;
+        result.type = Event::Type::frame;
         return result;
     }
 
@@ -77,6 +85,33 @@ namespace ouzel::graphics
         return std::vector<math::Size<std::uint32_t, 2>>{};
     }
 
+    bool RenderDevice::isPixelFormatSupported(PixelFormat pixelFormat) const noexcept
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::bc1RgbaUnsignedNorm:
+            case PixelFormat::bc1RgbaUnsignedNormSRGB:
+            case PixelFormat::bc3RgbaUnsignedNorm:
+            case PixelFormat::bc3RgbaUnsignedNormSRGB:
+            case PixelFormat::bc4RUnsignedNorm:
+            case PixelFormat::bc5RgUnsignedNorm:
+                return bcTexturesSupported;
+            case PixelFormat::bc7RgbaUnsignedNorm:
+            case PixelFormat::bc7RgbaUnsignedNormSRGB:
+                return bc7TexturesSupported;
+            case PixelFormat::etc2RgbUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNormSRGB:
+            case PixelFormat::etc2RgbaUnsignedNorm:
+            case PixelFormat::etc2RgbaUnsignedNormSRGB:
+                return etc2TexturesSupported;
+            case PixelFormat::astc4x4RgbaUnsignedNorm:
+            case PixelFormat::astc4x4RgbaUnsignedNormSRGB:
+                return astcTexturesSupported;
+            default:
+                return true;
+        }
+    }
+
     void RenderDevice::generateScreenshot(const std::string&)
     {
     }
@@ -85,25 +120,88 @@ namespace ouzel::graphics
     {
         std::scoped_lock lock{executeMutex};
         executeQueue.push(func);
+        executeCount.fetch_add(1, std::memory_order_release);
     }
 
     void RenderDevice::executeAll()
     {
         std::function<void()> func;
 
-        for (;;)
+        // most frames have nothing to execute, so don't lock the mutex for them
+        while (executeCount.load(std::memory_order_acquire) != 0)
         {
             std::unique_lock lock{executeMutex};
             if (executeQueue.empty()) break;
 
             func = std::move(executeQueue.front());
             executeQueue.pop();
+            executeCount.fetch_sub(1, std::memory_order_relaxed);
             lock.unlock();
 
             if (func) func();
         }
     }
 
+    void RenderDevice::submitCommandBuffer(CommandBuffer&& commandBuffer)
+    {
+        QueuedCommandBuffer queuedCommandBuffer{std::move(commandBuffer), std::chrono::steady_clock::now()};
+
+        if (overflowCommandBuffers.empty())
+        {
+            if (commandQueue.push(std::move(queuedCommandBuffer), submitTimeout)) return;
+
+            log(Log::Level::warning) << "Render thread didn't take a frame in " << submitTimeout.count() << " ms";
+            overflowCommandBuffers.push_back(std::move(queuedCommandBuffer));
+            return;
+        }
+
+        // the render thread has already timed out once, so don't wait for it again until it catches up
+        overflowCommandBuffers.push_back(std::move(queuedCommandBuffer));
+
+        while (!overflowCommandBuffers.empty() &&
+               commandQueue.tryPush(std::move(overflowCommandBuffers.front())))
+            overflowCommandBuffers.pop_front();
+
+        if (overflowCommandBuffers.size() > maxOverflowFrames)
+        {
+            // the commands of the oldest frame are executed before the ones of the next frame
+            auto& oldest = overflowCommandBuffers[0];
+            auto& next = overflowCommandBuffers[1];
+            oldest.commandBuffer.append(std::move(next.commandBuffer));
+            next.commandBuffer = std::move(oldest.commandBuffer);
+            next.submitTime = oldest.submitTime;
+            overflowCommandBuffers.pop_front();
+        }
+    }
+
+    bool RenderDevice::waitForCommandBuffer(CommandBuffer& commandBuffer)
+    {
+        QueuedCommandBuffer queuedCommandBuffer;
+        if (!commandQueue.pop(queuedCommandBuffer)) return false;
+
+        commandBuffer = std::move(queuedCommandBuffer.commandBuffer);
+        updateQueueLatency(queuedCommandBuffer.submitTime);
+        return true;
+    }
+
+    bool RenderDevice::getNextCommandBuffer(CommandBuffer& commandBuffer)
+    {
+        QueuedCommandBuffer queuedCommandBuffer;
+        if (!commandQueue.tryPop(queuedCommandBuffer)) return false;
+
+        commandBuffer = std::move(queuedCommandBuffer.commandBuffer);
+        updateQueueLatency(queuedCommandBuffer.submitTime);
+        return true;
+    }
+
+    void RenderDevice::updateQueueLatency(std::chrono::steady_clock::time_point submitTime) noexcept
+    {
+        const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - submitTime).count();
+
+        queueLatency.store(latency, std::memory_order_relaxed);
+        currentMaxQueueLatency = std::max(currentMaxQueueLatency, latency);
+    }
+
     void RenderDevice::saveScreenshot(const std::string& filename,
                                       std::size_t width,
                                       std::size_t height,
@@ -5,18 +5,23 @@
 
 #include <array>
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
+#include <deque>
 #include <functional>
 #include <mutex>
 #include <queue>
 #include <set>
+#include <vector>
 #include "Commands.hpp"
 #include "Driver.hpp"
+#include "PixelFormat.hpp"
 #include "SamplerFilter.hpp"
 #include "Settings.hpp"
 #include "Vertex.hpp"
 #include "../math/Matrix.hpp"
 #include "../math/Size.hpp"
+#include "../thread/Semaphore.hpp"
+#include "../thread/SpscQueue.hpp"
 #include "../utils/Log.hpp"
 
 namespace ouzel::core
@@ -100,15 +105,70 @@ namespace ouzel::graphics
 
         virtual std::vector<math::Size<std::uint32_t, 2>> getSupportedResolutions() const;
 
-        void submitCommandBuffer(CommandBuffer&& commandBuffer)
+        // must be called only from one thread (the one that records the frames)
+        // blocks while the render thread is behind by the number of frames in flight, but at most for the submit timeout,
+        // after that the frames are kept on the submitting thread without waiting until the render thread takes them,
+        // so that a stuck render thread doesn't block the game thread
+        void submitCommandBuffer(CommandBuffer&& commandBuffer);
+
+        static constexpr std::chrono::milliseconds submitTimeout{1000};
+
+        // the oldest frames kept on the submitting thread are merged beyond this count,
+        // they can't be dropped, because they contain the resource commands
+        static constexpr std::size_t maxOverflowFrames = 3;
+
+        // returns a command buffer that was already processed by the render thread (with its memory kept)
+        CommandBuffer getFreeCommandBuffer()
+        {
+            CommandBuffer result;
+            freeCommandBuffers.tryPop(result);
+            return result;
+        }
+
+        // time that the last command buffer waited in the queue before the render thread took it
+        auto getQueueLatency() const noexcept
+        {
+            return std::chrono::nanoseconds{queueLatency.load(std::memory_order_relaxed)};
+        }
+
+        // the longest wait during the last second
+        auto getMaxQueueLatency() const noexcept
         {
-            std::unique_lock lock{commandQueueMutex};
-            commandQueue.push(std::move(commandBuffer));
-            lock.unlock();
-            commandQueueCondition.notify_all();
+            return std::chrono::nanoseconds{maxQueueLatency.load(std::memory_order_relaxed)};
         }
 
-        auto getDrawCallCount() const noexcept { return drawCallCount; }
+        auto getDrawCallCount() const noexcept { return drawCallCount.load(std::memory_order_relaxed); }
+
+        // API calls made during a frame, the ones skipped because the state did not change are not counted,
+        // only the OpenGL device counts them for now
+        struct CallCounts final
+        {
+            std::uint32_t programBinds = 0;
+            std::uint32_t textureBinds = 0;
+            std::uint32_t bufferBinds = 0;
+            std::uint32_t vertexArrayBinds = 0;
+            std::uint32_t vertexAttributeUpdates = 0;
+            std::uint32_t uniformUploads = 0;
+            std::uint32_t skippedUniformUploads = 0;
+            std::uint32_t uniformBufferBinds = 0;
+        };
+
+        // the counts of the last presented frame, each of them is read separately without locking
+        CallCounts getCallCounts() const noexcept
+        {
+            CallCounts result;
+            result.programBinds = callCounts.programBinds.load(std::memory_order_relaxed);
+            result.textureBinds = callCounts.textureBinds.load(std::memory_order_relaxed);
+            result.bufferBinds = callCounts.bufferBinds.load(std::memory_order_relaxed);
+            result.vertexArrayBinds = callCounts.vertexArrayBinds.load(std::memory_order_relaxed);
+            result.vertexAttributeUpdates = callCounts.vertexAttributeUpdates.load(std::memory_order_relaxed);
+            result.uniformUploads = callCounts.uniformUploads.load(std::memory_order_relaxed);
+            result.skippedUniformUploads = callCounts.skippedUniformUploads.load(std::memory_order_relaxed);
+            result.uniformBufferBinds = callCounts.uniformBufferBinds.load(std::memory_order_relaxed);
+            return result;
+        }
+        auto getBatchCount() const noexcept { return batchCount; }
+        auto getBatchedSpriteCount() const noexcept { return batchedSpriteCount; }
 
         auto getAPIMajorVersion() const noexcept { return apiVersion.v[0]; }
         auto getAPIMinorVersion() const noexcept { return apiVersion.v[1]; }
@@ -116,6 +176,7 @@ namespace ouzel::graphics
         auto isNpotTexturesSupported() const noexcept { return npotTexturesSupported; }
         auto isAnisotropicFilteringSupported() const noexcept { return anisotropicFilteringSupported; }
         auto isRenderTargetsSupported() const noexcept { return renderTargetsSupported; }
+        bool isPixelFormatSupported(PixelFormat pixelFormat) const noexcept;
 
         auto& getProjectionTransform(bool renderTarget) const noexcept
         {
@@ -178,6 +239,26 @@ namespace ouzel::graphics
     protected:
         void executeAll();
 
+        // called on the render thread, returns false if the thread was woken up without a new command buffer
+        bool waitForCommandBuffer(CommandBuffer& commandBuffer);
+
+        // called on the render thread, doesn't wait for the next command buffer
+        bool getNextCommandBuffer(CommandBuffer& commandBuffer);
+
+        // makes the render thread return from waiting for the next command buffer, can be called from any thread
+        void wakeRenderThread()
+        {
+            commandQueue.interrupt();
+        }
+
+        void recycleCommandBuffer(CommandBuffer&& commandBuffer)
+        {
+            commandBuffer.clear();
+
+            // if the game thread hasn't taken the previous buffers, the memory of this one is released
+            freeCommandBuffers.tryPush(std::move(commandBuffer));
+        }
+
         virtual void changeScreen(const std::uintptr_t) {}
         virtual void generateScreenshot(const std::string& filename);
         void saveScreenshot(const std::string& filename,
@@ -207,18 +288,37 @@ namespace ouzel::graphics
         bool clampToBorderSupported:1;
         bool multisamplingSupported:1;
         bool uintIndicesSupported:1;
+        bool bcTexturesSupported:1; // BC1-BC5
+        bool bc7TexturesSupported:1;
+        bool etc2TexturesSupported:1;
+        bool astcTexturesSupported:1;
 
         math::Matrix<float, 4> projectionTransform = math::identityMatrix<float, 4>;
         math::Matrix<float, 4> renderTargetProjectionTransform = math::identityMatrix<float, 4>;
 
-        std::uint32_t drawCallCount = 0;
+        // statistics of the last presented frame
+        std::atomic<std::uint32_t> drawCallCount{0};
+        std::uint32_t frameDrawCallCount = 0;
+        std::uint32_t batchCount = 0; // written by Graphics on the game thread
+        std::uint32_t batchedSpriteCount = 0;
+        CallCounts frameCallCounts; // counted on the render thread and published on present
 
-        std::queue<CommandBuffer> commandQueue;
-        std::mutex commandQueueMutex;
-        std::condition_variable commandQueueCondition;
+        void publishCallCounts() noexcept
+        {
+            callCounts.programBinds.store(frameCallCounts.programBinds, std::memory_order_relaxed);
+            callCounts.textureBinds.store(frameCallCounts.textureBinds, std::memory_order_relaxed);
+            callCounts.bufferBinds.store(frameCallCounts.bufferBinds, std::memory_order_relaxed);
+            callCounts.vertexArrayBinds.store(frameCallCounts.vertexArrayBinds, std::memory_order_relaxed);
+            callCounts.vertexAttributeUpdates.store(frameCallCounts.vertexAttributeUpdates, std::memory_order_relaxed);
+            callCounts.uniformUploads.store(frameCallCounts.uniformUploads, std::memory_order_relaxed);
+            callCounts.skippedUniformUploads.store(frameCallCounts.skippedUniformUploads, std::memory_order_relaxed);
+            callCounts.uniformBufferBinds.store(frameCallCounts.uniformBufferBinds, std::memory_order_relaxed);
+            frameCallCounts = CallCounts{};
+        }
 
         std::queue<std::function<void()>> executeQueue;
         std::mutex executeMutex;
+        std::atomic<std::size_t> executeCount{0};
 
     private:
         ResourceId createResourceId()
@@ -238,9 +338,25 @@ namespace ouzel::graphics
             deletedResourceIds.insert(id);
         }
 
+        void updateQueueLatency(std::chrono::steady_clock::time_point submitTime) noexcept;
+
         ResourceId lastResourceId = 0;
         std::set<ResourceId> deletedResourceIds;
 
+        struct AtomicCallCounts final
+        {
+            std::atomic<std::uint32_t> programBinds{0};
+            std::atomic<std::uint32_t> textureBinds{0};
+            std::atomic<std::uint32_t> bufferBinds{0};
+            std::atomic<std::uint32_t> vertexArrayBinds{0};
+            std::atomic<std::uint32_t> vertexAttributeUpdates{0};
+            std::atomic<std::uint32_t> uniformUploads{0};
+            std::atomic<std::uint32_t> skippedUniformUploads{0};
+            std::atomic<std::uint32_t> uniformBufferBinds{0};
+        };
+
+        AtomicCallCounts callCounts;
+
         std::atomic<float> currentFps{0.0F};
         std::chrono::steady_clock::time_point previousFrameTime;
 
@@ -248,9 +364,22 @@ namespace ouzel::graphics
         float currentAccumulatedFps = 0.0F;
         std::atomic<float> accumulatedFps{0.0F};
 
-        std::queue<Event> eventQueue;
-        mutable std::mutex eventQueueMutex;
-        std::condition_variable eventQueueCondition;
+        std::atomic<std::size_t> frameEventCount{0};
+        thread::Semaphore frameEventSemaphore;
+
+        struct QueuedCommandBuffer final
+        {
+            CommandBuffer commandBuffer;
+            std::chrono::steady_clock::time_point submitTime;
+        };
+
+        thread::SpscQueue<QueuedCommandBuffer> commandQueue;
+        thread::SpscQueue<CommandBuffer> freeCommandBuffers;
+        std::deque<QueuedCommandBuffer> overflowCommandBuffers; // accessed only by the submitting thread
+
+        std::atomic<std::chrono::nanoseconds::rep> queueLatency{0};
+        std::atomic<std::chrono::nanoseconds::rep> maxQueueLatency{0};
+        std::chrono::nanoseconds::rep currentMaxQueueLatency = 0;
     };
 }
 
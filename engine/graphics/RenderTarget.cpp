@@ -18,8 +18,8 @@ namespace ouzel::graphics
         for (const auto& colorTexture : colorTextures)
             colorTextureIds.insert(colorTexture ? colorTexture->getResource() : 0);
 
-        initGraphics.addCommand(std::make_unique<InitRenderTargetCommand>(resource,
-                                                                          colorTextureIds,
-                                                                          depthTexture ? depthTexture->getResource() : RenderDevice::ResourceId(0)));
+        initGraphics.addCommand<InitRenderTargetCommand>(resource,
+                                                         colorTextureIds,
+                                                         depthTexture ? depthTexture->getResource() : RenderDevice::ResourceId(0));
     }
 }
@@ -13,6 +13,10 @@ namespace ouzel::graphics
         std::uint32_t sampleCount = 1;
         SamplerFilter textureFilter = SamplerFilter::point;
         std::uint32_t maxAnisotropy = 1;
+        // number of frames the game thread can record ahead of the render thread
+        // more frames let the game thread go on when a frame takes longer to render, but add input latency
+        // and keep more command buffers in memory, fewer frames make the game thread wait for the render thread
+        std::uint32_t framesInFlight = 2;
         bool srgb = false;
         bool verticalSync = false;
         bool depth = false;
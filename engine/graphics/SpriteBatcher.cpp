@@ -0,0 +1,113 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <limits>
+#include "SpriteBatcher.hpp"
+#include "Graphics.hpp"
+#include "../utils/Utils.hpp"
+
+namespace ouzel::graphics
+{
+    namespace
+    {
+        bool isSameState(const SpriteBatcher::State& state1, const SpriteBatcher::State& state2) noexcept
+        {
+            return state1.blendState == state2.blendState &&
+                state1.shader == state2.shader &&
+                state1.cullMode == state2.cullMode &&
+                state1.fillMode == state2.fillMode &&
+                state1.textures == state2.textures &&
+                state1.viewProjection == state2.viewProjection;
+        }
+
+        std::uint8_t modulate(std::uint8_t component, float factor) noexcept
+        {
+            return static_cast<std::uint8_t>(std::clamp(component * factor + 0.5F, 0.0F, 255.0F));
+        }
+    }
+
+    void SpriteBatcher::addSprite(const State& state,
+                                  Span<const std::uint16_t> indices,
+                                  Span<const Vertex> vertices,
+                                  const math::Matrix<float, 4>& transform,
+                                  math::Color color)
+    {
+        if (hasPendingSprites() &&
+            (!isSameState(batchState, state) ||
+             batchVertices.size() + vertices.size() > std::numeric_limits<std::uint16_t>::max() + 1U))
+            flush();
+
+        if (!hasPendingSprites()) batchState = state;
+
+        const auto baseIndex = static_cast<std::uint16_t>(batchVertices.size());
+        for (const auto index : indices)
+            batchIndices.push_back(static_cast<std::uint16_t>(baseIndex + index));
+
+        const float colorFactors[] = {color.normR(), color.normG(), color.normB(), color.normA()};
+
+        for (const auto& vertex : vertices)
+        {
+            auto& batchVertex = batchVertices.emplace_back(vertex);
+            transformPoint(transform, batchVertex.position);
+
+            for (std::size_t i = 0; i < 4; ++i)
+                batchVertex.color.v[i] = modulate(vertex.color.v[i], colorFactors[i]);
+        }
+
+        ++spriteCount;
+    }
+
+    void SpriteBatcher::flush()
+    {
+        if (!hasPendingSprites()) return;
+
+        if (usedBufferCount == buffers.size())
+            buffers.push_back(std::make_unique<BatchBuffers>(BatchBuffers{
+                Buffer{graphics, BufferType::index, Flags::dynamic},
+                Buffer{graphics, BufferType::vertex, Flags::dynamic}
+            }));
+
+        auto& batchBuffers = *buffers[usedBufferCount++];
+
+        // take the pending data, so that the commands issued below don't flush it again
+        auto indices = std::move(batchIndices);
+        auto vertices = std::move(batchVertices);
+        batchIndices.clear();
+        batchVertices.clear();
+
+        batchBuffers.indexBuffer.setData(indices.data(), static_cast<std::uint32_t>(getVectorSize(indices)));
+        batchBuffers.vertexBuffer.setData(vertices.data(), static_cast<std::uint32_t>(getVectorSize(vertices)));
+
+        std::copy(std::begin(batchState.viewProjection.m.v), std::end(batchState.viewProjection.m.v),
+                  vertexShaderConstants.front().begin());
+        batchTextures.assign(batchState.textures.begin(), batchState.textures.end());
+
+        graphics.setPipelineState(batchState.blendState,
+                                  batchState.shader,
+                                  batchState.cullMode,
+                                  batchState.fillMode);
+        graphics.setShaderConstants(fragmentShaderConstants, vertexShaderConstants);
+        graphics.setTextures(batchTextures);
+        graphics.draw(batchBuffers.indexBuffer.getResource(),
+                      static_cast<std::uint32_t>(indices.size()),
+                      sizeof(std::uint16_t),
+                      batchBuffers.vertexBuffer.getResource(),
+                      DrawMode::triangleList,
+                      0);
+
+        ++batchCount;
+
+        // keep the allocated memory for the next batch
+        batchIndices = std::move(indices);
+        batchVertices = std::move(vertices);
+        batchIndices.clear();
+        batchVertices.clear();
+    }
+
+    void SpriteBatcher::reset() noexcept
+    {
+        usedBufferCount = 0;
+        batchCount = 0;
+        spriteCount = 0;
+    }
+}
@@ -0,0 +1,92 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_SPRITEBATCHER_HPP
+#define OUZEL_GRAPHICS_SPRITEBATCHER_HPP
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Buffer.hpp"
+#include "RasterizerState.hpp"
+#include "Vertex.hpp"
+#include "../math/Color.hpp"
+#include "../math/Matrix.hpp"
+#include "../utils/Span.hpp"
+
+namespace ouzel::graphics
+{
+    class Graphics;
+
+    // Merges consecutive sprites that use the same pipeline state, textures and view projection
+    // into a single draw call with vertices transformed on the CPU
+    class SpriteBatcher final
+    {
+    public:
+        static constexpr std::size_t textureLayers = 4U;
+
+        struct State final
+        {
+            std::size_t blendState = 0;
+            std::size_t shader = 0;
+            CullMode cullMode = CullMode::none;
+            FillMode fillMode = FillMode::solid;
+            std::array<std::size_t, textureLayers> textures{};
+            math::Matrix<float, 4> viewProjection = math::identityMatrix<float, 4>;
+        };
+
+        explicit SpriteBatcher(Graphics& initGraphics) noexcept:
+            graphics{initGraphics}
+        {
+        }
+
+        SpriteBatcher(const SpriteBatcher&) = delete;
+        SpriteBatcher& operator=(const SpriteBatcher&) = delete;
+
+        SpriteBatcher(SpriteBatcher&&) = delete;
+        SpriteBatcher& operator=(SpriteBatcher&&) = delete;
+
+        // the shader must take the color (float4) as its only fragment shader constant
+        // and the model view projection (float4x4) as its only vertex shader constant
+        void addSprite(const State& state,
+                       Span<const std::uint16_t> indices,
+                       Span<const Vertex> vertices,
+                       const math::Matrix<float, 4>& transform,
+                       math::Color color);
+
+        [[nodiscard]] auto hasPendingSprites() const noexcept { return !batchIndices.empty(); }
+        void flush();
+
+        // called at the end of every frame, the buffers of the previous batches are reused
+        void reset() noexcept;
+
+        [[nodiscard]] auto getBatchCount() const noexcept { return batchCount; }
+        [[nodiscard]] auto getSpriteCount() const noexcept { return spriteCount; }
+
+    private:
+        struct BatchBuffers final
+        {
+            Buffer indexBuffer;
+            Buffer vertexBuffer;
+        };
+
+        Graphics& graphics;
+
+        State batchState;
+        std::vector<std::uint16_t> batchIndices;
+        std::vector<Vertex> batchVertices;
+
+        // the arguments of the commands of a batch, kept to reuse their memory
+        const std::vector<std::vector<float>> fragmentShaderConstants{{1.0F, 1.0F, 1.0F, 1.0F}};
+        std::vector<std::vector<float>> vertexShaderConstants{std::vector<float>(16)};
+        std::vector<std::size_t> batchTextures;
+
+        std::vector<std::unique_ptr<BatchBuffers>> buffers;
+        std::size_t usedBufferCount = 0;
+
+        std::uint32_t batchCount = 0;
+        std::uint32_t spriteCount = 0;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_SPRITEBATCHER_HPP
@@ -13,6 +13,7 @@
 #include "SamplerFilter.hpp"
 #include "TextureType.hpp"
 #include "../math/Color.hpp"
+#include "../math/Rect.hpp"
 #include "../math/Size.hpp"
 
 namespace ouzel::graphics
@@ -49,6 +50,9 @@ namespace ouzel::graphics
 
         void setData(const std::vector<std::uint8_t>& newData, CubeFace face = CubeFace::positiveX);
 
+        // updates a part of a texture without mip maps, the data holds only the pixels of the rectangle
+        void setData(const std::vector<std::uint8_t>& newData, const math::Rect<std::uint32_t>& rect);
+
         auto getFlags() const noexcept { return flags; }
         auto getMipmaps() const noexcept { return mipmaps; }
 
@@ -25,7 +25,7 @@ namespace ouzel::graphics::d3d11
         createBuffer(initSize, data);
     }
 
-    void Buffer::setData(const std::vector<std::uint8_t>& data)
+    void Buffer::setData(Span<const std::uint8_t> data)
     {
         if ((flags & Flags::dynamic) != Flags::dynamic)
             throw std::runtime_error{"Buffer is not dynamic"};
@@ -47,7 +47,7 @@ namespace ouzel::graphics::d3d11
         }
     }
 
-    void Buffer::createBuffer(UINT newSize, const std::vector<std::uint8_t>& data)
+    void Buffer::createBuffer(UINT newSize, Span<const std::uint8_t> data)
     {
         if (newSize)
         {
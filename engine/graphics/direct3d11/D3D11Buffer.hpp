@@ -23,6 +23,7 @@
 #include "D3D11Pointer.hpp"
 #include "../BufferType.hpp"
 #include "../Flags.hpp"
+#include "../../utils/Span.hpp"
 
 namespace ouzel::graphics::d3d11
 {
@@ -37,7 +38,7 @@ namespace ouzel::graphics::d3d11
                const std::vector<std::uint8_t>& data,
                std::uint32_t initSize);
 
-        void setData(const std::vector<std::uint8_t>& data);
+        void setData(Span<const std::uint8_t> data);
 
         auto getFlags() const noexcept { return flags; }
         auto getType() const noexcept { return type; }
@@ -46,7 +47,7 @@ namespace ouzel::graphics::d3d11
         auto& getBuffer() const noexcept { return buffer; }
 
     private:
-        void createBuffer(UINT newSize, const std::vector<std::uint8_t>& data);
+        void createBuffer(UINT newSize, Span<const std::uint8_t> data);
 
         BufferType type;
         Flags flags = Flags::none;
@@ -105,6 +105,11 @@ namespace ouzel::graphics::d3d11
         if (featureLevel >= D3D_FEATURE_LEVEL_10_0)
             npotTexturesSupported = true;
 
+        // BC1-BC5 are supported on all feature levels, BC7 only since Direct3D 11
+        bcTexturesSupported = true;
+        if (featureLevel >= D3D_FEATURE_LEVEL_11_0)
+            bc7TexturesSupported = true;
+
 
         void* dxgiDevicePtr;
         device->QueryInterface(IID_IDXGIDevice, &dxgiDevicePtr);
@@ -284,9 +289,7 @@ namespace ouzel::graphics::d3d11
     RenderDevice::~RenderDevice()
     {
         running = false;
-        CommandBuffer commandBuffer;
-        commandBuffer.pushCommand(std::make_unique<PresentCommand>());
-        submitCommandBuffer(std::move(commandBuffer));
+        wakeRenderThread();
 
         if (renderThread.isJoinable()) renderThread.join();
     }
@@ -316,15 +319,12 @@ namespace ouzel::graphics::d3d11
         std::vector<ID3D11SamplerState*> currentSamplerStates;
 
         CommandBuffer commandBuffer;
-        std::unique_ptr<Command> command;
+        const Command* command;
 
         for (;;)
         {
-            std::unique_lock lock{commandQueueMutex};
-            commandQueueCondition.wait(lock, [this]() noexcept { return !commandQueue.empty(); });
-            commandBuffer = std::move(commandQueue.front());
-            commandQueue.pop();
-            lock.unlock();
+            // interrupted when the device is being stopped
+            if (!waitForCommandBuffer(commandBuffer)) return;
 
             while (!commandBuffer.isEmpty())
             {
@@ -334,7 +334,7 @@ namespace ouzel::graphics::d3d11
                 {
                     case Command::Type::resize:
                     {
-                        const auto resizeCommand = static_cast<const ResizeCommand*>(command.get());
+                        const auto resizeCommand = static_cast<const ResizeCommand*>(command);
                         resizeBackBuffer(static_cast<UINT>(resizeCommand->size.v[0]),
                                          static_cast<UINT>(resizeCommand->size.v[1]));
                         break;
@@ -342,6 +342,9 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::present:
                     {
+                        drawCallCount = frameDrawCallCount;
+                        frameDrawCallCount = 0;
+
                         if (currentRenderTarget)
                             currentRenderTarget->resolve();
 
@@ -351,14 +354,14 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::deleteResource:
                     {
-                        const auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command.get());
+                        const auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command);
                         resources[deleteResourceCommand->resource - 1].reset();
                         break;
                     }
 
                     case Command::Type::initRenderTarget:
                     {
-                        const auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command.get());
+                        const auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command);
 
                         std::set<Texture*> colorTextures;
                         for (const auto colorTextureId : initRenderTargetCommand->colorTextures)
@@ -376,7 +379,7 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::setRenderTarget:
                     {
-                        const auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command.get());
+                        const auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command);
 
                         if (currentRenderTarget)
                             currentRenderTarget->resolve();
@@ -400,7 +403,7 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::clearRenderTarget:
                     {
-                        const auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command.get());
+                        const auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command);
 
                         const std::array<FLOAT, 4> frameBufferClearColor{
                             clearCommand->clearColor.normR(),
@@ -439,7 +442,7 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::setScissorTest:
                     {
-                        const auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command.get());
+                        const auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command);
 
                         if (setScissorTestCommand->enabled)
                         {
@@ -461,7 +464,7 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::setViewport:
                     {
-                        const auto setViewportCommand = static_cast<const SetViewportCommand*>(command.get());
+                        const auto setViewportCommand = static_cast<const SetViewportCommand*>(command);
 
                         D3D11_VIEWPORT viewport;
                         viewport.MinDepth = 0.0F;
@@ -477,7 +480,7 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::initDepthStencilState:
                     {
-                        const auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command.get());
+                        const auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command);
                         auto depthStencilState = std::make_unique<DepthStencilState>(*this,
                                                                                      initDepthStencilStateCommand->depthTest,
                                                                                      initDepthStencilStateCommand->depthWrite,
@@ -502,7 +505,7 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::setDepthStencilState:
                     {
-                        const auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command.get());
+                        const auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command);
 
                         if (setDepthStencilStateCommand->depthStencilState)
                         {
@@ -519,7 +522,7 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::setPipelineState:
                     {
-                        const auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command.get());
+                        const auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command);
 
                         const auto blendState = getResource<BlendState>(setPipelineStateCommand->blendState);
                         const auto shader = getResource<Shader>(setPipelineStateCommand->shader);
@@ -569,7 +572,8 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::draw:
                     {
-                        const auto drawCommand = static_cast<const DrawCommand*>(command.get());
+                        const auto drawCommand = static_cast<const DrawCommand*>(command);
+                        ++frameDrawCallCount;
 
                         // draw mesh buffer
                         const auto indexBuffer = getResource<Buffer>(drawCommand->indexBuffer);
@@ -599,7 +603,7 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::initBlendState:
                     {
-                        const auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command.get());
+                        const auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command);
 
                         auto blendState = std::make_unique<BlendState>(*this,
                                                                        initBlendStateCommand->enableBlending,
@@ -619,7 +623,7 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::initBuffer:
                     {
-                        const auto initBufferCommand = static_cast<const InitBufferCommand*>(command.get());
+                        const auto initBufferCommand = static_cast<const InitBufferCommand*>(command);
 
                         auto buffer = std::make_unique<Buffer>(*this,
                                                                initBufferCommand->bufferType,
@@ -635,16 +639,16 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::setBufferData:
                     {
-                        const auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command.get());
+                        const auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command);
 
                         const auto buffer = getResource<Buffer>(setBufferDataCommand->buffer);
-                        buffer->setData(setBufferDataCommand->data);
+                        buffer->setData(setBufferDataCommand->getData());
                         break;
                     }
 
                     case Command::Type::initShader:
                     {
-                        const auto initShaderCommand = static_cast<const InitShaderCommand*>(command.get());
+                        const auto initShaderCommand = static_cast<const InitShaderCommand*>(command);
 
                         auto shader = std::make_unique<Shader>(*this,
                                                                initShaderCommand->fragmentShader,
@@ -663,7 +667,7 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::setShaderConstants:
                     {
-                        const auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command.get());
+                        const auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command);
 
                         if (!currentShader)
                             throw std::runtime_error{"No shader set"};
@@ -671,15 +675,15 @@ namespace ouzel::graphics::d3d11
                         // pixel shader constants
                         const auto& fragmentShaderConstantLocations = currentShader->getFragmentShaderConstantLocations();
 
-                        if (setShaderConstantsCommand->fragmentShaderConstants.size() > fragmentShaderConstantLocations.size())
+                        if (setShaderConstantsCommand->fragmentShaderConstantCount > fragmentShaderConstantLocations.size())
                             throw std::runtime_error{"Invalid pixel shader constant size"};
 
                         shaderData.clear();
 
-                        for (std::size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstants.size(); ++i)
+                        for (std::size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstantCount; ++i)
                         {
                             const auto& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
-                            const auto& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
+                            const auto fragmentShaderConstant = setShaderConstantsCommand->getFragmentShaderConstant(i);
 
                             if (sizeof(float) * fragmentShaderConstant.size() != fragmentShaderConstantLocation.size)
                                 throw std::runtime_error{"Invalid pixel shader constant size"};
@@ -697,15 +701,15 @@ namespace ouzel::graphics::d3d11
                         // vertex shader constants
                         const auto& vertexShaderConstantLocations = currentShader->getVertexShaderConstantLocations();
 
-                        if (setShaderConstantsCommand->vertexShaderConstants.size() > vertexShaderConstantLocations.size())
+                        if (setShaderConstantsCommand->vertexShaderConstantCount > vertexShaderConstantLocations.size())
                             throw std::runtime_error{"Invalid vertex shader constant size"};
 
                         shaderData.clear();
 
-                        for (std::size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstants.size(); ++i)
+                        for (std::size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstantCount; ++i)
                         {
                             const auto& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                            const auto& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
+                            const auto vertexShaderConstant = setShaderConstantsCommand->getVertexShaderConstant(i);
 
                             if (sizeof(float) * vertexShaderConstant.size() != vertexShaderConstantLocation.size)
                                 throw std::runtime_error{"Invalid vertex shader constant size"};
@@ -725,7 +729,7 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::initTexture:
                     {
-                        const auto initTextureCommand = static_cast<const InitTextureCommand*>(command.get());
+                        const auto initTextureCommand = static_cast<const InitTextureCommand*>(command);
 
                         auto texture = std::make_unique<Texture>(*this,
                                                                  initTextureCommand->levels,
@@ -744,17 +748,17 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::setTextureData:
                     {
-                        const auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command.get());
+                        const auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command);
 
                         const auto texture = getResource<Texture>(setTextureDataCommand->texture);
-                        texture->setData(setTextureDataCommand->levels);
+                        texture->setData(setTextureDataCommand->levels, setTextureDataCommand->offset);
 
                         break;
                     }
 
                     case Command::Type::setTextureParameters:
                     {
-                        const auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command.get());
+                        const auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command);
 
                         const auto texture = getResource<Texture>(setTextureParametersCommand->texture);
                         texture->setFilter(setTextureParametersCommand->filter);
@@ -768,12 +772,12 @@ namespace ouzel::graphics::d3d11
 
                     case Command::Type::setTextures:
                     {
-                        const auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command.get());
+                        const auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command);
 
                         currentResourceViews.clear();
                         currentSamplerStates.clear();
 
-                        for (const auto textureId : setTexturesCommand->textures)
+                        for (const auto textureId : setTexturesCommand->getTextures())
                             if (auto texture = getResource<Texture>(textureId))
                             {
                                 currentResourceViews.push_back(texture->getResourceView().get());
@@ -795,8 +799,14 @@ namespace ouzel::graphics::d3d11
                         throw std::runtime_error{"Invalid command"};
                 }
 
-                if (command->type == Command::Type::present) return;
+                if (command->type == Command::Type::present)
+                {
+                    recycleCommandBuffer(std::move(commandBuffer));
+                    return;
+                }
             }
+
+            recycleCommandBuffer(std::move(commandBuffer));
         }
     }
 
@@ -51,6 +51,14 @@ namespace ouzel::graphics::d3d11
                 case PixelFormat::rgba32Float: return DXGI_FORMAT_R32G32B32A32_FLOAT;
                 case PixelFormat::depth: return DXGI_FORMAT_D32_FLOAT;
                 case PixelFormat::depthStencil: return DXGI_FORMAT_D24_UNORM_S8_UINT;
+                case PixelFormat::bc1RgbaUnsignedNorm: return DXGI_FORMAT_BC1_UNORM;
+                case PixelFormat::bc1RgbaUnsignedNormSRGB: return DXGI_FORMAT_BC1_UNORM_SRGB;
+                case PixelFormat::bc3RgbaUnsignedNorm: return DXGI_FORMAT_BC3_UNORM;
+                case PixelFormat::bc3RgbaUnsignedNormSRGB: return DXGI_FORMAT_BC3_UNORM_SRGB;
+                case PixelFormat::bc4RUnsignedNorm: return DXGI_FORMAT_BC4_UNORM;
+                case PixelFormat::bc5RgUnsignedNorm: return DXGI_FORMAT_BC5_UNORM;
+                case PixelFormat::bc7RgbaUnsignedNorm: return DXGI_FORMAT_BC7_UNORM;
+                case PixelFormat::bc7RgbaUnsignedNormSRGB: return DXGI_FORMAT_BC7_UNORM_SRGB;
                 default: throw std::runtime_error{"Invalid pixel format"};
             }
         }
@@ -140,6 +148,14 @@ namespace ouzel::graphics::d3d11
         if (!width || !height)
             throw std::runtime_error{"Invalid texture size"};
 
+        if ((flags & Flags::dynamic) == Flags::dynamic &&
+            (flags & Flags::bindRenderTarget) != Flags::bindRenderTarget &&
+            levels.size() == 1)
+        {
+            data = levels.front().second;
+            data.resize(width * height * pixelSize);
+        }
+
         D3D11_TEXTURE2D_DESC textureDescriptor;
         textureDescriptor.Width = width;
         textureDescriptor.Height = height;
@@ -185,7 +201,7 @@ namespace ouzel::graphics::d3d11
             for (std::size_t level = 0; level < levels.size(); ++level)
             {
                 subresourceData[level].pSysMem = levels[level].second.data();
-                subresourceData[level].SysMemPitch = static_cast<UINT>(levels[level].first.v[0] * pixelSize);
+                subresourceData[level].SysMemPitch = static_cast<UINT>(getRowSize(initPixelFormat, levels[level].first.v[0]));
                 subresourceData[level].SysMemSlicePitch = 0;
             }
 
@@ -325,43 +341,66 @@ namespace ouzel::graphics::d3d11
         updateSamplerState();
     }
 
-    void Texture::setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& levels)
+    void Texture::setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& levels,
+                          const math::Vector<std::uint32_t, 2>& offset)
     {
         if ((flags & Flags::dynamic) != Flags::dynamic ||
             (flags & Flags::bindRenderTarget) == Flags::bindRenderTarget)
             throw std::runtime_error{"Texture is not dynamic"};
 
-        for (std::size_t level = 0; level < levels.size(); ++level)
+        if (offset.v[0] != 0 || offset.v[1] != 0 ||
+            (!levels.empty() && (levels.front().first.v[0] != width || levels.front().first.v[1] != height)))
         {
+            if (data.empty() || levels.size() != 1)
+                throw std::runtime_error{"Only dynamic textures without mip maps can be partially updated"};
+
+            const auto& region = levels.front();
+            const auto rowSize = region.first.v[0] * pixelSize;
+
+            for (std::uint32_t row = 0; row < region.first.v[1]; ++row)
+                std::memcpy(data.data() + ((offset.v[1] + row) * width + offset.v[0]) * pixelSize,
+                            region.second.data() + row * rowSize,
+                            rowSize);
+
+            uploadLevel(0, math::Size<std::uint32_t, 2>{width, height}, data);
+            return;
+        }
+
+        if (!data.empty() && !levels.empty() && !levels.front().second.empty())
+            data = levels.front().second;
+
+        for (std::size_t level = 0; level < levels.size(); ++level)
             if (!levels[level].second.empty())
+                uploadLevel(level, levels[level].first, levels[level].second);
+    }
+
+    void Texture::uploadLevel(std::size_t level, const math::Size<std::uint32_t, 2>& size, const std::vector<std::uint8_t>& levelData)
+    {
+        MappedSubresource mapped{renderDevice.getContext().get()};
+        const auto mappedSubresource = mapped.map(texture.get(), level,
+                                                  (level == 0) ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE);
+
+        if (mappedSubresource.RowPitch == size.v[0] * pixelSize)
+        {
+            std::memcpy(mappedSubresource.pData,
+                        levelData.data(),
+                        levelData.size());
+        }
+        else
+        {
+            const auto rowSize = size.v[0] * pixelSize;
+            const auto rows = static_cast<UINT>(size.v[1]);
+            auto source = levelData.data();
+            auto destination = static_cast<BYTE*>(mappedSubresource.pData);
+
+            for (UINT row = 0; row < rows; ++row)
             {
-                MappedSubresource mapped{renderDevice.getContext().get()};
-                const auto mappedSubresource = mapped.map(texture.get(), level,
-                                                          (level == 0) ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE);
+                std::memcpy(destination,
+                            source,
+                            rowSize);
 
-                if (mappedSubresource.RowPitch == levels[level].first.v[0] * pixelSize)
-                {
-                    std::memcpy(mappedSubresource.pData,
-                                levels[level].second.data(),
-                                levels[level].second.size());
-                }
-                else
-                {
-                    const auto rowSize = levels[level].first.v[0] * pixelSize;
-                    const auto rows = static_cast<UINT>(levels[level].first.v[1]);
-                    auto source = levels[level].second.data();
-                    auto destination = static_cast<BYTE*>(mappedSubresource.pData);
-
-                    for (UINT row = 0; row < rows; ++row)
-                    {
-                        std::memcpy(destination,
-                                    source,
-                                    rowSize);
-
-                        source += rowSize;
-                        destination += mappedSubresource.RowPitch;
-                    }
-                }
+                source += rowSize;
+                destination += mappedSubresource.RowPitch;
             }
         }
     }
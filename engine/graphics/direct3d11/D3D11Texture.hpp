@@ -9,6 +9,7 @@
 
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #pragma push_macro("WIN32_LEAN_AND_MEAN")
 #pragma push_macro("NOMINMAX")
@@ -30,6 +31,7 @@
 #include "../SamplerFilter.hpp"
 #include "../TextureType.hpp"
 #include "../../math/Size.hpp"
+#include "../../math/Vector.hpp"
 
 namespace ouzel::graphics::d3d11
 {
@@ -62,7 +64,8 @@ namespace ouzel::graphics::d3d11
                 SamplerFilter initFilter,
                 std::uint32_t initMaxAnisotropy);
 
-        void setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& levels);
+        void setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& levels,
+                     const math::Vector<std::uint32_t, 2>& offset = {});
         void setFilter(SamplerFilter filter);
         void setAddressX(SamplerAddressMode addressX);
         void setAddressY(SamplerAddressMode addressY);
@@ -88,6 +91,7 @@ namespace ouzel::graphics::d3d11
 
     private:
         void updateSamplerState();
+        void uploadLevel(std::size_t level, const math::Size<std::uint32_t, 2>& size, const std::vector<std::uint8_t>& levelData);
 
         Flags flags = Flags::none;
         std::uint32_t mipmaps = 0;
@@ -104,6 +108,10 @@ namespace ouzel::graphics::d3d11
         UINT width = 0;
         UINT height = 0;
 
+        // dynamic textures are written with discarding the old contents, so the partially updatable ones
+        // (dynamic without mip maps) keep a copy of their data to upload it as a whole
+        std::vector<std::uint8_t> data;
+
         Pointer<ID3D11RenderTargetView> renderTargetView;
         Pointer<ID3D11DepthStencilView> depthStencilView;
     };
@@ -19,7 +19,20 @@ namespace ouzel::graphics::empty
         void start() final {}
 
     private:
-        void process() final {}
+        void process() final
+        {
+            CommandBuffer commandBuffer;
+
+            while (getNextCommandBuffer(commandBuffer))
+            {
+                // nothing is rendered, so the commands are only walked and the buffer returned for reuse
+                while (!commandBuffer.isEmpty())
+                    if (commandBuffer.popCommand()->type == Command::Type::present)
+                        break;
+
+                recycleCommandBuffer(std::move(commandBuffer));
+            }
+        }
     };
 }
 
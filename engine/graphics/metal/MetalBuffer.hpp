@@ -18,6 +18,7 @@ using MTLBufferPtr = id;
 #include "MetalRenderResource.hpp"
 #include "../BufferType.hpp"
 #include "../Flags.hpp"
+#include "../../utils/Span.hpp"
 #include "../../platform/objc/Pointer.hpp"
 
 namespace ouzel::graphics::metal
@@ -33,7 +34,7 @@ namespace ouzel::graphics::metal
                const std::vector<std::uint8_t>& initData,
                std::uint32_t initSize);
 
-        void setData(const std::vector<std::uint8_t>& data);
+        void setData(Span<const std::uint8_t> data);
 
         auto getFlags() const noexcept { return flags; }
         auto getType() const noexcept { return type; }
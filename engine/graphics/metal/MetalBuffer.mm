@@ -26,7 +26,7 @@ namespace ouzel::graphics::metal
             std::memcpy([buffer.get() contents], data.data(), data.size());
     }
 
-    void Buffer::setData(const std::vector<std::uint8_t>& data)
+    void Buffer::setData(Span<const std::uint8_t> data)
     {
         if ((flags & Flags::dynamic) != Flags::dynamic)
             throw Error{"Buffer is not dynamic"};
@@ -125,6 +125,17 @@ namespace ouzel::graphics::metal
             clampToBorderSupported = true;
 #endif
 
+#if TARGET_OS_IOS
+        etc2TexturesSupported = true;
+        astcTexturesSupported = [device.get() supportsFeatureSet:MTLFeatureSet_iOS_GPUFamily2_v1];
+#elif TARGET_OS_TV
+        etc2TexturesSupported = true;
+        astcTexturesSupported = true;
+#else
+        bcTexturesSupported = true;
+        bc7TexturesSupported = true;
+#endif
+
         metalCommandQueue = [device.get() newCommandQueue];
 
         if (!metalCommandQueue)
@@ -259,15 +270,12 @@ namespace ouzel::graphics::metal
         const Shader* currentShader = nullptr;
 
         CommandBuffer commandBuffer;
-        std::unique_ptr<Command> command;
+        const Command* command;
 
         for (;;)
         {
-            std::unique_lock lock{commandQueueMutex};
-            commandQueueCondition.wait(lock, [this]() noexcept { return !commandQueue.empty(); });
-            commandBuffer = std::move(commandQueue.front());
-            commandQueue.pop();
-            lock.unlock();
+            // interrupted when the device is being stopped
+            if (!waitForCommandBuffer(commandBuffer)) return;
 
             while (!commandBuffer.isEmpty())
             {
@@ -277,7 +285,7 @@ namespace ouzel::graphics::metal
                 {
                     case Command::Type::resize:
                     {
-                        const auto resizeCommand = static_cast<const ResizeCommand*>(command.get());
+                        const auto resizeCommand = static_cast<const ResizeCommand*>(command);
                         const CGSize drawableSize = CGSizeMake(resizeCommand->size.v[0],
                                                                resizeCommand->size.v[1]);
                         metalLayer.drawableSize = drawableSize;
@@ -286,6 +294,9 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::present:
                     {
+                        drawCallCount = frameDrawCallCount;
+                        frameDrawCallCount = 0;
+
                         if (currentRenderCommandEncoder)
                             [currentRenderCommandEncoder endEncoding];
 
@@ -299,14 +310,14 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::deleteResource:
                     {
-                        const auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command.get());
+                        const auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command);
                         resources[deleteResourceCommand->resource - 1].reset();
                         break;
                     }
 
                     case Command::Type::initRenderTarget:
                     {
-                        const auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command.get());
+                        const auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command);
 
                         std::set<Texture*> colorTextures;
                         for (const auto colorTextureId : initRenderTargetCommand->colorTextures)
@@ -324,7 +335,7 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::setRenderTarget:
                     {
-                        const auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command.get());
+                        const auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command);
 
                         MTLRenderPassDescriptorPtr newRenderPassDescriptor;
 
@@ -370,7 +381,7 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::clearRenderTarget:
                     {
-                        const auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command.get());
+                        const auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command);
 
                         if (currentRenderCommandEncoder)
                             [currentRenderCommandEncoder endEncoding];
@@ -406,7 +417,7 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::setScissorTest:
                     {
-                        const auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command.get());
+                        const auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command);
 
                         // create a new render command encoder to set up a new scissor rect
                         if (currentRenderCommandEncoder)
@@ -428,7 +439,7 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::setViewport:
                     {
-                        const auto setViewportCommand = static_cast<const SetViewportCommand*>(command.get());
+                        const auto setViewportCommand = static_cast<const SetViewportCommand*>(command);
 
                         if (!currentRenderCommandEncoder)
                             throw Error{"Metal render command encoder not initialized"};
@@ -448,7 +459,7 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::initDepthStencilState:
                     {
-                        const auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command.get());
+                        const auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command);
                         auto depthStencilState = std::make_unique<DepthStencilState>(*this,
                                                                                      initDepthStencilStateCommand->depthTest,
                                                                                      initDepthStencilStateCommand->depthWrite,
@@ -474,7 +485,7 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::setDepthStencilState:
                     {
-                        const auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command.get());
+                        const auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command);
 
                         if (!currentRenderCommandEncoder)
                             throw Error{"Metal render command encoder not initialized"};
@@ -495,7 +506,7 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::setPipelineState:
                     {
-                        const auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command.get());
+                        const auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command);
 
                         if (!currentRenderCommandEncoder)
                             throw Error{"Metal render command encoder not initialized"};
@@ -518,7 +529,8 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::draw:
                     {
-                        const auto drawCommand = static_cast<const DrawCommand*>(command.get());
+                        const auto drawCommand = static_cast<const DrawCommand*>(command);
+                        ++frameDrawCallCount;
 
                         if (!currentRenderCommandEncoder)
                             throw Error{"Metal render command encoder not initialized"};
@@ -550,7 +562,7 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::initBlendState:
                     {
-                        const auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command.get());
+                        const auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command);
 
                         auto blendState = std::make_unique<BlendState>(*this,
                                                                        initBlendStateCommand->enableBlending,
@@ -570,7 +582,7 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::initBuffer:
                     {
-                        const auto initBufferCommand = static_cast<const InitBufferCommand*>(command.get());
+                        const auto initBufferCommand = static_cast<const InitBufferCommand*>(command);
 
                         auto buffer = std::make_unique<Buffer>(*this,
                                                                 initBufferCommand->bufferType,
@@ -586,16 +598,16 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::setBufferData:
                     {
-                        const auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command.get());
+                        const auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command);
 
                         const auto buffer = getResource<Buffer>(setBufferDataCommand->buffer);
-                        buffer->setData(setBufferDataCommand->data);
+                        buffer->setData(setBufferDataCommand->getData());
                         break;
                     }
 
                     case Command::Type::initShader:
                     {
-                        const auto initShaderCommand = static_cast<const InitShaderCommand*>(command.get());
+                        const auto initShaderCommand = static_cast<const InitShaderCommand*>(command);
 
                         auto shader = std::make_unique<Shader>(*this,
                                                                initShaderCommand->fragmentShader,
@@ -614,7 +626,7 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::setShaderConstants:
                     {
-                        const auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command.get());
+                        const auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command);
 
                         if (!currentRenderCommandEncoder)
                             throw Error{"Metal render command encoder not initialized"};
@@ -625,15 +637,15 @@ namespace ouzel::graphics::metal
                         // pixel shader constants
                         const auto& fragmentShaderConstantLocations = currentShader->getFragmentShaderConstantLocations();
 
-                        if (setShaderConstantsCommand->fragmentShaderConstants.size() > fragmentShaderConstantLocations.size())
+                        if (setShaderConstantsCommand->fragmentShaderConstantCount > fragmentShaderConstantLocations.size())
                             throw Error{"Invalid pixel shader constant size"};
 
                         shaderData.clear();
 
-                        for (std::size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstants.size(); ++i)
+                        for (std::size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstantCount; ++i)
                         {
                             const auto& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
-                            const auto& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
+                            const auto fragmentShaderConstant = setShaderConstantsCommand->getFragmentShaderConstant(i);
 
                             if (sizeof(float) * fragmentShaderConstant.size() != fragmentShaderConstantLocation.size)
                                 throw Error{"Invalid pixel shader constant size"};
@@ -675,15 +687,15 @@ namespace ouzel::graphics::metal
                         // vertex shader constants
                         const auto& vertexShaderConstantLocations = currentShader->getVertexShaderConstantLocations();
 
-                        if (setShaderConstantsCommand->vertexShaderConstants.size() > vertexShaderConstantLocations.size())
+                        if (setShaderConstantsCommand->vertexShaderConstantCount > vertexShaderConstantLocations.size())
                             throw Error{"Invalid vertex shader constant size"};
 
                         shaderData.clear();
 
-                        for (std::size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstants.size(); ++i)
+                        for (std::size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstantCount; ++i)
                         {
                             const auto& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                            const auto& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
+                            const auto vertexShaderConstant = setShaderConstantsCommand->getVertexShaderConstant(i);
 
                             if (sizeof(float) * vertexShaderConstant.size() != vertexShaderConstantLocation.size)
                                 throw Error{"Invalid vertex shader constant size"};
@@ -727,7 +739,7 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::initTexture:
                     {
-                        const auto initTextureCommand = static_cast<const InitTextureCommand*>(command.get());
+                        const auto initTextureCommand = static_cast<const InitTextureCommand*>(command);
 
                         auto texture = std::make_unique<Texture>(*this,
                                                                  initTextureCommand->levels,
@@ -746,17 +758,17 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::setTextureData:
                     {
-                        const auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command.get());
+                        const auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command);
 
                         const auto texture = getResource<Texture>(setTextureDataCommand->texture);
-                        texture->setData(setTextureDataCommand->levels);
+                        texture->setData(setTextureDataCommand->levels, setTextureDataCommand->offset);
 
                         break;
                     }
 
                     case Command::Type::setTextureParameters:
                     {
-                        const auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command.get());
+                        const auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command);
 
                         const auto texture = getResource<Texture>(setTextureParametersCommand->texture);
                         texture->setFilter(setTextureParametersCommand->filter);
@@ -770,14 +782,16 @@ namespace ouzel::graphics::metal
 
                     case Command::Type::setTextures:
                     {
-                        const auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command.get());
+                        const auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command);
 
                         if (!currentRenderCommandEncoder)
                             throw Error{"Metal render command encoder not initialized"};
 
-                        for (std::size_t layer = 0; layer < setTexturesCommand->textures.size(); ++layer)
+                        const auto textures = setTexturesCommand->getTextures();
+
+                        for (std::size_t layer = 0; layer < textures.size(); ++layer)
                         {
-                            if (auto texture = getResource<Texture>(setTexturesCommand->textures[layer]))
+                            if (auto texture = getResource<Texture>(textures[layer]))
                             {
                                 [currentRenderCommandEncoder setFragmentTexture:texture->getTexture().get() atIndex:layer];
                                 [currentRenderCommandEncoder setFragmentSamplerState:texture->getSamplerState() atIndex:layer];
@@ -795,8 +809,14 @@ namespace ouzel::graphics::metal
                     default: throw Error{"Invalid command"};
                 }
 
-                if (command->type == Command::Type::present) return;
+                if (command->type == Command::Type::present)
+                {
+                    recycleCommandBuffer(std::move(commandBuffer));
+                    return;
+                }
             }
+
+            recycleCommandBuffer(std::move(commandBuffer));
         }
     }
 
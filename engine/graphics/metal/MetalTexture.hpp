@@ -31,6 +31,7 @@ using MTLLoadAction = NSUInteger;
 #include "../SamplerFilter.hpp"
 #include "../TextureType.hpp"
 #include "../../math/Size.hpp"
+#include "../../math/Vector.hpp"
 #include "../../platform/objc/Pointer.hpp"
 
 namespace ouzel::graphics::metal
@@ -65,7 +66,8 @@ namespace ouzel::graphics::metal
                 SamplerFilter initFilter,
                 std::uint32_t initMaxAnisotropy);
 
-        void setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& levels);
+        void setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& levels,
+                     const math::Vector<std::uint32_t, 2>& offset = {});
         void setFilter(SamplerFilter filter);
         void setAddressX(SamplerAddressMode addressX);
         void setAddressY(SamplerAddressMode addressY);
@@ -49,6 +49,23 @@ namespace ouzel::graphics::metal
                 case PixelFormat::rgba32Float: return MTLPixelFormatRGBA32Float;
                 case PixelFormat::depth: return MTLPixelFormatDepth32Float;
                 case PixelFormat::depthStencil: return MTLPixelFormatDepth32Float_Stencil8; // MTLPixelFormatDepth24Unorm_Stencil8 is only available on macOS
+#if TARGET_OS_IOS || TARGET_OS_TV
+                case PixelFormat::etc2RgbUnsignedNorm: return MTLPixelFormatETC2_RGB8;
+                case PixelFormat::etc2RgbUnsignedNormSRGB: return MTLPixelFormatETC2_RGB8_sRGB;
+                case PixelFormat::etc2RgbaUnsignedNorm: return MTLPixelFormatEAC_RGBA8;
+                case PixelFormat::etc2RgbaUnsignedNormSRGB: return MTLPixelFormatEAC_RGBA8_sRGB;
+                case PixelFormat::astc4x4RgbaUnsignedNorm: return MTLPixelFormatASTC_4x4_LDR;
+                case PixelFormat::astc4x4RgbaUnsignedNormSRGB: return MTLPixelFormatASTC_4x4_sRGB;
+#else
+                case PixelFormat::bc1RgbaUnsignedNorm: return MTLPixelFormatBC1_RGBA;
+                case PixelFormat::bc1RgbaUnsignedNormSRGB: return MTLPixelFormatBC1_RGBA_sRGB;
+                case PixelFormat::bc3RgbaUnsignedNorm: return MTLPixelFormatBC3_RGBA;
+                case PixelFormat::bc3RgbaUnsignedNormSRGB: return MTLPixelFormatBC3_RGBA_sRGB;
+                case PixelFormat::bc4RUnsignedNorm: return MTLPixelFormatBC4_RUnorm;
+                case PixelFormat::bc5RgUnsignedNorm: return MTLPixelFormatBC5_RGUnorm;
+                case PixelFormat::bc7RgbaUnsignedNorm: return MTLPixelFormatBC7_RGBAUnorm;
+                case PixelFormat::bc7RgbaUnsignedNormSRGB: return MTLPixelFormatBC7_RGBAUnorm_sRGB;
+#endif
                 default: throw std::runtime_error{"Invalid pixel format"};
             }
         }
@@ -182,7 +199,7 @@ namespace ouzel::graphics::metal
                                                                  static_cast<NSUInteger>(levels[level].first.v[1]))
                                      mipmapLevel:level
                                        withBytes:levels[level].second.data()
-                                     bytesPerRow:static_cast<NSUInteger>(levels[level].first.v[0] * pixelSize)];
+                                     bytesPerRow:static_cast<NSUInteger>(getRowSize(initPixelFormat, levels[level].first.v[0]))];
             }
         }
 
@@ -195,7 +212,8 @@ namespace ouzel::graphics::metal
         updateSamplerState();
     }
 
-    void Texture::setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& levels)
+    void Texture::setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& levels,
+                          const math::Vector<std::uint32_t, 2>& offset)
     {
         if ((flags & Flags::dynamic) != Flags::dynamic ||
             (flags & Flags::bindRenderTarget) == Flags::bindRenderTarget)
@@ -204,7 +222,8 @@ namespace ouzel::graphics::metal
         for (std::size_t level = 0; level < levels.size(); ++level)
         {
             if (!levels[level].second.empty())
-                [texture.get() replaceRegion:MTLRegionMake2D(0, 0,
+                [texture.get() replaceRegion:MTLRegionMake2D(static_cast<NSUInteger>(offset.v[0] >> level),
+                                                             static_cast<NSUInteger>(offset.v[1] >> level),
                                                              static_cast<NSUInteger>(levels[level].first.v[0]),
                                                              static_cast<NSUInteger>(levels[level].first.v[1]))
                                  mipmapLevel:level
@@ -39,9 +39,7 @@ namespace ouzel::graphics::metal::ios
     {
         running = false;
         runLoop.stop();
-        CommandBuffer commandBuffer;
-        commandBuffer.pushCommand(std::make_unique<PresentCommand>());
-        submitCommandBuffer(std::move(commandBuffer));
+        wakeRenderThread();
     }
 
     void RenderDevice::start()
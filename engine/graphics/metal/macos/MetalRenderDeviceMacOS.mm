@@ -68,9 +68,7 @@ namespace ouzel::graphics::metal::macos
     RenderDevice::~RenderDevice()
     {
         running = false;
-        CommandBuffer commandBuffer;
-        commandBuffer.pushCommand(std::make_unique<PresentCommand>());
-        submitCommandBuffer(std::move(commandBuffer));
+        wakeRenderThread();
     }
 
     std::vector<math::Size<std::uint32_t, 2>> RenderDevice::getSupportedResolutions() const
@@ -103,9 +101,7 @@ namespace ouzel::graphics::metal::macos
     void RenderDevice::changeScreen(const std::uintptr_t screenId)
     {
         engine->executeOnMainThread([this, screenId]() {
-            CommandBuffer commandBuffer;
-            commandBuffer.pushCommand(std::make_unique<PresentCommand>());
-            submitCommandBuffer(std::move(commandBuffer));
+            wakeRenderThread();
 
             const auto displayId = static_cast<CGDirectDisplayID>(screenId);
             displayLink.setCurrentCGDisplay(displayId);
@@ -35,9 +35,7 @@ namespace ouzel::graphics::metal::tvos
     {
         running = false;
         runLoop.stop();
-        CommandBuffer commandBuffer;
-        commandBuffer.pushCommand(std::make_unique<PresentCommand>());
-        submitCommandBuffer(std::move(commandBuffer));
+        wakeRenderThread();
     }
 
     void RenderDevice::start()
@@ -23,6 +23,8 @@ namespace ouzel::graphics::opengl
     {
         createBuffer();
 
+        bufferSize = size;
+
         if (size > 0)
         {
             renderDevice.bindBuffer(bufferType, bufferId);
@@ -48,9 +50,12 @@ namespace ouzel::graphics::opengl
     void Buffer::reload()
     {
         bufferId = 0;
+        streamed = false;
 
         createBuffer();
 
+        bufferSize = size;
+
         if (size > 0)
         {
             renderDevice.bindBuffer(bufferType, bufferId);
@@ -67,7 +72,7 @@ namespace ouzel::graphics::opengl
         }
     }
 
-    void Buffer::setData(const std::vector<std::uint8_t>& newData)
+    void Buffer::setData(Span<const std::uint8_t> newData)
     {
         if ((flags & Flags::dynamic) != Flags::dynamic)
             throw Error{"Buffer is not dynamic"};
@@ -75,18 +80,57 @@ namespace ouzel::graphics::opengl
         if (newData.empty())
             throw std::invalid_argument{"Data is empty"};
 
-        data = newData;
+        data.assign(newData.begin(), newData.end());
 
         if (!bufferId)
             throw Error{"Buffer not initialized"};
 
+        if (static_cast<GLsizeiptr>(data.size()) > size)
+            size = static_cast<GLsizeiptr>(data.size());
+
+        // the data is copied to the buffer object only if it is used after the current frame
+        if (const auto streamingBuffer = renderDevice.getStreamingBuffer(bufferType))
+            if (const auto position = streamingBuffer->upload(newData))
+            {
+                streamed = true;
+                streamPosition = *position;
+                return;
+            }
+
+        streamed = false;
         renderDevice.bindBuffer(bufferType, bufferId);
+        uploadData();
+    }
 
-        if (static_cast<GLsizeiptr>(data.size()) > size)
+    GLintptr Buffer::bind()
+    {
+        if (streamed)
         {
-            size = static_cast<GLsizeiptr>(data.size());
+            const auto streamingBuffer = renderDevice.getStreamingBuffer(bufferType);
+
+            if (streamingBuffer->isValid(streamPosition))
+            {
+                renderDevice.bindBuffer(bufferType, streamingBuffer->getBufferId());
+                return streamingBuffer->getOffset(streamPosition);
+            }
+
+            streamed = false;
+            renderDevice.bindBuffer(bufferType, bufferId);
+            uploadData();
+        }
+        else
+            renderDevice.bindBuffer(bufferType, bufferId);
+
+        return 0;
+    }
+
+    void Buffer::uploadData()
+    {
+        if (static_cast<GLsizeiptr>(data.size()) > bufferSize)
+        {
+            bufferSize = static_cast<GLsizeiptr>(data.size());
 
-            renderDevice.glBufferDataProc(bufferType, size, data.data(), GL_DYNAMIC_DRAW);
+            renderDevice.glBufferDataProc(bufferType, bufferSize, data.data(), GL_DYNAMIC_DRAW);
 
             if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
                 throw std::system_error{makeErrorCode(error), "Failed to create buffer"};
@@ -22,6 +22,7 @@
 #include "OGLRenderResource.hpp"
 #include "../BufferType.hpp"
 #include "../Flags.hpp"
+#include "../../utils/Span.hpp"
 
 namespace ouzel::graphics::opengl
 {
@@ -39,7 +40,10 @@ namespace ouzel::graphics::opengl
 
         void reload() final;
 
-        void setData(const std::vector<std::uint8_t>& newData);
+        void setData(Span<const std::uint8_t> newData);
+
+        // binds the buffer that holds the data and returns the offset of the data in it
+        GLintptr bind();
 
         auto getFlags() const noexcept { return flags; }
         auto getType() const noexcept { return type; }
@@ -50,6 +54,7 @@ namespace ouzel::graphics::opengl
 
     private:
         void createBuffer();
+        void uploadData();
 
         BufferType type;
         Flags flags = Flags::none;
@@ -57,6 +62,11 @@ namespace ouzel::graphics::opengl
 
         GLuint bufferId = 0;
         GLsizeiptr size = 0;
+        GLsizeiptr bufferSize = 0;
+
+        // the data of the current frame is in the streaming buffer of the render device
+        bool streamed = false;
+        std::uint64_t streamPosition = 0;
 
         GLuint bufferType = 0;
     };
@@ -47,6 +47,39 @@ namespace ouzel::graphics::opengl
 {
     namespace
     {
+        constexpr GLsizeiptr indexStreamingBufferSize = 1024 * 1024;
+        constexpr GLsizeiptr vertexStreamingBufferSize = 4 * 1024 * 1024;
+        constexpr GLsizeiptr uniformStreamingBufferSize = 4 * 1024 * 1024;
+
+        // writes the value of the constant to its offset in the uniform block
+        void packConstant(std::vector<std::uint8_t>& block,
+                          const Shader::Location& location,
+                          Span<const float> value)
+        {
+            std::size_t columns = 1;
+            std::size_t columnSize = getDataTypeSize(location.dataType);
+
+            switch (location.dataType)
+            {
+                case DataType::float32Matrix3: columns = 3; columnSize = 3 * sizeof(float); break;
+                case DataType::float32Matrix4: columns = 4; columnSize = 4 * sizeof(float); break;
+                default: break;
+            }
+
+            const auto stride = location.matrixStride ? static_cast<std::size_t>(location.matrixStride) : columnSize;
+            const auto offset = static_cast<std::size_t>(location.blockOffset);
+
+            if (value.size() * sizeof(float) < columns * columnSize ||
+                offset + (columns - 1) * stride + columnSize > block.size())
+                throw Error{"Invalid shader constant size"};
+
+            const auto data = reinterpret_cast<const std::uint8_t*>(value.data());
+            for (std::size_t column = 0; column < columns; ++column)
+                std::copy(data + column * columnSize,
+                          data + (column + 1) * columnSize,
+                          block.data() + offset + column * stride);
+        }
+
         constexpr GLenum getIndexType(std::uint32_t indexSize)
         {
             switch (indexSize)
@@ -280,9 +313,14 @@ namespace ouzel::graphics::opengl
 
     RenderDevice::~RenderDevice()
     {
+        for (const auto& vertexArray : vertexArrays)
+            glDeleteVertexArraysProc(1, &vertexArray.second.vertexArrayId);
         if (vertexArrayId) glDeleteVertexArraysProc(1, &vertexArrayId);
+        if (frameTimerQueries[0]) glDeleteQueriesProc(static_cast<GLsizei>(frameTimerCount), frameTimerQueries.data());
 
         resources.clear();
+        indexStreamingBuffer.reset();
+        vertexStreamingBuffer.reset();
     }
 
     void RenderDevice::init(GLsizei newWidth, GLsizei newHeight)
@@ -330,6 +368,11 @@ namespace ouzel::graphics::opengl
         textureMaxLevelSupported = apiVersion >= ApiVersion{3, 0} || getter.hasExtension("GL_APPLE_texture_max_level");
         uintIndicesSupported = apiVersion >= ApiVersion{3, 0} || getter.hasExtension("OES_element_index_uint");
         anisotropicFilteringSupported = getter.hasExtension("GL_EXT_texture_filter_anisotropic");
+        bcTexturesSupported = getter.hasExtension("GL_EXT_texture_compression_s3tc") &&
+            getter.hasExtension("GL_EXT_texture_compression_rgtc");
+        bc7TexturesSupported = getter.hasExtension("GL_EXT_texture_compression_bptc");
+        etc2TexturesSupported = apiVersion >= ApiVersion{3, 0};
+        astcTexturesSupported = apiVersion >= ApiVersion{3, 2} || getter.hasExtension("GL_KHR_texture_compression_astc_ldr");
 
         glEnableProc = getter.get<PFNGLENABLEPROC>("glEnable", ApiVersion{1, 0});
         glDisableProc = getter.get<PFNGLDISABLEPROC>("glDisable", ApiVersion{1, 0});
@@ -343,6 +386,9 @@ namespace ouzel::graphics::opengl
         glTexParameterfvProc = getter.get<PFNGLTEXPARAMETERFVPROC>("glTexParameterfv", ApiVersion{1, 0});
         glTexImage2DProc = getter.get<PFNGLTEXIMAGE2DPROC>("glTexImage2D", ApiVersion{1, 0});
         glTexSubImage2DProc = getter.get<PFNGLTEXSUBIMAGE2DPROC>("glTexSubImage2D", ApiVersion{1, 0});
+        glPixelStoreiProc = getter.get<PFNGLPIXELSTOREIPROC>("glPixelStorei", ApiVersion{1, 0});
+        glCompressedTexImage2DProc = getter.get<PFNGLCOMPRESSEDTEXIMAGE2DPROC>("glCompressedTexImage2D", ApiVersion{2, 0});
+        glCompressedTexSubImage2DProc = getter.get<PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC>("glCompressedTexSubImage2D", ApiVersion{2, 0});
         glViewportProc = getter.get<PFNGLVIEWPORTPROC>("glViewport", ApiVersion{1, 0});
         glClearProc = getter.get<PFNGLCLEARPROC>("glClear", ApiVersion{1, 0});
         glClearColorProc = getter.get<PFNGLCLEARCOLORPROC>("glClearColor", ApiVersion{1, 0});
@@ -431,6 +477,14 @@ namespace ouzel::graphics::opengl
         glUnmapBufferProc = getter.get<PFNGLUNMAPBUFFERPROC>("glUnmapBuffer", ApiVersion{3, 0},
                                                              {{"glUnmapBufferOES", "GL_OES_mapbuffer"}});
 
+        glFenceSyncProc = getter.get<PFNGLFENCESYNCPROC>("glFenceSync", ApiVersion{3, 0},
+                                                         {{"glFenceSyncAPPLE", "GL_APPLE_sync"}});
+        glClientWaitSyncProc = getter.get<PFNGLCLIENTWAITSYNCPROC>("glClientWaitSync", ApiVersion{3, 0},
+                                                                   {{"glClientWaitSyncAPPLE", "GL_APPLE_sync"}});
+        glDeleteSyncProc = getter.get<PFNGLDELETESYNCPROC>("glDeleteSync", ApiVersion{3, 0},
+                                                           {{"glDeleteSyncAPPLE", "GL_APPLE_sync"}});
+        glBufferStorageProc = getter.get<PFNGLBUFFERSTORAGEEXTPROC>("glBufferStorageEXT", "GL_EXT_buffer_storage");
+
         glGenVertexArraysProc = getter.get<PFNGLGENVERTEXARRAYSPROC>("glGenVertexArrays", ApiVersion{3, 0},
                                                                      {{"glGenVertexArraysOES", "GL_OES_vertex_array_object"}});
         glBindVertexArrayProc = getter.get<PFNGLBINDVERTEXARRAYPROC>("glBindVertexArray", ApiVersion{3, 0},
@@ -443,6 +497,20 @@ namespace ouzel::graphics::opengl
 
         glCopyImageSubDataProc = getter.get<PFNGLCOPYIMAGESUBDATAPROC>("glCopyImageSubData", ApiVersion{3, 2});
 
+        glGetUniformBlockIndexProc = getter.get<PFNGLGETUNIFORMBLOCKINDEXPROC>("glGetUniformBlockIndex", ApiVersion{3, 0});
+        glUniformBlockBindingProc = getter.get<PFNGLUNIFORMBLOCKBINDINGPROC>("glUniformBlockBinding", ApiVersion{3, 0});
+        glGetActiveUniformBlockivProc = getter.get<PFNGLGETACTIVEUNIFORMBLOCKIVPROC>("glGetActiveUniformBlockiv", ApiVersion{3, 0});
+        glGetUniformIndicesProc = getter.get<PFNGLGETUNIFORMINDICESPROC>("glGetUniformIndices", ApiVersion{3, 0});
+        glGetActiveUniformsivProc = getter.get<PFNGLGETACTIVEUNIFORMSIVPROC>("glGetActiveUniformsiv", ApiVersion{3, 0});
+        glBindBufferRangeProc = getter.get<PFNGLBINDBUFFERRANGEPROC>("glBindBufferRange", ApiVersion{3, 0});
+
+        glGenQueriesProc = getter.get<PFNGLGENQUERIESPROC>("glGenQueriesEXT", "GL_EXT_disjoint_timer_query");
+        glDeleteQueriesProc = getter.get<PFNGLDELETEQUERIESPROC>("glDeleteQueriesEXT", "GL_EXT_disjoint_timer_query");
+        glBeginQueryProc = getter.get<PFNGLBEGINQUERYPROC>("glBeginQueryEXT", "GL_EXT_disjoint_timer_query");
+        glEndQueryProc = getter.get<PFNGLENDQUERYPROC>("glEndQueryEXT", "GL_EXT_disjoint_timer_query");
+        glGetQueryObjectuivProc = getter.get<PFNGLGETQUERYOBJECTUIVPROC>("glGetQueryObjectuivEXT", "GL_EXT_disjoint_timer_query");
+        glGetQueryObjectui64vProc = getter.get<PFNGLGETQUERYOBJECTUI64VEXTPROC>("glGetQueryObjectui64vEXT", "GL_EXT_disjoint_timer_query");
+
         glRenderbufferStorageMultisampleProc = getter.get<PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC>("glRenderbufferStorageMultisample", ApiVersion{3, 0},
                                                                                                    {{"glRenderbufferStorageMultisampleEXT", "GL_EXT_multisampled_render_to_texture"},
                                                                                                     {"glRenderbufferStorageMultisampleIMG", "GL_IMG_multisampled_render_to_texture"},
@@ -477,6 +545,11 @@ namespace ouzel::graphics::opengl
         anisotropicFilteringSupported = apiVersion >= ApiVersion{4, 6} ||
             getter.hasExtension("GL_EXT_texture_filter_anisotropic") ||
             getter.hasExtension("GL_ARB_texture_filter_anisotropic");
+        bcTexturesSupported = getter.hasExtension("GL_EXT_texture_compression_s3tc") &&
+            (apiVersion >= ApiVersion{3, 0} || getter.hasExtension("GL_ARB_texture_compression_rgtc"));
+        bc7TexturesSupported = apiVersion >= ApiVersion{4, 2} || getter.hasExtension("GL_ARB_texture_compression_bptc");
+        etc2TexturesSupported = apiVersion >= ApiVersion{4, 3} || getter.hasExtension("GL_ARB_ES3_compatibility");
+        astcTexturesSupported = getter.hasExtension("GL_KHR_texture_compression_astc_ldr");
 
         glEnableProc = getter.get<PFNGLENABLEPROC>("glEnable", ApiVersion{1, 0});
         glDisableProc = getter.get<PFNGLDISABLEPROC>("glDisable", ApiVersion{1, 0});
@@ -490,6 +563,9 @@ namespace ouzel::graphics::opengl
         glTexParameterfvProc = getter.get<PFNGLTEXPARAMETERFVPROC>("glTexParameterfv", ApiVersion{1, 0});
         glTexImage2DProc = getter.get<PFNGLTEXIMAGE2DPROC>("glTexImage2D", ApiVersion{1, 0});
         glTexSubImage2DProc = getter.get<PFNGLTEXSUBIMAGE2DPROC>("glTexSubImage2D", ApiVersion{1, 1});
+        glPixelStoreiProc = getter.get<PFNGLPIXELSTOREIPROC>("glPixelStorei", ApiVersion{1, 0});
+        glCompressedTexImage2DProc = getter.get<PFNGLCOMPRESSEDTEXIMAGE2DPROC>("glCompressedTexImage2D", ApiVersion{1, 3});
+        glCompressedTexSubImage2DProc = getter.get<PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC>("glCompressedTexSubImage2D", ApiVersion{1, 3});
         glViewportProc = getter.get<PFNGLVIEWPORTPROC>("glViewport", ApiVersion{1, 0});
         glClearProc = getter.get<PFNGLCLEARPROC>("glClear", ApiVersion{1, 0});
         glClearColorProc = getter.get<PFNGLCLEARCOLORPROC>("glClearColor", ApiVersion{1, 0});
@@ -564,6 +640,15 @@ namespace ouzel::graphics::opengl
         glMapBufferRangeProc = getter.get<PFNGLMAPBUFFERRANGEPROC>("glMapBufferRange", ApiVersion{3, 0},
                                                                    {{"glMapBufferRange", "GL_ARB_map_buffer_range"}});
 
+        glFenceSyncProc = getter.get<PFNGLFENCESYNCPROC>("glFenceSync", ApiVersion{3, 2},
+                                                         {{"glFenceSync", "GL_ARB_sync"}});
+        glClientWaitSyncProc = getter.get<PFNGLCLIENTWAITSYNCPROC>("glClientWaitSync", ApiVersion{3, 2},
+                                                                   {{"glClientWaitSync", "GL_ARB_sync"}});
+        glDeleteSyncProc = getter.get<PFNGLDELETESYNCPROC>("glDeleteSync", ApiVersion{3, 2},
+                                                           {{"glDeleteSync", "GL_ARB_sync"}});
+        glBufferStorageProc = getter.get<PFNGLBUFFERSTORAGEPROC>("glBufferStorage", ApiVersion{4, 4},
+                                                                 {{"glBufferStorage", "GL_ARB_buffer_storage"}});
+
         glGenVertexArraysProc = getter.get<PFNGLGENVERTEXARRAYSPROC>("glGenVertexArrays", ApiVersion{3, 0},
                                                                      {{"glGenVertexArrays", "GL_ARB_vertex_array_object"}});
         glBindVertexArrayProc = getter.get<PFNGLBINDVERTEXARRAYPROC>("glBindVertexArray", ApiVersion{3, 0},
@@ -623,12 +708,41 @@ namespace ouzel::graphics::opengl
 
         glPushGroupMarkerEXTProc = getter.get<PFNGLPUSHGROUPMARKEREXTPROC>("glPushGroupMarkerEXT", "GL_EXT_debug_marker");
         glPopGroupMarkerEXTProc = getter.get<PFNGLPOPGROUPMARKEREXTPROC>("glPopGroupMarkerEXT", "GL_EXT_debug_marker");
+
+        glGetUniformBlockIndexProc = getter.get<PFNGLGETUNIFORMBLOCKINDEXPROC>("glGetUniformBlockIndex", ApiVersion{3, 1},
+                                                                               {{"glGetUniformBlockIndex", "GL_ARB_uniform_buffer_object"}});
+        glUniformBlockBindingProc = getter.get<PFNGLUNIFORMBLOCKBINDINGPROC>("glUniformBlockBinding", ApiVersion{3, 1},
+                                                                             {{"glUniformBlockBinding", "GL_ARB_uniform_buffer_object"}});
+        glGetActiveUniformBlockivProc = getter.get<PFNGLGETACTIVEUNIFORMBLOCKIVPROC>("glGetActiveUniformBlockiv", ApiVersion{3, 1},
+                                                                                     {{"glGetActiveUniformBlockiv", "GL_ARB_uniform_buffer_object"}});
+        glGetUniformIndicesProc = getter.get<PFNGLGETUNIFORMINDICESPROC>("glGetUniformIndices", ApiVersion{3, 1},
+                                                                         {{"glGetUniformIndices", "GL_ARB_uniform_buffer_object"}});
+        glGetActiveUniformsivProc = getter.get<PFNGLGETACTIVEUNIFORMSIVPROC>("glGetActiveUniformsiv", ApiVersion{3, 1},
+                                                                             {{"glGetActiveUniformsiv", "GL_ARB_uniform_buffer_object"}});
+        glBindBufferRangeProc = getter.get<PFNGLBINDBUFFERRANGEPROC>("glBindBufferRange", ApiVersion{3, 0},
+                                                                     {{"glBindBufferRange", "GL_ARB_uniform_buffer_object"}});
+
+        glGenQueriesProc = getter.get<PFNGLGENQUERIESPROC>("glGenQueries", ApiVersion{1, 5});
+        glDeleteQueriesProc = getter.get<PFNGLDELETEQUERIESPROC>("glDeleteQueries", ApiVersion{1, 5});
+        glBeginQueryProc = getter.get<PFNGLBEGINQUERYPROC>("glBeginQuery", ApiVersion{1, 5});
+        glEndQueryProc = getter.get<PFNGLENDQUERYPROC>("glEndQuery", ApiVersion{1, 5});
+        glGetQueryObjectuivProc = getter.get<PFNGLGETQUERYOBJECTUIVPROC>("glGetQueryObjectuiv", ApiVersion{1, 5});
+        glGetQueryObjectui64vProc = getter.get<PFNGLGETQUERYOBJECTUI64VEXTPROC>("glGetQueryObjectui64v", ApiVersion{3, 3},
+                                                                               {{"glGetQueryObjectui64v", "GL_ARB_timer_query"},
+                                                                                {"glGetQueryObjectui64vEXT", "GL_EXT_timer_query"}});
 #endif
 
+        timerQueriesSupported = glGenQueriesProc && glDeleteQueriesProc &&
+            glBeginQueryProc && glEndQueryProc &&
+            glGetQueryObjectuivProc && glGetQueryObjectui64vProc;
+
         if (!multisamplingSupported) sampleCount = 1;
 
         glDisableProc(GL_DITHER);
 
+        // texture rows are tightly packed, single channel textures can have any width
+        glPixelStoreiProc(GL_UNPACK_ALIGNMENT, 1);
+
         if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
             throw std::system_error{makeErrorCode(error), "Failed to set depth function"};
 
@@ -652,15 +766,96 @@ namespace ouzel::graphics::opengl
         {
             glGenVertexArraysProc(1, &vertexArrayId);
 
-            glBindVertexArrayProc(vertexArrayId);
-
             if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
-                throw std::system_error{makeErrorCode(error), "Failed to bind vertex array"};
+                throw std::system_error{makeErrorCode(error), "Failed to create vertex array"};
+
+            bindVertexArray(vertexArrayId);
         }
 
+        createStreamingBuffers();
+
         setFrontFace(GL_CW);
     }
 
+    void RenderDevice::createStreamingBuffers()
+    {
+        if (glMapBufferRangeProc && glUnmapBufferProc)
+        {
+            if (indexStreamingBuffer)
+                indexStreamingBuffer->reload();
+            else
+                indexStreamingBuffer = std::make_unique<StreamingBuffer>(*this, GL_ELEMENT_ARRAY_BUFFER, indexStreamingBufferSize);
+
+            if (vertexStreamingBuffer)
+                vertexStreamingBuffer->reload();
+            else
+                vertexStreamingBuffer = std::make_unique<StreamingBuffer>(*this, GL_ARRAY_BUFFER, vertexStreamingBufferSize);
+
+            if (uniformStreamingBuffer)
+                uniformStreamingBuffer->reload();
+            else if (glGetUniformBlockIndexProc &&
+                     glUniformBlockBindingProc &&
+                     glGetActiveUniformBlockivProc &&
+                     glGetUniformIndicesProc &&
+                     glGetActiveUniformsivProc &&
+                     glBindBufferRangeProc)
+            {
+                GLint alignment = 0;
+                glGetIntegervProc(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+                if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                    throw std::system_error{makeErrorCode(error), "Failed to get uniform buffer offset alignment"};
+
+                uniformStreamingBuffer = std::make_unique<StreamingBuffer>(*this, GL_UNIFORM_BUFFER, uniformStreamingBufferSize,
+                                                                           static_cast<std::uint64_t>(std::max(alignment, 16)));
+            }
+
+            constantBlocks = {};
+        }
+    }
+
+    void RenderDevice::bindConstantBlock(GLuint binding)
+    {
+        auto& constantBlock = constantBlocks[binding];
+
+        // the same constants uploaded earlier in this frame are still in the ring
+        if (constantBlock.bound &&
+            uniformStreamingBuffer->isValid(constantBlock.position) &&
+            constantBlock.data == constantBlockData)
+        {
+            ++frameCallCounts.skippedUniformUploads;
+            return;
+        }
+
+        auto position = uniformStreamingBuffer->upload(constantBlockData);
+
+        if (!position)
+        {
+            // the frame has filled the ring, so fence it and wait for the GPU to read the oldest constants
+            uniformStreamingBuffer->endFrame();
+            position = uniformStreamingBuffer->upload(constantBlockData);
+
+            if (!position)
+                throw Error{"Failed to upload shader constants"};
+        }
+
+        const auto bufferId = uniformStreamingBuffer->getBufferId();
+        glBindBufferRangeProc(GL_UNIFORM_BUFFER, binding, bufferId,
+                              uniformStreamingBuffer->getOffset(*position),
+                              static_cast<GLsizeiptr>(constantBlockData.size()));
+
+        // also binds the buffer to the generic binding point
+        stateCache.bufferId[GL_UNIFORM_BUFFER] = bufferId;
+        ++frameCallCounts.uniformBufferBinds;
+
+        if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+            throw std::system_error{makeErrorCode(error), "Failed to bind uniform buffer"};
+
+        constantBlock.data = constantBlockData;
+        constantBlock.position = *position;
+        constantBlock.bound = true;
+    }
+
     void RenderDevice::setUniform(GLint location, DataType dataType, const void* data)
     {
         switch (dataType)
@@ -716,24 +911,149 @@ namespace ouzel::graphics::opengl
         }
     }
 
+    void RenderDevice::setVertexAttributes(GLuint bufferId, GLintptr offset)
+    {
+        VertexArray* vertexArray = &defaultVertexArray;
+
+        if (glGenVertexArraysProc)
+        {
+            vertexArray = &vertexArrays[bufferId];
+
+            if (!vertexArray->vertexArrayId)
+            {
+                glGenVertexArraysProc(1, &vertexArray->vertexArrayId);
+
+                if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                {
+                    vertexArrays.erase(bufferId);
+                    throw std::system_error{makeErrorCode(error), "Failed to create vertex array"};
+                }
+            }
+
+            bindVertexArray(vertexArray->vertexArrayId);
+        }
+
+        if (vertexArray->bufferId == bufferId && vertexArray->offset == offset)
+            return;
+
+        const std::byte* vertexOffset = nullptr;
+        vertexOffset += offset;
+
+        for (GLuint index = 0; index < RenderDevice::vertexAttributes.size(); ++index)
+        {
+            const auto& vertexAttribute = RenderDevice::vertexAttributes[index];
+
+            // the enabled state is kept by the vertex array
+            if (vertexArray->offset == -1)
+                glEnableVertexAttribArrayProc(index);
+
+            glVertexAttribPointerProc(index,
+                                      getArraySize(vertexAttribute.dataType),
+                                      getVertexType(vertexAttribute.dataType),
+                                      isNormalized(vertexAttribute.dataType),
+                                      static_cast<GLsizei>(sizeof(Vertex)),
+                                      vertexOffset);
+
+            vertexOffset += getDataTypeSize(vertexAttribute.dataType);
+        }
+
+        frameCallCounts.vertexAttributeUpdates += static_cast<std::uint32_t>(RenderDevice::vertexAttributes.size());
+
+        if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+        {
+            *vertexArray = VertexArray{vertexArray->vertexArrayId};
+            throw std::system_error{makeErrorCode(error), "Failed to update vertex attributes"};
+        }
+
+        vertexArray->bufferId = bufferId;
+        vertexArray->offset = offset;
+    }
+
+    void RenderDevice::beginFrameTimer()
+    {
+        readFrameTimers();
+
+        if (!timerQueriesSupported || !profiler.isRecording() ||
+            frameTimerRunning || pendingFrameTimerCount == frameTimerCount)
+            return;
+
+        if (!frameTimerQueries[0])
+        {
+            glGenQueriesProc(static_cast<GLsizei>(frameTimerCount), frameTimerQueries.data());
+
+            if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                throw std::system_error{makeErrorCode(error), "Failed to create timer queries"};
+
+            gpuTrack = &profiler.createTrack("GPU");
+        }
+
+        const auto index = (firstFrameTimer + pendingFrameTimerCount) % frameTimerCount;
+        glBeginQueryProc(GL_TIME_ELAPSED_EXT, frameTimerQueries[index]);
+        frameTimerStarts[index] = Profiler::now();
+        frameTimerRunning = true;
+    }
+
+    void RenderDevice::endFrameTimer()
+    {
+        if (!frameTimerRunning) return;
+
+        glEndQueryProc(GL_TIME_ELAPSED_EXT);
+        frameTimerRunning = false;
+        ++pendingFrameTimerCount;
+    }
+
+    void RenderDevice::readFrameTimers()
+    {
+        if (!pendingFrameTimerCount) return;
+
+#if OUZEL_OPENGLES
+        // the results are undefined if the GPU was reset or its frequency changed
+        GLint disjoint = 0;
+        glGetIntegervProc(GL_GPU_DISJOINT_EXT, &disjoint);
+        if (disjoint)
+        {
+            firstFrameTimer = (firstFrameTimer + pendingFrameTimerCount) % frameTimerCount;
+            pendingFrameTimerCount = 0;
+            return;
+        }
+#endif
+
+        // queries finish in order, so the reading stops at the first one that is not available yet
+        while (pendingFrameTimerCount)
+        {
+            const auto query = frameTimerQueries[firstFrameTimer];
+
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuivProc(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) break;
+
+            GLuint64 duration = 0;
+            glGetQueryObjectui64vProc(query, GL_QUERY_RESULT, &duration);
+            gpuTrack->push("GPU frame", frameTimerStarts[firstFrameTimer], duration);
+
+            firstFrameTimer = (firstFrameTimer + 1) % frameTimerCount;
+            --pendingFrameTimerCount;
+        }
+    }
+
     void RenderDevice::process()
     {
         graphics::RenderDevice::process();
         executeAll();
 
         const RenderTarget* currentRenderTarget = nullptr;
-        const Shader* currentShader = nullptr;
+        Shader* currentShader = nullptr;
 
         CommandBuffer commandBuffer;
-        std::unique_ptr<Command> command;
+        const Command* command;
 
         for (;;)
         {
-            std::unique_lock lock{commandQueueMutex};
-            commandQueueCondition.wait(lock, [this]() noexcept { return !commandQueue.empty(); });
-            commandBuffer = std::move(commandQueue.front());
-            commandQueue.pop();
-            lock.unlock();
+            // interrupted when the device is being stopped
+            if (!waitForCommandBuffer(commandBuffer)) return;
+
+            OUZEL_PROFILE_SCOPE("RenderDevice::process");
+            beginFrameTimer();
 
             while (!commandBuffer.isEmpty())
             {
@@ -743,7 +1063,7 @@ namespace ouzel::graphics::opengl
                 {
                     case Command::Type::resize:
                     {
-                        const auto resizeCommand = static_cast<const ResizeCommand*>(command.get());
+                        const auto resizeCommand = static_cast<const ResizeCommand*>(command);
                         frameBufferWidth = static_cast<GLsizei>(resizeCommand->size.v[0]);
                         frameBufferHeight = static_cast<GLsizei>(resizeCommand->size.v[1]);
                         resizeFrameBuffer();
@@ -752,20 +1072,32 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::present:
                     {
+                        drawCallCount = frameDrawCallCount;
+                        frameDrawCallCount = 0;
+
+                        publishCallCounts();
+
+                        if (indexStreamingBuffer) indexStreamingBuffer->endFrame();
+                        if (vertexStreamingBuffer) vertexStreamingBuffer->endFrame();
+                        if (uniformStreamingBuffer) uniformStreamingBuffer->endFrame();
+
+                        endFrameTimer();
+
+                        OUZEL_PROFILE_SCOPE("RenderDevice::present");
                         present();
                         break;
                     }
 
                     case Command::Type::deleteResource:
                     {
-                        const auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command.get());
+                        const auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command);
                         resources[deleteResourceCommand->resource - 1].reset();
                         break;
                     }
 
                     case Command::Type::initRenderTarget:
                     {
-                        const auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command.get());
+                        const auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command);
 
                         std::set<Texture*> colorTextures;
                         for (const auto colorTextureId : initRenderTargetCommand->colorTextures)
@@ -783,7 +1115,7 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::setRenderTarget:
                     {
-                        const auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command.get());
+                        const auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command);
 
                         if (setRenderTargetCommand->renderTarget)
                         {
@@ -804,7 +1136,7 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::clearRenderTarget:
                     {
-                        const auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command.get());
+                        const auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command);
 
                         const GLbitfield clearMask = (clearCommand->clearColorBuffer ? GL_COLOR_BUFFER_BIT : 0) |
                             (clearCommand->clearDepthBuffer ? GL_DEPTH_BUFFER_BIT : 0 |
@@ -858,7 +1190,7 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::setScissorTest:
                     {
-                        const auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command.get());
+                        const auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command);
 
                         setScissorTest(setScissorTestCommand->enabled,
                                        static_cast<GLint>(setScissorTestCommand->rectangle.position.v[0]),
@@ -871,7 +1203,7 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::setViewport:
                     {
-                        const auto setViewportCommand = static_cast<const SetViewportCommand*>(command.get());
+                        const auto setViewportCommand = static_cast<const SetViewportCommand*>(command);
 
                         setViewport(static_cast<GLint>(setViewportCommand->viewport.position.v[0]),
                                     static_cast<GLint>(setViewportCommand->viewport.position.v[1]),
@@ -883,7 +1215,7 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::initDepthStencilState:
                     {
-                        const auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command.get());
+                        const auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command);
                         auto depthStencilState = std::make_unique<DepthStencilState>(*this,
                                                                                      initDepthStencilStateCommand->depthTest,
                                                                                      initDepthStencilStateCommand->depthWrite,
@@ -908,7 +1240,7 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::setDepthStencilState:
                     {
-                        const auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command.get());
+                        const auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command);
 
                         if (setDepthStencilStateCommand->depthStencilState)
                         {
@@ -953,7 +1285,7 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::setPipelineState:
                     {
-                        const auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command.get());
+                        const auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command);
 
                         const auto blendState = getResource<BlendState>(setPipelineStateCommand->blendState);
                         const auto shader = getResource<Shader>(setPipelineStateCommand->shader);
@@ -1003,7 +1335,8 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::draw:
                     {
-                        const auto drawCommand = static_cast<const DrawCommand*>(command.get());
+                        const auto drawCommand = static_cast<const DrawCommand*>(command);
+                        ++frameDrawCallCount;
 
                         // mesh buffer
                         const auto indexBuffer = getResource<Buffer>(drawCommand->indexBuffer);
@@ -1015,35 +1348,18 @@ namespace ouzel::graphics::opengl
                         assert(vertexBuffer->getBufferId());
 
                         // draw
-                        bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer->getBufferId());
-                        bindBuffer(GL_ARRAY_BUFFER, vertexBuffer->getBufferId());
-
-                        const std::byte* vertexOffset = nullptr;
-
-                        for (GLuint index = 0; index < RenderDevice::vertexAttributes.size(); ++index)
-                        {
-                            const auto& vertexAttribute = RenderDevice::vertexAttributes[index];
+                        const auto vertexBufferOffset = vertexBuffer->bind();
+                        setVertexAttributes(stateCache.bufferId[GL_ARRAY_BUFFER], vertexBufferOffset);
 
-                            glEnableVertexAttribArrayProc(index);
-                            glVertexAttribPointerProc(index,
-                                                      getArraySize(vertexAttribute.dataType),
-                                                      getVertexType(vertexAttribute.dataType),
-                                                      isNormalized(vertexAttribute.dataType),
-                                                      static_cast<GLsizei>(sizeof(Vertex)),
-                                                      vertexOffset);
-
-                            vertexOffset += getDataTypeSize(vertexAttribute.dataType);
-                        }
-
-                        if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
-                            throw std::system_error{makeErrorCode(error), "Failed to update vertex attributes"};
+                        // bound after the vertex array, because the binding is stored in it
+                        const auto indexBufferOffset = indexBuffer->bind();
 
                         assert(drawCommand->indexCount);
                         assert(indexBuffer->getSize());
                         assert(vertexBuffer->getSize());
 
                         const std::byte* indexOffset = nullptr;
-                        indexOffset += drawCommand->startIndex * drawCommand->indexSize;
+                        indexOffset += indexBufferOffset + drawCommand->startIndex * drawCommand->indexSize;
 
                         glDrawElementsProc(getDrawMode(drawCommand->drawMode),
                                            static_cast<GLsizei>(drawCommand->indexCount),
@@ -1058,7 +1374,7 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::initBlendState:
                     {
-                        const auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command.get());
+                        const auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command);
 
                         auto blendState = std::make_unique<BlendState>(*this,
                                                                        initBlendStateCommand->enableBlending,
@@ -1078,7 +1394,7 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::initBuffer:
                     {
-                        const auto initBufferCommand = static_cast<const InitBufferCommand*>(command.get());
+                        const auto initBufferCommand = static_cast<const InitBufferCommand*>(command);
 
                         auto buffer = std::make_unique<Buffer>(*this,
                                                                initBufferCommand->bufferType,
@@ -1094,16 +1410,16 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::setBufferData:
                     {
-                        const auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command.get());
+                        const auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command);
 
                         const auto buffer = getResource<Buffer>(setBufferDataCommand->buffer);
-                        buffer->setData(setBufferDataCommand->data);
+                        buffer->setData(setBufferDataCommand->getData());
                         break;
                     }
 
                     case Command::Type::initShader:
                     {
-                        const auto initShaderCommand = static_cast<const InitShaderCommand*>(command.get());
+                        const auto initShaderCommand = static_cast<const InitShaderCommand*>(command);
 
                         auto shader = std::make_unique<Shader>(*this,
                                                                initShaderCommand->fragmentShader,
@@ -1122,7 +1438,7 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::setShaderConstants:
                     {
-                        const auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command.get());
+                        const auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command);
 
                         if (!currentShader)
                             throw Error{"No shader set"};
@@ -1130,33 +1446,73 @@ namespace ouzel::graphics::opengl
                         // pixel shader constants
                         const auto& fragmentShaderConstantLocations = currentShader->getFragmentShaderConstantLocations();
 
-                        if (setShaderConstantsCommand->fragmentShaderConstants.size() > fragmentShaderConstantLocations.size())
+                        if (setShaderConstantsCommand->fragmentShaderConstantCount > fragmentShaderConstantLocations.size())
                             throw Error{"Invalid pixel shader constant size"};
 
-                        for (std::size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstants.size(); ++i)
+                        if (const auto blockSize = currentShader->getFragmentShaderConstantBlockSize())
                         {
-                            const auto& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
-                            const auto& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
+                            constantBlockData.assign(static_cast<std::size_t>(blockSize), 0);
 
-                            setUniform(fragmentShaderConstantLocation.location,
-                                       fragmentShaderConstantLocation.dataType,
-                                       fragmentShaderConstant.data());
+                            for (std::size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstantCount; ++i)
+                                packConstant(constantBlockData,
+                                             fragmentShaderConstantLocations[i],
+                                             setShaderConstantsCommand->getFragmentShaderConstant(i));
+
+                            bindConstantBlock(Shader::fragmentShaderConstantBlockBinding);
+                        }
+                        else
+                        {
+                            for (std::size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstantCount; ++i)
+                            {
+                                const auto& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
+                                const auto fragmentShaderConstant = setShaderConstantsCommand->getFragmentShaderConstant(i);
+
+                                if (currentShader->updateConstantValue(fragmentShaderConstantLocation, fragmentShaderConstant.data()))
+                                {
+                                    setUniform(fragmentShaderConstantLocation.location,
+                                               fragmentShaderConstantLocation.dataType,
+                                               fragmentShaderConstant.data());
+                                    ++frameCallCounts.uniformUploads;
+                                }
+                                else
+                                    ++frameCallCounts.skippedUniformUploads;
+                            }
                         }
 
                         // vertex shader constants
                         const auto& vertexShaderConstantLocations = currentShader->getVertexShaderConstantLocations();
 
-                        if (setShaderConstantsCommand->vertexShaderConstants.size() > vertexShaderConstantLocations.size())
+                        if (setShaderConstantsCommand->vertexShaderConstantCount > vertexShaderConstantLocations.size())
                             throw Error{"Invalid vertex shader constant size"};
 
-                        for (std::size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstants.size(); ++i)
+                        if (const auto blockSize = currentShader->getVertexShaderConstantBlockSize())
                         {
-                            const auto& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                            const auto& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
+                            constantBlockData.assign(static_cast<std::size_t>(blockSize), 0);
 
-                            setUniform(vertexShaderConstantLocation.location,
-                                       vertexShaderConstantLocation.dataType,
-                                       vertexShaderConstant.data());
+                            for (std::size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstantCount; ++i)
+                                packConstant(constantBlockData,
+                                             vertexShaderConstantLocations[i],
+                                             setShaderConstantsCommand->getVertexShaderConstant(i));
+
+                            bindConstantBlock(Shader::vertexShaderConstantBlockBinding);
+                        }
+                        else
+                        {
+                            for (std::size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstantCount; ++i)
+                            {
+                                const auto& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
+                                const auto vertexShaderConstant = setShaderConstantsCommand->getVertexShaderConstant(i);
+
+                                if (currentShader->updateConstantValue(vertexShaderConstantLocation, vertexShaderConstant.data()))
+                                {
+                                    setUniform(vertexShaderConstantLocation.location,
+                                               vertexShaderConstantLocation.dataType,
+                                               vertexShaderConstant.data());
+                                    ++frameCallCounts.uniformUploads;
+                                }
+                                else
+                                    ++frameCallCounts.skippedUniformUploads;
+                            }
                         }
 
                         break;
@@ -1164,7 +1520,7 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::initTexture:
                     {
-                        const auto initTextureCommand = static_cast<const InitTextureCommand*>(command.get());
+                        const auto initTextureCommand = static_cast<const InitTextureCommand*>(command);
 
                         auto texture = std::make_unique<Texture>(*this,
                                                                  initTextureCommand->levels,
@@ -1183,17 +1539,17 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::setTextureData:
                     {
-                        const auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command.get());
+                        const auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command);
 
                         const auto texture = getResource<Texture>(setTextureDataCommand->texture);
-                        texture->setData(setTextureDataCommand->levels);
+                        texture->setData(setTextureDataCommand->levels, setTextureDataCommand->offset);
 
                         break;
                     }
 
                     case Command::Type::setTextureParameters:
                     {
-                        const auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command.get());
+                        const auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command);
 
                         const auto texture = getResource<Texture>(setTextureParametersCommand->texture);
                         texture->setFilter(setTextureParametersCommand->filter);
@@ -1206,10 +1562,12 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::setTextures:
                     {
-                        const auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command.get());
+                        const auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command);
 
-                        for (std::size_t layer = 0; layer < setTexturesCommand->textures.size(); ++layer)
-                            if (auto texture = getResource<Texture>(setTexturesCommand->textures[layer]))
+                        const auto textures = setTexturesCommand->getTextures();
+
+                        for (std::size_t layer = 0; layer < textures.size(); ++layer)
+                            if (auto texture = getResource<Texture>(textures[layer]))
                                 bindTexture(GL_TEXTURE_2D, static_cast<GLenum>(layer), texture->getTextureId());
                             else
                                 bindTexture(GL_TEXTURE_2D, static_cast<GLenum>(layer), 0);
@@ -1221,8 +1579,14 @@ namespace ouzel::graphics::opengl
                         throw Error{"Invalid command"};
                 }
 
-                if (command->type == Command::Type::present) return;
+                if (command->type == Command::Type::present)
+                {
+                    recycleCommandBuffer(std::move(commandBuffer));
+                    return;
+                }
             }
+
+            recycleCommandBuffer(std::move(commandBuffer));
         }
     }
 
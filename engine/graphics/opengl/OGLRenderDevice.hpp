@@ -10,9 +10,11 @@
 #include <cstring>
 #include <array>
 #include <atomic>
+#include <limits>
 #include <memory>
 #include <queue>
 #include <system_error>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -31,9 +33,11 @@
 #endif
 
 #include "../RenderDevice.hpp"
+#include "../../utils/Profiler.hpp"
 #include "OGLErrorCategory.hpp"
 #include "OGLShader.hpp"
 #include "OGLStateCache.hpp"
+#include "OGLStreamingBuffer.hpp"
 
 namespace ouzel::graphics::opengl
 {
@@ -56,6 +60,9 @@ namespace ouzel::graphics::opengl
         PFNGLTEXPARAMETERFVPROC glTexParameterfvProc = nullptr;
         PFNGLTEXIMAGE2DPROC glTexImage2DProc = nullptr;
         PFNGLTEXSUBIMAGE2DPROC glTexSubImage2DProc = nullptr;
+        PFNGLPIXELSTOREIPROC glPixelStoreiProc = nullptr;
+        PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2DProc = nullptr;
+        PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC glCompressedTexSubImage2DProc = nullptr;
         PFNGLVIEWPORTPROC glViewportProc = nullptr;
         PFNGLCLEARPROC glClearProc = nullptr;
         PFNGLCLEARCOLORPROC glClearColorProc = nullptr;
@@ -110,11 +117,30 @@ namespace ouzel::graphics::opengl
         PFNGLMAPBUFFERRANGEPROC glMapBufferRangeProc = nullptr;
         PFNGLUNMAPBUFFERPROC glUnmapBufferProc = nullptr;
 
+        PFNGLFENCESYNCPROC glFenceSyncProc = nullptr;
+        PFNGLCLIENTWAITSYNCPROC glClientWaitSyncProc = nullptr;
+        PFNGLDELETESYNCPROC glDeleteSyncProc = nullptr;
+
         PFNGLCOPYIMAGESUBDATAPROC glCopyImageSubDataProc = nullptr;
 
+        PFNGLGETUNIFORMBLOCKINDEXPROC glGetUniformBlockIndexProc = nullptr;
+        PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBindingProc = nullptr;
+        PFNGLGETACTIVEUNIFORMBLOCKIVPROC glGetActiveUniformBlockivProc = nullptr;
+        PFNGLGETUNIFORMINDICESPROC glGetUniformIndicesProc = nullptr;
+        PFNGLGETACTIVEUNIFORMSIVPROC glGetActiveUniformsivProc = nullptr;
+        PFNGLBINDBUFFERRANGEPROC glBindBufferRangeProc = nullptr;
+
+        PFNGLGENQUERIESPROC glGenQueriesProc = nullptr;
+        PFNGLDELETEQUERIESPROC glDeleteQueriesProc = nullptr;
+        PFNGLBEGINQUERYPROC glBeginQueryProc = nullptr;
+        PFNGLENDQUERYPROC glEndQueryProc = nullptr;
+        PFNGLGETQUERYOBJECTUIVPROC glGetQueryObjectuivProc = nullptr;
+        PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64vProc = nullptr;
+
 #if OUZEL_OPENGLES
         PFNGLCLEARDEPTHFPROC glClearDepthfProc = nullptr;
         PFNGLMAPBUFFEROESPROC glMapBufferProc = nullptr;
+        PFNGLBUFFERSTORAGEEXTPROC glBufferStorageProc = nullptr;
         PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC glFramebufferTexture2DMultisampleProc = nullptr;
 #  if OUZEL_OPENGL_INTERFACE_EAGL
         PFNGLDISCARDFRAMEBUFFEREXTPROC glDiscardFramebufferEXTProc = nullptr;
@@ -124,6 +150,7 @@ namespace ouzel::graphics::opengl
         PFNGLPOLYGONMODEPROC glPolygonModeProc = nullptr;
         PFNGLCLEARDEPTHPROC glClearDepthProc = nullptr;
         PFNGLMAPBUFFERPROC glMapBufferProc = nullptr;
+        PFNGLBUFFERSTORAGEPROC glBufferStorageProc = nullptr;
 #endif
 
         PFNGLCREATESHADERPROC glCreateShaderProc = nullptr;
@@ -167,6 +194,7 @@ namespace ouzel::graphics::opengl
 
         auto isTextureBaseLevelSupported() const noexcept { return textureBaseLevelSupported; }
         auto isTextureMaxLevelSupported() const noexcept { return textureMaxLevelSupported; }
+        auto isUniformBufferSupported() const noexcept { return uniformStreamingBuffer != nullptr; }
 
         void setFrontFace(GLenum mode)
         {
@@ -187,6 +215,7 @@ namespace ouzel::graphics::opengl
                 glActiveTextureProc(GL_TEXTURE0 + layer);
                 glBindTextureProc(target, textureId);
                 stateCache.textures[target][layer] = textureId;
+                ++frameCallCounts.textureBinds;
 
                 if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
                     throw std::system_error{makeErrorCode(error), "Failed to bind texture"};
@@ -199,6 +228,7 @@ namespace ouzel::graphics::opengl
             {
                 glUseProgramProc(programId);
                 stateCache.programId = programId;
+                ++frameCallCounts.programBinds;
 
                 if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
                     throw std::system_error{makeErrorCode(error), "Failed to bind program"};
@@ -225,12 +255,29 @@ namespace ouzel::graphics::opengl
             {
                 glBindBufferProc(target, bufferId);
                 currentBufferId = bufferId;
+                ++frameCallCounts.bufferBinds;
 
                 if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
                     throw std::system_error{makeErrorCode(error), "Failed to bind element array buffer"};
             }
         }
 
+        void bindVertexArray(GLuint arrayId)
+        {
+            if (stateCache.vertexArrayId != arrayId)
+            {
+                glBindVertexArrayProc(arrayId);
+                stateCache.vertexArrayId = arrayId;
+                ++frameCallCounts.vertexArrayBinds;
+
+                // the element array buffer binding is a part of the vertex array state
+                stateCache.bufferId[GL_ELEMENT_ARRAY_BUFFER] = unknownBufferId;
+
+                if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                    throw std::system_error{makeErrorCode(error), "Failed to bind vertex array"};
+            }
+        }
+
         void setScissorTest(bool scissorTestEnabled,
                             GLint x, GLint y,
                             GLsizei width, GLsizei height)
@@ -513,6 +560,16 @@ namespace ouzel::graphics::opengl
             if (elementArrayBufferId == bufferId) elementArrayBufferId = 0;
             GLuint& arrayBufferId = stateCache.bufferId[GL_ARRAY_BUFFER];
             if (arrayBufferId == bufferId) arrayBufferId = 0;
+
+            // the vertex array keeps the deleted buffer alive and a new buffer can get the same name
+            if (const auto i = vertexArrays.find(bufferId); i != vertexArrays.end())
+            {
+                if (stateCache.vertexArrayId == i->second.vertexArrayId)
+                    bindVertexArray(vertexArrayId);
+                glDeleteVertexArraysProc(1, &i->second.vertexArrayId);
+                vertexArrays.erase(i);
+            }
+
             glDeleteBuffersProc(1, &bufferId);
         }
 
@@ -557,6 +614,17 @@ namespace ouzel::graphics::opengl
         }
 #endif
 
+        // returns the ring buffer for the dynamic buffer data or nullptr if buffer mapping is not supported
+        StreamingBuffer* getStreamingBuffer(GLuint bufferType) const noexcept
+        {
+            switch (bufferType)
+            {
+                case GL_ELEMENT_ARRAY_BUFFER: return indexStreamingBuffer.get();
+                case GL_ARRAY_BUFFER: return vertexStreamingBuffer.get();
+                default: return nullptr;
+            }
+        }
+
         template <class T>
         auto getResource(std::size_t id) const
         {
@@ -565,6 +633,7 @@ namespace ouzel::graphics::opengl
 
     protected:
         void init(GLsizei newWidth, GLsizei newHeight);
+        void createStreamingBuffers();
         virtual void resizeFrameBuffer() {}
 
         void process() override;
@@ -572,6 +641,17 @@ namespace ouzel::graphics::opengl
         void generateScreenshot(const std::string& filename) override;
         void setUniform(GLint location, DataType dataType, const void* data);
 
+        // uploads constantBlockData to the uniform ring and binds it to the uniform block binding point
+        void bindConstantBlock(GLuint binding);
+
+        // binds the vertex array of the buffer bound to GL_ARRAY_BUFFER and points the attributes at the offset
+        void setVertexAttributes(GLuint bufferId, GLintptr offset);
+
+        // GPU time of the frames measured with timer queries while the profiler is recording
+        void beginFrameTimer();
+        void endFrameTimer();
+        void readFrameTimers();
+
         bool embedded = false;
 
         GLuint frameBufferId = 0;
@@ -579,12 +659,51 @@ namespace ouzel::graphics::opengl
         GLsizei frameBufferHeight = 0;
         GLuint vertexArrayId = 0;
 
+        static constexpr GLuint unknownBufferId = std::numeric_limits<GLuint>::max();
+
+        struct VertexArray final
+        {
+            GLuint vertexArrayId = 0;
+            GLuint bufferId = 0;
+            GLintptr offset = -1; // -1 if the attributes were not set up yet
+        };
+
+        // vertex arrays by the vertex buffer if they are supported, the attribute pointers are
+        // updated only when the data is at a different offset (streamed buffers)
+        std::unordered_map<GLuint, VertexArray> vertexArrays;
+        VertexArray defaultVertexArray; // the attribute state of the context if vertex arrays are not supported
+
         bool textureBaseLevelSupported:1;
         bool textureMaxLevelSupported:1;
+        bool timerQueriesSupported = false;
+
+        // the results are read a few frames later, so that reading them does not stall the pipeline
+        static constexpr std::size_t frameTimerCount = 4;
+        std::array<GLuint, frameTimerCount> frameTimerQueries{};
+        std::array<std::uint64_t, frameTimerCount> frameTimerStarts{};
+        std::size_t firstFrameTimer = 0;
+        std::size_t pendingFrameTimerCount = 0;
+        bool frameTimerRunning = false;
+        Profiler::Track* gpuTrack = nullptr;
 
         StateCache stateCache;
 
         std::vector<std::unique_ptr<RenderResource>> resources;
+
+        std::unique_ptr<StreamingBuffer> indexStreamingBuffer;
+        std::unique_ptr<StreamingBuffer> vertexStreamingBuffer;
+        std::unique_ptr<StreamingBuffer> uniformStreamingBuffer; // per-draw constant blocks
+
+        struct ConstantBlock final
+        {
+            std::vector<std::uint8_t> data;
+            std::uint64_t position = 0; // in the uniform ring
+            bool bound = false;
+        };
+
+        // the last constants bound to every binding point, they are not uploaded again if they did not change
+        std::array<ConstantBlock, 2> constantBlocks;
+        std::vector<std::uint8_t> constantBlockData;
     };
 }
 
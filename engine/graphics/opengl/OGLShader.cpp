@@ -4,6 +4,7 @@
 
 #if OUZEL_COMPILE_OPENGL
 
+#include <algorithm>
 #include "OGLShader.hpp"
 #include "OGLError.hpp"
 #include "OGLRenderDevice.hpp"
@@ -76,6 +77,45 @@ namespace ouzel::graphics::opengl
         return std::string();
     }
 
+    GLsizeiptr Shader::getConstantBlockSize(const char* blockName, GLuint binding) const
+    {
+        if (!renderDevice.isUniformBufferSupported()) return 0;
+
+        const auto blockIndex = renderDevice.glGetUniformBlockIndexProc(programId, blockName);
+        if (blockIndex == GL_INVALID_INDEX) return 0;
+
+        renderDevice.glUniformBlockBindingProc(programId, blockIndex, binding);
+
+        GLint blockSize = 0;
+        renderDevice.glGetActiveUniformBlockivProc(programId, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize);
+
+        if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+            throw std::system_error{makeErrorCode(error), "Failed to get uniform block size"};
+
+        return blockSize;
+    }
+
+    Shader::Location Shader::getBlockLocation(const std::string& name, DataType dataType) const
+    {
+        const auto uniformName = name.c_str();
+        GLuint uniformIndex = GL_INVALID_INDEX;
+        renderDevice.glGetUniformIndicesProc(programId, 1, &uniformName, &uniformIndex);
+
+        if (uniformIndex == GL_INVALID_INDEX)
+            throw Error{"Shader constant " + name + " is not in the uniform block"};
+
+        GLint offset = 0;
+        renderDevice.glGetActiveUniformsivProc(programId, 1, &uniformIndex, GL_UNIFORM_OFFSET, &offset);
+
+        GLint matrixStride = 0;
+        renderDevice.glGetActiveUniformsivProc(programId, 1, &uniformIndex, GL_UNIFORM_MATRIX_STRIDE, &matrixStride);
+
+        if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+            throw std::system_error{makeErrorCode(error), "Failed to get uniform offset"};
+
+        return Location{dataType, offset, matrixStride};
+    }
+
     namespace
     {
         std::string semanticToString(Vertex::Attribute::Semantic semantic)
@@ -174,6 +214,13 @@ namespace ouzel::graphics::opengl
         if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
             throw std::system_error{makeErrorCode(error), "Failed to get uniform location"};
 
+        std::size_t valueOffset = 0;
+
+        fragmentShaderConstantBlockSize = getConstantBlockSize(fragmentShaderConstantBlockName,
+                                                               fragmentShaderConstantBlockBinding);
+        vertexShaderConstantBlockSize = getConstantBlockSize(vertexShaderConstantBlockName,
+                                                             vertexShaderConstantBlockBinding);
+
         if (!fragmentShaderConstantInfo.empty())
         {
             fragmentShaderConstantLocations.clear();
@@ -181,6 +228,12 @@ namespace ouzel::graphics::opengl
 
             for (const auto& [name, dataType] : fragmentShaderConstantInfo)
             {
+                if (fragmentShaderConstantBlockSize)
+                {
+                    fragmentShaderConstantLocations.push_back(getBlockLocation(name, dataType));
+                    continue;
+                }
+
                 const auto location = renderDevice.glGetUniformLocationProc(programId, name.c_str());
 
                 if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
@@ -189,7 +242,8 @@ namespace ouzel::graphics::opengl
                 if (location == -1)
                     throw Error{"Failed to get OpenGL uniform location"};
 
-                fragmentShaderConstantLocations.emplace_back(location, dataType);
+                fragmentShaderConstantLocations.emplace_back(location, dataType, valueOffset);
+                valueOffset += getDataTypeSize(dataType);
             }
         }
 
@@ -200,6 +254,12 @@ namespace ouzel::graphics::opengl
 
             for (const auto& [name, dataType] : vertexShaderConstantInfo)
             {
+                if (vertexShaderConstantBlockSize)
+                {
+                    vertexShaderConstantLocations.push_back(getBlockLocation(name, dataType));
+                    continue;
+                }
+
                 const auto location = renderDevice.glGetUniformLocationProc(programId, name.c_str());
 
                 if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
@@ -208,9 +268,24 @@ namespace ouzel::graphics::opengl
                 if (location == -1)
                     throw Error{"Failed to get OpenGL uniform location"};
 
-                vertexShaderConstantLocations.emplace_back(location, dataType);
+                // a uniform used by both shaders has one value
+                const auto i = std::find_if(fragmentShaderConstantLocations.begin(),
+                                            fragmentShaderConstantLocations.end(),
+                                            [location](const auto& fragmentShaderConstantLocation) noexcept {
+                                                return fragmentShaderConstantLocation.location == location;
+                                            });
+
+                if (i != fragmentShaderConstantLocations.end())
+                    vertexShaderConstantLocations.emplace_back(location, dataType, i->valueOffset);
+                else
+                {
+                    vertexShaderConstantLocations.emplace_back(location, dataType, valueOffset);
+                    valueOffset += getDataTypeSize(dataType);
+                }
             }
         }
+
+        constantValues.assign(valueOffset, 0);
     }
 }
 
@@ -3,6 +3,7 @@
 #ifndef OUZEL_GRAPHICS_OGLSHADER_HPP
 #define OUZEL_GRAPHICS_OGLSHADER_HPP
 
+#include <cstring>
 #include <utility>
 
 #include "../../core/Setup.h"
@@ -44,15 +45,31 @@ namespace ouzel::graphics::opengl
 
         void reload() final;
 
+        // Constants of a stage are passed in a uniform block if the shader declares one with these names,
+        // otherwise as separate uniforms. Uniform blocks are supported on OpenGL 3.1+ and OpenGL ES 3.0+.
+        static constexpr const char* fragmentShaderConstantBlockName = "FragmentConstants";
+        static constexpr const char* vertexShaderConstantBlockName = "VertexConstants";
+        static constexpr GLuint fragmentShaderConstantBlockBinding = 0;
+        static constexpr GLuint vertexShaderConstantBlockBinding = 1;
+
         struct Location final
         {
-            Location(GLint initLocation, DataType initDataType) noexcept:
-                location(initLocation), dataType(initDataType)
+            Location(GLint initLocation, DataType initDataType, std::size_t initValueOffset) noexcept:
+                location(initLocation), dataType(initDataType), valueOffset(initValueOffset)
+            {
+            }
+
+            Location(DataType initDataType, GLint initBlockOffset, GLint initMatrixStride) noexcept:
+                location(-1), dataType(initDataType), valueOffset(0),
+                blockOffset(initBlockOffset), matrixStride(initMatrixStride)
             {
             }
 
-            GLint location;
+            GLint location; // -1 if the constant is in the uniform block
             DataType dataType;
+            std::size_t valueOffset; // offset of the value in the shadow copy of the uniforms
+            GLint blockOffset = 0;
+            GLint matrixStride = 0; // distance between the columns of a matrix in the uniform block
         };
 
         auto& getVertexAttributes() const noexcept { return vertexAttributes; }
@@ -62,10 +79,28 @@ namespace ouzel::graphics::opengl
 
         auto getProgramId() const noexcept { return programId; }
 
+        // zero if the stage does not have a uniform block
+        auto getFragmentShaderConstantBlockSize() const noexcept { return fragmentShaderConstantBlockSize; }
+        auto getVertexShaderConstantBlockSize() const noexcept { return vertexShaderConstantBlockSize; }
+
+        // stores the value in the shadow copy of the uniforms of the program,
+        // returns false if the program already has the same value
+        bool updateConstantValue(const Location& location, const void* value)
+        {
+            const auto size = getDataTypeSize(location.dataType);
+            const auto shadowValue = constantValues.data() + location.valueOffset;
+            if (std::memcmp(shadowValue, value, size) == 0) return false;
+
+            std::memcpy(shadowValue, value, size);
+            return true;
+        }
+
     private:
         void compileShader();
         std::string getShaderMessage(GLuint shaderId) const;
         std::string getProgramMessage() const;
+        GLsizeiptr getConstantBlockSize(const char* blockName, GLuint binding) const;
+        Location getBlockLocation(const std::string& name, DataType dataType) const;
 
         std::vector<std::uint8_t> fragmentShaderData;
         std::vector<std::uint8_t> vertexShaderData;
@@ -81,6 +116,9 @@ namespace ouzel::graphics::opengl
 
         std::vector<Location> fragmentShaderConstantLocations;
         std::vector<Location> vertexShaderConstantLocations;
+        std::vector<std::uint8_t> constantValues; // uniforms are zero after the program is linked
+        GLsizeiptr fragmentShaderConstantBlockSize = 0;
+        GLsizeiptr vertexShaderConstantBlockSize = 0;
     };
 }
 #endif
@@ -0,0 +1,204 @@
+// Ouzel by Elviss Strazdins
+
+#include "../../core/Setup.h"
+
+#if OUZEL_COMPILE_OPENGL
+
+#include <algorithm>
+#include <limits>
+#include "OGLStreamingBuffer.hpp"
+#include "OGLError.hpp"
+#include "OGLRenderDevice.hpp"
+
+namespace ouzel::graphics::opengl
+{
+    namespace
+    {
+#if OUZEL_OPENGLES
+        constexpr GLbitfield persistentMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT_EXT | GL_MAP_COHERENT_BIT_EXT;
+#else
+        constexpr GLbitfield persistentMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+#endif
+    }
+
+    StreamingBuffer::StreamingBuffer(RenderDevice& initRenderDevice,
+                                     GLenum initBufferType,
+                                     GLsizeiptr initSize,
+                                     std::uint64_t initAlignment):
+        renderDevice{initRenderDevice},
+        bufferType{initBufferType},
+        size{initSize},
+        alignment{initAlignment}
+    {
+        if (renderDevice.glFenceSyncProc &&
+            renderDevice.glClientWaitSyncProc &&
+            renderDevice.glDeleteSyncProc)
+            mode = renderDevice.glBufferStorageProc ? Mode::persistent : Mode::unsynchronized;
+
+        createBuffer();
+    }
+
+    StreamingBuffer::~StreamingBuffer()
+    {
+        while (!fences.empty())
+        {
+            renderDevice.glDeleteSyncProc(fences.front().sync);
+            fences.pop();
+        }
+
+        // deleting the buffer also unmaps it
+        if (bufferId)
+            renderDevice.deleteBuffer(bufferId);
+    }
+
+    std::optional<std::uint64_t> StreamingBuffer::upload(Span<const std::uint8_t> data)
+    {
+        const auto dataSize = static_cast<std::uint64_t>(data.size());
+        const auto ringSize = static_cast<std::uint64_t>(size);
+
+        if (dataSize > ringSize) return std::nullopt;
+
+        auto position = (writePosition + alignment - 1) / alignment * alignment;
+
+        // the data has to be contiguous, so skip the end of the ring if it doesn't fit there
+        if (position % ringSize + dataSize > ringSize)
+            position = (position / ringSize + 1) * ringSize;
+
+        while (position + dataSize > freePosition + ringSize)
+        {
+            if (!fences.empty())
+                retireFence(std::numeric_limits<GLuint64>::max());
+            else if (mode == Mode::orphan)
+            {
+                orphan();
+
+                if (position % ringSize != 0)
+                    position = (position / ringSize + 1) * ringSize;
+
+                // the data uploaded before orphaning is not in the new storage
+                validPosition = freePosition = position;
+            }
+            else // the current frame has filled the whole ring
+                return std::nullopt;
+        }
+
+        const auto offset = getOffset(position);
+
+        if (mode == Mode::persistent)
+            std::copy(data.begin(), data.end(), mappedData + offset);
+        else
+        {
+            renderDevice.bindBuffer(bufferType, bufferId);
+
+            const auto mappedRange = renderDevice.glMapBufferRangeProc(bufferType, offset,
+                                                                       static_cast<GLsizeiptr>(dataSize),
+                                                                       GL_MAP_WRITE_BIT |
+                                                                       GL_MAP_UNSYNCHRONIZED_BIT |
+                                                                       GL_MAP_INVALIDATE_RANGE_BIT);
+
+            if (!mappedRange)
+                throw std::system_error{makeErrorCode(renderDevice.glGetErrorProc()), "Failed to map buffer"};
+
+            std::copy(data.begin(), data.end(), static_cast<std::uint8_t*>(mappedRange));
+
+            // the contents of the buffer got corrupted while it was mapped
+            if (renderDevice.glUnmapBufferProc(bufferType) != GL_TRUE)
+                return std::nullopt;
+        }
+
+        writePosition = position + dataSize;
+        return position;
+    }
+
+    void StreamingBuffer::endFrame()
+    {
+        if (mode != Mode::orphan && writePosition != validPosition)
+        {
+            const auto sync = renderDevice.glFenceSyncProc(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+            if (!sync)
+                throw std::system_error{makeErrorCode(renderDevice.glGetErrorProc()), "Failed to create fence"};
+
+            fences.push(Fence{sync, writePosition});
+        }
+
+        validPosition = writePosition;
+
+        // release the regions of the frames that the GPU has already finished without waiting
+        while (!fences.empty())
+            if (!retireFence(0)) break;
+    }
+
+    void StreamingBuffer::reload()
+    {
+        // the buffer and the fences were destroyed with the context
+        fences = std::queue<Fence>{};
+        bufferId = 0;
+        mappedData = nullptr;
+        validPosition = freePosition = writePosition;
+
+        createBuffer();
+    }
+
+    void StreamingBuffer::createBuffer()
+    {
+        renderDevice.glGenBuffersProc(1, &bufferId);
+
+        if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+            throw std::system_error{makeErrorCode(error), "Failed to create buffer"};
+
+        renderDevice.bindBuffer(bufferType, bufferId);
+
+        if (mode == Mode::persistent)
+        {
+            renderDevice.glBufferStorageProc(bufferType, size, nullptr, persistentMapFlags);
+
+            if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+                throw std::system_error{makeErrorCode(error), "Failed to create buffer storage"};
+
+            mappedData = static_cast<std::uint8_t*>(renderDevice.glMapBufferRangeProc(bufferType, 0, size, persistentMapFlags));
+
+            if (!mappedData)
+                throw std::system_error{makeErrorCode(renderDevice.glGetErrorProc()), "Failed to map buffer"};
+        }
+        else
+        {
+            renderDevice.glBufferDataProc(bufferType, size, nullptr, GL_STREAM_DRAW);
+
+            if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+                throw std::system_error{makeErrorCode(error), "Failed to create buffer"};
+        }
+    }
+
+    void StreamingBuffer::orphan()
+    {
+        renderDevice.bindBuffer(bufferType, bufferId);
+        renderDevice.glBufferDataProc(bufferType, size, nullptr, GL_STREAM_DRAW);
+
+        if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+            throw std::system_error{makeErrorCode(error), "Failed to orphan buffer"};
+    }
+
+    bool StreamingBuffer::retireFence(GLuint64 timeout)
+    {
+        const auto& fence = fences.front();
+
+        switch (renderDevice.glClientWaitSyncProc(fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout))
+        {
+            case GL_ALREADY_SIGNALED:
+            case GL_CONDITION_SATISFIED:
+                break;
+            case GL_TIMEOUT_EXPIRED:
+                return false;
+            default:
+                throw std::system_error{makeErrorCode(renderDevice.glGetErrorProc()), "Failed to wait for fence"};
+        }
+
+        renderDevice.glDeleteSyncProc(fence.sync);
+        freePosition = fence.position;
+        fences.pop();
+        return true;
+    }
+}
+
+#endif
@@ -0,0 +1,105 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_OGLSTREAMINGBUFFER_HPP
+#define OUZEL_GRAPHICS_OGLSTREAMINGBUFFER_HPP
+
+#include "../../core/Setup.h"
+
+#if OUZEL_COMPILE_OPENGL
+
+#include <cstdint>
+#include <optional>
+#include <queue>
+
+#include "OGL.h"
+
+#if OUZEL_OPENGLES
+#  include "GLES/gl.h"
+#  include "GLES2/gl2.h"
+#  include "GLES2/gl2ext.h"
+#  include "GLES3/gl3.h"
+#else
+#  include "GL/glcorearb.h"
+#  include "GL/glext.h"
+#endif
+
+#include "../../utils/Span.hpp"
+
+namespace ouzel::graphics::opengl
+{
+    class RenderDevice;
+
+    // Ring buffer that the dynamic buffers upload their data to
+    // Every frame fences the region it has written, and the region is overwritten only after the GPU has read it
+    // If sync objects are not supported, the storage of the buffer is orphaned when the ring wraps around
+    class StreamingBuffer final
+    {
+    public:
+        StreamingBuffer(RenderDevice& initRenderDevice,
+                        GLenum initBufferType,
+                        GLsizeiptr initSize,
+                        std::uint64_t initAlignment = 16U);
+        ~StreamingBuffer();
+
+        StreamingBuffer(const StreamingBuffer&) = delete;
+        StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+
+        StreamingBuffer(StreamingBuffer&&) = delete;
+        StreamingBuffer& operator=(StreamingBuffer&&) = delete;
+
+        // returns the position of the data in the ring or nothing if the data doesn't fit in it
+        std::optional<std::uint64_t> upload(Span<const std::uint8_t> data);
+
+        // data is valid only until the end of the frame it was uploaded in
+        auto isValid(std::uint64_t position) const noexcept { return position >= validPosition; }
+        auto getOffset(std::uint64_t position) const noexcept
+        {
+            return static_cast<GLintptr>(position % static_cast<std::uint64_t>(size));
+        }
+
+        auto getBufferId() const noexcept { return bufferId; }
+        auto getBufferType() const noexcept { return bufferType; }
+
+        void endFrame();
+
+        // recreates the buffer after the context was lost
+        void reload();
+
+    private:
+        enum class Mode
+        {
+            persistent, // persistently mapped buffer with fences
+            unsynchronized, // unsynchronized mapping with fences
+            orphan // unsynchronized mapping with orphaning
+        };
+
+        struct Fence final
+        {
+            GLsync sync;
+            std::uint64_t position;
+        };
+
+        void createBuffer();
+        void orphan();
+        bool retireFence(GLuint64 timeout);
+
+        RenderDevice& renderDevice;
+        GLenum bufferType;
+        GLsizeiptr size;
+        std::uint64_t alignment; // of the uploaded data
+        Mode mode = Mode::orphan;
+
+        GLuint bufferId = 0;
+        std::uint8_t* mappedData = nullptr;
+
+        // positions grow monotonically and wrap around the ring only when converted to offsets
+        std::uint64_t writePosition = 0;
+        std::uint64_t validPosition = 0; // start of the current frame or the last orphaning
+        std::uint64_t freePosition = 0; // everything before it has been read by the GPU
+        std::queue<Fence> fences;
+    };
+}
+
+#endif
+
+#endif // OUZEL_GRAPHICS_OGLSTREAMINGBUFFER_HPP
@@ -4,6 +4,7 @@
 
 #if OUZEL_COMPILE_OPENGL
 
+#include <algorithm>
 #include "OGLTexture.hpp"
 #include "OGLError.hpp"
 #include "OGLRenderDevice.hpp"
@@ -12,9 +13,40 @@ namespace ouzel::graphics::opengl
 {
     namespace
     {
+        constexpr GLenum getOpenGlCompressedPixelFormat(PixelFormat pixelFormat)
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::bc1RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+                case PixelFormat::bc1RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+                case PixelFormat::bc3RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                case PixelFormat::bc3RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+                case PixelFormat::bc4RUnsignedNorm: return GL_COMPRESSED_RED_RGTC1_EXT;
+                case PixelFormat::bc5RgUnsignedNorm: return GL_COMPRESSED_RED_GREEN_RGTC2_EXT;
+#if OUZEL_OPENGLES
+                case PixelFormat::bc7RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_BPTC_UNORM_EXT;
+                case PixelFormat::bc7RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_EXT;
+#else
+                case PixelFormat::bc7RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+                case PixelFormat::bc7RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+#endif
+                case PixelFormat::etc2RgbUnsignedNorm: return GL_COMPRESSED_RGB8_ETC2;
+                case PixelFormat::etc2RgbUnsignedNormSRGB: return GL_COMPRESSED_SRGB8_ETC2;
+                case PixelFormat::etc2RgbaUnsignedNorm: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+                case PixelFormat::etc2RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC;
+                case PixelFormat::astc4x4RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+                case PixelFormat::astc4x4RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR;
+                default: throw Error{"Invalid pixel format"};
+            }
+        }
+
         constexpr GLenum getOpenGlInternalPixelFormat(PixelFormat pixelFormat,
                                                       [[maybe_unused]] std::uint32_t openGlVersion)
         {
+            // compressed formats don't depend on the API version, only on the extensions
+            if (isCompressed(pixelFormat))
+                return getOpenGlCompressedPixelFormat(pixelFormat);
+
 #if OUZEL_OPENGLES
             if (openGlVersion >= 3)
             {
@@ -109,6 +141,8 @@ namespace ouzel::graphics::opengl
 
         constexpr GLenum getOpenGlPixelFormat(PixelFormat pixelFormat)
         {
+            if (isCompressed(pixelFormat)) return GL_NONE;
+
             switch (pixelFormat)
             {
                 case PixelFormat::a8UnsignedNorm:
@@ -159,6 +193,8 @@ namespace ouzel::graphics::opengl
 
         constexpr GLenum getOpenGlPixelType(PixelFormat pixelFormat)
         {
+            if (isCompressed(pixelFormat)) return GL_NONE;
+
             switch (pixelFormat)
             {
                 case PixelFormat::a8UnsignedNorm:
@@ -270,7 +306,8 @@ namespace ouzel::graphics::opengl
         textureTarget{getTextureTarget(type)},
         internalPixelFormat{getOpenGlInternalPixelFormat(initPixelFormat, renderDevice.getAPIMajorVersion())},
         pixelFormat{getOpenGlPixelFormat(initPixelFormat)},
-        pixelType{getOpenGlPixelType(initPixelFormat)}
+        pixelType{getOpenGlPixelType(initPixelFormat)},
+        compressed{isCompressed(initPixelFormat)}
     {
         if ((flags & Flags::bindRenderTarget) == Flags::bindRenderTarget &&
             (mipmaps == 0 || mipmaps > 1))
@@ -279,11 +316,22 @@ namespace ouzel::graphics::opengl
         if (internalPixelFormat == GL_NONE)
             throw Error{"Invalid pixel format"};
 
-        if (pixelFormat == GL_NONE)
-            throw Error{"Invalid pixel format"};
+        if (compressed)
+        {
+            if ((flags & Flags::bindRenderTarget) == Flags::bindRenderTarget)
+                throw Error{"Compressed textures can't be used as render targets"};
 
-        if (pixelType == GL_NONE)
-            throw Error{"Invalid pixel format"};
+            if (!renderDevice.isPixelFormatSupported(initPixelFormat))
+                throw Error{"Pixel format not supported"};
+        }
+        else
+        {
+            if (pixelFormat == GL_NONE)
+                throw Error{"Invalid pixel format"};
+
+            if (pixelType == GL_NONE)
+                throw Error{"Invalid pixel format"};
+        }
 
         createTexture();
 
@@ -300,22 +348,7 @@ namespace ouzel::graphics::opengl
                     throw std::system_error{makeErrorCode(error), "Failed to set texture base and max levels"};
             }
 
-            for (std::size_t level = 0; level < levels.size(); ++level)
-            {
-                if (!levels[level].second.empty())
-                    renderDevice.glTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalPixelFormat),
-                                                  static_cast<GLsizei>(levels[level].first.v[0]),
-                                                  static_cast<GLsizei>(levels[level].first.v[1]), 0,
-                                                  pixelFormat, pixelType, levels[level].second.data());
-                else
-                    renderDevice.glTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalPixelFormat),
-                                                  static_cast<GLsizei>(levels[level].first.v[0]),
-                                                  static_cast<GLsizei>(levels[level].first.v[1]), 0,
-                                                  pixelFormat, pixelType, nullptr);
-            }
-
-            if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
-                throw std::system_error{makeErrorCode(error), "Failed to upload texture data"};
+            uploadLevels();
         }
 
         setTextureParameters();
@@ -350,48 +383,69 @@ namespace ouzel::graphics::opengl
                     throw std::system_error{makeErrorCode(error), "Failed to set texture base and max levels"};
             }
 
-            for (std::size_t level = 0; level < levels.size(); ++level)
-            {
-                if (!levels[level].second.empty())
-                    renderDevice.glTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalPixelFormat),
-                                                  static_cast<GLsizei>(levels[level].first.v[0]),
-                                                  static_cast<GLsizei>(levels[level].first.v[1]), 0,
-                                                  pixelFormat, pixelType, levels[level].second.data());
-                else
-                    renderDevice.glTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalPixelFormat),
-                                                  static_cast<GLsizei>(levels[level].first.v[0]),
-                                                  static_cast<GLsizei>(levels[level].first.v[1]), 0,
-                                                  pixelFormat, pixelType, nullptr);
-            }
-
-            if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
-                throw std::system_error{makeErrorCode(error), "Failed to upload texture data"};
+            uploadLevels();
 
             setTextureParameters();
         }
     }
 
     void Texture::setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>,
-                          std::vector<std::uint8_t>>>& newLevels)
+                          std::vector<std::uint8_t>>>& newLevels,
+                          const math::Vector<std::uint32_t, 2>& offset)
     {
         if ((flags & Flags::dynamic) != Flags::dynamic ||
             (flags & Flags::bindRenderTarget) == Flags::bindRenderTarget)
             throw Error{"Texture is not dynamic"};
 
-        levels = newLevels;
-
         if (!textureId)
             throw Error{"Texture not initialized"};
 
+        const auto partial = offset.v[0] != 0 || offset.v[1] != 0 ||
+            (!newLevels.empty() && !levels.empty() && newLevels.front().first != levels.front().first);
+
+        if (partial)
+        {
+            if (compressed || newLevels.size() != 1)
+                throw Error{"Only the first level of an uncompressed texture can be partially updated"};
+
+            // keep the copy of the data that is used to recreate the texture up to date
+            if (auto& level = levels.front(); !level.second.empty())
+            {
+                const auto& region = newLevels.front();
+                const auto pixelSize = level.second.size() / (level.first.v[0] * level.first.v[1]);
+                const auto rowSize = region.first.v[0] * pixelSize;
+
+                for (std::uint32_t row = 0; row < region.first.v[1]; ++row)
+                    std::copy(region.second.begin() + static_cast<std::ptrdiff_t>(row * rowSize),
+                              region.second.begin() + static_cast<std::ptrdiff_t>((row + 1) * rowSize),
+                              level.second.begin() + static_cast<std::ptrdiff_t>(((offset.v[1] + row) * level.first.v[0] + offset.v[0]) * pixelSize));
+            }
+        }
+        else
+            levels = newLevels;
+
         renderDevice.bindTexture(textureTarget, 0, textureId);
 
-        for (std::size_t level = 0; level < levels.size(); ++level)
-            if (!levels[level].second.empty())
-                renderDevice.glTexSubImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0,
-                                                 static_cast<GLsizei>(levels[level].first.v[0]),
-                                                 static_cast<GLsizei>(levels[level].first.v[1]),
+        for (std::size_t level = 0; level < newLevels.size(); ++level)
+        {
+            if (newLevels[level].second.empty()) continue;
+
+            if (compressed)
+                renderDevice.glCompressedTexSubImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0,
+                                                           static_cast<GLsizei>(newLevels[level].first.v[0]),
+                                                           static_cast<GLsizei>(newLevels[level].first.v[1]),
+                                                           internalPixelFormat,
+                                                           static_cast<GLsizei>(newLevels[level].second.size()),
+                                                           newLevels[level].second.data());
+            else
+                renderDevice.glTexSubImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level),
+                                                 static_cast<GLint>(offset.v[0]),
+                                                 static_cast<GLint>(offset.v[1]),
+                                                 static_cast<GLsizei>(newLevels[level].first.v[0]),
+                                                 static_cast<GLsizei>(newLevels[level].first.v[1]),
                                                  pixelFormat, pixelType,
-                                                 levels[level].second.data());
+                                                 newLevels[level].second.data());
+        }
 
         if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
             throw std::system_error{makeErrorCode(error), "Failed to upload texture data"};
@@ -562,6 +616,33 @@ namespace ouzel::graphics::opengl
         }
     }
 
+    void Texture::uploadLevels()
+    {
+        for (std::size_t level = 0; level < levels.size(); ++level)
+        {
+            // the compressed data goes to the GPU as it is, without a format conversion or mip map generation
+            if (compressed)
+                renderDevice.glCompressedTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), internalPixelFormat,
+                                                        static_cast<GLsizei>(levels[level].first.v[0]),
+                                                        static_cast<GLsizei>(levels[level].first.v[1]), 0,
+                                                        static_cast<GLsizei>(levels[level].second.size()),
+                                                        levels[level].second.data());
+            else if (!levels[level].second.empty())
+                renderDevice.glTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalPixelFormat),
+                                              static_cast<GLsizei>(levels[level].first.v[0]),
+                                              static_cast<GLsizei>(levels[level].first.v[1]), 0,
+                                              pixelFormat, pixelType, levels[level].second.data());
+            else
+                renderDevice.glTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalPixelFormat),
+                                              static_cast<GLsizei>(levels[level].first.v[0]),
+                                              static_cast<GLsizei>(levels[level].first.v[1]), 0,
+                                              pixelFormat, pixelType, nullptr);
+        }
+
+        if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+            throw std::system_error{makeErrorCode(error), "Failed to upload texture data"};
+    }
+
     void Texture::setTextureParameters()
     {
         renderDevice.bindTexture(textureTarget, 0, textureId);
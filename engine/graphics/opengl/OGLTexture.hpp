@@ -29,6 +29,7 @@
 #include "../SamplerFilter.hpp"
 #include "../TextureType.hpp"
 #include "../../math/Size.hpp"
+#include "../../math/Vector.hpp"
 
 namespace ouzel::graphics::opengl
 {
@@ -51,7 +52,8 @@ namespace ouzel::graphics::opengl
         void reload() final;
 
         void setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>,
-                     std::vector<std::uint8_t>>>& newLevels);
+                     std::vector<std::uint8_t>>>& newLevels,
+                     const math::Vector<std::uint32_t, 2>& offset = {});
         void setFilter(SamplerFilter newFilter);
         void setAddressX(SamplerAddressMode newAddressX);
         void setAddressY(SamplerAddressMode newAddressY);
@@ -78,6 +80,7 @@ namespace ouzel::graphics::opengl
     private:
         void createTexture();
         void setTextureParameters();
+        void uploadLevels();
 
         std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levels;
         Flags flags = Flags::none;
@@ -98,6 +101,7 @@ namespace ouzel::graphics::opengl
         GLenum internalPixelFormat = GL_NONE;
         GLenum pixelFormat = GL_NONE;
         GLenum pixelType = GL_NONE;
+        bool compressed = false; // the levels are uploaded as they are, without any conversion by the driver
     };
 }
 #endif
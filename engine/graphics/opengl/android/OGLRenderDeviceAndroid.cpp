@@ -178,9 +178,7 @@ namespace ouzel::graphics::opengl::android
     RenderDevice::~RenderDevice()
     {
         running = false;
-        CommandBuffer commandBuffer;
-        commandBuffer.pushCommand(std::make_unique<PresentCommand>());
-        submitCommandBuffer(std::move(commandBuffer));
+        wakeRenderThread();
 
         if (renderThread.isJoinable()) renderThread.join();
 
@@ -208,9 +206,7 @@ namespace ouzel::graphics::opengl::android
     void RenderDevice::reload()
     {
         running = false;
-        CommandBuffer commandBuffer;
-        commandBuffer.pushCommand(std::make_unique<PresentCommand>());
-        submitCommandBuffer(std::move(commandBuffer));
+        wakeRenderThread();
 
         if (renderThread.isJoinable()) renderThread.join();
 
@@ -311,15 +307,20 @@ namespace ouzel::graphics::opengl::android
         frameBufferHeight = surfaceHeight;
 
         stateCache = StateCache();
+        vertexArrays.clear();
+        defaultVertexArray = VertexArray{};
 
         glDisableProc(GL_DITHER);
         glDepthFuncProc(GL_LEQUAL);
+        glPixelStoreiProc(GL_UNPACK_ALIGNMENT, 1);
 
         if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
             throw std::system_error{makeErrorCode(error), "Failed to set depth function"};
 
         if (glGenVertexArraysProc) glGenVertexArraysProc(1, &vertexArrayId);
 
+        createStreamingBuffers();
+
         for (const auto& resource : resources)
             if (resource) resource->invalidate();
 
@@ -336,9 +337,7 @@ namespace ouzel::graphics::opengl::android
     void RenderDevice::destroy()
     {
         running = false;
-        CommandBuffer commandBuffer;
-        commandBuffer.pushCommand(std::make_unique<PresentCommand>());
-        submitCommandBuffer(std::move(commandBuffer));
+        wakeRenderThread();
 
         if (renderThread.isJoinable()) renderThread.join();
 
@@ -70,9 +70,7 @@ namespace ouzel::graphics::opengl::ios
     {
         running = false;
         runLoop.stop();
-        CommandBuffer commandBuffer;
-        commandBuffer.pushCommand(std::make_unique<PresentCommand>());
-        submitCommandBuffer(std::move(commandBuffer));
+        wakeRenderThread();
 
         if (msaaColorRenderBufferId) glDeleteRenderbuffersProc(1, &msaaColorRenderBufferId);
         if (msaaFrameBufferId) glDeleteFramebuffersProc(1, &msaaFrameBufferId);
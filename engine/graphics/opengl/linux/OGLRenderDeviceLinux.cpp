@@ -166,9 +166,7 @@ namespace ouzel::graphics::opengl::linux
     RenderDevice::~RenderDevice()
     {
         running = false;
-        CommandBuffer commandBuffer;
-        commandBuffer.pushCommand(std::make_unique<PresentCommand>());
-        submitCommandBuffer(std::move(commandBuffer));
+        wakeRenderThread();
 
         if (renderThread.isJoinable()) renderThread.join();
 
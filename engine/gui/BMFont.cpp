@@ -3,6 +3,7 @@
 #include <string>
 #include <iterator>
 #include <stdexcept>
+#include <utility>
 #include "BMFont.hpp"
 #include "../core/Engine.hpp"
 #include "../assets/Cache.hpp"
@@ -181,8 +182,10 @@ namespace ouzel::gui
         }
     }
 
-    BMFont::BMFont(const std::vector<std::byte>& data)
+    BMFont::BMFont(const std::vector<std::byte>& data, bool initDistanceField)
     {
+        distanceField = initDistanceField;
+
         auto iterator = data.cbegin();
 
         std::string keyword;
@@ -331,6 +334,30 @@ namespace ouzel::gui
         }
     }
 
+    BMFont::BMFont(std::uint16_t initLineHeight,
+                   std::uint16_t initBase,
+                   std::uint16_t initWidth,
+                   std::uint16_t initHeight,
+                   std::uint16_t initPages,
+                   std::uint16_t initOutline,
+                   std::unordered_map<char32_t, CharDescriptor> initChars,
+                   std::map<std::pair<char32_t, char32_t>, std::int16_t> initKern,
+                   std::shared_ptr<graphics::Texture> initFontTexture,
+                   bool initDistanceField):
+        lineHeight{initLineHeight},
+        base{initBase},
+        width{initWidth},
+        height{initHeight},
+        pages{initPages},
+        outline{initOutline},
+        kernCount{static_cast<std::uint16_t>(initKern.size())},
+        chars{std::move(initChars)},
+        kern{std::move(initKern)},
+        fontTexture{std::move(initFontTexture)}
+    {
+        distanceField = initDistanceField;
+    }
+
     Font::RenderData BMFont::getRenderData(const std::string_view& text,
                                            math::Color color,
                                            float fontSize,
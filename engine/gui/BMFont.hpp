@@ -12,17 +12,6 @@ namespace ouzel::gui
     class BMFont final: public Font
     {
     public:
-        BMFont() = default;
-        explicit BMFont(const std::vector<std::byte>& data);
-
-        RenderData getRenderData(const std::string_view& text,
-                                 math::Color color,
-                                 float fontSize,
-                                 const math::Vector<float, 2>& anchor) const override;
-
-    private:
-        std::int16_t getKerningPair(char32_t, char32_t) const;
-
         struct CharDescriptor final
         {
             std::int16_t x = 0;
@@ -35,6 +24,27 @@ namespace ouzel::gui
             std::int16_t page = 0;
         };
 
+        BMFont() = default;
+        explicit BMFont(const std::vector<std::byte>& data, bool initDistanceField = false);
+        BMFont(std::uint16_t initLineHeight,
+               std::uint16_t initBase,
+               std::uint16_t initWidth,
+               std::uint16_t initHeight,
+               std::uint16_t initPages,
+               std::uint16_t initOutline,
+               std::unordered_map<char32_t, CharDescriptor> initChars,
+               std::map<std::pair<char32_t, char32_t>, std::int16_t> initKern,
+               std::shared_ptr<graphics::Texture> initFontTexture,
+               bool initDistanceField = false);
+
+        RenderData getRenderData(const std::string_view& text,
+                                 math::Color color,
+                                 float fontSize,
+                                 const math::Vector<float, 2>& anchor) const override;
+
+    private:
+        std::int16_t getKerningPair(char32_t, char32_t) const;
+
         std::uint16_t lineHeight = 0;
         std::uint16_t base = 0;
         std::uint16_t width = 0;
@@ -36,6 +36,17 @@ namespace ouzel::gui
                                          math::Color color,
                                          float fontSize,
                                          const math::Vector<float, 2>& anchor) const = 0;
+
+        // changes when the render data returned earlier becomes invalid and has to be requested again
+        auto getVersion() const noexcept { return version; }
+
+        // the texture stores the distance to the edge of the glyphs instead of their coverage,
+        // so the text has to be drawn with the distance field shader, but stays sharp at any size
+        auto isDistanceField() const noexcept { return distanceField; }
+
+    protected:
+        mutable std::uint32_t version = 0;
+        bool distanceField = false;
     };
 }
 
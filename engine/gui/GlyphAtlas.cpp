@@ -0,0 +1,232 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <cstring>
+#include "GlyphAtlas.hpp"
+#include "../graphics/Driver.hpp"
+
+namespace ouzel::gui
+{
+    namespace
+    {
+        // empty space on the right and at the bottom of every glyph, so that the neighbours don't bleed in when filtering
+        constexpr std::uint32_t padding = 1U;
+
+        graphics::PixelFormat getAtlasPixelFormat(const graphics::RenderDevice& renderDevice) noexcept
+        {
+            // only the OpenGL text shader reads the coverage from a single channel,
+            // the other drivers draw the glyphs with the texture shader, which needs white RGBA pixels
+            if (renderDevice.getDriver() == graphics::Driver::openGl)
+                return (renderDevice.getAPIMajorVersion() >= 3) ?
+                    graphics::PixelFormat::r8UnsignedNorm : // alpha textures are not supported by the core profile
+                    graphics::PixelFormat::a8UnsignedNorm; // red textures are not supported by OpenGL 2 and OpenGL ES 2
+
+            return graphics::PixelFormat::rgba8UnsignedNorm;
+        }
+    }
+
+    GlyphAtlas::GlyphAtlas(graphics::Graphics& initGraphics,
+                           std::uint32_t initSize,
+                           std::uint32_t initMaxSize):
+        graphics{initGraphics},
+        pixelFormat{getAtlasPixelFormat(*initGraphics.getDevice())},
+        size{initSize, initSize},
+        maxSize{std::max(initSize, initMaxSize)},
+        data(static_cast<std::size_t>(initSize) * initSize)
+    {
+        createTexture();
+    }
+
+    const GlyphAtlas::Region* GlyphAtlas::getGlyph(std::uint32_t glyph) noexcept
+    {
+        const auto i = glyphs.find(glyph);
+        if (i == glyphs.end()) return nullptr;
+
+        shelves[i->second.shelf].lastUse = currentUse;
+        return &i->second.region;
+    }
+
+    const GlyphAtlas::Region* GlyphAtlas::addGlyph(std::uint32_t glyph, std::uint32_t width, std::uint32_t height)
+    {
+        const auto paddedWidth = width + padding;
+        const auto paddedHeight = height + padding;
+
+        if (paddedWidth > maxSize || paddedHeight > maxSize)
+            return nullptr;
+
+        auto shelf = findShelf(paddedWidth, paddedHeight);
+
+        while (!shelf)
+            if (paddedWidth <= size.v[0] && paddedHeight <= size.v[1] - shelvesHeight)
+            {
+                // round the height up, so that the shelf can be reused by slightly taller glyphs
+                Shelf newShelf;
+                newShelf.y = shelvesHeight;
+                newShelf.height = std::min((paddedHeight + 3U) & ~3U, size.v[1] - shelvesHeight);
+                shelves.push_back(std::move(newShelf));
+
+                shelvesHeight += shelves.back().height;
+                shelf = &shelves.back();
+            }
+            else if (grow())
+                shelf = findShelf(paddedWidth, paddedHeight);
+            else if (!(shelf = evictShelf(paddedHeight)))
+                return nullptr;
+
+        auto& result = glyphs[glyph];
+        result.region = Region{shelf->width, shelf->y, width, height};
+        result.shelf = static_cast<std::size_t>(shelf - shelves.data());
+
+        shelf->width += paddedWidth;
+        shelf->lastUse = currentUse;
+        shelf->glyphs.push_back(glyph);
+
+        addDirtyRect(result.region.x, result.region.y, width, height);
+
+        return &result.region;
+    }
+
+    void GlyphAtlas::upload()
+    {
+        if (dirtyRight <= dirtyLeft || dirtyBottom <= dirtyTop) return;
+
+        const math::Rect<std::uint32_t> rect{dirtyLeft, dirtyTop, dirtyRight - dirtyLeft, dirtyBottom - dirtyTop};
+        texture->setData(getTextureData(rect), rect);
+
+        dirtyLeft = dirtyTop = dirtyRight = dirtyBottom = 0;
+    }
+
+    GlyphAtlas::Shelf* GlyphAtlas::findShelf(std::uint32_t width, std::uint32_t height) noexcept
+    {
+        Shelf* result = nullptr;
+
+        // the lowest shelf that has space for the glyph, shelves with glyphs are not used
+        // for glyphs that are much lower than the shelf to not waste the space
+        for (auto& shelf : shelves)
+            if (shelf.height >= height &&
+                shelf.width + width <= size.v[0] &&
+                (shelf.glyphs.empty() || shelf.height - height <= height / 2) &&
+                (!result || shelf.height < result->height))
+                result = &shelf;
+
+        return result;
+    }
+
+    GlyphAtlas::Shelf* GlyphAtlas::evictShelf(std::uint32_t height)
+    {
+        Shelf* result = nullptr;
+
+        // the least recently used shelf that is high enough, the glyphs of the current use have to stay
+        for (auto& shelf : shelves)
+            if (shelf.height >= height &&
+                shelf.lastUse != currentUse &&
+                (!result || shelf.lastUse < result->lastUse ||
+                 (shelf.lastUse == result->lastUse && shelf.height < result->height)))
+                result = &shelf;
+
+        if (!result) return nullptr;
+
+        for (const auto glyph : result->glyphs)
+            glyphs.erase(glyph);
+
+        result->glyphs.clear();
+        result->width = 0;
+
+        std::fill(data.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(result->y) * size.v[0]),
+                  data.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(result->y + result->height) * size.v[0]),
+                  std::uint8_t(0));
+        addDirtyRect(0, result->y, size.v[0], result->height);
+
+        ++generation;
+
+        return result;
+    }
+
+    bool GlyphAtlas::grow()
+    {
+        if (size.v[0] >= maxSize && size.v[1] >= maxSize)
+            return false;
+
+        const math::Size<std::uint32_t, 2> newSize{
+            std::min(size.v[0] * 2U, maxSize),
+            std::min(size.v[1] * 2U, maxSize)
+        };
+
+        // the shelves keep their positions, so only the rows have to be copied
+        std::vector<std::uint8_t> newData(static_cast<std::size_t>(newSize.v[0]) * newSize.v[1]);
+        for (std::uint32_t row = 0; row < size.v[1]; ++row)
+            std::memcpy(newData.data() + static_cast<std::size_t>(row) * newSize.v[0],
+                        data.data() + static_cast<std::size_t>(row) * size.v[0],
+                        size.v[0]);
+
+        data = std::move(newData);
+        size = newSize;
+
+        // the texture coordinates change, so the text has to be rebuilt with the new texture
+        createTexture();
+        ++generation;
+
+        return true;
+    }
+
+    void GlyphAtlas::createTexture()
+    {
+        const math::Rect<std::uint32_t> rect{0U, 0U, size.v[0], size.v[1]};
+        texture = std::make_shared<graphics::Texture>(graphics,
+                                                      getTextureData(rect),
+                                                      size,
+                                                      graphics::Flags::dynamic,
+                                                      1,
+                                                      pixelFormat);
+
+        dirtyLeft = dirtyTop = dirtyRight = dirtyBottom = 0;
+    }
+
+    std::vector<std::uint8_t> GlyphAtlas::getTextureData(const math::Rect<std::uint32_t>& rect) const
+    {
+        const auto pixelSize = graphics::getPixelSize(pixelFormat);
+        std::vector<std::uint8_t> result(static_cast<std::size_t>(rect.size.v[0]) * rect.size.v[1] * pixelSize);
+
+        auto destination = result.data();
+        for (std::uint32_t row = 0; row < rect.size.v[1]; ++row)
+        {
+            const auto source = data.data() + static_cast<std::size_t>(rect.position.v[1] + row) * size.v[0] + rect.position.v[0];
+
+            if (pixelSize == 1)
+            {
+                std::memcpy(destination, source, rect.size.v[0]);
+                destination += rect.size.v[0];
+            }
+            else
+                for (std::uint32_t column = 0; column < rect.size.v[0]; ++column)
+                {
+                    *destination++ = 255;
+                    *destination++ = 255;
+                    *destination++ = 255;
+                    *destination++ = source[column];
+                }
+        }
+
+        return result;
+    }
+
+    void GlyphAtlas::addDirtyRect(std::uint32_t x, std::uint32_t y, std::uint32_t width, std::uint32_t height) noexcept
+    {
+        if (width == 0 || height == 0) return;
+
+        if (dirtyRight <= dirtyLeft || dirtyBottom <= dirtyTop)
+        {
+            dirtyLeft = x;
+            dirtyTop = y;
+            dirtyRight = x + width;
+            dirtyBottom = y + height;
+        }
+        else
+        {
+            dirtyLeft = std::min(dirtyLeft, x);
+            dirtyTop = std::min(dirtyTop, y);
+            dirtyRight = std::max(dirtyRight, x + width);
+            dirtyBottom = std::max(dirtyBottom, y + height);
+        }
+    }
+}
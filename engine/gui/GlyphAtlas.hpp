@@ -0,0 +1,106 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GUI_GLYPHATLAS_HPP
+#define OUZEL_GUI_GLYPHATLAS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "../graphics/Graphics.hpp"
+#include "../graphics/Texture.hpp"
+#include "../math/Rect.hpp"
+#include "../math/Size.hpp"
+
+namespace ouzel::gui
+{
+    // Texture that is filled with glyphs on demand. The glyphs are packed into shelves (rows of glyphs
+    // of a similar height) and when the atlas can't grow anymore, the least recently used shelves are evicted.
+    // The coverage is kept in one byte per pixel and only the changed part is uploaded.
+    class GlyphAtlas final
+    {
+    public:
+        struct Region final
+        {
+            std::uint32_t x = 0;
+            std::uint32_t y = 0;
+            std::uint32_t width = 0;
+            std::uint32_t height = 0;
+        };
+
+        GlyphAtlas(graphics::Graphics& initGraphics,
+                   std::uint32_t initSize = 256,
+                   std::uint32_t initMaxSize = 2048);
+
+        // starts a new use of the atlas, the glyphs used in it are not evicted until the next use starts
+        void beginUse() noexcept { ++currentUse; }
+
+        // returns the region of the glyph and marks it as used or null if the glyph is not in the atlas
+        const Region* getGlyph(std::uint32_t glyph) noexcept;
+
+        // allocates a region for the glyph, the caller has to write its coverage with getPixels,
+        // returns null if the glyph doesn't fit even after evicting all the shelves not used in the current use
+        const Region* addGlyph(std::uint32_t glyph, std::uint32_t width, std::uint32_t height);
+
+        // the coverage of the region, rows are getSize().v[0] bytes apart
+        std::uint8_t* getPixels(const Region& region) noexcept
+        {
+            return data.data() + static_cast<std::size_t>(region.y) * size.v[0] + region.x;
+        }
+
+        // uploads the regions added since the last upload
+        void upload();
+
+        auto& getTexture() const noexcept { return texture; }
+        auto& getSize() const noexcept { return size; }
+
+        // changes every time the regions returned earlier become invalid because of eviction or growing
+        auto getGeneration() const noexcept { return generation; }
+
+    private:
+        struct Shelf final
+        {
+            std::uint32_t y = 0;
+            std::uint32_t height = 0;
+            std::uint32_t width = 0; // the used width
+            std::uint64_t lastUse = 0;
+            std::vector<std::uint32_t> glyphs;
+        };
+
+        struct Glyph final
+        {
+            Region region;
+            std::size_t shelf = 0;
+        };
+
+        Shelf* findShelf(std::uint32_t width, std::uint32_t height) noexcept;
+        Shelf* evictShelf(std::uint32_t height);
+        bool grow();
+        void createTexture();
+        std::vector<std::uint8_t> getTextureData(const math::Rect<std::uint32_t>& rect) const;
+        void addDirtyRect(std::uint32_t x, std::uint32_t y, std::uint32_t width, std::uint32_t height) noexcept;
+
+        graphics::Graphics& graphics;
+        graphics::PixelFormat pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
+        math::Size<std::uint32_t, 2> size;
+        std::uint32_t maxSize;
+        std::vector<std::uint8_t> data;
+        std::shared_ptr<graphics::Texture> texture;
+
+        std::vector<Shelf> shelves;
+        std::uint32_t shelvesHeight = 0;
+        std::unordered_map<std::uint32_t, Glyph> glyphs;
+
+        std::uint64_t currentUse = 0;
+        std::uint32_t generation = 0;
+
+        // the part of the data that has not been uploaded yet, empty if right <= left
+        std::uint32_t dirtyLeft = 0;
+        std::uint32_t dirtyTop = 0;
+        std::uint32_t dirtyRight = 0;
+        std::uint32_t dirtyBottom = 0;
+    };
+}
+
+#endif // OUZEL_GUI_GLYPHATLAS_HPP
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <stdexcept>
 #include "TTFont.hpp"
 #include "../core/Engine.hpp"
@@ -27,10 +28,11 @@
 
 namespace ouzel::gui
 {
-    TTFont::TTFont(const std::vector<std::byte>& initData, bool initMipmaps):
-        data{initData},
-        mipmaps{initMipmaps}
+    TTFont::TTFont(const std::vector<std::byte>& initData, bool initDistanceField):
+        data{initData}
     {
+        distanceField = initDistanceField;
+
         const auto offset = stbtt_GetFontOffsetForIndex(reinterpret_cast<const unsigned char*>(data.data()), 0);
 
         if (offset == -1)
@@ -50,103 +52,68 @@ namespace ouzel::gui
         if (!font)
             throw std::runtime_error{"Font not loaded"};
 
-        constexpr std::uint32_t spacing = 2U;
+        // all the sizes of a distance field font share the glyphs of one size
+        const auto glyphSize = distanceField ? distanceFieldSize : fontSize;
+        const auto glyphScale = fontSize / glyphSize;
 
-        const auto s = stbtt_ScaleForPixelHeight(font.get(), fontSize);
+        auto& glyphCache = getGlyphCache(glyphSize);
+        auto& atlas = glyphCache.atlas;
+        const auto s = glyphCache.scale;
+        const auto generation = atlas.getGeneration();
 
         const auto utf32Text = utf8::toUtf32(text);
 
-        std::set<char32_t> glyphs;
-        for (const auto i : utf32Text)
-            glyphs.insert(i);
-
-        std::uint16_t width = 0;
-        std::uint16_t height = 0;
-
         int ascent;
         int descent;
         int lineGap;
         stbtt_GetFontVMetrics(font.get(), &ascent, &descent, &lineGap);
 
-        struct CharDescriptor final
+        // look up all the glyphs first, because adding them to the atlas can change its size
+        struct Character final
         {
-            std::uint16_t x = 0;
-            std::uint16_t y = 0;
-            std::uint16_t width = 0;
-            std::uint16_t height = 0;
-            math::Vector<float, 2> offset{};
-            float advance = 0;
-            std::vector<std::uint8_t> bitmap;
+            const Glyph* glyph = nullptr;
+            const GlyphAtlas::Region* region = nullptr;
         };
 
-        std::unordered_map<std::uint32_t, CharDescriptor> chars;
-
-        for (const char32_t c : glyphs)
-            if (const auto index = stbtt_FindGlyphIndex(font.get(), static_cast<int>(c)))
-            {
-                int advance;
-                int leftBearing;
-                stbtt_GetGlyphHMetrics(font.get(), index, &advance, &leftBearing);
-
-                CharDescriptor charDesc;
-                int w;
-                int h;
-                int xoff;
-                int yoff;
-
-                if (const auto bitmap = stbtt_GetGlyphBitmapSubpixel(font.get(), s, s, 0.0F, 0.0F, index, &w, &h, &xoff, &yoff))
-                {
-                    charDesc.width = static_cast<std::uint16_t>(w);
-                    charDesc.height = static_cast<std::uint16_t>(h);
-                    charDesc.offset.v[0] = static_cast<float>(leftBearing * s);
-                    charDesc.offset.v[1] = static_cast<float>(yoff + (ascent - descent) * s);
-                    charDesc.bitmap = std::vector<std::uint8_t>(bitmap, bitmap + h * w);
-                    charDesc.x = width;
-
-                    width += static_cast<std::uint16_t>(w);
-                    height = std::max(height, static_cast<std::uint16_t>(h));
-
-                    stbtt_FreeBitmap(bitmap, nullptr);
-                }
-
-                charDesc.advance = static_cast<float>(advance * s);
-
-                if (!chars.empty())
-                    width += spacing;
+        std::vector<Character> characters(utf32Text.size());
 
-                chars[c] = charDesc;
-            }
+        atlas.beginUse();
 
-        std::vector<std::uint8_t> textureData(width * height * 4);
+        for (std::size_t i = 0; i < utf32Text.size(); ++i)
+        {
+            const auto c = static_cast<std::uint32_t>(utf32Text[i]);
+            const auto& glyph = getGlyph(glyphCache, c);
+            characters[i].glyph = &glyph;
 
-        for (std::uint16_t posX = 0; posX < width; ++posX)
-            for (std::uint16_t posY = 0; posY < height; ++posY)
+            if (glyph.index && glyph.width && glyph.height)
             {
-                textureData[(posY * width + posX) * 4 + 0] = 255;
-                textureData[(posY * width + posX) * 4 + 1] = 255;
-                textureData[(posY * width + posX) * 4 + 2] = 255;
-                textureData[(posY * width + posX) * 4 + 3] = 0;
+                characters[i].region = atlas.getGlyph(c);
+
+                if (!characters[i].region)
+                    if (const auto region = atlas.addGlyph(c, glyph.width, glyph.height))
+                    {
+                        if (distanceField)
+                            makeDistanceField(glyphCache, glyph, *region);
+                        else
+                            stbtt_MakeGlyphBitmapSubpixel(font.get(), atlas.getPixels(*region),
+                                                          static_cast<int>(region->width),
+                                                          static_cast<int>(region->height),
+                                                          static_cast<int>(atlas.getSize().v[0]),
+                                                          s, s, 0.0F, 0.0F, glyph.index);
+                        characters[i].region = region;
+                    }
             }
+        }
 
-        for (const auto& c : chars)
-        {
-            const auto& charDesc = c.second;
+        atlas.upload();
 
-            for (std::uint16_t posX = 0; posX < charDesc.width; ++posX)
-                for (std::uint16_t posY = 0; posY < charDesc.height; ++posY)
-                {
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 0] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 1] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 2] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 3] = charDesc.bitmap[posY * charDesc.width + posX];
-                }
-        }
+        // the texts built before have to be rebuilt if their glyphs were evicted or the atlas has grown
+        if (atlas.getGeneration() != generation)
+            ++version;
 
-        auto texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
-                                                           textureData,
-                                                           math::Size<std::uint32_t, 2>{width, height},
-                                                           graphics::Flags::none,
-                                                           mipmaps ? 0 : 1);
+        const auto& atlasSize = atlas.getSize();
+        const auto width = static_cast<float>(atlasSize.v[0]);
+        const auto height = static_cast<float>(atlasSize.v[1]);
 
         math::Vector<float, 2> position{};
 
@@ -157,11 +124,11 @@ namespace ouzel::gui
 
         std::size_t firstChar = 0;
 
-        for (auto i = utf32Text.begin(); i != utf32Text.end(); ++i)
+        for (std::size_t i = 0; i < utf32Text.size(); ++i)
         {
-            if (auto iterator = chars.find(*i); iterator != chars.end())
+            if (const auto& character = characters[i]; character.glyph->index)
             {
-                const auto& f = iterator->second;
+                const auto& f = *character.glyph;
 
                 const auto startIndex = static_cast<std::uint16_t>(vertices.size());
                 indices.push_back(startIndex + 0);
@@ -172,14 +139,17 @@ namespace ouzel::gui
                 indices.push_back(startIndex + 3);
                 indices.push_back(startIndex + 2);
 
+                // glyphs that didn't fit into the atlas are left out, but still advance the position
+                const auto region = character.region ? *character.region : GlyphAtlas::Region{};
+
                 const math::Vector<float, 2> leftTop{
-                    f.x / static_cast<float>(width),
-                    f.y / static_cast<float>(height)
+                    region.x / width,
+                    region.y / height
                 };
 
                 const math::Vector<float, 2> rightBottom{
-                    (f.x + f.width) / static_cast<float>(width),
-                    (f.y + f.height) / static_cast<float>(height)
+                    (region.x + region.width) / width,
+                    (region.y + region.height) / height
                 };
 
                 const std::array<math::Vector<float, 2>, 4> textCoords{
@@ -189,28 +159,32 @@ namespace ouzel::gui
                     math::Vector<float, 2>{rightBottom.v[0], leftTop.v[1]}
                 };
 
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0], -position.v[1] - f.offset.v[1] - f.height, 0.0F},
+                const auto glyphWidth = static_cast<float>(region.width) * glyphScale;
+                const auto glyphHeight = static_cast<float>(region.height) * glyphScale;
+                const auto offset = f.offset * glyphScale;
+
+                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + offset.v[0], -position.v[1] - offset.v[1] - glyphHeight, 0.0F},
                                       color, textCoords[0], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0] + f.width, -position.v[1] - f.offset.v[1] - f.height, 0.0F},
+                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + offset.v[0] + glyphWidth, -position.v[1] - offset.v[1] - glyphHeight, 0.0F},
                                       color, textCoords[1], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0], -position.v[1] - f.offset.v[1], 0.0F},
+                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + offset.v[0], -position.v[1] - offset.v[1], 0.0F},
                                       color, textCoords[2], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0] + f.width, -position.v[1] - f.offset.v[1], 0.0F},
+                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + offset.v[0] + glyphWidth, -position.v[1] - offset.v[1], 0.0F},
                                       color, textCoords[3], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
 
-                if ((i + 1) != utf32Text.end())
+                if (i + 1 < utf32Text.size() && characters[i + 1].glyph->index)
                 {
-                    const auto kernAdvance = stbtt_GetCodepointKernAdvance(font.get(),
-                                                                           static_cast<int>(*i),
-                                                                           static_cast<int>(*(i + 1)));
-                    position.v[0] += static_cast<float>(kernAdvance) * s;
+                    const auto kernAdvance = stbtt_GetGlyphKernAdvance(font.get(),
+                                                                       f.index,
+                                                                       characters[i + 1].glyph->index);
+                    position.v[0] += static_cast<float>(kernAdvance) * s * glyphScale;
                 }
 
-                position.v[0] += f.advance;
+                position.v[0] += f.advance * glyphScale;
             }
 
-            if (*i == static_cast<std::uint32_t>('\n') || // line feed
-                (i + 1) == utf32Text.end()) // end of string
+            if (utf32Text[i] == static_cast<std::uint32_t>('\n') || // line feed
+                i + 1 == utf32Text.size()) // end of string
             {
                 const auto lineWidth = position.v[0];
                 position.v[0] = 0.0F;
@@ -228,6 +202,97 @@ namespace ouzel::gui
         for (auto& vertex : vertices)
             vertex.position.v[1] += textHeight * (1.0F - anchor.v[1]);
 
-        return std::make_tuple(std::move(indices), std::move(vertices), std::move(texture));
+        return std::make_tuple(std::move(indices), std::move(vertices), atlas.getTexture());
+    }
+
+    TTFont::GlyphCache& TTFont::getGlyphCache(float fontSize) const
+    {
+        auto i = glyphCaches.find(fontSize);
+
+        if (i == glyphCaches.end())
+        {
+            if (glyphCaches.size() >= maxGlyphCaches)
+            {
+                // the texts of the least recently used size will get new glyphs when they are rebuilt
+                glyphCaches.erase(std::min_element(glyphCaches.begin(), glyphCaches.end(),
+                                                   [](const auto& a, const auto& b) noexcept {
+                                                       return a.second->lastUse < b.second->lastUse;
+                                                   }));
+                ++version;
+            }
+
+            i = glyphCaches.emplace(fontSize,
+                                    std::make_unique<GlyphCache>(engine->getGraphics(),
+                                                                 stbtt_ScaleForPixelHeight(font.get(), fontSize))).first;
+        }
+
+        i->second->lastUse = ++currentUse;
+        return *i->second;
+    }
+
+    const TTFont::Glyph& TTFont::getGlyph(GlyphCache& glyphCache, std::uint32_t c) const
+    {
+        if (const auto i = glyphCache.glyphs.find(c); i != glyphCache.glyphs.end())
+            return i->second;
+
+        auto& glyph = glyphCache.glyphs[c];
+
+        if (const auto index = stbtt_FindGlyphIndex(font.get(), static_cast<int>(c)))
+        {
+            int ascent;
+            int descent;
+            int lineGap;
+            stbtt_GetFontVMetrics(font.get(), &ascent, &descent, &lineGap);
+
+            int advance;
+            int leftBearing;
+            stbtt_GetGlyphHMetrics(font.get(), index, &advance, &leftBearing);
+
+            int x0;
+            int y0;
+            int x1;
+            int y1;
+            stbtt_GetGlyphBitmapBoxSubpixel(font.get(), index, glyphCache.scale, glyphCache.scale, 0.0F, 0.0F,
+                                            &x0, &y0, &x1, &y1);
+
+            // the distance field of the glyph reaches outside of its box (the glyphs without a shape stay empty)
+            const auto spread = (distanceField && x1 > x0 && y1 > y0) ? distanceFieldSpread : 0;
+
+            glyph.index = index;
+            glyph.width = static_cast<std::uint32_t>(x1 - x0 + spread * 2);
+            glyph.height = static_cast<std::uint32_t>(y1 - y0 + spread * 2);
+            glyph.offset.v[0] = static_cast<float>(leftBearing * glyphCache.scale - spread);
+            glyph.offset.v[1] = static_cast<float>(y0 - spread + (ascent - descent) * glyphCache.scale);
+            glyph.advance = static_cast<float>(advance * glyphCache.scale);
+        }
+
+        return glyph;
+    }
+
+    void TTFont::makeDistanceField(GlyphCache& glyphCache, const Glyph& glyph, const GlyphAtlas::Region& region) const
+    {
+        int width;
+        int height;
+        int xOffset;
+        int yOffset;
+
+        // the edge of the glyph is at the middle of the range and the distance reaches zero at the end of the spread
+        const auto field = stbtt_GetGlyphSDF(font.get(), glyphCache.scale, glyph.index,
+                                             distanceFieldSpread, 128,
+                                             128.0F / static_cast<float>(distanceFieldSpread),
+                                             &width, &height, &xOffset, &yOffset);
+        if (!field) return;
+
+        auto& atlas = glyphCache.atlas;
+        const auto pixels = atlas.getPixels(region);
+        const auto rowSize = std::min(static_cast<std::uint32_t>(width), region.width);
+        const auto rows = std::min(static_cast<std::uint32_t>(height), region.height);
+
+        for (std::uint32_t row = 0; row < rows; ++row)
+            std::memcpy(pixels + static_cast<std::size_t>(row) * atlas.getSize().v[0],
+                        field + static_cast<std::size_t>(row) * static_cast<std::size_t>(width),
+                        rowSize);
+
+        stbtt_FreeSDF(field, nullptr);
     }
 }
@@ -3,7 +3,9 @@
 #ifndef OUZEL_GUI_TTFONT_HPP
 #define OUZEL_GUI_TTFONT_HPP
 
+#include <unordered_map>
 #include "../gui/Font.hpp"
+#include "../gui/GlyphAtlas.hpp"
 
 struct stbtt_fontinfo;
 
@@ -13,7 +15,7 @@ namespace ouzel::gui
     {
     public:
         TTFont() = default;
-        TTFont(const std::vector<std::byte>& newData, bool newMipmaps = true);
+        explicit TTFont(const std::vector<std::byte>& newData, bool initDistanceField = false);
 
         RenderData getRenderData(const std::string_view& text,
                                  math::Color color,
@@ -21,9 +23,46 @@ namespace ouzel::gui
                                  const math::Vector<float, 2>& anchor) const override;
 
     private:
+        // the number of font sizes that have their glyphs cached at the same time
+        static constexpr std::size_t maxGlyphCaches = 8;
+
+        // the distance fields are generated once at this size and scaled to all the font sizes
+        static constexpr float distanceFieldSize = 48.0F;
+        // the number of pixels the distance field reaches outside of the glyph, which limits the outline width
+        static constexpr int distanceFieldSpread = 6;
+
+        struct Glyph final
+        {
+            int index = 0; // zero if the font doesn't have the glyph
+            std::uint32_t width = 0;
+            std::uint32_t height = 0;
+            math::Vector<float, 2> offset{};
+            float advance = 0.0F;
+        };
+
+        // the metrics and the atlas of the glyphs of one font size, shared by all the texts of that size
+        struct GlyphCache final
+        {
+            GlyphCache(graphics::Graphics& graphics, float initScale):
+                scale{initScale}, atlas{graphics}
+            {
+            }
+
+            float scale;
+            std::unordered_map<std::uint32_t, Glyph> glyphs;
+            GlyphAtlas atlas;
+            std::uint64_t lastUse = 0;
+        };
+
+        GlyphCache& getGlyphCache(float fontSize) const;
+        const Glyph& getGlyph(GlyphCache& glyphCache, std::uint32_t c) const;
+        void makeDistanceField(GlyphCache& glyphCache, const Glyph& glyph, const GlyphAtlas::Region& region) const;
+
         std::unique_ptr<stbtt_fontinfo> font;
         std::vector<std::byte> data;
-        bool mipmaps = true;
+
+        mutable std::unordered_map<float, std::unique_ptr<GlyphCache>> glyphCaches;
+        mutable std::uint64_t currentUse = 0;
     };
 }
 
@@ -3,7 +3,9 @@
 #ifndef OUZEL_HASH_FNV1_HPP
 #define OUZEL_HASH_FNV1_HPP
 
+#include <cstddef>
 #include <cstdint>
+#include <string_view>
 
 namespace ouzel::hash::fnv1
 {
@@ -32,4 +34,19 @@ namespace ouzel::hash::fnv1
     }
 }
 
+namespace ouzel::hash::fnv1a
+{
+    // FNV-1a of the string, can be evaluated at compile time for literals
+    template <typename Result>
+    constexpr Result hash(const std::string_view value) noexcept
+    {
+        Result result = fnv1::Constants<Result>::offsetBasis;
+
+        for (const auto c : value)
+            result = (result ^ static_cast<std::uint8_t>(c)) * fnv1::Constants<Result>::prime;
+
+        return result;
+    }
+}
+
 #endif // OUZEL_HASH_FNV1_HPP
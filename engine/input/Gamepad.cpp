@@ -44,19 +44,19 @@ namespace ouzel::input
 
     bool Gamepad::handleButtonValueChange(Gamepad::Button button, bool pressed, float value)
     {
-        auto event = std::make_unique<GamepadEvent>();
-        event->type = Event::Type::gamepadButtonChange;
-        event->gamepad = this;
-        event->button = button;
-        event->previousPressed = buttonStates.test(static_cast<std::size_t>(button));
-        event->pressed = pressed;
-        event->value = value;
-        event->previousValue = buttonValues[static_cast<std::size_t>(button)];
+        GamepadEvent event;
+        event.type = Event::Type::gamepadButtonChange;
+        event.gamepad = this;
+        event.button = button;
+        event.previousPressed = buttonStates.test(static_cast<std::size_t>(button));
+        event.pressed = pressed;
+        event.value = value;
+        event.previousValue = buttonValues[static_cast<std::size_t>(button)];
 
         buttonStates.set(static_cast<std::size_t>(button), pressed);
         buttonValues[static_cast<std::size_t>(button)] = value;
 
-        return engine->getEventDispatcher().dispatchEvent(std::move(event));
+        return engine->getEventDispatcher().dispatchEvent(event);
     }
 
     void Gamepad::setVibration(Motor motor, float speed)
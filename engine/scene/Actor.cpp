@@ -237,10 +237,9 @@ namespace ouzel::scene
             component->setActor(nullptr);
     }
 
-    void Actor::visit(std::vector<Actor*>& drawQueue,
+    void Actor::visit(std::vector<Actor*>& visibleActors,
                       const math::Matrix<float, 4>& newParentTransform,
                       bool parentTransformDirty,
-                      Camera* camera,
                       Order parentOrder,
                       bool parentHidden)
     {
@@ -250,23 +249,10 @@ namespace ouzel::scene
         if (parentTransformDirty) updateTransform(newParentTransform);
         if (transformDirty) calculateTransform();
 
-        if (!worldHidden)
-        {
-            const auto boundingBox = getBoundingBox();
-
-            if (cullDisabled || (!isEmpty(boundingBox) && camera->checkVisibility(getTransform(), boundingBox)))
-            {
-                const auto upperBound = std::upper_bound(drawQueue.begin(), drawQueue.end(), this,
-                                                         [](const auto a, const auto b) noexcept {
-                                                             return a->worldOrder > b->worldOrder;
-                                                         });
-
-                drawQueue.insert(upperBound, this);
-            }
-        }
+        if (!worldHidden) visibleActors.push_back(this);
 
         for (const auto actor : children)
-            actor->visit(drawQueue, transform, updateChildrenTransform, camera, worldOrder, worldHidden);
+            actor->visit(visibleActors, transform, updateChildrenTransform, worldOrder, worldHidden);
 
         updateChildrenTransform = false;
     }
@@ -69,10 +69,9 @@ namespace ouzel::scene
         Actor() = default;
         ~Actor() override;
 
-        virtual void visit(std::vector<Actor*>& drawQueue,
+        virtual void visit(std::vector<Actor*>& visibleActors,
                            const math::Matrix<float, 4>& newParentTransform,
                            bool parentTransformDirty,
-                           Camera* camera,
                            Order parentOrder,
                            bool parentHidden);
         virtual void draw(Camera* camera, bool wireframe);
@@ -11,9 +11,8 @@ namespace ouzel::scene
     Animator::Animator(float initLength):
         length{initLength}
     {
-        updateHandler.updateHandler = [this](const UpdateEvent& event) {
-            update(event.delta);
-            return false;
+        updater.function = [this](float delta) {
+            update(delta);
         };
     }
 
@@ -41,10 +40,12 @@ namespace ouzel::scene
                 progress = 1.0F;
                 currentTime = length;
 
-                auto finishEvent = std::make_unique<AnimationEvent>();
-                finishEvent->type = Event::Type::animationFinish;
-                finishEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                engine->getUpdateScheduler().runSerially([this]() {
+                    AnimationEvent finishEvent;
+                    finishEvent.type = Event::Type::animationFinish;
+                    finishEvent.component = this;
+                    engine->getEventDispatcher().dispatchEvent(finishEvent);
+                });
             }
             else
             {
@@ -55,18 +56,20 @@ namespace ouzel::scene
             updateProgress();
         }
         else
-            updateHandler.remove();
+            engine->getUpdateScheduler().runSerially([this]() {
+                updater.remove();
+            });
     }
 
     void Animator::start()
     {
-        engine->getEventDispatcher().addEventHandler(updateHandler);
+        engine->getUpdateScheduler().addUpdater(updater);
         play();
 
-        auto startEvent = std::make_unique<AnimationEvent>();
-        startEvent->type = Event::Type::animationStart;
-        startEvent->component = this;
-        engine->getEventDispatcher().dispatchEvent(std::move(startEvent));
+        AnimationEvent startEvent;
+        startEvent.type = Event::Type::animationStart;
+        startEvent.component = this;
+        engine->getEventDispatcher().dispatchEvent(startEvent);
     }
 
     void Animator::play()
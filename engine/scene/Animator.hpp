@@ -6,7 +6,7 @@
 #include <memory>
 #include <vector>
 #include "Component.hpp"
-#include "../events/EventHandler.hpp"
+#include "../core/UpdateScheduler.hpp"
 
 namespace ouzel::scene
 {
@@ -45,6 +45,10 @@ namespace ouzel::scene
         auto getParent() const noexcept { return parent; }
         void removeFromParent();
 
+        // animators whose target actors are not shared with other updaters can be updated in parallel
+        auto isThreadSafe() const noexcept { return updater.isThreadSafe(); }
+        void setThreadSafe(bool newThreadSafe) { updater.setThreadSafe(newThreadSafe); }
+
     protected:
         virtual void updateProgress() {}
 
@@ -57,7 +61,7 @@ namespace ouzel::scene
         Animator* parent = nullptr;
         Actor* targetActor = nullptr;
 
-        EventHandler updateHandler;
+        core::Updater updater{core::UpdatePhase::animation};
 
         std::vector<Animator*> animators;
         std::vector<std::unique_ptr<Animator>> ownedAnimators;
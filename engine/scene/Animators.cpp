@@ -151,10 +151,12 @@ namespace ouzel::scene
                 const float remainingTime = currentTime - animators.front()->getLength() * static_cast<float>(currentCount);
                 animators.front()->setProgress(remainingTime / animators.front()->getLength());
 
-                auto resetEvent = std::make_unique<AnimationEvent>();
-                resetEvent->type = Event::Type::animationReset;
-                resetEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(resetEvent));
+                engine->getUpdateScheduler().runSerially([this]() {
+                    AnimationEvent resetEvent;
+                    resetEvent.type = Event::Type::animationReset;
+                    resetEvent.component = this;
+                    engine->getEventDispatcher().dispatchEvent(resetEvent);
+                });
             }
             else
             {
@@ -163,10 +165,12 @@ namespace ouzel::scene
                 currentTime = length;
                 progress = 1.0F;
 
-                auto finishEvent = std::make_unique<AnimationEvent>();
-                finishEvent->type = Event::Type::animationFinish;
-                finishEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                engine->getUpdateScheduler().runSerially([this]() {
+                    AnimationEvent finishEvent;
+                    finishEvent.type = Event::Type::animationFinish;
+                    finishEvent.component = this;
+                    engine->getEventDispatcher().dispatchEvent(finishEvent);
+                });
             }
         }
     }
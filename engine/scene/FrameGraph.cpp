@@ -0,0 +1,88 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include "FrameGraph.hpp"
+#include "../core/Engine.hpp"
+#include "../utils/Profiler.hpp"
+
+namespace ouzel::scene
+{
+    FrameGraph::FrameGraph(const math::Size<float, 2>& initSize,
+                           std::size_t initSampleCount,
+                           float initMaxTime):
+        size{initSize},
+        sampleCount{std::max(initSampleCount, std::size_t(2))},
+        maxTime{initMaxTime}
+    {
+        updater.function = [this](float) {
+            update();
+        };
+
+        engine->getUpdateScheduler().addUpdater(updater);
+
+        redraw();
+    }
+
+    void FrameGraph::addMetric(const char* name, math::Color color)
+    {
+        metrics.push_back(Metric{name, color, {}});
+        metrics.back().history.reserve(sampleCount);
+    }
+
+    void FrameGraph::removeMetrics()
+    {
+        metrics.clear();
+        redraw();
+    }
+
+    void FrameGraph::update()
+    {
+        if (!profiler.isRecording()) return;
+
+        for (auto& metric : metrics)
+        {
+            if (metric.history.size() == sampleCount)
+                metric.history.erase(metric.history.begin());
+
+            metric.history.push_back(static_cast<float>(profiler.getLastDuration(metric.name)) / 1000000000.0F);
+        }
+
+        redraw();
+    }
+
+    void FrameGraph::redraw()
+    {
+        clear();
+
+        rectangle(math::Rect<float>{0.0F, 0.0F, size.v[0], size.v[1]},
+                  math::Color{0, 0, 0, 160}, true);
+
+        // the time of one frame at 60 FPS
+        const auto targetTime = 1.0F / 60.0F;
+        if (targetTime < maxTime)
+        {
+            const auto y = size.v[1] * targetTime / maxTime;
+            line(math::Vector<float, 2>{0.0F, y},
+                 math::Vector<float, 2>{size.v[0], y},
+                 math::Color{255, 255, 255, 128});
+        }
+
+        const auto step = size.v[0] / static_cast<float>(sampleCount - 1);
+
+        for (const auto& metric : metrics)
+        {
+            if (metric.history.size() < 2) continue;
+
+            // the newest sample is at the right edge
+            points.clear();
+            auto x = size.v[0] - step * static_cast<float>(metric.history.size() - 1);
+            for (const auto time : metric.history)
+            {
+                points.emplace_back(x, size.v[1] * std::min(time / maxTime, 1.0F));
+                x += step;
+            }
+
+            polyline(points, metric.color);
+        }
+    }
+}
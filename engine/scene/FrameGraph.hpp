@@ -0,0 +1,52 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_FRAMEGRAPH_HPP
+#define OUZEL_SCENE_FRAMEGRAPH_HPP
+
+#include <cstddef>
+#include <vector>
+#include "ShapeRenderer.hpp"
+#include "../core/UpdateScheduler.hpp"
+#include "../math/Color.hpp"
+#include "../math/Size.hpp"
+
+namespace ouzel::scene
+{
+    // On-screen graph of the durations of the profiled scopes over the last frames.
+    // The graph is updated only while the profiler is recording.
+    class FrameGraph final: public ShapeRenderer
+    {
+    public:
+        explicit FrameGraph(const math::Size<float, 2>& initSize = math::Size<float, 2>{200.0F, 100.0F},
+                            std::size_t initSampleCount = 120,
+                            float initMaxTime = 1.0F / 30.0F);
+
+        // the name must be the same string literal that was passed to OUZEL_PROFILE_SCOPE
+        void addMetric(const char* name, math::Color color);
+        void removeMetrics();
+
+        [[nodiscard]] auto& getSize() const noexcept { return size; }
+        [[nodiscard]] auto getMaxTime() const noexcept { return maxTime; }
+
+    private:
+        struct Metric final
+        {
+            const char* name;
+            math::Color color;
+            std::vector<float> history; // seconds, oldest first
+        };
+
+        void update();
+        void redraw();
+
+        math::Size<float, 2> size;
+        std::size_t sampleCount;
+        float maxTime;
+        std::vector<Metric> metrics;
+        std::vector<math::Vector<float, 2>> points;
+
+        core::Updater updater{core::UpdatePhase::preRender};
+    };
+}
+
+#endif // OUZEL_SCENE_FRAMEGRAPH_HPP
@@ -23,20 +23,55 @@ namespace ouzel::scene
 
     void Layer::draw()
     {
+        if (cameras.empty()) return;
+
+        // transforms are updated only once per frame, not for every camera
+        visibleActors.clear();
+        for (const auto actor : children)
+            actor->visit(visibleActors, math::identityMatrix<float, 4>, false, 0, false);
+
+        // actors with the same world order keep their tree order
+        std::stable_sort(visibleActors.begin(), visibleActors.end(),
+                         [](const auto a, const auto b) noexcept {
+                             return a->worldOrder > b->worldOrder;
+                         });
+
+        auto& workerPool = engine->getWorkerPool();
+
+        boundingBoxes.resize(visibleActors.size());
+        actorVisibilities.resize(visibleActors.size());
+
+        workerPool.parallelFor(0, visibleActors.size(), cullGrainSize,
+                               [this](std::size_t first, std::size_t last) {
+                                   for (auto i = first; i < last; ++i)
+                                       boundingBoxes[i] = visibleActors[i]->getBoundingBox();
+                               });
+
         for (const auto camera : cameras)
         {
-            std::vector<Actor*> drawQueue;
+            // calculate the lazily updated view projection before it is accessed from the worker threads
+            static_cast<void>(camera->getViewProjection());
+
+            workerPool.parallelFor(0, visibleActors.size(), cullGrainSize,
+                                   [this, camera](std::size_t first, std::size_t last) {
+                                       for (auto i = first; i < last; ++i)
+                                       {
+                                           const auto actor = visibleActors[i];
+                                           const auto& boundingBox = boundingBoxes[i];
 
-            for (const auto actor : children)
-                actor->visit(drawQueue, math::identityMatrix<float, 4>, false, camera, 0, false);
+                                           actorVisibilities[i] = actor->cullDisabled ||
+                                               (!isEmpty(boundingBox) && camera->checkVisibility(actor->transform, boundingBox));
+                                       }
+                                   });
 
             engine->getGraphics().setRenderTarget(camera->getRenderTarget() ? camera->getRenderTarget()->getResource() : 0);
             engine->getGraphics().setViewport(camera->getRenderViewport());
             engine->getGraphics().setDepthStencilState(camera->getDepthStencilState() ? camera->getDepthStencilState()->getResource() : 0,
                                                         camera->getStencilReferenceValue());
 
-            for (const auto actor : drawQueue)
-                actor->draw(camera, camera->getWireframe());
+            for (std::size_t i = 0; i < visibleActors.size(); ++i)
+                if (actorVisibilities[i])
+                    visibleActors[i]->draw(camera, camera->getWireframe());
         }
     }
 
@@ -3,6 +3,7 @@
 #ifndef OUZEL_SCENE_LAYER_HPP
 #define OUZEL_SCENE_LAYER_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include "Actor.hpp"
@@ -57,6 +58,15 @@ namespace ouzel::scene
         std::vector<Light*> lights;
 
         Order order = 0;
+
+    private:
+        // number of actors culled by a single worker pool task
+        static constexpr std::size_t cullGrainSize = 256;
+
+        // per-frame scratch buffers, kept between frames to avoid reallocations
+        std::vector<Actor*> visibleActors;
+        std::vector<math::Box<float, 3>> boundingBoxes;
+        std::vector<std::uint8_t> actorVisibilities;
     };
 }
 
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <new>
 #include <stdexcept>
 #include "ParticleSystem.hpp"
 #include "SceneManager.hpp"
@@ -19,17 +20,21 @@ namespace ouzel::scene
     namespace
     {
         constexpr float updateStep = 1.0F / 60.0F;
+
+        // large systems are split across the worker pool
+        constexpr std::size_t parallelGrainSize = 1024;
+        static_assert(parallelGrainSize % Particles::laneCount == 0);
     }
 
     ParticleSystem::ParticleSystem():
         shader{engine->getCache().getShader(shaderTexture)},
-        blendState{engine->getCache().getBlendState(blendAlpha)}
+        blendState{engine->getCache().getBlendState(blendAlpha)},
+        randomEngine{core::randomEngine()}
     {
         whitePixelTexture = engine->getCache().getTexture(textureWhitePixel);
 
-        updateHandler.updateHandler = [this](const UpdateEvent& event) {
-            update(event.delta);
-            return false;
+        updater.function = [this](float delta) {
+            update(delta);
         };
     }
 
@@ -126,79 +131,37 @@ namespace ouzel::scene
             else if (active && !particleCount)
             {
                 active = false;
-                updateHandler.remove();
 
-                auto finishEvent = std::make_unique<AnimationEvent>();
-                finishEvent->type = Event::Type::animationFinish;
-                finishEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                engine->getUpdateScheduler().runSerially([this]() {
+                    updater.remove();
+
+                    AnimationEvent finishEvent;
+                    finishEvent.type = Event::Type::animationFinish;
+                    finishEvent.component = this;
+                    engine->getEventDispatcher().dispatchEvent(finishEvent);
+                });
 
                 return;
             }
 
             if (active)
             {
+                engine->getWorkerPool().parallelFor(0, particleCount, parallelGrainSize,
+                                                    [this](std::size_t first, std::size_t last) {
+                                                        particles.simulate(first, last, updateStep,
+                                                                           particleSystemData.emitterType == ParticleSystemData::EmitterType::gravity,
+                                                                           particleSystemData.gravity,
+                                                                           particleSystemData.yCoordFlipped);
+                                                    });
+
+                // replace the dead particles with the last ones
                 for (std::size_t counter = particleCount; counter > 0; --counter)
                 {
                     const std::size_t i = counter - 1;
-                    auto& particle = particles[i];
 
-                    particle.life -= updateStep;
-
-                    if (particle.life >= 0.0F)
+                    if (!(particles.life[i] >= 0.0F))
                     {
-                        if (particleSystemData.emitterType == ParticleSystemData::EmitterType::gravity)
-                        {
-                            math::Vector<float, 2> radial{};
-
-                            // radial acceleration
-                            if (particle.position.v[0] == 0.0F || particle.position.v[1] == 0.0F)
-                                radial = normalized(particle.position);
-
-                            math::Vector<float, 2> tangential = radial * particle.radialAcceleration;
-
-                            // tangential acceleration
-                            std::swap(tangential.v[0], tangential.v[1]);
-                            tangential.v[0] *= -particle.tangentialAcceleration;
-                            tangential.v[1] *= particle.tangentialAcceleration;
-
-                            // (gravity + radial + tangential) * updateStep
-                            const math::Vector<float, 2> directionChange{
-                                (radial.v[0] + tangential.v[0] + particleSystemData.gravity.v[0]) * updateStep,
-                                (radial.v[1] + tangential.v[1] + particleSystemData.gravity.v[1]) * updateStep
-                            };
-                            particle.direction += directionChange;
-
-                            const math::Vector<float, 2> positionChange{
-                                particle.direction.v[0] * updateStep * (particleSystemData.yCoordFlipped ? 1.0F : -1.0F),
-                                particle.direction.v[1] * updateStep * (particleSystemData.yCoordFlipped ? 1.0F : -1.0F)
-                            };
-                            particle.position += positionChange;
-                        }
-                        else
-                        {
-                            particle.angle += particle.degreesPerSecond * updateStep;
-                            particle.radius += particle.deltaRadius * updateStep;
-                            particle.position.v[0] = -std::cos(particle.angle) * particle.radius;
-                            particle.position.v[1] = -std::sin(particle.angle) * particle.radius * (particleSystemData.yCoordFlipped ? 1.0F : -1.0F);
-                        }
-
-                        // color r,g,b,a
-                        particle.colorRed += particle.deltaColorRed * updateStep;
-                        particle.colorGreen += particle.deltaColorGreen * updateStep;
-                        particle.colorBlue += particle.deltaColorBlue * updateStep;
-                        particle.colorAlpha += particle.deltaColorAlpha * updateStep;
-
-                        // size
-                        particle.size += (particle.deltaSize * updateStep);
-                        particle.size = std::max(0.0F, particle.size);
-
-                        // angle
-                        particle.rotation += particle.deltaRotation * updateStep;
-                    }
-                    else
-                    {
-                        particle = particles[particleCount - 1];
+                        particles.move(particleCount - 1, i);
                         --particleCount;
                     }
                 }
@@ -222,7 +185,7 @@ namespace ouzel::scene
 
                     for (std::size_t i = 0; i < particleCount; ++i)
                     {
-                        auto position = math::Vector<float, 3>{particles[i].position};
+                        auto position = math::Vector<float, 3>{particles.positionX[i], particles.positionY[i], 0.0F};
                         transformPoint(inverseTransform, position);
                         insertPoint(boundingBox, position);
                     }
@@ -230,7 +193,7 @@ namespace ouzel::scene
             }
             else if (particleSystemData.positionType == ParticleSystemData::PositionType::grouped)
                 for (std::size_t i = 0; i < particleCount; ++i)
-                    insertPoint(boundingBox, math::Vector<float, 3>{particles[i].position});
+                    insertPoint(boundingBox, math::Vector<float, 3>{particles.positionX[i], particles.positionY[i], 0.0F});
         }
     }
 
@@ -257,15 +220,15 @@ namespace ouzel::scene
             if (!active)
             {
                 active = true;
-                engine->getEventDispatcher().addEventHandler(updateHandler);
+                engine->getUpdateScheduler().addUpdater(updater);
             }
 
             if (particleCount == 0)
             {
-                auto startEvent = std::make_unique<AnimationEvent>();
-                startEvent->type = Event::Type::animationStart;
-                startEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(startEvent));
+                AnimationEvent startEvent;
+                startEvent.type = Event::Type::animationStart;
+                startEvent.component = this;
+                engine->getEventDispatcher().dispatchEvent(startEvent);
             }
         }
     }
@@ -287,7 +250,6 @@ namespace ouzel::scene
     void ParticleSystem::createParticleMesh()
     {
         indices.reserve(particleSystemData.maxParticles * 6);
-        vertices.reserve(particleSystemData.maxParticles * 4);
 
         for (std::uint16_t i = 0; i < particleSystemData.maxParticles; ++i)
         {
@@ -297,15 +259,6 @@ namespace ouzel::scene
             indices.push_back(i * 4 + 1);
             indices.push_back(i * 4 + 3);
             indices.push_back(i * 4 + 2);
-
-            vertices.emplace_back(math::Vector<float, 3>{-1.0F, -1.0F, 0.0F}, math::whiteColor,
-                                  math::Vector<float, 2>{0.0F, 1.0F}, math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-            vertices.emplace_back(math::Vector<float, 3>{1.0F, -1.0F, 0.0F}, math::whiteColor,
-                                  math::Vector<float, 2>{1.0F, 1.0F}, math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-            vertices.emplace_back(math::Vector<float, 3>{-1.0F, 1.0F, 0.0F}, math::whiteColor,
-                                  math::Vector<float, 2>{0.0F, 0.0F}, math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-            vertices.emplace_back(math::Vector<float, 3>{1.0F, 1.0F, 0.0F}, math::whiteColor,
-                                  math::Vector<float, 2>{1.0F, 0.0F}, math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
         }
 
         indexBuffer = std::make_unique<graphics::Buffer>(engine->getGraphics(),
@@ -317,8 +270,7 @@ namespace ouzel::scene
         vertexBuffer = std::make_unique<graphics::Buffer>(engine->getGraphics(),
                                                           graphics::BufferType::vertex,
                                                           graphics::Flags::dynamic,
-                                                          vertices.data(),
-                                                          static_cast<std::uint32_t>(getVectorSize(vertices)));
+                                                          static_cast<std::uint32_t>(particleSystemData.maxParticles * 4 * sizeof(graphics::Vertex)));
 
         particles.resize(particleSystemData.maxParticles);
     }
@@ -327,53 +279,22 @@ namespace ouzel::scene
     {
         if (actor)
         {
-            for (std::size_t counter = particleCount; counter > 0; --counter)
-            {
-                const std::size_t i = counter - 1;
-                const auto& particle = particles[i];
-
-                const math::Vector<float, 2> position = (particleSystemData.positionType == ParticleSystemData::PositionType::free) ?
-                    particle.position :
-                    (particleSystemData.positionType == ParticleSystemData::PositionType::parent) ?
-                    math::Vector<float, 2>{actor->getPosition()} + particle.position :
-                    (particleSystemData.positionType == ParticleSystemData::PositionType::grouped) ?
-                    math::Vector<float, 2>{} :
-                    throw std::runtime_error{"Invalid position type"};
-
-                const float halfSize = particle.size / 2.0F;
-                const math::Vector<float, 2> v1{-halfSize, -halfSize};
-                const math::Vector<float, 2> v2{halfSize, halfSize};
-
-                const float r = -math::degToRad(particle.rotation);
-                const float cr = std::cos(r);
-                const float sr = std::sin(r);
-
-                const math::Vector<float, 2> a{v1.v[0] * cr - v1.v[1] * sr, v1.v[0] * sr + v1.v[1] * cr};
-                const math::Vector<float, 2> b{v2.v[0] * cr - v1.v[1] * sr, v2.v[0] * sr + v1.v[1] * cr};
-                const math::Vector<float, 2> c{v2.v[0] * cr - v2.v[1] * sr, v2.v[0] * sr + v2.v[1] * cr};
-                const math::Vector<float, 2> d{v1.v[0] * cr - v2.v[1] * sr, v1.v[0] * sr + v2.v[1] * cr};
-
-                const math::Color color{
-                    particle.colorRed,
-                    particle.colorGreen,
-                    particle.colorBlue,
-                    particle.colorAlpha
-                };
-
-                vertices[i * 4 + 0].position = math::Vector<float, 3>{a + position};
-                vertices[i * 4 + 0].color = color;
-
-                vertices[i * 4 + 1].position = math::Vector<float, 3>{b + position};
-                vertices[i * 4 + 1].color = color;
-
-                vertices[i * 4 + 2].position = math::Vector<float, 3>{d + position};
-                vertices[i * 4 + 2].color = color;
-
-                vertices[i * 4 + 3].position = math::Vector<float, 3>{c + position};
-                vertices[i * 4 + 3].color = color;
-            }
+            const auto offset = (particleSystemData.positionType == ParticleSystemData::PositionType::parent) ?
+                math::Vector<float, 2>{actor->getPosition()} : math::Vector<float, 2>{};
+
+            const float positionFactor = (particleSystemData.positionType == ParticleSystemData::PositionType::free ||
+                                          particleSystemData.positionType == ParticleSystemData::PositionType::parent) ? 1.0F :
+                (particleSystemData.positionType == ParticleSystemData::PositionType::grouped) ? 0.0F :
+                throw std::runtime_error{"Invalid position type"};
 
-            vertexBuffer->setData(vertices.data(), static_cast<std::uint32_t>(getVectorSize(vertices)));
+            // the vertices are generated straight into the command buffer
+            const auto data = vertexBuffer->reserveData(static_cast<std::uint32_t>(particleCount * 4 * sizeof(graphics::Vertex)));
+            const auto vertices = reinterpret_cast<graphics::Vertex*>(data.data());
+
+            engine->getWorkerPool().parallelFor(0, particleCount, parallelGrainSize,
+                                                [this, vertices, &offset, positionFactor](std::size_t first, std::size_t last) {
+                                                    particles.generateVertices(first, last, vertices, offset, positionFactor);
+                                                });
         }
     }
 
@@ -394,75 +315,80 @@ namespace ouzel::scene
 
             for (std::size_t i = particleCount; i < particleCount + remainingCount; ++i)
             {
-                auto& particle = particles[i];
-
                 if (particleSystemData.emitterType == ParticleSystemData::EmitterType::gravity)
                 {
-                    particle.life = std::max(particleSystemData.particleLifespan + particleSystemData.particleLifespanVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine), 0.0F);
+                    particles.life[i] = std::max(particleSystemData.particleLifespan + particleSystemData.particleLifespanVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
 
-                    particle.position = particleSystemData.sourcePosition + position + math::Vector<float, 2>{
-                        particleSystemData.sourcePositionVariance.v[0] * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine),
-                        particleSystemData.sourcePositionVariance.v[1] * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine)
+                    const auto particlePosition = particleSystemData.sourcePosition + position + math::Vector<float, 2>{
+                        particleSystemData.sourcePositionVariance.v[0] * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine),
+                        particleSystemData.sourcePositionVariance.v[1] * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine)
                     };
+                    particles.positionX[i] = particlePosition.v[0];
+                    particles.positionY[i] = particlePosition.v[1];
 
-                    particle.size = std::max(particleSystemData.startParticleSize + particleSystemData.startParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine), 0.0F);
+                    particles.size[i] = std::max(particleSystemData.startParticleSize + particleSystemData.startParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
 
-                    const float finishSize = std::max(particleSystemData.finishParticleSize + particleSystemData.finishParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine), 0.0F);
-                    particle.deltaSize = (finishSize - particle.size) / particle.life;
+                    const float finishSize = std::max(particleSystemData.finishParticleSize + particleSystemData.finishParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
+                    particles.deltaSize[i] = (finishSize - particles.size[i]) / particles.life[i];
 
-                    particle.colorRed = std::clamp(particleSystemData.startColorRed + particleSystemData.startColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine), 0.0F, 1.0F);
-                    particle.colorGreen = std::clamp(particleSystemData.startColorGreen + particleSystemData.startColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine), 0.0F, 1.0F);
-                    particle.colorBlue = std::clamp(particleSystemData.startColorBlue + particleSystemData.startColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine), 0.0F, 1.0F);
-                    particle.colorAlpha = std::clamp(particleSystemData.startColorAlpha + particleSystemData.startColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine), 0.0F, 1.0F);
+                    particles.colorRed[i] = std::clamp(particleSystemData.startColorRed + particleSystemData.startColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                    particles.colorGreen[i] = std::clamp(particleSystemData.startColorGreen + particleSystemData.startColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                    particles.colorBlue[i] = std::clamp(particleSystemData.startColorBlue + particleSystemData.startColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                    particles.colorAlpha[i] = std::clamp(particleSystemData.startColorAlpha + particleSystemData.startColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
 
-                    const float finishColorRed = std::clamp(particleSystemData.finishColorRed + particleSystemData.finishColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine), 0.0F, 1.0F);
-                    const float finishColorGreen = std::clamp(particleSystemData.finishColorGreen + particleSystemData.finishColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine), 0.0F, 1.0F);
-                    const float finishColorBlue = std::clamp(particleSystemData.finishColorBlue + particleSystemData.finishColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine), 0.0F, 1.0F);
-                    const float finishColorAlpha = std::clamp(particleSystemData.finishColorAlpha + particleSystemData.finishColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine), 0.0F, 1.0F);
+                    const float finishColorRed = std::clamp(particleSystemData.finishColorRed + particleSystemData.finishColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                    const float finishColorGreen = std::clamp(particleSystemData.finishColorGreen + particleSystemData.finishColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                    const float finishColorBlue = std::clamp(particleSystemData.finishColorBlue + particleSystemData.finishColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                    const float finishColorAlpha = std::clamp(particleSystemData.finishColorAlpha + particleSystemData.finishColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
 
-                    particle.deltaColorRed = (finishColorRed - particle.colorRed) / particle.life;
-                    particle.deltaColorGreen = (finishColorGreen - particle.colorGreen) / particle.life;
-                    particle.deltaColorBlue = (finishColorBlue - particle.colorBlue) / particle.life;
-                    particle.deltaColorAlpha = (finishColorAlpha - particle.colorAlpha) / particle.life;
+                    particles.deltaColorRed[i] = (finishColorRed - particles.colorRed[i]) / particles.life[i];
+                    particles.deltaColorGreen[i] = (finishColorGreen - particles.colorGreen[i]) / particles.life[i];
+                    particles.deltaColorBlue[i] = (finishColorBlue - particles.colorBlue[i]) / particles.life[i];
+                    particles.deltaColorAlpha[i] = (finishColorAlpha - particles.colorAlpha[i]) / particles.life[i];
 
-                    particle.rotation = particleSystemData.startRotation + particleSystemData.startRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine);
+                    particles.rotation[i] = particleSystemData.startRotation + particleSystemData.startRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
 
-                    const float finishRotation = particleSystemData.finishRotation + particleSystemData.finishRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine);
-                    particle.deltaRotation = (finishRotation - particle.rotation) / particle.life;
+                    const float finishRotation = particleSystemData.finishRotation + particleSystemData.finishRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                    particles.deltaRotation[i] = (finishRotation - particles.rotation[i]) / particles.life[i];
 
-                    particle.radialAcceleration = particleSystemData.radialAcceleration + particleSystemData.radialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine);
-                    particle.tangentialAcceleration = particleSystemData.tangentialAcceleration + particleSystemData.tangentialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine);
+                    particles.radialAcceleration[i] = particleSystemData.radialAcceleration + particleSystemData.radialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                    particles.tangentialAcceleration[i] = particleSystemData.tangentialAcceleration + particleSystemData.tangentialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
 
                     if (particleSystemData.rotationIsDir)
                     {
-                        const float a = math::degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine));
+                        const float a = math::degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
                         const math::Vector<float, 2> v{std::cos(a), std::sin(a)};
-                        const float s = particleSystemData.speed + particleSystemData.speedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine);
+                        const float s = particleSystemData.speed + particleSystemData.speedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
                         const auto dir = v * s;
-                        particle.direction = dir;
-                        particle.rotation = -math::radToDeg(getAngle(dir));
+                        particles.directionX[i] = dir.v[0];
+                        particles.directionY[i] = dir.v[1];
+                        particles.rotation[i] = -math::radToDeg(getAngle(dir));
                     }
                     else
                     {
-                        const float a = math::degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine));
+                        const float a = math::degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
                         const math::Vector<float, 2> v{std::cos(a), std::sin(a)};
-                        const float s = particleSystemData.speed + particleSystemData.speedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine);
+                        const float s = particleSystemData.speed + particleSystemData.speedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
                         const auto dir = v * s;
-                        particle.direction = dir;
+                        particles.directionX[i] = dir.v[0];
+                        particles.directionY[i] = dir.v[1];
                     }
                 }
                 else
                 {
-                    particle.radius = particleSystemData.maxRadius + particleSystemData.maxRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine);
-                    particle.angle = math::degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine));
-                    particle.degreesPerSecond = math::degToRad(particleSystemData.rotatePerSecond + particleSystemData.rotatePerSecondVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine));
+                    particles.radius[i] = particleSystemData.maxRadius + particleSystemData.maxRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                    particles.angle[i] = math::degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
+                    particles.degreesPerSecond[i] = math::degToRad(particleSystemData.rotatePerSecond + particleSystemData.rotatePerSecondVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
 
-                    const float endRadius = particleSystemData.minRadius + particleSystemData.minRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(core::randomEngine);
-                    particle.deltaRadius = (endRadius - particle.radius) / particle.life;
+                    const float endRadius = particleSystemData.minRadius + particleSystemData.minRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                    particles.deltaRadius[i] = (endRadius - particles.radius[i]) / particles.life[i];
                 }
             }
 
             particleCount += remainingCount;
+
+            // only the vertices of the live particles are uploaded
+            needsMeshUpdate = true;
         }
     }
 }
@@ -3,11 +3,13 @@
 #ifndef OUZEL_SCENE_PARTICLESYSTEM_HPP
 #define OUZEL_SCENE_PARTICLESYSTEM_HPP
 
+#include <random>
 #include <string>
 #include <vector>
 #include <functional>
 #include "Component.hpp"
-#include "../events/EventHandler.hpp"
+#include "Particles.hpp"
+#include "../core/UpdateScheduler.hpp"
 #include "../graphics/Vertex.hpp"
 #include "../graphics/BlendState.hpp"
 #include "../graphics/Buffer.hpp"
@@ -133,6 +135,10 @@ namespace ouzel::scene
         auto isRunning() const noexcept { return running; }
         auto isActive() const noexcept { return active; }
 
+        // particle systems whose actors are not shared with other updaters can be updated in parallel
+        auto isThreadSafe() const noexcept { return updater.isThreadSafe(); }
+        void setThreadSafe(bool newThreadSafe) { updater.setThreadSafe(newThreadSafe); }
+
         auto getPositionType() const noexcept
         {
             return particleSystemData.positionType;
@@ -158,47 +164,12 @@ namespace ouzel::scene
         std::shared_ptr<graphics::Texture> texture;
         std::shared_ptr<graphics::Texture> whitePixelTexture;
 
-        struct Particle final
-        {
-            float life = 0.0F;
-
-            math::Vector<float, 2> position{};
-
-            float colorRed = 0.0F;
-            float colorGreen = 0.0F;
-            float colorBlue = 0.0F;
-            float colorAlpha = 0.0F;
-
-            float deltaColorRed = 0.0F;
-            float deltaColorGreen = 0.0F;
-            float deltaColorBlue = 0.0F;
-            float deltaColorAlpha = 0.0F;
-
-            float angle = 0.0F;
-            float speed = 0.0F;
-
-            float size = 0.0F;
-            float deltaSize = 0.0F;
-
-            float rotation = 0.0F;
-            float deltaRotation = 0.0F;
-
-            float radialAcceleration = 0.0F;
-            float tangentialAcceleration = 0.0F;
-
-            math::Vector<float, 2> direction{};
-            float radius = 0.0F;
-            float degreesPerSecond = 0.0F;
-            float deltaRadius = 0.0F;
-        };
-
-        std::vector<Particle> particles;
+        Particles particles;
 
         std::unique_ptr<graphics::Buffer> indexBuffer;
         std::unique_ptr<graphics::Buffer> vertexBuffer;
 
         std::vector<std::uint16_t> indices;
-        std::vector<graphics::Vertex> vertices;
 
         std::size_t particleCount = 0;
 
@@ -211,7 +182,9 @@ namespace ouzel::scene
 
         bool needsMeshUpdate = false;
 
-        EventHandler updateHandler;
+        std::mt19937 randomEngine; // own engine, so that particle systems can be updated in parallel
+
+        core::Updater updater{core::UpdatePhase::animation};
     };
 }
 
@@ -0,0 +1,310 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <cmath>
+#include <new>
+#include "Particles.hpp"
+#include "../math/Scalar.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+#  include <xmmintrin.h>
+#elif defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#endif
+
+namespace ouzel::scene
+{
+    namespace
+    {
+        constexpr std::size_t laneCount = Particles::laneCount;
+
+#if defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+        // vector types are wrapped, because operators can't be overloaded for them
+        struct Lanes final
+        {
+            __m128 v;
+        };
+
+        struct Mask final
+        {
+            __m128 v;
+        };
+
+        inline Lanes load(const float* values) noexcept { return Lanes{_mm_loadu_ps(values)}; }
+        inline void store(float* values, Lanes lanes) noexcept { _mm_storeu_ps(values, lanes.v); }
+        inline Lanes broadcast(float value) noexcept { return Lanes{_mm_set1_ps(value)}; }
+
+        inline Lanes operator+(Lanes a, Lanes b) noexcept { return Lanes{_mm_add_ps(a.v, b.v)}; }
+        inline Lanes operator-(Lanes a, Lanes b) noexcept { return Lanes{_mm_sub_ps(a.v, b.v)}; }
+        inline Lanes operator*(Lanes a, Lanes b) noexcept { return Lanes{_mm_mul_ps(a.v, b.v)}; }
+        inline Lanes max(Lanes a, Lanes b) noexcept { return Lanes{_mm_max_ps(a.v, b.v)}; }
+        inline Lanes min(Lanes a, Lanes b) noexcept { return Lanes{_mm_min_ps(a.v, b.v)}; }
+        inline Lanes reciprocalSqrt(Lanes a) noexcept { return Lanes{_mm_div_ps(_mm_set1_ps(1.0F), _mm_sqrt_ps(a.v))}; }
+
+        inline Mask isZero(Lanes a) noexcept { return Mask{_mm_cmpeq_ps(a.v, _mm_setzero_ps())}; }
+        inline Mask isPositive(Lanes a) noexcept { return Mask{_mm_cmpgt_ps(a.v, _mm_setzero_ps())}; }
+        inline Mask maskOr(Mask a, Mask b) noexcept { return Mask{_mm_or_ps(a.v, b.v)}; }
+        inline Mask maskAnd(Mask a, Mask b) noexcept { return Mask{_mm_and_ps(a.v, b.v)}; }
+        inline Lanes selectOrZero(Mask mask, Lanes a) noexcept { return Lanes{_mm_and_ps(mask.v, a.v)}; }
+#elif defined(__ARM_NEON__)
+        // vector types are wrapped, because operators can't be overloaded for them
+        struct Lanes final
+        {
+            float32x4_t v;
+        };
+
+        struct Mask final
+        {
+            uint32x4_t v;
+        };
+
+        inline Lanes load(const float* values) noexcept { return Lanes{vld1q_f32(values)}; }
+        inline void store(float* values, Lanes lanes) noexcept { vst1q_f32(values, lanes.v); }
+        inline Lanes broadcast(float value) noexcept { return Lanes{vdupq_n_f32(value)}; }
+
+        inline Lanes operator+(Lanes a, Lanes b) noexcept { return Lanes{vaddq_f32(a.v, b.v)}; }
+        inline Lanes operator-(Lanes a, Lanes b) noexcept { return Lanes{vsubq_f32(a.v, b.v)}; }
+        inline Lanes operator*(Lanes a, Lanes b) noexcept { return Lanes{vmulq_f32(a.v, b.v)}; }
+        inline Lanes max(Lanes a, Lanes b) noexcept { return Lanes{vmaxq_f32(a.v, b.v)}; }
+        inline Lanes min(Lanes a, Lanes b) noexcept { return Lanes{vminq_f32(a.v, b.v)}; }
+        inline Lanes reciprocalSqrt(Lanes a) noexcept
+        {
+            // estimate refined with two Newton-Raphson steps
+            auto result = vrsqrteq_f32(a.v);
+            result = vmulq_f32(result, vrsqrtsq_f32(vmulq_f32(a.v, result), result));
+            return Lanes{vmulq_f32(result, vrsqrtsq_f32(vmulq_f32(a.v, result), result))};
+        }
+
+        inline Mask isZero(Lanes a) noexcept { return Mask{vceqq_f32(a.v, vdupq_n_f32(0.0F))}; }
+        inline Mask isPositive(Lanes a) noexcept { return Mask{vcgtq_f32(a.v, vdupq_n_f32(0.0F))}; }
+        inline Mask maskOr(Mask a, Mask b) noexcept { return Mask{vorrq_u32(a.v, b.v)}; }
+        inline Mask maskAnd(Mask a, Mask b) noexcept { return Mask{vandq_u32(a.v, b.v)}; }
+        inline Lanes selectOrZero(Mask mask, Lanes a) noexcept
+        {
+            return Lanes{vreinterpretq_f32_u32(vandq_u32(mask.v, vreinterpretq_u32_f32(a.v)))};
+        }
+#else
+        struct Lanes final
+        {
+            float v[laneCount];
+        };
+
+        struct Mask final
+        {
+            bool v[laneCount];
+        };
+
+        template <class Result, class Operand, class F>
+        inline Result perLane(const Operand& a, const Operand& b, F function) noexcept
+        {
+            Result result;
+            for (std::size_t i = 0; i < laneCount; ++i) result.v[i] = function(a.v[i], b.v[i]);
+            return result;
+        }
+
+        inline Lanes load(const float* values) noexcept { Lanes result; std::copy(values, values + laneCount, result.v); return result; }
+        inline void store(float* values, Lanes lanes) noexcept { std::copy(lanes.v, lanes.v + laneCount, values); }
+        inline Lanes broadcast(float value) noexcept { return Lanes{{value, value, value, value}}; }
+
+        inline Lanes operator+(Lanes a, Lanes b) noexcept { return perLane<Lanes>(a, b, [](float x, float y) noexcept { return x + y; }); }
+        inline Lanes operator-(Lanes a, Lanes b) noexcept { return perLane<Lanes>(a, b, [](float x, float y) noexcept { return x - y; }); }
+        inline Lanes operator*(Lanes a, Lanes b) noexcept { return perLane<Lanes>(a, b, [](float x, float y) noexcept { return x * y; }); }
+        inline Lanes max(Lanes a, Lanes b) noexcept { return perLane<Lanes>(a, b, [](float x, float y) noexcept { return std::max(x, y); }); }
+        inline Lanes min(Lanes a, Lanes b) noexcept { return perLane<Lanes>(a, b, [](float x, float y) noexcept { return std::min(x, y); }); }
+        inline Lanes reciprocalSqrt(Lanes a) noexcept { return perLane<Lanes>(a, a, [](float x, float) noexcept { return 1.0F / std::sqrt(x); }); }
+
+        inline Mask isZero(Lanes a) noexcept { return perLane<Mask>(a, a, [](float x, float) noexcept { return x == 0.0F; }); }
+        inline Mask isPositive(Lanes a) noexcept { return perLane<Mask>(a, a, [](float x, float) noexcept { return x > 0.0F; }); }
+        inline Mask maskOr(Mask a, Mask b) noexcept { return perLane<Mask>(a, b, [](bool x, bool y) noexcept { return x || y; }); }
+        inline Mask maskAnd(Mask a, Mask b) noexcept { return perLane<Mask>(a, b, [](bool x, bool y) noexcept { return x && y; }); }
+        inline Lanes selectOrZero(Mask mask, Lanes a) noexcept
+        {
+            Lanes result;
+            for (std::size_t i = 0; i < laneCount; ++i) result.v[i] = mask.v[i] ? a.v[i] : 0.0F;
+            return result;
+        }
+#endif
+
+        // value += delta * step
+        inline void integrate(float* values, const float* deltas, Lanes step) noexcept
+        {
+            store(values, load(values) + load(deltas) * step);
+        }
+    }
+
+    void Particles::resize(std::size_t newSize)
+    {
+        const auto paddedSize = (newSize + laneCount - 1) / laneCount * laneCount;
+
+        for (auto attribute : {
+            &life, &positionX, &positionY,
+            &colorRed, &colorGreen, &colorBlue, &colorAlpha,
+            &deltaColorRed, &deltaColorGreen, &deltaColorBlue, &deltaColorAlpha,
+            &size, &deltaSize, &rotation, &deltaRotation,
+            &directionX, &directionY, &radialAcceleration, &tangentialAcceleration,
+            &angle, &radius, &degreesPerSecond, &deltaRadius
+        })
+            attribute->assign(paddedSize, 0.0F);
+    }
+
+    void Particles::move(std::size_t from, std::size_t to) noexcept
+    {
+        for (auto attribute : {
+            &life, &positionX, &positionY,
+            &colorRed, &colorGreen, &colorBlue, &colorAlpha,
+            &deltaColorRed, &deltaColorGreen, &deltaColorBlue, &deltaColorAlpha,
+            &size, &deltaSize, &rotation, &deltaRotation,
+            &directionX, &directionY, &radialAcceleration, &tangentialAcceleration,
+            &angle, &radius, &degreesPerSecond, &deltaRadius
+        })
+            (*attribute)[to] = (*attribute)[from];
+    }
+
+    void Particles::simulate(std::size_t first, std::size_t last,
+                             const float step,
+                             const bool gravityEmitter,
+                             const math::Vector<float, 2>& gravity,
+                             const bool yCoordFlipped) noexcept
+    {
+        // the arrays are padded, so the last group can be processed as a whole
+        last = (last + laneCount - 1) / laneCount * laneCount;
+
+        const auto stepLanes = broadcast(step);
+        const auto zero = broadcast(0.0F);
+        const auto positionStep = broadcast(step * (yCoordFlipped ? 1.0F : -1.0F));
+
+        for (auto i = first; i < last; i += laneCount)
+        {
+            store(&life[i], load(&life[i]) - stepLanes);
+
+            if (gravityEmitter)
+            {
+                const auto x = load(&positionX[i]);
+                const auto y = load(&positionY[i]);
+
+                // radial acceleration
+                const auto lengthSquared = x * x + y * y;
+                const auto radialMask = maskAnd(maskOr(isZero(x), isZero(y)), isPositive(lengthSquared));
+                const auto inverseLength = selectOrZero(radialMask, reciprocalSqrt(lengthSquared));
+                const auto radialX = x * inverseLength;
+                const auto radialY = y * inverseLength;
+
+                // tangential acceleration
+                const auto radialAccelerations = load(&radialAcceleration[i]);
+                const auto tangentialAccelerations = load(&tangentialAcceleration[i]);
+                const auto tangentialX = zero - radialY * radialAccelerations * tangentialAccelerations;
+                const auto tangentialY = radialX * radialAccelerations * tangentialAccelerations;
+
+                // (gravity + radial + tangential) * step
+                const auto newDirectionX = load(&directionX[i]) +
+                    (radialX + tangentialX + broadcast(gravity.v[0])) * stepLanes;
+                const auto newDirectionY = load(&directionY[i]) +
+                    (radialY + tangentialY + broadcast(gravity.v[1])) * stepLanes;
+                store(&directionX[i], newDirectionX);
+                store(&directionY[i], newDirectionY);
+
+                store(&positionX[i], x + newDirectionX * positionStep);
+                store(&positionY[i], y + newDirectionY * positionStep);
+            }
+            else
+            {
+                integrate(&angle[i], &degreesPerSecond[i], stepLanes);
+                integrate(&radius[i], &deltaRadius[i], stepLanes);
+
+                const float yFactor = yCoordFlipped ? 1.0F : -1.0F;
+                for (auto j = i; j < i + laneCount; ++j)
+                {
+                    positionX[j] = -std::cos(angle[j]) * radius[j];
+                    positionY[j] = -std::sin(angle[j]) * radius[j] * yFactor;
+                }
+            }
+
+            // color r,g,b,a
+            integrate(&colorRed[i], &deltaColorRed[i], stepLanes);
+            integrate(&colorGreen[i], &deltaColorGreen[i], stepLanes);
+            integrate(&colorBlue[i], &deltaColorBlue[i], stepLanes);
+            integrate(&colorAlpha[i], &deltaColorAlpha[i], stepLanes);
+
+            // size
+            store(&size[i], max(zero, load(&size[i]) + load(&deltaSize[i]) * stepLanes));
+
+            // angle
+            integrate(&rotation[i], &deltaRotation[i], stepLanes);
+        }
+    }
+
+    void Particles::generateVertices(std::size_t first, std::size_t last,
+                                     graphics::Vertex* vertices,
+                                     const math::Vector<float, 2>& offset,
+                                     float positionFactor) const noexcept
+    {
+        const auto half = broadcast(0.5F);
+        const auto zero = broadcast(0.0F);
+        const auto one = broadcast(1.0F);
+        const auto colorScale = broadcast(255.0F);
+        const auto factor = broadcast(positionFactor);
+        const auto offsetX = broadcast(offset.v[0]);
+        const auto offsetY = broadcast(offset.v[1]);
+
+        for (auto i = first; i < last; i += laneCount)
+        {
+            float cosines[laneCount];
+            float sines[laneCount];
+            for (std::size_t j = 0; j < laneCount; ++j)
+            {
+                const float r = -math::degToRad(rotation[i + j]);
+                cosines[j] = std::cos(r);
+                sines[j] = std::sin(r);
+            }
+
+            // corners of the rotated square: a = (q - p, -q - p), b = (p + q, q - p), c = -a, d = -b
+            const auto halfSize = load(&size[i]) * half;
+            const auto p = halfSize * load(cosines);
+            const auto q = halfSize * load(sines);
+
+            float cornerAX[laneCount];
+            float cornerAY[laneCount];
+            float cornerBX[laneCount];
+            float cornerBY[laneCount];
+            store(cornerAX, q - p);
+            store(cornerAY, zero - q - p);
+            store(cornerBX, p + q);
+            store(cornerBY, q - p);
+
+            float vertexX[laneCount];
+            float vertexY[laneCount];
+            store(vertexX, offsetX + load(&positionX[i]) * factor);
+            store(vertexY, offsetY + load(&positionY[i]) * factor);
+
+            float red[laneCount];
+            float green[laneCount];
+            float blue[laneCount];
+            float alpha[laneCount];
+            store(red, min(max(load(&colorRed[i]), zero), one) * colorScale);
+            store(green, min(max(load(&colorGreen[i]), zero), one) * colorScale);
+            store(blue, min(max(load(&colorBlue[i]), zero), one) * colorScale);
+            store(alpha, min(max(load(&colorAlpha[i]), zero), one) * colorScale);
+
+            for (std::size_t j = 0; j < laneCount && i + j < last; ++j)
+            {
+                const math::Color color{
+                    static_cast<std::uint8_t>(red[j]),
+                    static_cast<std::uint8_t>(green[j]),
+                    static_cast<std::uint8_t>(blue[j]),
+                    static_cast<std::uint8_t>(alpha[j])
+                };
+
+                const auto vertex = &vertices[(i + j) * 4];
+
+                new(vertex + 0) graphics::Vertex{math::Vector<float, 3>{vertexX[j] + cornerAX[j], vertexY[j] + cornerAY[j], 0.0F}, color,
+                                                 math::Vector<float, 2>{0.0F, 1.0F}, math::Vector<float, 3>{0.0F, 0.0F, -1.0F}};
+                new(vertex + 1) graphics::Vertex{math::Vector<float, 3>{vertexX[j] + cornerBX[j], vertexY[j] + cornerBY[j], 0.0F}, color,
+                                                 math::Vector<float, 2>{1.0F, 1.0F}, math::Vector<float, 3>{0.0F, 0.0F, -1.0F}};
+                new(vertex + 2) graphics::Vertex{math::Vector<float, 3>{vertexX[j] - cornerBX[j], vertexY[j] - cornerBY[j], 0.0F}, color,
+                                                 math::Vector<float, 2>{0.0F, 0.0F}, math::Vector<float, 3>{0.0F, 0.0F, -1.0F}};
+                new(vertex + 3) graphics::Vertex{math::Vector<float, 3>{vertexX[j] - cornerAX[j], vertexY[j] - cornerAY[j], 0.0F}, color,
+                                                 math::Vector<float, 2>{1.0F, 0.0F}, math::Vector<float, 3>{0.0F, 0.0F, -1.0F}};
+            }
+        }
+    }
+}
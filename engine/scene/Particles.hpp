@@ -0,0 +1,70 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_PARTICLES_HPP
+#define OUZEL_SCENE_PARTICLES_HPP
+
+#include <cstddef>
+#include <vector>
+#include "../graphics/Vertex.hpp"
+#include "../math/Vector.hpp"
+
+namespace ouzel::scene
+{
+    // particle attributes are stored as a structure of arrays, so that they can be updated four at a time
+    struct Particles final
+    {
+        static constexpr std::size_t laneCount = 4;
+
+        // the arrays are padded to a multiple of the SIMD width
+        void resize(std::size_t newSize);
+        void move(std::size_t from, std::size_t to) noexcept;
+
+        // advances the particles in the range by one step of the gravity or of the radius emitter
+        void simulate(std::size_t first, std::size_t last,
+                      float step,
+                      bool gravityEmitter,
+                      const math::Vector<float, 2>& gravity,
+                      bool yCoordFlipped) noexcept;
+
+        // writes four vertices for every particle in the range
+        void generateVertices(std::size_t first, std::size_t last,
+                              graphics::Vertex* vertices,
+                              const math::Vector<float, 2>& offset,
+                              float positionFactor) const noexcept;
+
+        std::vector<float> life;
+
+        std::vector<float> positionX;
+        std::vector<float> positionY;
+
+        std::vector<float> colorRed;
+        std::vector<float> colorGreen;
+        std::vector<float> colorBlue;
+        std::vector<float> colorAlpha;
+
+        std::vector<float> deltaColorRed;
+        std::vector<float> deltaColorGreen;
+        std::vector<float> deltaColorBlue;
+        std::vector<float> deltaColorAlpha;
+
+        std::vector<float> size;
+        std::vector<float> deltaSize;
+
+        std::vector<float> rotation;
+        std::vector<float> deltaRotation;
+
+        // gravity emitter
+        std::vector<float> directionX;
+        std::vector<float> directionY;
+        std::vector<float> radialAcceleration;
+        std::vector<float> tangentialAcceleration;
+
+        // radius emitter
+        std::vector<float> angle;
+        std::vector<float> radius;
+        std::vector<float> degreesPerSecond;
+        std::vector<float> deltaRadius;
+    };
+}
+
+#endif // OUZEL_SCENE_PARTICLES_HPP
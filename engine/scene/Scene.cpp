@@ -270,12 +270,12 @@ namespace ouzel::scene
     {
         if (actor)
         {
-            auto event = std::make_unique<UIEvent>();
-            event->type = Event::Type::actorEnter;
-            event->actor = actor;
-            event->touchId = pointerId;
-            event->position = position;
-            engine->getEventDispatcher().dispatchEvent(std::move(event));
+            UIEvent event;
+            event.type = Event::Type::actorEnter;
+            event.actor = actor;
+            event.touchId = pointerId;
+            event.position = position;
+            engine->getEventDispatcher().dispatchEvent(event);
         }
     }
 
@@ -284,12 +284,12 @@ namespace ouzel::scene
     {
         if (actor)
         {
-            auto event = std::make_unique<UIEvent>();
-            event->type = Event::Type::actorLeave;
-            event->actor = actor;
-            event->touchId = pointerId;
-            event->position = position;
-            engine->getEventDispatcher().dispatchEvent(std::move(event));
+            UIEvent event;
+            event.type = Event::Type::actorLeave;
+            event.actor = actor;
+            event.touchId = pointerId;
+            event.position = position;
+            engine->getEventDispatcher().dispatchEvent(event);
         }
     }
 
@@ -301,13 +301,13 @@ namespace ouzel::scene
         {
             pointerDownOnActors[pointerId] = std::pair{actor, localPosition};
 
-            auto event = std::make_unique<UIEvent>();
-            event->type = Event::Type::actorPress;
-            event->actor = actor;
-            event->touchId = pointerId;
-            event->position = position;
-            event->localPosition = localPosition;
-            engine->getEventDispatcher().dispatchEvent(std::move(event));
+            UIEvent event;
+            event.type = Event::Type::actorPress;
+            event.actor = actor;
+            event.touchId = pointerId;
+            event.position = position;
+            event.localPosition = localPosition;
+            engine->getEventDispatcher().dispatchEvent(event);
         }
     }
 
@@ -320,24 +320,24 @@ namespace ouzel::scene
 
             if (pointerDownOnActor.first)
             {
-                auto releaseEvent = std::make_unique<UIEvent>();
-                releaseEvent->type = Event::Type::actorRelease;
-                releaseEvent->actor = pointerDownOnActor.first;
-                releaseEvent->touchId = pointerId;
-                releaseEvent->position = position;
-                releaseEvent->localPosition = pointerDownOnActor.second;
+                UIEvent releaseEvent;
+                releaseEvent.type = Event::Type::actorRelease;
+                releaseEvent.actor = pointerDownOnActor.first;
+                releaseEvent.touchId = pointerId;
+                releaseEvent.position = position;
+                releaseEvent.localPosition = pointerDownOnActor.second;
 
-                engine->getEventDispatcher().dispatchEvent(std::move(releaseEvent));
+                engine->getEventDispatcher().dispatchEvent(releaseEvent);
 
                 if (pointerDownOnActor.first == actor)
                 {
-                    auto clickEvent = std::make_unique<UIEvent>();
-                    clickEvent->type = Event::Type::actorClick;
-                    clickEvent->actor = actor;
-                    clickEvent->touchId = pointerId;
-                    clickEvent->position = position;
+                    UIEvent clickEvent;
+                    clickEvent.type = Event::Type::actorClick;
+                    clickEvent.actor = actor;
+                    clickEvent.touchId = pointerId;
+                    clickEvent.position = position;
 
-                    engine->getEventDispatcher().dispatchEvent(std::move(clickEvent));
+                    engine->getEventDispatcher().dispatchEvent(clickEvent);
                 }
             }
         }
@@ -352,14 +352,14 @@ namespace ouzel::scene
     {
         if (actor)
         {
-            auto event = std::make_unique<UIEvent>();
-            event->type = Event::Type::actorDrag;
-            event->actor = actor;
-            event->touchId = pointerId;
-            event->difference = difference;
-            event->position = position;
-            event->localPosition = localPosition;
-            engine->getEventDispatcher().dispatchEvent(std::move(event));
+            UIEvent event;
+            event.type = Event::Type::actorDrag;
+            event.actor = actor;
+            event.touchId = pointerId;
+            event.difference = difference;
+            event.position = position;
+            event.localPosition = localPosition;
+            engine->getEventDispatcher().dispatchEvent(event);
         }
     }
 }
@@ -537,6 +537,82 @@ namespace ouzel::scene
         }
     }
 
+    void ShapeRenderer::polyline(const std::vector<math::Vector<float, 2>>& points,
+                                 math::Color color,
+                                 float thickness)
+    {
+        assert(points.size() >= 2);
+        assert(thickness >= 0.0F);
+
+        DrawCommand command;
+        command.startIndex = static_cast<std::uint32_t>(indices.size());
+
+        const auto startVertex = static_cast<std::uint16_t>(vertices.size());
+
+        if (thickness == 0.0F)
+        {
+            command.mode = graphics::DrawMode::lineStrip;
+            command.indexCount = static_cast<std::uint32_t>(points.size());
+
+            for (std::uint16_t i = 0; i < points.size(); ++i)
+            {
+                indices.push_back(startVertex + i);
+                vertices.emplace_back(math::Vector<float, 3>{points[i]},
+                                      color,
+                                      math::Vector<float, 2>{},
+                                      math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+                insertPoint(boundingBox, math::Vector<float, 3>{points[i]});
+            }
+        }
+        else
+        {
+            command.mode = graphics::DrawMode::triangleList;
+            command.indexCount = 0;
+
+            const float halfThickness = thickness / 2.0F;
+
+            // every segment is a separate quad
+            for (std::size_t i = 1; i < points.size(); ++i)
+            {
+                const auto tangent = normalized(points[i] - points[i - 1]);
+                const math::Vector<float, 2> normal{-tangent.v[1], tangent.v[0]};
+                const auto segmentVertex = static_cast<std::uint16_t>(vertices.size());
+
+                vertices.emplace_back(math::Vector<float, 3>{points[i - 1] - normal * halfThickness},
+                                      color,
+                                      math::Vector<float, 2>{},
+                                      math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+                vertices.emplace_back(math::Vector<float, 3>{points[i] - normal * halfThickness},
+                                      color,
+                                      math::Vector<float, 2>{},
+                                      math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+                vertices.emplace_back(math::Vector<float, 3>{points[i - 1] + normal * halfThickness},
+                                      color,
+                                      math::Vector<float, 2>{},
+                                      math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+                vertices.emplace_back(math::Vector<float, 3>{points[i] + normal * halfThickness},
+                                      color,
+                                      math::Vector<float, 2>{},
+                                      math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+
+                indices.push_back(segmentVertex + 0);
+                indices.push_back(segmentVertex + 1);
+                indices.push_back(segmentVertex + 2);
+                indices.push_back(segmentVertex + 1);
+                indices.push_back(segmentVertex + 3);
+                indices.push_back(segmentVertex + 2);
+                command.indexCount += 6;
+
+                for (std::uint16_t v = 0; v < 4; ++v)
+                    insertPoint(boundingBox, vertices[segmentVertex + v].position);
+            }
+        }
+
+        drawCommands.push_back(command);
+
+        dirty = true;
+    }
+
     void ShapeRenderer::curve(const std::vector<math::Vector<float, 2>>& controlPoints,
                               math::Color color,
                               std::uint32_t segments,
@@ -47,6 +47,11 @@ namespace ouzel::scene
                      bool fill = false,
                      float thickness = 0.0F);
 
+        // an open line through the points
+        void polyline(const std::vector<math::Vector<float, 2>>& points,
+                      math::Color color,
+                      float thickness = 0.0F);
+
         void curve(const std::vector<math::Vector<float, 2>>& controlPoints,
                    math::Color color,
                    std::uint32_t segments = 16,
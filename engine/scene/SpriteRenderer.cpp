@@ -19,9 +19,9 @@ namespace ouzel::scene
                              const math::Size<float, 2>& sourceSize,
                              const math::Vector<float, 2>& sourceOffset,
                              const math::Vector<float, 2>& pivot):
-        name{frameName}
+        name{frameName},
+        indices{0, 1, 2, 1, 3, 2}
     {
-        const std::vector<std::uint16_t> indices = {0, 1, 2, 1, 3, 2};
         indexCount = static_cast<std::uint32_t>(indices.size());
 
         math::Vector<float, 2> textCoords[4];
@@ -65,7 +65,7 @@ namespace ouzel::scene
             textCoords[3] = math::Vector<float, 2>{rightBottom.v[0], rightBottom.v[1]};
         }
 
-        const std::vector<graphics::Vertex> vertices{
+        vertices = {
             graphics::Vertex{
                 math::Vector<float, 3>{finalOffset.v[0], finalOffset.v[1], 0.0F}, math::whiteColor,
                 textCoords[0], math::Vector<float, 3>{0.0F, 0.0F, -1.0F}
@@ -101,9 +101,11 @@ namespace ouzel::scene
     }
 
     SpriteData::Frame::Frame(const std::string& frameName,
-                             const std::vector<std::uint16_t>& indices,
-                             const std::vector<graphics::Vertex>& vertices):
-        name{frameName}
+                             const std::vector<std::uint16_t>& initIndices,
+                             const std::vector<graphics::Vertex>& initVertices):
+        name{frameName},
+        indices{initIndices},
+        vertices{initVertices}
     {
         indexCount = static_cast<std::uint32_t>(indices.size());
 
@@ -124,13 +126,15 @@ namespace ouzel::scene
     }
 
     SpriteData::Frame::Frame(const std::string& frameName,
-                             const std::vector<std::uint16_t>& indices,
-                             const std::vector<graphics::Vertex>& vertices,
+                             const std::vector<std::uint16_t>& initIndices,
+                             const std::vector<graphics::Vertex>& initVertices,
                              const math::Rect<float>& frameRectangle,
                              const math::Size<float, 2>& sourceSize,
                              const math::Vector<float, 2>& sourceOffset,
                              const math::Vector<float, 2>& pivot):
-        name{frameName}
+        name{frameName},
+        indices{initIndices},
+        vertices{initVertices}
     {
         indexCount = static_cast<std::uint32_t>(indices.size());
 
@@ -158,9 +162,8 @@ namespace ouzel::scene
 
     SpriteRenderer::SpriteRenderer()
     {
-        updateHandler.updateHandler = [this](const UpdateEvent& event) {
-            update(event.delta);
-            return false;
+        updater.function = [this](float delta) {
+            update(delta);
         };
 
         currentAnimation = animationQueue.end();
@@ -305,22 +308,22 @@ namespace ouzel::scene
                         {
                             currentTime = std::fmod(currentTime, length);
 
-                            auto resetEvent = std::make_unique<AnimationEvent>();
-                            resetEvent->type = Event::Type::animationReset;
-                            resetEvent->component = this;
-                            resetEvent->name = currentAnimation->animation->name;
-                            engine->getEventDispatcher().dispatchEvent(std::move(resetEvent));
+                            AnimationEvent resetEvent;
+                            resetEvent.type = Event::Type::animationReset;
+                            resetEvent.component = this;
+                            resetEvent.name = currentAnimation->animation->name;
+                            engine->getEventDispatcher().dispatchEvent(resetEvent);
                             break;
                         }
                         else
                         {
                             if (running)
                             {
-                                auto finishEvent = std::make_unique<AnimationEvent>();
-                                finishEvent->type = Event::Type::animationFinish;
-                                finishEvent->component = this;
-                                finishEvent->name = currentAnimation->animation->name;
-                                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                                AnimationEvent finishEvent;
+                                finishEvent.type = Event::Type::animationFinish;
+                                finishEvent.component = this;
+                                finishEvent.name = currentAnimation->animation->name;
+                                engine->getEventDispatcher().dispatchEvent(finishEvent);
                             }
 
                             auto nextAnimation = std::next(currentAnimation);
@@ -334,11 +337,11 @@ namespace ouzel::scene
                             {
                                 currentTime -= length;
 
-                                auto startEvent = std::make_unique<AnimationEvent>();
-                                startEvent->type = Event::Type::animationStart;
-                                startEvent->component = this;
-                                startEvent->name = nextAnimation->animation->name;
-                                engine->getEventDispatcher().dispatchEvent(std::move(startEvent));
+                                AnimationEvent startEvent;
+                                startEvent.type = Event::Type::animationStart;
+                                startEvent.component = this;
+                                startEvent.name = nextAnimation->animation->name;
+                                engine->getEventDispatcher().dispatchEvent(startEvent);
                             }
                         }
                     }
@@ -368,41 +371,31 @@ namespace ouzel::scene
             if (currentFrame >= currentAnimation->animation->frames.size())
                 currentFrame = currentAnimation->animation->frames.size() - 1;
 
-            const auto modelViewProj = renderViewProjection * transformMatrix * offsetMatrix;
-            const auto colorVector = {
+            static_assert(graphics::SpriteBatcher::textureLayers == graphics::Material::textureLayers);
+
+            graphics::SpriteBatcher::State state;
+            state.blendState = material->blendState->getResource();
+            state.shader = material->shader->getResource();
+            state.cullMode = material->cullMode;
+            state.fillMode = wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid;
+            for (std::size_t i = 0; i < graphics::Material::textureLayers; ++i)
+                state.textures[i] = material->textures[i] ? material->textures[i]->getResource() : 0;
+            state.viewProjection = renderViewProjection;
+
+            const math::Color color{
                 material->diffuseColor.normR(),
                 material->diffuseColor.normG(),
                 material->diffuseColor.normB(),
                 material->diffuseColor.normA() * opacity * material->opacity
             };
 
-            std::vector<std::vector<float>> fragmentShaderConstants(1);
-            fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-            std::vector<std::vector<float>> vertexShaderConstants(1);
-            vertexShaderConstants[0] = {std::begin(modelViewProj.m.v), std::end(modelViewProj.m.v)};
-
-            std::vector<std::size_t> textures;
-            textures.reserve(graphics::Material::textureLayers);
-            for (const std::shared_ptr<graphics::Texture>& texture : material->textures)
-                textures.push_back(texture ? texture->getResource() : 0);
-
-            engine->getGraphics().setPipelineState(material->blendState->getResource(),
-                                                   material->shader->getResource(),
-                                                   material->cullMode,
-                                                   wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid);
-            engine->getGraphics().setShaderConstants(fragmentShaderConstants,
-                                                     vertexShaderConstants);
-            engine->getGraphics().setTextures(textures);
-
             const auto& frame = currentAnimation->animation->frames[currentFrame];
 
-            engine->getGraphics().draw(frame.getIndexBuffer()->getResource(),
-                                       frame.getIndexCount(),
-                                       sizeof(std::uint16_t),
-                                       frame.getVertexBuffer()->getResource(),
-                                       graphics::DrawMode::triangleList,
-                                       0);
+            engine->getGraphics().getSpriteBatcher().addSprite(state,
+                                                               frame.getIndices(),
+                                                               frame.getVertices(),
+                                                               transformMatrix * offsetMatrix,
+                                                               color);
         }
     }
 
@@ -417,7 +410,7 @@ namespace ouzel::scene
     {
         if (!playing)
         {
-            engine->getEventDispatcher().addEventHandler(updateHandler);
+            engine->getUpdateScheduler().addUpdater(updater);
             playing = true;
             running = true;
         }
@@ -429,7 +422,7 @@ namespace ouzel::scene
         {
             playing = false;
             running = false;
-            updateHandler.remove();
+            updater.remove();
         }
 
         if (resetAnimation) reset();
@@ -8,7 +8,7 @@
 #include <memory>
 #include <vector>
 #include "Component.hpp"
-#include "../events/EventHandler.hpp"
+#include "../core/UpdateScheduler.hpp"
 #include "../graphics/BlendState.hpp"
 #include "../graphics/Buffer.hpp"
 #include "../graphics/Material.hpp"
@@ -37,12 +37,12 @@ namespace ouzel::scene
                   const math::Vector<float, 2>& pivot);
 
             Frame(const std::string& frameName,
-                  const std::vector<std::uint16_t>& indices,
-                  const std::vector<graphics::Vertex>& vertices);
+                  const std::vector<std::uint16_t>& initIndices,
+                  const std::vector<graphics::Vertex>& initVertices);
 
             Frame(const std::string& frameName,
-                  const std::vector<std::uint16_t>& indices,
-                  const std::vector<graphics::Vertex>& vertices,
+                  const std::vector<std::uint16_t>& initIndices,
+                  const std::vector<graphics::Vertex>& initVertices,
                   const math::Rect<float>& frameRectangle,
                   const math::Size<float, 2>& sourceSize,
                   const math::Vector<float, 2>& sourceOffset,
@@ -55,10 +55,16 @@ namespace ouzel::scene
             auto& getIndexBuffer() const noexcept { return indexBuffer; }
             auto& getVertexBuffer() const noexcept { return vertexBuffer; }
 
+            // CPU copies of the geometry used for batching
+            auto& getIndices() const noexcept { return indices; }
+            auto& getVertices() const noexcept { return vertices; }
+
         private:
             std::string name;
             math::Box<float, 2> boundingBox;
             std::uint32_t indexCount = 0;
+            std::vector<std::uint16_t> indices;
+            std::vector<graphics::Vertex> vertices;
             std::shared_ptr<graphics::Buffer> indexBuffer;
             std::shared_ptr<graphics::Buffer> vertexBuffer;
         };
@@ -141,7 +147,7 @@ namespace ouzel::scene
         bool running = false;
         float currentTime = 0.0F;
 
-        EventHandler updateHandler;
+        core::Updater updater{core::UpdatePhase::animation};
     };
 }
 
@@ -15,6 +15,7 @@ namespace ouzel::scene
                                math::Color initColor,
                                const math::Vector<float, 2>& initTextAnchor):
         shader{engine->getCache().getShader(shaderTexture)},
+        distanceFieldShader{engine->getCache().getShader(shaderDistanceField)},
         blendState{engine->getCache().getBlendState(blendAlpha)},
         indexBuffer{engine->getGraphics(),
                     graphics::BufferType::index,
@@ -38,6 +39,7 @@ namespace ouzel::scene
                                math::Color initColor,
                                const math::Vector<float, 2>& initTextAnchor):
         shader{engine->getCache().getShader(shaderTexture)},
+        distanceFieldShader{engine->getCache().getShader(shaderDistanceField)},
         blendState{engine->getCache().getBlendState(blendAlpha)},
         indexBuffer{engine->getGraphics(),
                     graphics::BufferType::index,
@@ -86,6 +88,10 @@ namespace ouzel::scene
                         renderViewProjection,
                         wireframe);
 
+        // the glyphs of the text were evicted from the font's atlas or moved to a bigger one
+        if (font && font->getVersion() != fontVersion)
+            updateText();
+
         if (needsMeshUpdate)
         {
             indexBuffer.setData(indices.data(), static_cast<std::uint32_t>(getVectorSize(indices)));
@@ -105,6 +111,20 @@ namespace ouzel::scene
         std::vector<std::vector<float>> fragmentShaderConstants(1);
         fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
 
+        if (shader == distanceFieldShader)
+        {
+            // the outline is left out by making it transparent
+            const auto outlineColorVector = {
+                outlineColor.normR(),
+                outlineColor.normG(),
+                outlineColor.normB(),
+                outlineWidth > 0.0F ? outlineColor.normA() * opacity : 0.0F
+            };
+
+            fragmentShaderConstants.emplace_back(std::begin(outlineColorVector), std::end(outlineColorVector));
+            fragmentShaderConstants.push_back({outlineWidth});
+        }
+
         std::vector<std::vector<float>> vertexShaderConstants(1);
         vertexShaderConstants[0] = {std::begin(modelViewProj.m.v), std::end(modelViewProj.m.v)};
 
@@ -137,8 +157,22 @@ namespace ouzel::scene
         if (font)
         {
             std::tie(indices, vertices, texture) = font->getRenderData(text, math::whiteColor, fontSize, textAnchor);
+            fontVersion = font->getVersion();
             needsMeshUpdate = true;
 
+            // the default shaders follow the font and the format of its texture, a custom shader is kept
+            const auto textureShader = engine->getCache().getShader(shaderTexture);
+            const auto textShader = engine->getCache().getShader(shaderText);
+            if (shader == textureShader || (shader && (shader == textShader || shader == distanceFieldShader)))
+            {
+                if (distanceFieldShader && font->isDistanceField())
+                    shader = distanceFieldShader;
+                else if (textShader && texture && graphics::getChannelCount(texture->getPixelFormat()) == 1)
+                    shader = textShader;
+                else
+                    shader = textureShader;
+            }
+
             for (const auto& vertex : vertices)
                 insertPoint(boundingBox, vertex.position);
         }
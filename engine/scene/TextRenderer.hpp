@@ -51,6 +51,20 @@ namespace ouzel::scene
             color = newColor;
         }
 
+        auto getOutlineColor() const noexcept { return outlineColor; }
+        void setOutlineColor(math::Color newOutlineColor) noexcept
+        {
+            outlineColor = newOutlineColor;
+        }
+
+        // the width of the outline as a fraction of the distance field's spread outside of the glyphs (0 - 1),
+        // only the distance field fonts have outlines
+        auto getOutlineWidth() const noexcept { return outlineWidth; }
+        void setOutlineWidth(float newOutlineWidth) noexcept
+        {
+            outlineWidth = newOutlineWidth;
+        }
+
         auto& getShader() const noexcept { return shader; }
         void setShader(const graphics::Shader* newShader)
         {
@@ -67,6 +81,7 @@ namespace ouzel::scene
         void updateText();
 
         const graphics::Shader* shader = nullptr;
+        const graphics::Shader* distanceFieldShader = nullptr;
         const graphics::BlendState* blendState = nullptr;
 
         graphics::Buffer indexBuffer;
@@ -84,7 +99,10 @@ namespace ouzel::scene
         std::vector<graphics::Vertex> vertices;
 
         math::Color color = math::whiteColor;
+        math::Color outlineColor = math::blackColor;
+        float outlineWidth = 0.0F;
 
+        std::uint32_t fontVersion = 0;
         bool needsMeshUpdate = false;
     };
 }
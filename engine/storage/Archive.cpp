@@ -0,0 +1,217 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <limits>
+#include "Archive.hpp"
+#include "../utils/Utils.hpp"
+
+// the inflate implementation of stb_image is compiled in assets/ImageLoader.cpp
+#include "stb_image.h"
+
+namespace ouzel::storage
+{
+    namespace
+    {
+        constexpr std::uint32_t endOfCentralDirectorySignature = 0x06054B50U;
+        constexpr std::uint32_t centralDirectorySignature = 0x02014B50U;
+        constexpr std::uint32_t headerSignature = 0x04034B50U;
+
+        constexpr std::size_t endOfCentralDirectorySize = 22;
+        constexpr std::size_t centralDirectoryHeaderSize = 46;
+        constexpr std::size_t headerSize = 30;
+        constexpr std::size_t maxCommentLength = 0xFFFF;
+
+        constexpr std::uint16_t encryptedFlag = 0x01;
+
+        template <typename T>
+        T decode(Span<const std::byte> data, std::size_t offset) noexcept
+        {
+            return decodeLittleEndian<T>(data.data() + offset);
+        }
+    }
+
+    Archive::Archive(const Path& initPath):
+        path{initPath},
+        file{std::make_shared<const MappedFile>(initPath)}
+    {
+        const auto data = file->getData();
+
+        if (data.size() < endOfCentralDirectorySize)
+            throw Error{"Invalid archive " + std::string(path)};
+
+        // the end of central directory record is followed only by the archive comment
+        const auto searchEnd = (data.size() > endOfCentralDirectorySize + maxCommentLength) ?
+            data.size() - endOfCentralDirectorySize - maxCommentLength : 0;
+
+        auto recordOffset = data.size() - endOfCentralDirectorySize;
+        while (decode<std::uint32_t>(data, recordOffset) != endOfCentralDirectorySignature)
+        {
+            if (recordOffset == searchEnd)
+                throw Error{"Central directory not found in " + std::string(path)};
+            --recordOffset;
+        }
+
+        const std::size_t entryCount = decode<std::uint16_t>(data, recordOffset + 10);
+        const std::size_t directorySize = decode<std::uint32_t>(data, recordOffset + 12);
+        const std::size_t directoryOffset = decode<std::uint32_t>(data, recordOffset + 16);
+
+        if (entryCount == std::numeric_limits<std::uint16_t>::max() ||
+            directoryOffset == std::numeric_limits<std::uint32_t>::max())
+            throw Error{"ZIP64 archives are not supported"};
+
+        if (directoryOffset > recordOffset || directorySize > recordOffset - directoryOffset)
+            throw Error{"Invalid central directory in " + std::string(path)};
+
+        entries.reserve(entryCount);
+
+        // the whole index is built from the central directory, the local headers are read on first access
+        auto offset = directoryOffset;
+        for (std::size_t i = 0; i < entryCount; ++i)
+        {
+            if (directoryOffset + directorySize - offset < centralDirectoryHeaderSize ||
+                decode<std::uint32_t>(data, offset) != centralDirectorySignature)
+                throw Error{"Invalid central directory in " + std::string(path)};
+
+            const auto flags = decode<std::uint16_t>(data, offset + 8);
+            const auto compression = decode<std::uint16_t>(data, offset + 10);
+            const std::size_t compressedSize = decode<std::uint32_t>(data, offset + 20);
+            const std::size_t uncompressedSize = decode<std::uint32_t>(data, offset + 24);
+            const std::size_t fileNameLength = decode<std::uint16_t>(data, offset + 28);
+            const std::size_t extraFieldLength = decode<std::uint16_t>(data, offset + 30);
+            const std::size_t commentLength = decode<std::uint16_t>(data, offset + 32);
+            const std::size_t headerOffset = decode<std::uint32_t>(data, offset + 42);
+
+            const auto entrySize = centralDirectoryHeaderSize + fileNameLength + extraFieldLength + commentLength;
+            if (directoryOffset + directorySize - offset < entrySize)
+                throw Error{"Invalid central directory in " + std::string(path)};
+
+            const std::string_view name{
+                reinterpret_cast<const char*>(data.data() + offset + centralDirectoryHeaderSize),
+                fileNameLength
+            };
+
+            if (flags & encryptedFlag)
+                throw Error{"Encrypted file " + std::string{name} + " is not supported"};
+
+            // directories don't have any data
+            if (!name.empty() && name.back() != '/')
+                entries.insert_or_assign(name, Entry{
+                    headerOffset,
+                    compressedSize,
+                    uncompressedSize,
+                    static_cast<Compression>(compression)
+                });
+
+            offset += entrySize;
+        }
+    }
+
+    Span<const std::byte> Archive::getFileData(std::string_view filename) const
+    {
+        const auto& entry = getEntry(filename);
+
+        if (entry.compression == Compression::none)
+            return getCompressedData(entry);
+
+        const auto data = getDecompressedData(entry);
+        return Span<const std::byte>{data->data(), data->size()};
+    }
+
+    std::vector<std::byte> Archive::readFile(std::string_view filename) const
+    {
+        const auto& entry = getEntry(filename);
+
+        if (entry.compression == Compression::none)
+        {
+            const auto data = getCompressedData(entry);
+            return std::vector<std::byte>(data.begin(), data.end());
+        }
+
+        const auto data = getDecompressedData(entry);
+        return *data;
+    }
+
+    FileReader Archive::openFile(std::string_view filename) const
+    {
+        const auto& entry = getEntry(filename);
+
+        // the reader shares the ownership of the mapping or of the decompressed data
+        if (entry.compression == Compression::none)
+            return FileReader{file, getCompressedData(entry)};
+
+        auto data = getDecompressedData(entry);
+        const Span<const std::byte> span{data->data(), data->size()};
+        return FileReader{std::move(data), span};
+    }
+
+    void Archive::clearCache()
+    {
+        if (!cache) return; // moved from
+
+        std::scoped_lock lock{cache->mutex};
+        cache->files.clear();
+    }
+
+    const Archive::Entry& Archive::getEntry(std::string_view filename) const
+    {
+        if (!file)
+            throw Error{"Archive is not open"};
+
+        if (const auto i = entries.find(filename); i != entries.end())
+            return i->second;
+        else
+            throw Error{"File " + std::string{filename} + " does not exist"};
+    }
+
+    Span<const std::byte> Archive::getCompressedData(const Entry& entry) const
+    {
+        const auto data = file->getData();
+
+        if (entry.headerOffset > data.size() ||
+            data.size() - entry.headerOffset < headerSize ||
+            decode<std::uint32_t>(data, entry.headerOffset) != headerSignature)
+            throw Error{"Invalid file header in " + std::string(path)};
+
+        // the extra field of the local header can differ from the one in the central directory
+        const std::size_t fileNameLength = decode<std::uint16_t>(data, entry.headerOffset + 26);
+        const std::size_t extraFieldLength = decode<std::uint16_t>(data, entry.headerOffset + 28);
+        const auto dataOffset = entry.headerOffset + headerSize + fileNameLength + extraFieldLength;
+
+        if (dataOffset > data.size() || data.size() - dataOffset < entry.compressedSize)
+            throw Error{"Invalid file header in " + std::string(path)};
+
+        return data.subspan(dataOffset, entry.compressedSize);
+    }
+
+    std::shared_ptr<const std::vector<std::byte>> Archive::getDecompressedData(const Entry& entry) const
+    {
+        {
+            std::scoped_lock lock{cache->mutex};
+            if (const auto i = cache->files.find(&entry); i != cache->files.end())
+                return i->second;
+        }
+
+        if (entry.compression != Compression::deflate)
+            throw Error{"Unsupported compression"};
+
+        const auto compressedData = getCompressedData(entry);
+
+        if (compressedData.size() > static_cast<std::size_t>(std::numeric_limits<int>::max()) ||
+            entry.size > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+            throw Error{"File is too big"};
+
+        // decompressed without the lock, so that other files can be decompressed at the same time
+        auto data = std::make_shared<std::vector<std::byte>>(entry.size);
+        const auto size = stbi_zlib_decode_noheader_buffer(reinterpret_cast<char*>(data->data()),
+                                                           static_cast<int>(data->size()),
+                                                           reinterpret_cast<const char*>(compressedData.data()),
+                                                           static_cast<int>(compressedData.size()));
+
+        if (size < 0 || static_cast<std::size_t>(size) != entry.size)
+            throw Error{"Failed to decompress file"};
+
+        // if another thread decompressed the same file in the meantime, its data is used
+        std::scoped_lock lock{cache->mutex};
+        return cache->files.try_emplace(&entry, std::move(data)).first->second;
+    }
+}
@@ -3,112 +3,77 @@
 #ifndef OUZEL_STORAGE_ARCHIVE_HPP
 #define OUZEL_STORAGE_ARCHIVE_HPP
 
+#include <cstddef>
 #include <cstdint>
-#include <fstream>
-#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
+#include "FileReader.hpp"
+#include "MappedFile.hpp"
 #include "Path.hpp"
 #include "StorageError.hpp"
-#include "../utils/Utils.hpp"
+#include "../utils/Span.hpp"
 
 namespace ouzel::storage
 {
+    // ZIP archive mapped into memory, stored files are accessed without copying them
+    // and deflated files are decompressed on first access
     class Archive final
     {
     public:
         Archive() = default;
+        explicit Archive(const Path& initPath);
 
-        explicit Archive(const Path& path):
-            file{path, std::ios::binary}
-        {
-            constexpr std::uint32_t centralDirectory = 0x02014B50U;
-            constexpr std::uint32_t headerSignature = 0x04034B50U;
-
-            for (;;)
-            {
-                std::uint8_t signatureData[4];
-                file.read(reinterpret_cast<char*>(signatureData), sizeof(signatureData));
-
-                if (decodeLittleEndian<std::uint32_t>(signatureData) == centralDirectory)
-                    break;
-
-                if (decodeLittleEndian<std::uint32_t>(signatureData) != headerSignature)
-                    throw Error{"Bad signature"};
-
-                file.seekg(2, std::ios::cur); // skip version
-                file.seekg(2, std::ios::cur); // skip flags
-
-                std::uint8_t compressionData[2];
-                file.read(reinterpret_cast<char*>(&compressionData), sizeof(compressionData));
-
-                if (decodeLittleEndian<std::uint16_t>(compressionData) != 0x00)
-                    throw Error{"Unsupported compression"};
-
-                file.seekg(2, std::ios::cur); // skip modification time
-                file.seekg(2, std::ios::cur); // skip modification date
-                file.seekg(4, std::ios::cur); // skip CRC-32
-
-                std::uint8_t compressedSizeData[4];
-                file.read(reinterpret_cast<char*>(compressedSizeData), sizeof(compressedSizeData));
-
-                std::uint8_t uncompressedSizeData[4];
-                file.read(reinterpret_cast<char*>(uncompressedSizeData), sizeof(uncompressedSizeData));
-                const std::size_t uncompressedSize = decodeLittleEndian<std::uint32_t>(uncompressedSizeData);
-
-                std::uint8_t fileNameLengthData[2];
-                file.read(reinterpret_cast<char*>(fileNameLengthData), sizeof(fileNameLengthData));
-                const std::size_t fileNameLength = decodeLittleEndian<std::uint16_t>(fileNameLengthData);
-
-                std::uint8_t extraFieldLengthData[2];
-                file.read(reinterpret_cast<char*>(extraFieldLengthData), sizeof(extraFieldLengthData));
-                const std::size_t extraFieldLength = decodeLittleEndian<std::uint16_t>(extraFieldLengthData);
-
-                const auto name = std::make_unique<char[]>(fileNameLength + 1); // +1 for null character
+        // A default constructed or moved from archive has no files, reading from it throws an Error
+        bool isOpen() const noexcept { return file != nullptr; }
 
-                file.read(name.get(), static_cast<std::streamsize>(fileNameLength));
+        // The returned data is valid until the archive is destroyed or, for compressed files, until clearCache is called
+        Span<const std::byte> getFileData(std::string_view filename) const;
 
-                file.seekg(static_cast<std::streamoff>(extraFieldLength),
-                           std::ios::cur); // skip extra field
+        // every call works on its own copy of the data, so files can be read from multiple threads at once
+        std::vector<std::byte> readFile(std::string_view filename) const;
+        FileReader openFile(std::string_view filename) const;
 
-                entries[name.get()] = {file.tellg(), uncompressedSize};
-
-                file.seekg(static_cast<std::streamoff>(uncompressedSize),
-                           std::ios::cur); // skip uncompressed size
-            }
-        }
-
-        std::vector<std::byte> readFile(std::string_view filename)
+        bool fileExists(std::string_view filename) const noexcept
         {
-            if (const auto i = entries.find(filename); i != entries.end())
-            {
-                file.seekg(i->second.offset, std::ios::beg);
-
-                std::vector<std::byte> data(i->second.size);
-                file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(i->second.size));
-
-                return data;
-            }
-            else
-                throw Error{"File " + std::string{filename} + " does not exist"};
+            return file && entries.find(filename) != entries.end();
         }
 
-        bool fileExists(std::string_view filename) const noexcept(false)
-        {
-            return entries.find(filename) != entries.end();
-        }
+        // frees the decompressed files, must not be called while data returned by getFileData is in use
+        void clearCache();
 
     private:
-        std::ifstream file;
+        enum class Compression: std::uint16_t
+        {
+            none = 0,
+            deflate = 8
+        };
 
         struct Entry final
         {
-            std::streamoff offset;
+            std::size_t headerOffset;
+            std::size_t compressedSize;
             std::size_t size;
+            Compression compression;
+        };
+
+        const Entry& getEntry(std::string_view filename) const;
+        Span<const std::byte> getCompressedData(const Entry& entry) const;
+        std::shared_ptr<const std::vector<std::byte>> getDecompressedData(const Entry& entry) const;
+
+        struct Cache final
+        {
+            std::mutex mutex;
+            std::unordered_map<const Entry*, std::shared_ptr<const std::vector<std::byte>>> files;
         };
 
-        std::map<std::string, Entry, std::less<>> entries;
+        Path path;
+        std::shared_ptr<const MappedFile> file;
+        std::unordered_map<std::string_view, Entry> entries; // the names point into the mapped central directory
+        std::unique_ptr<Cache> cache = std::make_unique<Cache>();
     };
 }
 
@@ -0,0 +1,121 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_STORAGE_FILEREADER_HPP
+#define OUZEL_STORAGE_FILEREADER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Path.hpp"
+#include "StorageError.hpp"
+#include "../utils/Span.hpp"
+
+namespace ouzel::storage
+{
+    // Reads a file (or a part of it, e.g. a file stored in an archive) in chunks
+    class FileReader final
+    {
+    public:
+        FileReader() = default;
+
+        explicit FileReader(const Path& initPath):
+            path{initPath},
+            file{initPath, std::ios::binary}
+        {
+            if (!file)
+                throw Error{"Failed to open file " + std::string(path)};
+
+            file.seekg(0, std::ios::end);
+            size = static_cast<std::size_t>(file.tellg());
+            file.seekg(0, std::ios::beg);
+        }
+
+        FileReader(const Path& initPath, std::streamoff initOffset, std::size_t initSize):
+            path{initPath},
+            file{initPath, std::ios::binary},
+            offset{initOffset},
+            size{initSize}
+        {
+            if (!file)
+                throw Error{"Failed to open file " + std::string(path)};
+
+            file.seekg(offset, std::ios::beg);
+        }
+
+        // for files that can't be read in parts
+        explicit FileReader(std::vector<std::byte> initData)
+        {
+            auto buffer = std::make_shared<const std::vector<std::byte>>(std::move(initData));
+            memory = buffer->data();
+            size = buffer->size();
+            owner = std::move(buffer);
+        }
+
+        // for files that are already in memory (e.g. mapped archives), the owner keeps the memory alive
+        FileReader(std::shared_ptr<const void> initOwner, Span<const std::byte> initData) noexcept:
+            owner{std::move(initOwner)},
+            memory{initData.data()},
+            size{initData.size()}
+        {
+        }
+
+        // opens the same file again, so that it can be read from another position
+        FileReader reopen() const
+        {
+            if (owner)
+                return FileReader{owner, Span<const std::byte>{memory, size}};
+            else
+                return FileReader{path, offset, size};
+        }
+
+        auto getSize() const noexcept { return size; }
+        auto getPosition() const noexcept { return position; }
+
+        // returns the number of bytes read, zero at the end of the file
+        std::size_t read(std::byte* buffer, std::size_t count)
+        {
+            count = std::min(count, size - position);
+
+            if (owner)
+                std::copy(memory + position, memory + position + count, buffer);
+            else if (count > 0)
+            {
+                file.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(count));
+                if (static_cast<std::size_t>(file.gcount()) != count)
+                    throw Error{"Failed to read from file " + std::string(path)};
+            }
+
+            position += count;
+            return count;
+        }
+
+        void seek(std::size_t newPosition)
+        {
+            if (newPosition > size)
+                throw Error{"Invalid file position"};
+
+            if (!owner)
+            {
+                file.clear();
+                file.seekg(offset + static_cast<std::streamoff>(newPosition), std::ios::beg);
+            }
+
+            position = newPosition;
+        }
+
+    private:
+        Path path;
+        std::ifstream file;
+        std::shared_ptr<const void> owner;
+        const std::byte* memory = nullptr;
+        std::streamoff offset = 0;
+        std::size_t size = 0;
+        std::size_t position = 0;
+    };
+}
+
+#endif // OUZEL_STORAGE_FILEREADER_HPP
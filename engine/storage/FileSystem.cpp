@@ -376,6 +376,32 @@ namespace ouzel::storage
         return data;
     }
 
+    FileReader FileSystem::openFile(const Path& filename, const bool searchResources)
+    {
+        if (searchResources)
+        {
+            const auto& genericPath = filename.getGeneric();
+
+            for (auto& archive : archives)
+                if (archive.second.fileExists(genericPath))
+                    return archive.second.openFile(genericPath);
+        }
+
+#ifdef __ANDROID__
+        // assets can't be reopened at a position, so they are read into memory
+        if (!filename.isAbsolute())
+            return FileReader{readFile(filename, searchResources)};
+#endif
+
+        const auto path = getPath(filename, searchResources);
+
+        // file does not exist
+        if (path.isEmpty())
+            throw Error{"Failed to find file " + std::string(filename)};
+
+        return FileReader{path};
+    }
+
     bool FileSystem::resourceFileExists(const Path& filename) const
     {
         if (filename.isAbsolute())
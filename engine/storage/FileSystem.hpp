@@ -30,6 +30,7 @@
 #  include <unistd.h>
 #endif
 #include "Archive.hpp"
+#include "FileReader.hpp"
 #include "Path.hpp"
 #include "StorageError.hpp"
 
@@ -249,6 +250,9 @@ namespace ouzel::storage
 
         [[nodiscard]] std::vector<std::byte> readFile(const Path& filename, const bool searchResources = true);
 
+        // opens the file for reading in chunks instead of reading all of it
+        [[nodiscard]] FileReader openFile(const Path& filename, const bool searchResources = true);
+
         bool resourceFileExists(const Path& filename) const;
 
         [[nodiscard]] Path getPath(const Path& filename, const bool searchResources = true) const
@@ -0,0 +1,167 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_STORAGE_MAPPEDFILE_HPP
+#define OUZEL_STORAGE_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <system_error>
+#ifdef _WIN32
+#  pragma push_macro("WIN32_LEAN_AND_MEAN")
+#  pragma push_macro("NOMINMAX")
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <Windows.h>
+#  pragma pop_macro("WIN32_LEAN_AND_MEAN")
+#  pragma pop_macro("NOMINMAX")
+#elif defined(__unix__) || defined(__APPLE__)
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+#include "Path.hpp"
+#include "../utils/Span.hpp"
+
+namespace ouzel::storage
+{
+    // Read-only view of the whole file mapped into memory, the pages are loaded by the OS on first access
+    class MappedFile final
+    {
+    public:
+        MappedFile() noexcept = default;
+
+        explicit MappedFile(const Path& path)
+        {
+#ifdef _WIN32
+            const auto file = CreateFileW(path.getNative().c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                          nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                throw std::system_error{static_cast<int>(GetLastError()), std::system_category(), "Failed to open file " + std::string(path)};
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize))
+            {
+                const auto error = GetLastError();
+                CloseHandle(file);
+                throw std::system_error{static_cast<int>(error), std::system_category(), "Failed to get size of " + std::string(path)};
+            }
+
+            size = static_cast<std::size_t>(fileSize.QuadPart);
+
+            // empty files can't be mapped
+            if (size > 0)
+            {
+                const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!mapping)
+                {
+                    const auto error = GetLastError();
+                    CloseHandle(file);
+                    throw std::system_error{static_cast<int>(error), std::system_category(), "Failed to map file " + std::string(path)};
+                }
+
+                // the view keeps the mapping and the file open
+                memory = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                const auto error = GetLastError();
+                CloseHandle(mapping);
+                CloseHandle(file);
+
+                if (!memory)
+                    throw std::system_error{static_cast<int>(error), std::system_category(), "Failed to map file " + std::string(path)};
+            }
+            else
+                CloseHandle(file);
+#else
+            auto fd = open(path.getNative().c_str(), O_RDONLY);
+            while (fd == -1 && errno == EINTR)
+                fd = open(path.getNative().c_str(), O_RDONLY);
+
+            if (fd == -1)
+                throw std::system_error{errno, std::system_category(), "Failed to open file " + std::string(path)};
+
+            struct stat buf;
+            if (fstat(fd, &buf) == -1)
+            {
+                const auto error = errno;
+                close(fd);
+                throw std::system_error{error, std::system_category(), "Failed to get size of " + std::string(path)};
+            }
+
+            size = static_cast<std::size_t>(buf.st_size);
+
+            // empty files can't be mapped
+            if (size > 0)
+            {
+                // the mapping stays valid after the file descriptor is closed
+                const auto result = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                const auto error = errno;
+                close(fd);
+
+                if (result == MAP_FAILED)
+                    throw std::system_error{error, std::system_category(), "Failed to map file " + std::string(path)};
+
+                memory = result;
+            }
+            else
+                close(fd);
+#endif
+        }
+
+        ~MappedFile()
+        {
+            unmap();
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept:
+            memory{other.memory}, size{other.size}
+        {
+            other.memory = nullptr;
+            other.size = 0;
+        }
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            unmap();
+            memory = other.memory;
+            size = other.size;
+            other.memory = nullptr;
+            other.size = 0;
+
+            return *this;
+        }
+
+        [[nodiscard]] Span<const std::byte> getData() const noexcept
+        {
+            return Span<const std::byte>{static_cast<const std::byte*>(memory), size};
+        }
+
+        [[nodiscard]] auto getSize() const noexcept { return size; }
+
+    private:
+        void unmap() noexcept
+        {
+            if (!memory) return;
+#ifdef _WIN32
+            UnmapViewOfFile(memory);
+#else
+            munmap(memory, size);
+#endif
+            memory = nullptr;
+        }
+
+        void* memory = nullptr;
+        std::size_t size = 0;
+    };
+}
+
+#endif // OUZEL_STORAGE_MAPPEDFILE_HPP
@@ -3,6 +3,8 @@
 #ifndef OUZEL_THREAD_SEMAPHORE_HPP
 #define OUZEL_THREAD_SEMAPHORE_HPP
 
+#include <chrono>
+#include <cstdint>
 #include <system_error>
 #ifdef _WIN32
 #  pragma push_macro("WIN32_LEAN_AND_MEAN")
@@ -19,6 +21,8 @@
 #elif defined(__APPLE__)
 #  include <dispatch/dispatch.h>
 #else
+#  include <cerrno>
+#  include <ctime>
 #  include <semaphore.h>
 #endif
 
@@ -78,15 +82,57 @@ namespace ouzel::thread
 #endif
         }
 
+        // returns false if the semaphore was not released before the timeout
+        template <class Rep, class Period>
+        bool tryAcquireFor(const std::chrono::duration<Rep, Period>& timeout)
+        {
+            const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+#ifdef _MSC_VER
+            const auto milliseconds = (nanoseconds > 0) ? (nanoseconds + 999999) / 1000000 : 0;
+            switch (WaitForSingleObject(semaphore, static_cast<DWORD>(milliseconds)))
+            {
+                case WAIT_OBJECT_0: return true;
+                case WAIT_TIMEOUT: return false;
+                default: throw std::system_error{static_cast<int>(GetLastError()), std::system_category(), "Failed to wait for semaphore"};
+            }
+#elif defined(__APPLE__)
+            return dispatch_semaphore_wait(semaphore, dispatch_time(DISPATCH_TIME_NOW, static_cast<std::int64_t>(nanoseconds))) == 0;
+#else
+            // sem_timedwait takes an absolute time of the realtime clock
+            timespec deadline;
+            if (clock_gettime(CLOCK_REALTIME, &deadline) == -1)
+                throw std::system_error{errno, std::system_category(), "Failed to get time"};
+
+            if (nanoseconds > 0)
+            {
+                deadline.tv_sec += static_cast<std::time_t>(nanoseconds / 1000000000);
+                deadline.tv_nsec += static_cast<long>(nanoseconds % 1000000000);
+                if (deadline.tv_nsec >= 1000000000)
+                {
+                    ++deadline.tv_sec;
+                    deadline.tv_nsec -= 1000000000;
+                }
+            }
+
+            while (sem_timedwait(&semaphore, &deadline) == -1)
+                if (errno == ETIMEDOUT)
+                    return false;
+                else if (errno != EINTR)
+                    throw std::system_error{errno, std::system_category(), "Failed to wait for semaphore"};
+
+            return true;
+#endif
+        }
+
         void release(std::ptrdiff_t count = 1)
         {
 #ifdef _MSC_VER
             if (!ReleaseSemaphore(semaphore, static_cast<LONG>(count), nullptr))
                 throw std::system_error{static_cast<int>(GetLastError()), std::system_category(), "Failed to release semaphore"};
 #elif defined(__APPLE__)
+            // the result is non-zero when a waiting thread was woken, which is not an error
             while (count-- > 0)
-                if (dispatch_semaphore_signal(semaphore) != 0)
-                    throw std::runtime_error{"Failed to signal semaphore"};
+                dispatch_semaphore_signal(semaphore);
 #else
             while (count-- > 0)
                 if (sem_post(&semaphore) == -1)
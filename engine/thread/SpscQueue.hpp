@@ -0,0 +1,216 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_THREAD_SPSCQUEUE_HPP
+#define OUZEL_THREAD_SPSCQUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Semaphore.hpp"
+
+namespace ouzel::thread
+{
+    // Bounded lock-free queue between exactly one producer thread and one consumer thread
+    // A blocked side spins for a while before it parks on a semaphore, the spin length adapts to the wait times
+    template <class Type>
+    class SpscQueue final
+    {
+    public:
+        explicit SpscQueue(std::size_t initCapacity):
+            capacity{initCapacity},
+            slots(initCapacity)
+        {
+            if (capacity == 0)
+                throw std::invalid_argument{"Invalid queue capacity"};
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        SpscQueue(SpscQueue&&) = delete;
+        SpscQueue& operator=(SpscQueue&&) = delete;
+
+        auto getCapacity() const noexcept { return capacity; }
+
+        auto getSize() const noexcept
+        {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+
+        // called only by the producer
+        bool tryPush(Type&& value)
+        {
+            const auto tailIndex = tail.load(std::memory_order_relaxed);
+            if (tailIndex - head.load(std::memory_order_acquire) == capacity)
+                return false;
+
+            slots[tailIndex % capacity] = std::move(value);
+            tail.store(tailIndex + 1, std::memory_order_release);
+            consumerWaiter.notify();
+            return true;
+        }
+
+        // called only by the producer, blocks while the queue is full
+        void push(Type&& value)
+        {
+            producerWaiter.wait([this, &value]() { return tryPush(std::move(value)); });
+        }
+
+        // called only by the producer, blocks while the queue is full, but at most for the timeout
+        // returns false if the queue was still full, in that case the value is left intact
+        template <class Rep, class Period>
+        bool push(Type&& value, const std::chrono::duration<Rep, Period>& timeout)
+        {
+            return producerWaiter.waitFor([this, &value]() { return tryPush(std::move(value)); },
+                                          std::chrono::steady_clock::now() + timeout);
+        }
+
+        // called only by the consumer
+        bool tryPop(Type& value)
+        {
+            const auto headIndex = head.load(std::memory_order_relaxed);
+            if (tail.load(std::memory_order_acquire) == headIndex)
+                return false;
+
+            value = std::move(slots[headIndex % capacity]);
+            head.store(headIndex + 1, std::memory_order_release);
+            producerWaiter.notify();
+            return true;
+        }
+
+        // called only by the consumer, blocks until there is a value or the consumer is interrupted
+        // returns false if it was interrupted
+        bool pop(Type& value)
+        {
+            bool result = false;
+            consumerWaiter.wait([this, &value, &result]() {
+                result = tryPop(value);
+                return result || interrupted.exchange(false, std::memory_order_acquire);
+            });
+            return result;
+        }
+
+        // makes the current (or the next) blocking pop on an empty queue return, can be called from any thread
+        void interrupt()
+        {
+            interrupted.store(true, std::memory_order_release);
+            consumerWaiter.notify();
+        }
+
+    private:
+        static constexpr std::size_t cacheLineSize = 64;
+
+        class Waiter final
+        {
+        public:
+            template <class Condition>
+            void wait(Condition condition)
+            {
+                for (std::uint32_t i = 0; i < spinCount; ++i)
+                {
+                    if (condition())
+                    {
+                        // the wait was short, so spin longer next time before parking
+                        spinCount = std::min(spinCount * 2, maxSpinCount);
+                        return;
+                    }
+
+                    std::this_thread::yield();
+                }
+
+                spinCount = std::max(spinCount / 2, minSpinCount);
+
+                for (;;)
+                {
+                    parked.store(true, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    if (condition())
+                    {
+                        // if the notifier has already taken the flag, its release has to be consumed
+                        if (!parked.exchange(false, std::memory_order_relaxed))
+                            semaphore.acquire();
+                        return;
+                    }
+
+                    semaphore.acquire();
+                }
+            }
+
+            // returns false if the condition was not met before the deadline
+            template <class Condition>
+            bool waitFor(Condition condition, std::chrono::steady_clock::time_point deadline)
+            {
+                for (std::uint32_t i = 0; i < spinCount; ++i)
+                {
+                    if (condition())
+                    {
+                        spinCount = std::min(spinCount * 2, maxSpinCount);
+                        return true;
+                    }
+
+                    std::this_thread::yield();
+                }
+
+                spinCount = std::max(spinCount / 2, minSpinCount);
+
+                for (;;)
+                {
+                    parked.store(true, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    if (condition())
+                    {
+                        if (!parked.exchange(false, std::memory_order_relaxed))
+                            semaphore.acquire();
+                        return true;
+                    }
+
+                    const auto now = std::chrono::steady_clock::now();
+                    if (now >= deadline || !semaphore.tryAcquireFor(deadline - now))
+                    {
+                        // the notifier may have taken the flag after the timeout, its release has to be consumed
+                        if (!parked.exchange(false, std::memory_order_relaxed))
+                            semaphore.acquire();
+                        return condition();
+                    }
+                }
+            }
+
+            void notify()
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if (parked.load(std::memory_order_relaxed) &&
+                    parked.exchange(false, std::memory_order_relaxed))
+                    semaphore.release();
+            }
+
+        private:
+            static constexpr std::uint32_t minSpinCount = 16;
+            static constexpr std::uint32_t maxSpinCount = 4096;
+
+            std::uint32_t spinCount = minSpinCount; // accessed only by the waiting thread
+            std::atomic<bool> parked{false};
+            Semaphore semaphore;
+        };
+
+        const std::size_t capacity;
+        std::vector<Type> slots;
+
+        alignas(cacheLineSize) std::atomic<std::size_t> head{0};
+        alignas(cacheLineSize) std::atomic<std::size_t> tail{0};
+        alignas(cacheLineSize) std::atomic<bool> interrupted{false};
+
+        Waiter producerWaiter;
+        Waiter consumerWaiter;
+    };
+}
+
+#endif // OUZEL_THREAD_SPSCQUEUE_HPP
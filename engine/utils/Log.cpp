@@ -27,7 +27,18 @@
 #  include <emscripten.h>
 #endif
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 #include "Log.hpp"
+#ifndef __EMSCRIPTEN__
+#  include "../thread/SpscQueue.hpp"
+#  include "../thread/Thread.hpp"
+#endif
 
 namespace ouzel
 {
@@ -142,4 +153,402 @@ namespace ouzel
 #  endif
 #endif
     }
+
+#ifndef __EMSCRIPTEN__
+    namespace
+    {
+        // a part of a message, the messages that don't fit into one record take several consecutive records
+        struct Record final
+        {
+            static constexpr std::size_t textSize = 240;
+
+            std::int64_t time = 0; // nanoseconds since the epoch
+            Log::Level level = Log::Level::info;
+            std::uint16_t size = 0;
+            bool last = true; // the last record of the message
+            char text[textSize];
+        };
+
+        struct Message final
+        {
+            std::int64_t time = 0;
+            std::uint32_t threadIndex = 0;
+            Log::Level level = Log::Level::info;
+            std::string text;
+        };
+
+        void appendLittleEndian(std::vector<char>& data, std::uint64_t value, std::size_t size)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+                data.push_back(static_cast<char>((value >> (i * 8)) & 0xFFU));
+        }
+    }
+
+    // Every thread writes its messages into its own single producer single consumer queue of fixed size records,
+    // so logging doesn't take locks or make system calls on the calling thread. The writer thread collects the
+    // messages of all the threads, orders them by time and writes them to the platform's log and to the binary log file.
+    //
+    // The binary log file starts with "OUZELLOG" and a 32-bit version followed by the messages, each of them
+    // stored as a 64-bit time (nanoseconds since the epoch), a 32-bit thread index (zero for the messages of
+    // the writer itself), an 8-bit level, a 32-bit size and the UTF-8 text, all the numbers in little endian.
+    class Logger::Writer final
+    {
+    public:
+        explicit Writer(const Logger& initLogger) noexcept:
+            logger{initLogger}
+        {
+        }
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+        Writer(Writer&&) = delete;
+        Writer& operator=(Writer&&) = delete;
+
+        void start(std::size_t initBufferSize, const storage::Path& binaryLogPath)
+        {
+            if (initBufferSize == 0)
+                throw std::invalid_argument{"Invalid log buffer size"};
+
+            {
+                std::scoped_lock lock{buffersMutex};
+                bufferSize = initBufferSize;
+            }
+
+            if (!binaryLogPath.isEmpty())
+            {
+                file.open(binaryLogPath.getNative(), std::ios::binary | std::ios::app);
+                if (!file)
+                    throw std::runtime_error{"Failed to open " + std::string(binaryLogPath)};
+
+                if (file.tellp() == 0)
+                {
+                    std::vector<char> header{'O', 'U', 'Z', 'E', 'L', 'L', 'O', 'G'};
+                    appendLittleEndian(header, binaryLogVersion, 4);
+                    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+                }
+            }
+
+            running = true;
+            writerThread = thread::Thread{&Writer::run, this};
+        }
+
+        void stop()
+        {
+            {
+                std::scoped_lock lock{mutex};
+                running = false;
+            }
+
+            condition.notify_one();
+            if (writerThread.isJoinable()) writerThread.join();
+
+            // read the buffers once more on the calling thread, so that no message that was buffered before
+            // the logger stopped depends on the last flush of the writer thread
+            std::vector<Message> messages;
+            flush(messages);
+
+            if (file.is_open()) file.close();
+        }
+
+        void write(const std::string& str, Log::Level level)
+        {
+            auto& buffer = getThreadBuffer();
+
+            // the whole message is dropped if it doesn't fit, so that the writer never gets a part of it
+            const auto recordCount = (str.size() + Record::textSize - 1) / Record::textSize;
+            if (buffer.records.getCapacity() - buffer.records.getSize() < recordCount)
+            {
+                buffer.droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+            for (std::size_t offset = 0; offset < str.size(); offset += Record::textSize)
+            {
+                Record record;
+                record.time = static_cast<std::int64_t>(time);
+                record.level = level;
+                record.size = static_cast<std::uint16_t>(std::min(str.size() - offset, Record::textSize));
+                record.last = (offset + record.size == str.size());
+                std::memcpy(record.text, str.data() + offset, record.size);
+                buffer.records.tryPush(std::move(record));
+            }
+
+            // only the first message after the writer has woken up notifies it
+            if (!pending.exchange(true, std::memory_order_acq_rel))
+                condition.notify_one();
+        }
+
+        std::uint64_t getDroppedCount() const
+        {
+            std::scoped_lock lock{buffersMutex};
+
+            auto result = removedDroppedCount;
+            for (const auto& buffer : buffers)
+                result += buffer->droppedCount.load(std::memory_order_relaxed);
+
+            return result;
+        }
+
+    private:
+        static constexpr std::uint32_t binaryLogVersion = 1;
+        static constexpr std::chrono::milliseconds flushInterval{100};
+
+        struct Buffer final
+        {
+            Buffer(std::size_t capacity, std::uint32_t initThreadIndex):
+                records{capacity}, threadIndex{initThreadIndex}
+            {
+            }
+
+            thread::SpscQueue<Record> records;
+            const std::uint32_t threadIndex;
+            std::atomic<std::uint64_t> droppedCount{0};
+            std::atomic<bool> closed{false}; // the thread has exited
+
+            // accessed only by the writer thread
+            Message message;
+            std::uint64_t reportedDroppedCount = 0;
+        };
+
+        // closes the buffer when the thread exits, so that the writer can remove it after reading the rest of it
+        struct ThreadBuffer final
+        {
+            ~ThreadBuffer()
+            {
+                if (buffer) buffer->closed.store(true, std::memory_order_release);
+            }
+
+            const Writer* writer = nullptr;
+            std::shared_ptr<Buffer> buffer;
+        };
+
+        Buffer& getThreadBuffer()
+        {
+            if (threadBuffer.writer != this)
+            {
+                if (threadBuffer.buffer)
+                    threadBuffer.buffer->closed.store(true, std::memory_order_release);
+
+                std::scoped_lock lock{buffersMutex};
+                threadBuffer.buffer = std::make_shared<Buffer>(bufferSize, ++threadCount);
+                threadBuffer.writer = this;
+                buffers.push_back(threadBuffer.buffer);
+            }
+
+            return *threadBuffer.buffer;
+        }
+
+        void run()
+        {
+            std::vector<Message> messages;
+
+            for (;;)
+            {
+                bool stopping;
+
+                {
+                    // the notifications are sent without locking the mutex, so a missed one only delays the messages
+                    std::unique_lock lock{mutex};
+                    condition.wait_for(lock, flushInterval, [this]() {
+                        return pending.load(std::memory_order_acquire) || !running;
+                    });
+                    stopping = !running;
+                }
+
+                pending.store(false, std::memory_order_release);
+                flush(messages);
+
+                if (stopping) break;
+            }
+        }
+
+        void flush(std::vector<Message>& messages)
+        {
+            std::vector<std::shared_ptr<Buffer>> currentBuffers;
+
+            {
+                std::scoped_lock lock{buffersMutex};
+                currentBuffers = buffers;
+            }
+
+            std::uint64_t droppedCount = 0;
+
+            for (const auto& buffer : currentBuffers)
+            {
+                Record record;
+                while (buffer->records.tryPop(record))
+                {
+                    if (buffer->message.text.empty())
+                    {
+                        buffer->message.time = record.time;
+                        buffer->message.threadIndex = buffer->threadIndex;
+                        buffer->message.level = record.level;
+                    }
+
+                    buffer->message.text.append(record.text, record.size);
+
+                    if (record.last)
+                    {
+                        messages.push_back(std::move(buffer->message));
+                        buffer->message = Message{};
+                    }
+                }
+
+                const auto bufferDroppedCount = buffer->droppedCount.load(std::memory_order_relaxed);
+                droppedCount += bufferDroppedCount - buffer->reportedDroppedCount;
+                buffer->reportedDroppedCount = bufferDroppedCount;
+            }
+
+            {
+                // the buffers of the exited threads are removed after all their records have been read
+                std::scoped_lock lock{buffersMutex};
+                buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [this](const auto& buffer) {
+                    if (!buffer->closed.load(std::memory_order_acquire) || buffer->records.getSize() != 0)
+                        return false;
+
+                    removedDroppedCount += buffer->droppedCount.load(std::memory_order_relaxed);
+                    return true;
+                }), buffers.end());
+            }
+
+            if (droppedCount)
+            {
+                Message message;
+                message.time = static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+                message.level = Log::Level::warning;
+                message.text = std::to_string(droppedCount) + " log messages were dropped";
+                messages.push_back(std::move(message));
+            }
+
+            if (messages.empty()) return;
+
+            std::stable_sort(messages.begin(), messages.end(), [](const auto& a, const auto& b) noexcept {
+                return a.time < b.time;
+            });
+
+            {
+                std::scoped_lock lock{logger.logMutex};
+                for (const auto& message : messages)
+                    logString(message.text, message.level);
+            }
+
+            if (file.is_open())
+            {
+                std::vector<char> data;
+                for (const auto& message : messages)
+                {
+                    appendLittleEndian(data, static_cast<std::uint64_t>(message.time), 8);
+                    appendLittleEndian(data, message.threadIndex, 4);
+                    appendLittleEndian(data, static_cast<std::uint64_t>(message.level), 1);
+                    appendLittleEndian(data, message.text.size(), 4);
+                    data.insert(data.end(), message.text.begin(), message.text.end());
+                }
+
+                file.write(data.data(), static_cast<std::streamsize>(data.size()));
+                file.flush();
+            }
+
+            messages.clear();
+        }
+
+        static thread_local ThreadBuffer threadBuffer;
+
+        const Logger& logger;
+
+        mutable std::mutex buffersMutex;
+        std::vector<std::shared_ptr<Buffer>> buffers;
+        std::size_t bufferSize = 0;
+        std::uint32_t threadCount = 0;
+        std::uint64_t removedDroppedCount = 0;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool running = false;
+        std::atomic<bool> pending{false};
+
+        std::ofstream file;
+        thread::Thread writerThread;
+    };
+
+    thread_local Logger::Writer::ThreadBuffer Logger::Writer::threadBuffer;
+#endif
+
+    Logger::Logger(Log::Level initThreshold):
+        threshold{initThreshold}
+    {
+    }
+
+    Logger::~Logger()
+    {
+        stopAsync();
+    }
+
+    void Logger::startAsync([[maybe_unused]] std::size_t bufferSize,
+                            [[maybe_unused]] const storage::Path& binaryLogPath)
+    {
+#ifndef __EMSCRIPTEN__
+        std::scoped_lock lock{writerMutex};
+
+        if (async.load(std::memory_order_relaxed))
+            throw std::runtime_error{"Asynchronous logging already started"};
+
+        if (!writer) writer = std::make_unique<Writer>(*this);
+        writer->start(bufferSize, binaryLogPath);
+
+        async.store(true, std::memory_order_release);
+#endif
+    }
+
+    void Logger::stopAsync()
+    {
+#ifndef __EMSCRIPTEN__
+        std::scoped_lock lock{writerMutex};
+
+        if (!async.load(std::memory_order_relaxed)) return;
+
+        // the messages logged after this are written on the calling thread, the writer writes the rest of the buffered ones
+        async.store(false);
+
+        // a thread that saw the flag set before the store can still be buffering its message
+        while (asyncWriteCount.load() != 0)
+            std::this_thread::yield();
+
+        writer->stop();
+#endif
+    }
+
+    std::uint64_t Logger::getDroppedCount() const
+    {
+#ifndef __EMSCRIPTEN__
+        std::scoped_lock lock{writerMutex};
+        return writer ? writer->getDroppedCount() : 0;
+#else
+        return 0;
+#endif
+    }
+
+#ifndef __EMSCRIPTEN__
+    bool Logger::logAsync(const std::string& str, const Log::Level level) const
+    {
+        // the write is counted before the flag is checked again, so either stopAsync waits for it
+        // or the message is written on the calling thread
+        ++asyncWriteCount;
+
+        try
+        {
+            const auto buffered = async.load();
+            if (buffered) writer->write(str, level);
+
+            --asyncWriteCount;
+            return buffered;
+        }
+        catch (...)
+        {
+            --asyncWriteCount;
+            throw;
+        }
+    }
+#endif
 }
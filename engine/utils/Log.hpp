@@ -4,7 +4,9 @@
 #define OUZEL_UTILS_LOG_HPP
 
 #include <atomic>
+#include <cstdint>
 #include <cstring>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <type_traits>
@@ -180,10 +182,10 @@ namespace ouzel
     class Logger final
     {
     public:
-        explicit Logger(Log::Level initThreshold = Log::Level::all):
-            threshold{initThreshold}
-        {
-        }
+        static constexpr std::size_t defaultBufferSize = 512;
+
+        explicit Logger(Log::Level initThreshold = Log::Level::all);
+        ~Logger();
 
         Logger(const Logger&) = delete;
         Logger& operator=(const Logger&) = delete;
@@ -200,14 +202,44 @@ namespace ouzel
             if (level <= threshold && !str.empty())
             {
 #ifndef __EMSCRIPTEN__
+                if (async.load(std::memory_order_acquire) && logAsync(str, level))
+                    return;
+
                 std::scoped_lock lock{logMutex};
 #endif
                 logString(str, level);
             }
         }
 
+        // Starts a thread that writes the messages, so that logging doesn't block the calling threads.
+        // Every thread that logs gets a lock-free buffer of bufferSize records (a record holds up to 240 bytes
+        // of a message) and the messages that don't fit into it are dropped. If binaryLogPath is not empty,
+        // the messages are also appended to that file in the binary log format.
+        void startAsync(std::size_t bufferSize = defaultBufferSize, const storage::Path& binaryLogPath = {});
+
+        // writes the buffered messages and stops the writer thread, after that the messages are written on the calling thread again
+        void stopAsync();
+
+        bool isAsync() const noexcept
+        {
+#ifndef __EMSCRIPTEN__
+            return async.load(std::memory_order_acquire);
+#else
+            return false;
+#endif
+        }
+
+        // the number of the messages that were dropped, because the buffer of their thread was full
+        std::uint64_t getDroppedCount() const;
+
     private:
+        class Writer;
+
         static void logString(const std::string& str, const Log::Level level = Log::Level::info);
+#ifndef __EMSCRIPTEN__
+        // returns false if the asynchronous logging was stopped before the message was buffered
+        bool logAsync(const std::string& str, const Log::Level level) const;
+#endif
 
 #ifdef DEBUG
         std::atomic<Log::Level> threshold{Log::Level::all};
@@ -217,6 +249,12 @@ namespace ouzel
 
 #ifndef __EMSCRIPTEN__
         mutable std::mutex logMutex;
+
+        // the writer is kept until the logger is destroyed, because the threads can still be writing into it after stopping
+        std::unique_ptr<Writer> writer;
+        std::atomic<bool> async{false};
+        mutable std::atomic<std::size_t> asyncWriteCount{0}; // the threads that are buffering a message
+        mutable std::mutex writerMutex;
 #endif
     };
 
@@ -0,0 +1,203 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "Profiler.hpp"
+
+namespace ouzel
+{
+    void Profiler::Track::getSamples(std::vector<Sample>& samples) const
+    {
+        const auto last = end.load(std::memory_order_acquire);
+        const auto first = (last > capacity) ? last - capacity : 0;
+        const auto offset = samples.size();
+
+        for (auto i = first; i < last; ++i)
+        {
+            const auto& entry = entries[i & (capacity - 1)];
+            samples.push_back(Sample{
+                entry.name.load(std::memory_order_relaxed),
+                entry.start.load(std::memory_order_relaxed),
+                entry.duration.load(std::memory_order_relaxed)
+            });
+        }
+
+        // drop the entries that the owning thread started to overwrite while they were being copied
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto written = begin.load(std::memory_order_relaxed);
+        const auto valid = (written > capacity) ? written - capacity : 0;
+        if (valid > first)
+        {
+            const auto overwritten = static_cast<std::ptrdiff_t>(std::min(valid - first, last - first));
+            samples.erase(samples.begin() + static_cast<std::ptrdiff_t>(offset),
+                          samples.begin() + static_cast<std::ptrdiff_t>(offset) + overwritten);
+        }
+    }
+
+    std::uint64_t Profiler::Track::getLastDuration(const char* sampleName) const noexcept
+    {
+        const auto last = end.load(std::memory_order_acquire);
+        const auto first = (last > capacity) ? last - capacity : 0;
+
+        for (auto i = last; i > first; --i)
+        {
+            const auto& entry = entries[(i - 1) & (capacity - 1)];
+            const auto entryName = entry.name.load(std::memory_order_relaxed);
+            if (entryName == sampleName ||
+                (entryName && std::strcmp(entryName, sampleName) == 0))
+                return entry.duration.load(std::memory_order_relaxed);
+        }
+
+        return 0;
+    }
+
+    Profiler::Track& Profiler::createTrack(const char* name)
+    {
+        std::scoped_lock lock{tracksMutex};
+
+        auto track = std::make_unique<Track>(static_cast<std::uint32_t>(tracks.size() + 1));
+        track->setName(name);
+
+        auto& result = *track;
+        tracks.push_back(std::move(track));
+
+        // so that releasing a track on thread exit doesn't allocate
+        freeThreadTracks.reserve(tracks.size());
+        return result;
+    }
+
+    Profiler::ThreadTrack::~ThreadTrack()
+    {
+        if (owner && track) owner->releaseThreadTrack(*track);
+    }
+
+    Profiler::Track& Profiler::acquireThreadTrack()
+    {
+        {
+            std::scoped_lock lock{tracksMutex};
+            if (!freeThreadTracks.empty())
+            {
+                // the samples of the previous thread stay in the track until they are overwritten
+                auto& track = *freeThreadTracks.back();
+                freeThreadTracks.pop_back();
+                return track;
+            }
+        }
+
+        return createTrack(nullptr);
+    }
+
+    void Profiler::releaseThreadTrack(Track& track)
+    {
+        track.setName(nullptr);
+
+        std::scoped_lock lock{tracksMutex};
+        freeThreadTracks.push_back(&track);
+    }
+
+    std::uint64_t Profiler::getLastDuration(const char* name) const
+    {
+        std::scoped_lock lock{tracksMutex};
+
+        for (const auto& track : tracks)
+            if (const auto duration = track->getLastDuration(name))
+                return duration;
+
+        return 0;
+    }
+
+    namespace
+    {
+        void appendString(std::string& result, const char* str)
+        {
+            result += '"';
+            for (; *str; ++str)
+                switch (*str)
+                {
+                    case '"': result += "\\\""; break;
+                    case '\\': result += "\\\\"; break;
+                    case '\n': result += "\\n"; break;
+                    case '\t': result += "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(*str) >= 0x20) result += *str;
+                        break;
+                }
+            result += '"';
+        }
+
+        // timestamps in the trace are in microseconds
+        void appendTime(std::string& result, std::uint64_t nanoseconds)
+        {
+            result += std::to_string(nanoseconds / 1000U);
+            result += '.';
+            const auto fraction = std::to_string(nanoseconds % 1000U);
+            result.append(3 - fraction.size(), '0');
+            result += fraction;
+        }
+    }
+
+    std::string Profiler::getChromeTrace() const
+    {
+        std::string result = "{\"traceEvents\":[";
+        bool first = true;
+
+        std::vector<Sample> samples;
+        std::scoped_lock lock{tracksMutex};
+
+        for (const auto& track : tracks)
+        {
+            const auto threadId = std::to_string(track->getId());
+
+            if (const auto name = track->getName())
+            {
+                if (!first) result += ',';
+                first = false;
+
+                result += "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+                result += threadId;
+                result += ",\"args\":{\"name\":";
+                appendString(result, name);
+                result += "}}";
+            }
+
+            samples.clear();
+            track->getSamples(samples);
+
+            for (const auto& sample : samples)
+            {
+                if (!sample.name) continue;
+
+                if (!first) result += ',';
+                first = false;
+
+                result += "\n{\"name\":";
+                appendString(result, sample.name);
+                result += ",\"ph\":\"X\",\"ts\":";
+                appendTime(result, sample.start);
+                result += ",\"dur\":";
+                appendTime(result, sample.duration);
+                result += ",\"pid\":1,\"tid\":";
+                result += threadId;
+                result += '}';
+            }
+        }
+
+        result += "\n]}\n";
+        return result;
+    }
+
+    void Profiler::saveChromeTrace(const storage::Path& path) const
+    {
+        const auto trace = getChromeTrace();
+
+        std::ofstream file{path.getNative(), std::ios::binary | std::ios::trunc};
+        if (!file)
+            throw std::runtime_error{"Failed to open " + std::string(path)};
+
+        file.write(trace.data(), static_cast<std::streamsize>(trace.size()));
+        if (!file)
+            throw std::runtime_error{"Failed to write " + std::string(path)};
+    }
+}
@@ -0,0 +1,198 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_UTILS_PROFILER_HPP
+#define OUZEL_UTILS_PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../core/Setup.h"
+#include "../storage/Path.hpp"
+
+#ifndef OUZEL_ENABLE_PROFILER
+#  define OUZEL_ENABLE_PROFILER 1
+#endif
+
+#define OUZEL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define OUZEL_PROFILE_CONCAT(a, b) OUZEL_PROFILE_CONCAT_IMPL(a, b)
+
+#if OUZEL_ENABLE_PROFILER
+// the name must be a string literal, because only the pointer is stored
+#  define OUZEL_PROFILE_SCOPE(name) const ouzel::ProfileScope OUZEL_PROFILE_CONCAT(profileScope, __LINE__){name}
+#  define OUZEL_PROFILE_THREAD(name) ouzel::profiler.setThreadName(name)
+#else
+#  define OUZEL_PROFILE_SCOPE(name)
+#  define OUZEL_PROFILE_THREAD(name)
+#endif
+
+namespace ouzel
+{
+    class Profiler final
+    {
+    public:
+        struct Sample final
+        {
+            const char* name = nullptr;
+            std::uint64_t start = 0; // nanoseconds since the start of the profiler
+            std::uint64_t duration = 0; // nanoseconds
+        };
+
+        // Ring buffer of the samples of one thread (or of the GPU). Only the owning thread writes to it,
+        // readers copy the samples without locking and drop the ones that were overwritten meanwhile.
+        class Track final
+        {
+            friend Profiler;
+        public:
+            static constexpr std::size_t capacity = 8192;
+
+            explicit Track(std::uint32_t initId) noexcept: id{initId} {}
+
+            void push(const char* sampleName, std::uint64_t start, std::uint64_t duration) noexcept
+            {
+                const auto index = end.load(std::memory_order_relaxed);
+                begin.store(index + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                auto& entry = entries[index & (capacity - 1)];
+                entry.name.store(sampleName, std::memory_order_relaxed);
+                entry.start.store(start, std::memory_order_relaxed);
+                entry.duration.store(duration, std::memory_order_relaxed);
+
+                end.store(index + 1, std::memory_order_release);
+            }
+
+            void setName(const char* newName) noexcept { name.store(newName, std::memory_order_relaxed); }
+            [[nodiscard]] const char* getName() const noexcept { return name.load(std::memory_order_relaxed); }
+            [[nodiscard]] auto getId() const noexcept { return id; }
+
+            // appends the samples currently in the buffer, oldest first
+            void getSamples(std::vector<Sample>& samples) const;
+
+            // the duration of the most recent sample with the given name or zero
+            [[nodiscard]] std::uint64_t getLastDuration(const char* sampleName) const noexcept;
+
+        private:
+            struct Entry final
+            {
+                std::atomic<const char*> name{nullptr};
+                std::atomic<std::uint64_t> start{0};
+                std::atomic<std::uint64_t> duration{0};
+            };
+
+            std::uint32_t id;
+            std::atomic<const char*> name{nullptr};
+            std::atomic<std::size_t> begin{0}; // index of the last entry that is being written + 1
+            std::atomic<std::size_t> end{0}; // index of the last written entry + 1
+            std::array<Entry, capacity> entries;
+        };
+
+        Profiler() = default;
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+        Profiler(Profiler&&) = delete;
+        Profiler& operator=(Profiler&&) = delete;
+
+        [[nodiscard]] static std::uint64_t now() noexcept
+        {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+        }
+
+        // scopes are recorded only while recording, otherwise they cost one atomic load
+        [[nodiscard]] bool isRecording() const noexcept { return recording.load(std::memory_order_relaxed); }
+        void setRecording(bool newRecording) noexcept { recording.store(newRecording, std::memory_order_relaxed); }
+
+        // the name must outlive the profiler
+        void setThreadName(const char* name) { getThreadTrack().setName(name); }
+
+        void addSample(const char* name, std::uint64_t start, std::uint64_t duration)
+        {
+            getThreadTrack().push(name, start, duration);
+        }
+
+        // a track that is not bound to a thread, for example for the GPU timings
+        Track& createTrack(const char* name);
+
+        // the duration of the most recent sample with the given name on any track or zero
+        [[nodiscard]] std::uint64_t getLastDuration(const char* name) const;
+
+        // the recorded samples in the Chrome tracing JSON format (chrome://tracing or Perfetto)
+        [[nodiscard]] std::string getChromeTrace() const;
+        void saveChromeTrace(const storage::Path& path) const;
+
+    private:
+        // returns the track of the thread to the profiler when the thread exits
+        class ThreadTrack final
+        {
+        public:
+            ThreadTrack() noexcept = default;
+            ~ThreadTrack();
+
+            ThreadTrack(const ThreadTrack&) = delete;
+            ThreadTrack& operator=(const ThreadTrack&) = delete;
+            ThreadTrack(ThreadTrack&&) = delete;
+            ThreadTrack& operator=(ThreadTrack&&) = delete;
+
+            Profiler* owner = nullptr;
+            Track* track = nullptr;
+        };
+
+        Track& getThreadTrack()
+        {
+            if (!threadTrack.track)
+            {
+                threadTrack.track = &acquireThreadTrack();
+                threadTrack.owner = this;
+            }
+            return *threadTrack.track;
+        }
+
+        // the tracks of the exited threads are reused, so short-lived threads don't allocate a track each
+        Track& acquireThreadTrack();
+        void releaseThreadTrack(Track& track);
+
+        inline static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        static thread_local ThreadTrack threadTrack;
+
+        std::atomic_bool recording{false};
+        mutable std::mutex tracksMutex;
+        std::vector<std::unique_ptr<Track>> tracks;
+        std::vector<Track*> freeThreadTracks;
+    };
+
+    inline thread_local Profiler::ThreadTrack Profiler::threadTrack;
+
+    inline Profiler profiler;
+
+    class ProfileScope final
+    {
+    public:
+        explicit ProfileScope(const char* initName) noexcept:
+            name{profiler.isRecording() ? initName : nullptr},
+            start{name ? Profiler::now() : 0}
+        {
+        }
+
+        ~ProfileScope()
+        {
+            if (name) profiler.addSample(name, start, Profiler::now() - start);
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+        ProfileScope(ProfileScope&&) = delete;
+        ProfileScope& operator=(ProfileScope&&) = delete;
+
+    private:
+        const char* name;
+        std::uint64_t start;
+    };
+}
+
+#endif // OUZEL_UTILS_PROFILER_HPP
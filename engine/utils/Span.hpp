@@ -0,0 +1,72 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_UTILS_SPAN_HPP
+#define OUZEL_UTILS_SPAN_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace ouzel
+{
+    // non-owning view of a contiguous sequence of objects (subset of C++20 std::span)
+    template <class T>
+    class Span final
+    {
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using size_type = std::size_t;
+        using pointer = T*;
+        using reference = T&;
+        using iterator = T*;
+
+        constexpr Span() noexcept = default;
+        constexpr Span(T* initData, std::size_t initSize) noexcept:
+            elements{initData}, count{initSize}
+        {
+        }
+
+        template <class U, std::size_t n, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+        constexpr Span(U (&array)[n]) noexcept:
+            elements{array}, count{n}
+        {
+        }
+
+        // temporaries are accepted only for views of const elements, e.g. when passed as a function argument
+        template <class Container, typename = std::enable_if_t<
+            !std::is_same_v<std::remove_cv_t<std::remove_reference_t<Container>>, Span> &&
+            !std::is_array_v<std::remove_reference_t<Container>> &&
+            (std::is_lvalue_reference_v<Container> || std::is_const_v<T>) &&
+            std::is_convertible_v<std::remove_pointer_t<decltype(std::declval<Container&>().data())>(*)[], T(*)[]>
+        >>
+        constexpr Span(Container&& container) noexcept:
+            elements{container.data()}, count{container.size()}
+        {
+        }
+
+        [[nodiscard]] constexpr auto data() const noexcept { return elements; }
+        [[nodiscard]] constexpr auto size() const noexcept { return count; }
+        [[nodiscard]] constexpr auto sizeBytes() const noexcept { return count * sizeof(T); }
+        [[nodiscard]] constexpr auto empty() const noexcept { return count == 0; }
+
+        [[nodiscard]] constexpr iterator begin() const noexcept { return elements; }
+        [[nodiscard]] constexpr iterator end() const noexcept { return elements + count; }
+
+        [[nodiscard]] constexpr reference operator[](std::size_t index) const noexcept
+        {
+            return elements[index];
+        }
+
+        [[nodiscard]] constexpr Span subspan(std::size_t offset, std::size_t length) const noexcept
+        {
+            return Span{elements + offset, length};
+        }
+
+    private:
+        T* elements = nullptr;
+        std::size_t count = 0;
+    };
+}
+
+#endif // OUZEL_UTILS_SPAN_HPP
@@ -0,0 +1,18 @@
+#version 120
+uniform vec4 color;
+uniform vec4 outlineColor;
+uniform float outlineWidth;
+uniform sampler2D texture0;
+varying vec4 exColor;
+varying vec2 exTexCoord;
+void main()
+{
+    float edgeDistance = texture2D(texture0, exTexCoord).a;
+    float smoothing = max(0.7 * fwidth(edgeDistance), 0.001);
+    vec4 fillColor = exColor * color;
+    float fillAlpha = fillColor.a * smoothstep(0.5 - smoothing, 0.5 + smoothing, edgeDistance);
+    float outlineEdge = 0.5 - 0.5 * outlineWidth;
+    float outlineAlpha = outlineColor.a * smoothstep(outlineEdge - smoothing, outlineEdge + smoothing, edgeDistance) * (1.0 - fillAlpha);
+    float alpha = fillAlpha + outlineAlpha;
+    gl_FragColor = vec4((fillColor.rgb * fillAlpha + outlineColor.rgb * outlineAlpha) / max(alpha, 0.001), alpha);
+}
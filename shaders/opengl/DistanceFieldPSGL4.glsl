@@ -0,0 +1,23 @@
+#version 400
+layout(std140) uniform FragmentConstants
+{
+    vec4 color;
+    vec4 outlineColor;
+    float outlineWidth;
+};
+uniform sampler2D texture0;
+in vec4 exColor;
+in vec2 exTexCoord;
+out vec4 outColor;
+void main()
+{
+    vec4 texel = texture(texture0, exTexCoord);
+    float edgeDistance = min(texel.r, texel.a);
+    float smoothing = max(0.7 * fwidth(edgeDistance), 0.001);
+    vec4 fillColor = exColor * color;
+    float fillAlpha = fillColor.a * smoothstep(0.5 - smoothing, 0.5 + smoothing, edgeDistance);
+    float outlineEdge = 0.5 - 0.5 * outlineWidth;
+    float outlineAlpha = outlineColor.a * smoothstep(outlineEdge - smoothing, outlineEdge + smoothing, edgeDistance) * (1.0 - fillAlpha);
+    float alpha = fillAlpha + outlineAlpha;
+    outColor = vec4((fillColor.rgb * fillAlpha + outlineColor.rgb * outlineAlpha) / max(alpha, 0.001), alpha);
+}
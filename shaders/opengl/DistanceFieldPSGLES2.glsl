@@ -0,0 +1,25 @@
+#ifdef GL_OES_standard_derivatives
+#extension GL_OES_standard_derivatives : enable
+#endif
+precision mediump float;
+uniform lowp vec4 color;
+uniform lowp vec4 outlineColor;
+uniform float outlineWidth;
+uniform lowp sampler2D texture0;
+varying lowp vec4 exColor;
+varying vec2 exTexCoord;
+void main()
+{
+    float edgeDistance = texture2D(texture0, exTexCoord).a;
+#ifdef GL_OES_standard_derivatives
+    float smoothing = max(0.7 * fwidth(edgeDistance), 0.001);
+#else
+    float smoothing = 0.05;
+#endif
+    vec4 fillColor = exColor * color;
+    float fillAlpha = fillColor.a * smoothstep(0.5 - smoothing, 0.5 + smoothing, edgeDistance);
+    float outlineEdge = 0.5 - 0.5 * outlineWidth;
+    float outlineAlpha = outlineColor.a * smoothstep(outlineEdge - smoothing, outlineEdge + smoothing, edgeDistance) * (1.0 - fillAlpha);
+    float alpha = fillAlpha + outlineAlpha;
+    gl_FragColor = vec4((fillColor.rgb * fillAlpha + outlineColor.rgb * outlineAlpha) / max(alpha, 0.001), alpha);
+}
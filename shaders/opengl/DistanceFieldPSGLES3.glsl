@@ -0,0 +1,24 @@
+#version 300 es
+precision mediump float;
+layout(std140) uniform FragmentConstants
+{
+    lowp vec4 color;
+    lowp vec4 outlineColor;
+    float outlineWidth;
+};
+uniform lowp sampler2D texture0;
+in lowp vec4 exColor;
+in vec2 exTexCoord;
+out vec4 outColor;
+void main()
+{
+    vec4 texel = texture(texture0, exTexCoord);
+    float edgeDistance = min(texel.r, texel.a);
+    float smoothing = max(0.7 * fwidth(edgeDistance), 0.001);
+    vec4 fillColor = exColor * color;
+    float fillAlpha = fillColor.a * smoothstep(0.5 - smoothing, 0.5 + smoothing, edgeDistance);
+    float outlineEdge = 0.5 - 0.5 * outlineWidth;
+    float outlineAlpha = outlineColor.a * smoothstep(outlineEdge - smoothing, outlineEdge + smoothing, edgeDistance) * (1.0 - fillAlpha);
+    float alpha = fillAlpha + outlineAlpha;
+    outColor = vec4((fillColor.rgb * fillAlpha + outlineColor.rgb * outlineAlpha) / max(alpha, 0.001), alpha);
+}
@@ -0,0 +1,9 @@
+#version 120
+uniform vec4 color;
+uniform sampler2D texture0;
+varying vec4 exColor;
+varying vec2 exTexCoord;
+void main()
+{
+    gl_FragColor = vec4(1.0, 1.0, 1.0, texture2D(texture0, exTexCoord).a) * exColor * color;
+}
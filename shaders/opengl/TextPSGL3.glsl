@@ -0,0 +1,13 @@
+#version 330
+layout(std140) uniform FragmentConstants
+{
+    vec4 color;
+};
+uniform sampler2D texture0;
+in vec4 exColor;
+in vec2 exTexCoord;
+out vec4 outColor;
+void main()
+{
+    outColor = vec4(1.0, 1.0, 1.0, texture(texture0, exTexCoord).r) * exColor * color;
+}
@@ -0,0 +1,9 @@
+precision mediump float;
+uniform lowp vec4 color;
+uniform lowp sampler2D texture0;
+varying lowp vec4 exColor;
+varying vec2 exTexCoord;
+void main()
+{
+    gl_FragColor = vec4(1.0, 1.0, 1.0, texture2D(texture0, exTexCoord).a) * exColor * color;
+}
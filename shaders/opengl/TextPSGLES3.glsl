@@ -0,0 +1,14 @@
+#version 300 es
+precision mediump float;
+layout(std140) uniform FragmentConstants
+{
+    lowp vec4 color;
+};
+uniform lowp sampler2D texture0;
+in lowp vec4 exColor;
+in vec2 exTexCoord;
+out vec4 outColor;
+void main()
+{
+    outColor = vec4(1.0, 1.0, 1.0, texture(texture0, exTexCoord).r) * exColor * color;
+}
@@ -0,0 +1,50 @@
+// Ouzel by Elviss Strazdins
+
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include "Test.hpp"
+#include "assets/AssetId.hpp"
+
+namespace
+{
+    using ouzel::assets::AssetId;
+
+    OUZEL_TEST_CASE(assetIdMatchesFnv1a)
+    {
+        // reference values of the 64-bit FNV-1a
+        static_assert(AssetId{""}.getValue() == 0xCBF29CE484222325ULL);
+        static_assert(AssetId{"a"}.getValue() == 0xAF63DC4C8601EC8CULL);
+        static_assert(AssetId{"foobar"}.getValue() == 0x85944171F73967E8ULL);
+
+        // the ids of runtime strings are the same as the ones computed at compile time
+        const std::string name = "foobar";
+        OUZEL_EXPECT(AssetId{name} == AssetId{"foobar"});
+        OUZEL_EXPECT(AssetId{name} != AssetId{"fooba"});
+    }
+
+    OUZEL_TEST_CASE(assetIdDefaultIsNotTheEmptyName)
+    {
+        OUZEL_EXPECT(AssetId{}.getValue() == 0);
+        OUZEL_EXPECT(AssetId{} != AssetId{""});
+    }
+
+    OUZEL_TEST_CASE(assetIdHashIsTheValue)
+    {
+        const AssetId id{"textures/player.png"};
+        OUZEL_EXPECT(std::hash<AssetId>{}(id) == static_cast<std::size_t>(id.getValue()));
+    }
+
+    OUZEL_TEST_CASE(assetIdDistinctNames)
+    {
+        // names that differ only in a character or in their case don't collide
+        std::unordered_set<AssetId> ids;
+        for (std::size_t i = 0; i < 10000; ++i)
+        {
+            ids.insert(AssetId{"sprite" + std::to_string(i) + ".png"});
+            ids.insert(AssetId{"Sprite" + std::to_string(i) + ".png"});
+        }
+
+        OUZEL_EXPECT(ids.size() == 20000);
+    }
+}
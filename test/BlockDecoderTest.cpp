@@ -0,0 +1,139 @@
+// Ouzel by Elviss Strazdins
+
+#include <cstdint>
+#include <vector>
+#include "Test.hpp"
+#include "graphics/BlockDecoder.hpp"
+#include "graphics/GraphicsError.hpp"
+
+namespace
+{
+    using ouzel::graphics::PixelFormat;
+
+    bool hasPixel(const std::vector<std::uint8_t>& data, std::size_t index,
+                  std::uint8_t red, std::uint8_t green, std::uint8_t blue, std::uint8_t alpha)
+    {
+        return data[index * 4 + 0] == red &&
+            data[index * 4 + 1] == green &&
+            data[index * 4 + 2] == blue &&
+            data[index * 4 + 3] == alpha;
+    }
+
+    OUZEL_TEST_CASE(blockDecoderBc1)
+    {
+        // red and blue endpoints, the rows use the indices 0, 1, 2 and 3
+        const std::vector<std::uint8_t> fourColors{0x00, 0xF8, 0x1F, 0x00, 0x00, 0x55, 0xAA, 0xFF};
+        const auto decoded = ouzel::graphics::decodeLevel(PixelFormat::bc1RgbaUnsignedNorm, 4, 4, fourColors);
+
+        OUZEL_EXPECT(decoded.size() == 4 * 4 * 4);
+        OUZEL_EXPECT(hasPixel(decoded, 0, 255, 0, 0, 255));
+        OUZEL_EXPECT(hasPixel(decoded, 4, 0, 0, 255, 255));
+        OUZEL_EXPECT(hasPixel(decoded, 8, 170, 0, 85, 255));
+        OUZEL_EXPECT(hasPixel(decoded, 12, 85, 0, 170, 255));
+
+        // the first endpoint is smaller, so the fourth color is transparent black
+        const std::vector<std::uint8_t> threeColors{0x1F, 0x00, 0x00, 0xF8, 0x00, 0x55, 0xAA, 0xFF};
+        const auto transparent = ouzel::graphics::decodeLevel(PixelFormat::bc1RgbaUnsignedNorm, 4, 4, threeColors);
+
+        OUZEL_EXPECT(hasPixel(transparent, 8, 128, 0, 128, 255));
+        OUZEL_EXPECT(hasPixel(transparent, 12, 0, 0, 0, 0));
+    }
+
+    OUZEL_TEST_CASE(blockDecoderBc3)
+    {
+        // the alpha block uses the indices 0 and 1 in the first two pixels, the color block is white
+        const std::vector<std::uint8_t> block{
+            0xFF, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00
+        };
+        const auto decoded = ouzel::graphics::decodeLevel(PixelFormat::bc3RgbaUnsignedNorm, 4, 4, block);
+
+        OUZEL_EXPECT(hasPixel(decoded, 0, 255, 255, 255, 255));
+        OUZEL_EXPECT(hasPixel(decoded, 1, 255, 255, 255, 0));
+        OUZEL_EXPECT(hasPixel(decoded, 2, 255, 255, 255, 255));
+    }
+
+    OUZEL_TEST_CASE(blockDecoderBc4AndBc5)
+    {
+        // indices 0, 1, 2 and 7 in the first four pixels
+        const std::vector<std::uint8_t> channel{0xFF, 0x00, 0x88, 0x0E, 0x00, 0x00, 0x00, 0x00};
+        const auto red = ouzel::graphics::decodeLevel(PixelFormat::bc4RUnsignedNorm, 4, 4, channel);
+
+        OUZEL_EXPECT(ouzel::graphics::getDecodedPixelFormat(PixelFormat::bc4RUnsignedNorm) == PixelFormat::r8UnsignedNorm);
+        OUZEL_EXPECT(red.size() == 16);
+        OUZEL_EXPECT(red[0] == 255);
+        OUZEL_EXPECT(red[1] == 0);
+        OUZEL_EXPECT(red[2] == 218);
+        OUZEL_EXPECT(red[3] == 36);
+
+        // the red channel is black, the green channel uses the same block as above
+        const std::vector<std::uint8_t> channels{
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0xFF, 0x00, 0x88, 0x0E, 0x00, 0x00, 0x00, 0x00
+        };
+        const auto redGreen = ouzel::graphics::decodeLevel(PixelFormat::bc5RgUnsignedNorm, 4, 4, channels);
+
+        OUZEL_EXPECT(redGreen.size() == 32);
+        OUZEL_EXPECT(redGreen[0] == 0 && redGreen[1] == 255);
+        OUZEL_EXPECT(redGreen[4] == 0 && redGreen[5] == 218);
+    }
+
+    OUZEL_TEST_CASE(blockDecoderEtc2Modes)
+    {
+        // individual mode with black base colors and the first modifier
+        const std::vector<std::uint8_t> individual(8, 0x00);
+        const auto decodedIndividual = ouzel::graphics::decodeLevel(PixelFormat::etc2RgbUnsignedNorm, 4, 4, individual);
+        OUZEL_EXPECT(hasPixel(decodedIndividual, 0, 2, 2, 2, 255));
+
+        // differential mode with white base colors and the largest negative modifier
+        const std::vector<std::uint8_t> differential{0xF8, 0xF8, 0xF8, 0x02, 0xFF, 0xFF, 0xFF, 0xFF};
+        const auto decodedDifferential = ouzel::graphics::decodeLevel(PixelFormat::etc2RgbUnsignedNorm, 4, 4, differential);
+        OUZEL_EXPECT(hasPixel(decodedDifferential, 15, 247, 247, 247, 255));
+
+        // red overflows in T mode, the second paint color is the second base color plus the distance
+        const std::vector<std::uint8_t> t{0x07, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0xFF};
+        const auto decodedT = ouzel::graphics::decodeLevel(PixelFormat::etc2RgbUnsignedNorm, 4, 4, t);
+        OUZEL_EXPECT(hasPixel(decodedT, 0, 3, 3, 3, 255));
+        OUZEL_EXPECT(hasPixel(decodedT, 2, 51, 0, 0, 255));
+
+        // green overflows in H mode
+        const std::vector<std::uint8_t> h{0x00, 0x07, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00};
+        const auto decodedH = ouzel::graphics::decodeLevel(PixelFormat::etc2RgbUnsignedNorm, 4, 4, h);
+        OUZEL_EXPECT(hasPixel(decodedH, 0, 6, 6, 108, 255));
+
+        // blue overflows in planar mode
+        const std::vector<std::uint8_t> planar{0x00, 0x00, 0x07, 0x02, 0x00, 0x00, 0x00, 0x00};
+        const auto decodedPlanar = ouzel::graphics::decodeLevel(PixelFormat::etc2RgbUnsignedNorm, 4, 4, planar);
+        OUZEL_EXPECT(hasPixel(decodedPlanar, 0, 0, 0, 24, 255));
+        OUZEL_EXPECT(hasPixel(decodedPlanar, 1, 0, 0, 18, 255));
+    }
+
+    OUZEL_TEST_CASE(blockDecoderEtc2Alpha)
+    {
+        // alpha 128 with the multiplier 1 and the modifier -3, followed by an individual mode color block
+        std::vector<std::uint8_t> block{0x80, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+        block.resize(16, 0x00);
+
+        const auto decoded = ouzel::graphics::decodeLevel(PixelFormat::etc2RgbaUnsignedNorm, 4, 4, block);
+        OUZEL_EXPECT(hasPixel(decoded, 0, 2, 2, 2, 125));
+        OUZEL_EXPECT(hasPixel(decoded, 15, 2, 2, 2, 125));
+    }
+
+    OUZEL_TEST_CASE(blockDecoderCropsEdgeBlocks)
+    {
+        // a 6x2 level has two blocks, the pixels outside of the level are dropped
+        const std::vector<std::uint8_t> blocks{
+            0x00, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+        };
+        const auto decoded = ouzel::graphics::decodeLevel(PixelFormat::bc1RgbaUnsignedNorm, 6, 2, blocks);
+
+        OUZEL_EXPECT(decoded.size() == 6 * 2 * 4);
+        OUZEL_EXPECT(hasPixel(decoded, 3, 255, 0, 0, 255));
+        OUZEL_EXPECT(hasPixel(decoded, 4, 0, 0, 255, 255));
+        OUZEL_EXPECT(hasPixel(decoded, 11, 0, 0, 255, 255));
+
+        OUZEL_EXPECT_THROW(ouzel::graphics::decodeLevel(PixelFormat::bc1RgbaUnsignedNorm, 12, 2, blocks), ouzel::graphics::Error);
+        OUZEL_EXPECT(!ouzel::graphics::isDecodable(PixelFormat::bc7RgbaUnsignedNorm));
+    }
+}
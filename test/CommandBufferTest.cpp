@@ -0,0 +1,263 @@
+// Ouzel by Elviss Strazdins
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "Test.hpp"
+#include "graphics/Commands.hpp"
+
+namespace
+{
+    using ouzel::graphics::Command;
+    using ouzel::graphics::CommandBuffer;
+    using ouzel::graphics::DeleteResourceCommand;
+    using ouzel::graphics::DrawCommand;
+    using ouzel::graphics::SetBufferDataCommand;
+
+    void pushBufferData(CommandBuffer& commandBuffer, ouzel::graphics::ResourceId buffer, std::size_t size)
+    {
+        std::vector<std::uint8_t> data(size);
+        for (std::size_t i = 0; i < size; ++i)
+            data[i] = static_cast<std::uint8_t>(buffer + i);
+
+        commandBuffer.pushCommand<SetBufferDataCommand>(buffer, ouzel::Span<const std::uint8_t>{data.data(), data.size()});
+    }
+
+    bool hasBufferData(const Command* command, ouzel::graphics::ResourceId buffer, std::size_t size)
+    {
+        if (command->type != Command::Type::setBufferData) return false;
+
+        const auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command);
+        if (setBufferDataCommand->buffer != buffer) return false;
+
+        const auto data = setBufferDataCommand->getData();
+        if (data.size() != size) return false;
+
+        for (std::size_t i = 0; i < size; ++i)
+            if (data[i] != static_cast<std::uint8_t>(buffer + i)) return false;
+
+        return true;
+    }
+
+    OUZEL_TEST_CASE(commandBufferCrossesBlocksInOrder)
+    {
+        CommandBuffer commandBuffer;
+
+        // enough commands to fill several blocks
+        constexpr std::size_t count = CommandBuffer::blockSize / 8;
+        for (std::size_t i = 0; i < count; ++i)
+            commandBuffer.pushCommand<DeleteResourceCommand>(i);
+
+        OUZEL_EXPECT(commandBuffer.getCommandCount() == count);
+        OUZEL_EXPECT(commandBuffer.getBlockCount() > 1);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto command = commandBuffer.popCommand();
+            OUZEL_EXPECT(command->type == Command::Type::deleteResource);
+            OUZEL_EXPECT(static_cast<const DeleteResourceCommand*>(command)->resource == i);
+        }
+
+        OUZEL_EXPECT(commandBuffer.isEmpty());
+    }
+
+    OUZEL_TEST_CASE(commandBufferOversizedCommands)
+    {
+        CommandBuffer commandBuffer;
+
+        pushBufferData(commandBuffer, 1, 16);
+        pushBufferData(commandBuffer, 2, CommandBuffer::blockSize * 2);
+        pushBufferData(commandBuffer, 3, 16);
+        pushBufferData(commandBuffer, 4, CommandBuffer::blockSize + 1);
+        pushBufferData(commandBuffer, 5, CommandBuffer::blockSize + 1);
+
+        OUZEL_EXPECT(hasBufferData(commandBuffer.popCommand(), 1, 16));
+        OUZEL_EXPECT(hasBufferData(commandBuffer.popCommand(), 2, CommandBuffer::blockSize * 2));
+        OUZEL_EXPECT(hasBufferData(commandBuffer.popCommand(), 3, 16));
+        OUZEL_EXPECT(hasBufferData(commandBuffer.popCommand(), 4, CommandBuffer::blockSize + 1));
+        OUZEL_EXPECT(hasBufferData(commandBuffer.popCommand(), 5, CommandBuffer::blockSize + 1));
+        OUZEL_EXPECT(commandBuffer.isEmpty());
+    }
+
+    OUZEL_TEST_CASE(commandBufferReusesBlocksAfterOversizedCommands)
+    {
+        CommandBuffer commandBuffer;
+
+        // the first frame allocates two regular blocks
+        for (std::size_t i = 0; i < CommandBuffer::blockSize / 8; ++i)
+            commandBuffer.pushCommand<DeleteResourceCommand>(i);
+        commandBuffer.clear();
+
+        const auto blockCount = commandBuffer.getBlockCount();
+
+        // the empty blocks after an oversized command are used by the following commands
+        for (int frame = 0; frame < 10; ++frame)
+        {
+            pushBufferData(commandBuffer, 1, 16);
+            pushBufferData(commandBuffer, 2, CommandBuffer::blockSize + 1);
+            pushBufferData(commandBuffer, 3, 16);
+
+            OUZEL_EXPECT(hasBufferData(commandBuffer.popCommand(), 1, 16));
+            OUZEL_EXPECT(hasBufferData(commandBuffer.popCommand(), 2, CommandBuffer::blockSize + 1));
+            OUZEL_EXPECT(hasBufferData(commandBuffer.popCommand(), 3, 16));
+
+            commandBuffer.clear();
+            OUZEL_EXPECT(commandBuffer.getBlockCount() == blockCount);
+        }
+    }
+
+    OUZEL_TEST_CASE(commandBufferMoveLeavesAnEmptyBuffer)
+    {
+        CommandBuffer commandBuffer;
+        commandBuffer.pushCommand<DeleteResourceCommand>(1);
+
+        CommandBuffer other{std::move(commandBuffer)};
+        OUZEL_EXPECT(commandBuffer.isEmpty());
+        OUZEL_EXPECT(commandBuffer.getBlockCount() == 0);
+        OUZEL_EXPECT(other.getCommandCount() == 1);
+
+        // the moved from buffer can be used again
+        commandBuffer.pushCommand<DeleteResourceCommand>(2);
+        OUZEL_EXPECT(static_cast<const DeleteResourceCommand*>(commandBuffer.popCommand())->resource == 2);
+        OUZEL_EXPECT(static_cast<const DeleteResourceCommand*>(other.popCommand())->resource == 1);
+    }
+
+    OUZEL_TEST_CASE(commandBufferAppendKeepsTheOrder)
+    {
+        CommandBuffer first;
+        CommandBuffer second;
+
+        first.pushCommand<DeleteResourceCommand>(1);
+        pushBufferData(first, 2, CommandBuffer::blockSize + 1);
+        for (std::size_t i = 3; i < CommandBuffer::blockSize / 8; ++i)
+            second.pushCommand<DeleteResourceCommand>(i);
+
+        first.append(std::move(second));
+        OUZEL_EXPECT(second.isEmpty());
+        OUZEL_EXPECT(second.getBlockCount() == 0);
+
+        // commands pushed after the merge follow the appended ones
+        pushBufferData(first, 1, 16);
+
+        OUZEL_EXPECT(static_cast<const DeleteResourceCommand*>(first.popCommand())->resource == 1);
+        OUZEL_EXPECT(hasBufferData(first.popCommand(), 2, CommandBuffer::blockSize + 1));
+        for (std::size_t i = 3; i < CommandBuffer::blockSize / 8; ++i)
+            OUZEL_EXPECT(static_cast<const DeleteResourceCommand*>(first.popCommand())->resource == i);
+        OUZEL_EXPECT(hasBufferData(first.popCommand(), 1, 16));
+        OUZEL_EXPECT(first.isEmpty());
+    }
+
+    // the commands as they were stored before the arena, each one allocated separately and
+    // destroyed through the virtual destructor of the base class
+    namespace baseline
+    {
+        class Command
+        {
+        public:
+            explicit Command(ouzel::graphics::Command::Type initType) noexcept: type{initType} {}
+            virtual ~Command() = default;
+
+            const ouzel::graphics::Command::Type type;
+        };
+
+        class DeleteResourceCommand final: public Command
+        {
+        public:
+            explicit DeleteResourceCommand(ouzel::graphics::ResourceId initResource) noexcept:
+                Command{ouzel::graphics::Command::Type::deleteResource},
+                resource{initResource}
+            {
+            }
+
+            const ouzel::graphics::ResourceId resource;
+        };
+
+        class DrawCommand final: public Command
+        {
+        public:
+            DrawCommand(ouzel::graphics::ResourceId initIndexBuffer,
+                        std::uint32_t initIndexCount,
+                        std::uint32_t initIndexSize,
+                        ouzel::graphics::ResourceId initVertexBuffer,
+                        ouzel::graphics::DrawMode initDrawMode,
+                        std::uint32_t initStartIndex) noexcept:
+                Command{ouzel::graphics::Command::Type::draw},
+                indexBuffer{initIndexBuffer},
+                indexCount{initIndexCount},
+                indexSize{initIndexSize},
+                vertexBuffer{initVertexBuffer},
+                drawMode{initDrawMode},
+                startIndex{initStartIndex}
+            {
+            }
+
+            const ouzel::graphics::ResourceId indexBuffer;
+            const std::uint32_t indexCount;
+            const std::uint32_t indexSize;
+            const ouzel::graphics::ResourceId vertexBuffer;
+            const ouzel::graphics::DrawMode drawMode;
+            const std::uint32_t startIndex;
+        };
+    }
+
+    template <class F>
+    void reportRate(const char* name, std::size_t count, std::size_t iterations, F function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) function();
+        const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << name << ": " << static_cast<double>(count * iterations) / duration << " commands/s\n";
+    }
+
+    // records a frame of draw calls with a resource deletion after every fourth one and reads it back
+    OUZEL_BENCHMARK(commandBufferBenchmark)
+    {
+        constexpr std::size_t count = 100000;
+        constexpr std::size_t iterations = 100;
+        std::uint64_t checksum = 0;
+
+        CommandBuffer commandBuffer;
+        reportRate("arena", count, iterations, [&commandBuffer, &checksum]() {
+            for (std::size_t i = 0; i < count; ++i)
+                if (i % 4 == 3)
+                    commandBuffer.pushCommand<DeleteResourceCommand>(i);
+                else
+                    commandBuffer.pushCommand<DrawCommand>(1, static_cast<std::uint32_t>(i), 2, 2,
+                                                           ouzel::graphics::DrawMode::triangleList, 0);
+
+            while (!commandBuffer.isEmpty())
+            {
+                const auto command = commandBuffer.popCommand();
+                if (command->type == Command::Type::draw)
+                    checksum += static_cast<const DrawCommand*>(command)->indexCount;
+                else
+                    checksum += static_cast<const DeleteResourceCommand*>(command)->resource;
+            }
+
+            commandBuffer.clear();
+        });
+
+        std::vector<std::unique_ptr<baseline::Command>> commands;
+        reportRate("std::vector<std::unique_ptr<Command>>", count, iterations, [&commands, &checksum]() {
+            for (std::size_t i = 0; i < count; ++i)
+                if (i % 4 == 3)
+                    commands.push_back(std::make_unique<baseline::DeleteResourceCommand>(i));
+                else
+                    commands.push_back(std::make_unique<baseline::DrawCommand>(1, static_cast<std::uint32_t>(i), 2, 2,
+                                                                               ouzel::graphics::DrawMode::triangleList, 0));
+
+            for (const auto& command : commands)
+                if (command->type == Command::Type::draw)
+                    checksum += static_cast<const baseline::DrawCommand*>(command.get())->indexCount;
+                else
+                    checksum += static_cast<const baseline::DeleteResourceCommand*>(command.get())->resource;
+
+            commands.clear();
+        });
+
+        OUZEL_EXPECT(checksum != 0);
+    }
+}
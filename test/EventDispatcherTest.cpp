@@ -0,0 +1,103 @@
+// Ouzel by Elviss Strazdins
+
+#include "Test.hpp"
+#include "events/EventDispatcher.hpp"
+#include "events/EventHandler.hpp"
+
+namespace
+{
+    ouzel::UserEvent makeUserEvent()
+    {
+        ouzel::UserEvent event;
+        event.type = ouzel::Event::Type::user;
+        return event;
+    }
+
+    OUZEL_TEST_CASE(eventHandlerAssignedBeforeAdding)
+    {
+        ouzel::EventDispatcher eventDispatcher;
+        ouzel::EventHandler eventHandler;
+
+        std::size_t count = 0;
+        eventHandler.userHandler = [&count](const ouzel::UserEvent&) { ++count; return false; };
+        eventDispatcher.addEventHandler(eventHandler);
+
+        eventDispatcher.postEvent(makeUserEvent());
+        eventDispatcher.dispatchEvents();
+
+        OUZEL_EXPECT(count == 1);
+    }
+
+    OUZEL_TEST_CASE(eventHandlerAssignedAfterAdding)
+    {
+        ouzel::EventDispatcher eventDispatcher;
+        ouzel::EventHandler eventHandler;
+
+        std::size_t keyboardCount = 0;
+        std::size_t userCount = 0;
+        eventHandler.keyboardHandler = [&keyboardCount](const ouzel::KeyboardEvent&) { ++keyboardCount; return false; };
+        eventDispatcher.addEventHandler(eventHandler);
+        eventDispatcher.dispatchEvents();
+
+        // the handler is already listed under the keyboard category
+        eventHandler.userHandler = [&userCount](const ouzel::UserEvent&) { ++userCount; return false; };
+        eventHandler.keyboardHandler = [&keyboardCount](const ouzel::KeyboardEvent&) { keyboardCount += 10; return false; };
+
+        ouzel::KeyboardEvent keyboardEvent;
+        keyboardEvent.type = ouzel::Event::Type::keyboardKeyPress;
+        eventDispatcher.postEvent(keyboardEvent);
+        eventDispatcher.postEvent(makeUserEvent());
+        eventDispatcher.dispatchEvents();
+
+        OUZEL_EXPECT(userCount == 1);
+        OUZEL_EXPECT(keyboardCount == 10);
+    }
+
+    OUZEL_TEST_CASE(eventHandlerClearedAfterAdding)
+    {
+        ouzel::EventDispatcher eventDispatcher;
+        ouzel::EventHandler first{1};
+        ouzel::EventHandler second;
+
+        std::size_t firstCount = 0;
+        std::size_t secondCount = 0;
+        first.userHandler = [&firstCount](const ouzel::UserEvent&) { ++firstCount; return true; };
+        second.userHandler = [&secondCount](const ouzel::UserEvent&) { ++secondCount; return true; };
+        eventDispatcher.addEventHandler(first);
+        eventDispatcher.addEventHandler(second);
+
+        // the handler with the higher priority consumes the event
+        eventDispatcher.postEvent(makeUserEvent());
+        eventDispatcher.dispatchEvents();
+        OUZEL_EXPECT(firstCount == 1 && secondCount == 0);
+
+        first.userHandler = nullptr;
+        eventDispatcher.postEvent(makeUserEvent());
+        eventDispatcher.dispatchEvents();
+        OUZEL_EXPECT(firstCount == 1 && secondCount == 1);
+
+        // assigned again, the handler goes back to its place by priority
+        first.userHandler = [&firstCount](const ouzel::UserEvent&) { ++firstCount; return true; };
+        eventDispatcher.postEvent(makeUserEvent());
+        eventDispatcher.dispatchEvents();
+        OUZEL_EXPECT(firstCount == 2 && secondCount == 1);
+    }
+
+    OUZEL_TEST_CASE(eventHandlerRemovedWhileDispatching)
+    {
+        ouzel::EventDispatcher eventDispatcher;
+        ouzel::EventHandler first{1};
+        ouzel::EventHandler second;
+
+        std::size_t secondCount = 0;
+        first.userHandler = [&second](const ouzel::UserEvent&) { second.remove(); return false; };
+        second.userHandler = [&secondCount](const ouzel::UserEvent&) { ++secondCount; return false; };
+        eventDispatcher.addEventHandler(first);
+        eventDispatcher.addEventHandler(second);
+
+        eventDispatcher.postEvent(makeUserEvent());
+        eventDispatcher.dispatchEvents();
+
+        OUZEL_EXPECT(secondCount == 0);
+    }
+}
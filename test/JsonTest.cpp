@@ -0,0 +1,209 @@
+// Ouzel by Elviss Strazdins
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "Test.hpp"
+#include "formats/Json.hpp"
+
+namespace
+{
+    using ouzel::json::Document;
+    using ouzel::json::ParseError;
+    using ouzel::json::RangeError;
+
+    // counts the tokens, so that a reader that stops early would be noticed
+    class TokenCounter final
+    {
+    public:
+        void null() { ++count; }
+        void boolean(bool) { ++count; }
+        void integer(std::int64_t) { ++count; }
+        void number(double) { ++count; }
+        void string(std::string_view) { ++count; }
+        void key(std::string_view) { ++count; }
+        void beginObject() { ++count; }
+        void endObject() { ++count; }
+        void beginArray() { ++count; }
+        void endArray() { ++count; }
+
+        std::size_t count = 0;
+    };
+
+    // the contiguous, the non-contiguous and the in-place parsing must all reject the data
+    template <class Exception>
+    bool rejects(const std::string_view data)
+    {
+        const auto throws = [](const auto& function) {
+            try
+            {
+                function();
+            }
+            catch (const Exception&)
+            {
+                return true;
+            }
+            return false;
+        };
+
+        const std::string contiguous{data};
+        const std::deque<char> nonContiguous(data.begin(), data.end());
+
+        return throws([&contiguous]() { (void)ouzel::json::parse(contiguous); }) &&
+            throws([&nonContiguous]() { (void)ouzel::json::parse(nonContiguous); }) &&
+            throws([&contiguous]() { TokenCounter counter; ouzel::json::read(contiguous, counter); }) &&
+            throws([&nonContiguous]() { TokenCounter counter; ouzel::json::read(nonContiguous, counter); }) &&
+            throws([&contiguous]() { Document document{contiguous}; });
+    }
+
+    OUZEL_TEST_CASE(jsonValidInput)
+    {
+        const std::string data = R"({"a": [1, -2.5e1, "x\nyé😀", true, false, null], "b": {}})";
+
+        TokenCounter counter;
+        ouzel::json::read(data, counter);
+        OUZEL_EXPECT(counter.count == 14);
+
+        const auto value = ouzel::json::parse(data);
+        OUZEL_EXPECT(value["a"][1].as<double>() == -25.0);
+        OUZEL_EXPECT(value["a"][2].as<std::string>() == "x\ny\xC3\xA9\xF0\x9F\x98\x80");
+
+        const Document document{data};
+        const auto root = document.getRoot();
+        OUZEL_EXPECT(root["a"].getSize() == 6);
+        OUZEL_EXPECT(root["a"][0].as<int>() == 1);
+        OUZEL_EXPECT(root["a"][2].as<std::string_view>() == "x\ny\xC3\xA9\xF0\x9F\x98\x80");
+        OUZEL_EXPECT(root["b"].isEmpty());
+    }
+
+    OUZEL_TEST_CASE(jsonTruncatedInput)
+    {
+        OUZEL_EXPECT(rejects<ParseError>(""));
+        OUZEL_EXPECT(rejects<ParseError>("   "));
+        OUZEL_EXPECT(rejects<ParseError>("{"));
+        OUZEL_EXPECT(rejects<ParseError>("["));
+        OUZEL_EXPECT(rejects<ParseError>("{\"a\""));
+        OUZEL_EXPECT(rejects<ParseError>("{\"a\":"));
+        OUZEL_EXPECT(rejects<ParseError>("{\"a\":1"));
+        OUZEL_EXPECT(rejects<ParseError>("[1, 2"));
+        OUZEL_EXPECT(rejects<ParseError>("[1,"));
+        OUZEL_EXPECT(rejects<ParseError>("\"abc"));
+        OUZEL_EXPECT(rejects<ParseError>("\"abc\\"));
+        OUZEL_EXPECT(rejects<ParseError>("\"\\u12"));
+        OUZEL_EXPECT(rejects<ParseError>("tru"));
+        OUZEL_EXPECT(rejects<ParseError>("-"));
+        OUZEL_EXPECT(rejects<ParseError>("1."));
+        OUZEL_EXPECT(rejects<ParseError>("1e"));
+        OUZEL_EXPECT(rejects<ParseError>("1e+"));
+    }
+
+    OUZEL_TEST_CASE(jsonBadEscapes)
+    {
+        OUZEL_EXPECT(rejects<ParseError>(R"("\x")"));
+        OUZEL_EXPECT(rejects<ParseError>(R"("\u12G4")"));
+        OUZEL_EXPECT(rejects<ParseError>(R"("\ud83d\u0041")"));
+        OUZEL_EXPECT(rejects<ParseError>(R"(["a\"])"));
+        OUZEL_EXPECT(rejects<ParseError>("\"a\nb\""));
+        OUZEL_EXPECT(rejects<ParseError>("\"a\\n\tb\""));
+    }
+
+    OUZEL_TEST_CASE(jsonTrailingCommas)
+    {
+        OUZEL_EXPECT(rejects<ParseError>("[1,]"));
+        OUZEL_EXPECT(rejects<ParseError>("[,]"));
+        OUZEL_EXPECT(rejects<ParseError>("[1,,2]"));
+        OUZEL_EXPECT(rejects<ParseError>(R"({"a":1,})"));
+        OUZEL_EXPECT(rejects<ParseError>(R"({,})"));
+    }
+
+    OUZEL_TEST_CASE(jsonUnbalancedBrackets)
+    {
+        OUZEL_EXPECT(rejects<ParseError>("]"));
+        OUZEL_EXPECT(rejects<ParseError>("}"));
+        OUZEL_EXPECT(rejects<ParseError>("[}"));
+        OUZEL_EXPECT(rejects<ParseError>("{]"));
+        OUZEL_EXPECT(rejects<ParseError>("[[1]"));
+        OUZEL_EXPECT(rejects<ParseError>("[1]]"));
+        OUZEL_EXPECT(rejects<ParseError>(R"({"a":[1}})"));
+        OUZEL_EXPECT(rejects<ParseError>(R"({"a":{"b":1}]})"));
+        OUZEL_EXPECT(rejects<ParseError>("[1] [2]"));
+    }
+
+    OUZEL_TEST_CASE(jsonInvalidTokens)
+    {
+        OUZEL_EXPECT(rejects<ParseError>("{a:1}"));
+        OUZEL_EXPECT(rejects<ParseError>(R"({"a" 1})"));
+        OUZEL_EXPECT(rejects<ParseError>("[1 2]"));
+        OUZEL_EXPECT(rejects<ParseError>("[nul]"));
+        OUZEL_EXPECT(rejects<ParseError>("[True]"));
+        OUZEL_EXPECT(rejects<ParseError>("['a']"));
+        OUZEL_EXPECT(rejects<ParseError>("[+1]"));
+        OUZEL_EXPECT(rejects<ParseError>("[-a]"));
+        OUZEL_EXPECT(rejects<RangeError>("[9223372036854775808]"));
+        OUZEL_EXPECT(rejects<RangeError>("[-9223372036854775809]"));
+    }
+
+    // an indented array of objects similar to the scene and the sprite assets
+    std::string generateDocument(std::size_t objectCount)
+    {
+        std::string result = "[\n";
+        for (std::size_t i = 0; i < objectCount; ++i)
+        {
+            const auto index = std::to_string(i);
+            result += "    {\n"
+                "        \"name\": \"node_" + index + "\",\n"
+                "        \"position\": [" + index + ", -" + index + ".25, 0.5e2],\n"
+                "        \"scale\": 1.5,\n"
+                "        \"visible\": true,\n"
+                "        \"parent\": null,\n"
+                "        \"tags\": [\"sprite\", \"static\"],\n"
+                "        \"children\": {}\n"
+                "    }";
+            result += (i + 1 < objectCount) ? ",\n" : "\n";
+        }
+        result += "]\n";
+        return result;
+    }
+
+    template <class F>
+    void reportThroughput(const char* name, std::size_t size, std::size_t iterations, F function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) function();
+        const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << name << ": " << static_cast<double>(size * iterations) / duration / (1024.0 * 1024.0) << " MB/s\n";
+    }
+
+    OUZEL_BENCHMARK(jsonBenchmark)
+    {
+        constexpr std::size_t objectCount = 100000;
+        constexpr std::size_t iterations = 10;
+        const auto data = generateDocument(objectCount);
+        std::size_t tokenCount = 0;
+        std::size_t valueCount = 0;
+
+        reportThroughput("json::read", data.size(), iterations, [&data, &tokenCount]() {
+            TokenCounter counter;
+            ouzel::json::read(data, counter);
+            tokenCount += counter.count;
+        });
+
+        reportThroughput("json::parse", data.size(), iterations, [&data, &valueCount]() {
+            const auto value = ouzel::json::parse(data);
+            valueCount += value.getSize();
+        });
+
+        reportThroughput("json::Document", data.size(), iterations, [&data, &valueCount]() {
+            const Document document{data};
+            valueCount += document.getRoot().getSize();
+        });
+
+        // 24 tokens for every object and two for the array
+        OUZEL_EXPECT(tokenCount == iterations * (objectCount * 24 + 2));
+        OUZEL_EXPECT(valueCount == iterations * objectCount * 2);
+    }
+}
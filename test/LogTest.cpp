@@ -0,0 +1,106 @@
+// Ouzel by Elviss Strazdins
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Test.hpp"
+#include "utils/Log.hpp"
+
+namespace
+{
+    struct BinaryLogMessage final
+    {
+        std::uint32_t threadIndex;
+        std::string text;
+    };
+
+    std::uint64_t readLittleEndian(const std::vector<char>& data, std::size_t& offset, std::size_t size)
+    {
+        std::uint64_t result = 0;
+        for (std::size_t i = 0; i < size; ++i)
+            result |= std::uint64_t{static_cast<std::uint8_t>(data[offset + i])} << (i * 8);
+        offset += size;
+        return result;
+    }
+
+    std::vector<BinaryLogMessage> readBinaryLog(const char* path)
+    {
+        std::ifstream file{path, std::ios::binary};
+        const std::vector<char> data{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+        std::vector<BinaryLogMessage> result;
+        if (data.size() < 12 || std::string(data.data(), 8) != "OUZELLOG") return result;
+
+        for (std::size_t offset = 12; offset + 17 <= data.size();)
+        {
+            readLittleEndian(data, offset, 8); // time
+            const auto threadIndex = static_cast<std::uint32_t>(readLittleEndian(data, offset, 4));
+            readLittleEndian(data, offset, 1); // level
+            const auto size = static_cast<std::size_t>(readLittleEndian(data, offset, 4));
+            if (offset + size > data.size()) break;
+
+            result.push_back(BinaryLogMessage{threadIndex, std::string(data.data() + offset, size)});
+            offset += size;
+        }
+
+        return result;
+    }
+
+    OUZEL_TEST_CASE(loggerWritesEveryAsyncMessage)
+    {
+        constexpr const char* path = "LogTest.bin";
+        constexpr std::size_t threadCount = 4;
+        constexpr std::size_t messageCount = 32;
+
+        std::remove(path);
+
+        {
+            // every thread can buffer all of its messages, so none of them are dropped
+            ouzel::Logger logger{ouzel::Log::Level::all};
+            logger.startAsync(messageCount, path);
+
+            std::vector<std::thread> threads;
+            for (std::size_t t = 0; t < threadCount; ++t)
+                threads.emplace_back([&logger, t]() {
+                    for (std::size_t i = 0; i < messageCount; ++i)
+                        logger.log(std::to_string(t) + " " + std::to_string(i), ouzel::Log::Level::all);
+                });
+
+            for (auto& thread : threads) thread.join();
+
+            logger.stopAsync();
+            OUZEL_EXPECT(logger.getDroppedCount() == 0);
+        }
+
+        const auto messages = readBinaryLog(path);
+        std::remove(path);
+
+        OUZEL_EXPECT(messages.size() == threadCount * messageCount);
+
+        // the messages of every thread are in the order they were logged
+        std::vector<std::size_t> nextMessages(threadCount);
+        std::vector<std::uint32_t> threadIndices(threadCount);
+        for (const auto& message : messages)
+        {
+            const auto separator = message.text.find(' ');
+            OUZEL_EXPECT(separator != std::string::npos);
+
+            const auto t = std::stoul(message.text.substr(0, separator));
+            const auto i = std::stoul(message.text.substr(separator + 1));
+            OUZEL_EXPECT(t < threadCount);
+            OUZEL_EXPECT(i == nextMessages[t]);
+            ++nextMessages[t];
+
+            // every thread has its own index
+            if (threadIndices[t] == 0) threadIndices[t] = message.threadIndex;
+            OUZEL_EXPECT(message.threadIndex == threadIndices[t]);
+        }
+
+        for (const auto nextMessage : nextMessages)
+            OUZEL_EXPECT(nextMessage == messageCount);
+    }
+}
@@ -0,0 +1,98 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "Test.hpp"
+#include "core/WorkerPool.hpp"
+#include "graphics/Mipmaps.hpp"
+
+namespace
+{
+    using ouzel::graphics::PixelFormat;
+    using ouzel::graphics::generateMipmaps;
+
+    OUZEL_TEST_CASE(mipmapsGenerateTheWholeChain)
+    {
+        ouzel::core::WorkerPool workerPool;
+
+        // a uniform image stays the same on every level
+        const ouzel::math::Size<std::uint32_t, 2> size{64, 16};
+        std::vector<std::uint8_t> data(64 * 16 * 4);
+        for (std::size_t i = 0; i < data.size(); i += 4)
+        {
+            data[i + 0] = 200;
+            data[i + 1] = 100;
+            data[i + 2] = 50;
+            data[i + 3] = 255;
+        }
+
+        const auto levels = generateMipmaps(size, data, 0, PixelFormat::rgba8UnsignedNorm, workerPool);
+        OUZEL_EXPECT(levels.size() == 7);
+
+        std::uint32_t width = 64;
+        std::uint32_t height = 16;
+        for (const auto& level : levels)
+        {
+            OUZEL_EXPECT(level.first.v[0] == width);
+            OUZEL_EXPECT(level.first.v[1] == height);
+            OUZEL_EXPECT(level.second.size() == std::size_t{width} * height * 4);
+
+            for (std::size_t i = 0; i < level.second.size(); i += 4)
+            {
+                OUZEL_EXPECT(level.second[i + 0] == 200);
+                OUZEL_EXPECT(level.second[i + 1] == 100);
+                OUZEL_EXPECT(level.second[i + 2] == 50);
+                OUZEL_EXPECT(level.second[i + 3] == 255);
+            }
+
+            width = std::max(width / 2, 1U);
+            height = std::max(height / 2, 1U);
+        }
+
+        OUZEL_EXPECT(generateMipmaps(size, data, 3, PixelFormat::rgba8UnsignedNorm, workerPool).size() == 3);
+    }
+
+    OUZEL_TEST_CASE(mipmapsAverageInLinearSpace)
+    {
+        ouzel::core::WorkerPool workerPool;
+
+        // black and white pixels average to the middle gray of the linear space, not to 128
+        const ouzel::math::Size<std::uint32_t, 2> size{2, 2};
+        const std::vector<std::uint8_t> data{
+            0, 0, 0, 255, 255, 255, 255, 255,
+            255, 255, 255, 255, 0, 0, 0, 255
+        };
+
+        const auto levels = generateMipmaps(size, data, 0, PixelFormat::rgba8UnsignedNorm, workerPool);
+        OUZEL_EXPECT(levels.size() == 2);
+        OUZEL_EXPECT(levels[1].second[0] == 186); // std::round(std::pow(0.5, 1.0 / 2.2) * 255.0)
+        OUZEL_EXPECT(levels[1].second[3] == 255);
+    }
+
+    OUZEL_BENCHMARK(mipmapsBenchmark)
+    {
+        constexpr std::uint32_t width = 4096;
+        constexpr std::uint32_t height = 4096;
+        constexpr std::size_t iterations = 5;
+
+        ouzel::core::WorkerPool workerPool;
+
+        std::vector<std::uint8_t> data(std::size_t{width} * height * 4);
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<std::uint8_t>(i * 7 + i / 4096);
+
+        std::size_t levelCount = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+            levelCount += generateMipmaps(ouzel::math::Size<std::uint32_t, 2>{width, height}, data, 0,
+                                          PixelFormat::rgba8UnsignedNorm, workerPool).size();
+        const auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "4096x4096 RGBA8 mip chain: " << duration / iterations << " ms\n";
+
+        OUZEL_EXPECT(levelCount == iterations * 13);
+    }
+}
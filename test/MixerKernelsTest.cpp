@@ -0,0 +1,214 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Test.hpp"
+#include "audio/mixer/Kernels.hpp"
+
+namespace
+{
+    using namespace ouzel::audio::mixer;
+
+    // counts that are not multiples of the vector width, so that the scalar tails are tested too
+    constexpr std::uint32_t counts[] = {0, 1, 3, 4, 5, 7, 8, 13, 1001};
+
+    std::vector<float> makeSamples(std::size_t count, float offset = 0.0F)
+    {
+        std::vector<float> samples(count);
+        for (std::size_t i = 0; i < count; ++i)
+            samples[i] = std::sin(static_cast<float>(i) * 0.37F + offset);
+        return samples;
+    }
+
+    bool isNear(const std::vector<float>& a, const std::vector<float>& b, float epsilon = 1e-6F)
+    {
+        if (a.size() != b.size()) return false;
+
+        for (std::size_t i = 0; i < a.size(); ++i)
+            if (std::fabs(a[i] - b[i]) > epsilon) return false;
+
+        return true;
+    }
+
+    OUZEL_TEST_CASE(mixerMix)
+    {
+        for (const auto count : counts)
+        {
+            const auto source = makeSamples(count);
+            auto destination = makeSamples(count, 1.0F);
+            auto expected = destination;
+            auto expectedGain = destination;
+            auto destinationGain = destination;
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                expected[i] += source[i];
+                expectedGain[i] += source[i] * 0.3F;
+            }
+
+            mix(source.data(), destination.data(), count);
+            mix(source.data(), 0.3F, destinationGain.data(), count);
+
+            OUZEL_EXPECT(isNear(destination, expected));
+            OUZEL_EXPECT(isNear(destinationGain, expectedGain));
+        }
+    }
+
+    OUZEL_TEST_CASE(mixerScale)
+    {
+        for (const auto count : counts)
+        {
+            const auto source = makeSamples(count);
+            std::vector<float> destination(count);
+            std::vector<float> expected(count);
+
+            for (std::size_t i = 0; i < count; ++i)
+                expected[i] = source[i] * -0.7F;
+
+            scale(source.data(), -0.7F, destination.data(), count);
+            OUZEL_EXPECT(isNear(destination, expected));
+        }
+    }
+
+    OUZEL_TEST_CASE(mixerConvertToInt16)
+    {
+        for (const auto count : counts)
+        {
+            // out of range samples are clamped
+            auto source = makeSamples(count);
+            for (auto& sample : source) sample *= 1.5F;
+
+            std::vector<std::int16_t> destination(count);
+            std::vector<std::int16_t> expected(count);
+
+            for (std::size_t i = 0; i < count; ++i)
+                expected[i] = static_cast<std::int16_t>(std::clamp(source[i], -1.0F, 1.0F) * 32767.0F);
+
+            convertToInt16(source.data(), destination.data(), count);
+            OUZEL_EXPECT(destination == expected);
+        }
+
+        const float limits[] = {-2.0F, -1.0F, 0.0F, 1.0F, 2.0F};
+        std::int16_t converted[5];
+        convertToInt16(limits, converted, 5);
+        OUZEL_EXPECT(converted[0] == -32767);
+        OUZEL_EXPECT(converted[1] == -32767);
+        OUZEL_EXPECT(converted[2] == 0);
+        OUZEL_EXPECT(converted[3] == 32767);
+        OUZEL_EXPECT(converted[4] == 32767);
+    }
+
+    OUZEL_TEST_CASE(mixerInterleave)
+    {
+        for (std::uint32_t channels = 1; channels <= 3; ++channels)
+            for (const auto frames : counts)
+            {
+                const auto planar = makeSamples(channels * frames);
+                std::vector<float> interleaved(channels * frames);
+                std::vector<float> expected(channels * frames);
+
+                for (std::uint32_t frame = 0; frame < frames; ++frame)
+                    for (std::uint32_t channel = 0; channel < channels; ++channel)
+                        expected[frame * channels + channel] = planar[channel * frames + frame];
+
+                interleave(planar.data(), channels, frames, interleaved.data());
+                OUZEL_EXPECT(interleaved == expected);
+
+                // deinterleaving restores the planar samples
+                std::vector<float> result(channels * frames);
+                deinterleave(interleaved.data(), channels, frames, result.data());
+                OUZEL_EXPECT(result == planar);
+            }
+    }
+
+    std::vector<float> resampleReference(const std::vector<float>& source, std::uint32_t frames)
+    {
+        const auto sourceFrames = static_cast<std::uint32_t>(source.size());
+        std::vector<float> result(frames);
+        if (frames == 0) return result;
+
+        if (sourceFrames < 2)
+        {
+            std::fill(result.begin(), result.end(), sourceFrames ? source[0] : 0.0F);
+            return result;
+        }
+
+        const auto increment = (frames > 1) ? static_cast<float>(sourceFrames - 1) / static_cast<float>(frames - 1) : 0.0F;
+
+        for (std::uint32_t frame = 0; frame + 1 < frames; ++frame)
+        {
+            const auto position = static_cast<float>(frame) * increment;
+            const auto index = std::min(static_cast<std::uint32_t>(position), sourceFrames - 2);
+            const auto fraction = position - static_cast<float>(index);
+            result[frame] = source[index] + (source[index + 1] - source[index]) * fraction;
+        }
+
+        result[frames - 1] = source[sourceFrames - 1];
+        return result;
+    }
+
+    OUZEL_TEST_CASE(mixerResample)
+    {
+        for (const auto sourceFrames : counts)
+            for (const auto frames : counts)
+            {
+                const auto source = makeSamples(sourceFrames);
+                std::vector<float> destination(frames);
+
+                resample(source.data(), sourceFrames, destination.data(), frames);
+                OUZEL_EXPECT(isNear(destination, resampleReference(source, frames), 1e-5F));
+
+                // the first and the last frames are aligned with the ones of the source
+                if (frames > 1 && sourceFrames > 0)
+                {
+                    OUZEL_EXPECT(destination.front() == source.front());
+                    OUZEL_EXPECT(destination.back() == source.back());
+                }
+            }
+
+        // resampling to the same rate copies the samples
+        const auto source = makeSamples(13);
+        std::vector<float> destination(13);
+        resample(source.data(), 13, destination.data(), 13);
+        OUZEL_EXPECT(isNear(destination, source, 1e-5F));
+    }
+
+    OUZEL_TEST_CASE(mixerConvertChannels)
+    {
+        // stereo to mono, mono to stereo and a channel that is not written
+        const float stereoToMono[] = {0.5F, 0.5F};
+        const float monoToStereo[] = {1.0F, 0.25F};
+        const float stereoToThree[] = {1.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F};
+
+        for (const auto frames : counts)
+        {
+            const auto stereo = makeSamples(2 * frames);
+            const auto mono = makeSamples(frames, 2.0F);
+
+            std::vector<float> monoResult(frames);
+            std::vector<float> monoExpected(frames);
+            for (std::uint32_t frame = 0; frame < frames; ++frame)
+                monoExpected[frame] = stereo[frame] * 0.5F + stereo[frames + frame] * 0.5F;
+            convertChannels(stereo.data(), 2, monoResult.data(), 1, frames, stereoToMono);
+            OUZEL_EXPECT(isNear(monoResult, monoExpected));
+
+            std::vector<float> stereoResult(2 * frames);
+            std::vector<float> stereoExpected(2 * frames);
+            for (std::uint32_t frame = 0; frame < frames; ++frame)
+            {
+                stereoExpected[frame] = mono[frame];
+                stereoExpected[frames + frame] = mono[frame] * 0.25F;
+            }
+            convertChannels(mono.data(), 1, stereoResult.data(), 2, frames, monoToStereo);
+            OUZEL_EXPECT(isNear(stereoResult, stereoExpected));
+
+            std::vector<float> threeResult(3 * frames, 1.0F);
+            std::vector<float> threeExpected(3 * frames, 0.0F);
+            std::copy(stereo.begin(), stereo.end(), threeExpected.begin());
+            convertChannels(stereo.data(), 2, threeResult.data(), 3, frames, stereoToThree);
+            OUZEL_EXPECT(threeResult == threeExpected);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+// Ouzel by Elviss Strazdins
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "Test.hpp"
+#include "audio/mixer/Object.hpp"
+
+namespace
+{
+    using namespace ouzel::audio::mixer;
+
+    class TestObject final: public Object
+    {
+    public:
+        auto getParent() const noexcept { return parent; }
+        auto getChildCount() const noexcept { return children.size(); }
+        auto getChildCapacity() const noexcept { return children.capacity(); }
+    };
+
+    OUZEL_TEST_CASE(mixerObjectReservesTheChildren)
+    {
+        TestObject object;
+        OUZEL_EXPECT(object.getChildCapacity() >= Object::maxChildren);
+    }
+
+    OUZEL_TEST_CASE(mixerObjectRejectsChildrenPastTheCapacity)
+    {
+        TestObject oldParent;
+        TestObject object;
+        std::vector<std::unique_ptr<TestObject>> children;
+
+        for (std::size_t i = 0; i < Object::maxChildren; ++i)
+        {
+            children.push_back(std::make_unique<TestObject>());
+            OUZEL_EXPECT(object.addChild(*children.back()));
+        }
+
+        const auto capacity = object.getChildCapacity();
+
+        TestObject child;
+        oldParent.addChild(child);
+        OUZEL_EXPECT(!object.addChild(child));
+        OUZEL_EXPECT(object.getChildCount() == Object::maxChildren);
+        OUZEL_EXPECT(object.getChildCapacity() == capacity);
+
+        // the rejected child stays attached to its old parent
+        OUZEL_EXPECT(child.getParent() == &oldParent);
+        OUZEL_EXPECT(oldParent.getChildCount() == 1);
+
+        // adding a child that is already attached does not need room
+        OUZEL_EXPECT(object.addChild(*children.front()));
+        OUZEL_EXPECT(object.getChildCount() == Object::maxChildren);
+
+        object.removeChild(*children.front());
+        OUZEL_EXPECT(object.addChild(child));
+        OUZEL_EXPECT(child.getParent() == &object);
+        OUZEL_EXPECT(oldParent.getChildCount() == 0);
+    }
+}
@@ -0,0 +1,158 @@
+// Ouzel by Elviss Strazdins
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "Test.hpp"
+#include "audio/mixer/Bus.hpp"
+#include "audio/mixer/Commands.hpp"
+#include "audio/mixer/Data.hpp"
+#include "audio/mixer/Mixer.hpp"
+#include "audio/mixer/Stream.hpp"
+
+namespace
+{
+    using namespace ouzel::audio::mixer;
+
+    constexpr std::uint32_t bufferSize = 512;
+    constexpr std::uint32_t channels = 2;
+    constexpr std::uint32_t sampleRate = 44100;
+    constexpr std::size_t voiceCount = 128;
+
+    // a voice whose every sample is the same value, or a sine wave if the frequency is not zero
+    class ToneData final: public Data
+    {
+    public:
+        ToneData(std::uint32_t initChannels, std::uint32_t initSampleRate, float initAmplitude, float initFrequency):
+            Data{initChannels, initSampleRate},
+            amplitude{initAmplitude},
+            frequency{initFrequency}
+        {
+        }
+
+        std::unique_ptr<Stream> createStream() override;
+
+        const float amplitude;
+        const float frequency;
+    };
+
+    class ToneStream final: public Stream
+    {
+    public:
+        explicit ToneStream(ToneData& toneData):
+            Stream{toneData}
+        {
+        }
+
+        void reset() override
+        {
+            position = 0;
+        }
+
+        void generateSamples(std::uint32_t frames, ouzel::Span<float> samples) override
+        {
+            const auto& toneData = static_cast<const ToneData&>(data);
+            const auto step = 6.2831853F * toneData.frequency / static_cast<float>(toneData.getSampleRate());
+
+            for (std::uint32_t channel = 0; channel < toneData.getChannels(); ++channel)
+                for (std::uint32_t frame = 0; frame < frames; ++frame)
+                    samples[channel * frames + frame] = (toneData.frequency == 0.0F) ?
+                        toneData.amplitude :
+                        toneData.amplitude * std::sin(step * static_cast<float>(position + frame));
+
+            position += frames;
+        }
+
+    private:
+        std::uint32_t position = 0;
+    };
+
+    std::unique_ptr<Stream> ToneData::createStream()
+    {
+        return std::make_unique<ToneStream>(*this);
+    }
+
+    // builds the graph the way Audio does: every voice is a stream of its own data and the voices
+    // are split between submix buses, because a bus takes at most 64 inputs
+    void initVoices(Mixer& mixer, float amplitude, float frequency)
+    {
+        constexpr std::size_t submixCount = 4;
+
+        CommandBuffer commandBuffer;
+
+        // a data object and a stream for every voice, the buses and the root object
+        const auto objectCount = voiceCount * 2 + submixCount + 2;
+        if (objectCount > Mixer::initialObjectCapacity)
+            commandBuffer.pushCommand(std::make_unique<ReserveObjectsCommand>(objectCount));
+
+        const auto masterBusId = mixer.getObjectId();
+        commandBuffer.pushCommand(std::make_unique<InitBusCommand>(masterBusId, std::make_unique<Bus>(bufferSize, channels)));
+        commandBuffer.pushCommand(std::make_unique<SetMasterBusCommand>(masterBusId));
+
+        std::vector<Mixer::ObjectId> submixBusIds;
+        for (std::size_t i = 0; i < submixCount; ++i)
+        {
+            const auto busId = mixer.getObjectId();
+            commandBuffer.pushCommand(std::make_unique<InitBusCommand>(busId, std::make_unique<Bus>(bufferSize, channels)));
+            commandBuffer.pushCommand(std::make_unique<SetBusOutputCommand>(busId, masterBusId));
+            submixBusIds.push_back(busId);
+        }
+
+        for (std::size_t i = 0; i < voiceCount; ++i)
+        {
+            // every other voice is a mono voice at a lower sample rate, so that it is resampled and upmixed
+            auto data = (i % 2 == 0) ?
+                std::make_unique<ToneData>(1, sampleRate / 2, amplitude, frequency) :
+                std::make_unique<ToneData>(channels, sampleRate, amplitude, frequency);
+            auto stream = data->createStream();
+            stream->reserve(bufferSize, channels, sampleRate);
+
+            const auto dataId = mixer.getObjectId();
+            const auto streamId = mixer.getObjectId();
+            commandBuffer.pushCommand(std::make_unique<InitDataCommand>(dataId, std::move(data)));
+            commandBuffer.pushCommand(std::make_unique<InitStreamCommand>(streamId, std::move(stream)));
+            commandBuffer.pushCommand(std::make_unique<SetStreamOutputCommand>(streamId, submixBusIds[i % submixCount]));
+            commandBuffer.pushCommand(std::make_unique<PlayStreamCommand>(streamId));
+        }
+
+        OUZEL_EXPECT(mixer.submitCommandBuffer(std::move(commandBuffer)));
+    }
+
+    OUZEL_TEST_CASE(mixerMixesAllVoices)
+    {
+        Mixer mixer{bufferSize, channels, sampleRate};
+        initVoices(mixer, 1.0F / 256.0F, 0.0F);
+
+        // a block larger than the buffer size is mixed in parts
+        std::vector<float> samples(bufferSize * 3 * channels);
+        mixer.getSamples(bufferSize * 3, ouzel::Span<float>{samples.data(), samples.size()});
+
+        for (const auto sample : samples)
+            OUZEL_EXPECT(std::fabs(sample - 0.5F) < 1e-5F);
+    }
+
+    // renders a few seconds of a 128-voice mix in the blocks an audio device without a backend
+    // (the empty driver) would ask for and reports how much faster than real time it was
+    OUZEL_BENCHMARK(mixerVoicesBenchmark)
+    {
+        constexpr std::uint32_t seconds = 10;
+
+        Mixer mixer{bufferSize, channels, sampleRate};
+        initVoices(mixer, 1.0F / 256.0F, 440.0F);
+
+        std::vector<float> samples(bufferSize * channels);
+        const ouzel::Span<float> span{samples.data(), samples.size()};
+
+        const auto start = std::chrono::steady_clock::now();
+        for (std::uint32_t frames = 0; frames < seconds * sampleRate; frames += bufferSize)
+            mixer.getSamples(bufferSize, span);
+        const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << voiceCount << " voices: " << seconds / duration << "x real time\n";
+
+        mixer.releaseCommandBuffers();
+    }
+}
@@ -0,0 +1,251 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+#include "Test.hpp"
+#include "scene/Particles.hpp"
+
+namespace
+{
+    using ouzel::scene::Particles;
+
+    constexpr float step = 1.0F / 60.0F;
+
+    void fill(Particles& particles, std::size_t count)
+    {
+        particles.resize(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto value = static_cast<float>(i);
+            particles.life[i] = 1.0F + value * 0.01F;
+            // every third particle is on an axis, which enables the radial acceleration
+            particles.positionX[i] = (i % 3 == 0) ? 0.0F : std::sin(value) * 100.0F;
+            particles.positionY[i] = std::cos(value) * 100.0F;
+            particles.colorRed[i] = 0.5F;
+            particles.colorGreen[i] = 0.25F;
+            particles.colorBlue[i] = 1.0F;
+            particles.colorAlpha[i] = 1.0F;
+            particles.deltaColorRed[i] = 0.1F;
+            particles.deltaColorGreen[i] = -0.1F;
+            particles.deltaColorBlue[i] = -0.5F;
+            particles.deltaColorAlpha[i] = -1.0F;
+            particles.size[i] = 10.0F;
+            particles.deltaSize[i] = -value;
+            particles.rotation[i] = value;
+            particles.deltaRotation[i] = 90.0F;
+            particles.directionX[i] = std::cos(value * 0.5F) * 50.0F;
+            particles.directionY[i] = std::sin(value * 0.5F) * 50.0F;
+            particles.radialAcceleration[i] = 5.0F;
+            particles.tangentialAcceleration[i] = -3.0F;
+            particles.angle[i] = value * 0.1F;
+            particles.radius[i] = 50.0F + value;
+            particles.degreesPerSecond[i] = 2.0F;
+            particles.deltaRadius[i] = -5.0F;
+        }
+    }
+
+    // the update of a single particle before the particles were stored as a structure of arrays
+    void simulateReference(Particles& p, std::size_t i, bool gravityEmitter,
+                           const ouzel::math::Vector<float, 2>& gravity, bool yCoordFlipped)
+    {
+        const float yFactor = yCoordFlipped ? 1.0F : -1.0F;
+
+        p.life[i] -= step;
+
+        if (gravityEmitter)
+        {
+            float radialX = 0.0F;
+            float radialY = 0.0F;
+
+            if (p.positionX[i] == 0.0F || p.positionY[i] == 0.0F)
+            {
+                const auto length = std::sqrt(p.positionX[i] * p.positionX[i] + p.positionY[i] * p.positionY[i]);
+                if (length > 0.0F)
+                {
+                    radialX = p.positionX[i] / length;
+                    radialY = p.positionY[i] / length;
+                }
+            }
+
+            const auto tangentialX = -radialY * p.radialAcceleration[i] * p.tangentialAcceleration[i];
+            const auto tangentialY = radialX * p.radialAcceleration[i] * p.tangentialAcceleration[i];
+
+            p.directionX[i] += (radialX + tangentialX + gravity.v[0]) * step;
+            p.directionY[i] += (radialY + tangentialY + gravity.v[1]) * step;
+            p.positionX[i] += p.directionX[i] * step * yFactor;
+            p.positionY[i] += p.directionY[i] * step * yFactor;
+        }
+        else
+        {
+            p.angle[i] += p.degreesPerSecond[i] * step;
+            p.radius[i] += p.deltaRadius[i] * step;
+            p.positionX[i] = -std::cos(p.angle[i]) * p.radius[i];
+            p.positionY[i] = -std::sin(p.angle[i]) * p.radius[i] * yFactor;
+        }
+
+        p.colorRed[i] += p.deltaColorRed[i] * step;
+        p.colorGreen[i] += p.deltaColorGreen[i] * step;
+        p.colorBlue[i] += p.deltaColorBlue[i] * step;
+        p.colorAlpha[i] += p.deltaColorAlpha[i] * step;
+        p.size[i] = std::max(0.0F, p.size[i] + p.deltaSize[i] * step);
+        p.rotation[i] += p.deltaRotation[i] * step;
+    }
+
+    bool isNear(const std::vector<float>& a, const std::vector<float>& b, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            if (std::fabs(a[i] - b[i]) > 1e-3F * std::max(1.0F, std::fabs(b[i]))) return false;
+
+        return true;
+    }
+
+    OUZEL_TEST_CASE(particlesSimulationMatchesReference)
+    {
+        const ouzel::math::Vector<float, 2> gravity{3.0F, -9.8F};
+
+        for (const auto gravityEmitter : {true, false})
+            for (const auto yCoordFlipped : {true, false})
+            {
+                // not a multiple of the lane count
+                constexpr std::size_t count = 13;
+
+                Particles particles;
+                fill(particles, count);
+                Particles expected = particles;
+
+                for (int frame = 0; frame < 30; ++frame)
+                {
+                    particles.simulate(0, count, step, gravityEmitter, gravity, yCoordFlipped);
+                    for (std::size_t i = 0; i < count; ++i)
+                        simulateReference(expected, i, gravityEmitter, gravity, yCoordFlipped);
+                }
+
+                OUZEL_EXPECT(isNear(particles.life, expected.life, count));
+                OUZEL_EXPECT(isNear(particles.positionX, expected.positionX, count));
+                OUZEL_EXPECT(isNear(particles.positionY, expected.positionY, count));
+                OUZEL_EXPECT(isNear(particles.directionX, expected.directionX, count));
+                OUZEL_EXPECT(isNear(particles.directionY, expected.directionY, count));
+                OUZEL_EXPECT(isNear(particles.colorRed, expected.colorRed, count));
+                OUZEL_EXPECT(isNear(particles.colorAlpha, expected.colorAlpha, count));
+                OUZEL_EXPECT(isNear(particles.size, expected.size, count));
+                OUZEL_EXPECT(isNear(particles.rotation, expected.rotation, count));
+            }
+    }
+
+    OUZEL_TEST_CASE(particlesMoveAndPadding)
+    {
+        Particles particles;
+        fill(particles, 5);
+
+        // the arrays are padded to a multiple of the lane count
+        OUZEL_EXPECT(particles.life.size() == 8);
+        OUZEL_EXPECT(particles.deltaRadius.size() == 8);
+
+        particles.move(4, 1);
+        OUZEL_EXPECT(particles.life[1] == particles.life[4]);
+        OUZEL_EXPECT(particles.positionY[1] == particles.positionY[4]);
+        OUZEL_EXPECT(particles.deltaRadius[1] == particles.deltaRadius[4]);
+    }
+
+    OUZEL_TEST_CASE(particlesVerticesOfTheRangeOnly)
+    {
+        constexpr std::size_t count = 7;
+
+        Particles particles;
+        fill(particles, count);
+
+        // colors out of the [0, 1] range are clamped
+        particles.colorRed[0] = 2.0F;
+        particles.colorGreen[0] = -1.0F;
+
+        std::vector<ouzel::graphics::Vertex> vertices(8 * 4);
+        const ouzel::graphics::Vertex sentinel{ouzel::math::Vector<float, 3>{-1.0F, -1.0F, -1.0F}, ouzel::math::Color{},
+                                               ouzel::math::Vector<float, 2>{}, ouzel::math::Vector<float, 3>{}};
+        std::fill(vertices.begin(), vertices.end(), sentinel);
+
+        particles.generateVertices(0, count, vertices.data(), ouzel::math::Vector<float, 2>{10.0F, 20.0F}, 1.0F);
+
+        OUZEL_EXPECT(vertices[0].color.v[0] == 255);
+        OUZEL_EXPECT(vertices[0].color.v[1] == 0);
+
+        // the corners are around the offset position of the particle
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            float centerX = 0.0F;
+            float centerY = 0.0F;
+            for (std::size_t corner = 0; corner < 4; ++corner)
+            {
+                centerX += vertices[i * 4 + corner].position.v[0] / 4.0F;
+                centerY += vertices[i * 4 + corner].position.v[1] / 4.0F;
+            }
+
+            OUZEL_EXPECT(std::fabs(centerX - (particles.positionX[i] + 10.0F)) < 1e-3F);
+            OUZEL_EXPECT(std::fabs(centerY - (particles.positionY[i] + 20.0F)) < 1e-3F);
+        }
+
+        // the vertices of the padding are not written
+        for (std::size_t i = count * 4; i < vertices.size(); ++i)
+            OUZEL_EXPECT(vertices[i].position.v[0] == -1.0F);
+    }
+
+    template <class F>
+    void reportRate(const char* name, std::size_t count, std::size_t iterations, F function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) function();
+        const auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << name << ": " << static_cast<double>(count * iterations) / duration << " particles/ms\n";
+    }
+
+    OUZEL_BENCHMARK(particlesSimulationBenchmark)
+    {
+        constexpr std::size_t count = 100000;
+        constexpr std::size_t iterations = 200;
+        const ouzel::math::Vector<float, 2> gravity{0.0F, -9.8F};
+
+        Particles particles;
+
+        // the old path updates one particle at a time
+        fill(particles, count);
+        reportRate("gravity emitter (per particle)", count, iterations, [&particles, &gravity]() {
+            for (std::size_t i = 0; i < count; ++i)
+                simulateReference(particles, i, true, gravity, false);
+        });
+
+        fill(particles, count);
+        reportRate("gravity emitter", count, iterations, [&particles, &gravity]() {
+            particles.simulate(0, count, step, true, gravity, false);
+        });
+
+        fill(particles, count);
+        reportRate("radius emitter (per particle)", count, iterations, [&particles, &gravity]() {
+            for (std::size_t i = 0; i < count; ++i)
+                simulateReference(particles, i, false, gravity, false);
+        });
+
+        fill(particles, count);
+        reportRate("radius emitter", count, iterations, [&particles, &gravity]() {
+            particles.simulate(0, count, step, false, gravity, false);
+        });
+    }
+
+    OUZEL_BENCHMARK(particlesVertexBenchmark)
+    {
+        constexpr std::size_t count = 100000;
+        constexpr std::size_t iterations = 200;
+
+        Particles particles;
+        fill(particles, count);
+
+        std::vector<ouzel::graphics::Vertex> vertices(count * 4);
+        reportRate("vertex generation", count, iterations, [&particles, &vertices]() {
+            particles.generateVertices(0, count, vertices.data(), ouzel::math::Vector<float, 2>{}, 1.0F);
+        });
+    }
+}
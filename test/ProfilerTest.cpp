@@ -0,0 +1,62 @@
+// Ouzel by Elviss Strazdins
+
+#include <set>
+#include <string>
+#include <thread>
+#include "Test.hpp"
+#include "utils/Profiler.hpp"
+
+namespace
+{
+    std::set<std::string> getThreadIds(const std::string& trace)
+    {
+        std::set<std::string> result;
+        const std::string key = "\"tid\":";
+        for (auto position = trace.find(key); position != std::string::npos; position = trace.find(key, position + 1))
+        {
+            const auto start = position + key.size();
+            result.insert(trace.substr(start, trace.find_first_not_of("0123456789", start) - start));
+        }
+        return result;
+    }
+
+    OUZEL_TEST_CASE(profilerReusesTracksOfExitedThreads)
+    {
+        ouzel::Profiler testProfiler;
+        testProfiler.setRecording(true);
+
+        // the tracks are used only on the spawned threads, which exit before the profiler is destroyed
+        for (int i = 0; i < 100; ++i)
+            std::thread{[&testProfiler]() {
+                testProfiler.addSample("sample", ouzel::Profiler::now(), 1000);
+            }}.join();
+
+        const auto trace = testProfiler.getChromeTrace();
+        OUZEL_EXPECT(getThreadIds(trace) == std::set<std::string>{"1"});
+        OUZEL_EXPECT(testProfiler.getLastDuration("sample") == 1000);
+    }
+
+    OUZEL_TEST_CASE(profilerKeepsTracksOfRunningThreads)
+    {
+        ouzel::Profiler testProfiler;
+        testProfiler.setRecording(true);
+
+        const auto record = [&testProfiler]() {
+            testProfiler.setThreadName("Worker");
+            testProfiler.addSample("sample", ouzel::Profiler::now(), 1000);
+        };
+
+        std::thread first{record};
+        first.join();
+
+        // the second thread gets the track of the first one, the third one needs a new track
+        std::thread second{[&testProfiler, &record]() {
+            record();
+            std::thread{record}.join();
+        }};
+        second.join();
+
+        const auto trace = testProfiler.getChromeTrace();
+        OUZEL_EXPECT(getThreadIds(trace) == (std::set<std::string>{"1", "2"}));
+    }
+}
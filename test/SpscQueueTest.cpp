@@ -0,0 +1,121 @@
+// Ouzel by Elviss Strazdins
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "Test.hpp"
+#include "thread/SpscQueue.hpp"
+
+namespace
+{
+    OUZEL_TEST_CASE(spscQueueRejectsZeroCapacity)
+    {
+        OUZEL_EXPECT_THROW(ouzel::thread::SpscQueue<int>{0}, std::invalid_argument);
+    }
+
+    OUZEL_TEST_CASE(spscQueueEmpty)
+    {
+        ouzel::thread::SpscQueue<int> queue{4};
+        int value = 0;
+
+        OUZEL_EXPECT(queue.getSize() == 0);
+        OUZEL_EXPECT(!queue.tryPop(value));
+
+        // an interrupted pop on an empty queue returns without a value
+        queue.interrupt();
+        OUZEL_EXPECT(!queue.pop(value));
+        OUZEL_EXPECT(queue.getSize() == 0);
+    }
+
+    OUZEL_TEST_CASE(spscQueueFull)
+    {
+        ouzel::thread::SpscQueue<std::unique_ptr<int>> queue{3};
+
+        for (int i = 0; i < 3; ++i)
+            OUZEL_EXPECT(queue.tryPush(std::make_unique<int>(i)));
+
+        OUZEL_EXPECT(queue.getSize() == queue.getCapacity());
+
+        // the value that didn't fit is left intact
+        auto value = std::make_unique<int>(3);
+        OUZEL_EXPECT(!queue.tryPush(std::move(value)));
+        OUZEL_EXPECT(value && *value == 3);
+
+        const auto start = std::chrono::steady_clock::now();
+        OUZEL_EXPECT(!queue.push(std::move(value), std::chrono::milliseconds{20}));
+        OUZEL_EXPECT(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds{20});
+        OUZEL_EXPECT(value && *value == 3);
+
+        std::unique_ptr<int> result;
+        OUZEL_EXPECT(queue.tryPop(result) && *result == 0);
+        OUZEL_EXPECT(queue.push(std::move(value), std::chrono::milliseconds{20}));
+
+        for (int i = 1; i < 4; ++i)
+            OUZEL_EXPECT(queue.tryPop(result) && *result == i);
+
+        OUZEL_EXPECT(!queue.tryPop(result));
+    }
+
+    OUZEL_TEST_CASE(spscQueueWrapsAroundInOrder)
+    {
+        ouzel::thread::SpscQueue<std::uint32_t> queue{5};
+        std::uint32_t next = 0;
+        std::uint32_t expected = 0;
+
+        for (std::uint32_t round = 0; round < 100; ++round)
+        {
+            while (queue.tryPush(std::uint32_t{next})) ++next;
+
+            std::uint32_t value;
+            for (std::uint32_t i = 0; i <= round % 5; ++i)
+            {
+                OUZEL_EXPECT(queue.tryPop(value));
+                OUZEL_EXPECT(value == expected++);
+            }
+        }
+    }
+
+    OUZEL_TEST_CASE(spscQueueBlocksBetweenThreads)
+    {
+        constexpr std::uint32_t count = 100000;
+        ouzel::thread::SpscQueue<std::uint32_t> queue{8};
+
+        std::thread producer{[&queue]() {
+            for (std::uint32_t i = 0; i < count; ++i)
+                queue.push(std::uint32_t{i});
+        }};
+
+        bool ordered = true;
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            std::uint32_t value;
+            while (!queue.pop(value)) {}
+            if (value != i) ordered = false;
+        }
+
+        producer.join();
+
+        OUZEL_EXPECT(ordered);
+        OUZEL_EXPECT(queue.getSize() == 0);
+    }
+
+    OUZEL_TEST_CASE(spscQueueTimedPushWaitsForTheConsumer)
+    {
+        ouzel::thread::SpscQueue<int> queue{1};
+        OUZEL_EXPECT(queue.tryPush(1));
+
+        std::thread consumer{[&queue]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+            int value;
+            queue.pop(value);
+        }};
+
+        const bool pushed = queue.push(2, std::chrono::seconds{10});
+        consumer.join();
+
+        int value = 0;
+        OUZEL_EXPECT(pushed);
+        OUZEL_EXPECT(queue.tryPop(value) && value == 2);
+    }
+}
@@ -0,0 +1,69 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_TEST_TEST_HPP
+#define OUZEL_TEST_TEST_HPP
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ouzel::test
+{
+    class TestError final: public std::logic_error
+    {
+    public:
+        using std::logic_error::logic_error;
+    };
+
+    using TestFunction = void(*)();
+
+    struct TestCase final
+    {
+        const char* name;
+        TestFunction function;
+        bool benchmark;
+    };
+
+    inline std::vector<TestCase>& getTestCases()
+    {
+        static std::vector<TestCase> testCases;
+        return testCases;
+    }
+
+    class Registration final
+    {
+    public:
+        Registration(const char* name, TestFunction function, bool benchmark = false)
+        {
+            getTestCases().push_back(TestCase{name, function, benchmark});
+        }
+    };
+
+    inline void expect(bool condition, const char* expression, const char* file, int line)
+    {
+        if (!condition)
+            throw TestError{std::string{file} + ":" + std::to_string(line) + ": " + expression};
+    }
+}
+
+#define OUZEL_TEST_CASE(name) \
+    static void name(); \
+    static const ouzel::test::Registration name##Registration{#name, &name}; \
+    static void name()
+
+// benchmarks are run only if the test executable is started with the "benchmark" argument
+#define OUZEL_BENCHMARK(name) \
+    static void name(); \
+    static const ouzel::test::Registration name##Registration{#name, &name, true}; \
+    static void name()
+
+#define OUZEL_EXPECT(condition) ouzel::test::expect((condition), #condition, __FILE__, __LINE__)
+
+#define OUZEL_EXPECT_THROW(expression, Exception) \
+    do { \
+        bool thrown = false; \
+        try { expression; } catch (const Exception&) { thrown = true; } \
+        ouzel::test::expect(thrown, #expression " throws " #Exception, __FILE__, __LINE__); \
+    } while (false)
+
+#endif // OUZEL_TEST_TEST_HPP
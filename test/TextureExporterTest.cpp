@@ -0,0 +1,95 @@
+// Ouzel by Elviss Strazdins
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "Test.hpp"
+#include "TextureExporter.hpp"
+#include "graphics/BlockDecoder.hpp"
+
+namespace
+{
+    ouzel::texture::Level createGradient(std::uint32_t width, std::uint32_t height)
+    {
+        ouzel::texture::Level level;
+        level.width = width;
+        level.height = height;
+
+        for (std::uint32_t y = 0; y < height; ++y)
+            for (std::uint32_t x = 0; x < width; ++x)
+            {
+                level.data.push_back(static_cast<std::uint8_t>(x * 255 / (width - 1)));
+                level.data.push_back(static_cast<std::uint8_t>(y * 255 / (height - 1)));
+                level.data.push_back(static_cast<std::uint8_t>(128));
+                level.data.push_back(static_cast<std::uint8_t>((x + y) * 255 / (width + height - 2)));
+            }
+
+        return level;
+    }
+
+    std::uint32_t getMaxError(const std::vector<std::uint8_t>& original,
+                              const std::vector<std::uint8_t>& decoded,
+                              std::size_t channel)
+    {
+        std::uint32_t maxError = 0;
+        for (std::size_t i = channel; i < original.size(); i += 4)
+            maxError = std::max(maxError, static_cast<std::uint32_t>(std::abs(original[i] - decoded[i])));
+        return maxError;
+    }
+
+    OUZEL_TEST_CASE(textureExporterEtc2RoundTrip)
+    {
+        // odd sizes have partial blocks on the right and bottom edges
+        const auto level = createGradient(37, 21);
+
+        const auto compressed = ouzel::texture::compress(level, ouzel::texture::Format::etc2Rgb);
+        OUZEL_EXPECT(compressed.data.size() == 10 * 6 * 8);
+
+        const auto decoded = ouzel::graphics::decodeLevel(ouzel::graphics::PixelFormat::etc2RgbUnsignedNorm,
+                                                          level.width, level.height, compressed.data);
+
+        for (std::size_t channel = 0; channel < 3; ++channel)
+            OUZEL_EXPECT(getMaxError(level.data, decoded, channel) <= 24);
+    }
+
+    OUZEL_TEST_CASE(textureExporterEtc2AlphaRoundTrip)
+    {
+        const auto level = createGradient(16, 16);
+
+        const auto compressed = ouzel::texture::compress(level, ouzel::texture::Format::etc2Rgba);
+        OUZEL_EXPECT(compressed.data.size() == 4 * 4 * 16);
+
+        const auto decoded = ouzel::graphics::decodeLevel(ouzel::graphics::PixelFormat::etc2RgbaUnsignedNorm,
+                                                          level.width, level.height, compressed.data);
+
+        for (std::size_t channel = 0; channel < 3; ++channel)
+            OUZEL_EXPECT(getMaxError(level.data, decoded, channel) <= 24);
+
+        OUZEL_EXPECT(getMaxError(level.data, decoded, 3) <= 4);
+    }
+
+    OUZEL_TEST_CASE(textureExporterBc3RoundTrip)
+    {
+        const auto level = createGradient(16, 16);
+
+        const auto compressed = ouzel::texture::compress(level, ouzel::texture::Format::bc3);
+        const auto decoded = ouzel::graphics::decodeLevel(ouzel::graphics::PixelFormat::bc3RgbaUnsignedNorm,
+                                                          level.width, level.height, compressed.data);
+
+        // the palette of a BC block lies on a line, so the red and green gradients can't both be exact
+        for (std::size_t channel = 0; channel < 3; ++channel)
+            OUZEL_EXPECT(getMaxError(level.data, decoded, channel) <= 32);
+
+        OUZEL_EXPECT(getMaxError(level.data, decoded, 3) <= 4);
+    }
+
+    OUZEL_TEST_CASE(textureExporterMobileFormats)
+    {
+        using ouzel::texture::Format;
+        using ouzel::texture::getFormat;
+
+        OUZEL_EXPECT(getFormat(ouzel::Platform::android, true) == Format::etc2Rgb);
+        OUZEL_EXPECT(getFormat(ouzel::Platform::iOs, false) == Format::etc2Rgba);
+        OUZEL_EXPECT(getFormat(ouzel::Platform::emscripten, true) == Format::rgba8);
+    }
+}
@@ -0,0 +1,184 @@
+// Ouzel by Elviss Strazdins
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Test.hpp"
+#include "core/UpdateScheduler.hpp"
+#include "core/WorkerPool.hpp"
+
+namespace
+{
+    using ouzel::core::UpdatePhase;
+    using ouzel::core::UpdateScheduler;
+    using ouzel::core::Updater;
+    using ouzel::core::WorkerPool;
+
+    // the time steps are powers of two, so that the accumulated time is exact
+    OUZEL_TEST_CASE(updateSchedulerRunsTheFixedStepsOfTheFrame)
+    {
+        WorkerPool workerPool;
+        UpdateScheduler scheduler{workerPool};
+        scheduler.setFixedTimeStep(0.25F);
+
+        std::vector<float> deltas;
+        Updater updater{UpdatePhase::fixed};
+        updater.function = [&deltas](float delta) { deltas.push_back(delta); };
+        scheduler.addUpdater(updater);
+
+        scheduler.update(0.625F);
+        OUZEL_EXPECT(deltas.size() == 2);
+        OUZEL_EXPECT(scheduler.getFixedStepAlpha() == 0.5F);
+
+        // the remainder of the previous frame completes a step
+        scheduler.update(0.125F);
+        OUZEL_EXPECT(deltas.size() == 3);
+        OUZEL_EXPECT(scheduler.getFixedStepAlpha() == 0.0F);
+
+        scheduler.update(0.0625F);
+        OUZEL_EXPECT(deltas.size() == 3);
+        OUZEL_EXPECT(scheduler.getFixedStepAlpha() == 0.25F);
+
+        for (const auto delta : deltas)
+            OUZEL_EXPECT(delta == 0.25F);
+    }
+
+    OUZEL_TEST_CASE(updateSchedulerRunsTheFixedPhaseOnceWithoutAStep)
+    {
+        WorkerPool workerPool;
+        UpdateScheduler scheduler{workerPool};
+
+        std::vector<float> deltas;
+        Updater updater{UpdatePhase::fixed};
+        updater.function = [&deltas](float delta) { deltas.push_back(delta); };
+        scheduler.addUpdater(updater);
+
+        scheduler.update(0.5F);
+        scheduler.update(0.0F);
+        OUZEL_EXPECT(deltas.size() == 2);
+        OUZEL_EXPECT(deltas[0] == 0.5F);
+        OUZEL_EXPECT(deltas[1] == 0.0F);
+        OUZEL_EXPECT(scheduler.getFixedStepAlpha() == 0.0F);
+    }
+
+    OUZEL_TEST_CASE(updateSchedulerDropsTheTimePastTheMaxSteps)
+    {
+        WorkerPool workerPool;
+        UpdateScheduler scheduler{workerPool};
+        scheduler.setFixedTimeStep(0.25F, 3);
+
+        std::uint32_t steps = 0;
+        Updater updater{UpdatePhase::fixed};
+        updater.function = [&steps](float) { ++steps; };
+        scheduler.addUpdater(updater);
+
+        // a long frame runs the maximum number of steps and keeps only the part of a step that is left over
+        scheduler.update(1.125F);
+        OUZEL_EXPECT(steps == 3);
+        OUZEL_EXPECT(scheduler.getFixedStepAlpha() == 0.5F);
+
+        // the dropped time is not caught up with in the following frames
+        scheduler.update(0.125F);
+        OUZEL_EXPECT(steps == 4);
+        OUZEL_EXPECT(scheduler.getFixedStepAlpha() == 0.0F);
+
+        // exactly the maximum number of steps does not drop anything
+        scheduler.update(0.8125F);
+        OUZEL_EXPECT(steps == 7);
+        OUZEL_EXPECT(scheduler.getFixedStepAlpha() == 0.25F);
+    }
+
+    // every body reads only its own state, so the result must not depend on how the updaters are run
+    struct Body final
+    {
+        float position = 0.0F;
+        float velocity = 0.0F;
+        std::uint32_t updates = 0;
+    };
+
+    std::vector<Body> simulate(bool threadSafe)
+    {
+        constexpr std::size_t bodyCount = 64;
+
+        WorkerPool workerPool;
+        UpdateScheduler scheduler{workerPool};
+        scheduler.setFixedTimeStep(1.0F / 64.0F);
+
+        std::vector<Body> bodies(bodyCount);
+        std::vector<std::unique_ptr<Updater>> updaters;
+        for (std::size_t i = 0; i < bodyCount; ++i)
+        {
+            bodies[i].velocity = static_cast<float>(i);
+
+            auto& updater = *updaters.emplace_back(std::make_unique<Updater>(UpdatePhase::fixed, threadSafe));
+            updater.function = [&body = bodies[i], i](float delta) {
+                body.velocity -= static_cast<float>(i % 7) * delta;
+                body.position += body.velocity * delta;
+                ++body.updates;
+            };
+            scheduler.addUpdater(updater);
+        }
+
+        for (std::uint32_t frame = 0; frame < 100; ++frame)
+            scheduler.update(1.0F / 60.0F);
+
+        return bodies;
+    }
+
+    OUZEL_TEST_CASE(updateSchedulerThreadSafeUpdatersMatchTheSerialOnes)
+    {
+        const auto serial = simulate(false);
+        const auto parallel = simulate(true);
+
+        OUZEL_EXPECT(serial.size() == parallel.size());
+        for (std::size_t i = 0; i < serial.size(); ++i)
+        {
+            OUZEL_EXPECT(serial[i].position == parallel[i].position);
+            OUZEL_EXPECT(serial[i].velocity == parallel[i].velocity);
+            OUZEL_EXPECT(serial[i].updates == parallel[i].updates);
+        }
+    }
+
+    OUZEL_TEST_CASE(updateSchedulerDefersTheSerialWorkOfThreadSafeUpdaters)
+    {
+        constexpr std::size_t updaterCount = 32;
+
+        WorkerPool workerPool;
+        UpdateScheduler scheduler{workerPool};
+
+        // not synchronized, so it may only be changed through runSerially
+        std::vector<std::size_t> spawned;
+        std::atomic<std::size_t> seenDuringPhase{0};
+
+        std::vector<std::unique_ptr<Updater>> updaters;
+        for (std::size_t i = 0; i < updaterCount; ++i)
+        {
+            auto& updater = *updaters.emplace_back(std::make_unique<Updater>(UpdatePhase::animation, true));
+            updater.function = [&scheduler, &spawned, &seenDuringPhase, i](float) {
+                scheduler.runSerially([&spawned, i]() { spawned.push_back(i); });
+                seenDuringPhase.fetch_add(spawned.size(), std::memory_order_relaxed);
+            };
+            scheduler.addUpdater(updater);
+        }
+
+        // a serial updater of the next phase sees all the deferred work done
+        std::size_t seenAfterPhase = 0;
+        Updater lateUpdater{UpdatePhase::late};
+        lateUpdater.function = [&spawned, &seenAfterPhase](float) { seenAfterPhase = spawned.size(); };
+        scheduler.addUpdater(lateUpdater);
+
+        scheduler.update(0.0F);
+
+        OUZEL_EXPECT(seenDuringPhase.load() == 0);
+        OUZEL_EXPECT(seenAfterPhase == updaterCount);
+
+        std::vector<bool> found(updaterCount);
+        for (const auto i : spawned) found[i] = true;
+        for (const auto value : found) OUZEL_EXPECT(value);
+
+        // outside of the parallel updaters the function runs immediately
+        scheduler.runSerially([&spawned]() { spawned.clear(); });
+        OUZEL_EXPECT(spawned.empty());
+    }
+}
@@ -0,0 +1,46 @@
+// Ouzel by Elviss Strazdins
+
+#include <cstdint>
+#include "Test.hpp"
+#include "utils/Utils.hpp"
+
+namespace
+{
+    constexpr std::uint8_t bytes[] = {0x81, 0x02, 0x83, 0x04, 0x85, 0x06, 0x87, 0x08};
+
+    OUZEL_TEST_CASE(decodeBigEndian)
+    {
+        OUZEL_EXPECT(ouzel::decodeBigEndian<std::uint8_t>(bytes) == 0x81U);
+        OUZEL_EXPECT(ouzel::decodeBigEndian<std::uint16_t>(bytes) == 0x8102U);
+        OUZEL_EXPECT(ouzel::decodeBigEndian<std::uint32_t>(bytes) == 0x81028304U);
+        // the upper half of 64-bit values used to be lost, because the bytes were shifted as ints
+        OUZEL_EXPECT(ouzel::decodeBigEndian<std::uint64_t>(bytes) == 0x8102830485068708ULL);
+    }
+
+    OUZEL_TEST_CASE(decodeLittleEndian)
+    {
+        OUZEL_EXPECT(ouzel::decodeLittleEndian<std::uint8_t>(bytes) == 0x81U);
+        OUZEL_EXPECT(ouzel::decodeLittleEndian<std::uint16_t>(bytes) == 0x0281U);
+        OUZEL_EXPECT(ouzel::decodeLittleEndian<std::uint32_t>(bytes) == 0x04830281U);
+        OUZEL_EXPECT(ouzel::decodeLittleEndian<std::uint64_t>(bytes) == 0x0887068504830281ULL);
+    }
+
+    OUZEL_TEST_CASE(encodeAndDecodeEndian)
+    {
+        constexpr std::uint64_t value = 0xFEDCBA9876543210ULL;
+
+        std::uint8_t buffer[8];
+        ouzel::encodeBigEndian(buffer, value);
+        OUZEL_EXPECT(buffer[0] == 0xFE && buffer[7] == 0x10);
+        OUZEL_EXPECT(ouzel::decodeBigEndian<std::uint64_t>(buffer) == value);
+
+        ouzel::encodeLittleEndian(buffer, value);
+        OUZEL_EXPECT(buffer[0] == 0x10 && buffer[7] == 0xFE);
+        OUZEL_EXPECT(ouzel::decodeLittleEndian<std::uint64_t>(buffer) == value);
+
+        // bytes read through a signed char iterator aren't sign extended
+        const char signedBytes[] = {'\xFF', '\x80'};
+        OUZEL_EXPECT(ouzel::decodeBigEndian<std::uint16_t>(signedBytes) == 0xFF80U);
+        OUZEL_EXPECT(ouzel::decodeLittleEndian<std::uint16_t>(signedBytes) == 0x80FFU);
+    }
+}
@@ -0,0 +1,173 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "Test.hpp"
+#include "core/WorkerPool.hpp"
+
+namespace
+{
+    OUZEL_TEST_CASE(workerPoolRunsAllTasks)
+    {
+        ouzel::core::WorkerPool workerPool;
+        std::atomic<std::size_t> counter{0};
+
+        ouzel::core::TaskGroup taskGroup;
+        for (std::size_t i = 0; i < 1000; ++i)
+            taskGroup.add([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+
+        auto future = workerPool.run(std::move(taskGroup));
+        future.wait();
+
+        OUZEL_EXPECT(future.isReady());
+        OUZEL_EXPECT(counter.load() == 1000);
+        OUZEL_EXPECT(!workerPool.runPendingTask());
+    }
+
+    OUZEL_TEST_CASE(workerPoolEmptyGroupIsReady)
+    {
+        ouzel::core::WorkerPool workerPool;
+        auto future = workerPool.run(ouzel::core::TaskGroup{});
+        OUZEL_EXPECT(future.isReady());
+        future.wait();
+    }
+
+    OUZEL_TEST_CASE(workerPoolNestedTasksWaitForTheirDependencies)
+    {
+        ouzel::core::WorkerPool workerPool;
+        std::vector<std::size_t> results(16);
+
+        ouzel::core::TaskGroup taskGroup;
+        for (std::size_t i = 0; i < results.size(); ++i)
+            taskGroup.add([&workerPool, &results, i]() {
+                // every task spawns its dependencies and waits for them, helping with the work meanwhile
+                std::vector<std::size_t> parts(8);
+                ouzel::core::TaskGroup subgroup;
+                for (std::size_t j = 0; j < parts.size(); ++j)
+                    subgroup.add([&parts, i, j]() { parts[j] = i * j; });
+
+                workerPool.run(std::move(subgroup)).wait();
+
+                std::size_t sum = 0;
+                for (const auto part : parts) sum += part;
+                results[i] = sum;
+            });
+
+        workerPool.run(std::move(taskGroup)).wait();
+
+        for (std::size_t i = 0; i < results.size(); ++i)
+            OUZEL_EXPECT(results[i] == i * 28);
+    }
+
+    OUZEL_TEST_CASE(workerPoolParallelForCoversTheRange)
+    {
+        ouzel::core::WorkerPool workerPool;
+        std::vector<std::uint32_t> values(10007);
+
+        workerPool.parallelFor(0, values.size(), 64, [&values](std::size_t first, std::size_t last) {
+            for (auto i = first; i < last; ++i) ++values[i];
+        });
+
+        for (const auto value : values)
+            OUZEL_EXPECT(value == 1);
+    }
+
+    OUZEL_TEST_CASE(workerPoolPassesExceptionsToTheFuture)
+    {
+        ouzel::core::WorkerPool workerPool;
+        std::atomic<std::size_t> counter{0};
+
+        ouzel::core::TaskGroup taskGroup;
+        for (std::size_t i = 0; i < 100; ++i)
+            taskGroup.add([&counter, i]() {
+                counter.fetch_add(1, std::memory_order_relaxed);
+                if (i % 10 == 0) throw std::runtime_error{"Task failed"};
+                if (i == 55) throw 42; // not derived from std::exception
+            });
+
+        auto future = workerPool.run(std::move(taskGroup));
+
+        bool thrown = false;
+        try
+        {
+            future.wait();
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        catch (int)
+        {
+            thrown = true;
+        }
+
+        // the failed tasks are still counted as finished
+        OUZEL_EXPECT(thrown);
+        OUZEL_EXPECT(future.isReady());
+        OUZEL_EXPECT(counter.load() == 100);
+        OUZEL_EXPECT(!workerPool.runPendingTask());
+    }
+
+    OUZEL_TEST_CASE(workerPoolParallelForRethrows)
+    {
+        ouzel::core::WorkerPool workerPool;
+        std::atomic<std::size_t> counter{0};
+
+        OUZEL_EXPECT_THROW(workerPool.parallelFor(0, 64, 1, [&counter](std::size_t first, std::size_t) {
+            counter.fetch_add(1, std::memory_order_relaxed);
+            if (first == 63) throw std::runtime_error{"Last range failed"}; // thrown on the calling thread
+        }), std::runtime_error);
+
+        // all the subranges have finished before parallelFor returned
+        OUZEL_EXPECT(counter.load() == 64);
+    }
+
+    OUZEL_BENCHMARK(workerPoolTaskThroughputBenchmark)
+    {
+        constexpr std::size_t count = 100000;
+        constexpr std::size_t iterations = 20;
+
+        ouzel::core::WorkerPool workerPool;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            ouzel::core::TaskGroup taskGroup;
+            for (std::size_t j = 0; j < count; ++j)
+                taskGroup.add([]() {});
+
+            workerPool.run(std::move(taskGroup)).wait();
+        }
+        const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "empty tasks: " << static_cast<double>(count * iterations) / duration << " tasks/s\n";
+    }
+
+    // a fork-join with one trivial subrange for every worker and one for the calling thread,
+    // so that the time is spent in the pool
+    OUZEL_BENCHMARK(workerPoolParallelForLatencyBenchmark)
+    {
+        constexpr std::size_t iterations = 10000;
+        const std::size_t ranges = std::max(std::thread::hardware_concurrency(), 2U);
+
+        ouzel::core::WorkerPool workerPool;
+        std::vector<std::size_t> values(ranges);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+            workerPool.parallelFor(0, ranges, 1, [&values](std::size_t first, std::size_t last) {
+                for (auto j = first; j < last; ++j) ++values[j];
+            });
+        const auto duration = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "parallelFor over " << ranges << " ranges: " << duration / iterations << " us\n";
+
+        for (const auto value : values)
+            OUZEL_EXPECT(value == iterations);
+    }
+}
@@ -1,8 +1,38 @@
 // Ouzel by Elviss Strazdins
 
-#include "cstdlib"
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string_view>
+#include "Test.hpp"
 
-int main()
+int main(int argc, char* argv[])
 {
+    const bool benchmark = argc > 1 && std::string_view{argv[1]} == "benchmark";
+
+    std::size_t failedCount = 0;
+
+    for (const auto& testCase : ouzel::test::getTestCases())
+    {
+        if (testCase.benchmark != benchmark) continue;
+
+        try
+        {
+            testCase.function();
+            std::cout << "[  OK  ] " << testCase.name << '\n';
+        }
+        catch (const std::exception& e)
+        {
+            ++failedCount;
+            std::cout << "[FAILED] " << testCase.name << ": " << e.what() << '\n';
+        }
+    }
+
+    if (failedCount > 0)
+    {
+        std::cout << failedCount << " test(s) failed\n";
+        return EXIT_FAILURE;
+    }
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,653 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETCOOKER_HPP
+#define OUZEL_ASSETCOOKER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include "stb_image.h"
+#include "formats/Cooked.hpp"
+#include "formats/Json.hpp"
+#include "storage/Path.hpp"
+
+// Converts the text assets to the binary layout of formats/Cooked.hpp, so that the runtime doesn't have to parse them
+namespace ouzel::cooker
+{
+    // names of the exported files of the assets, keyed by the source filenames that other assets use to refer to them
+    using FileMap = std::map<std::string, std::string, std::less<>>;
+
+    inline std::string resolve(const FileMap& files, std::string_view filename)
+    {
+        const auto i = files.find(filename);
+        return i != files.end() ? i->second : std::string{filename};
+    }
+
+    inline std::vector<char> readFile(const storage::Path& path)
+    {
+        std::ifstream file{path, std::ios::binary};
+        if (!file)
+            throw std::runtime_error{"Failed to open " + std::string(path)};
+
+        return std::vector<char>{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+    inline void writeFile(const storage::Path& path, const std::vector<std::uint8_t>& data)
+    {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        if (!file)
+            throw std::runtime_error{"Failed to create " + std::string(path)};
+
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    // splits the text into lines and the lines into tokens separated by white spaces,
+    // quoted tokens can contain white spaces
+    inline void forEachLine(const std::vector<char>& data,
+                            const std::function<void(const std::vector<std::string_view>&)>& function)
+    {
+        std::vector<std::string_view> tokens;
+        const std::string_view text{data.data(), data.size()};
+
+        for (std::size_t position = 0; position < text.size();)
+        {
+            auto lineEnd = text.find_first_of("\r\n", position);
+            if (lineEnd == std::string_view::npos) lineEnd = text.size();
+
+            tokens.clear();
+            for (auto i = position; i < lineEnd;)
+            {
+                if (text[i] == ' ' || text[i] == '\t')
+                {
+                    ++i;
+                    continue;
+                }
+
+                const auto tokenStart = i;
+                bool quoted = false;
+                while (i < lineEnd && (quoted || (text[i] != ' ' && text[i] != '\t')))
+                {
+                    if (text[i] == '"') quoted = !quoted;
+                    ++i;
+                }
+
+                tokens.push_back(text.substr(tokenStart, i - tokenStart));
+            }
+
+            // comments start with a hash
+            if (!tokens.empty() && tokens.front().front() != '#')
+                function(tokens);
+
+            position = lineEnd + 1;
+        }
+    }
+
+    inline float toFloat(std::string_view token)
+    {
+        return std::strtof(std::string{token}.c_str(), nullptr);
+    }
+
+    inline long toInteger(std::string_view token)
+    {
+        return std::strtol(std::string{token}.c_str(), nullptr, 10);
+    }
+
+    inline std::uint8_t toColorComponent(float value) noexcept
+    {
+        return static_cast<std::uint8_t>(std::clamp(value, 0.0F, 1.0F) * 255.0F);
+    }
+
+    inline void cookSprite(const storage::Path& inputPath,
+                           const storage::Path& outputPath,
+                           const FileMap& files)
+    {
+        struct Frame final
+        {
+            std::string name;
+            std::array<float, 4> rectangle{};
+            std::array<float, 2> sourceSize{};
+            std::array<float, 2> sourceOffset{};
+            std::array<float, 2> pivot{};
+            bool rotated = false;
+            std::vector<std::array<float, 4>> vertices;
+            std::vector<std::uint16_t> indices;
+        };
+
+        const auto data = readFile(inputPath);
+        const json::Document document{data};
+        const auto d = document.getRoot();
+
+        std::string imageFilename;
+        std::vector<Frame> frames;
+
+        if (d.hasMember("meta") && d.hasMember("frames"))
+        {
+            imageFilename = d["meta"]["image"].as<std::string>();
+
+            for (const auto& frameObject : d["frames"])
+            {
+                Frame frame;
+                frame.name = frameObject["filename"].as<std::string>();
+
+                const auto frameRectangleObject = frameObject["frame"];
+                frame.rectangle = {
+                    frameRectangleObject["x"].as<float>(),
+                    frameRectangleObject["y"].as<float>(),
+                    frameRectangleObject["w"].as<float>(),
+                    frameRectangleObject["h"].as<float>()
+                };
+
+                frame.sourceSize = {frameObject["sourceSize"]["w"].as<float>(), frameObject["sourceSize"]["h"].as<float>()};
+                frame.sourceOffset = {frameObject["spriteSourceSize"]["x"].as<float>(), frameObject["spriteSourceSize"]["y"].as<float>()};
+                frame.pivot = {frameObject["pivot"]["x"].as<float>(), frameObject["pivot"]["y"].as<float>()};
+
+                if (frameObject.hasMember("vertices") &&
+                    frameObject.hasMember("verticesUV") &&
+                    frameObject.hasMember("triangles"))
+                {
+                    for (const auto& triangleObject : frameObject["triangles"])
+                        for (const auto& indexObject : triangleObject)
+                            frame.indices.push_back(static_cast<std::uint16_t>(indexObject.as<std::uint32_t>()));
+
+                    // reverse the vertices, so that they are counterclockwise
+                    std::reverse(frame.indices.begin(), frame.indices.end());
+
+                    const auto verticesObject = frameObject["vertices"];
+                    const auto verticesUVObject = frameObject["verticesUV"];
+
+                    for (std::size_t i = 0; i < verticesObject.getSize(); ++i)
+                        frame.vertices.push_back({
+                            static_cast<float>(verticesObject[i][0].as<std::int32_t>()),
+                            static_cast<float>(verticesObject[i][1].as<std::int32_t>()),
+                            static_cast<float>(verticesUVObject[i][0].as<std::int32_t>()),
+                            static_cast<float>(verticesUVObject[i][1].as<std::int32_t>())
+                        });
+                }
+                else
+                    frame.rotated = frameObject["rotated"].as<bool>();
+
+                frames.push_back(std::move(frame));
+            }
+        }
+        else if (d.hasMember("filename") &&
+                 d.hasMember("spritesX") &&
+                 d.hasMember("spritesY") &&
+                 d.hasMember("pivotX") &&
+                 d.hasMember("pivotY"))
+        {
+            imageFilename = d["filename"].as<std::string>();
+            const auto spritesX = d["spritesX"].as<std::size_t>();
+            const auto spritesY = d["spritesY"].as<std::size_t>();
+            const std::array<float, 2> pivot{d["pivotX"].as<float>(), d["pivotY"].as<float>()};
+
+            // the frames of a sprite sheet depend only on the size of the image, so they are computed here
+            int width;
+            int height;
+            int comp;
+            const auto imagePath = std::string(inputPath.getDirectory() / imageFilename);
+            if (!stbi_info(imagePath.c_str(), &width, &height, &comp))
+                throw std::runtime_error{"Failed to load " + imagePath};
+
+            const std::array<float, 2> spriteSize{
+                static_cast<float>(width) / static_cast<float>(spritesX),
+                static_cast<float>(height) / static_cast<float>(spritesY)
+            };
+
+            for (std::size_t x = 0; x < spritesX; ++x)
+                for (std::size_t y = 0; y < spritesY; ++y)
+                {
+                    Frame frame;
+                    frame.name = imageFilename;
+                    frame.rectangle = {
+                        spriteSize[0] * static_cast<float>(x),
+                        spriteSize[1] * static_cast<float>(y),
+                        spriteSize[0],
+                        spriteSize[1]
+                    };
+                    frame.sourceSize = spriteSize;
+                    frame.pivot = pivot;
+                    frames.push_back(std::move(frame));
+                }
+        }
+        else
+            throw std::runtime_error{"Unsupported sprite " + std::string(inputPath)};
+
+        cooked::Writer writer{cooked::Kind::spriteData};
+        const auto root = writer.allocate(cooked::sprite::rootSize, 8);
+        writer.writeString(root, resolve(files, imageFilename));
+
+        // all frames are in one unnamed animation
+        const auto animation = writer.allocate(cooked::sprite::animationSize);
+        writer.writeRange(root + cooked::rangeSize, cooked::Range{animation, 1});
+        writer.writeString(animation, "");
+
+        const auto firstFrame = writer.allocate(frames.size() * cooked::sprite::frameSize);
+        writer.writeRange(animation + cooked::rangeSize, cooked::Range{firstFrame, frames.size()});
+
+        for (std::size_t i = 0; i < frames.size(); ++i)
+        {
+            const auto& frame = frames[i];
+            const auto offset = firstFrame + i * cooked::sprite::frameSize;
+
+            writer.writeString(offset, frame.name);
+            for (std::size_t c = 0; c < 4; ++c)
+                writer.write(offset + 8 + c * 4, frame.rectangle[c]);
+            for (std::size_t c = 0; c < 2; ++c)
+            {
+                writer.write(offset + 24 + c * 4, frame.sourceSize[c]);
+                writer.write(offset + 32 + c * 4, frame.sourceOffset[c]);
+                writer.write(offset + 40 + c * 4, frame.pivot[c]);
+            }
+            writer.write(offset + 48, frame.rotated);
+
+            const auto vertices = writer.allocate(frame.vertices.size() * cooked::sprite::vertexSize);
+            writer.writeRange(offset + 56, cooked::Range{vertices, frame.vertices.size()});
+            for (std::size_t v = 0; v < frame.vertices.size(); ++v)
+                for (std::size_t c = 0; c < 4; ++c)
+                    writer.write(vertices + v * cooked::sprite::vertexSize + c * 4, frame.vertices[v][c]);
+
+            writer.writeArray(offset + 64, frame.indices);
+        }
+
+        writeFile(outputPath, writer.finish());
+    }
+
+    inline void cookParticleSystem(const storage::Path& inputPath,
+                                   const storage::Path& outputPath,
+                                   const FileMap& files)
+    {
+        using cooked::particleSystem::Field;
+
+        const auto data = readFile(inputPath);
+        const json::Document document{data};
+        const auto d = document.getRoot();
+
+        if (!d.hasMember("textureFileName") ||
+            !d.hasMember("configName"))
+            throw std::runtime_error{"Unsupported particle system " + std::string(inputPath)};
+
+        cooked::Writer writer{cooked::Kind::particleSystem};
+        const auto root = writer.allocate(cooked::particleSystem::rootSize, 8);
+        writer.writeString(root, d["configName"].as<std::string>());
+        writer.writeString(root + cooked::rangeSize, resolve(files, d["textureFileName"].as<std::string>()));
+
+        std::uint64_t mask = 0;
+
+        for (std::size_t i = 0; i < cooked::particleSystem::fieldCount; ++i)
+        {
+            const auto key = cooked::particleSystem::keys[i];
+            if (!d.hasMember(key)) continue;
+
+            const auto field = static_cast<Field>(i);
+            const auto valueOffset = root + cooked::particleSystem::valuesOffset + i * 4;
+
+            if (cooked::particleSystem::isInteger(field))
+                writer.write(valueOffset, d[key].as<std::uint32_t>());
+            else if (cooked::particleSystem::isBoolean(field))
+                writer.write(valueOffset, d[key].as<bool>());
+            else
+                writer.write(valueOffset, d[key].as<float>());
+
+            mask |= std::uint64_t{1} << i;
+        }
+
+        writer.write(root + cooked::particleSystem::maskOffset, mask);
+
+        writeFile(outputPath, writer.finish());
+    }
+
+    // BMFont text files
+    inline void cookFont(const storage::Path& inputPath,
+                         const storage::Path& outputPath,
+                         const FileMap& files)
+    {
+        std::array<std::uint16_t, 6> common{}; // line height, base, width, height, pages, outline
+        std::string pageFilename;
+        std::map<std::uint32_t, std::array<std::int16_t, 8>> characters;
+        std::map<std::pair<std::uint32_t, std::uint32_t>, std::int16_t> kerningPairs;
+
+        forEachLine(readFile(inputPath), [&](const std::vector<std::string_view>& tokens) {
+            const auto keyword = tokens.front();
+
+            std::map<std::string_view, std::string_view> values;
+            for (std::size_t i = 1; i < tokens.size(); ++i)
+                if (const auto separator = tokens[i].find('='); separator != std::string_view::npos)
+                {
+                    auto value = tokens[i].substr(separator + 1);
+                    if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+                        value = value.substr(1, value.size() - 2);
+                    values[tokens[i].substr(0, separator)] = value;
+                }
+
+            const auto get = [&values](std::string_view key) {
+                const auto i = values.find(key);
+                return i != values.end() ? toInteger(i->second) : 0L;
+            };
+
+            if (keyword == "page")
+            {
+                if (const auto i = values.find("file"); i != values.end())
+                    pageFilename = std::string{i->second};
+            }
+            else if (keyword == "common")
+                common = {
+                    static_cast<std::uint16_t>(get("lineHeight")),
+                    static_cast<std::uint16_t>(get("base")),
+                    static_cast<std::uint16_t>(get("scaleW")),
+                    static_cast<std::uint16_t>(get("scaleH")),
+                    static_cast<std::uint16_t>(get("pages")),
+                    static_cast<std::uint16_t>(get("outline"))
+                };
+            else if (keyword == "char")
+                characters[static_cast<std::uint32_t>(get("id"))] = {
+                    static_cast<std::int16_t>(get("x")),
+                    static_cast<std::int16_t>(get("y")),
+                    static_cast<std::int16_t>(get("width")),
+                    static_cast<std::int16_t>(get("height")),
+                    static_cast<std::int16_t>(get("xoffset")),
+                    static_cast<std::int16_t>(get("yoffset")),
+                    static_cast<std::int16_t>(get("xadvance")),
+                    static_cast<std::int16_t>(get("page"))
+                };
+            else if (keyword == "kerning")
+                kerningPairs[std::pair{static_cast<std::uint32_t>(get("first")), static_cast<std::uint32_t>(get("second"))}] =
+                    static_cast<std::int16_t>(get("amount"));
+        });
+
+        cooked::Writer writer{cooked::Kind::font};
+        const auto root = writer.allocate(cooked::font::rootSize, 8);
+        for (std::size_t i = 0; i < common.size(); ++i)
+            writer.write(root + i * 2, common[i]);
+        writer.writeString(root + 16, resolve(files, pageFilename));
+
+        const auto firstCharacter = writer.allocate(characters.size() * cooked::font::characterSize);
+        writer.writeRange(root + 24, cooked::Range{firstCharacter, characters.size()});
+
+        auto offset = firstCharacter;
+        for (const auto& [id, values] : characters)
+        {
+            writer.write(offset, id);
+            for (std::size_t i = 0; i < values.size(); ++i)
+                writer.write(offset + 4 + i * 2, values[i]);
+            offset += cooked::font::characterSize;
+        }
+
+        const auto firstKerningPair = writer.allocate(kerningPairs.size() * cooked::font::kerningPairSize);
+        writer.writeRange(root + 32, cooked::Range{firstKerningPair, kerningPairs.size()});
+
+        offset = firstKerningPair;
+        for (const auto& [pair, amount] : kerningPairs)
+        {
+            writer.write(offset, pair.first);
+            writer.write(offset + 4, pair.second);
+            writer.write(offset + 8, amount);
+            offset += cooked::font::kerningPairSize;
+        }
+
+        writeFile(outputPath, writer.finish());
+    }
+
+    // Wavefront OBJ files, the vertices are deduplicated and the polygons are triangulated here
+    inline void cookMesh(const storage::Path& inputPath,
+                         const storage::Path& outputPath,
+                         const FileMap& files)
+    {
+        struct Vertex final
+        {
+            std::array<float, 3> position{};
+            std::array<float, 2> texCoord{};
+            std::array<float, 3> normal{};
+        };
+
+        struct Mesh final
+        {
+            std::string name;
+            std::string material;
+            std::array<float, 3> min{
+                std::numeric_limits<float>::max(),
+                std::numeric_limits<float>::max(),
+                std::numeric_limits<float>::max()
+            };
+            std::array<float, 3> max{
+                std::numeric_limits<float>::lowest(),
+                std::numeric_limits<float>::lowest(),
+                std::numeric_limits<float>::lowest()
+            };
+            std::vector<Vertex> vertices;
+            std::vector<std::uint32_t> indices;
+            std::map<std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>, std::uint32_t> vertexMap;
+        };
+
+        std::string materialLibrary;
+        std::vector<std::array<float, 3>> positions;
+        std::vector<std::array<float, 2>> texCoords;
+        std::vector<std::array<float, 3>> normals;
+        std::vector<Mesh> meshes(1);
+
+        const auto getIndex = [](std::string_view token, std::size_t count, const char* what) {
+            auto index = toInteger(token);
+            if (index < 0) index += static_cast<long>(count) + 1;
+            if (index < 1 || index > static_cast<long>(count))
+                throw std::runtime_error{std::string{"Invalid "} + what + " index"};
+            return static_cast<std::uint32_t>(index);
+        };
+
+        forEachLine(readFile(inputPath), [&](const std::vector<std::string_view>& tokens) {
+            const auto keyword = tokens.front();
+            auto& mesh = meshes.back();
+
+            if (keyword == "mtllib" && tokens.size() > 1)
+                materialLibrary = resolve(files, tokens[1]);
+            else if (keyword == "usemtl" && tokens.size() > 1)
+                mesh.material = std::string{tokens[1]};
+            else if (keyword == "o")
+            {
+                meshes.emplace_back();
+                if (tokens.size() > 1) meshes.back().name = std::string{tokens[1]};
+            }
+            else if (keyword == "v" && tokens.size() > 3)
+                positions.push_back({toFloat(tokens[1]), toFloat(tokens[2]), toFloat(tokens[3])});
+            else if (keyword == "vt" && tokens.size() > 2)
+                texCoords.push_back({toFloat(tokens[1]), toFloat(tokens[2])});
+            else if (keyword == "vn" && tokens.size() > 3)
+                normals.push_back({toFloat(tokens[1]), toFloat(tokens[2]), toFloat(tokens[3])});
+            else if (keyword == "f")
+            {
+                if (tokens.size() < 4)
+                    throw std::runtime_error{"Invalid face count"};
+
+                std::vector<std::uint32_t> vertexIndices;
+
+                for (std::size_t i = 1; i < tokens.size(); ++i)
+                {
+                    // position/texture coordinates/normal, the last two are optional
+                    const auto token = tokens[i];
+                    const auto firstSlash = token.find('/');
+                    const auto secondSlash = firstSlash == std::string_view::npos ? std::string_view::npos : token.find('/', firstSlash + 1);
+
+                    std::tuple<std::uint32_t, std::uint32_t, std::uint32_t> key{
+                        getIndex(token.substr(0, firstSlash), positions.size(), "position"), 0, 0
+                    };
+
+                    if (firstSlash != std::string_view::npos)
+                    {
+                        const auto texCoordToken = token.substr(firstSlash + 1, secondSlash == std::string_view::npos ? std::string_view::npos : secondSlash - firstSlash - 1);
+                        if (!texCoordToken.empty())
+                            std::get<1>(key) = getIndex(texCoordToken, texCoords.size(), "texture coordinate");
+
+                        if (secondSlash != std::string_view::npos)
+                            std::get<2>(key) = getIndex(token.substr(secondSlash + 1), normals.size(), "normal");
+                    }
+
+                    if (const auto vertexIterator = mesh.vertexMap.find(key); vertexIterator != mesh.vertexMap.end())
+                        vertexIndices.push_back(vertexIterator->second);
+                    else
+                    {
+                        const auto index = static_cast<std::uint32_t>(mesh.vertices.size());
+                        mesh.vertexMap[key] = index;
+
+                        Vertex vertex;
+                        vertex.position = positions[std::get<0>(key) - 1];
+                        if (std::get<1>(key)) vertex.texCoord = texCoords[std::get<1>(key) - 1];
+                        if (std::get<2>(key)) vertex.normal = normals[std::get<2>(key) - 1];
+                        mesh.vertices.push_back(vertex);
+
+                        for (std::size_t c = 0; c < 3; ++c)
+                        {
+                            mesh.min[c] = std::min(mesh.min[c], vertex.position[c]);
+                            mesh.max[c] = std::max(mesh.max[c], vertex.position[c]);
+                        }
+
+                        vertexIndices.push_back(index);
+                    }
+                }
+
+                for (std::size_t i = 0; i + 2 < vertexIndices.size(); ++i)
+                {
+                    mesh.indices.push_back(vertexIndices[0]);
+                    mesh.indices.push_back(vertexIndices[i + 1]);
+                    mesh.indices.push_back(vertexIndices[i + 2]);
+                }
+            }
+        });
+
+        // objects without faces are not exported
+        meshes.erase(std::remove_if(meshes.begin(), meshes.end(), [](const Mesh& mesh) noexcept {
+            return mesh.indices.empty();
+        }), meshes.end());
+
+        cooked::Writer writer{cooked::Kind::staticMesh};
+        const auto root = writer.allocate(cooked::staticMesh::rootSize, 8);
+        writer.writeString(root, materialLibrary);
+
+        const auto firstMesh = writer.allocate(meshes.size() * cooked::staticMesh::meshSize);
+        writer.writeRange(root + cooked::rangeSize, cooked::Range{firstMesh, meshes.size()});
+
+        for (std::size_t i = 0; i < meshes.size(); ++i)
+        {
+            const auto& mesh = meshes[i];
+            const auto offset = firstMesh + i * cooked::staticMesh::meshSize;
+
+            writer.writeString(offset, mesh.name);
+            writer.writeString(offset + 8, mesh.material);
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+                writer.write(offset + 16 + c * 4, mesh.min[c]);
+                writer.write(offset + 28 + c * 4, mesh.max[c]);
+            }
+
+            const auto vertices = writer.allocate(mesh.vertices.size() * cooked::staticMesh::vertexSize);
+            writer.writeRange(offset + 40, cooked::Range{vertices, mesh.vertices.size()});
+
+            for (std::size_t v = 0; v < mesh.vertices.size(); ++v)
+            {
+                const auto& vertex = mesh.vertices[v];
+                const auto vertexOffset = vertices + v * cooked::staticMesh::vertexSize;
+
+                for (std::size_t c = 0; c < 3; ++c)
+                {
+                    writer.write(vertexOffset + c * 4, vertex.position[c]);
+                    writer.write(vertexOffset + 32 + c * 4, vertex.normal[c]);
+                }
+                writer.write(vertexOffset + 12, std::uint32_t{0xFFFFFFFFU}); // white
+                writer.write(vertexOffset + 16, vertex.texCoord[0]);
+                writer.write(vertexOffset + 20, vertex.texCoord[1]);
+                // the second texture coordinates stay zero
+            }
+
+            writer.writeArray(offset + 48, mesh.indices);
+        }
+
+        writeFile(outputPath, writer.finish());
+    }
+
+    // Wavefront MTL files
+    inline void cookMaterial(const storage::Path& inputPath,
+                             const storage::Path& outputPath,
+                             const FileMap& files)
+    {
+        struct Material final
+        {
+            std::string name;
+            std::string diffuseTexture;
+            std::string ambientTexture;
+            std::array<std::uint8_t, 4> ambientColor{255, 255, 255, 255};
+            std::array<std::uint8_t, 4> diffuseColor{255, 255, 255, 255};
+            float opacity = 1.0F;
+        };
+
+        std::vector<Material> materials;
+
+        forEachLine(readFile(inputPath), [&](const std::vector<std::string_view>& tokens) {
+            const auto keyword = tokens.front();
+
+            if (keyword == "newmtl")
+            {
+                materials.emplace_back();
+                if (tokens.size() > 1) materials.back().name = std::string{tokens[1]};
+                return;
+            }
+
+            // the attributes before the first material definition belong to an unnamed material
+            if (materials.empty()) materials.emplace_back();
+            auto& material = materials.back();
+
+            // the texture map options precede the filename
+            if (keyword == "map_Kd" && tokens.size() > 1)
+                material.diffuseTexture = resolve(files, tokens.back());
+            else if (keyword == "map_Ka" && tokens.size() > 1)
+                material.ambientTexture = resolve(files, tokens.back());
+            else if ((keyword == "Ka" || keyword == "Kd") && tokens.size() > 3)
+            {
+                auto& color = (keyword == "Ka") ? material.ambientColor : material.diffuseColor;
+                color = {
+                    toColorComponent(toFloat(tokens[1])),
+                    toColorComponent(toFloat(tokens[2])),
+                    toColorComponent(toFloat(tokens[3])),
+                    255
+                };
+            }
+            else if (keyword == "d" && tokens.size() > 1)
+                material.opacity = toFloat(tokens[1]);
+            else if (keyword == "Tr" && tokens.size() > 1)
+                material.opacity = 1.0F - toFloat(tokens[1]);
+        });
+
+        cooked::Writer writer{cooked::Kind::material};
+        const auto root = writer.allocate(cooked::material::rootSize, 8);
+
+        const auto firstMaterial = writer.allocate(materials.size() * cooked::material::materialSize);
+        writer.writeRange(root, cooked::Range{firstMaterial, materials.size()});
+
+        for (std::size_t i = 0; i < materials.size(); ++i)
+        {
+            const auto& material = materials[i];
+            const auto offset = firstMaterial + i * cooked::material::materialSize;
+
+            writer.writeString(offset, material.name);
+            writer.writeString(offset + 8, material.diffuseTexture);
+            writer.writeString(offset + 16, material.ambientTexture);
+            for (std::size_t c = 0; c < 4; ++c)
+            {
+                writer.write(offset + 24 + c, material.ambientColor[c]);
+                writer.write(offset + 28 + c, material.diffuseColor[c]);
+            }
+            writer.write(offset + 32, material.opacity);
+        }
+
+        writeFile(outputPath, writer.finish());
+    }
+}
+
+#endif // OUZEL_ASSETCOOKER_HPP
@@ -5,7 +5,9 @@
 
 #include <fstream>
 #include "Asset.hpp"
+#include "AssetCooker.hpp"
 #include "Target.hpp"
+#include "TextureExporter.hpp"
 #include "storage/FileSystem.hpp"
 #include "formats/Json.hpp"
 
@@ -83,29 +85,113 @@ namespace ouzel
 
         void exportAssets(const std::string& targetName) const
         {
+            const auto targetIterator = std::find_if(targets.begin(), targets.end(),
+                                                     [&targetName](const auto& target) noexcept {
+                return target.name == targetName;
+            });
+
+            if (targetIterator == targets.end())
+                throw std::runtime_error{"Target not found"};
+
+            // every target gets its own resources, because the texture formats depend on the platform
+            auto outputPath = path.getDirectory() / "Resources";
+            if (storage::FileSystem::getFileType(outputPath) == storage::FileType::notFound)
+                storage::FileSystem::createDirectory(outputPath);
+
+            outputPath /= targetName;
+            if (storage::FileSystem::getFileType(outputPath) == storage::FileType::notFound)
+                storage::FileSystem::createDirectory(outputPath);
+
+            // the assets refer to each other by the source filenames, which are replaced by the names of the exported files
+            cooker::FileMap files;
+            for (const auto& asset : assets)
+                if (const auto resourceName = getResourceName(asset); !resourceName.empty())
+                    files[std::string(asset.path.getFilename())] = resourceName;
+
             for (const auto& asset : assets)
             {
-                const auto assetPath = assetsPath / asset.path;
+                const auto resourceName = getResourceName(asset);
+                if (resourceName.empty()) continue;
 
-                auto resourceName = asset.path;
-                resourceName.replaceExtension("otexture");
-                const auto resourcePath = assetPath / resourceName;
+                if (storage::FileSystem::getFileType(asset.path) != storage::FileType::regular)
+                    throw std::runtime_error{"Asset " + std::string(asset.path) + " not found"};
 
-                const auto targetIterator = std::find_if(targets.begin(), targets.end(),
-                                                         [targetName](const auto& target) noexcept {
-                    return target.name == targetName;
-                });
+                const auto resourcePath = outputPath / resourceName;
 
-                if (targetIterator == targets.end())
-                    throw std::runtime_error{"Target not found"};
+                // the output is up to date if it was written after the input was last modified
+                if (storage::FileSystem::getFileType(resourcePath) == storage::FileType::regular &&
+                    storage::FileSystem::getModifyTime(resourcePath) > storage::FileSystem::getModifyTime(asset.path))
+                    continue;
 
-                // TODO: check if input file exists
-                // TODO: check if output file exists and is older than the input file
-                // TODO: export input file to output file
+                if (!isConverted(asset))
+                {
+                    storage::FileSystem::copyFile(asset.path, resourcePath, true);
+                    continue;
+                }
+
+                switch (asset.type)
+                {
+                    case Asset::Type::texture:
+                        texture::exportTexture(asset.path, resourcePath, targetIterator->platform, asset.options.mipmaps);
+                        break;
+                    case Asset::Type::sprite:
+                        cooker::cookSprite(asset.path, resourcePath, files);
+                        break;
+                    case Asset::Type::particleSystem:
+                        cooker::cookParticleSystem(asset.path, resourcePath, files);
+                        break;
+                    case Asset::Type::font:
+                        cooker::cookFont(asset.path, resourcePath, files);
+                        break;
+                    case Asset::Type::mesh:
+                        cooker::cookMesh(asset.path, resourcePath, files);
+                        break;
+                    case Asset::Type::material:
+                        cooker::cookMaterial(asset.path, resourcePath, files);
+                        break;
+                    default:
+                        break;
+                }
             }
         }
 
     private:
+        // textures are exported as KTX files and the text assets that the engine would have to parse are cooked
+        static bool isConverted(const Asset& asset)
+        {
+            const auto extension = std::string(asset.path.getExtension());
+
+            switch (asset.type)
+            {
+                case Asset::Type::texture:
+                case Asset::Type::sprite:
+                case Asset::Type::particleSystem:
+                    return true;
+                case Asset::Type::font:
+                    return extension == "fnt";
+                case Asset::Type::mesh:
+                    return extension == "obj";
+                case Asset::Type::material:
+                    return extension == "mtl";
+                default:
+                    return false;
+            }
+        }
+
+        // the other assets (sounds, shaders, TrueType fonts etc.) are copied with their original extension
+        static std::string getResourceName(const Asset& asset)
+        {
+            if (asset.type == Asset::Type::empty)
+                return std::string{};
+            else if (asset.type == Asset::Type::texture)
+                return asset.name + ".ktx";
+            else if (isConverted(asset))
+                return asset.name + ".cooked";
+
+            const auto extension = std::string(asset.path.getExtension());
+            return extension.empty() ? asset.name : asset.name + '.' + extension;
+        }
+
         const storage::Path path;
         std::string name;
         std::string identifier;
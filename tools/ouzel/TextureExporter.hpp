@@ -0,0 +1,787 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_TEXTUREEXPORTER_HPP
+#define OUZEL_TEXTUREEXPORTER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "stb_image.h"
+#include "Platform.hpp"
+#include "storage/Path.hpp"
+
+namespace ouzel::texture
+{
+    // Formats of the exported textures, the runtime decodes the levels only if the device can't sample them
+    enum class Format
+    {
+        rgba8,
+        bc1,
+        bc3,
+        etc2Rgb,
+        etc2Rgba
+    };
+
+    struct Level final
+    {
+        std::uint32_t width = 0;
+        std::uint32_t height = 0;
+        std::vector<std::uint8_t> data;
+    };
+
+    // BC formats are supported by all desktop GPUs and ETC2 by OpenGL ES 3 and Metal mobile GPUs,
+    // WebGL supports neither of them without extensions, so the web gets the uncompressed levels
+    inline Format getFormat(Platform platform, bool opaque) noexcept
+    {
+        switch (platform)
+        {
+            case Platform::windows:
+            case Platform::macOs:
+            case Platform::linux:
+                return opaque ? Format::bc1 : Format::bc3;
+            case Platform::iOs:
+            case Platform::tvOs:
+            case Platform::android:
+                return opaque ? Format::etc2Rgb : Format::etc2Rgba;
+            default:
+                return Format::rgba8;
+        }
+    }
+
+    inline Level loadImage(const storage::Path& path)
+    {
+        std::ifstream file{path, std::ios::binary};
+        if (!file)
+            throw std::runtime_error{"Failed to open " + std::string(path)};
+
+        const std::vector<char> data{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+        int width;
+        int height;
+        int comp;
+
+        using ImageFreeFunction = void(*)(void*);
+        std::unique_ptr<stbi_uc, ImageFreeFunction> imageData{
+            stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(data.data()),
+                                  static_cast<int>(data.size()),
+                                  &width, &height,
+                                  &comp, STBI_rgb_alpha),
+            &stbi_image_free
+        };
+
+        if (!imageData)
+            throw std::runtime_error{"Failed to load " + std::string(path) + ", reason: " + stbi_failure_reason()};
+
+        Level result;
+        result.width = static_cast<std::uint32_t>(width);
+        result.height = static_cast<std::uint32_t>(height);
+        result.data.assign(imageData.get(), imageData.get() + static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4);
+        return result;
+    }
+
+    inline bool isOpaque(const Level& image) noexcept
+    {
+        for (std::size_t i = 3; i < image.data.size(); i += 4)
+            if (image.data[i] != 255) return false;
+
+        return true;
+    }
+
+    // Color channels are averaged in linear space, the same way the runtime generates the mip levels
+    inline std::vector<Level> generateMipmaps(Level image)
+    {
+        std::array<float, 256> toLinear;
+        for (std::size_t i = 0; i < toLinear.size(); ++i)
+            toLinear[i] = std::pow(static_cast<float>(i) / 255.0F, 2.2F);
+
+        const auto toGamma = [](float value) noexcept {
+            return static_cast<std::uint8_t>(std::lround(std::pow(std::clamp(value, 0.0F, 1.0F), 1.0F / 2.2F) * 255.0F));
+        };
+
+        std::vector<Level> levels;
+        levels.push_back(std::move(image));
+
+        while (levels.back().width > 1 || levels.back().height > 1)
+        {
+            const auto& source = levels.back();
+
+            Level level;
+            level.width = std::max(source.width >> 1, 1U);
+            level.height = std::max(source.height >> 1, 1U);
+            level.data.resize(static_cast<std::size_t>(level.width) * level.height * 4);
+
+            for (std::uint32_t y = 0; y < level.height; ++y)
+                for (std::uint32_t x = 0; x < level.width; ++x)
+                {
+                    // the last row or column of odd sized levels is repeated
+                    const std::array<std::size_t, 4> offsets = {
+                        (static_cast<std::size_t>(std::min(y * 2, source.height - 1)) * source.width + std::min(x * 2, source.width - 1)) * 4,
+                        (static_cast<std::size_t>(std::min(y * 2, source.height - 1)) * source.width + std::min(x * 2 + 1, source.width - 1)) * 4,
+                        (static_cast<std::size_t>(std::min(y * 2 + 1, source.height - 1)) * source.width + std::min(x * 2, source.width - 1)) * 4,
+                        (static_cast<std::size_t>(std::min(y * 2 + 1, source.height - 1)) * source.width + std::min(x * 2 + 1, source.width - 1)) * 4
+                    };
+
+                    auto pixel = level.data.data() + (static_cast<std::size_t>(y) * level.width + x) * 4;
+
+                    for (std::size_t channel = 0; channel < 3; ++channel)
+                    {
+                        float sum = 0.0F;
+                        for (const auto offset : offsets)
+                            sum += toLinear[source.data[offset + channel]];
+                        pixel[channel] = toGamma(sum / 4.0F);
+                    }
+
+                    std::uint32_t alpha = 2;
+                    for (const auto offset : offsets)
+                        alpha += source.data[offset + 3];
+                    pixel[3] = static_cast<std::uint8_t>(alpha / 4);
+                }
+
+            levels.push_back(std::move(level));
+        }
+
+        return levels;
+    }
+
+    namespace detail
+    {
+        using Color = std::array<float, 3>;
+
+        inline std::uint16_t toRgb565(const Color& color) noexcept
+        {
+            const auto quantize = [](float value, float maximum) noexcept {
+                return static_cast<std::uint16_t>(std::lround(std::clamp(value, 0.0F, 255.0F) * maximum / 255.0F));
+            };
+
+            return static_cast<std::uint16_t>((quantize(color[0], 31.0F) << 11) |
+                                              (quantize(color[1], 63.0F) << 5) |
+                                              quantize(color[2], 31.0F));
+        }
+
+        inline Color fromRgb565(std::uint16_t color) noexcept
+        {
+            const auto red = static_cast<std::uint32_t>(color >> 11) & 0x1FU;
+            const auto green = static_cast<std::uint32_t>(color >> 5) & 0x3FU;
+            const auto blue = static_cast<std::uint32_t>(color) & 0x1FU;
+
+            return Color{
+                static_cast<float>((red << 3) | (red >> 2)),
+                static_cast<float>((green << 2) | (green >> 4)),
+                static_cast<float>((blue << 3) | (blue >> 2))
+            };
+        }
+
+        inline float distanceSquared(const Color& a, const Color& b) noexcept
+        {
+            return (a[0] - b[0]) * (a[0] - b[0]) +
+                (a[1] - b[1]) * (a[1] - b[1]) +
+                (a[2] - b[2]) * (a[2] - b[2]);
+        }
+
+        // Picks the closest of the four palette colors for every pixel and returns the total squared error
+        inline float assignIndices(const std::array<Color, 16>& colors,
+                                   std::uint16_t color0, std::uint16_t color1,
+                                   std::array<std::uint32_t, 16>& indices) noexcept
+        {
+            if (color0 == color1)
+            {
+                const auto endpoint = fromRgb565(color0);
+                float error = 0.0F;
+                for (std::size_t i = 0; i < colors.size(); ++i)
+                {
+                    indices[i] = 0;
+                    error += distanceSquared(colors[i], endpoint);
+                }
+                return error;
+            }
+
+            const auto endpoint0 = fromRgb565(color0);
+            const auto endpoint1 = fromRgb565(color1);
+            const std::array<Color, 4> palette = {
+                endpoint0,
+                endpoint1,
+                Color{
+                    (2.0F * endpoint0[0] + endpoint1[0]) / 3.0F,
+                    (2.0F * endpoint0[1] + endpoint1[1]) / 3.0F,
+                    (2.0F * endpoint0[2] + endpoint1[2]) / 3.0F
+                },
+                Color{
+                    (endpoint0[0] + 2.0F * endpoint1[0]) / 3.0F,
+                    (endpoint0[1] + 2.0F * endpoint1[1]) / 3.0F,
+                    (endpoint0[2] + 2.0F * endpoint1[2]) / 3.0F
+                }
+            };
+
+            float error = 0.0F;
+            for (std::size_t i = 0; i < colors.size(); ++i)
+            {
+                indices[i] = 0;
+                auto bestDistance = distanceSquared(colors[i], palette[0]);
+                for (std::uint32_t index = 1; index < palette.size(); ++index)
+                    if (const auto distance = distanceSquared(colors[i], palette[index]); distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        indices[i] = index;
+                    }
+
+                error += bestDistance;
+            }
+
+            return error;
+        }
+
+        // Encodes the colors of a 4x4 block in the four color mode, the endpoints start on the principal axis
+        // of the colors and are then refined by a least squares fit to the selected palette indices
+        inline void encodeColorBlock(const std::array<Color, 16>& colors, std::uint8_t* output) noexcept
+        {
+            Color mean{};
+            for (const auto& color : colors)
+                for (std::size_t i = 0; i < 3; ++i)
+                    mean[i] += color[i] / 16.0F;
+
+            std::array<float, 6> covariance{}; // rr, rg, rb, gg, gb, bb
+            for (const auto& color : colors)
+            {
+                const Color d{color[0] - mean[0], color[1] - mean[1], color[2] - mean[2]};
+                covariance[0] += d[0] * d[0];
+                covariance[1] += d[0] * d[1];
+                covariance[2] += d[0] * d[2];
+                covariance[3] += d[1] * d[1];
+                covariance[4] += d[1] * d[2];
+                covariance[5] += d[2] * d[2];
+            }
+
+            // power iteration converges to the principal axis fast enough for 16 colors
+            Color axis{1.0F, 1.0F, 1.0F};
+            for (int iteration = 0; iteration < 8; ++iteration)
+            {
+                const Color next{
+                    covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+                    covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+                    covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]
+                };
+                const auto length = std::max({std::fabs(next[0]), std::fabs(next[1]), std::fabs(next[2])});
+                if (length <= 0.0F) break;
+                axis = Color{next[0] / length, next[1] / length, next[2] / length};
+            }
+
+            float minProjection = 0.0F;
+            float maxProjection = 0.0F;
+            const auto axisLengthSquared = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+            for (const auto& color : colors)
+            {
+                const auto projection = ((color[0] - mean[0]) * axis[0] +
+                                         (color[1] - mean[1]) * axis[1] +
+                                         (color[2] - mean[2]) * axis[2]) / axisLengthSquared;
+                minProjection = std::min(minProjection, projection);
+                maxProjection = std::max(maxProjection, projection);
+            }
+
+            // the four color mode is selected by the first endpoint being greater than the second one
+            const auto orderEndpoints = [](std::uint16_t& first, std::uint16_t& second) noexcept {
+                if (first < second) std::swap(first, second);
+            };
+
+            std::uint16_t color0 = toRgb565(Color{
+                mean[0] + axis[0] * maxProjection,
+                mean[1] + axis[1] * maxProjection,
+                mean[2] + axis[2] * maxProjection
+            });
+            std::uint16_t color1 = toRgb565(Color{
+                mean[0] + axis[0] * minProjection,
+                mean[1] + axis[1] * minProjection,
+                mean[2] + axis[2] * minProjection
+            });
+            orderEndpoints(color0, color1);
+
+            std::array<std::uint32_t, 16> indices;
+            auto error = assignIndices(colors, color0, color1, indices);
+
+            // weights of the first endpoint for each of the palette indices
+            constexpr std::array<float, 4> weights = {1.0F, 0.0F, 2.0F / 3.0F, 1.0F / 3.0F};
+
+            for (int iteration = 0; iteration < 2 && error > 0.0F; ++iteration)
+            {
+                float a = 0.0F;
+                float b = 0.0F;
+                float c = 0.0F;
+                Color x{};
+                Color y{};
+                for (std::size_t i = 0; i < colors.size(); ++i)
+                {
+                    const auto weight = weights[indices[i]];
+                    a += weight * weight;
+                    b += weight * (1.0F - weight);
+                    c += (1.0F - weight) * (1.0F - weight);
+                    for (std::size_t channel = 0; channel < 3; ++channel)
+                    {
+                        x[channel] += weight * colors[i][channel];
+                        y[channel] += (1.0F - weight) * colors[i][channel];
+                    }
+                }
+
+                const auto determinant = a * c - b * b;
+                if (std::fabs(determinant) < 1e-6F) break;
+
+                auto newColor0 = toRgb565(Color{
+                    (x[0] * c - y[0] * b) / determinant,
+                    (x[1] * c - y[1] * b) / determinant,
+                    (x[2] * c - y[2] * b) / determinant
+                });
+                auto newColor1 = toRgb565(Color{
+                    (y[0] * a - x[0] * b) / determinant,
+                    (y[1] * a - x[1] * b) / determinant,
+                    (y[2] * a - x[2] * b) / determinant
+                });
+                orderEndpoints(newColor0, newColor1);
+
+                std::array<std::uint32_t, 16> newIndices;
+                const auto newError = assignIndices(colors, newColor0, newColor1, newIndices);
+                if (newError >= error) break;
+
+                color0 = newColor0;
+                color1 = newColor1;
+                indices = newIndices;
+                error = newError;
+            }
+
+            std::uint32_t packedIndices = 0;
+            for (std::size_t i = 0; i < indices.size(); ++i)
+                packedIndices |= indices[i] << (i * 2);
+
+            output[0] = static_cast<std::uint8_t>(color0 & 0xFFU);
+            output[1] = static_cast<std::uint8_t>(color0 >> 8);
+            output[2] = static_cast<std::uint8_t>(color1 & 0xFFU);
+            output[3] = static_cast<std::uint8_t>(color1 >> 8);
+            for (std::size_t i = 0; i < 4; ++i)
+                output[4 + i] = static_cast<std::uint8_t>((packedIndices >> (i * 8)) & 0xFFU);
+        }
+
+        // Encodes the alpha of a 4x4 block in the eight alpha mode between the smallest and the largest value
+        inline void encodeAlphaBlock(const std::array<std::uint8_t, 16>& alphas, std::uint8_t* output) noexcept
+        {
+            const auto [minAlpha, maxAlpha] = std::minmax_element(alphas.begin(), alphas.end());
+            const std::uint32_t alpha0 = *maxAlpha;
+            const std::uint32_t alpha1 = *minAlpha;
+
+            std::uint64_t indices = 0;
+
+            if (alpha0 != alpha1)
+            {
+                std::array<std::uint32_t, 8> palette;
+                palette[0] = alpha0;
+                palette[1] = alpha1;
+                for (std::uint32_t i = 2; i < 8; ++i)
+                    palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7;
+
+                for (std::size_t i = 0; i < alphas.size(); ++i)
+                {
+                    std::uint64_t bestIndex = 0;
+                    std::uint32_t bestDistance = 256;
+                    for (std::uint32_t index = 0; index < palette.size(); ++index)
+                    {
+                        const auto distance = alphas[i] > palette[index] ?
+                            alphas[i] - palette[index] : palette[index] - alphas[i];
+                        if (distance < bestDistance)
+                        {
+                            bestDistance = distance;
+                            bestIndex = index;
+                        }
+                    }
+
+                    indices |= bestIndex << (i * 3);
+                }
+            }
+
+            output[0] = static_cast<std::uint8_t>(alpha0);
+            output[1] = static_cast<std::uint8_t>(alpha1);
+            for (std::size_t i = 0; i < 6; ++i)
+                output[2 + i] = static_cast<std::uint8_t>((indices >> (i * 8)) & 0xFFU);
+        }
+
+        constexpr std::int32_t etcModifiers[8][4] = {
+            {2, 8, -2, -8},
+            {5, 17, -5, -17},
+            {9, 29, -9, -29},
+            {13, 42, -13, -42},
+            {18, 60, -18, -60},
+            {24, 80, -24, -80},
+            {33, 106, -33, -106},
+            {47, 183, -47, -183}
+        };
+
+        constexpr std::int32_t eacModifiers[16][8] = {
+            {-3, -6, -9, -15, 2, 5, 8, 14},
+            {-3, -7, -10, -13, 2, 6, 9, 12},
+            {-2, -5, -8, -13, 1, 4, 7, 12},
+            {-2, -4, -6, -13, 1, 3, 5, 12},
+            {-3, -6, -8, -12, 2, 5, 7, 11},
+            {-3, -7, -9, -11, 2, 6, 8, 10},
+            {-4, -7, -8, -11, 3, 6, 7, 10},
+            {-3, -5, -8, -11, 2, 4, 7, 10},
+            {-2, -6, -8, -10, 1, 5, 7, 9},
+            {-2, -5, -8, -10, 1, 4, 7, 9},
+            {-2, -4, -8, -10, 1, 3, 7, 9},
+            {-2, -5, -7, -10, 1, 4, 6, 9},
+            {-3, -4, -7, -10, 2, 3, 6, 9},
+            {-1, -2, -3, -10, 0, 1, 2, 9},
+            {-4, -6, -8, -9, 3, 5, 7, 8},
+            {-3, -5, -7, -9, 2, 4, 6, 8}
+        };
+
+        struct EtcSubblock final
+        {
+            std::uint32_t table = 0;
+            std::array<std::uint32_t, 8> indices{};
+            std::uint32_t error = 0;
+        };
+
+        // Picks the modifier table and the modifiers that best fit the pixels to the base color
+        inline EtcSubblock fitEtcSubblock(const std::array<std::array<std::int32_t, 3>, 8>& pixels,
+                                          const std::array<std::int32_t, 3>& baseColor) noexcept
+        {
+            EtcSubblock best;
+            best.error = std::numeric_limits<std::uint32_t>::max();
+
+            for (std::uint32_t table = 0; table < 8; ++table)
+            {
+                EtcSubblock subblock;
+                subblock.table = table;
+
+                for (std::size_t i = 0; i < pixels.size(); ++i)
+                {
+                    auto bestDistance = std::numeric_limits<std::uint32_t>::max();
+                    for (std::uint32_t index = 0; index < 4; ++index)
+                    {
+                        std::uint32_t distance = 0;
+                        for (std::size_t channel = 0; channel < 3; ++channel)
+                        {
+                            const auto difference = std::clamp(baseColor[channel] + etcModifiers[table][index], 0, 255) - pixels[i][channel];
+                            distance += static_cast<std::uint32_t>(difference * difference);
+                        }
+
+                        if (distance < bestDistance)
+                        {
+                            bestDistance = distance;
+                            subblock.indices[i] = index;
+                        }
+                    }
+
+                    subblock.error += bestDistance;
+                }
+
+                if (subblock.error < best.error) best = subblock;
+            }
+
+            return best;
+        }
+
+        // Encodes the colors of a 4x4 block in the individual or differential mode, which ETC1 decoders
+        // can also read, the base colors are the averages of the sub-blocks
+        inline void encodeEtcColorBlock(const std::array<Color, 16>& colors, std::uint8_t* output) noexcept
+        {
+            std::uint64_t bestBits = 0;
+            auto bestError = std::numeric_limits<std::uint32_t>::max();
+
+            for (std::uint32_t flip = 0; flip < 2; ++flip)
+            {
+                // the sub-blocks are 2x4 side by side, or 4x2 on top of each other if flipped
+                std::array<std::array<std::array<std::int32_t, 3>, 8>, 2> pixels;
+                std::array<std::array<std::uint32_t, 8>, 2> positions; // pixel numbers in the ETC column order
+                std::array<Color, 2> averages{};
+                std::array<std::size_t, 2> counts{};
+
+                for (std::uint32_t y = 0; y < 4; ++y)
+                    for (std::uint32_t x = 0; x < 4; ++x)
+                    {
+                        const auto subblock = flip ? (y >= 2 ? 1U : 0U) : (x >= 2 ? 1U : 0U);
+                        const auto& color = colors[y * 4 + x];
+                        auto& count = counts[subblock];
+
+                        for (std::size_t channel = 0; channel < 3; ++channel)
+                        {
+                            pixels[subblock][count][channel] = static_cast<std::int32_t>(color[channel]);
+                            averages[subblock][channel] += color[channel] / 8.0F;
+                        }
+                        positions[subblock][count] = x * 4 + y;
+                        ++count;
+                    }
+
+                for (std::uint32_t differential = 0; differential < 2; ++differential)
+                {
+                    const auto maximum = differential ? 31.0F : 15.0F;
+                    std::array<std::array<std::int32_t, 3>, 2> quantized;
+                    for (std::size_t subblock = 0; subblock < 2; ++subblock)
+                        for (std::size_t channel = 0; channel < 3; ++channel)
+                            quantized[subblock][channel] = static_cast<std::int32_t>(std::lround(std::clamp(averages[subblock][channel], 0.0F, 255.0F) * maximum / 255.0F));
+
+                    // the second base color is stored as a 3 bit signed difference to the first one
+                    if (differential)
+                        for (std::size_t channel = 0; channel < 3; ++channel)
+                            quantized[1][channel] = std::clamp(quantized[1][channel], quantized[0][channel] - 4, quantized[0][channel] + 3);
+
+                    std::array<std::array<std::int32_t, 3>, 2> baseColors;
+                    for (std::size_t subblock = 0; subblock < 2; ++subblock)
+                        for (std::size_t channel = 0; channel < 3; ++channel)
+                        {
+                            const auto value = quantized[subblock][channel];
+                            baseColors[subblock][channel] = differential ? (value << 3) | (value >> 2) : (value << 4) | value;
+                        }
+
+                    const std::array<EtcSubblock, 2> subblocks{
+                        fitEtcSubblock(pixels[0], baseColors[0]),
+                        fitEtcSubblock(pixels[1], baseColors[1])
+                    };
+
+                    const auto error = subblocks[0].error + subblocks[1].error;
+                    if (error >= bestError) continue;
+
+                    std::uint64_t bits = 0;
+                    for (std::size_t channel = 0; channel < 3; ++channel)
+                    {
+                        const auto shift = 56 - channel * 8;
+                        if (differential)
+                            bits |= (static_cast<std::uint64_t>(quantized[0][channel]) << (shift + 3)) |
+                                (static_cast<std::uint64_t>(quantized[1][channel] - quantized[0][channel]) & 0x07U) << shift;
+                        else
+                            bits |= (static_cast<std::uint64_t>(quantized[0][channel]) << (shift + 4)) |
+                                (static_cast<std::uint64_t>(quantized[1][channel]) << shift);
+                    }
+
+                    bits |= static_cast<std::uint64_t>(subblocks[0].table) << 37;
+                    bits |= static_cast<std::uint64_t>(subblocks[1].table) << 34;
+                    bits |= static_cast<std::uint64_t>(differential) << 33;
+                    bits |= static_cast<std::uint64_t>(flip) << 32;
+
+                    // the most significant bits of the indices are in the upper half
+                    for (std::size_t subblock = 0; subblock < 2; ++subblock)
+                        for (std::size_t i = 0; i < 8; ++i)
+                        {
+                            const auto index = subblocks[subblock].indices[i];
+                            const auto position = positions[subblock][i];
+                            bits |= static_cast<std::uint64_t>(index >> 1) << (position + 16);
+                            bits |= static_cast<std::uint64_t>(index & 0x01U) << position;
+                        }
+
+                    bestBits = bits;
+                    bestError = error;
+                }
+            }
+
+            for (std::size_t i = 0; i < 8; ++i)
+                output[i] = static_cast<std::uint8_t>((bestBits >> (56 - i * 8)) & 0xFFU);
+        }
+
+        // Encodes the alpha of a 4x4 block as EAC, the base value and the multiplier are chosen for every
+        // modifier table so that the table spans the range of the alpha values
+        inline void encodeEacAlphaBlock(const std::array<std::uint8_t, 16>& alphas, std::uint8_t* output) noexcept
+        {
+            const auto [minAlpha, maxAlpha] = std::minmax_element(alphas.begin(), alphas.end());
+            const auto minimum = static_cast<std::int32_t>(*minAlpha);
+            const auto maximum = static_cast<std::int32_t>(*maxAlpha);
+
+            std::uint64_t bestBits = 0;
+            auto bestError = std::numeric_limits<std::uint32_t>::max();
+
+            for (std::uint32_t table = 0; table < 16 && bestError > 0; ++table)
+            {
+                const auto& modifiers = eacModifiers[table];
+                const auto tableRange = modifiers[7] - modifiers[3];
+                const auto multiplier = std::clamp((maximum - minimum + tableRange / 2) / tableRange, 1, 15);
+
+                for (auto candidate = std::max(multiplier - 1, 1); candidate <= std::min(multiplier + 1, 15); ++candidate)
+                {
+                    const auto base = std::clamp((minimum - modifiers[3] * candidate + maximum - modifiers[7] * candidate + 1) / 2, 0, 255);
+
+                    std::uint64_t bits = (static_cast<std::uint64_t>(base) << 56) |
+                        (static_cast<std::uint64_t>(candidate) << 52) |
+                        (static_cast<std::uint64_t>(table) << 48);
+                    std::uint32_t error = 0;
+
+                    for (std::uint32_t x = 0; x < 4; ++x)
+                        for (std::uint32_t y = 0; y < 4; ++y)
+                        {
+                            const auto alpha = static_cast<std::int32_t>(alphas[y * 4 + x]);
+
+                            std::uint64_t bestIndex = 0;
+                            auto bestDistance = std::numeric_limits<std::uint32_t>::max();
+                            for (std::uint32_t index = 0; index < 8; ++index)
+                            {
+                                const auto difference = std::clamp(base + modifiers[index] * candidate, 0, 255) - alpha;
+                                const auto distance = static_cast<std::uint32_t>(difference * difference);
+                                if (distance < bestDistance)
+                                {
+                                    bestDistance = distance;
+                                    bestIndex = index;
+                                }
+                            }
+
+                            // the pixels are stored in columns starting from the most significant bits
+                            bits |= bestIndex << (45 - (x * 4 + y) * 3);
+                            error += bestDistance;
+                        }
+
+                    if (error < bestError)
+                    {
+                        bestBits = bits;
+                        bestError = error;
+                    }
+                }
+            }
+
+            for (std::size_t i = 0; i < 8; ++i)
+                output[i] = static_cast<std::uint8_t>((bestBits >> (56 - i * 8)) & 0xFFU);
+        }
+    }
+
+    inline Level compress(const Level& level, Format format)
+    {
+        if (format == Format::rgba8) return level;
+
+        const auto blockSize = (format == Format::bc1 || format == Format::etc2Rgb) ? 8U : 16U;
+        const auto blockCountX = (level.width + 3) / 4;
+        const auto blockCountY = (level.height + 3) / 4;
+
+        Level result;
+        result.width = level.width;
+        result.height = level.height;
+        result.data.resize(static_cast<std::size_t>(blockCountX) * blockCountY * blockSize);
+
+        auto output = result.data.data();
+
+        for (std::uint32_t blockY = 0; blockY < blockCountY; ++blockY)
+            for (std::uint32_t blockX = 0; blockX < blockCountX; ++blockX, output += blockSize)
+            {
+                std::array<detail::Color, 16> colors;
+                std::array<std::uint8_t, 16> alphas;
+
+                // the pixels outside of the level are replaced with the closest edge pixels
+                for (std::uint32_t y = 0; y < 4; ++y)
+                    for (std::uint32_t x = 0; x < 4; ++x)
+                    {
+                        const auto pixelX = std::min(blockX * 4 + x, level.width - 1);
+                        const auto pixelY = std::min(blockY * 4 + y, level.height - 1);
+                        const auto pixel = level.data.data() + (static_cast<std::size_t>(pixelY) * level.width + pixelX) * 4;
+
+                        colors[y * 4 + x] = detail::Color{
+                            static_cast<float>(pixel[0]),
+                            static_cast<float>(pixel[1]),
+                            static_cast<float>(pixel[2])
+                        };
+                        alphas[y * 4 + x] = pixel[3];
+                    }
+
+                switch (format)
+                {
+                    case Format::bc1:
+                        detail::encodeColorBlock(colors, output);
+                        break;
+                    case Format::bc3:
+                        detail::encodeAlphaBlock(alphas, output);
+                        detail::encodeColorBlock(colors, output + 8);
+                        break;
+                    case Format::etc2Rgb:
+                        detail::encodeEtcColorBlock(colors, output);
+                        break;
+                    case Format::etc2Rgba:
+                        detail::encodeEacAlphaBlock(alphas, output);
+                        detail::encodeEtcColorBlock(colors, output + 8);
+                        break;
+                    default:
+                        throw std::runtime_error{"Unsupported format"};
+                }
+            }
+
+        return result;
+    }
+
+    // Writes the levels into a KTX 1.1 container, which stores the OpenGL enums of the format
+    inline void writeKtx(const storage::Path& path, Format format, const std::vector<Level>& levels)
+    {
+        constexpr std::uint32_t glUnsignedByte = 0x1401;
+        constexpr std::uint32_t glRgba = 0x1908;
+        constexpr std::uint32_t glRgba8 = 0x8058;
+        constexpr std::uint32_t glCompressedRgbaS3tcDxt1 = 0x83F1;
+        constexpr std::uint32_t glCompressedRgbaS3tcDxt5 = 0x83F3;
+        constexpr std::uint32_t glRgb = 0x1907;
+        constexpr std::uint32_t glCompressedRgb8Etc2 = 0x9274;
+        constexpr std::uint32_t glCompressedRgba8Etc2Eac = 0x9278;
+
+        const auto getInternalFormat = [](Format textureFormat) noexcept {
+            switch (textureFormat)
+            {
+                case Format::bc1: return glCompressedRgbaS3tcDxt1;
+                case Format::bc3: return glCompressedRgbaS3tcDxt5;
+                case Format::etc2Rgb: return glCompressedRgb8Etc2;
+                case Format::etc2Rgba: return glCompressedRgba8Etc2Eac;
+                default: return glRgba8;
+            }
+        };
+
+        std::vector<std::uint8_t> data = {
+            0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+        };
+
+        const auto encode = [&data](std::uint32_t value) {
+            for (std::size_t i = 0; i < sizeof(value); ++i)
+                data.push_back(static_cast<std::uint8_t>((value >> (i * 8)) & 0xFFU));
+        };
+
+        const auto compressed = format != Format::rgba8;
+
+        encode(0x04030201U); // endianness
+        encode(compressed ? 0 : glUnsignedByte); // glType
+        encode(1); // glTypeSize
+        encode(compressed ? 0 : glRgba); // glFormat
+        encode(getInternalFormat(format)); // glInternalFormat
+        encode(format == Format::etc2Rgb ? glRgb : glRgba); // glBaseInternalFormat
+        encode(levels.front().width);
+        encode(levels.front().height);
+        encode(0); // pixelDepth
+        encode(0); // numberOfArrayElements
+        encode(1); // numberOfFaces
+        encode(static_cast<std::uint32_t>(levels.size()));
+        encode(0); // bytesOfKeyValueData
+
+        for (const auto& level : levels)
+        {
+            encode(static_cast<std::uint32_t>(level.data.size()));
+            data.insert(data.end(), level.data.begin(), level.data.end());
+            data.resize((data.size() + 3) & ~std::size_t{3}); // levels are aligned to 4 bytes
+        }
+
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        if (!file)
+            throw std::runtime_error{"Failed to create " + std::string(path)};
+
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file)
+            throw std::runtime_error{"Failed to write " + std::string(path)};
+    }
+
+    inline void exportTexture(const storage::Path& inputPath,
+                              const storage::Path& outputPath,
+                              Platform platform,
+                              bool mipmaps)
+    {
+        auto image = loadImage(inputPath);
+        const auto format = getFormat(platform, isOpaque(image));
+
+        auto levels = mipmaps ? generateMipmaps(std::move(image)) : std::vector<Level>{std::move(image)};
+
+        for (auto& level : levels)
+            level = compress(level, format);
+
+        writeKtx(outputPath, format, levels);
+    }
+}
+
+#endif // OUZEL_TEXTUREEXPORTER_HPP